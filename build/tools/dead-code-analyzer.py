@@ -7,6 +7,7 @@
 
 import json
 import re
+import subprocess
 from dataclasses import dataclass
 from enum import Enum
 from pathlib import Path
@@ -106,6 +107,9 @@ class DeadCodeAnalyzer:
         if not self.makefile_path.exists():
             return
 
+        if self._load_makefile_graph():
+            return
+
         with open(self.makefile_path) as f:
             content = f.read()
 
@@ -129,6 +133,30 @@ class DeadCodeAnalyzer:
                 if not ref_path.startswith("$"):  # Skip variables
                     self.makefile_references.add(ref_path)
 
+    def _load_makefile_graph(self) -> bool:
+        """Read targets and recipe scripts from deptrack's Makefile parser, when built."""
+        deptrack = self.project_root / "build/tools/dependency-tracker/build/deptrack"
+        if not deptrack.exists():
+            return False
+
+        try:
+            result = subprocess.run(
+                [str(deptrack), "make", f"--root={self.project_root}", "--format=json"],
+                capture_output=True,
+                text=True,
+                timeout=30,
+                check=False,
+            )
+            graph = json.loads(result.stdout)
+        except (OSError, subprocess.TimeoutExpired, json.JSONDecodeError):
+            return False
+
+        for target in graph.get("targets", []):
+            self.makefile_targets.add(target["name"])
+            self.makefile_references.update(target.get("scripts", []))
+        self.makefile_references.update(graph.get("includes", []))
+        return True
+
     def _analyze_build_config(self):
         """Extract modules and references from build configuration."""
         print("  🔧 Analyzing build configuration...")
@@ -36,11 +36,12 @@ extern "C" {
 #define DEPTRACK_VERSION_STRING "1.0.0"
 
 // Configuration constants
-#define MAX_LANGUAGES 10
+#define MAX_LANGUAGES 16
 #define MAX_PATH_LENGTH 4096
 #define MAX_NAME_LENGTH 256
 #define MAX_VERSION_LENGTH 64
 #define MAX_DEPENDENCIES 1000
+#define DEPTRACK_NO_OFFSET SIZE_MAX
 #define MAX_FILE_EXTENSIONS 10
 
 // Forward declarations
@@ -50,6 +51,14 @@ typedef struct DependencyGraph DependencyGraph;
 typedef struct FileCache FileCache;
 typedef struct ConfigManager ConfigManager;
 typedef struct OutputGenerator OutputGenerator;
+typedef struct HashMap HashMap;
+typedef struct StringPool StringPool;
+typedef struct VersionCatalog VersionCatalog;
+typedef struct KeywordMatcher KeywordMatcher;
+typedef struct MpmcQueue MpmcQueue;
+typedef struct WorkDeque WorkDeque;
+typedef struct ThreadPool ThreadPool;
+typedef struct TaskGroup TaskGroup;
 
 // Enumerations
 typedef enum {
@@ -61,6 +70,10 @@ typedef enum {
     LANG_YAML,
     LANG_SQL,
     LANG_PROTO,
+    LANG_C,
+    LANG_MAKE,
+    LANG_SHELL,
+    LANG_DOCKER,
     LANG_UNKNOWN
 } Language;
 
@@ -103,7 +116,8 @@ typedef struct {
     char* version;
     DependencyType type;
     char* source_file;
-    int line_number;
+    int line_number;           // 0 until parsed_file_resolve_lines when recorded by offset
+    size_t offset;             // Byte offset in source_file, DEPTRACK_NO_OFFSET when only the line is known
     ResolveStatus status;
     void* metadata;
 } Dependency;
@@ -118,6 +132,10 @@ typedef struct {
     void* parse_metadata;
 } ParsedFile;
 
+// What graph_add_node and graph_add_edge copy in; the graph itself stores nodes and edges by column.
+// Adding an edge whose (from, to, type) is already present merges into it: the occurrence count goes up,
+// the source location is appended to the edge's list, and the smaller version constraint by strcmp is
+// kept, so the result does not depend on the order edges arrive in.
 typedef struct {
     char* id;
     char* name;
@@ -125,7 +143,6 @@ typedef struct {
     char* filepath;
     char** dependencies;
     size_t dep_count;
-    void* metadata;
 } GraphNode;
 
 typedef struct {
@@ -133,17 +150,103 @@ typedef struct {
     char* to_id;
     DependencyType type;
     char* version_constraint;
-    void* metadata;
+    char* source_file;         // Where the edge was found; NULL records no location
+    int line_number;           // 0 when unknown
 } GraphEdge;
 
+// An edge between nodes already in the graph, by index (see graph_add_nodes_bulk)
+typedef struct {
+    size_t from;
+    size_t to;
+    DependencyType type;
+    const char* version_constraint;
+    const char* source_file;
+    int line_number;
+} GraphBulkEdge;
+
+// Index of an interned string in a StringPool
+typedef uint32_t StringHandle;
+#define STRING_NONE UINT32_MAX
+#define GRAPH_NO_NODE SIZE_MAX
+#define GRAPH_NO_LOCATION UINT32_MAX
+
+// One source location of an edge, linked to the edge's next one
+typedef struct {
+    StringHandle file;
+    uint32_t line;
+    uint32_t next;             // Index into graph->locations, GRAPH_NO_LOCATION at the end
+} GraphLocationEntry;
+
+typedef struct {
+    const char* file;
+    uint32_t line;
+} GraphLocation;
+
+// Node flags, kept up to date as nodes and edges are added
+#define GRAPH_NODE_FILE 0x01             // Has a file path: analyzed, not only depended on
+#define GRAPH_NODE_HAS_DEPENDENCIES 0x02 // Source of an edge
+#define GRAPH_NODE_HAS_DEPENDENTS 0x04   // Target of an edge
+
+// Typed attribute columns (src/core/graph_attributes.c), indexed like the node or edge columns
+typedef enum {
+    ATTRIBUTE_INT,             // int64_t
+    ATTRIBUTE_FLOAT,           // double
+    ATTRIBUTE_STRING,          // Interned in the graph's string pool
+    ATTRIBUTE_BITSET           // 64 bits per row
+} AttributeType;
+
+typedef enum {
+    ATTRIBUTE_NODE,
+    ATTRIBUTE_EDGE
+} AttributeScope;
+
+// Rows at or past capacity are unset; so are int and float rows without their present bit, string rows
+// holding STRING_NONE and bitset rows of 0.
+typedef struct {
+    char* name;
+    AttributeScope scope;
+    AttributeType type;
+    void* values;              // int64_t, double, StringHandle or uint64_t per row
+    uint64_t* present;         // One bit per row; ints and floats only
+    size_t capacity;           // Rows allocated
+} GraphAttribute;
+
+#define GRAPH_NO_ATTRIBUTE SIZE_MAX
+
+// Node i and edge e are position i and e of every column. Hot columns are allocated with the graph;
+// cold ones stay NULL until the first node or edge that has a value for them.
 typedef struct DependencyGraph {
-    GraphNode* nodes;
-    GraphEdge* edges;
+    uint8_t* node_type;        // NodeType
+    uint8_t* node_flags;       // GRAPH_NODE_*
+    StringHandle* node_id;
+    uint32_t* edge_from;       // Node indices
+    uint32_t* edge_to;
+    uint8_t* edge_type;        // DependencyType
+    StringHandle* edge_version;   // STRING_NONE without a constraint
+    uint32_t* edge_occurrences;   // Adds merged into the edge, saturating
+    uint32_t* edge_slots;      // Open-addressed set of edge index + 1 on (from, to, type); 0 is empty
+    size_t edge_slot_count;    // Power of two, at least twice edge_count
+    uint32_t* edge_location_first;   // Cold; GRAPH_NO_LOCATION for edges without one
+    uint32_t* edge_location_last;    // Cold
+    GraphLocationEntry* locations;
+    size_t location_count;
+    size_t location_capacity;
+    StringHandle* node_name;   // Cold
+    StringHandle* node_filepath;   // Cold
+    uint32_t* node_dep_end;    // Cold; node i lists dep_ids[node_dep_end[i - 1]] up to dep_ids[node_dep_end[i]]
+    StringHandle* dep_ids;
+    size_t dep_id_count;
+    size_t dep_id_capacity;
     size_t node_count;
     size_t edge_count;
     size_t node_capacity;
     size_t edge_capacity;
-    void* node_index;  // HashMap for fast lookups
+    GraphAttribute* attributes;
+    size_t attribute_count;
+    size_t attribute_capacity;
+    StringPool* strings;       // Ids, names, paths, versions and string attributes
+    uint32_t* node_by_string;  // By handle; UINT32_MAX for strings that are no node's id
+    size_t node_by_string_capacity;
     pthread_mutex_t mutex;  // Thread safety for concurrent graph modifications
 } DependencyGraph;
 
@@ -151,6 +254,7 @@ typedef struct DependencyGraph {
 typedef ParsedFile* (*ParseFunction)(const char* filepath);
 typedef ResolveStatus (*ResolveFunction)(Dependency* dep, void* context);
 
+// The tracker owns a registered parser and its keyword_matcher; name, extensions and keywords are borrowed.
 typedef struct LanguageParser {
     Language language;
     char* name;
@@ -159,8 +263,50 @@ typedef struct LanguageParser {
     ParseFunction parse_file;
     ResolveFunction resolve_deps;
     void* config;
+    const char* const* keywords;   // Built into keyword_matcher at registration
+    size_t keyword_count;
+    KeywordMatcher* keyword_matcher;
 } LanguageParser;
 
+// Analysis pipeline (src/core/pipeline.c)
+// Files flow enumerate -> read -> parse -> merge through bounded queues; a full queue stalls its producers.
+// Stage workers run as tasks on the tracker's thread pool and yield it while stalled.
+typedef enum {
+    PIPELINE_ENUMERATE,
+    PIPELINE_READ,
+    PIPELINE_PARSE,
+    PIPELINE_MERGE,
+    PIPELINE_STAGE_COUNT
+} PipelineStage;
+
+// Stage worker counts above this are refused by pipeline_run, the CLI and deptrack.json
+#define PIPELINE_MAX_STAGE_THREADS 1024
+// Likewise for queue capacities; mpmc_queue_create returns NULL above it
+#define PIPELINE_MAX_QUEUE_CAPACITY 1048576
+
+typedef struct {
+    size_t threads[PIPELINE_STAGE_COUNT];   // Workers per stage; 0 picks the default (parse: pool size)
+    size_t queue_capacity;                  // Per queue, rounded up to a power of two
+} PipelineConfig;
+
+typedef struct {
+    size_t threads;
+    size_t items;              // Files the stage passed on
+    size_t queue_capacity;     // Of the stage's input queue; 0 for enumeration
+    size_t max_queue_depth;
+    double mean_queue_depth;   // Sampled at every push into the input queue
+    uint64_t busy_ns;          // Summed over the stage's workers, stalls excluded
+    uint64_t input_stall_ns;   // Waiting on an empty input queue
+    uint64_t output_stall_ns;  // Waiting on a full output queue
+} PipelineStageMetrics;
+
+typedef struct {
+    PipelineStageMetrics stages[PIPELINE_STAGE_COUNT];
+    size_t files_skipped;      // No parser for the language
+    size_t files_failed;       // Unreadable or failed to parse
+    uint64_t elapsed_ns;
+} PipelineMetrics;
+
 // Main tracker structure
 typedef struct DependencyTracker {
     LanguageParser* parsers[MAX_LANGUAGES];
@@ -169,6 +315,13 @@ typedef struct DependencyTracker {
     FileCache* cache;
     ConfigManager* config;
     OutputGenerator* output;
+    VersionCatalog* catalog;   // Gradle version catalogs of the analyzed root
+    char* root_path;           // Of the last deptrack_analyze_directory; written as the output's root_path
+    PipelineConfig pipeline;   // Stage workers and queue size for deptrack_analyze_directory
+    PipelineMetrics pipeline_metrics;   // Of the last deptrack_analyze_directory
+    size_t jobs;               // Pool worker threads; 0 is one per CPU
+    ThreadPool* pool;          // Created on first use by deptrack_thread_pool
+    bool compact_output;       // JSON without indentation
     pthread_mutex_t mutex;
     bool initialized;
 } DependencyTracker;
@@ -178,23 +331,1066 @@ DependencyTracker* deptrack_create(void);
 void deptrack_destroy(DependencyTracker* tracker);
 int deptrack_initialize(DependencyTracker* tracker, const char* config_path);
 int deptrack_analyze_directory(DependencyTracker* tracker, const char* root_path);
+// Parses one file into tracker->graph; under the analyzed root its node id is root-relative, as
+// deptrack_analyze_directory keys it, otherwise the path as given.
 int deptrack_analyze_file(DependencyTracker* tracker, const char* filepath);
+// Adds the file's node under id, one node per dependency name and the edges between them, as one batch;
+// dependency names are node ids, so paths must be resolved first. The pipeline's merge stage uses it.
+int deptrack_merge_parsed_file(DependencyTracker* tracker, const ParsedFile* parsed, const char* id);
 DependencyGraph* deptrack_get_graph(DependencyTracker* tracker);
+// Only OUTPUT_JSON is written; other formats return DEPTRACK_ERROR_INVALID_PARAM without creating the file.
 int deptrack_generate_output(DependencyTracker* tracker, OutputFormat format, const char* output_path);
+// Whether a parser exists for the file.
+bool deptrack_has_parser(Language lang, const char* filepath);
+// Parses a file already in memory, as parser_read_file returns it.
+ParsedFile* deptrack_parse_buffer(DependencyTracker* tracker, const char* filepath, Language lang,
+                                  const char* buffer, size_t length);
+// Languages whose parser reads the file in fixed-size chunks itself (SQL dumps can be any size); callers
+// parse them with deptrack_parse_file instead of loading them.
+bool deptrack_parser_streams(Language lang);
+// Streams the file when deptrack_parser_streams(lang), otherwise reads it and runs deptrack_parse_buffer.
+ParsedFile* deptrack_parse_file(DependencyTracker* tracker, const char* filepath, Language lang);
+// The tracker's shared pool, started with tracker->jobs workers on first call; NULL if it cannot start.
+ThreadPool* deptrack_thread_pool(DependencyTracker* tracker);
 
 // Graph operations
 DependencyGraph* graph_create(void);
 void graph_destroy(DependencyGraph* graph);
 int graph_add_node(DependencyGraph* graph, const GraphNode* node);
 int graph_add_edge(DependencyGraph* graph, const GraphEdge* edge);
-GraphNode* graph_find_node(DependencyGraph* graph, const char* id);
+// Batch construction under one lock with one capacity reservation. Ids already in the graph or earlier
+// in the batch are not added again; handles (may be NULL) receives every node's index either way. A node
+// with a filepath is written over one without (a dependency target added first), so a file's node reads
+// the same whichever batch arrived first. Edges
+// name their ends by index, and the batch is refused if any index is out of range. After a memory
+// error the nodes and edges before the failing one stay added.
+int graph_add_nodes_bulk(DependencyGraph* graph, const GraphNode* nodes, size_t count, size_t* handles);
+int graph_add_edges_bulk(DependencyGraph* graph, const GraphBulkEdge* edges, size_t count);
+// Node index of id, or GRAPH_NO_NODE.
+size_t graph_find_node(const DependencyGraph* graph, const char* id);
+// Strings stay valid until the next node or edge is added; name, path and versions may be NULL.
+const char* graph_node_id(const DependencyGraph* graph, size_t node);
+const char* graph_node_name(const DependencyGraph* graph, size_t node);
+const char* graph_node_filepath(const DependencyGraph* graph, size_t node);
+size_t graph_node_dependency_count(const DependencyGraph* graph, size_t node);
+const char* graph_node_dependency(const DependencyGraph* graph, size_t node, size_t index);
+const char* graph_edge_version(const DependencyGraph* graph, size_t edge);
+// Index of the edge (from, to, type), or SIZE_MAX.
+size_t graph_find_edge(const DependencyGraph* graph, size_t from, size_t to, DependencyType type);
+// Locations in the order they were added; writes up to capacity of them and returns how many there are.
+size_t graph_edge_locations(const DependencyGraph* graph, size_t edge, GraphLocation* out, size_t capacity);
+// Kernels over the hot columns only. type_mask has bit 1 << type set for every type to keep; nodes
+// must also carry every flag in flags. out receives the indices in ascending order; returns how many.
+size_t graph_filter_nodes(const DependencyGraph* graph, uint32_t type_mask, uint8_t flags, size_t* out);
+size_t graph_filter_edges(const DependencyGraph* graph, uint32_t type_mask, size_t* out);
+// 1 if some node depends on itself through its edges, 0 if not, or an error code.
 int graph_detect_cycles(DependencyGraph* graph);
+// Interns into graph->strings, keeping node lookup in step; the caller holds graph->mutex.
+int graph_intern(DependencyGraph* graph, const char* text, StringHandle* handle);
+
+// Attributes: define once per (scope, name), then set and get in bulk. rows lists the rows to touch and
+// may be NULL for rows 0 .. count - 1. Setters take the graph lock and write nothing when a row is past
+// the scope's node or edge count or the attribute has another type; a NULL string unsets its row.
+// Getters write 0 or NULL for unset rows and return how many were set.
+int graph_attribute_define(DependencyGraph* graph, AttributeScope scope, const char* name, AttributeType type,
+                           size_t* attribute);
+size_t graph_attribute_find(const DependencyGraph* graph, AttributeScope scope, const char* name);
+int graph_attribute_set_ints(DependencyGraph* graph, size_t attribute, const size_t* rows, const int64_t* values,
+                             size_t count);
+int graph_attribute_set_floats(DependencyGraph* graph, size_t attribute, const size_t* rows, const double* values,
+                               size_t count);
+int graph_attribute_set_strings(DependencyGraph* graph, size_t attribute, const size_t* rows,
+                                const char* const* values, size_t count);
+int graph_attribute_set_bits(DependencyGraph* graph, size_t attribute, const size_t* rows, const uint64_t* values,
+                             size_t count);
+size_t graph_attribute_get_ints(const DependencyGraph* graph, size_t attribute, const size_t* rows,
+                                int64_t* values, size_t count);
+size_t graph_attribute_get_floats(const DependencyGraph* graph, size_t attribute, const size_t* rows,
+                                  double* values, size_t count);
+size_t graph_attribute_get_strings(const DependencyGraph* graph, size_t attribute, const size_t* rows,
+                                   const char** values, size_t count);
+size_t graph_attribute_get_bits(const DependencyGraph* graph, size_t attribute, const size_t* rows,
+                                uint64_t* values, size_t count);
+// Column scans like graph_filter_nodes: out receives the set rows with min <= value <= max, or whose
+// bits meet mask, in ascending order. The sum covers set rows of an int or float attribute.
+size_t graph_attribute_filter_ints(const DependencyGraph* graph, size_t attribute, int64_t min, int64_t max,
+                                   size_t* out);
+size_t graph_attribute_filter_bits(const DependencyGraph* graph, size_t attribute, uint64_t mask, size_t* out);
+double graph_attribute_sum(const DependencyGraph* graph, size_t attribute);
+
+// Canonical order for output (src/core/graph_sort.c): nodes by id, edges by (from id, to id, type), which
+// the graph keeps unique. Identical at any thread count; call once construction has finished.
+typedef struct {
+    size_t* nodes;             // Node indices
+    size_t* edges;             // Edge indices
+    size_t node_count;
+    size_t edge_count;
+} GraphOrder;
+
+// pool may be NULL to sort on the calling thread.
+int graph_sort(const DependencyGraph* graph, ThreadPool* pool, GraphOrder* order);
+void graph_order_destroy(GraphOrder* order);
 
 // Parser registration
 int deptrack_register_parser(DependencyTracker* tracker, LanguageParser* parser);
 LanguageParser* deptrack_get_parser(DependencyTracker* tracker, Language lang);
+// Path only; deptrack_analyze_file also sniffs the first bytes of files this leaves unknown.
 Language deptrack_detect_language(const char* filepath);
 
+// Language classifier (src/parsers/language_classifier.c)
+// head holds the first bytes of the file for shebang and modeline sniffing, or NULL.
+Language language_classify(const char* filepath, const char* head, size_t head_length);
+size_t language_classifier_slot(const char* key, size_t length);
+// Number of table entries not in their hash slot; 0 for a valid table.
+size_t language_classifier_verify(void);
+
+// Parser utilities (src/parsers/parser_utils.c)
+char* parser_read_file(const char* filepath, size_t* out_length);
+// Reads filepath and hands it to parse_buffer; the parse_*_file wrappers of buffer parsers use it.
+ParsedFile* parser_parse_file(const char* filepath,
+                              ParsedFile* (*parse_buffer)(const char*, const char*, size_t));
+ParsedFile* parsed_file_create(const char* filepath, Language language);
+Dependency* parsed_file_add_dependency(ParsedFile* parsed, const char* name, size_t name_length,
+                                       const char* version, DependencyType type, int line_number);
+// Records a byte offset only; the line is filled in by parsed_file_resolve_lines.
+Dependency* parsed_file_add_dependency_at(ParsedFile* parsed, const char* name, size_t name_length,
+                                          const char* version, DependencyType type, size_t offset);
+// Resolves every offset-only dependency against buffer; no index is built when there are none.
+int parsed_file_resolve_lines(ParsedFile* parsed, const char* buffer, size_t length);
+void parsed_file_destroy(ParsedFile* parsed);
+
+typedef enum {
+    SIMD_ISA_SCALAR,
+    SIMD_ISA_SSE42,
+    SIMD_ISA_AVX2
+} SimdIsa;
+
+SimdIsa simd_detect_isa(void);
+const char* simd_isa_name(SimdIsa isa);
+
+typedef enum {
+    KEYWORD_MATCH_WHOLE_WORD = 1 << 0,   // Identifier characters may not touch either end
+    KEYWORD_MATCH_IGNORE_CASE = 1 << 1   // ASCII case folding
+} KeywordMatchFlags;
+
+typedef struct {
+    size_t keyword;            // Index into the keyword list the matcher was built from
+    size_t offset;
+    size_t length;
+} KeywordMatch;
+
+// Return DEPTRACK_SUCCESS to keep scanning or an error code to stop with it.
+typedef int (*KeywordVisitFunction)(const KeywordMatch* match, void* context);
+
+KeywordMatcher* keyword_matcher_create(const char* const* keywords, size_t count, unsigned flags);
+void keyword_matcher_destroy(KeywordMatcher* matcher);
+// Caps the instruction set used (tests, benchmarks); returns the one in effect.
+SimdIsa keyword_matcher_set_isa(KeywordMatcher* matcher, SimdIsa isa);
+size_t keyword_matcher_count(const KeywordMatcher* matcher);
+// Reports every occurrence, overlapping ones included, in order of their end offset.
+int keyword_matcher_scan(const KeywordMatcher* matcher, const char* buffer, size_t length,
+                         KeywordVisitFunction visit, void* context);
+
+typedef enum {
+    SYNTAX_HASH_COMMENT = 1 << 0,    // # to end of line
+    SYNTAX_SLASH_COMMENT = 1 << 1,   // // to end of line
+    SYNTAX_BLOCK_COMMENT = 1 << 2,   // /* ... */
+    SYNTAX_SINGLE_QUOTE = 1 << 3,    // '...' on one line
+    SYNTAX_DOUBLE_QUOTE = 1 << 4,    // "..." on one line
+    SYNTAX_TRIPLE_QUOTE = 1 << 5,    // '''...''' and """...""" across lines
+    SYNTAX_TEMPLATE = 1 << 6         // `...` across lines; ${} interpolations stay masked
+} SyntaxRules;
+
+// Bit i of bits[i / 64] is set when byte i is inside a string or comment, delimiters included.
+typedef struct {
+    uint64_t* bits;
+    size_t block_count;
+    size_t length;
+} SyntaxMask;
+
+// Offsets of every '\n', ascending
+typedef struct {
+    size_t* newlines;
+    size_t count;
+} LineIndex;
+
+int line_index_build(const char* buffer, size_t length, SimdIsa max_isa, LineIndex* index);
+// 1-based line of the byte at offset
+int line_index_line(const LineIndex* index, size_t offset);
+void line_index_destroy(LineIndex* index);
+
+unsigned syntax_rules_for_language(Language language);
+// max_isa caps the instruction set; SIMD_ISA_AVX2 means the best one available.
+int syntax_mask_build(const char* buffer, size_t length, unsigned rules, SimdIsa max_isa, SyntaxMask* mask);
+void syntax_mask_destroy(SyntaxMask* mask);
+bool syntax_mask_test(const SyntaxMask* mask, size_t offset);
+
+// Language parsers
+ParsedFile* parse_kotlin_file(const char* filepath);
+ParsedFile* parse_kotlin_gradle_file(const char* filepath);
+ParsedFile* parse_kotlin_source_buffer(const char* filepath, const char* buffer, size_t length);
+ParsedFile* parse_gradle_buffer(const char* filepath, const char* buffer, size_t length);
+ParsedFile* parse_yaml_file(const char* filepath);
+ParsedFile* parse_yaml_buffer(const char* filepath, const char* buffer, size_t length);
+ParsedFile* parse_typescript_file(const char* filepath);
+// matcher comes from the registered TypeScript parser; NULL builds a temporary one.
+ParsedFile* typescript_parse_buffer(const char* filepath, const char* buffer, size_t length,
+                                    const KeywordMatcher* matcher);
+bool typescript_is_manifest(const char* filepath);
+// Entries of the dependencies, devDependencies, peerDependencies and optionalDependencies sections.
+ParsedFile* parse_package_json_buffer(const char* filepath, const char* buffer, size_t length);
+LanguageParser* typescript_parser_create(void);
+ParsedFile* parse_proto_file(const char* filepath);
+ParsedFile* parse_proto_buffer(const char* filepath, const char* buffer, size_t length);
+// Imports only, without the ProtoFile model; matcher as for typescript_parse_buffer.
+ParsedFile* proto_scan_imports(const char* filepath, const char* buffer, size_t length,
+                               const KeywordMatcher* matcher);
+LanguageParser* proto_parser_create(void);
+ParsedFile* parse_python_manifest_file(const char* filepath);
+// -r and -c includes of a requirements file are still read from disk.
+ParsedFile* parse_python_manifest_buffer(const char* filepath, const char* buffer, size_t length);
+ParsedFile* parse_python_file(const char* filepath);
+// import and from statements of a source; matcher as for typescript_parse_buffer.
+ParsedFile* python_scan_imports(const char* filepath, const char* buffer, size_t length,
+                                const KeywordMatcher* matcher);
+LanguageParser* python_parser_create(void);
+
+// DAG scheduling (src/analysis/graph_analyzer.c)
+// Edges point from prerequisite to dependent: edge_from[i] must finish before edge_to[i] starts.
+typedef struct {
+    size_t node_count;
+    size_t* order;             // Nodes in wave order (topological)
+    size_t* wave_of;           // Wave index per node, SIZE_MAX if the node sits on a cycle
+    size_t* wave_offsets;      // Wave w is order[wave_offsets[w] .. wave_offsets[w + 1])
+    size_t wave_count;
+    size_t scheduled_count;    // Less than node_count when a cycle blocks the rest
+    size_t* critical_path;     // Longest cost-weighted chain, prerequisite first
+    size_t critical_path_length;
+    double critical_path_cost;
+} DagSchedule;
+
+// Returns DEPTRACK_ERROR_CYCLE, with the acyclic prefix still scheduled, when a cycle remains.
+int dag_schedule_compute(size_t node_count, const size_t* edge_from, const size_t* edge_to,
+                         size_t edge_count, const double* costs, DagSchedule* schedule);
+void dag_schedule_destroy(DagSchedule* schedule);
+
+// Docker Compose model (src/parsers/yaml_parser.c)
+typedef struct {
+    char* name;
+    char* image;
+    char* build_context;
+    char* dockerfile;          // build.dockerfile, relative to build_context
+    char** depends_on;
+    size_t depends_count;
+    char** volumes;            // Volume sources: host paths or named volumes
+    size_t volume_count;
+    int line_number;
+} ComposeService;
+
+typedef struct {
+    ComposeService* services;
+    size_t service_count;
+    size_t service_capacity;
+} ComposeFile;
+
+ComposeFile* compose_parse_buffer(const char* buffer, size_t length);
+ComposeFile* compose_parse_file(const char* filepath);
+void compose_file_destroy(ComposeFile* compose);
+int compose_find_service(const ComposeFile* compose, const char* name);
+int compose_startup_waves(const ComposeFile* compose, DagSchedule* schedule);
+
+// Protocol Buffers model (src/parsers/proto_parser.c)
+typedef struct {
+    char* name;
+    char* request_type;
+    char* response_type;
+    bool client_streaming;
+    bool server_streaming;
+    int line_number;
+} ProtoRpc;
+
+typedef struct {
+    char* name;
+    ProtoRpc* rpcs;
+    size_t rpc_count;
+    int line_number;
+} ProtoService;
+
+typedef struct {
+    char* filepath;
+    char* package;
+    char** imports;            // Import paths as written, relative to the proto root
+    int* import_lines;
+    size_t import_count;
+    char** messages;           // Defined messages and enums, nested ones as Outer.Inner
+    size_t message_count;
+    char** type_refs;          // Distinct non-scalar field, rpc and extend types
+    int* type_ref_lines;
+    size_t type_ref_count;
+    ProtoService* services;
+    size_t service_count;
+} ProtoFile;
+
+typedef struct {
+    char* root;
+    ProtoFile** files;
+    char** import_paths;       // Path of each file relative to root
+    size_t file_count;
+    size_t file_capacity;
+    HashMap* by_import_path;
+} ProtoSet;
+
+ProtoFile* proto_parse_buffer(const char* filepath, const char* buffer, size_t length);
+ProtoFile* proto_parse_file(const char* filepath);
+void proto_file_destroy(ProtoFile* file);
+ProtoSet* proto_set_create(const char* root);
+ProtoSet* proto_set_load(const char* root);
+int proto_set_add_buffer(ProtoSet* set, const char* import_path, const char* buffer, size_t length);
+void proto_set_destroy(ProtoSet* set);
+int proto_set_compile_order(const ProtoSet* set, DagSchedule* schedule);
+// Marks changed files and everything importing them; returns the number of stale files.
+size_t proto_set_stale(const ProtoSet* set, const char* const* changed, size_t changed_count, bool* stale);
+
+// TOML reader (src/parsers/toml_parser.c)
+#define TOML_MAX_DEPTH 16
+
+typedef enum {
+    TOML_STRING,
+    TOML_INTEGER,
+    TOML_FLOAT,
+    TOML_BOOLEAN,
+    TOML_DATETIME
+} TomlValueType;
+
+// One scalar; arrays and inline tables are flattened into their elements.
+typedef struct {
+    const char* path[TOML_MAX_DEPTH];  // Key components, table header first (not NUL-terminated)
+    size_t path_lengths[TOML_MAX_DEPTH];
+    size_t depth;
+    size_t array_index;        // Position in the innermost array, SIZE_MAX outside arrays
+    size_t table_index;        // Bumped at every table header, so [[array]] entries stay apart
+    TomlValueType type;
+    const char* value;         // Decoded string, or the source text of other scalars
+    size_t value_length;
+    int line_number;
+} TomlValue;
+
+// Visitors return DEPTRACK_SUCCESS to continue or an error code to stop the parse.
+typedef int (*TomlVisitFunction)(const TomlValue* value, void* context);
+
+int toml_parse_buffer(const char* buffer, size_t length, TomlVisitFunction visit, void* context);
+bool toml_key_is(const TomlValue* value, size_t index, const char* key);
+
+// Gradle version catalogs (src/parsers/version_catalog.c)
+typedef enum {
+    CATALOG_LIBRARY,
+    CATALOG_PLUGIN,
+    CATALOG_BUNDLE,
+    CATALOG_VERSION
+} CatalogEntryKind;
+
+typedef struct {
+    CatalogEntryKind kind;
+    char* accessor;            // As used in build scripts: libs.foo.bar, libs.plugins.x, libs.bundles.x
+    char* module;              // group:artifact for libraries, the id for plugins
+    char* version;             // Resolved version; NULL when a platform supplies it
+    size_t* members;           // Library entries of a bundle
+    size_t member_count;
+    int line_number;
+} CatalogEntry;
+
+typedef struct VersionCatalog {
+    char* root;
+    CatalogEntry* entries;
+    size_t entry_count;
+    size_t entry_capacity;
+    HashMap* by_accessor;
+} VersionCatalog;
+
+VersionCatalog* version_catalog_create(const char* root);
+// Loads every ROOT/gradle/NAME.versions.toml; accessors are prefixed with NAME.
+VersionCatalog* version_catalog_load(const char* root);
+int version_catalog_add_buffer(VersionCatalog* catalog, const char* name, const char* buffer, size_t length);
+void version_catalog_destroy(VersionCatalog* catalog);
+const CatalogEntry* version_catalog_find(const VersionCatalog* catalog, const char* accessor, size_t length);
+// Rewrites "catalog" dependencies to real coordinates; returns how many were resolved.
+size_t version_catalog_resolve(const VersionCatalog* catalog, ParsedFile* parsed);
+
+// Python declared dependencies (src/parsers/python_parser.c)
+// PEP 440 specifier sets normalized to one interval plus point/prefix exclusions.
+typedef struct {
+    char* lower;               // NULL when unbounded
+    bool lower_inclusive;
+    char* upper;               // NULL when unbounded
+    bool upper_inclusive;
+    char** excluded;           // != versions; "1.4.*" excludes a whole prefix
+    size_t excluded_count;
+    bool empty;                // The specifiers contradict each other
+} VersionInterval;
+
+typedef struct {
+    char* name;                // PEP 503 normalized (lowercase, -_. runs become '-')
+    char* extras;              // Comma-separated extras, NULL when none
+    char* specifier;           // Specifier text as written, NULL when unpinned
+    VersionInterval interval;  // After any -c constraints have been applied
+    char* marker;              // PEP 508 environment marker, NULL when unconditional
+    char* group;               // Optional-dependency group, "build-system", or NULL for main deps
+    char* url;                 // Direct reference, path or VCS URL
+    char* source_file;
+    int line_number;
+    bool editable;
+    bool constraint;           // Came from a -c file: restricts versions, installs nothing
+} PythonRequirement;
+
+typedef struct {
+    PythonRequirement* items;
+    size_t count;
+    size_t capacity;
+    HashMap* by_name;          // Normalized name -> first non-constraint requirement
+} PythonRequirements;
+
+int pep440_compare(const char* a, const char* b);
+bool pep440_normalize(const char* version, size_t length, char* out, size_t out_size);
+int version_interval_parse(const char* specifiers, size_t length, VersionInterval* interval);
+void version_interval_destroy(VersionInterval* interval);
+bool version_interval_contains(const VersionInterval* interval, const char* version);
+bool version_interval_overlaps(const VersionInterval* a, const VersionInterval* b);
+// Maven-style text: "[1.0,2.0)", "[6.0,)", "[1.4.2]"; exclusions follow as ",!=1.5"
+int version_interval_format(const VersionInterval* interval, char* out, size_t size);
+// environment is a NULL-terminated list of name/value pairs; returns 1, 0 or an error code.
+int python_marker_evaluate(const char* marker, const char* const* environment);
+
+PythonRequirements* python_requirements_create(void);
+void python_requirements_destroy(PythonRequirements* reqs);
+// Parses one requirements file body; -r/-c lines are recorded but not followed.
+int python_requirements_parse_buffer(PythonRequirements* reqs, const char* filepath,
+                                     const char* buffer, size_t length, bool constraint);
+// Loads a requirements file, following -r/-c includes, then applies constraints.
+int python_requirements_load(PythonRequirements* reqs, const char* filepath);
+int pyproject_parse_buffer(PythonRequirements* reqs, const char* filepath, const char* buffer, size_t length);
+int python_requirements_apply_constraints(PythonRequirements* reqs);
+const PythonRequirement* python_requirements_find(const PythonRequirements* reqs, const char* name);
+bool python_is_manifest(const char* filepath);
+
+// Go modules (src/parsers/go_parser.c)
+typedef struct {
+    char* path;
+    char* version;
+    bool indirect;             // Marked "// indirect"
+    int line_number;
+} GoRequire;
+
+typedef struct {
+    char* old_path;
+    char* old_version;         // NULL when every version is replaced
+    char* new_path;
+    char* new_version;         // NULL for a local directory replacement
+    int line_number;
+} GoReplace;
+
+typedef struct {
+    char* module_path;
+    char* go_version;
+    GoRequire* requires;
+    size_t require_count;
+    GoReplace* replaces;
+    size_t replace_count;
+    HashMap* by_path;          // Module path -> index into requires
+} GoModFile;
+
+typedef struct {
+    size_t entry_count;
+    HashMap* by_module;        // "path@version" -> 1 with a zip hash, 0 with only a go.mod hash
+} GoSumFile;
+
+GoModFile* go_mod_parse_buffer(const char* buffer, size_t length);
+GoModFile* go_mod_parse_file(const char* filepath);
+void go_mod_destroy(GoModFile* mod);
+// Longest requirement whose module path is a '/'-prefix of the import path.
+const GoRequire* go_mod_find_require(const GoModFile* mod, const char* import_path, size_t length);
+GoSumFile* go_sum_parse_buffer(const char* buffer, size_t length);
+GoSumFile* go_sum_parse_file(const char* filepath);
+void go_sum_destroy(GoSumFile* sum);
+bool go_sum_has(const GoSumFile* sum, const char* path, const char* version);
+// mod may be NULL; imports are then only split into stdlib and external.
+ParsedFile* parse_go_source_buffer(const char* filepath, const char* buffer, size_t length, const GoModFile* mod);
+ParsedFile* parse_go_file(const char* filepath);
+// go.mod, go.sum or a source file; go.mod reads its sibling go.sum, sources the go.mod above them.
+ParsedFile* parse_go_buffer(const char* filepath, const char* buffer, size_t length);
+
+// Cargo manifests and Rust sources (src/parsers/rust_parser.c)
+typedef enum {
+    CARGO_NORMAL,
+    CARGO_DEV,
+    CARGO_BUILD
+} CargoDependencyKind;
+
+typedef struct {
+    char* name;                // Key in the dependency table
+    char* package;             // Real crate name when renamed, else NULL
+    char* version;             // Requirement as written, NULL for path/git-only
+    char* path;
+    char* git;
+    char* target;              // cfg(...) or triple from [target.X.dependencies], else NULL
+    CargoDependencyKind kind;
+    bool optional;
+    bool workspace;            // workspace = true: version comes from [workspace.dependencies]
+    int line_number;
+} CargoDependency;
+
+typedef struct {
+    char* package_name;
+    char* package_version;
+    CargoDependency* dependencies;
+    size_t dependency_count;
+    size_t dependency_capacity;
+    char** workspace_members;
+    size_t member_count;
+    HashMap* by_key;           // "kind|target|name" -> index into dependencies
+} CargoManifest;
+
+typedef struct {
+    char* name;
+    char* version;
+    char* source;              // NULL for workspace members
+    char** dependencies;       // Crate names only
+    size_t dependency_count;
+} CargoLockPackage;
+
+typedef struct {
+    CargoLockPackage* packages;
+    size_t package_count;
+    size_t package_capacity;
+    HashMap* by_name;          // Crate name -> index, SIZE_MAX when locked at several versions
+} CargoLock;
+
+CargoManifest* cargo_manifest_parse_buffer(const char* buffer, size_t length);
+void cargo_manifest_destroy(CargoManifest* manifest);
+const char* cargo_dependency_section(CargoDependencyKind kind);
+CargoLock* cargo_lock_parse_buffer(const char* buffer, size_t length);
+void cargo_lock_destroy(CargoLock* lock);
+// NULL when the crate is missing or locked at more than one version.
+const CargoLockPackage* cargo_lock_find(const CargoLock* lock, const char* name);
+ParsedFile* parse_rust_source_buffer(const char* filepath, const char* buffer, size_t length);
+ParsedFile* parse_rust_file(const char* filepath);
+// Cargo.toml (with its sibling Cargo.lock), Cargo.lock or a source file.
+ParsedFile* parse_rust_buffer(const char* filepath, const char* buffer, size_t length);
+
+// C/C++ includes (src/parsers/c_parser.c)
+typedef struct {
+    char* path;                // As written between the delimiters
+    bool system;               // <...> rather than "..."
+    int line_number;
+} CInclude;
+
+typedef struct {
+    char* filepath;
+    CInclude* includes;        // Includes outside `#if 0` branches, in source order
+    size_t include_count;
+    char* guard;               // Include guard macro, NULL when the file has none
+    bool pragma_once;
+} CSourceFile;
+
+typedef struct {
+    char** include_dirs;       // Searched in order after the including directory
+    size_t include_dir_count;
+    char** paths;              // Normalized paths of every file resolved so far
+    CSourceFile** files;       // Scan of paths[i], NULL until first needed
+    size_t file_count;
+    size_t file_capacity;
+    HashMap* by_path;          // Normalized path -> index
+    HashMap* lookup_cache;     // Including directory + include spelling -> index or SIZE_MAX
+    size_t cache_hits;
+    size_t stat_count;         // Filesystem probes made by resolution
+} CIncludeResolver;
+
+CSourceFile* c_scan_buffer(const char* filepath, const char* buffer, size_t length);
+CSourceFile* c_scan_file(const char* filepath);
+void c_source_destroy(CSourceFile* file);
+bool c_is_source(const char* filepath);
+CIncludeResolver* c_resolver_create(void);
+void c_resolver_destroy(CIncludeResolver* resolver);
+int c_resolver_add_include_dir(CIncludeResolver* resolver, const char* dir);
+// Adds include_directories() and target_include_directories() paths of one CMakeLists.txt.
+int c_resolver_load_cmake(CIncludeResolver* resolver, const char* cmakelists_path);
+// Index into resolver->paths, or SIZE_MAX for an unresolved (system) include.
+size_t c_resolver_resolve(CIncludeResolver* resolver, const char* including_file, const CInclude* inc);
+const CSourceFile* c_resolver_scan(CIncludeResolver* resolver, size_t index);
+// Source first, then every reachable project header once; the caller frees the array.
+int c_resolver_dependencies(CIncludeResolver* resolver, const char* source, size_t** out_files, size_t* out_count);
+int c_write_depfile(CIncludeResolver* resolver, const char* target, const char* source,
+                    bool phony_headers, FILE* out);
+ParsedFile* parse_c_file(const char* filepath);
+ParsedFile* parse_c_buffer(const char* filepath, const char* buffer, size_t length);
+
+// Makefiles (src/parsers/makefile_parser.c)
+typedef struct {
+    char* name;
+    char** prerequisites;
+    size_t prerequisite_count;
+    char** order_only;         // After '|': ordering only, never a reason to rebuild
+    size_t order_only_count;
+    char** recipe;             // Recipe lines as written, without the leading tab
+    size_t recipe_count;
+    char** invocations;        // Targets run through `$(MAKE) target` in the recipe
+    size_t invocation_count;
+    char** scripts;            // Script files the recipe executes, relative to the Makefile
+    size_t script_count;
+    char** calls;              // Macros used through $(call NAME,...)
+    size_t call_count;
+    char* help;                // Trailing `## text` on the rule line
+    bool phony;
+    int line_number;
+} MakeTarget;
+
+typedef struct {
+    char* name;
+    char* value;               // Unexpanded; define blocks keep their newlines
+    int line_number;
+} MakeVariable;
+
+typedef struct {
+    MakeTarget* targets;       // In order of first appearance
+    size_t target_count;
+    size_t target_capacity;
+    HashMap* by_name;          // Target name -> index
+    MakeVariable* variables;
+    size_t variable_count;
+    HashMap* variables_by_name;
+    char** includes;
+    size_t include_count;
+    char** phony;              // Every .PHONY prerequisite, defined here or not
+    size_t phony_count;
+} Makefile;
+
+Makefile* makefile_parse_buffer(const char* buffer, size_t length);
+Makefile* makefile_parse_file(const char* filepath);
+void makefile_destroy(Makefile* mf);
+bool makefile_is_makefile(const char* filepath);
+const MakeTarget* makefile_find_target(const Makefile* mf, const char* name);
+// Expands variables, $(call ...) and automatic variables of target (may be NULL); caller frees.
+char* makefile_expand(const Makefile* mf, const MakeTarget* target, const char* text);
+// Waves over targets; prerequisites and sub-make invocations run before the target.
+int makefile_schedule(const Makefile* mf, DagSchedule* schedule);
+// Marks targets that name, depend on or run a changed file, and everything after them.
+size_t makefile_affected_targets(const Makefile* mf, const char* const* changed, size_t changed_count, bool* affected);
+ParsedFile* parse_makefile(const char* filepath);
+ParsedFile* parse_makefile_buffer(const char* filepath, const char* buffer, size_t length);
+
+// SQL migrations (src/parsers/sql_parser.c)
+typedef enum {
+    SQL_OBJECT_TABLE,
+    SQL_OBJECT_VIEW,
+    SQL_OBJECT_FUNCTION,       // Functions, procedures and aggregates
+    SQL_OBJECT_INDEX,
+    SQL_OBJECT_SEQUENCE,
+    SQL_OBJECT_TYPE,
+    SQL_OBJECT_SCHEMA,
+    SQL_OBJECT_TRIGGER,
+    SQL_OBJECT_RELATION,       // Table or view; the referencing syntax does not tell which
+    SQL_OBJECT_OTHER
+} SqlObjectKind;
+
+typedef enum {
+    SQL_ACCESS_DEFINE,         // CREATE, ALTER ... RENAME TO, SELECT INTO
+    SQL_ACCESS_WRITE,          // ALTER, DROP, INSERT, UPDATE, DELETE, TRUNCATE, CREATE INDEX ON
+    SQL_ACCESS_READ
+} SqlAccess;
+
+typedef struct {
+    char* name;                // Lower-cased unless quoted, "public." dropped
+    SqlObjectKind kind;
+    SqlAccess access;
+    bool call;                 // name(...): a function only when some migration defines it
+    bool optional;             // IF EXISTS
+    size_t statement;          // Statement index within the file
+    int line_number;
+} SqlObject;
+
+typedef struct {
+    char* filepath;
+    char* version;             // Flyway V1_2__ or leading digits; NULL when unversioned
+    SqlObject* objects;
+    size_t object_count;
+    size_t object_capacity;
+    size_t statement_count;
+} SqlMigration;
+
+typedef struct {
+    SqlMigration** migrations; // Apply order as given: version order after sql_migration_set_load
+    size_t migration_count;
+    size_t migration_capacity;
+} SqlMigrationSet;
+
+typedef struct {
+    size_t migration;          // Referencing migration
+    size_t object;             // Index into its objects
+    size_t defined_in;         // First migration defining the object (may equal migration)
+} SqlForwardReference;
+
+typedef struct SqlScanner SqlScanner;
+
+// Incremental scanning: feed any chunking of the file, tokens may span chunk boundaries.
+SqlScanner* sql_scanner_create(const char* filepath);
+int sql_scanner_feed(SqlScanner* scanner, const char* data, size_t length);
+SqlMigration* sql_scanner_finish(SqlScanner* scanner);
+SqlMigration* sql_scan_buffer(const char* filepath, const char* buffer, size_t length);
+SqlMigration* sql_scan_file(const char* filepath);
+void sql_migration_destroy(SqlMigration* migration);
+char* sql_migration_version(const char* filepath);
+// qsort comparator over SqlMigration* by version, unversioned files last.
+int sql_migration_compare(const void* a, const void* b);
+SqlMigrationSet* sql_migration_set_create(void);
+int sql_migration_set_add(SqlMigrationSet* set, SqlMigration* migration);
+SqlMigrationSet* sql_migration_set_load(const char* root);
+void sql_migration_set_destroy(SqlMigrationSet* set);
+// Waves of migrations that may be applied concurrently; DEPTRACK_ERROR_CYCLE when none is valid.
+int sql_migration_set_order(const SqlMigrationSet* set, DagSchedule* schedule);
+// References to objects first defined by a later statement or migration; the caller frees *out.
+int sql_migration_set_forward_references(const SqlMigrationSet* set, SqlForwardReference** out, size_t* count);
+// Streams the file through the chunked scanner; deptrack_parser_streams(LANG_SQL) is true.
+ParsedFile* parse_sql_file(const char* filepath);
+ParsedFile* parse_sql_buffer(const char* filepath, const char* buffer, size_t length);
+
+// Shell scripts (src/parsers/shell_parser.c)
+typedef enum {
+    SHELL_SOURCE,              // source FILE, . FILE
+    SHELL_EXEC,                // ./x.sh, bash x.sh, node x.js
+    SHELL_PYTHON,              // python3 x.py, ./x.py
+    SHELL_MAKE                 // Script graph only: a Makefile prerequisite or sub-make
+} ShellReferenceKind;
+
+typedef struct {
+    char* path;                // Relative to the scan root; a pattern when nothing matched
+    ShellReferenceKind kind;
+    bool exists;               // Checked only when scanning against a root
+    int line_number;
+} ShellReference;
+
+typedef struct {
+    char* filepath;
+    ShellReference* references; // One per (path, kind), first occurrence
+    size_t reference_count;
+    size_t reference_capacity;
+} ShellScript;
+
+typedef struct {
+    char** nodes;              // Root-relative paths, "make:TARGET" for Makefile targets
+    size_t node_count;
+    size_t node_capacity;
+    HashMap* by_name;
+    size_t* edge_from;         // User
+    size_t* edge_to;           // Used file or target
+    ShellReferenceKind* edge_kind;
+    size_t edge_count;
+    size_t edge_capacity;
+} ScriptGraph;
+
+// root (may be NULL) is where relative paths resolve and unknown variables glob; filepath is relative to it.
+ShellScript* shell_scan_buffer(const char* root, const char* filepath, const char* buffer, size_t length);
+ShellScript* shell_scan_file(const char* root, const char* filepath);
+void shell_script_destroy(ShellScript* script);
+bool shell_is_script(const char* filepath);
+const char* shell_reference_kind_name(ShellReferenceKind kind);
+ParsedFile* parse_shell_file(const char* filepath);
+ParsedFile* parse_shell_buffer(const char* filepath, const char* buffer, size_t length);
+// Every shell script under root plus the root Makefile's targets.
+ScriptGraph* script_graph_load(const char* root);
+void script_graph_destroy(ScriptGraph* graph);
+// Marks every node that uses path directly or through other scripts and targets; returns how many.
+size_t script_graph_dependents(const ScriptGraph* graph, const char* path, bool* dependents);
+
+// CI workflows (src/parsers/ci_parser.c)
+typedef struct {
+    char* event;               // push, pull_request, release, ...
+    char** paths;              // Filter globs in order; '!' excludes
+    size_t path_count;
+    char** paths_ignore;
+    size_t paths_ignore_count;
+} CiTrigger;
+
+typedef struct {
+    char* name;
+    char* uses;                // owner/action@ref
+    char* run;                 // Shell script; block scalars joined
+    char* working_directory;
+    int line_number;
+} CiStep;
+
+typedef struct {
+    char* id;
+    char* name;
+    char** needs;
+    size_t need_count;
+    char** paths;              // Job-level change filter (paths: or changes:); none means any change
+    size_t path_count;
+    char** scripts;            // Files run steps execute or source, relative to the root
+    size_t script_count;
+    CiStep* steps;
+    size_t step_count;
+    char* condition;           // if:
+    int timeout_minutes;       // 0 when not given
+    int line_number;
+} CiJob;
+
+typedef struct {
+    char* filepath;
+    char* name;
+    CiTrigger* triggers;
+    size_t trigger_count;
+    CiJob* jobs;
+    size_t job_count;
+    size_t job_capacity;
+    HashMap* by_id;
+} CiWorkflow;
+
+// root (may be NULL) resolves the scripts run steps reference; filepath is relative to it.
+CiWorkflow* ci_workflow_parse_buffer(const char* root, const char* filepath, const char* buffer, size_t length);
+CiWorkflow* ci_workflow_parse_file(const char* root, const char* filepath);
+void ci_workflow_destroy(CiWorkflow* wf);
+bool ci_is_workflow(const char* filepath);
+const CiJob* ci_workflow_find_job(const CiWorkflow* wf, const char* id);
+bool ci_path_matches(const char* pattern, const char* path);
+// Whether a push or pull request touching the changed files starts the workflow at all.
+bool ci_workflow_triggered(const CiWorkflow* wf, const char* const* changed, size_t changed_count);
+// Waves over jobs by needs:, weighted by timeout-minutes.
+int ci_workflow_schedule(const CiWorkflow* wf, DagSchedule* schedule);
+// Jobs whose filter matches, jobs downstream of them, and the needs of all of those.
+size_t ci_workflow_required_jobs(const CiWorkflow* wf, const char* const* changed, size_t changed_count,
+                                 bool* required);
+// Workflow files under root, relative to it; the caller frees the array and its strings.
+int ci_find_workflows(const char* root, char*** out, size_t* count);
+ParsedFile* parse_ci_workflow_file(const char* filepath);
+ParsedFile* parse_ci_workflow_buffer(const char* filepath, const char* buffer, size_t length);
+
+// Dockerfiles (src/parsers/dockerfile_parser.c)
+typedef enum {
+    DOCKER_REF_COPY,           // COPY source, relative to the root
+    DOCKER_REF_ADD,
+    DOCKER_REF_IMAGE,          // COPY --from=image that is not a stage
+    DOCKER_REF_PIP,            // pip install package; version holds the specifier
+    DOCKER_REF_NPM,
+    DOCKER_REF_MANIFEST        // pip -r file or package.json; the context path when a COPY brought it in
+} DockerReferenceKind;
+
+typedef struct {
+    char* name;                // AS name, NULL when unnamed
+    char* base;                // FROM argument with ARGs substituted
+    int base_stage;            // Index of the stage it builds on, -1 for an image
+    int line_number;
+} DockerStage;
+
+typedef struct {
+    DockerReferenceKind kind;
+    char* value;
+    char* version;
+    size_t stage;
+    int line_number;
+} DockerReference;
+
+typedef struct {
+    char* filepath;
+    char* context;             // Build context, relative to the root
+    DockerStage* stages;
+    size_t stage_count;
+    size_t stage_capacity;
+    DockerReference* references;
+    size_t reference_count;
+    size_t reference_capacity;
+} Dockerfile;
+
+typedef struct {
+    char* name;                // Compose image: or service name, else the Dockerfile path
+    Dockerfile* dockerfile;
+} DockerImage;
+
+typedef struct {
+    DockerImage* images;
+    size_t image_count;
+} DockerImageSet;
+
+// context (may be NULL, meaning the Dockerfile's directory) is relative to the same root as filepath.
+Dockerfile* dockerfile_parse_buffer(const char* filepath, const char* context, const char* buffer, size_t length);
+Dockerfile* dockerfile_parse_file(const char* root, const char* filepath, const char* context);
+void dockerfile_destroy(Dockerfile* df);
+const char* docker_reference_kind_name(DockerReferenceKind kind);
+// Whether path is the Dockerfile itself or lies under one of its COPY/ADD sources.
+bool dockerfile_uses_path(const Dockerfile* df, const char* path);
+// Every Dockerfile under root, with context and name taken from compose files that build it.
+DockerImageSet* docker_image_set_load(const char* root);
+void docker_image_set_destroy(DockerImageSet* set);
+// Images using a changed file, and images built FROM or copying from those; returns how many.
+size_t docker_images_to_rebuild(const DockerImageSet* set, const char* const* changed, size_t changed_count,
+                                bool* rebuild);
+ParsedFile* parse_dockerfile(const char* filepath);
+ParsedFile* parse_dockerfile_buffer(const char* filepath, const char* buffer, size_t length);
+
+// Bounded lock-free multi-producer multi-consumer ring (src/core/pipeline.c)
+MpmcQueue* mpmc_queue_create(size_t capacity);
+void mpmc_queue_destroy(MpmcQueue* queue);
+// Never block: push fails when the queue is full, pop when it is empty.
+bool mpmc_queue_push(MpmcQueue* queue, void* item);
+bool mpmc_queue_pop(MpmcQueue* queue, void** item);
+size_t mpmc_queue_capacity(const MpmcQueue* queue);
+
+void pipeline_config_default(PipelineConfig* config);
+const char* pipeline_stage_name(PipelineStage stage);
+// Parses every file under root into tracker->graph; node ids are paths relative to root.
+int pipeline_run(DependencyTracker* tracker, const char* root, const PipelineConfig* config,
+                 PipelineMetrics* metrics);
+
+// Work-stealing thread pool (src/core/thread_pool.c)
+// Tasks a worker spawns go to its own deque; idle workers steal the oldest ones from the others.
+typedef void (*TaskFunction)(void* arg);
+typedef void (*ParallelForFunction)(size_t begin, size_t end, void* context);
+
+// Chase-Lev deque: only its owner pushes and pops (LIFO), any thread steals (FIFO).
+WorkDeque* work_deque_create(void);
+void work_deque_destroy(WorkDeque* deque);
+bool work_deque_push(WorkDeque* deque, void* item);
+void* work_deque_pop(WorkDeque* deque);
+void* work_deque_steal(WorkDeque* deque);
+size_t work_deque_size(const WorkDeque* deque);
+
+// Pool sizes above this are refused by the CLI and deptrack.json
+#define THREAD_POOL_MAX_WORKERS 1024
+// workers == 0 starts one per CPU.
+ThreadPool* thread_pool_create(size_t workers);
+void thread_pool_destroy(ThreadPool* pool);
+size_t thread_pool_size(const ThreadPool* pool);
+bool thread_pool_in_worker(const ThreadPool* pool);
+TaskGroup* task_group_create(ThreadPool* pool);
+// Waits for outstanding tasks first.
+void task_group_destroy(TaskGroup* group);
+int task_group_spawn(TaskGroup* group, TaskFunction function, void* arg);
+// Queues behind everything already waiting instead of on the caller's deque, for tasks that yield.
+int task_group_defer(TaskGroup* group, TaskFunction function, void* arg);
+// Tasks not yet started are dropped; running ones see task_group_cancelled.
+void task_group_cancel(TaskGroup* group);
+bool task_group_cancelled(const TaskGroup* group);
+// Runs pool tasks while waiting; DEPTRACK_ERROR_CANCELLED if the group was cancelled.
+int task_group_wait(TaskGroup* group);
+// Calls function on subranges of at most grain items (0 picks one); pool may be NULL to run serially.
+int thread_pool_parallel_for(ThreadPool* pool, size_t begin, size_t end, size_t grain,
+                             ParallelForFunction function, void* context);
+
+// Configuration (src/core/config_manager.c)
+// deptrack.json scalars by dotted path: "jobs", "pipeline.queue_size", "pipeline.stage_threads.2".
+ConfigManager* config_manager_create(void);
+void config_manager_destroy(ConfigManager* config);
+int config_manager_load_buffer(ConfigManager* config, const char* buffer, size_t length);
+// DEPTRACK_ERROR_FILE_NOT_FOUND if path cannot be read, DEPTRACK_ERROR_CONFIG if it is not valid JSON.
+int config_manager_load(ConfigManager* config, const char* path);
+const char* config_manager_path(const ConfigManager* config);
+// Strings are unescaped, numbers and booleans kept as written; NULL when the key is absent or null.
+const char* config_get_string(const ConfigManager* config, const char* key);
+long config_get_int(const ConfigManager* config, const char* key, long fallback);
+
+// The JSON reader behind it: every scalar in document order, objects and arrays flattened.
+typedef struct {
+    const char* path;          // Dotted, as config_get_string takes it; array elements are numbered from 0
+    size_t depth;              // Members and elements it is nested in, 1 for a top-level member
+    const char* key;           // Innermost member name, which may itself contain dots; NULL in arrays
+    const char* value;         // Unescaped string, source text of numbers and booleans, NULL for null
+    bool string;               // value was a JSON string
+    size_t offset;             // Of the value in the buffer
+} JsonValue;
+
+// Visitors return DEPTRACK_SUCCESS to continue or an error code to stop the parse.
+typedef int (*JsonVisitFunction)(const JsonValue* value, void* context);
+// The document must be an object; DEPTRACK_ERROR_PARSE_FAILED if it is not valid JSON.
+int json_parse_buffer(const char* buffer, size_t length, JsonVisitFunction visit, void* context);
+
+// JSON output (src/output/json_generator.c)
+typedef struct {
+    bool pretty;               // Two-space indentation; compact output has no whitespace at all
+    const char* root_path;     // Written as "root_path"; may be NULL
+    ThreadPool* pool;          // For graph_sort; may be NULL
+    SimdIsa max_isa;           // Caps the escape scan (tests, benchmarks)
+} JsonOutputOptions;
+
+void json_output_options_default(JsonOutputOptions* options);
+// Streams the graph to fd in graph_sort order; options may be NULL for the defaults.
+int json_generate(const DependencyGraph* graph, int fd, const JsonOutputOptions* options);
+int json_generate_file(const DependencyGraph* graph, const char* path, const JsonOutputOptions* options);
+// Offset of the first byte JSON strings must escape ('"', '\\', below 0x20) or check as UTF-8 (0x80 and up),
+// or length if there is none.
+size_t json_escape_scan(const char* text, size_t length, SimdIsa max_isa);
+// Writes text as a quoted, escaped JSON string, or null; the command-line reports all go through it.
+void json_write_string(FILE* out, const char* text);
+
+// Graph snapshots (src/core/graph_snapshot.c)
+// A versioned binary file of the graph that graph_snapshot_open maps without reading it through; node and
+// edge numbers follow graph_sort order, so nodes ascend by id.
+typedef struct GraphSnapshot GraphSnapshot;
+
+typedef struct {
+    const uint8_t* data;
+    const uint8_t* end;
+    size_t remaining;
+    size_t neighbor;
+    size_t edge;
+    size_t node_count;
+    bool has_edges;
+} SnapshotCursor;
+
+// Replaces path atomically, so processes that have the old snapshot open keep reading it.
+int graph_snapshot_write(const DependencyGraph* graph, ThreadPool* pool, const char* path);
+// Checks the header and section table only: DEPTRACK_ERROR_PARSE_FAILED for a file that is not a snapshot.
+int graph_snapshot_open(const char* path, GraphSnapshot** snapshot);
+void graph_snapshot_close(GraphSnapshot* snapshot);
+// Reads the whole file: DEPTRACK_ERROR_PARSE_FAILED when the checksum does not match.
+int graph_snapshot_verify(const GraphSnapshot* snapshot);
+// CRC-32C, as stored in the header
+uint32_t graph_snapshot_checksum(const void* data, size_t length, SimdIsa max_isa);
+size_t graph_snapshot_node_count(const GraphSnapshot* snapshot);
+size_t graph_snapshot_edge_count(const GraphSnapshot* snapshot);
+// SIZE_MAX when no node has the id
+size_t graph_snapshot_find_node(const GraphSnapshot* snapshot, const char* id);
+const char* graph_snapshot_node_id(const GraphSnapshot* snapshot, size_t node);
+const char* graph_snapshot_node_name(const GraphSnapshot* snapshot, size_t node);
+const char* graph_snapshot_node_filepath(const GraphSnapshot* snapshot, size_t node);
+NodeType graph_snapshot_node_type(const GraphSnapshot* snapshot, size_t node);
+DependencyType graph_snapshot_edge_type(const GraphSnapshot* snapshot, size_t edge);
+const char* graph_snapshot_edge_version(const GraphSnapshot* snapshot, size_t edge);
+// Targets of the node's edges in ascending order, each with its edge number.
+void graph_snapshot_dependencies(const GraphSnapshot* snapshot, size_t node, SnapshotCursor* cursor);
+// Sources of edges into the node in ascending order; edge numbers are not kept, so *edge is SIZE_MAX.
+void graph_snapshot_dependents(const GraphSnapshot* snapshot, size_t node, SnapshotCursor* cursor);
+bool snapshot_cursor_next(SnapshotCursor* cursor, size_t* neighbor, size_t* edge);
+
+// Hash map (src/utils/hash_map.c)
+HashMap* hashmap_create(size_t bucket_count);
+void hashmap_destroy(HashMap* map);
+int hashmap_put(HashMap* map, const char* key, size_t value);
+int hashmap_put_n(HashMap* map, const char* key, size_t key_length, size_t value);
+int hashmap_get(const HashMap* map, const char* key, size_t* value);
+int hashmap_get_n(const HashMap* map, const char* key, size_t key_length, size_t* value);
+size_t hashmap_size(const HashMap* map);
+
+// String interning (src/utils/string_pool.c)
+// Equal strings get one handle; handles count up from 0 and are never reused. Not thread-safe.
+StringPool* string_pool_create(void);
+void string_pool_destroy(StringPool* pool);
+// A NULL text interns to STRING_NONE.
+int string_pool_intern(StringPool* pool, const char* text, StringHandle* handle);
+// STRING_NONE if text was never interned.
+StringHandle string_pool_find(const StringPool* pool, const char* text);
+// NULL for STRING_NONE; valid until the next intern.
+const char* string_pool_get(const StringPool* pool, StringHandle handle);
+size_t string_pool_count(const StringPool* pool);
+
+// Filesystem helpers (src/utils/file_utils.c)
+// Visitors return DEPTRACK_SUCCESS to continue the walk or an error code to stop it.
+typedef int (*FileVisitFunction)(const char* path, void* context);
+
+int file_walk(const char* root, FileVisitFunction visit, void* context);
+bool file_has_suffix(const char* path, const char* suffix);
+// Hidden, vendored and build output directories file_walk does not enter.
+bool file_is_skipped_directory(const char* name);
+// Lexically collapses "." and "dir/.." components in place; "./a" becomes "a", "" becomes ".".
+void file_normalize_path(char* path);
+
 // Utility functions
 const char* deptrack_version_string(void);
 const char* deptrack_language_name(Language lang);
@@ -210,7 +1406,9 @@ typedef enum {
     DEPTRACK_ERROR_MEMORY = -4,
     DEPTRACK_ERROR_THREAD = -5,
     DEPTRACK_ERROR_CONFIG = -6,
-    DEPTRACK_ERROR_OUTPUT = -7
+    DEPTRACK_ERROR_OUTPUT = -7,
+    DEPTRACK_ERROR_CYCLE = -8,
+    DEPTRACK_ERROR_CANCELLED = -9
 } DeptrackError;
 
 const char* deptrack_error_string(DeptrackError error);
@@ -253,6 +1451,8 @@ void test_context_init(void);
 void test_context_cleanup(void);
 void test_run(const char* test_name, void (*test_func)(void));
 void test_print_summary(void);
+// Writes content to dir/name (tests/test_utils.c)
+void write_fixture(const char* dir, const char* name, const char* content);
 
 #endif // TESTING
 
@@ -1 +1,158 @@
-// Stub implementation for graph_analyzer
+/**
+ * @file graph_analyzer.c
+ * @brief Graph analysis algorithms over index-based DAGs
+ * @author Unhinged Development Team
+ *
+ * @llm-type service
+ * @llm-legend Scheduling analysis shared by compose startup, build targets and CI jobs
+ * @llm-key Kahn's algorithm processed level by level yields the minimum number of sequential
+ *          waves; a longest-path pass over the same order yields the cost-weighted critical path
+ * @llm-contract Nodes are dense indices [0, node_count); a DagSchedule owns its arrays
+ */
+
+#include "dependency_tracker.h"
+#include <stdint.h>
+#include <string.h>
+
+void dag_schedule_destroy(DagSchedule* schedule) {
+    if (!schedule) return;
+
+    free(schedule->order);
+    free(schedule->wave_of);
+    free(schedule->wave_offsets);
+    free(schedule->critical_path);
+    memset(schedule, 0, sizeof(DagSchedule));
+}
+
+int dag_schedule_compute(size_t node_count, const size_t* edge_from, const size_t* edge_to,
+                         size_t edge_count, const double* costs, DagSchedule* schedule) {
+    if (!schedule || (edge_count > 0 && (!edge_from || !edge_to))) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    memset(schedule, 0, sizeof(DagSchedule));
+    schedule->node_count = node_count;
+
+    for (size_t i = 0; i < edge_count; i++) {
+        if (edge_from[i] >= node_count || edge_to[i] >= node_count) {
+            return DEPTRACK_ERROR_INVALID_PARAM;
+        }
+    }
+
+    if (node_count == 0) {
+        return DEPTRACK_SUCCESS;
+    }
+
+    // Successor lists in CSR form
+    size_t* offsets = calloc(node_count + 1, sizeof(size_t));
+    size_t* successors = calloc(edge_count ? edge_count : 1, sizeof(size_t));
+    size_t* in_degree = calloc(node_count, sizeof(size_t));
+    size_t* fill = calloc(node_count, sizeof(size_t));
+    size_t* pred = malloc(node_count * sizeof(size_t));
+    double* start = calloc(node_count, sizeof(double));
+    double* finish = calloc(node_count, sizeof(double));
+
+    schedule->order = malloc(node_count * sizeof(size_t));
+    schedule->wave_of = malloc(node_count * sizeof(size_t));
+    schedule->wave_offsets = calloc(node_count + 1, sizeof(size_t));
+
+    if (!offsets || !successors || !in_degree || !fill || !pred || !start || !finish ||
+        !schedule->order || !schedule->wave_of || !schedule->wave_offsets) {
+        free(offsets); free(successors); free(in_degree); free(fill);
+        free(pred); free(start); free(finish);
+        dag_schedule_destroy(schedule);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+
+    for (size_t i = 0; i < edge_count; i++) {
+        offsets[edge_from[i] + 1]++;
+        in_degree[edge_to[i]]++;
+    }
+    for (size_t n = 0; n < node_count; n++) {
+        offsets[n + 1] += offsets[n];
+    }
+    for (size_t i = 0; i < edge_count; i++) {
+        size_t from = edge_from[i];
+        successors[offsets[from] + fill[from]++] = edge_to[i];
+    }
+
+    for (size_t n = 0; n < node_count; n++) {
+        schedule->wave_of[n] = SIZE_MAX;
+        pred[n] = SIZE_MAX;
+    }
+
+    // First wave: everything without prerequisites, in index order for stable output
+    size_t tail = 0;
+    for (size_t n = 0; n < node_count; n++) {
+        if (in_degree[n] == 0) {
+            schedule->order[tail++] = n;
+        }
+    }
+
+    size_t head = 0;
+    while (head < tail) {
+        size_t wave_end = tail;
+        schedule->wave_offsets[schedule->wave_count] = head;
+
+        for (; head < wave_end; head++) {
+            size_t node = schedule->order[head];
+            schedule->wave_of[node] = schedule->wave_count;
+            finish[node] = start[node] + (costs ? costs[node] : 1.0);
+
+            for (size_t e = offsets[node]; e < offsets[node + 1]; e++) {
+                size_t next = successors[e];
+                if (pred[next] == SIZE_MAX || finish[node] > start[next]) {
+                    start[next] = finish[node];
+                    pred[next] = node;
+                }
+                if (--in_degree[next] == 0) {
+                    schedule->order[tail++] = next;
+                }
+            }
+        }
+
+        schedule->wave_count++;
+    }
+    schedule->wave_offsets[schedule->wave_count] = tail;
+    schedule->scheduled_count = tail;
+
+    // Walk the critical path back from the latest-finishing scheduled node
+    if (tail > 0) {
+        size_t last = schedule->order[0];
+        for (size_t i = 1; i < tail; i++) {
+            if (finish[schedule->order[i]] > finish[last]) {
+                last = schedule->order[i];
+            }
+        }
+        schedule->critical_path_cost = finish[last];
+
+        size_t length = 0;
+        for (size_t n = last; n != SIZE_MAX; n = pred[n]) {
+            length++;
+        }
+
+        schedule->critical_path = malloc(length * sizeof(size_t));
+        if (schedule->critical_path) {
+            size_t i = length;
+            for (size_t n = last; n != SIZE_MAX; n = pred[n]) {
+                schedule->critical_path[--i] = n;
+            }
+            schedule->critical_path_length = length;
+        }
+    }
+
+    free(offsets);
+    free(successors);
+    free(in_degree);
+    free(fill);
+    free(pred);
+    free(start);
+    free(finish);
+
+    if (!schedule->critical_path && tail > 0) {
+        dag_schedule_destroy(schedule);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+
+    return schedule->scheduled_count == node_count ? DEPTRACK_SUCCESS : DEPTRACK_ERROR_CYCLE;
+}
@@ -1,8 +1,410 @@
 /**
  * @file config_manager.c
- * @brief Configuration manager implementation (stub)
+ * @brief deptrack.json reader
+ * @author Unhinged Development Team
+ *
+ * @llm-type config
+ * @llm-legend Loads the tracker's JSON configuration into a flat key/value table
+ * @llm-key One recursive pass over the buffer; every scalar is stored under its dotted path, with array
+ *          elements numbered from 0, so "pipeline": {"stage_threads": [1, 2]} yields
+ *          "pipeline.stage_threads.0" and "pipeline.stage_threads.1"
+ * @llm-map The pass is json_parse_buffer, which hands each scalar to a visitor; package.json manifests
+ *          are read through it as well
+ * @llm-contract Strings are stored unescaped, numbers and booleans as written; a later duplicate key
+ *               replaces the earlier value, as most JSON readers do
  */
 
 #include "dependency_tracker.h"
+#include <ctype.h>
+#include <errno.h>
 
-// Stub implementation - TODO: Implement configuration management
+#define CONFIG_PATH_BUFFER 512
+#define CONFIG_MAX_DEPTH 32
+
+struct ConfigManager {
+    char* config_path;
+    HashMap* index;            // Dotted key -> values index
+    char** values;             // NULL for JSON null
+    size_t value_count;
+    size_t value_capacity;
+};
+
+typedef struct {
+    JsonVisitFunction visit;
+    void* context;
+    const char* start;
+    const char* cur;
+    const char* end;
+    char path[CONFIG_PATH_BUFFER];
+    size_t path_length;
+    const char* key;           // Name of the member being read, NULL in arrays
+    size_t offset;             // Of the scalar being read
+    int depth;
+    int status;
+} JsonReader;
+
+ConfigManager* config_manager_create(void) {
+    ConfigManager* config = calloc(1, sizeof(ConfigManager));
+    if (!config) return NULL;
+    config->index = hashmap_create(64);
+    if (!config->index) {
+        free(config);
+        return NULL;
+    }
+    return config;
+}
+
+void config_manager_destroy(ConfigManager* config) {
+    if (!config) return;
+    for (size_t i = 0; i < config->value_count; i++) {
+        free(config->values[i]);
+    }
+    free(config->values);
+    hashmap_destroy(config->index);
+    free(config->config_path);
+    free(config);
+}
+
+const char* config_manager_path(const ConfigManager* config) {
+    return config ? config->config_path : NULL;
+}
+
+const char* config_get_string(const ConfigManager* config, const char* key) {
+    size_t index;
+    if (!config || !key || hashmap_get(config->index, key, &index) != 0) return NULL;
+    return config->values[index];
+}
+
+long config_get_int(const ConfigManager* config, const char* key, long fallback) {
+    const char* text = config_get_string(config, key);
+    if (!text) return fallback;
+
+    char* end;
+    errno = 0;
+    long value = strtol(text, &end, 10);
+    return errno == 0 && end != text && *end == '\0' ? value : fallback;
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+static bool json_fail(JsonReader* r) {
+    if (r->status == DEPTRACK_SUCCESS) r->status = DEPTRACK_ERROR_PARSE_FAILED;
+    return false;
+}
+
+static void skip_space(JsonReader* r) {
+    while (r->cur < r->end && isspace((unsigned char)*r->cur)) r->cur++;
+}
+
+static bool expect(JsonReader* r, char c) {
+    skip_space(r);
+    if (r->cur >= r->end || *r->cur != c) return json_fail(r);
+    r->cur++;
+    return true;
+}
+
+// Hands one scalar to the visitor; takes ownership of value
+static bool emit(JsonReader* r, char* value, bool string) {
+    JsonValue scalar = { r->path, (size_t)r->depth - 1, r->key, value, string, r->offset };
+    int result = r->visit(&scalar, r->context);
+    free(value);
+    if (result != DEPTRACK_SUCCESS) {
+        r->status = result;
+        return false;
+    }
+    return true;
+}
+
+static bool append_utf8(char* out, size_t* length, unsigned code) {
+    if (code < 0x80) {
+        out[(*length)++] = (char)code;
+    } else if (code < 0x800) {
+        out[(*length)++] = (char)(0xC0 | (code >> 6));
+        out[(*length)++] = (char)(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out[(*length)++] = (char)(0xE0 | (code >> 12));
+        out[(*length)++] = (char)(0x80 | ((code >> 6) & 0x3F));
+        out[(*length)++] = (char)(0x80 | (code & 0x3F));
+    } else if (code < 0x110000) {
+        out[(*length)++] = (char)(0xF0 | (code >> 18));
+        out[(*length)++] = (char)(0x80 | ((code >> 12) & 0x3F));
+        out[(*length)++] = (char)(0x80 | ((code >> 6) & 0x3F));
+        out[(*length)++] = (char)(0x80 | (code & 0x3F));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool read_hex4(JsonReader* r, unsigned* code) {
+    if (r->end - r->cur < 4) return false;
+    *code = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = *r->cur++;
+        unsigned digit;
+        if (c >= '0' && c <= '9') digit = (unsigned)(c - '0');
+        else if (c >= 'a' && c <= 'f') digit = (unsigned)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') digit = (unsigned)(c - 'A' + 10);
+        else return false;
+        *code = *code * 16 + digit;
+    }
+    return true;
+}
+
+// Decoded string, or NULL with r->status set; the opening quote is already consumed
+static char* read_string(JsonReader* r) {
+    // Escapes never decode longer than they are written, so the raw length bounds the result
+    const char* start = r->cur;
+    while (r->cur < r->end && *r->cur != '"') {
+        if (*r->cur == '\\') r->cur++;
+        r->cur++;
+    }
+    if (r->cur >= r->end) {
+        json_fail(r);
+        return NULL;
+    }
+    const char* stop = r->cur++;
+    char* out = malloc((size_t)(stop - start) + 1);
+    if (!out) {
+        r->status = DEPTRACK_ERROR_MEMORY;
+        return NULL;
+    }
+
+    size_t length = 0;
+    const char* saved = r->cur;
+    r->cur = start;
+    bool ok = true;
+    while (ok && r->cur < stop) {
+        char c = *r->cur++;
+        if ((unsigned char)c < 0x20) {
+            ok = false;
+        } else if (c != '\\') {
+            out[length++] = c;
+        } else {
+            char e = *r->cur++;
+            unsigned code;
+            switch (e) {
+                case '"': case '\\': case '/': out[length++] = e; break;
+                case 'b': out[length++] = '\b'; break;
+                case 'f': out[length++] = '\f'; break;
+                case 'n': out[length++] = '\n'; break;
+                case 'r': out[length++] = '\r'; break;
+                case 't': out[length++] = '\t'; break;
+                case 'u':
+                    ok = read_hex4(r, &code);
+                    if (ok && code >= 0xD800 && code < 0xDC00) {
+                        // A surrogate pair is 12 bytes written and 4 decoded
+                        unsigned low;
+                        ok = r->cur + 1 < stop && r->cur[0] == '\\' && r->cur[1] == 'u';
+                        if (ok) {
+                            r->cur += 2;
+                            ok = read_hex4(r, &low) && low >= 0xDC00 && low < 0xE000;
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                    }
+                    ok = ok && append_utf8(out, &length, code);
+                    break;
+                default: ok = false; break;
+            }
+        }
+    }
+    r->cur = saved;
+    if (!ok) {
+        free(out);
+        json_fail(r);
+        return NULL;
+    }
+    out[length] = '\0';
+    return out;
+}
+
+static bool read_literal(JsonReader* r) {
+    const char* start = r->cur;
+    if (*r->cur == '-') r->cur++;
+    while (r->cur < r->end && (isalnum((unsigned char)*r->cur) || *r->cur == '.' || *r->cur == '+' ||
+                               *r->cur == '-')) {
+        r->cur++;
+    }
+    size_t length = (size_t)(r->cur - start);
+    if (length == 0) return json_fail(r);
+    if (length == 4 && memcmp(start, "null", 4) == 0) {
+        return emit(r, NULL, false);
+    }
+    bool number = isdigit((unsigned char)start[start[0] == '-' ? 1 : 0]);
+    if (!number && !(length == 4 && memcmp(start, "true", 4) == 0) &&
+        !(length == 5 && memcmp(start, "false", 5) == 0)) {
+        return json_fail(r);
+    }
+    char* value = strndup(start, length);
+    if (!value) {
+        r->status = DEPTRACK_ERROR_MEMORY;
+        return false;
+    }
+    return emit(r, value, false);
+}
+
+// Appends ".segment" (or "segment" at the top) to the path; returns the previous length
+static bool push_path(JsonReader* r, const char* segment, size_t segment_length, size_t* saved) {
+    *saved = r->path_length;
+    size_t separator = r->path_length > 0 ? 1 : 0;
+    if (r->path_length + separator + segment_length >= sizeof(r->path)) return json_fail(r);
+    if (separator) r->path[r->path_length++] = '.';
+    memcpy(r->path + r->path_length, segment, segment_length);
+    r->path_length += segment_length;
+    r->path[r->path_length] = '\0';
+    return true;
+}
+
+static void pop_path(JsonReader* r, size_t saved) {
+    r->path_length = saved;
+    r->path[saved] = '\0';
+}
+
+static bool read_value(JsonReader* r);
+
+static bool read_object(JsonReader* r) {
+    skip_space(r);
+    if (r->cur < r->end && *r->cur == '}') {
+        r->cur++;
+        return true;
+    }
+    for (;;) {
+        if (!expect(r, '"')) return false;
+        char* key = read_string(r);
+        if (!key) return false;
+        size_t saved;
+        r->key = key;
+        bool ok = push_path(r, key, strlen(key), &saved) && expect(r, ':') && read_value(r);
+        free(key);
+        if (!ok) return false;
+        pop_path(r, saved);
+
+        skip_space(r);
+        if (r->cur < r->end && *r->cur == ',') {
+            r->cur++;
+            continue;
+        }
+        return expect(r, '}');
+    }
+}
+
+static bool read_array(JsonReader* r) {
+    skip_space(r);
+    if (r->cur < r->end && *r->cur == ']') {
+        r->cur++;
+        return true;
+    }
+    for (size_t index = 0;; index++) {
+        char segment[24];
+        int length = snprintf(segment, sizeof(segment), "%zu", index);
+        size_t saved;
+        r->key = NULL;
+        if (!push_path(r, segment, (size_t)length, &saved) || !read_value(r)) return false;
+        pop_path(r, saved);
+
+        skip_space(r);
+        if (r->cur < r->end && *r->cur == ',') {
+            r->cur++;
+            continue;
+        }
+        return expect(r, ']');
+    }
+}
+
+static bool read_value(JsonReader* r) {
+    skip_space(r);
+    if (r->cur >= r->end) return json_fail(r);
+    if (++r->depth > CONFIG_MAX_DEPTH) return json_fail(r);
+
+    bool ok;
+    char c = *r->cur;
+    r->offset = (size_t)(r->cur - r->start);
+    if (c == '{') {
+        r->cur++;
+        ok = read_object(r);
+    } else if (c == '[') {
+        r->cur++;
+        ok = read_array(r);
+    } else if (c == '"') {
+        r->cur++;
+        char* value = read_string(r);
+        ok = value && emit(r, value, true);
+    } else {
+        ok = read_literal(r);
+    }
+    r->depth--;
+    return ok;
+}
+
+int json_parse_buffer(const char* buffer, size_t length, JsonVisitFunction visit, void* context) {
+    if (!buffer || !visit) return DEPTRACK_ERROR_INVALID_PARAM;
+
+    JsonReader r = { .visit = visit, .context = context, .start = buffer, .cur = buffer, .end = buffer + length,
+                     .status = DEPTRACK_SUCCESS };
+    skip_space(&r);
+    if (r.cur >= r.end || *r.cur != '{') return DEPTRACK_ERROR_PARSE_FAILED;
+    if (read_value(&r)) {
+        skip_space(&r);
+        if (r.cur != r.end) json_fail(&r);
+    }
+    return r.status;
+}
+
+// ---------------------------------------------------------------------------
+// Loading
+// ---------------------------------------------------------------------------
+
+static int store_value(const JsonValue* value, void* context) {
+    ConfigManager* config = context;
+    char* copy = NULL;
+    if (value->value && !(copy = strdup(value->value))) return DEPTRACK_ERROR_MEMORY;
+
+    size_t index;
+    if (hashmap_get(config->index, value->path, &index) == 0) {
+        free(config->values[index]);
+        config->values[index] = copy;
+        return DEPTRACK_SUCCESS;
+    }
+    if (config->value_count >= config->value_capacity) {
+        size_t capacity = config->value_capacity ? config->value_capacity * 2 : 16;
+        char** grown = realloc(config->values, capacity * sizeof(char*));
+        if (!grown) {
+            free(copy);
+            return DEPTRACK_ERROR_MEMORY;
+        }
+        config->values = grown;
+        config->value_capacity = capacity;
+    }
+    if (hashmap_put(config->index, value->path, config->value_count) != DEPTRACK_SUCCESS) {
+        free(copy);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+    config->values[config->value_count++] = copy;
+    return DEPTRACK_SUCCESS;
+}
+
+int config_manager_load_buffer(ConfigManager* config, const char* buffer, size_t length) {
+    if (!config || !buffer) return DEPTRACK_ERROR_INVALID_PARAM;
+
+    int result = json_parse_buffer(buffer, length, store_value, config);
+    return result == DEPTRACK_ERROR_PARSE_FAILED ? DEPTRACK_ERROR_CONFIG : result;
+}
+
+int config_manager_load(ConfigManager* config, const char* path) {
+    if (!config || !path) return DEPTRACK_ERROR_INVALID_PARAM;
+
+    size_t length;
+    char* buffer = parser_read_file(path, &length);
+    if (!buffer) return DEPTRACK_ERROR_FILE_NOT_FOUND;
+    int result = config_manager_load_buffer(config, buffer, length);
+    free(buffer);
+    if (result != DEPTRACK_SUCCESS) return result;
+
+    char* copy = strdup(path);
+    if (!copy) return DEPTRACK_ERROR_MEMORY;
+    free(config->config_path);
+    config->config_path = copy;
+    return DEPTRACK_SUCCESS;
+}
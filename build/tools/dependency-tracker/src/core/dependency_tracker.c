@@ -21,12 +21,6 @@ struct FileCache {
     pthread_mutex_t mutex;
 };
 
-// Config manager structure (stub)
-struct ConfigManager {
-    char* config_path;
-    void* config_data;  // TODO: Implement configuration storage
-};
-
 // Output generator structure (stub)
 struct OutputGenerator {
     OutputFormat format;
@@ -44,6 +38,10 @@ static const char* language_names[] = {
     [LANG_YAML] = "YAML",
     [LANG_SQL] = "SQL",
     [LANG_PROTO] = "Protocol Buffers",
+    [LANG_C] = "C/C++",
+    [LANG_MAKE] = "Makefile",
+    [LANG_SHELL] = "Shell",
+    [LANG_DOCKER] = "Docker",
     [LANG_UNKNOWN] = "Unknown"
 };
 
@@ -65,7 +63,9 @@ static const char* error_messages[] = {
     [-DEPTRACK_ERROR_MEMORY] = "Memory allocation failed",
     [-DEPTRACK_ERROR_THREAD] = "Thread operation failed",
     [-DEPTRACK_ERROR_CONFIG] = "Configuration error",
-    [-DEPTRACK_ERROR_OUTPUT] = "Output generation failed"
+    [-DEPTRACK_ERROR_OUTPUT] = "Output generation failed",
+    [-DEPTRACK_ERROR_CYCLE] = "Circular dependency detected",
+    [-DEPTRACK_ERROR_CANCELLED] = "Operation cancelled"
 };
 
 DependencyTracker* deptrack_create(void) {
@@ -82,6 +82,7 @@ DependencyTracker* deptrack_create(void) {
     
     tracker->initialized = false;
     tracker->parser_count = 0;
+    pipeline_config_default(&tracker->pipeline);
     
     return tracker;
 }
@@ -89,6 +90,9 @@ DependencyTracker* deptrack_create(void) {
 void deptrack_destroy(DependencyTracker* tracker) {
     if (!tracker) return;
     
+    // Workers may still reference the tracker, so they stop first
+    thread_pool_destroy(tracker->pool);
+
     // Destroy mutex
     pthread_mutex_destroy(&tracker->mutex);
     
@@ -104,10 +108,7 @@ void deptrack_destroy(DependencyTracker* tracker) {
     }
     
     // Clean up config
-    if (tracker->config) {
-        free(tracker->config->config_path);
-        free(tracker->config);
-    }
+    config_manager_destroy(tracker->config);
     
     // Clean up output generator
     if (tracker->output) {
@@ -115,10 +116,13 @@ void deptrack_destroy(DependencyTracker* tracker) {
         free(tracker->output);
     }
     
-    // Clean up parsers
-    for (size_t i = 0; i < tracker->parser_count; i++) {
+    version_catalog_destroy(tracker->catalog);
+    free(tracker->root_path);
+
+    // Clean up parsers (slots are indexed by language, so they may be sparse)
+    for (size_t i = 0; i < MAX_LANGUAGES; i++) {
         if (tracker->parsers[i]) {
-            // TODO: Implement parser cleanup
+            keyword_matcher_destroy(tracker->parsers[i]->keyword_matcher);
             free(tracker->parsers[i]);
         }
     }
@@ -126,6 +130,43 @@ void deptrack_destroy(DependencyTracker* tracker) {
     free(tracker);
 }
 
+// Settings in deptrack.json override the defaults deptrack_create set; absent keys leave them alone.
+// Jobs outside 1..THREAD_POOL_MAX_WORKERS, stage thread counts outside 1..PIPELINE_MAX_STAGE_THREADS and queue
+// sizes outside 1..PIPELINE_MAX_QUEUE_CAPACITY are refused rather than ignored.
+static int apply_config(DependencyTracker* tracker) {
+    if (config_get_string(tracker->config, "jobs")) {
+        long jobs = config_get_int(tracker->config, "jobs", 0);
+        if (jobs <= 0 || jobs > THREAD_POOL_MAX_WORKERS) {
+            return DEPTRACK_ERROR_CONFIG;
+        }
+        tracker->jobs = (size_t)jobs;
+    }
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+        char key[64];
+        snprintf(key, sizeof(key), "pipeline.stage_threads.%zu", s);
+        if (!config_get_string(tracker->config, key)) {
+            continue;
+        }
+        long threads = config_get_int(tracker->config, key, 0);
+        if (threads <= 0 || threads > PIPELINE_MAX_STAGE_THREADS) {
+            return DEPTRACK_ERROR_CONFIG;
+        }
+        tracker->pipeline.threads[s] = (size_t)threads;
+    }
+    if (config_get_string(tracker->config, "pipeline.queue_size")) {
+        long queue_size = config_get_int(tracker->config, "pipeline.queue_size", 0);
+        if (queue_size <= 0 || queue_size > PIPELINE_MAX_QUEUE_CAPACITY) {
+            return DEPTRACK_ERROR_CONFIG;
+        }
+        tracker->pipeline.queue_capacity = (size_t)queue_size;
+    }
+    const char* pretty = config_get_string(tracker->config, "output.pretty_print");
+    if (pretty) {
+        tracker->compact_output = strcmp(pretty, "false") == 0;
+    }
+    return DEPTRACK_SUCCESS;
+}
+
 int deptrack_initialize(DependencyTracker* tracker, const char* config_path) {
     if (!tracker) {
         return DEPTRACK_ERROR_INVALID_PARAM;
@@ -155,14 +196,23 @@ int deptrack_initialize(DependencyTracker* tracker, const char* config_path) {
     }
     
     // Create config manager
-    tracker->config = calloc(1, sizeof(ConfigManager));
+    tracker->config = config_manager_create();
     if (!tracker->config) {
         pthread_mutex_unlock(&tracker->mutex);
         return DEPTRACK_ERROR_MEMORY;
     }
     
     if (config_path) {
-        tracker->config->config_path = strdup(config_path);
+        int loaded = config_manager_load(tracker->config, config_path);
+        if (loaded != DEPTRACK_SUCCESS) {
+            pthread_mutex_unlock(&tracker->mutex);
+            return loaded;
+        }
+        int applied = apply_config(tracker);
+        if (applied != DEPTRACK_SUCCESS) {
+            pthread_mutex_unlock(&tracker->mutex);
+            return applied;
+        }
     }
     
     // Create output generator
@@ -175,9 +225,58 @@ int deptrack_initialize(DependencyTracker* tracker, const char* config_path) {
     tracker->initialized = true;
     
     pthread_mutex_unlock(&tracker->mutex);
+
+    // Parsers with a keyword set get their matcher built once, here
+    int result = deptrack_register_parser(tracker, typescript_parser_create());
+    if (result == DEPTRACK_SUCCESS) {
+        result = deptrack_register_parser(tracker, proto_parser_create());
+    }
+    if (result == DEPTRACK_SUCCESS) {
+        result = deptrack_register_parser(tracker, python_parser_create());
+    }
+    return result;
+}
+
+int deptrack_register_parser(DependencyTracker* tracker, LanguageParser* parser) {
+    if (!tracker || !parser) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+    if (parser->language < 0 || parser->language >= MAX_LANGUAGES) {
+        free(parser);
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    if (parser->keyword_count > 0 && !parser->keyword_matcher) {
+        parser->keyword_matcher = keyword_matcher_create(parser->keywords, parser->keyword_count,
+                                                         KEYWORD_MATCH_WHOLE_WORD);
+        if (!parser->keyword_matcher) {
+            free(parser);
+            return DEPTRACK_ERROR_MEMORY;
+        }
+    }
+
+    pthread_mutex_lock(&tracker->mutex);
+    LanguageParser* previous = tracker->parsers[parser->language];
+    tracker->parsers[parser->language] = parser;
+    if (!previous) {
+        tracker->parser_count++;
+    }
+    pthread_mutex_unlock(&tracker->mutex);
+
+    if (previous) {
+        keyword_matcher_destroy(previous->keyword_matcher);
+        free(previous);
+    }
     return DEPTRACK_SUCCESS;
 }
 
+LanguageParser* deptrack_get_parser(DependencyTracker* tracker, Language lang) {
+    if (!tracker || lang < 0 || lang >= MAX_LANGUAGES) {
+        return NULL;
+    }
+    return tracker->parsers[lang];
+}
+
 int deptrack_analyze_directory(DependencyTracker* tracker, const char* root_path) {
     if (!tracker || !root_path) {
         return DEPTRACK_ERROR_INVALID_PARAM;
@@ -186,18 +285,142 @@ int deptrack_analyze_directory(DependencyTracker* tracker, const char* root_path
     if (!tracker->initialized) {
         return DEPTRACK_ERROR_CONFIG;
     }
+
+    // Version catalogs are indexed once per root and shared by every build script under it
+    if (!tracker->catalog || strcmp(tracker->catalog->root, root_path) != 0) {
+        version_catalog_destroy(tracker->catalog);
+        tracker->catalog = version_catalog_load(root_path);
+        if (!tracker->catalog) {
+            return DEPTRACK_ERROR_MEMORY;
+        }
+    }
+    if (!tracker->root_path || strcmp(tracker->root_path, root_path) != 0) {
+        char* copy = strdup(root_path);
+        if (!copy) {
+            return DEPTRACK_ERROR_MEMORY;
+        }
+        free(tracker->root_path);
+        tracker->root_path = copy;
+    }
     
-    // TODO: Implement directory analysis
-    // - Walk directory tree
-    // - Identify files by language
-    // - Parse each file with appropriate parser
-    // - Build dependency graph
-    
-    return DEPTRACK_SUCCESS;
+    return pipeline_run(tracker, root_path, &tracker->pipeline, &tracker->pipeline_metrics);
+}
+
+// Extensionless scripts are recognized by their shebang or modeline
+static Language detect_language_with_content(const char* filepath) {
+    Language lang = deptrack_detect_language(filepath);
+    if (lang != LANG_UNKNOWN) {
+        return lang;
+    }
+
+    char head[512];
+    FILE* file = fopen(filepath, "rb");
+    if (!file) {
+        return LANG_UNKNOWN;
+    }
+    size_t length = fread(head, 1, sizeof(head), file);
+    fclose(file);
+    return language_classify(filepath, head, length);
+}
+
+bool deptrack_has_parser(Language lang, const char* filepath) {
+    (void)filepath;   // Every language parses all of its files
+    return lang >= 0 && lang < LANG_UNKNOWN;
+}
+
+ParsedFile* deptrack_parse_buffer(DependencyTracker* tracker, const char* filepath, Language lang,
+                                  const char* buffer, size_t length) {
+    if (!filepath || !buffer) {
+        return NULL;
+    }
+
+    ParsedFile* parsed = NULL;
+    switch (lang) {
+        case LANG_KOTLIN:
+            if (file_has_suffix(filepath, ".gradle.kts") || file_has_suffix(filepath, ".gradle")) {
+                parsed = parse_gradle_buffer(filepath, buffer, length);
+            } else {
+                parsed = parse_kotlin_source_buffer(filepath, buffer, length);
+            }
+            break;
+        case LANG_TYPESCRIPT: {
+            if (typescript_is_manifest(filepath)) {
+                parsed = parse_package_json_buffer(filepath, buffer, length);
+                break;
+            }
+            LanguageParser* parser = deptrack_get_parser(tracker, LANG_TYPESCRIPT);
+            parsed = typescript_parse_buffer(filepath, buffer, length, parser ? parser->keyword_matcher : NULL);
+            break;
+        }
+        case LANG_PYTHON: {
+            if (python_is_manifest(filepath)) {
+                parsed = parse_python_manifest_buffer(filepath, buffer, length);
+                break;
+            }
+            LanguageParser* parser = deptrack_get_parser(tracker, LANG_PYTHON);
+            parsed = python_scan_imports(filepath, buffer, length, parser ? parser->keyword_matcher : NULL);
+            break;
+        }
+        case LANG_GO:
+            // Sources need their go.mod, which parse_go_buffer finds next to them
+            parsed = parse_go_buffer(filepath, buffer, length);
+            break;
+        case LANG_RUST:
+            parsed = parse_rust_buffer(filepath, buffer, length);
+            break;
+        case LANG_YAML:
+            parsed = ci_is_workflow(filepath) ? parse_ci_workflow_buffer(filepath, buffer, length)
+                                              : parse_yaml_buffer(filepath, buffer, length);
+            break;
+        case LANG_SQL:
+            parsed = parse_sql_buffer(filepath, buffer, length);
+            break;
+        case LANG_PROTO: {
+            LanguageParser* parser = deptrack_get_parser(tracker, LANG_PROTO);
+            parsed = proto_scan_imports(filepath, buffer, length, parser ? parser->keyword_matcher : NULL);
+            break;
+        }
+        case LANG_C:
+            parsed = parse_c_buffer(filepath, buffer, length);
+            break;
+        case LANG_MAKE:
+            parsed = parse_makefile_buffer(filepath, buffer, length);
+            break;
+        case LANG_SHELL:
+            parsed = parse_shell_buffer(filepath, buffer, length);
+            break;
+        case LANG_DOCKER:
+            parsed = parse_dockerfile_buffer(filepath, buffer, length);
+            break;
+        default:
+            break;
+    }
+
+    // The catalog is read-only once loaded, so parse threads share it
+    if (parsed && lang == LANG_KOTLIN && tracker && tracker->catalog) {
+        version_catalog_resolve(tracker->catalog, parsed);
+    }
+    return parsed;
 }
 
-// Forward declaration for parser functions
-extern ParsedFile* parse_kotlin_file(const char* filepath);
+bool deptrack_parser_streams(Language lang) {
+    return lang == LANG_SQL;
+}
+
+ParsedFile* deptrack_parse_file(DependencyTracker* tracker, const char* filepath, Language lang) {
+    if (!filepath) {
+        return NULL;
+    }
+    if (deptrack_parser_streams(lang)) {
+        return parse_sql_file(filepath);
+    }
+
+    size_t length;
+    char* buffer = parser_read_file(filepath, &length);
+    ParsedFile* parsed = buffer ? deptrack_parse_buffer(tracker, filepath, lang, buffer, length) : NULL;
+    free(buffer);
+    return parsed;
+}
 
 int deptrack_analyze_file(DependencyTracker* tracker, const char* filepath) {
     if (!tracker || !filepath) {
@@ -211,36 +434,21 @@ int deptrack_analyze_file(DependencyTracker* tracker, const char* filepath) {
     printf("🔍 Analyzing file: %s\n", filepath);
 
     // Detect language
-    Language lang = deptrack_detect_language(filepath);
+    Language lang = detect_language_with_content(filepath);
     printf("  Language detected: %s\n", deptrack_language_name(lang));
 
-    // Parse file based on language
-    ParsedFile* parsed = NULL;
-    switch (lang) {
-        case LANG_KOTLIN:
-            parsed = parse_kotlin_file(filepath);
-            break;
-        case LANG_TYPESCRIPT:
-            // parsed = parse_typescript_file(filepath);
-            printf("  TypeScript parsing not yet implemented\n");
-            break;
-        case LANG_PYTHON:
-            // parsed = parse_python_file(filepath);
-            printf("  Python parsing not yet implemented\n");
-            break;
-        default:
-            printf("  No parser available for this language\n");
-            return DEPTRACK_SUCCESS;
+    if (!deptrack_has_parser(lang, filepath)) {
+        printf("  No parser available for this language\n");
+        return DEPTRACK_SUCCESS;
     }
 
+    ParsedFile* parsed = deptrack_parse_file(tracker, filepath, lang);
     if (!parsed) {
         printf("  Failed to parse file\n");
         return DEPTRACK_ERROR_PARSE_FAILED;
     }
 
     printf("  Found %zu dependencies\n", parsed->dep_count);
-
-    // Add to graph (simplified - just print for now)
     for (size_t i = 0; i < parsed->dep_count; i++) {
         Dependency* dep = &parsed->dependencies[i];
         printf("    - %s (%s) at line %d\n",
@@ -249,21 +457,83 @@ int deptrack_analyze_file(DependencyTracker* tracker, const char* filepath) {
                dep->line_number);
     }
 
-    // TODO: Actually add to graph structure
+    // Keyed like deptrack_analyze_directory's nodes when the file is under the analyzed root
+    const char* id = filepath;
+    size_t root_length = tracker->root_path ? strlen(tracker->root_path) : 0;
+    if (root_length > 0 && strncmp(filepath, tracker->root_path, root_length) == 0 && filepath[root_length] == '/') {
+        id = filepath + root_length + 1;
+    }
+    int result = deptrack_merge_parsed_file(tracker, parsed, id);
+    parsed_file_destroy(parsed);
+    return result;
+}
 
-    // Cleanup
-    if (parsed->dependencies) {
+static NodeType file_node_type(Language language) {
+    switch (language) {
+        case LANG_SQL: return NODE_DATABASE;
+        case LANG_PROTO: return NODE_API;
+        case LANG_YAML:
+        case LANG_MAKE:
+        case LANG_SHELL:
+        case LANG_DOCKER: return NODE_CONFIG;
+        default: return NODE_LIBRARY;
+    }
+}
+
+// The file's node and its dependency targets go in as one batch, and the edges refer to the handles it returns
+int deptrack_merge_parsed_file(DependencyTracker* tracker, const ParsedFile* parsed, const char* id) {
+    if (!tracker || !tracker->graph || !parsed || !id) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    const char* slash = strrchr(id, '/');
+    size_t count = parsed->dep_count + 1;
+    GraphNode* nodes = malloc(count * sizeof(GraphNode));
+    size_t* handles = malloc(count * sizeof(size_t));
+    GraphBulkEdge* edges = malloc(count * sizeof(GraphBulkEdge));
+    int result = DEPTRACK_ERROR_MEMORY;
+    if (nodes && handles && edges) {
+        nodes[0] = (GraphNode){
+            .id = (char*)id,
+            .name = (char*)(slash ? slash + 1 : id),
+            .type = file_node_type(parsed->language),
+            .filepath = parsed->filepath
+        };
         for (size_t i = 0; i < parsed->dep_count; i++) {
-            free(parsed->dependencies[i].name);
-            free(parsed->dependencies[i].version);
-            free(parsed->dependencies[i].source_file);
+            const Dependency* dep = &parsed->dependencies[i];
+            nodes[i + 1] = (GraphNode){
+                .id = dep->name,
+                .name = dep->name,
+                .type = dep->type == DEP_CONFIG ? NODE_CONFIG : NODE_LIBRARY
+            };
         }
-        free(parsed->dependencies);
+        result = graph_add_nodes_bulk(tracker->graph, nodes, count, handles);
     }
-    free(parsed->filepath);
-    free(parsed);
+    if (result == DEPTRACK_SUCCESS) {
+        for (size_t i = 0; i < parsed->dep_count; i++) {
+            const Dependency* dep = &parsed->dependencies[i];
+            edges[i] = (GraphBulkEdge){ handles[0], handles[i + 1], dep->type, dep->version, id, dep->line_number };
+        }
+        result = graph_add_edges_bulk(tracker->graph, edges, parsed->dep_count);
+    }
+    free(nodes);
+    free(handles);
+    free(edges);
+    return result;
+}
 
-    return DEPTRACK_SUCCESS;
+ThreadPool* deptrack_thread_pool(DependencyTracker* tracker) {
+    if (!tracker) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&tracker->mutex);
+    if (!tracker->pool) {
+        tracker->pool = thread_pool_create(tracker->jobs);
+    }
+    ThreadPool* pool = tracker->pool;
+    pthread_mutex_unlock(&tracker->mutex);
+    return pool;
 }
 
 DependencyGraph* deptrack_get_graph(DependencyTracker* tracker) {
@@ -278,42 +548,24 @@ int deptrack_generate_output(DependencyTracker* tracker, OutputFormat format, co
     if (!tracker || !output_path) {
         return DEPTRACK_ERROR_INVALID_PARAM;
     }
-    
-    // TODO: Implement output generation
-    return DEPTRACK_SUCCESS;
-}
-
-Language deptrack_detect_language(const char* filepath) {
-    if (!filepath) {
-        return LANG_UNKNOWN;
-    }
-    
-    const char* ext = strrchr(filepath, '.');
-    if (!ext) {
-        return LANG_UNKNOWN;
+    if (!tracker->initialized) {
+        return DEPTRACK_ERROR_CONFIG;
     }
     
-    ext++; // Skip the dot
-    
-    if (strcmp(ext, "kt") == 0 || strcmp(ext, "kts") == 0) {
-        return LANG_KOTLIN;
-    } else if (strcmp(ext, "ts") == 0 || strcmp(ext, "tsx") == 0 || strcmp(ext, "js") == 0 || strcmp(ext, "jsx") == 0) {
-        return LANG_TYPESCRIPT;
-    } else if (strcmp(ext, "py") == 0) {
-        return LANG_PYTHON;
-    } else if (strcmp(ext, "go") == 0) {
-        return LANG_GO;
-    } else if (strcmp(ext, "rs") == 0) {
-        return LANG_RUST;
-    } else if (strcmp(ext, "yml") == 0 || strcmp(ext, "yaml") == 0) {
-        return LANG_YAML;
-    } else if (strcmp(ext, "sql") == 0) {
-        return LANG_SQL;
-    } else if (strcmp(ext, "proto") == 0) {
-        return LANG_PROTO;
+    if (format != OUTPUT_JSON) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
     }
     
-    return LANG_UNKNOWN;
+    JsonOutputOptions options;
+    json_output_options_default(&options);
+    options.pretty = !tracker->compact_output;
+    options.root_path = tracker->root_path;
+    options.pool = deptrack_thread_pool(tracker);
+    return json_generate_file(tracker->graph, output_path, &options);
+}
+
+Language deptrack_detect_language(const char* filepath) {
+    return language_classify(filepath, NULL, 0);
 }
 
 const char* deptrack_version_string(void) {
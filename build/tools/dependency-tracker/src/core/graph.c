@@ -2,10 +2,14 @@
  * @file graph.c
  * @brief Dependency graph implementation
  * @author Unhinged Development Team
- * 
+ *
  * @llm-type class
  * @llm-legend Manages dependency graph data structure for representing relationships between components
- * @llm-key Implements dynamic arrays for nodes and edges with hash map indexing for fast lookups
+ * @llm-key Stores nodes and edges as parallel columns: type and flag bytes plus interned id handles per
+ *          node, node indices, a type byte, a version handle and an occurrence count per edge. Names,
+ *          paths, dependency lists and edge source locations live in cold columns allocated on first
+ *          use, so kernels that filter or traverse read only the bytes they test. An open-addressed
+ *          set over the edge columns merges repeated (from, to, type) edges as they are added
  * @llm-map Core data structure used by dependency tracker to represent and analyze dependencies
  * @llm-axiom Graph operations must maintain referential integrity and prevent memory leaks
  * @llm-contract Provides thread-safe graph operations with proper error handling
@@ -18,153 +22,45 @@
 // Initial capacity for dynamic arrays
 #define INITIAL_NODE_CAPACITY 100
 #define INITIAL_EDGE_CAPACITY 200
-
-// Simple hash map implementation for node indexing (stub)
-typedef struct HashMapEntry {
-    char* key;
-    size_t value;
-    struct HashMapEntry* next;
-} HashMapEntry;
-
-typedef struct HashMap {
-    HashMapEntry** buckets;
-    size_t bucket_count;
-    size_t size;
-} HashMap;
-
-// Hash map operations (simplified implementation)
-static HashMap* hashmap_create(size_t bucket_count) {
-    HashMap* map = calloc(1, sizeof(HashMap));
-    if (!map) return NULL;
-    
-    map->buckets = calloc(bucket_count, sizeof(HashMapEntry*));
-    if (!map->buckets) {
-        free(map);
-        return NULL;
-    }
-    
-    map->bucket_count = bucket_count;
-    map->size = 0;
-    return map;
-}
-
-static void hashmap_destroy(HashMap* map) {
-    if (!map) return;
-    
-    for (size_t i = 0; i < map->bucket_count; i++) {
-        HashMapEntry* entry = map->buckets[i];
-        while (entry) {
-            HashMapEntry* next = entry->next;
-            free(entry->key);
-            free(entry);
-            entry = next;
-        }
-    }
-    
-    free(map->buckets);
-    free(map);
-}
-
-static size_t hash_string(const char* str) {
-    size_t hash = 5381;
-    int c;
-    while ((c = *str++)) {
-        hash = ((hash << 5) + hash) + c;
-    }
-    return hash;
-}
-
-static int hashmap_put(HashMap* map, const char* key, size_t value) {
-    if (!map || !key) return -1;
-    
-    size_t bucket = hash_string(key) % map->bucket_count;
-    
-    // Check if key already exists
-    HashMapEntry* entry = map->buckets[bucket];
-    while (entry) {
-        if (strcmp(entry->key, key) == 0) {
-            entry->value = value;
-            return 0;
-        }
-        entry = entry->next;
-    }
-    
-    // Create new entry
-    entry = malloc(sizeof(HashMapEntry));
-    if (!entry) return -1;
-    
-    entry->key = strdup(key);
-    if (!entry->key) {
-        free(entry);
-        return -1;
-    }
-    
-    entry->value = value;
-    entry->next = map->buckets[bucket];
-    map->buckets[bucket] = entry;
-    map->size++;
-    
-    return 0;
-}
-
-static int hashmap_get(HashMap* map, const char* key, size_t* value) {
-    if (!map || !key || !value) return -1;
-    
-    size_t bucket = hash_string(key) % map->bucket_count;
-    HashMapEntry* entry = map->buckets[bucket];
-    
-    while (entry) {
-        if (strcmp(entry->key, key) == 0) {
-            *value = entry->value;
-            return 0;
-        }
-        entry = entry->next;
-    }
-    
-    return -1; // Not found
-}
+#define INITIAL_STRING_CAPACITY 256
+#define INITIAL_EDGE_SLOTS 512      // Power of two, at least twice INITIAL_EDGE_CAPACITY
+#define NO_NODE_INDEX UINT32_MAX
 
 DependencyGraph* graph_create(void) {
     DependencyGraph* graph = calloc(1, sizeof(DependencyGraph));
     if (!graph) {
         return NULL;
     }
-    
-    // Allocate initial capacity for nodes
-    graph->nodes = calloc(INITIAL_NODE_CAPACITY, sizeof(GraphNode));
-    if (!graph->nodes) {
-        free(graph);
-        return NULL;
-    }
-    
-    // Allocate initial capacity for edges
-    graph->edges = calloc(INITIAL_EDGE_CAPACITY, sizeof(GraphEdge));
-    if (!graph->edges) {
-        free(graph->nodes);
-        free(graph);
-        return NULL;
-    }
-    
-    // Create node index hash map
-    graph->node_index = hashmap_create(101); // Prime number for better distribution
-    if (!graph->node_index) {
-        free(graph->edges);
-        free(graph->nodes);
-        free(graph);
+
+    graph->node_type = malloc(INITIAL_NODE_CAPACITY * sizeof(uint8_t));
+    graph->node_flags = malloc(INITIAL_NODE_CAPACITY * sizeof(uint8_t));
+    graph->node_id = malloc(INITIAL_NODE_CAPACITY * sizeof(StringHandle));
+    graph->edge_from = malloc(INITIAL_EDGE_CAPACITY * sizeof(uint32_t));
+    graph->edge_to = malloc(INITIAL_EDGE_CAPACITY * sizeof(uint32_t));
+    graph->edge_type = malloc(INITIAL_EDGE_CAPACITY * sizeof(uint8_t));
+    graph->edge_version = malloc(INITIAL_EDGE_CAPACITY * sizeof(StringHandle));
+    graph->edge_occurrences = malloc(INITIAL_EDGE_CAPACITY * sizeof(uint32_t));
+    graph->edge_slots = calloc(INITIAL_EDGE_SLOTS, sizeof(uint32_t));
+    graph->strings = string_pool_create();
+    graph->node_by_string = malloc(INITIAL_STRING_CAPACITY * sizeof(uint32_t));
+    if (!graph->node_type || !graph->node_flags || !graph->node_id || !graph->edge_from || !graph->edge_to ||
+        !graph->edge_type || !graph->edge_version || !graph->edge_occurrences || !graph->edge_slots ||
+        !graph->strings || !graph->node_by_string) {
+        graph_destroy(graph);
         return NULL;
     }
-    
+
     graph->node_count = 0;
     graph->edge_count = 0;
     graph->node_capacity = INITIAL_NODE_CAPACITY;
     graph->edge_capacity = INITIAL_EDGE_CAPACITY;
+    graph->node_by_string_capacity = INITIAL_STRING_CAPACITY;
+    graph->edge_slot_count = INITIAL_EDGE_SLOTS;
 
     // Initialize mutex for thread safety
     if (pthread_mutex_init(&graph->mutex, NULL) != 0) {
-        hashmap_destroy((HashMap*)graph->node_index);
-        free(graph->edges);
-        free(graph->nodes);
-        free(graph);
+        graph->node_capacity = 0;
+        graph_destroy(graph);
         return NULL;
     }
 
@@ -174,81 +70,196 @@ DependencyGraph* graph_create(void) {
 void graph_destroy(DependencyGraph* graph) {
     if (!graph) return;
 
-    // Destroy mutex
-    pthread_mutex_destroy(&graph->mutex);
-    
-    // Clean up nodes
-    for (size_t i = 0; i < graph->node_count; i++) {
-        GraphNode* node = &graph->nodes[i];
-        free(node->id);
-        free(node->name);
-        free(node->filepath);
-        
-        // Clean up dependencies array
-        if (node->dependencies) {
-            for (size_t j = 0; j < node->dep_count; j++) {
-                free(node->dependencies[j]);
-            }
-            free(node->dependencies);
-        }
-        
-        // Clean up metadata if needed
-        // TODO: Implement metadata cleanup based on node type
+    // A zero capacity means graph_create failed before the mutex existed
+    if (graph->node_capacity > 0) {
+        pthread_mutex_destroy(&graph->mutex);
     }
-    
-    // Clean up edges
-    for (size_t i = 0; i < graph->edge_count; i++) {
-        GraphEdge* edge = &graph->edges[i];
-        free(edge->from_id);
-        free(edge->to_id);
-        free(edge->version_constraint);
-        
-        // Clean up metadata if needed
-        // TODO: Implement metadata cleanup based on edge type
-    }
-    
-    // Clean up arrays
-    free(graph->nodes);
-    free(graph->edges);
-    
-    // Clean up hash map
-    hashmap_destroy((HashMap*)graph->node_index);
-    
+
+    free(graph->node_type);
+    free(graph->node_flags);
+    free(graph->node_id);
+    free(graph->edge_from);
+    free(graph->edge_to);
+    free(graph->edge_type);
+    free(graph->edge_version);
+    free(graph->edge_occurrences);
+    free(graph->edge_slots);
+    free(graph->edge_location_first);
+    free(graph->edge_location_last);
+    free(graph->locations);
+    free(graph->node_name);
+    free(graph->node_filepath);
+    free(graph->node_dep_end);
+    free(graph->dep_ids);
+    for (size_t i = 0; i < graph->attribute_count; i++) {
+        free(graph->attributes[i].name);
+        free(graph->attributes[i].values);
+        free(graph->attributes[i].present);
+    }
+    free(graph->attributes);
+    string_pool_destroy(graph->strings);
+    free(graph->node_by_string);
+
     free(graph);
 }
 
-static int graph_resize_nodes(DependencyGraph* graph) {
+// Reallocates a column that exists; a column grown before a later one fails is merely roomier
+static int grow_column(void* column, size_t element_size, size_t capacity) {
+    void** slot = column;
+    if (!*slot) return 0;
+    void* grown = realloc(*slot, capacity * element_size);
+    if (!grown) return -1;
+    *slot = grown;
+    return 0;
+}
+
+// Grows every node column to hold needed rows, doubling so repeated single adds stay amortized
+static int graph_reserve_nodes(DependencyGraph* graph, size_t needed) {
+    if (needed <= graph->node_capacity) return 0;
+    if (needed > NO_NODE_INDEX) return -1;
     size_t new_capacity = graph->node_capacity * 2;
-    GraphNode* new_nodes = realloc(graph->nodes, new_capacity * sizeof(GraphNode));
-    if (!new_nodes) {
+    while (new_capacity < needed) new_capacity *= 2;
+    if (new_capacity > NO_NODE_INDEX) new_capacity = NO_NODE_INDEX;
+    if (grow_column(&graph->node_type, sizeof(uint8_t), new_capacity) != 0 ||
+        grow_column(&graph->node_flags, sizeof(uint8_t), new_capacity) != 0 ||
+        grow_column(&graph->node_id, sizeof(StringHandle), new_capacity) != 0 ||
+        grow_column(&graph->node_name, sizeof(StringHandle), new_capacity) != 0 ||
+        grow_column(&graph->node_filepath, sizeof(StringHandle), new_capacity) != 0 ||
+        grow_column(&graph->node_dep_end, sizeof(uint32_t), new_capacity) != 0) {
         return -1;
     }
-    
-    // Zero out new memory
-    memset(new_nodes + graph->node_capacity, 0, 
-           (new_capacity - graph->node_capacity) * sizeof(GraphNode));
-    
-    graph->nodes = new_nodes;
     graph->node_capacity = new_capacity;
     return 0;
 }
 
-static int graph_resize_edges(DependencyGraph* graph) {
+static int graph_reserve_edges(DependencyGraph* graph, size_t needed) {
+    if (needed <= graph->edge_capacity) return 0;
     size_t new_capacity = graph->edge_capacity * 2;
-    GraphEdge* new_edges = realloc(graph->edges, new_capacity * sizeof(GraphEdge));
-    if (!new_edges) {
+    while (new_capacity < needed) new_capacity *= 2;
+    if (grow_column(&graph->edge_from, sizeof(uint32_t), new_capacity) != 0 ||
+        grow_column(&graph->edge_to, sizeof(uint32_t), new_capacity) != 0 ||
+        grow_column(&graph->edge_type, sizeof(uint8_t), new_capacity) != 0 ||
+        grow_column(&graph->edge_version, sizeof(StringHandle), new_capacity) != 0 ||
+        grow_column(&graph->edge_occurrences, sizeof(uint32_t), new_capacity) != 0 ||
+        grow_column(&graph->edge_location_first, sizeof(uint32_t), new_capacity) != 0 ||
+        grow_column(&graph->edge_location_last, sizeof(uint32_t), new_capacity) != 0) {
         return -1;
     }
-    
-    // Zero out new memory
-    memset(new_edges + graph->edge_capacity, 0,
-           (new_capacity - graph->edge_capacity) * sizeof(GraphEdge));
-    
-    graph->edges = new_edges;
     graph->edge_capacity = new_capacity;
     return 0;
 }
 
+// Allocates a cold column at capacity; the rows before count get fill (0 or 0xff bytes)
+static int ensure_cold_column(void* column, size_t element_size, size_t capacity, size_t count, int fill) {
+    void** slot = column;
+    if (*slot) return 0;
+    *slot = malloc(capacity * element_size);
+    if (!*slot) return -1;
+    memset(*slot, fill, count * element_size);
+    return 0;
+}
+
+int graph_intern(DependencyGraph* graph, const char* text, StringHandle* handle) {
+    // Room for a node_by_string entry comes first, so every handle in the pool has one
+    size_t before = string_pool_count(graph->strings);
+    if (before >= graph->node_by_string_capacity) {
+        size_t capacity = graph->node_by_string_capacity * 2;
+        uint32_t* grown = realloc(graph->node_by_string, capacity * sizeof(uint32_t));
+        if (!grown) return DEPTRACK_ERROR_MEMORY;
+        graph->node_by_string = grown;
+        graph->node_by_string_capacity = capacity;
+    }
+    int result = string_pool_intern(graph->strings, text, handle);
+    if (result == DEPTRACK_SUCCESS && string_pool_count(graph->strings) > before) {
+        graph->node_by_string[*handle] = NO_NODE_INDEX;
+    }
+    return result;
+}
+
+static size_t find_node_locked(const DependencyGraph* graph, const char* id) {
+    StringHandle handle = string_pool_find(graph->strings, id);
+    if (handle == STRING_NONE || graph->node_by_string[handle] == NO_NODE_INDEX) return GRAPH_NO_NODE;
+    return graph->node_by_string[handle];
+}
+
+// Appends a node whose interned id belongs to no node yet; the caller holds the lock and has reserved a row
+static int append_node_locked(DependencyGraph* graph, const GraphNode* node, StringHandle id) {
+    // Nothing is visible until node_count moves, so a failure part way only leaves unused strings behind
+    size_t index = graph->node_count;
+    StringHandle name, filepath;
+    int result = graph_intern(graph, node->name, &name);
+    if (result == DEPTRACK_SUCCESS) result = graph_intern(graph, node->filepath, &filepath);
+    if (result == DEPTRACK_SUCCESS && name != STRING_NONE &&
+        ensure_cold_column(&graph->node_name, sizeof(StringHandle), graph->node_capacity, index, 0xff) != 0) {
+        result = DEPTRACK_ERROR_MEMORY;
+    }
+    if (result == DEPTRACK_SUCCESS && filepath != STRING_NONE &&
+        ensure_cold_column(&graph->node_filepath, sizeof(StringHandle), graph->node_capacity, index, 0xff) != 0) {
+        result = DEPTRACK_ERROR_MEMORY;
+    }
+
+    // Dependency lists share one handle array; nodes before the first list all end at 0
+    size_t dep_count = node->dependencies ? node->dep_count : 0;
+    if (result == DEPTRACK_SUCCESS && dep_count > 0) {
+        if (ensure_cold_column(&graph->node_dep_end, sizeof(uint32_t), graph->node_capacity, index, 0) != 0) {
+            result = DEPTRACK_ERROR_MEMORY;
+        } else if (graph->dep_id_count + dep_count > graph->dep_id_capacity) {
+            size_t capacity = graph->dep_id_capacity ? graph->dep_id_capacity * 2 : INITIAL_EDGE_CAPACITY;
+            while (capacity < graph->dep_id_count + dep_count) capacity *= 2;
+            StringHandle* grown = realloc(graph->dep_ids, capacity * sizeof(StringHandle));
+            if (grown) {
+                graph->dep_ids = grown;
+                graph->dep_id_capacity = capacity;
+            } else {
+                result = DEPTRACK_ERROR_MEMORY;
+            }
+        }
+        for (size_t i = 0; result == DEPTRACK_SUCCESS && i < dep_count; i++) {
+            result = graph_intern(graph, node->dependencies[i], &graph->dep_ids[graph->dep_id_count + i]);
+        }
+    }
+    if (result != DEPTRACK_SUCCESS) {
+        return result;
+    }
+
+    graph->node_type[index] = (uint8_t)node->type;
+    graph->node_flags[index] = filepath != STRING_NONE ? GRAPH_NODE_FILE : 0;
+    graph->node_id[index] = id;
+    if (graph->node_name) graph->node_name[index] = name;
+    if (graph->node_filepath) graph->node_filepath[index] = filepath;
+    graph->dep_id_count += dep_count;
+    if (graph->node_dep_end) graph->node_dep_end[index] = (uint32_t)graph->dep_id_count;
+    graph->node_by_string[id] = (uint32_t)index;
+    graph->node_count++;
+    return DEPTRACK_SUCCESS;
+}
+
+// Writes a file's own node over the placeholder an earlier edge target left under its id
+static int promote_node_locked(DependencyGraph* graph, size_t index, const GraphNode* node) {
+    StringHandle name, filepath;
+    int result = graph_intern(graph, node->name, &name);
+    if (result == DEPTRACK_SUCCESS) result = graph_intern(graph, node->filepath, &filepath);
+    if (result == DEPTRACK_SUCCESS && name != STRING_NONE &&
+        ensure_cold_column(&graph->node_name, sizeof(StringHandle), graph->node_capacity, graph->node_count,
+                           0xff) != 0) {
+        result = DEPTRACK_ERROR_MEMORY;
+    }
+    if (result == DEPTRACK_SUCCESS &&
+        ensure_cold_column(&graph->node_filepath, sizeof(StringHandle), graph->node_capacity, graph->node_count,
+                           0xff) != 0) {
+        result = DEPTRACK_ERROR_MEMORY;
+    }
+    if (result != DEPTRACK_SUCCESS) {
+        return result;
+    }
+
+    graph->node_type[index] = (uint8_t)node->type;
+    graph->node_flags[index] |= GRAPH_NODE_FILE;
+    if (graph->node_name) graph->node_name[index] = name;
+    graph->node_filepath[index] = filepath;
+    return DEPTRACK_SUCCESS;
+}
+
 int graph_add_node(DependencyGraph* graph, const GraphNode* node) {
     if (!graph || !node || !node->id) {
         return DEPTRACK_ERROR_INVALID_PARAM;
@@ -258,68 +269,173 @@ int graph_add_node(DependencyGraph* graph, const GraphNode* node) {
     pthread_mutex_lock(&graph->mutex);
 
     // Check if node already exists
-    size_t existing_index;
-    if (hashmap_get((HashMap*)graph->node_index, node->id, &existing_index) == 0) {
+    if (find_node_locked(graph, node->id) != GRAPH_NO_NODE) {
         // Node already exists, could update it or return error
         pthread_mutex_unlock(&graph->mutex);
         return DEPTRACK_ERROR_INVALID_PARAM; // For now, don't allow duplicates
     }
-    
+
     // Resize if necessary
-    if (graph->node_count >= graph->node_capacity) {
-        if (graph_resize_nodes(graph) != 0) {
-            pthread_mutex_unlock(&graph->mutex);
-            return DEPTRACK_ERROR_MEMORY;
-        }
+    StringHandle id;
+    int result = graph_reserve_nodes(graph, graph->node_count + 1) == 0 ? DEPTRACK_SUCCESS : DEPTRACK_ERROR_MEMORY;
+    if (result == DEPTRACK_SUCCESS) result = graph_intern(graph, node->id, &id);
+    if (result == DEPTRACK_SUCCESS) result = append_node_locked(graph, node, id);
+
+    // Unlock graph
+    pthread_mutex_unlock(&graph->mutex);
+    return result;
+}
+
+// One lock and one reservation for the batch; interning the id is the only hash probe per node
+int graph_add_nodes_bulk(DependencyGraph* graph, const GraphNode* nodes, size_t count, size_t* handles) {
+    if (!graph || (!nodes && count > 0)) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
     }
-    
-    // Copy node data
-    GraphNode* new_node = &graph->nodes[graph->node_count];
-    new_node->id = strdup(node->id);
-    new_node->name = node->name ? strdup(node->name) : NULL;
-    new_node->type = node->type;
-    new_node->filepath = node->filepath ? strdup(node->filepath) : NULL;
-    
-    // Copy dependencies
-    if (node->dependencies && node->dep_count > 0) {
-        new_node->dependencies = calloc(node->dep_count, sizeof(char*));
-        if (!new_node->dependencies) {
-            free(new_node->id);
-            free(new_node->name);
-            free(new_node->filepath);
-            pthread_mutex_unlock(&graph->mutex);
-            return DEPTRACK_ERROR_MEMORY;
-        }
-        
-        for (size_t i = 0; i < node->dep_count; i++) {
-            new_node->dependencies[i] = strdup(node->dependencies[i]);
+    for (size_t i = 0; i < count; i++) {
+        if (!nodes[i].id) return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&graph->mutex);
+    int result = graph_reserve_nodes(graph, graph->node_count + count) == 0 ? DEPTRACK_SUCCESS
+                                                                            : DEPTRACK_ERROR_MEMORY;
+    for (size_t i = 0; result == DEPTRACK_SUCCESS && i < count; i++) {
+        StringHandle id;
+        result = graph_intern(graph, nodes[i].id, &id);
+        if (result != DEPTRACK_SUCCESS) break;
+        size_t node = graph->node_by_string[id];
+        if (node == NO_NODE_INDEX) {
+            node = graph->node_count;
+            result = append_node_locked(graph, &nodes[i], id);
+        } else if (nodes[i].filepath && !(graph->node_flags[node] & GRAPH_NODE_FILE)) {
+            result = promote_node_locked(graph, node, &nodes[i]);
         }
-        new_node->dep_count = node->dep_count;
-    }
-    
-    // Add to index
-    if (hashmap_put((HashMap*)graph->node_index, node->id, graph->node_count) != 0) {
-        // Cleanup on failure
-        free(new_node->id);
-        free(new_node->name);
-        free(new_node->filepath);
-        if (new_node->dependencies) {
-            for (size_t i = 0; i < new_node->dep_count; i++) {
-                free(new_node->dependencies[i]);
-            }
-            free(new_node->dependencies);
+        if (handles) handles[i] = node;
+    }
+    pthread_mutex_unlock(&graph->mutex);
+    return result;
+}
+
+static size_t edge_hash(uint32_t from, uint32_t to, uint8_t type) {
+    uint64_t key = ((uint64_t)from << 32 | to) ^ ((uint64_t)type << 61);
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key;
+}
+
+// Slot holding the edge (from, to, type), or the empty slot where it would go
+static size_t edge_slot(const DependencyGraph* graph, uint32_t from, uint32_t to, uint8_t type) {
+    size_t mask = graph->edge_slot_count - 1;
+    size_t slot = edge_hash(from, to, type) & mask;
+    for (;;) {
+        uint32_t entry = graph->edge_slots[slot];
+        if (entry == 0) return slot;
+        size_t edge = entry - 1;
+        if (graph->edge_from[edge] == from && graph->edge_to[edge] == to && graph->edge_type[edge] == type) {
+            return slot;
         }
-        pthread_mutex_unlock(&graph->mutex);
+        slot = (slot + 1) & mask;
+    }
+}
+
+// Keeps the set at most half full
+static int reserve_edge_slots(DependencyGraph* graph, size_t edges) {
+    if (edges * 2 <= graph->edge_slot_count) return 0;
+    size_t count = graph->edge_slot_count * 2;
+    while (edges * 2 > count) count *= 2;
+    uint32_t* slots = calloc(count, sizeof(uint32_t));
+    if (!slots) return -1;
+    free(graph->edge_slots);
+    graph->edge_slots = slots;
+    graph->edge_slot_count = count;
+    for (size_t e = 0; e < graph->edge_count; e++) {
+        slots[edge_slot(graph, graph->edge_from[e], graph->edge_to[e], graph->edge_type[e])] = (uint32_t)e + 1;
+    }
+    return 0;
+}
+
+// Appends a location to the edge's list; the location columns appear with the first one
+static int add_location_locked(DependencyGraph* graph, size_t edge, const char* source_file, int line_number) {
+    if (!source_file) return DEPTRACK_SUCCESS;
+    StringHandle file;
+    int result = graph_intern(graph, source_file, &file);
+    if (result != DEPTRACK_SUCCESS) return result;
+    if (ensure_cold_column(&graph->edge_location_first, sizeof(uint32_t), graph->edge_capacity,
+                           graph->edge_count, 0xff) != 0 ||
+        ensure_cold_column(&graph->edge_location_last, sizeof(uint32_t), graph->edge_capacity,
+                           graph->edge_count, 0xff) != 0) {
         return DEPTRACK_ERROR_MEMORY;
     }
-    
-    graph->node_count++;
+    if (graph->location_count >= GRAPH_NO_LOCATION) return DEPTRACK_ERROR_MEMORY;
+    if (graph->location_count >= graph->location_capacity) {
+        size_t capacity = graph->location_capacity ? graph->location_capacity * 2 : INITIAL_EDGE_CAPACITY;
+        GraphLocationEntry* grown = realloc(graph->locations, capacity * sizeof(GraphLocationEntry));
+        if (!grown) return DEPTRACK_ERROR_MEMORY;
+        graph->locations = grown;
+        graph->location_capacity = capacity;
+    }
 
-    // Unlock graph
-    pthread_mutex_unlock(&graph->mutex);
+    uint32_t index = (uint32_t)graph->location_count++;
+    graph->locations[index] = (GraphLocationEntry){ file, line_number > 0 ? (uint32_t)line_number : 0,
+                                                    GRAPH_NO_LOCATION };
+    if (graph->edge_location_first[edge] == GRAPH_NO_LOCATION) {
+        graph->edge_location_first[edge] = index;
+    } else {
+        graph->locations[graph->edge_location_last[edge]].next = index;
+    }
+    graph->edge_location_last[edge] = index;
     return DEPTRACK_SUCCESS;
 }
 
+// The caller holds the lock, has checked both nodes and reserved a row. An edge already present only
+// counts the occurrence, adds the location and keeps the smaller version constraint
+static int append_edge_locked(DependencyGraph* graph, size_t from, size_t to, DependencyType type,
+                              const char* version_constraint, const char* source_file, int line_number) {
+    if (reserve_edge_slots(graph, graph->edge_count + 1) != 0) {
+        return DEPTRACK_ERROR_MEMORY;
+    }
+    size_t slot = edge_slot(graph, (uint32_t)from, (uint32_t)to, (uint8_t)type);
+    StringHandle version;
+    int result;
+    if (graph->edge_slots[slot] != 0) {
+        size_t index = graph->edge_slots[slot] - 1;
+        const char* kept = string_pool_get(graph->strings, graph->edge_version[index]);
+        result = DEPTRACK_SUCCESS;
+        if (version_constraint && (!kept || strcmp(version_constraint, kept) < 0)) {
+            result = graph_intern(graph, version_constraint, &version);
+            if (result == DEPTRACK_SUCCESS) graph->edge_version[index] = version;
+        }
+        if (result == DEPTRACK_SUCCESS) result = add_location_locked(graph, index, source_file, line_number);
+        if (result == DEPTRACK_SUCCESS && graph->edge_occurrences[index] < UINT32_MAX) {
+            graph->edge_occurrences[index]++;
+        }
+        return result;
+    }
+
+    size_t index = graph->edge_count;
+    result = graph_intern(graph, version_constraint, &version);
+    if (result != DEPTRACK_SUCCESS) {
+        return result;
+    }
+
+    graph->edge_from[index] = (uint32_t)from;
+    graph->edge_to[index] = (uint32_t)to;
+    graph->edge_type[index] = (uint8_t)type;
+    graph->edge_version[index] = version;
+    graph->edge_occurrences[index] = 1;
+    if (graph->edge_location_first) {
+        graph->edge_location_first[index] = GRAPH_NO_LOCATION;
+        graph->edge_location_last[index] = GRAPH_NO_LOCATION;
+    }
+    graph->edge_slots[slot] = (uint32_t)index + 1;
+    graph->node_flags[from] |= GRAPH_NODE_HAS_DEPENDENCIES;
+    graph->node_flags[to] |= GRAPH_NODE_HAS_DEPENDENTS;
+    graph->edge_count++;
+
+    // A location that cannot be stored leaves the edge in place without it
+    return add_location_locked(graph, index, source_file, line_number);
+}
+
 int graph_add_edge(DependencyGraph* graph, const GraphEdge* edge) {
     if (!graph || !edge || !edge->from_id || !edge->to_id) {
         return DEPTRACK_ERROR_INVALID_PARAM;
@@ -329,55 +445,171 @@ int graph_add_edge(DependencyGraph* graph, const GraphEdge* edge) {
     pthread_mutex_lock(&graph->mutex);
 
     // Verify that both nodes exist
-    size_t from_index, to_index;
-    if (hashmap_get((HashMap*)graph->node_index, edge->from_id, &from_index) != 0 ||
-        hashmap_get((HashMap*)graph->node_index, edge->to_id, &to_index) != 0) {
-        pthread_mutex_unlock(&graph->mutex);
+    size_t from_index = find_node_locked(graph, edge->from_id);
+    size_t to_index = find_node_locked(graph, edge->to_id);
+    int result = DEPTRACK_SUCCESS;
+    if (from_index == GRAPH_NO_NODE || to_index == GRAPH_NO_NODE) {
+        result = DEPTRACK_ERROR_INVALID_PARAM;
+    } else if (graph_reserve_edges(graph, graph->edge_count + 1) != 0) {
+        result = DEPTRACK_ERROR_MEMORY;
+    } else {
+        result = append_edge_locked(graph, from_index, to_index, edge->type, edge->version_constraint,
+                                    edge->source_file, edge->line_number);
+    }
+
+    // Unlock graph
+    pthread_mutex_unlock(&graph->mutex);
+    return result;
+}
+
+int graph_add_edges_bulk(DependencyGraph* graph, const GraphBulkEdge* edges, size_t count) {
+    if (!graph || (!edges && count > 0)) {
         return DEPTRACK_ERROR_INVALID_PARAM;
     }
-    
-    // Resize if necessary
-    if (graph->edge_count >= graph->edge_capacity) {
-        if (graph_resize_edges(graph) != 0) {
-            pthread_mutex_unlock(&graph->mutex);
-            return DEPTRACK_ERROR_MEMORY;
+
+    pthread_mutex_lock(&graph->mutex);
+    int result = DEPTRACK_SUCCESS;
+    for (size_t i = 0; i < count; i++) {
+        if (edges[i].from >= graph->node_count || edges[i].to >= graph->node_count) {
+            result = DEPTRACK_ERROR_INVALID_PARAM;
+            break;
         }
     }
-    
-    // Copy edge data
-    GraphEdge* new_edge = &graph->edges[graph->edge_count];
-    new_edge->from_id = strdup(edge->from_id);
-    new_edge->to_id = strdup(edge->to_id);
-    new_edge->type = edge->type;
-    new_edge->version_constraint = edge->version_constraint ? strdup(edge->version_constraint) : NULL;
-    new_edge->metadata = edge->metadata; // Shallow copy for now
-    
-    graph->edge_count++;
-
-    // Unlock graph
+    if (result == DEPTRACK_SUCCESS && graph_reserve_edges(graph, graph->edge_count + count) != 0) {
+        result = DEPTRACK_ERROR_MEMORY;
+    }
+    for (size_t i = 0; result == DEPTRACK_SUCCESS && i < count; i++) {
+        const GraphBulkEdge* edge = &edges[i];
+        result = append_edge_locked(graph, edge->from, edge->to, edge->type, edge->version_constraint,
+                                    edge->source_file, edge->line_number);
+    }
     pthread_mutex_unlock(&graph->mutex);
-    return DEPTRACK_SUCCESS;
+    return result;
 }
 
-GraphNode* graph_find_node(DependencyGraph* graph, const char* id) {
+size_t graph_find_node(const DependencyGraph* graph, const char* id) {
     if (!graph || !id) {
-        return NULL;
+        return GRAPH_NO_NODE;
+    }
+    return find_node_locked(graph, id);
+}
+
+const char* graph_node_id(const DependencyGraph* graph, size_t node) {
+    if (!graph || node >= graph->node_count) return NULL;
+    return string_pool_get(graph->strings, graph->node_id[node]);
+}
+
+const char* graph_node_name(const DependencyGraph* graph, size_t node) {
+    if (!graph || node >= graph->node_count || !graph->node_name) return NULL;
+    return string_pool_get(graph->strings, graph->node_name[node]);
+}
+
+const char* graph_node_filepath(const DependencyGraph* graph, size_t node) {
+    if (!graph || node >= graph->node_count || !graph->node_filepath) return NULL;
+    return string_pool_get(graph->strings, graph->node_filepath[node]);
+}
+
+size_t graph_node_dependency_count(const DependencyGraph* graph, size_t node) {
+    if (!graph || node >= graph->node_count || !graph->node_dep_end) return 0;
+    return graph->node_dep_end[node] - (node > 0 ? graph->node_dep_end[node - 1] : 0);
+}
+
+const char* graph_node_dependency(const DependencyGraph* graph, size_t node, size_t index) {
+    if (index >= graph_node_dependency_count(graph, node)) return NULL;
+    size_t first = node > 0 ? graph->node_dep_end[node - 1] : 0;
+    return string_pool_get(graph->strings, graph->dep_ids[first + index]);
+}
+
+const char* graph_edge_version(const DependencyGraph* graph, size_t edge) {
+    if (!graph || edge >= graph->edge_count) return NULL;
+    return string_pool_get(graph->strings, graph->edge_version[edge]);
+}
+
+size_t graph_find_edge(const DependencyGraph* graph, size_t from, size_t to, DependencyType type) {
+    if (!graph || from >= graph->node_count || to >= graph->node_count) return SIZE_MAX;
+    uint32_t entry = graph->edge_slots[edge_slot(graph, (uint32_t)from, (uint32_t)to, (uint8_t)type)];
+    return entry ? (size_t)entry - 1 : SIZE_MAX;
+}
+
+size_t graph_edge_locations(const DependencyGraph* graph, size_t edge, GraphLocation* out, size_t capacity) {
+    if (!graph || edge >= graph->edge_count || !graph->edge_location_first) return 0;
+    size_t count = 0;
+    for (uint32_t i = graph->edge_location_first[edge]; i != GRAPH_NO_LOCATION; i = graph->locations[i].next) {
+        if (out && count < capacity) {
+            out[count] = (GraphLocation){ string_pool_get(graph->strings, graph->locations[i].file),
+                                          graph->locations[i].line };
+        }
+        count++;
+    }
+    return count;
+}
+
+// Branch-free: every index is written, and the count only moves past the ones kept
+size_t graph_filter_nodes(const DependencyGraph* graph, uint32_t type_mask, uint8_t flags, size_t* out) {
+    if (!graph || !out) return 0;
+    const uint8_t* types = graph->node_type;
+    const uint8_t* node_flags = graph->node_flags;
+    size_t kept = 0;
+    for (size_t i = 0; i < graph->node_count; i++) {
+        out[kept] = i;
+        kept += ((type_mask >> (types[i] & 31)) & 1) & ((node_flags[i] & flags) == flags);
     }
-    
-    size_t index;
-    if (hashmap_get((HashMap*)graph->node_index, id, &index) == 0) {
-        return &graph->nodes[index];
+    return kept;
+}
+
+size_t graph_filter_edges(const DependencyGraph* graph, uint32_t type_mask, size_t* out) {
+    if (!graph || !out) return 0;
+    const uint8_t* types = graph->edge_type;
+    size_t kept = 0;
+    for (size_t i = 0; i < graph->edge_count; i++) {
+        out[kept] = i;
+        kept += (type_mask >> (types[i] & 31)) & 1;
     }
-    
-    return NULL;
+    return kept;
 }
 
 int graph_detect_cycles(DependencyGraph* graph) {
     if (!graph) {
         return DEPTRACK_ERROR_INVALID_PARAM;
     }
-    
-    // TODO: Implement cycle detection using DFS
-    // For now, return 0 (no cycles detected)
-    return 0;
+
+    // Kahn's algorithm over the edge endpoint columns: peel nodes nothing left depends on; a cycle
+    // is what cannot be peeled
+    pthread_mutex_lock(&graph->mutex);
+    size_t node_count = graph->node_count;
+    size_t edge_count = graph->edge_count;
+    uint32_t* first = calloc(node_count + 1, sizeof(uint32_t));
+    uint32_t* targets = malloc((edge_count ? edge_count : 1) * sizeof(uint32_t));
+    uint32_t* indegree = calloc(node_count ? node_count : 1, sizeof(uint32_t));
+    uint32_t* ready = malloc((node_count ? node_count : 1) * sizeof(uint32_t));
+    int result = DEPTRACK_ERROR_MEMORY;
+    if (first && targets && indegree && ready) {
+        for (size_t e = 0; e < edge_count; e++) {
+            first[graph->edge_from[e] + 1]++;
+            indegree[graph->edge_to[e]]++;
+        }
+        for (size_t n = 0; n < node_count; n++) first[n + 1] += first[n];
+        for (size_t e = 0; e < edge_count; e++) targets[first[graph->edge_from[e]]++] = graph->edge_to[e];
+        // The scatter advanced each start to the next node's; shift back
+        for (size_t n = node_count; n > 0; n--) first[n] = first[n - 1];
+        first[0] = 0;
+
+        size_t head = 0, tail = 0;
+        for (size_t n = 0; n < node_count; n++) {
+            if (indegree[n] == 0) ready[tail++] = (uint32_t)n;
+        }
+        while (head < tail) {
+            uint32_t n = ready[head++];
+            for (uint32_t e = first[n]; e < first[n + 1]; e++) {
+                if (--indegree[targets[e]] == 0) ready[tail++] = targets[e];
+            }
+        }
+        result = tail < node_count ? 1 : 0;
+    }
+    pthread_mutex_unlock(&graph->mutex);
+    free(first);
+    free(targets);
+    free(indegree);
+    free(ready);
+    return result;
 }
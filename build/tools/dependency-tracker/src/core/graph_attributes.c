@@ -0,0 +1,293 @@
+/**
+ * @file graph_attributes.c
+ * @brief Typed per-node and per-edge attribute columns
+ * @author Unhinged Development Team
+ *
+ * @llm-type class
+ * @llm-legend Attaches metrics such as lines of code, build time, owners or content hashes to nodes and
+ *             edges without a heap object per row
+ * @llm-key Each attribute is one column of int64, double, string handle or 64-bit set, indexed by node or
+ *          edge number and grown by doubling; ints and floats carry a present bit per row. Unset values
+ *          are stored as zero, so sums and range or mask filters are straight loops over one array
+ * @llm-contract Define and set under the graph lock; reads, like graph_find_node, assume construction has
+ *               finished or is otherwise excluded
+ */
+
+#include "dependency_tracker.h"
+#include <string.h>
+
+#define ATTRIBUTE_INITIAL_COLUMNS 8
+#define ATTRIBUTE_INITIAL_ROWS 64
+
+static size_t scope_rows(const DependencyGraph* graph, AttributeScope scope) {
+    return scope == ATTRIBUTE_NODE ? graph->node_count : graph->edge_count;
+}
+
+static size_t value_size(AttributeType type) {
+    return type == ATTRIBUTE_STRING ? sizeof(StringHandle) : sizeof(uint64_t);
+}
+
+static bool has_present_bits(AttributeType type) {
+    return type == ATTRIBUTE_INT || type == ATTRIBUTE_FLOAT;
+}
+
+// New rows are unset: zero values and present bits, STRING_NONE handles
+static int reserve_rows(GraphAttribute* column, size_t rows) {
+    if (rows <= column->capacity) return DEPTRACK_SUCCESS;
+    size_t capacity = column->capacity ? column->capacity : ATTRIBUTE_INITIAL_ROWS;
+    while (capacity < rows) capacity *= 2;
+
+    size_t size = value_size(column->type);
+    char* values = realloc(column->values, capacity * size);
+    if (!values) return DEPTRACK_ERROR_MEMORY;
+    column->values = values;
+    memset(values + column->capacity * size, column->type == ATTRIBUTE_STRING ? 0xff : 0,
+           (capacity - column->capacity) * size);
+
+    if (has_present_bits(column->type)) {
+        size_t old_words = (column->capacity + 63) / 64;
+        size_t words = (capacity + 63) / 64;
+        uint64_t* present = realloc(column->present, words * sizeof(uint64_t));
+        if (!present) return DEPTRACK_ERROR_MEMORY;
+        column->present = present;
+        memset(present + old_words, 0, (words - old_words) * sizeof(uint64_t));
+    }
+    column->capacity = capacity;
+    return DEPTRACK_SUCCESS;
+}
+
+static bool row_is_set(const GraphAttribute* column, size_t row) {
+    if (row >= column->capacity) return false;
+    switch (column->type) {
+        case ATTRIBUTE_INT:
+        case ATTRIBUTE_FLOAT: return (column->present[row / 64] >> (row % 64)) & 1;
+        case ATTRIBUTE_STRING: return ((const StringHandle*)column->values)[row] != STRING_NONE;
+        case ATTRIBUTE_BITSET: return ((const uint64_t*)column->values)[row] != 0;
+    }
+    return false;
+}
+
+int graph_attribute_define(DependencyGraph* graph, AttributeScope scope, const char* name, AttributeType type,
+                           size_t* attribute) {
+    if (!graph || !name || !attribute || (scope != ATTRIBUTE_NODE && scope != ATTRIBUTE_EDGE) ||
+        type < ATTRIBUTE_INT || type > ATTRIBUTE_BITSET) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&graph->mutex);
+    size_t existing = graph_attribute_find(graph, scope, name);
+    if (existing != GRAPH_NO_ATTRIBUTE) {
+        bool same_type = graph->attributes[existing].type == type;
+        pthread_mutex_unlock(&graph->mutex);
+        if (!same_type) return DEPTRACK_ERROR_INVALID_PARAM;
+        *attribute = existing;
+        return DEPTRACK_SUCCESS;
+    }
+
+    int result = DEPTRACK_SUCCESS;
+    if (graph->attribute_count >= graph->attribute_capacity) {
+        size_t capacity = graph->attribute_capacity ? graph->attribute_capacity * 2 : ATTRIBUTE_INITIAL_COLUMNS;
+        GraphAttribute* grown = realloc(graph->attributes, capacity * sizeof(GraphAttribute));
+        if (grown) {
+            graph->attributes = grown;
+            graph->attribute_capacity = capacity;
+        } else {
+            result = DEPTRACK_ERROR_MEMORY;
+        }
+    }
+    char* copy = result == DEPTRACK_SUCCESS ? strdup(name) : NULL;
+    if (copy) {
+        graph->attributes[graph->attribute_count] = (GraphAttribute){ .name = copy, .scope = scope, .type = type };
+        *attribute = graph->attribute_count++;
+    } else {
+        result = DEPTRACK_ERROR_MEMORY;
+    }
+    pthread_mutex_unlock(&graph->mutex);
+    return result;
+}
+
+size_t graph_attribute_find(const DependencyGraph* graph, AttributeScope scope, const char* name) {
+    if (!graph || !name) return GRAPH_NO_ATTRIBUTE;
+    for (size_t i = 0; i < graph->attribute_count; i++) {
+        if (graph->attributes[i].scope == scope && strcmp(graph->attributes[i].name, name) == 0) return i;
+    }
+    return GRAPH_NO_ATTRIBUTE;
+}
+
+// Checks every row before writing any, so a failed call leaves the column as it was
+static int set_rows(DependencyGraph* graph, size_t attribute, AttributeType type, const size_t* rows,
+                    const void* values, size_t count) {
+    if (!graph || (!values && count > 0) || attribute >= graph->attribute_count) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    pthread_mutex_lock(&graph->mutex);
+    GraphAttribute* column = &graph->attributes[attribute];
+    int result = column->type == type ? DEPTRACK_SUCCESS : DEPTRACK_ERROR_INVALID_PARAM;
+    size_t limit = scope_rows(graph, column->scope);
+    size_t needed = 0;
+    for (size_t i = 0; result == DEPTRACK_SUCCESS && i < count; i++) {
+        size_t row = rows ? rows[i] : i;
+        if (row >= limit) result = DEPTRACK_ERROR_INVALID_PARAM;
+        else if (row >= needed) needed = row + 1;
+    }
+
+    StringHandle* handles = NULL;
+    if (result == DEPTRACK_SUCCESS && type == ATTRIBUTE_STRING && count > 0) {
+        handles = malloc(count * sizeof(StringHandle));
+        if (!handles) result = DEPTRACK_ERROR_MEMORY;
+        for (size_t i = 0; result == DEPTRACK_SUCCESS && i < count; i++) {
+            result = graph_intern(graph, ((const char* const*)values)[i], &handles[i]);
+        }
+    }
+    if (result == DEPTRACK_SUCCESS) result = reserve_rows(column, needed);
+
+    for (size_t i = 0; result == DEPTRACK_SUCCESS && i < count; i++) {
+        size_t row = rows ? rows[i] : i;
+        switch (type) {
+            case ATTRIBUTE_INT:
+                ((int64_t*)column->values)[row] = ((const int64_t*)values)[i];
+                break;
+            case ATTRIBUTE_FLOAT:
+                ((double*)column->values)[row] = ((const double*)values)[i];
+                break;
+            case ATTRIBUTE_STRING:
+                ((StringHandle*)column->values)[row] = handles[i];
+                break;
+            case ATTRIBUTE_BITSET:
+                ((uint64_t*)column->values)[row] = ((const uint64_t*)values)[i];
+                break;
+        }
+        if (column->present) column->present[row / 64] |= (uint64_t)1 << (row % 64);
+    }
+    pthread_mutex_unlock(&graph->mutex);
+    free(handles);
+    return result;
+}
+
+int graph_attribute_set_ints(DependencyGraph* graph, size_t attribute, const size_t* rows, const int64_t* values,
+                             size_t count) {
+    return set_rows(graph, attribute, ATTRIBUTE_INT, rows, values, count);
+}
+
+int graph_attribute_set_floats(DependencyGraph* graph, size_t attribute, const size_t* rows, const double* values,
+                               size_t count) {
+    return set_rows(graph, attribute, ATTRIBUTE_FLOAT, rows, values, count);
+}
+
+int graph_attribute_set_strings(DependencyGraph* graph, size_t attribute, const size_t* rows,
+                                const char* const* values, size_t count) {
+    return set_rows(graph, attribute, ATTRIBUTE_STRING, rows, values, count);
+}
+
+int graph_attribute_set_bits(DependencyGraph* graph, size_t attribute, const size_t* rows, const uint64_t* values,
+                             size_t count) {
+    return set_rows(graph, attribute, ATTRIBUTE_BITSET, rows, values, count);
+}
+
+// Unset rows, rows out of range and every row of an attribute of another type read as zero
+static size_t get_rows(const DependencyGraph* graph, size_t attribute, AttributeType type, const size_t* rows,
+                       void* values, size_t count) {
+    if (!graph || !values) return 0;
+    const GraphAttribute* column = attribute < graph->attribute_count ? &graph->attributes[attribute] : NULL;
+    bool typed = column && column->type == type;
+    size_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t row = rows ? rows[i] : i;
+        bool set = typed && row_is_set(column, row);
+        found += set;
+        switch (type) {
+            case ATTRIBUTE_INT:
+                ((int64_t*)values)[i] = set ? ((const int64_t*)column->values)[row] : 0;
+                break;
+            case ATTRIBUTE_FLOAT:
+                ((double*)values)[i] = set ? ((const double*)column->values)[row] : 0.0;
+                break;
+            case ATTRIBUTE_STRING:
+                ((const char**)values)[i] =
+                    set ? string_pool_get(graph->strings, ((const StringHandle*)column->values)[row]) : NULL;
+                break;
+            case ATTRIBUTE_BITSET:
+                ((uint64_t*)values)[i] = set ? ((const uint64_t*)column->values)[row] : 0;
+                break;
+        }
+    }
+    return found;
+}
+
+size_t graph_attribute_get_ints(const DependencyGraph* graph, size_t attribute, const size_t* rows,
+                                int64_t* values, size_t count) {
+    return get_rows(graph, attribute, ATTRIBUTE_INT, rows, values, count);
+}
+
+size_t graph_attribute_get_floats(const DependencyGraph* graph, size_t attribute, const size_t* rows,
+                                  double* values, size_t count) {
+    return get_rows(graph, attribute, ATTRIBUTE_FLOAT, rows, values, count);
+}
+
+size_t graph_attribute_get_strings(const DependencyGraph* graph, size_t attribute, const size_t* rows,
+                                   const char** values, size_t count) {
+    return get_rows(graph, attribute, ATTRIBUTE_STRING, rows, values, count);
+}
+
+size_t graph_attribute_get_bits(const DependencyGraph* graph, size_t attribute, const size_t* rows,
+                                uint64_t* values, size_t count) {
+    return get_rows(graph, attribute, ATTRIBUTE_BITSET, rows, values, count);
+}
+
+// Rows that exist in the scope and in the column; the ones past capacity are all unset
+static const GraphAttribute* scan_column(const DependencyGraph* graph, size_t attribute, size_t* rows) {
+    if (!graph || attribute >= graph->attribute_count) return NULL;
+    const GraphAttribute* column = &graph->attributes[attribute];
+    size_t limit = scope_rows(graph, column->scope);
+    *rows = limit < column->capacity ? limit : column->capacity;
+    return column;
+}
+
+size_t graph_attribute_filter_ints(const DependencyGraph* graph, size_t attribute, int64_t min, int64_t max,
+                                   size_t* out) {
+    size_t rows;
+    const GraphAttribute* column = scan_column(graph, attribute, &rows);
+    if (!column || column->type != ATTRIBUTE_INT || !out) return 0;
+    const int64_t* values = column->values;
+    const uint64_t* present = column->present;
+    size_t kept = 0;
+    for (size_t i = 0; i < rows; i++) {
+        out[kept] = i;
+        kept += ((present[i / 64] >> (i % 64)) & 1) & (values[i] >= min) & (values[i] <= max);
+    }
+    return kept;
+}
+
+size_t graph_attribute_filter_bits(const DependencyGraph* graph, size_t attribute, uint64_t mask, size_t* out) {
+    size_t rows;
+    const GraphAttribute* column = scan_column(graph, attribute, &rows);
+    if (!column || column->type != ATTRIBUTE_BITSET || !out) return 0;
+    const uint64_t* values = column->values;
+    size_t kept = 0;
+    for (size_t i = 0; i < rows; i++) {
+        out[kept] = i;
+        kept += (values[i] & mask) != 0;
+    }
+    return kept;
+}
+
+// Unset rows hold zero, so the sum needs no present bits
+double graph_attribute_sum(const DependencyGraph* graph, size_t attribute) {
+    size_t rows;
+    const GraphAttribute* column = scan_column(graph, attribute, &rows);
+    if (!column) return 0.0;
+    if (column->type == ATTRIBUTE_INT) {
+        const int64_t* values = column->values;
+        int64_t sum = 0;
+        for (size_t i = 0; i < rows; i++) sum += values[i];
+        return (double)sum;
+    }
+    if (column->type == ATTRIBUTE_FLOAT) {
+        const double* values = column->values;
+        double sum = 0.0;
+        for (size_t i = 0; i < rows; i++) sum += values[i];
+        return sum;
+    }
+    return 0.0;
+}
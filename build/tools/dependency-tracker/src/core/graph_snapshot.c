@@ -0,0 +1,626 @@
+/**
+ * @file graph_snapshot.c
+ * @brief Binary graph snapshots written after analysis and read in place through mmap
+ * @author Unhinged Development Team
+ *
+ * @llm-type storage
+ * @llm-legend Saves the analyzed graph in a form other tools can query without parsing or rebuilding it
+ * @llm-key Opening maps the file and checks the header and section table only; every accessor reads the
+ *          mapped columns directly, so start-up cost does not grow with the graph
+ * @llm-map Layout, all integers little-endian and every section 8-byte aligned:
+ *          header (48 bytes): magic "DTSNAP\0\0", u32 version, u32 byte order mark 0x01020304,
+ *          u64 node count, u64 edge count, u64 file size, u32 section count, u32 CRC-32C of every
+ *          byte after the header; then section count entries of {u32 id, u32 0, u64 offset, u64 length}
+ * @llm-map Nodes are numbered in graph_sort order (ascending id) and edges likewise; string columns hold
+ *          u32 offsets into the NUL-terminated, deduplicated string table, 0xffffffff for none
+ * @llm-map Adjacency is stored both ways as per-node LEB128 runs of neighbor deltas (neighbors ascend within
+ *          a node): FIRST u32[n+1] is the first edge of each run, BYTES u64[n+1] where the run starts
+ * @llm-contract Accessors bounds-check what they read, so a damaged file yields NULL strings or short
+ *               neighbor lists rather than faults; graph_snapshot_verify checks the CRC when it matters
+ */
+
+#include "dependency_tracker.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SNAPSHOT_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+#define SNAPSHOT_MAGIC "DTSNAP\0\0"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+#define SNAPSHOT_NO_STRING UINT32_MAX
+#define SNAPSHOT_ALIGN 8
+
+typedef enum {
+    SECTION_STRINGS = 1,
+    SECTION_NODE_ID,
+    SECTION_NODE_NAME,
+    SECTION_NODE_PATH,
+    SECTION_NODE_TYPE,
+    SECTION_EDGE_TYPE,
+    SECTION_EDGE_VERSION,
+    SECTION_OUT_FIRST,
+    SECTION_OUT_BYTES,
+    SECTION_OUT_DATA,
+    SECTION_IN_FIRST,
+    SECTION_IN_BYTES,
+    SECTION_IN_DATA,
+    SECTION_COUNT = SECTION_IN_DATA
+} SectionId;
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t node_count;
+    uint64_t edge_count;
+    uint64_t file_size;
+    uint32_t section_count;
+    uint32_t checksum;
+} SnapshotHeader;
+
+typedef struct {
+    uint32_t id;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t length;
+} SnapshotSection;
+
+typedef struct {
+    const uint32_t* first;
+    const uint64_t* bytes;
+    const uint8_t* data;
+    size_t data_size;
+} SnapshotAdjacency;
+
+struct GraphSnapshot {
+    uint8_t* map;
+    size_t size;
+    size_t node_count;
+    size_t edge_count;
+    const char* strings;
+    size_t strings_size;
+    const uint32_t* node_id;
+    const uint32_t* node_name;
+    const uint32_t* node_path;
+    const uint8_t* node_type;
+    const uint8_t* edge_type;
+    const uint32_t* edge_version;
+    SnapshotAdjacency out;
+    SnapshotAdjacency in;
+};
+
+// ---------------------------------------------------------------------------
+// CRC-32C
+// ---------------------------------------------------------------------------
+
+static uint32_t crc_table[256];
+static pthread_once_t crc_table_once = PTHREAD_ONCE_INIT;
+
+static void crc_table_init(void) {
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+        crc_table[i] = crc;
+    }
+}
+
+static uint32_t crc_scalar(uint32_t crc, const uint8_t* p, size_t length) {
+    for (size_t i = 0; i < length; i++) crc = crc_table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    return crc;
+}
+
+#ifdef SNAPSHOT_X86_SIMD
+__attribute__((target("sse4.2")))
+static uint32_t crc_sse42(uint32_t crc, const uint8_t* p, size_t length) {
+    size_t i = 0;
+#ifdef __x86_64__
+    uint64_t wide = crc;
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        memcpy(&word, p + i, sizeof(word));
+        wide = _mm_crc32_u64(wide, word);
+    }
+    crc = (uint32_t)wide;
+#endif
+    for (; i < length; i++) crc = _mm_crc32_u8(crc, p[i]);
+    return crc;
+}
+#endif
+
+// Running form: pass the previous result as crc, starting from 0
+static uint32_t crc_update(uint32_t crc, const void* data, size_t length, SimdIsa isa) {
+    crc = ~crc;
+#ifdef SNAPSHOT_X86_SIMD
+    if (isa >= SIMD_ISA_SSE42) return ~crc_sse42(crc, data, length);
+#endif
+    (void)isa;
+    return ~crc_scalar(crc, data, length);
+}
+
+uint32_t graph_snapshot_checksum(const void* data, size_t length, SimdIsa max_isa) {
+    if (!data) return 0;
+    pthread_once(&crc_table_once, crc_table_init);
+    SimdIsa isa = simd_detect_isa();
+    if (max_isa < isa) isa = max_isa;
+    return crc_update(0, data, length, isa);
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+    HashMap* offsets;
+} StringTable;
+
+typedef struct {
+    uint32_t* first;
+    uint64_t* bytes;
+    uint8_t* data;
+    size_t data_size;
+} AdjacencyBuffers;
+
+static int intern(StringTable* table, const char* text, uint32_t* offset) {
+    if (!text) {
+        *offset = SNAPSHOT_NO_STRING;
+        return DEPTRACK_SUCCESS;
+    }
+    size_t existing;
+    if (hashmap_get(table->offsets, text, &existing) == 0) {
+        *offset = (uint32_t)existing;
+        return DEPTRACK_SUCCESS;
+    }
+    size_t length = strlen(text) + 1;
+    if (table->length + length >= SNAPSHOT_NO_STRING) return DEPTRACK_ERROR_OUTPUT;
+    if (table->length + length > table->capacity) {
+        size_t capacity = table->capacity ? table->capacity : 4096;
+        while (capacity < table->length + length) capacity *= 2;
+        char* grown = realloc(table->data, capacity);
+        if (!grown) return DEPTRACK_ERROR_MEMORY;
+        table->data = grown;
+        table->capacity = capacity;
+    }
+    if (hashmap_put(table->offsets, text, table->length) != DEPTRACK_SUCCESS) return DEPTRACK_ERROR_MEMORY;
+    memcpy(table->data + table->length, text, length);
+    *offset = (uint32_t)table->length;
+    table->length += length;
+    return DEPTRACK_SUCCESS;
+}
+
+static size_t put_varint(uint8_t* out, uint64_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+// sources[i] -> targets[i] for edges grouped by source with targets ascending within each group
+static int encode_adjacency(size_t node_count, size_t edge_count, const uint32_t* sources, const uint32_t* targets,
+                            AdjacencyBuffers* adj) {
+    adj->first = calloc(node_count + 1, sizeof(uint32_t));
+    adj->bytes = calloc(node_count + 1, sizeof(uint64_t));
+    adj->data = malloc(edge_count * 5 + 1);
+    if (!adj->first || !adj->bytes || !adj->data) return DEPTRACK_ERROR_MEMORY;
+
+    size_t edge = 0;
+    size_t offset = 0;
+    for (size_t node = 0; node < node_count; node++) {
+        adj->first[node] = (uint32_t)edge;
+        adj->bytes[node] = offset;
+        uint32_t previous = 0;
+        for (; edge < edge_count && sources[edge] == node; edge++) {
+            offset += put_varint(adj->data + offset, targets[edge] - previous);
+            previous = targets[edge];
+        }
+    }
+    adj->first[node_count] = (uint32_t)edge;
+    adj->bytes[node_count] = offset;
+    adj->data_size = offset;
+    return DEPTRACK_SUCCESS;
+}
+
+static void adjacency_free(AdjacencyBuffers* adj) {
+    free(adj->first);
+    free(adj->bytes);
+    free(adj->data);
+}
+
+static int write_all(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t written = writev(fd, iov, count < 1024 ? count : 1024);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return DEPTRACK_ERROR_OUTPUT;
+        }
+        size_t left = (size_t)written;
+        while (count > 0 && left >= iov->iov_len) {
+            left -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char*)iov->iov_base + left;
+            iov->iov_len -= left;
+        }
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+// Sections, each followed by its padding, after the header and the section table
+static int write_file(const char* path, const SnapshotHeader* fields, const void* const* data,
+                      const size_t* lengths) {
+    static const uint8_t zeros[SNAPSHOT_ALIGN];
+    SnapshotHeader header = *fields;
+    SnapshotSection table[SECTION_COUNT];
+    struct iovec iov[2 + 2 * SECTION_COUNT];
+    int iov_count = 2;
+
+    uint64_t offset = sizeof(SnapshotHeader) + sizeof(table);
+    for (size_t s = 0; s < SECTION_COUNT; s++) {
+        table[s] = (SnapshotSection){ (uint32_t)(s + 1), 0, offset, lengths[s] };
+        size_t padding = (SNAPSHOT_ALIGN - lengths[s] % SNAPSHOT_ALIGN) % SNAPSHOT_ALIGN;
+        iov[iov_count++] = (struct iovec){ (void*)data[s], lengths[s] };
+        iov[iov_count++] = (struct iovec){ (void*)zeros, padding };
+        offset += lengths[s] + padding;
+    }
+    header.file_size = offset;
+    header.section_count = SECTION_COUNT;
+
+    SimdIsa isa = simd_detect_isa();
+    uint32_t crc = crc_update(0, table, sizeof(table), isa);
+    for (int i = 2; i < iov_count; i++) crc = crc_update(crc, iov[i].iov_base, iov[i].iov_len, isa);
+    header.checksum = crc;
+    iov[0] = (struct iovec){ &header, sizeof(header) };
+    iov[1] = (struct iovec){ table, sizeof(table) };
+
+    // Readers that still map the old file keep it; they see the new one when they reopen
+    size_t path_length = strlen(path);
+    char* temporary = malloc(path_length + 5);
+    if (!temporary) return DEPTRACK_ERROR_MEMORY;
+    memcpy(temporary, path, path_length);
+    memcpy(temporary + path_length, ".tmp", 5);
+
+    int result = DEPTRACK_ERROR_OUTPUT;
+    int fd = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        result = write_all(fd, iov, iov_count);
+        if (close(fd) != 0 && result == DEPTRACK_SUCCESS) result = DEPTRACK_ERROR_OUTPUT;
+        if (result == DEPTRACK_SUCCESS && rename(temporary, path) != 0) result = DEPTRACK_ERROR_OUTPUT;
+        if (result != DEPTRACK_SUCCESS) unlink(temporary);
+    }
+    free(temporary);
+    return result;
+}
+
+int graph_snapshot_write(const DependencyGraph* graph, ThreadPool* pool, const char* path) {
+    if (!graph || !path) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+    size_t node_count = graph->node_count;
+    size_t edge_count = graph->edge_count;
+    if (node_count >= UINT32_MAX || edge_count >= UINT32_MAX) {
+        return DEPTRACK_ERROR_OUTPUT;
+    }
+    pthread_once(&crc_table_once, crc_table_init);
+
+    GraphOrder order;
+    int result = graph_sort(graph, pool, &order);
+    if (result != DEPTRACK_SUCCESS) {
+        return result;
+    }
+
+    size_t n = node_count ? node_count : 1;
+    size_t m = edge_count ? edge_count : 1;
+    StringTable strings = { .offsets = hashmap_create(n * 2 + 1) };
+    uint32_t* rank = malloc(n * sizeof(uint32_t));
+    uint32_t* node_id = malloc(n * sizeof(uint32_t));
+    uint32_t* node_name = malloc(n * sizeof(uint32_t));
+    uint32_t* node_path = malloc(n * sizeof(uint32_t));
+    uint8_t* node_type = malloc(n);
+    uint8_t* edge_type = malloc(m);
+    uint32_t* edge_version = malloc(m * sizeof(uint32_t));
+    uint32_t* from = malloc(m * sizeof(uint32_t));
+    uint32_t* to = malloc(m * sizeof(uint32_t));
+    uint32_t* reverse_node = malloc(m * sizeof(uint32_t));
+    uint32_t* reverse_neighbor = malloc(m * sizeof(uint32_t));
+    uint32_t* reverse_next = calloc(n + 1, sizeof(uint32_t));
+    AdjacencyBuffers out = { 0 }, in = { 0 };
+    result = DEPTRACK_ERROR_MEMORY;
+    if (strings.offsets && rank && node_id && node_name && node_path && node_type && edge_type && edge_version &&
+        from && to && reverse_node && reverse_neighbor && reverse_next) {
+        result = DEPTRACK_SUCCESS;
+    }
+
+    for (size_t i = 0; result == DEPTRACK_SUCCESS && i < node_count; i++) {
+        size_t node = order.nodes[i];
+        rank[node] = (uint32_t)i;
+        node_type[i] = graph->node_type[node];
+        result = intern(&strings, graph_node_id(graph, node), &node_id[i]);
+        if (result == DEPTRACK_SUCCESS) result = intern(&strings, graph_node_name(graph, node), &node_name[i]);
+        if (result == DEPTRACK_SUCCESS) result = intern(&strings, graph_node_filepath(graph, node), &node_path[i]);
+    }
+    for (size_t i = 0; result == DEPTRACK_SUCCESS && i < edge_count; i++) {
+        size_t edge = order.edges[i];
+        from[i] = rank[graph->edge_from[edge]];
+        to[i] = rank[graph->edge_to[edge]];
+        edge_type[i] = graph->edge_type[edge];
+        result = intern(&strings, graph_edge_version(graph, edge), &edge_version[i]);
+    }
+
+    // Reverse edges by counting sort on the target; sources stay ascending because edges are sorted by source
+    if (result == DEPTRACK_SUCCESS) {
+        for (size_t i = 0; i < edge_count; i++) reverse_next[to[i] + 1]++;
+        for (size_t i = 0; i < node_count; i++) reverse_next[i + 1] += reverse_next[i];
+        for (size_t i = 0; i < edge_count; i++) {
+            uint32_t slot = reverse_next[to[i]]++;
+            reverse_node[slot] = to[i];
+            reverse_neighbor[slot] = from[i];
+        }
+        result = encode_adjacency(node_count, edge_count, from, to, &out);
+    }
+    if (result == DEPTRACK_SUCCESS) {
+        result = encode_adjacency(node_count, edge_count, reverse_node, reverse_neighbor, &in);
+    }
+    if (result == DEPTRACK_SUCCESS && strings.length == 0) {
+        result = intern(&strings, "", &(uint32_t){ 0 });
+    }
+
+    if (result == DEPTRACK_SUCCESS) {
+        SnapshotHeader header = {
+            .version = SNAPSHOT_VERSION,
+            .byte_order = SNAPSHOT_BYTE_ORDER,
+            .node_count = node_count,
+            .edge_count = edge_count
+        };
+        memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+        const void* data[SECTION_COUNT] = {
+            strings.data, node_id, node_name, node_path, node_type, edge_type, edge_version,
+            out.first, out.bytes, out.data, in.first, in.bytes, in.data
+        };
+        const size_t lengths[SECTION_COUNT] = {
+            strings.length, node_count * sizeof(uint32_t), node_count * sizeof(uint32_t),
+            node_count * sizeof(uint32_t), node_count, edge_count, edge_count * sizeof(uint32_t),
+            (node_count + 1) * sizeof(uint32_t), (node_count + 1) * sizeof(uint64_t), out.data_size,
+            (node_count + 1) * sizeof(uint32_t), (node_count + 1) * sizeof(uint64_t), in.data_size
+        };
+        result = write_file(path, &header, data, lengths);
+    }
+
+    hashmap_destroy(strings.offsets);
+    free(strings.data);
+    free(rank);
+    free(node_id);
+    free(node_name);
+    free(node_path);
+    free(node_type);
+    free(edge_type);
+    free(edge_version);
+    free(from);
+    free(to);
+    free(reverse_node);
+    free(reverse_neighbor);
+    free(reverse_next);
+    adjacency_free(&out);
+    adjacency_free(&in);
+    graph_order_destroy(&order);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+// Section payload when it exists and is exactly length bytes
+static const void* find_section(const GraphSnapshot* snapshot, const SnapshotHeader* header, SectionId id,
+                                size_t element_size, size_t count, size_t* length) {
+    const SnapshotSection* table = (const SnapshotSection*)(snapshot->map + sizeof(SnapshotHeader));
+    for (uint32_t s = 0; s < header->section_count; s++) {
+        if (table[s].id != (uint32_t)id) continue;
+        uint64_t offset = table[s].offset;
+        uint64_t size = table[s].length;
+        if (offset % SNAPSHOT_ALIGN != 0 || offset > snapshot->size || size > snapshot->size - offset) return NULL;
+        if (element_size && size != (uint64_t)element_size * count) return NULL;
+        if (length) *length = (size_t)size;
+        return snapshot->map + offset;
+    }
+    return NULL;
+}
+
+static bool load_adjacency(GraphSnapshot* snapshot, const SnapshotHeader* header, SectionId first,
+                           SnapshotAdjacency* adj) {
+    size_t n = snapshot->node_count + 1;
+    adj->first = find_section(snapshot, header, first, sizeof(uint32_t), n, NULL);
+    adj->bytes = find_section(snapshot, header, first + 1, sizeof(uint64_t), n, NULL);
+    adj->data = find_section(snapshot, header, first + 2, 0, 0, &adj->data_size);
+    return adj->first && adj->bytes && adj->data && adj->first[snapshot->node_count] == snapshot->edge_count;
+}
+
+int graph_snapshot_open(const char* path, GraphSnapshot** out) {
+    if (!path || !out) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+    *out = NULL;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return DEPTRACK_ERROR_FILE_NOT_FOUND;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(SnapshotHeader)) {
+        close(fd);
+        return DEPTRACK_ERROR_PARSE_FAILED;
+    }
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return DEPTRACK_ERROR_FILE_NOT_FOUND;
+    }
+
+    GraphSnapshot* snapshot = calloc(1, sizeof(GraphSnapshot));
+    if (!snapshot) {
+        munmap(map, (size_t)st.st_size);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+    snapshot->map = map;
+    snapshot->size = (size_t)st.st_size;
+
+    const SnapshotHeader* header = map;
+    bool valid = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0 &&
+                 header->version == SNAPSHOT_VERSION && header->byte_order == SNAPSHOT_BYTE_ORDER &&
+                 header->file_size == snapshot->size && header->node_count < UINT32_MAX &&
+                 header->edge_count < UINT32_MAX &&
+                 header->section_count <= (snapshot->size - sizeof(SnapshotHeader)) / sizeof(SnapshotSection);
+    if (valid) {
+        size_t n = snapshot->node_count = (size_t)header->node_count;
+        size_t m = snapshot->edge_count = (size_t)header->edge_count;
+        snapshot->strings = find_section(snapshot, header, SECTION_STRINGS, 0, 0, &snapshot->strings_size);
+        snapshot->node_id = find_section(snapshot, header, SECTION_NODE_ID, sizeof(uint32_t), n, NULL);
+        snapshot->node_name = find_section(snapshot, header, SECTION_NODE_NAME, sizeof(uint32_t), n, NULL);
+        snapshot->node_path = find_section(snapshot, header, SECTION_NODE_PATH, sizeof(uint32_t), n, NULL);
+        snapshot->node_type = find_section(snapshot, header, SECTION_NODE_TYPE, 1, n, NULL);
+        snapshot->edge_type = find_section(snapshot, header, SECTION_EDGE_TYPE, 1, m, NULL);
+        snapshot->edge_version = find_section(snapshot, header, SECTION_EDGE_VERSION, sizeof(uint32_t), m, NULL);
+        // A string table ending in NUL keeps every in-range offset a terminated string
+        valid = snapshot->strings && snapshot->strings_size > 0 &&
+                snapshot->strings[snapshot->strings_size - 1] == '\0' && snapshot->node_id && snapshot->node_name &&
+                snapshot->node_path && snapshot->node_type && snapshot->edge_type && snapshot->edge_version &&
+                load_adjacency(snapshot, header, SECTION_OUT_FIRST, &snapshot->out) &&
+                load_adjacency(snapshot, header, SECTION_IN_FIRST, &snapshot->in);
+    }
+    if (!valid) {
+        graph_snapshot_close(snapshot);
+        return DEPTRACK_ERROR_PARSE_FAILED;
+    }
+    *out = snapshot;
+    return DEPTRACK_SUCCESS;
+}
+
+void graph_snapshot_close(GraphSnapshot* snapshot) {
+    if (!snapshot) return;
+    munmap(snapshot->map, snapshot->size);
+    free(snapshot);
+}
+
+int graph_snapshot_verify(const GraphSnapshot* snapshot) {
+    if (!snapshot) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+    const SnapshotHeader* header = (const SnapshotHeader*)snapshot->map;
+    uint32_t crc = graph_snapshot_checksum(snapshot->map + sizeof(SnapshotHeader),
+                                           snapshot->size - sizeof(SnapshotHeader), SIMD_ISA_AVX2);
+    return crc == header->checksum ? DEPTRACK_SUCCESS : DEPTRACK_ERROR_PARSE_FAILED;
+}
+
+size_t graph_snapshot_node_count(const GraphSnapshot* snapshot) {
+    return snapshot ? snapshot->node_count : 0;
+}
+
+size_t graph_snapshot_edge_count(const GraphSnapshot* snapshot) {
+    return snapshot ? snapshot->edge_count : 0;
+}
+
+static const char* string_at(const GraphSnapshot* snapshot, uint32_t offset) {
+    return offset < snapshot->strings_size ? snapshot->strings + offset : NULL;
+}
+
+const char* graph_snapshot_node_id(const GraphSnapshot* snapshot, size_t node) {
+    return snapshot && node < snapshot->node_count ? string_at(snapshot, snapshot->node_id[node]) : NULL;
+}
+
+const char* graph_snapshot_node_name(const GraphSnapshot* snapshot, size_t node) {
+    return snapshot && node < snapshot->node_count ? string_at(snapshot, snapshot->node_name[node]) : NULL;
+}
+
+const char* graph_snapshot_node_filepath(const GraphSnapshot* snapshot, size_t node) {
+    return snapshot && node < snapshot->node_count ? string_at(snapshot, snapshot->node_path[node]) : NULL;
+}
+
+NodeType graph_snapshot_node_type(const GraphSnapshot* snapshot, size_t node) {
+    return snapshot && node < snapshot->node_count ? (NodeType)snapshot->node_type[node] : NODE_LIBRARY;
+}
+
+DependencyType graph_snapshot_edge_type(const GraphSnapshot* snapshot, size_t edge) {
+    return snapshot && edge < snapshot->edge_count ? (DependencyType)snapshot->edge_type[edge] : DEP_EXTERNAL;
+}
+
+const char* graph_snapshot_edge_version(const GraphSnapshot* snapshot, size_t edge) {
+    return snapshot && edge < snapshot->edge_count ? string_at(snapshot, snapshot->edge_version[edge]) : NULL;
+}
+
+// Ids ascend with node numbers, so lookup is a binary search over the id column
+size_t graph_snapshot_find_node(const GraphSnapshot* snapshot, const char* id) {
+    if (!snapshot || !id) return SIZE_MAX;
+    size_t low = 0, high = snapshot->node_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        const char* probe = string_at(snapshot, snapshot->node_id[mid]);
+        int order = probe ? strcmp(probe, id) : 1;
+        if (order == 0) return mid;
+        if (order < 0) low = mid + 1;
+        else high = mid;
+    }
+    return SIZE_MAX;
+}
+
+static void cursor_init(const GraphSnapshot* snapshot, const SnapshotAdjacency* adj, size_t node,
+                        SnapshotCursor* cursor) {
+    memset(cursor, 0, sizeof(*cursor));
+    if (!snapshot || node >= snapshot->node_count) return;
+    uint64_t begin = adj->bytes[node];
+    uint64_t end = adj->bytes[node + 1];
+    if (begin > end || end > adj->data_size || adj->first[node] > adj->first[node + 1]) return;
+    cursor->data = adj->data + begin;
+    cursor->end = adj->data + end;
+    cursor->edge = adj->first[node];
+    cursor->remaining = adj->first[node + 1] - adj->first[node];
+    cursor->node_count = snapshot->node_count;
+}
+
+void graph_snapshot_dependencies(const GraphSnapshot* snapshot, size_t node, SnapshotCursor* cursor) {
+    cursor_init(snapshot, snapshot ? &snapshot->out : NULL, node, cursor);
+    cursor->has_edges = true;
+}
+
+void graph_snapshot_dependents(const GraphSnapshot* snapshot, size_t node, SnapshotCursor* cursor) {
+    cursor_init(snapshot, snapshot ? &snapshot->in : NULL, node, cursor);
+}
+
+bool snapshot_cursor_next(SnapshotCursor* cursor, size_t* neighbor, size_t* edge) {
+    if (!cursor || cursor->remaining == 0) return false;
+    uint64_t delta = 0;
+    unsigned shift = 0;
+    for (;;) {
+        if (cursor->data >= cursor->end || shift > 63) {
+            cursor->remaining = 0;
+            return false;
+        }
+        uint8_t byte = *cursor->data++;
+        delta |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+        shift += 7;
+    }
+    cursor->neighbor += delta;
+    if (cursor->neighbor >= cursor->node_count) {
+        cursor->remaining = 0;
+        return false;
+    }
+    cursor->remaining--;
+    if (neighbor) *neighbor = cursor->neighbor;
+    if (edge) *edge = cursor->has_edges ? cursor->edge : SIZE_MAX;
+    cursor->edge++;
+    return true;
+}
@@ -0,0 +1,327 @@
+/**
+ * @file graph_sort.c
+ * @brief Deterministic parallel ordering of graph nodes and edges
+ * @author Unhinged Development Team
+ *
+ * @llm-type algorithm
+ * @llm-legend Gives output generators one canonical order, so the same graph serializes to the same bytes
+ *             whatever order the pipeline happened to insert nodes and edges in, at any thread count
+ * @llm-key Nodes are sample-sorted by id: splitters taken from a regular sample cut the ids into buckets,
+ *          blocks classify and scatter in parallel, and every bucket is sorted on its own. The rank of a
+ *          node in that order interns its id, so an edge packs (from rank, to rank, type) into one 64-bit
+ *          key and is placed by a stable parallel LSD radix sort, one byte per pass, skipping bytes every
+ *          key shares
+ * @llm-contract The result depends only on the graph's contents: ids are unique, and so are edge keys,
+ *               since the graph merges edges that repeat (from, to, type)
+ */
+
+#include "dependency_tracker.h"
+
+#define SORT_SERIAL_THRESHOLD 4096  // Below this one qsort beats splitting
+#define SORT_BLOCK_MINIMUM 4096     // Fewest items a block handles, so counting stays cheap
+#define SORT_BLOCKS_PER_WORKER 4
+#define SORT_OVERSAMPLE 16          // Samples per bucket
+#define SORT_RADIX_BITS 8
+#define SORT_RADIX (1u << SORT_RADIX_BITS)
+#define SORT_TYPE_BITS 3            // DependencyType fits
+
+typedef struct {
+    const char* id;
+    size_t index;
+} NodeKey;
+
+typedef struct {
+    uint64_t key;
+    size_t index;
+} EdgeKey;
+
+static int compare_node_keys(const void* a, const void* b) {
+    return strcmp(((const NodeKey*)a)->id, ((const NodeKey*)b)->id);
+}
+
+static size_t block_count(ThreadPool* pool, size_t count) {
+    size_t blocks = thread_pool_size(pool) * SORT_BLOCKS_PER_WORKER;
+    size_t limit = count / SORT_BLOCK_MINIMUM;
+    if (blocks > limit) blocks = limit;
+    return blocks > 0 ? blocks : 1;
+}
+
+static void block_range(size_t count, size_t blocks, size_t block, size_t* begin, size_t* end) {
+    *begin = count * block / blocks;
+    *end = count * (block + 1) / blocks;
+}
+
+// ---------------------------------------------------------------------------
+// Nodes: sample sort by id
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    NodeKey* keys;
+    NodeKey* sorted;
+    size_t count;
+    size_t blocks;
+    const NodeKey* splitters;  // buckets - 1 of them, ascending
+    size_t buckets;
+    uint32_t* bucket_of;       // Per key
+    size_t* counts;            // [block][bucket], then the block's first output position
+    size_t* bucket_start;      // buckets + 1 entries
+} SampleSort;
+
+static void classify_block(size_t first, size_t last, void* context) {
+    SampleSort* sort = context;
+    for (size_t block = first; block < last; block++) {
+        size_t begin, end;
+        block_range(sort->count, sort->blocks, block, &begin, &end);
+        size_t* counts = &sort->counts[block * sort->buckets];
+        for (size_t i = begin; i < end; i++) {
+            // First splitter greater than the key
+            size_t low = 0;
+            size_t high = sort->buckets - 1;
+            while (low < high) {
+                size_t middle = (low + high) / 2;
+                if (strcmp(sort->keys[i].id, sort->splitters[middle].id) < 0) {
+                    high = middle;
+                } else {
+                    low = middle + 1;
+                }
+            }
+            sort->bucket_of[i] = (uint32_t)low;
+            counts[low]++;
+        }
+    }
+}
+
+static void scatter_block(size_t first, size_t last, void* context) {
+    SampleSort* sort = context;
+    for (size_t block = first; block < last; block++) {
+        size_t begin, end;
+        block_range(sort->count, sort->blocks, block, &begin, &end);
+        size_t* next = &sort->counts[block * sort->buckets];
+        for (size_t i = begin; i < end; i++) {
+            sort->sorted[next[sort->bucket_of[i]]++] = sort->keys[i];
+        }
+    }
+}
+
+static void sort_buckets(size_t first, size_t last, void* context) {
+    SampleSort* sort = context;
+    for (size_t bucket = first; bucket < last; bucket++) {
+        size_t begin = sort->bucket_start[bucket];
+        qsort(sort->sorted + begin, sort->bucket_start[bucket + 1] - begin, sizeof(NodeKey), compare_node_keys);
+    }
+}
+
+// Sorts keys into sorted; keys is left in an unspecified order
+static int sample_sort(ThreadPool* pool, NodeKey* keys, NodeKey* sorted, size_t count) {
+    size_t blocks = block_count(pool, count);
+    if (count < SORT_SERIAL_THRESHOLD || blocks == 1) {
+        memcpy(sorted, keys, count * sizeof(NodeKey));
+        qsort(sorted, count, sizeof(NodeKey), compare_node_keys);
+        return DEPTRACK_SUCCESS;
+    }
+
+    // Regular sample: every step-th key, sorted, then every SORT_OVERSAMPLE-th sample splits
+    size_t buckets = blocks;
+    size_t sample_count = buckets * SORT_OVERSAMPLE;
+    NodeKey* samples = malloc(sample_count * sizeof(NodeKey));
+    NodeKey* splitters = malloc((buckets - 1) * sizeof(NodeKey));
+    uint32_t* bucket_of = malloc(count * sizeof(uint32_t));
+    size_t* counts = calloc(blocks * buckets, sizeof(size_t));
+    size_t* bucket_start = malloc((buckets + 1) * sizeof(size_t));
+    int result = DEPTRACK_ERROR_MEMORY;
+    if (samples && splitters && bucket_of && counts && bucket_start) {
+        for (size_t i = 0; i < sample_count; i++) {
+            samples[i] = keys[i * (count / sample_count)];
+        }
+        qsort(samples, sample_count, sizeof(NodeKey), compare_node_keys);
+        for (size_t i = 1; i < buckets; i++) {
+            splitters[i - 1] = samples[i * SORT_OVERSAMPLE];
+        }
+
+        SampleSort sort = { keys, sorted, count, blocks, splitters, buckets, bucket_of, counts, bucket_start };
+        result = thread_pool_parallel_for(pool, 0, blocks, 1, classify_block, &sort);
+
+        // Bucket-major prefix sum: bucket b of block k starts after all smaller buckets and earlier blocks
+        size_t position = 0;
+        for (size_t bucket = 0; bucket < buckets; bucket++) {
+            bucket_start[bucket] = position;
+            for (size_t block = 0; block < blocks; block++) {
+                size_t n = counts[block * buckets + bucket];
+                counts[block * buckets + bucket] = position;
+                position += n;
+            }
+        }
+        bucket_start[buckets] = position;
+
+        if (result == DEPTRACK_SUCCESS) {
+            result = thread_pool_parallel_for(pool, 0, blocks, 1, scatter_block, &sort);
+        }
+        if (result == DEPTRACK_SUCCESS) {
+            result = thread_pool_parallel_for(pool, 0, buckets, 1, sort_buckets, &sort);
+        }
+    }
+    free(samples);
+    free(splitters);
+    free(bucket_of);
+    free(counts);
+    free(bucket_start);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Edges: LSD radix sort on packed (from rank, to rank, type)
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const DependencyGraph* graph;
+    const size_t* rank;        // By node index
+    unsigned rank_bits;
+    EdgeKey* keys;
+} EdgeKeying;
+
+// Reads only the endpoint and type columns
+static void key_edges(size_t begin, size_t end, void* context) {
+    EdgeKeying* keying = context;
+    const uint32_t* from = keying->graph->edge_from;
+    const uint32_t* to = keying->graph->edge_to;
+    const uint8_t* type = keying->graph->edge_type;
+    for (size_t i = begin; i < end; i++) {
+        keying->keys[i].key = ((uint64_t)keying->rank[from[i]] << (keying->rank_bits + SORT_TYPE_BITS)) |
+                              ((uint64_t)keying->rank[to[i]] << SORT_TYPE_BITS) | (uint64_t)type[i];
+        keying->keys[i].index = i;
+    }
+}
+
+typedef struct {
+    EdgeKey* source;
+    EdgeKey* target;
+    size_t count;
+    size_t blocks;
+    unsigned shift;
+    size_t* counts;            // [block][digit], then the block's next output position
+} RadixPass;
+
+static void radix_count(size_t first, size_t last, void* context) {
+    RadixPass* pass = context;
+    for (size_t block = first; block < last; block++) {
+        size_t begin, end;
+        block_range(pass->count, pass->blocks, block, &begin, &end);
+        size_t* counts = &pass->counts[block * SORT_RADIX];
+        memset(counts, 0, SORT_RADIX * sizeof(size_t));
+        for (size_t i = begin; i < end; i++) {
+            counts[(pass->source[i].key >> pass->shift) & (SORT_RADIX - 1)]++;
+        }
+    }
+}
+
+static void radix_scatter(size_t first, size_t last, void* context) {
+    RadixPass* pass = context;
+    for (size_t block = first; block < last; block++) {
+        size_t begin, end;
+        block_range(pass->count, pass->blocks, block, &begin, &end);
+        size_t* next = &pass->counts[block * SORT_RADIX];
+        for (size_t i = begin; i < end; i++) {
+            pass->target[next[(pass->source[i].key >> pass->shift) & (SORT_RADIX - 1)]++] = pass->source[i];
+        }
+    }
+}
+
+// Stable, so the result in *keys does not depend on how the blocks were split; scratch matches keys in size
+static int radix_sort(ThreadPool* pool, EdgeKey** keys, EdgeKey** scratch, size_t count, unsigned key_bits) {
+    size_t blocks = block_count(pool, count);
+    size_t* counts = malloc(blocks * SORT_RADIX * sizeof(size_t));
+    if (!counts) return DEPTRACK_ERROR_MEMORY;
+
+    int result = DEPTRACK_SUCCESS;
+    for (unsigned shift = 0; shift < key_bits && result == DEPTRACK_SUCCESS; shift += SORT_RADIX_BITS) {
+        RadixPass pass = { *keys, *scratch, count, blocks, shift, counts };
+        result = thread_pool_parallel_for(pool, 0, blocks, 1, radix_count, &pass);
+        if (result != DEPTRACK_SUCCESS) break;
+
+        // A byte every key shares would only copy the array
+        bool uniform = false;
+        size_t position = 0;
+        for (size_t digit = 0; digit < SORT_RADIX; digit++) {
+            size_t digit_start = position;
+            for (size_t block = 0; block < blocks; block++) {
+                size_t n = counts[block * SORT_RADIX + digit];
+                counts[block * SORT_RADIX + digit] = position;
+                position += n;
+            }
+            if (position - digit_start == count) uniform = true;
+        }
+        if (uniform) continue;
+
+        result = thread_pool_parallel_for(pool, 0, blocks, 1, radix_scatter, &pass);
+        EdgeKey* swap = *keys;
+        *keys = *scratch;
+        *scratch = swap;
+    }
+    free(counts);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Entry point
+// ---------------------------------------------------------------------------
+
+void graph_order_destroy(GraphOrder* order) {
+    if (!order) return;
+    free(order->nodes);
+    free(order->edges);
+    memset(order, 0, sizeof(*order));
+}
+
+int graph_sort(const DependencyGraph* graph, ThreadPool* pool, GraphOrder* order) {
+    if (!graph || !order) return DEPTRACK_ERROR_INVALID_PARAM;
+    memset(order, 0, sizeof(*order));
+
+    size_t node_count = graph->node_count;
+    size_t edge_count = graph->edge_count;
+    unsigned rank_bits = 1;
+    while (rank_bits < 64 && ((size_t)1 << rank_bits) < node_count) rank_bits++;
+    if (2 * rank_bits + SORT_TYPE_BITS > 64) return DEPTRACK_ERROR_INVALID_PARAM;
+
+    NodeKey* node_keys = malloc((node_count ? node_count : 1) * sizeof(NodeKey));
+    NodeKey* sorted = malloc((node_count ? node_count : 1) * sizeof(NodeKey));
+    size_t* rank = malloc((node_count ? node_count : 1) * sizeof(size_t));
+    order->nodes = malloc((node_count ? node_count : 1) * sizeof(size_t));
+    order->edges = malloc((edge_count ? edge_count : 1) * sizeof(size_t));
+    EdgeKey* edge_keys = malloc((edge_count ? edge_count : 1) * sizeof(EdgeKey));
+    EdgeKey* scratch = malloc((edge_count ? edge_count : 1) * sizeof(EdgeKey));
+    int result = DEPTRACK_ERROR_MEMORY;
+    if (node_keys && sorted && rank && order->nodes && order->edges && edge_keys && scratch) {
+        for (size_t i = 0; i < node_count; i++) {
+            node_keys[i] = (NodeKey){ graph_node_id(graph, i), i };
+        }
+        result = sample_sort(pool, node_keys, sorted, node_count);
+    }
+    if (result == DEPTRACK_SUCCESS) {
+        for (size_t i = 0; i < node_count; i++) {
+            order->nodes[i] = sorted[i].index;
+            rank[sorted[i].index] = i;
+        }
+
+        EdgeKeying keying = { graph, rank, rank_bits, edge_keys };
+        result = thread_pool_parallel_for(pool, 0, edge_count, 0, key_edges, &keying);
+        if (result == DEPTRACK_SUCCESS) {
+            result = radix_sort(pool, &edge_keys, &scratch, edge_count, 2 * rank_bits + SORT_TYPE_BITS);
+        }
+        for (size_t i = 0; result == DEPTRACK_SUCCESS && i < edge_count; i++) {
+            order->edges[i] = edge_keys[i].index;
+        }
+    }
+    free(node_keys);
+    free(sorted);
+    free(rank);
+    free(edge_keys);
+    free(scratch);
+
+    if (result != DEPTRACK_SUCCESS) {
+        graph_order_destroy(order);
+        return result;
+    }
+    order->node_count = node_count;
+    order->edge_count = edge_count;
+    return DEPTRACK_SUCCESS;
+}
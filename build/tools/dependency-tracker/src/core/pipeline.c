@@ -0,0 +1,887 @@
+/**
+ * @file pipeline.c
+ * @brief Staged directory analysis: enumerate, read, parse and merge
+ * @author Unhinged Development Team
+ *
+ * @llm-type service
+ * @llm-legend Runs deptrack_analyze_directory as four stages connected by bounded queues, so a tree of
+ *             any size is analyzed with a fixed number of files in flight
+ * @llm-key Queues are Vyukov-style bounded MPMC rings: every cell carries a sequence number, and producers
+ *          and consumers claim positions with one CAS each. A full queue stalls its producers (backpressure);
+ *          an empty one stalls its consumers until every upstream worker has finished
+ * @llm-axiom Stage workers are tasks on the tracker's thread pool, not threads: each call runs a batch and
+ *            re-queues itself, and a stalled worker parks on an event count instead of holding its pool
+ *            thread; whoever pushes, pops, closes the queue or lists a directory it waits on re-queues it,
+ *            so any split of workers runs on any number of threads without polling
+ * @llm-map Enumeration workers share a directory work list and classify files by path; readers sniff the
+ *          content of files the path leaves unknown and load all but streamed (SQL) ones; parsers run
+ *          deptrack_parse_buffer, or deptrack_parse_file on streamed files, and turn dependency paths
+ *          relative to the file into root-relative ids; mergers hand each file to
+ *          deptrack_merge_parsed_file, which adds its node, dependency nodes and edges as one bulk batch
+ * @llm-contract Metrics report, per stage, the workers, items passed on, input queue depth and the time
+ *               spent working, starved and blocked, which is what tuning the thread split needs
+ */
+
+#include "dependency_tracker.h"
+#include <dirent.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define PIPELINE_DEFAULT_QUEUE_CAPACITY 256
+#define PIPELINE_SNIFF_LENGTH 512
+#define PIPELINE_CACHE_LINE 64
+#define PIPELINE_BATCH 32          // Items a worker handles per run before letting other tasks in
+
+// ---------------------------------------------------------------------------
+// Bounded MPMC queue
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    atomic_size_t sequence;    // == position when free for the producer of position, position + 1 when full
+    void* data;
+} MpmcCell;
+
+struct MpmcQueue {
+    MpmcCell* cells;
+    size_t mask;
+    _Alignas(PIPELINE_CACHE_LINE) atomic_size_t enqueue_position;
+    _Alignas(PIPELINE_CACHE_LINE) atomic_size_t dequeue_position;
+};
+
+MpmcQueue* mpmc_queue_create(size_t capacity) {
+    // Past the cap the doubling below could wrap to 0 and never reach capacity
+    if (capacity > PIPELINE_MAX_QUEUE_CAPACITY) return NULL;
+    size_t size = 2;
+    while (size < capacity) size *= 2;
+
+    MpmcQueue* queue = aligned_alloc(PIPELINE_CACHE_LINE, sizeof(MpmcQueue));
+    if (!queue) return NULL;
+    queue->cells = calloc(size, sizeof(MpmcCell));
+    if (!queue->cells) {
+        free(queue);
+        return NULL;
+    }
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(&queue->cells[i].sequence, i);
+    }
+    queue->mask = size - 1;
+    atomic_init(&queue->enqueue_position, 0);
+    atomic_init(&queue->dequeue_position, 0);
+    return queue;
+}
+
+void mpmc_queue_destroy(MpmcQueue* queue) {
+    if (!queue) return;
+    free(queue->cells);
+    free(queue);
+}
+
+size_t mpmc_queue_capacity(const MpmcQueue* queue) {
+    return queue ? queue->mask + 1 : 0;
+}
+
+bool mpmc_queue_push(MpmcQueue* queue, void* item) {
+    size_t position = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed);
+    MpmcCell* cell;
+    for (;;) {
+        cell = &queue->cells[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_position, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;   // The consumer of this cell's previous lap has not taken it yet
+        } else {
+            position = atomic_load_explicit(&queue->enqueue_position, memory_order_relaxed);
+        }
+    }
+    cell->data = item;
+    atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+    return true;
+}
+
+bool mpmc_queue_pop(MpmcQueue* queue, void** item) {
+    size_t position = atomic_load_explicit(&queue->dequeue_position, memory_order_relaxed);
+    MpmcCell* cell;
+    for (;;) {
+        cell = &queue->cells[position & queue->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeue_position, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = atomic_load_explicit(&queue->dequeue_position, memory_order_relaxed);
+        }
+    }
+    *item = cell->data;
+    atomic_store_explicit(&cell->sequence, position + queue->mask + 1, memory_order_release);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Pipeline state
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    char* path;
+    Language language;         // LANG_UNKNOWN until the reader sniffs the content
+    char* buffer;
+    size_t length;
+    ParsedFile* parsed;
+} PipelineItem;
+
+typedef struct PipelineWorker PipelineWorker;
+
+// Event count: a stalled worker reads the epoch before looking for work and parks only if no notify has
+// bumped it since, so a change between its look and its park is never missed
+typedef struct {
+    atomic_uint epoch;
+    atomic_size_t parked_count;
+    PipelineWorker* parked;    // Under Pipeline.park_mutex, linked through next_parked
+} PipelineEvent;
+
+// The queue feeding a stage and who still writes to it
+typedef struct {
+    MpmcQueue* queue;
+    atomic_size_t producers;   // Upstream workers still running; 0 closes the queue
+    PipelineEvent items;       // Pushes and closing, for the stage's starved workers
+    PipelineEvent room;        // Pops, for the upstream stage's blocked workers
+    atomic_long depth;
+    atomic_long max_depth;
+    atomic_ullong depth_sum;
+    atomic_ullong pushes;
+} PipelineLink;
+
+typedef struct {
+    atomic_size_t items;
+    atomic_ullong busy_ns;
+    atomic_ullong input_stall_ns;
+    atomic_ullong output_stall_ns;
+} PipelineCounters;
+
+typedef struct {
+    DependencyTracker* tracker;
+    TaskGroup* group;          // Every stage worker of this run
+    size_t root_length;
+    PipelineLink links[PIPELINE_STAGE_COUNT];   // links[s] feeds stage s; enumeration has none
+    PipelineCounters counters[PIPELINE_STAGE_COUNT];
+    atomic_size_t skipped;
+    atomic_size_t failed_files;
+    atomic_int error;          // First fatal error; stages drain their input without working on it
+
+    // Directories waiting to be listed, shared by the enumeration workers
+    pthread_mutex_t directory_mutex;
+    char** directories;
+    size_t directory_count;
+    size_t directory_capacity;
+    size_t directories_active;
+    PipelineEvent directory_event;   // Directories added or finished, for starved enumeration workers
+
+    pthread_mutex_t park_mutex;
+    PipelineWorker* orphans;   // Workers the pool could not take back; pipeline_run drains them
+} Pipeline;
+
+typedef enum {
+    STEP_DONE,                 // Input closed and drained; the worker is finished
+    STEP_YIELD,                // Batch used up; runs again behind the tasks already queued
+    STEP_STARVED,              // Input empty but still open
+    STEP_BLOCKED               // Next stage full; the item waits in worker->pending
+} StepResult;
+
+// A stage worker is a pool task that runs one batch per call and re-queues itself until its input closes
+struct PipelineWorker {
+    Pipeline* pipeline;
+    PipelineStage stage;
+    PipelineItem* pending;     // Finished here, not yet accepted by the next stage
+    DIR* dir;                  // Enumeration: the directory being listed
+    char* directory;
+    uint64_t stall_start;      // Nonzero while stalled
+    StepResult stalled_on;
+    PipelineWorker* next_parked;
+    uint64_t busy_ns;
+    uint64_t input_stall_ns;
+    uint64_t output_stall_ns;
+};
+
+static const char* stage_names[PIPELINE_STAGE_COUNT] = {
+    [PIPELINE_ENUMERATE] = "enumerate",
+    [PIPELINE_READ] = "read",
+    [PIPELINE_PARSE] = "parse",
+    [PIPELINE_MERGE] = "merge"
+};
+
+const char* pipeline_stage_name(PipelineStage stage) {
+    return stage >= 0 && stage < PIPELINE_STAGE_COUNT ? stage_names[stage] : "unknown";
+}
+
+void pipeline_config_default(PipelineConfig* config) {
+    if (!config) return;
+
+    config->threads[PIPELINE_ENUMERATE] = 1;
+    config->threads[PIPELINE_READ] = 2;
+    config->threads[PIPELINE_PARSE] = 0;   // One per pool worker, resolved by pipeline_run
+    config->threads[PIPELINE_MERGE] = 1;
+    config->queue_capacity = PIPELINE_DEFAULT_QUEUE_CAPACITY;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static bool pipeline_failed(Pipeline* p) {
+    return atomic_load_explicit(&p->error, memory_order_relaxed) != DEPTRACK_SUCCESS;
+}
+
+static void stage_task(void* arg);
+static void pipeline_fail(Pipeline* p, int error);
+
+// Re-queues a worker; one the pool cannot take any more is left for pipeline_run
+static void resume(Pipeline* p, PipelineWorker* worker) {
+    if (task_group_defer(p->group, stage_task, worker) == DEPTRACK_SUCCESS) return;
+
+    pipeline_fail(p, DEPTRACK_ERROR_MEMORY);
+    pthread_mutex_lock(&p->park_mutex);
+    worker->next_parked = p->orphans;
+    p->orphans = worker;
+    pthread_mutex_unlock(&p->park_mutex);
+}
+
+static unsigned event_prepare(PipelineEvent* event) {
+    return atomic_load(&event->epoch);
+}
+
+// False when the event fired after key was read; the worker should look again instead of parking
+static bool event_park(Pipeline* p, PipelineEvent* event, unsigned key, PipelineWorker* worker) {
+    pthread_mutex_lock(&p->park_mutex);
+    // Counted before the epoch is checked: a notify either sees the count or changed the epoch first
+    atomic_fetch_add(&event->parked_count, 1);
+    bool park = atomic_load(&event->epoch) == key;
+    if (park) {
+        worker->next_parked = event->parked;
+        event->parked = worker;
+    } else {
+        atomic_fetch_sub(&event->parked_count, 1);
+    }
+    pthread_mutex_unlock(&p->park_mutex);
+    return park;
+}
+
+// Called after the change a parked worker may be waiting for
+static void event_notify(Pipeline* p, PipelineEvent* event) {
+    atomic_fetch_add(&event->epoch, 1);
+    if (atomic_load(&event->parked_count) == 0) return;
+
+    pthread_mutex_lock(&p->park_mutex);
+    PipelineWorker* worker = event->parked;
+    event->parked = NULL;
+    atomic_store(&event->parked_count, 0);
+    pthread_mutex_unlock(&p->park_mutex);
+    while (worker) {
+        PipelineWorker* next = worker->next_parked;
+        resume(p, worker);
+        worker = next;
+    }
+}
+
+static void pipeline_fail(Pipeline* p, int error) {
+    int expected = DEPTRACK_SUCCESS;
+    if (!atomic_compare_exchange_strong(&p->error, &expected, error)) return;
+
+    // Every stage drains now, so every parked worker has something to do
+    event_notify(p, &p->directory_event);
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+        event_notify(p, &p->links[s].items);
+        event_notify(p, &p->links[s].room);
+    }
+}
+
+static void item_destroy(PipelineItem* item) {
+    if (!item) return;
+    free(item->path);
+    free(item->buffer);
+    parsed_file_destroy(item->parsed);
+    free(item);
+}
+
+// False when the queue is full; the caller still owns the item then
+static bool link_push(Pipeline* p, PipelineStage stage, PipelineItem* item) {
+    PipelineLink* link = &p->links[stage];
+    if (!mpmc_queue_push(link->queue, item)) return false;
+
+    long depth = atomic_fetch_add_explicit(&link->depth, 1, memory_order_relaxed) + 1;
+    long max = atomic_load_explicit(&link->max_depth, memory_order_relaxed);
+    while (depth > max && !atomic_compare_exchange_weak_explicit(&link->max_depth, &max, depth,
+                                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+    atomic_fetch_add_explicit(&link->depth_sum, (unsigned long long)(depth > 0 ? depth : 0), memory_order_relaxed);
+    atomic_fetch_add_explicit(&link->pushes, 1, memory_order_relaxed);
+    event_notify(p, &link->items);
+    return true;
+}
+
+// *item is NULL when the queue is empty; the result says whether it may still fill up
+static bool link_pop(Pipeline* p, PipelineStage stage, PipelineItem** item) {
+    PipelineLink* link = &p->links[stage];
+    // Read first: once producers are done, everything they pushed is visible to the pop
+    bool open = atomic_load_explicit(&link->producers, memory_order_acquire) > 0;
+    void* data;
+    if (mpmc_queue_pop(link->queue, &data)) {
+        atomic_fetch_sub_explicit(&link->depth, 1, memory_order_relaxed);
+        event_notify(p, &link->room);
+        *item = data;
+        return true;
+    }
+    *item = NULL;
+    return open;
+}
+
+// Hands worker->pending to the next stage; false while that stage has no room
+static bool flush_pending(Pipeline* p, PipelineWorker* worker) {
+    if (!worker->pending) return true;
+    if (pipeline_failed(p)) {
+        item_destroy(worker->pending);
+        worker->pending = NULL;
+        return true;
+    }
+    if (!link_push(p, worker->stage + 1, worker->pending)) return false;
+    atomic_fetch_add_explicit(&p->counters[worker->stage].items, 1, memory_order_relaxed);
+    worker->pending = NULL;
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Enumerate
+// ---------------------------------------------------------------------------
+
+static bool add_directory(Pipeline* p, const char* path) {
+    char* copy = strdup(path);
+    if (!copy) return false;
+
+    pthread_mutex_lock(&p->directory_mutex);
+    if (p->directory_count >= p->directory_capacity) {
+        size_t capacity = p->directory_capacity ? p->directory_capacity * 2 : 64;
+        char** grown = realloc(p->directories, capacity * sizeof(char*));
+        if (!grown) {
+            pthread_mutex_unlock(&p->directory_mutex);
+            free(copy);
+            return false;
+        }
+        p->directories = grown;
+        p->directory_capacity = capacity;
+    }
+    p->directories[p->directory_count++] = copy;
+    pthread_mutex_unlock(&p->directory_mutex);
+    event_notify(p, &p->directory_event);
+    return true;
+}
+
+// NULL with *more set while another worker lists a directory (which could add more)
+static char* next_directory(Pipeline* p, bool* more) {
+    pthread_mutex_lock(&p->directory_mutex);
+    char* directory = NULL;
+    bool failed = pipeline_failed(p);
+    if (p->directory_count > 0 && !failed) {
+        directory = p->directories[--p->directory_count];
+        p->directories_active++;
+    }
+    *more = !failed && p->directories_active > 0;
+    pthread_mutex_unlock(&p->directory_mutex);
+    return directory;
+}
+
+static void close_directory(Pipeline* p, PipelineWorker* worker) {
+    if (!worker->directory) return;
+    if (worker->dir) closedir(worker->dir);
+    free(worker->directory);
+    worker->dir = NULL;
+    worker->directory = NULL;
+
+    pthread_mutex_lock(&p->directory_mutex);
+    p->directories_active--;
+    pthread_mutex_unlock(&p->directory_mutex);
+    event_notify(p, &p->directory_event);
+}
+
+static void enumerate_file(Pipeline* p, PipelineWorker* worker, const char* path) {
+    // Files the path classifies but no parser handles never reach the reader
+    Language language = language_classify(path, NULL, 0);
+    if (language != LANG_UNKNOWN && !deptrack_has_parser(language, path)) {
+        atomic_fetch_add_explicit(&p->skipped, 1, memory_order_relaxed);
+        return;
+    }
+
+    PipelineItem* item = calloc(1, sizeof(PipelineItem));
+    if (!item || !(item->path = strdup(path))) {
+        free(item);
+        pipeline_fail(p, DEPTRACK_ERROR_MEMORY);
+        return;
+    }
+    item->language = language;
+    worker->pending = item;
+}
+
+static void enumerate_entry(Pipeline* p, PipelineWorker* worker, const struct dirent* entry) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+        return;
+    }
+    char path[MAX_PATH_LENGTH];
+    size_t length = strlen(worker->directory);
+    size_t name_length = strlen(entry->d_name);
+    if (length + 1 + name_length >= MAX_PATH_LENGTH) {
+        return;
+    }
+    memcpy(path, worker->directory, length);
+    path[length] = '/';
+    memcpy(path + length + 1, entry->d_name, name_length + 1);
+
+    bool is_dir = false;
+    bool is_file = false;
+#ifdef _DIRENT_HAVE_D_TYPE
+    if (entry->d_type == DT_DIR) {
+        is_dir = true;
+    } else if (entry->d_type == DT_REG) {
+        is_file = true;
+    } else if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK)
+#endif
+    {
+        struct stat st;
+        if (stat(path, &st) == 0) {
+            is_dir = S_ISDIR(st.st_mode);
+            is_file = S_ISREG(st.st_mode);
+        }
+    }
+
+    if (is_dir) {
+        if (!file_is_skipped_directory(entry->d_name) && !add_directory(p, path)) {
+            pipeline_fail(p, DEPTRACK_ERROR_MEMORY);
+        }
+    } else if (is_file) {
+        enumerate_file(p, worker, path);
+    }
+}
+
+static StepResult step_enumerate(Pipeline* p, PipelineWorker* worker) {
+    for (size_t n = 0; n < PIPELINE_BATCH; n++) {
+        if (!flush_pending(p, worker)) return STEP_BLOCKED;
+        if (pipeline_failed(p)) {
+            close_directory(p, worker);
+            return STEP_DONE;
+        }
+        if (!worker->directory) {
+            bool more;
+            worker->directory = next_directory(p, &more);
+            if (!worker->directory) return more ? STEP_STARVED : STEP_DONE;
+            worker->dir = opendir(worker->directory);
+            if (!worker->dir) {
+                close_directory(p, worker);   // Unreadable directories are skipped, as file_walk does
+                continue;
+            }
+        }
+        struct dirent* entry = readdir(worker->dir);
+        if (!entry) {
+            close_directory(p, worker);
+            continue;
+        }
+        enumerate_entry(p, worker, entry);
+    }
+    return flush_pending(p, worker) ? STEP_YIELD : STEP_BLOCKED;
+}
+
+// ---------------------------------------------------------------------------
+// Read, parse, merge
+// ---------------------------------------------------------------------------
+
+static Language sniff_language(const char* path) {
+    char head[PIPELINE_SNIFF_LENGTH];
+    FILE* file = fopen(path, "rb");
+    if (!file) return LANG_UNKNOWN;
+    size_t length = fread(head, 1, sizeof(head), file);
+    fclose(file);
+    return language_classify(path, head, length);
+}
+
+static PipelineItem* read_item(Pipeline* p, PipelineItem* item) {
+    if (item->language == LANG_UNKNOWN) {
+        item->language = sniff_language(item->path);
+        if (!deptrack_has_parser(item->language, item->path)) {
+            atomic_fetch_add_explicit(&p->skipped, 1, memory_order_relaxed);
+            item_destroy(item);
+            return NULL;
+        }
+    }
+
+    // Streaming parsers read the file themselves, in chunks
+    if (deptrack_parser_streams(item->language)) {
+        return item;
+    }
+    item->buffer = parser_read_file(item->path, &item->length);
+    if (!item->buffer) {
+        atomic_fetch_add_explicit(&p->failed_files, 1, memory_order_relaxed);
+        item_destroy(item);
+        return NULL;
+    }
+    return item;
+}
+
+static bool is_relative_path(const char* name) {
+    return strcmp(name, ".") == 0 || strcmp(name, "..") == 0 || strncmp(name, "./", 2) == 0 ||
+           strncmp(name, "../", 3) == 0;
+}
+
+// Graph id of a dependency name, written to out, or false to keep the name as it is. Paths relative to
+// the file are joined to its directory, so "./util" from two directories stays two nodes; absolute paths
+// under the root lose the root. Shell and CI paths are relative to the repository root already, which is
+// where scripts and jobs run; a C quoted include resolves next to the file only when the header is there,
+// as the compiler's first lookup does; make runs recipes in the Makefile's directory.
+static bool dependency_id(const Pipeline* p, const ParsedFile* parsed, const Dependency* dep, char* out,
+                          size_t size) {
+    const char* source = parsed->filepath;
+    const char* name = dep->name;
+    if (name[0] == '/') {
+        // The source's path starts with the root, so its first root_length bytes are the root
+        if (strncmp(name, source, p->root_length) != 0 || name[p->root_length] != '/') return false;
+        snprintf(out, size, "%s", name + p->root_length + 1);
+        file_normalize_path(out);
+        return true;
+    }
+
+    bool relative;
+    switch (parsed->language) {
+        case LANG_SHELL:
+            relative = false;
+            break;
+        case LANG_YAML:
+            relative = !ci_is_workflow(source) && is_relative_path(name);
+            break;
+        case LANG_MAKE:
+            relative = true;
+            break;
+        case LANG_C: {
+            struct stat st;
+            const char* slash = strrchr(source, '/');
+            int dir_length = slash ? (int)(slash - source) : 0;
+            relative = dep->type == DEP_INTERNAL &&
+                       snprintf(out, size, "%.*s/%s", dir_length, source, name) < (int)size &&
+                       stat(out, &st) == 0 && S_ISREG(st.st_mode);
+            break;
+        }
+        default:
+            relative = is_relative_path(name);
+            break;
+    }
+    if (!relative) return false;
+
+    const char* id = source + p->root_length;
+    while (*id == '/') id++;
+    const char* slash = strrchr(id, '/');
+    int dir_length = slash ? (int)(slash - id) : 0;
+    if (snprintf(out, size, "%.*s%s%s", dir_length, id, dir_length ? "/" : "", name) >= (int)size) return false;
+    file_normalize_path(out);
+    return true;
+}
+
+static bool resolve_dependency_ids(const Pipeline* p, ParsedFile* parsed) {
+    char id[MAX_PATH_LENGTH];
+    for (size_t i = 0; i < parsed->dep_count; i++) {
+        Dependency* dep = &parsed->dependencies[i];
+        if (!dep->name || !dependency_id(p, parsed, dep, id, sizeof(id)) || strcmp(id, dep->name) == 0) continue;
+        char* copy = strdup(id);
+        if (!copy) return false;
+        free(dep->name);
+        dep->name = copy;
+    }
+    return true;
+}
+
+static PipelineItem* parse_item(Pipeline* p, PipelineItem* item) {
+    item->parsed = item->buffer ? deptrack_parse_buffer(p->tracker, item->path, item->language, item->buffer,
+                                                        item->length)
+                                : deptrack_parse_file(p->tracker, item->path, item->language);
+    free(item->buffer);
+    item->buffer = NULL;
+    if (!item->parsed) {
+        atomic_fetch_add_explicit(&p->failed_files, 1, memory_order_relaxed);
+        item_destroy(item);
+        return NULL;
+    }
+    // Off the single merge thread: parse workers run in parallel, and the C rule needs a stat
+    if (!resolve_dependency_ids(p, item->parsed)) {
+        pipeline_fail(p, DEPTRACK_ERROR_MEMORY);
+        item_destroy(item);
+        return NULL;
+    }
+    return item;
+}
+
+// Targets are ids the parse stage resolved, so the bulk add finds ones already in the graph, which is how
+// shared dependencies are found
+static PipelineItem* merge_item(Pipeline* p, PipelineItem* item) {
+    const char* id = item->parsed->filepath + p->root_length;
+    while (*id == '/') id++;
+    int result = deptrack_merge_parsed_file(p->tracker, item->parsed, id);
+    if (result != DEPTRACK_SUCCESS) {
+        pipeline_fail(p, result);
+    } else {
+        atomic_fetch_add_explicit(&p->counters[PIPELINE_MERGE].items, 1, memory_order_relaxed);
+    }
+    item_destroy(item);
+    return NULL;
+}
+
+static StepResult step_queue(Pipeline* p, PipelineWorker* worker) {
+    for (size_t n = 0; n < PIPELINE_BATCH; n++) {
+        if (!flush_pending(p, worker)) return STEP_BLOCKED;
+
+        PipelineItem* item;
+        bool open = link_pop(p, worker->stage, &item);
+        if (!item) return open ? STEP_STARVED : STEP_DONE;
+        if (pipeline_failed(p)) {
+            item_destroy(item);
+            continue;
+        }
+        switch (worker->stage) {
+            case PIPELINE_READ: worker->pending = read_item(p, item); break;
+            case PIPELINE_PARSE: worker->pending = parse_item(p, item); break;
+            default: worker->pending = merge_item(p, item); break;
+        }
+    }
+    return flush_pending(p, worker) ? STEP_YIELD : STEP_BLOCKED;
+}
+
+static void finish_worker(Pipeline* p, PipelineWorker* worker) {
+    close_directory(p, worker);
+    item_destroy(worker->pending);
+    worker->pending = NULL;
+
+    // The last worker of a stage closes the queue after it
+    if (worker->stage + 1 < PIPELINE_STAGE_COUNT) {
+        atomic_fetch_sub_explicit(&p->links[worker->stage + 1].producers, 1, memory_order_release);
+        event_notify(p, &p->links[worker->stage + 1].items);
+    }
+
+    PipelineCounters* counters = &p->counters[worker->stage];
+    atomic_fetch_add(&counters->busy_ns, worker->busy_ns);
+    atomic_fetch_add(&counters->input_stall_ns, worker->input_stall_ns);
+    atomic_fetch_add(&counters->output_stall_ns, worker->output_stall_ns);
+}
+
+static StepResult step(Pipeline* p, PipelineWorker* worker) {
+    return worker->stage == PIPELINE_ENUMERATE ? step_enumerate(p, worker) : step_queue(p, worker);
+}
+
+static void stage_task(void* arg) {
+    PipelineWorker* worker = arg;
+    Pipeline* p = worker->pipeline;
+    // Read before the step looks for work, so whatever it misses shows up as a newer epoch
+    PipelineEvent* input = worker->stage == PIPELINE_ENUMERATE ? &p->directory_event : &p->links[worker->stage].items;
+    PipelineEvent* output = worker->stage + 1 < PIPELINE_STAGE_COUNT ? &p->links[worker->stage + 1].room : NULL;
+    unsigned input_key = event_prepare(input);
+    unsigned output_key = output ? event_prepare(output) : 0;
+    uint64_t start = now_ns();
+    if (worker->stall_start) {
+        uint64_t stalled = start - worker->stall_start;
+        if (worker->stalled_on == STEP_STARVED) {
+            worker->input_stall_ns += stalled;
+        } else {
+            worker->output_stall_ns += stalled;
+        }
+        worker->stall_start = 0;
+    }
+
+    StepResult result = step(p, worker);
+    uint64_t end = now_ns();
+    worker->busy_ns += end - start;
+    if (result == STEP_DONE) {
+        finish_worker(p, worker);
+        return;
+    }
+
+    if (result != STEP_YIELD) {
+        worker->stall_start = end;
+        worker->stalled_on = result;
+        // Parked, the worker costs nothing until the queue it waits on changes
+        bool parked = result == STEP_STARVED ? event_park(p, input, input_key, worker)
+                                             : event_park(p, output, output_key, worker);
+        if (parked) return;
+    }
+    resume(p, worker);
+}
+
+// ---------------------------------------------------------------------------
+// Run
+// ---------------------------------------------------------------------------
+
+static void pipeline_release(Pipeline* p) {
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+        MpmcQueue* queue = p->links[s].queue;
+        void* data;
+        while (queue && mpmc_queue_pop(queue, &data)) item_destroy(data);
+        mpmc_queue_destroy(queue);
+    }
+    for (size_t i = 0; i < p->directory_count; i++) free(p->directories[i]);
+    free(p->directories);
+    pthread_mutex_destroy(&p->directory_mutex);
+    pthread_mutex_destroy(&p->park_mutex);
+}
+
+int pipeline_run(DependencyTracker* tracker, const char* root, const PipelineConfig* config,
+                 PipelineMetrics* metrics) {
+    if (!tracker || !root || !tracker->graph) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    char trimmed[MAX_PATH_LENGTH];
+    if (snprintf(trimmed, sizeof(trimmed), "%s", root) >= (int)sizeof(trimmed)) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+    size_t root_length = strlen(trimmed);
+    while (root_length > 1 && trimmed[root_length - 1] == '/') trimmed[--root_length] = '\0';
+
+    struct stat st;
+    if (stat(trimmed, &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return DEPTRACK_ERROR_FILE_NOT_FOUND;
+    }
+
+    ThreadPool* pool = deptrack_thread_pool(tracker);
+    if (!pool) {
+        return DEPTRACK_ERROR_THREAD;
+    }
+
+    PipelineConfig effective;
+    pipeline_config_default(&effective);
+    for (size_t s = 0; config && s < PIPELINE_STAGE_COUNT; s++) {
+        if (config->threads[s] > PIPELINE_MAX_STAGE_THREADS) return DEPTRACK_ERROR_INVALID_PARAM;
+        if (config->threads[s] > 0) effective.threads[s] = config->threads[s];
+    }
+    if (config && config->queue_capacity > PIPELINE_MAX_QUEUE_CAPACITY) return DEPTRACK_ERROR_INVALID_PARAM;
+    if (config && config->queue_capacity > 0) effective.queue_capacity = config->queue_capacity;
+    if (effective.threads[PIPELINE_PARSE] == 0) effective.threads[PIPELINE_PARSE] = thread_pool_size(pool);
+
+    // Each count is bounded, but the pool size is not; the sum is checked before it sizes the worker array
+    size_t worker_total = 0;
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+        if (effective.threads[s] > SIZE_MAX / sizeof(PipelineWorker) - worker_total) {
+            return DEPTRACK_ERROR_INVALID_PARAM;
+        }
+        worker_total += effective.threads[s];
+    }
+
+    Pipeline p;
+    memset(&p, 0, sizeof(p));
+    p.tracker = tracker;
+    p.root_length = root_length;
+    atomic_init(&p.error, DEPTRACK_SUCCESS);
+    atomic_init(&p.skipped, 0);
+    atomic_init(&p.failed_files, 0);
+    atomic_init(&p.directory_event.epoch, 0);
+    atomic_init(&p.directory_event.parked_count, 0);
+    if (pthread_mutex_init(&p.directory_mutex, NULL) != 0) {
+        return DEPTRACK_ERROR_THREAD;
+    }
+    if (pthread_mutex_init(&p.park_mutex, NULL) != 0) {
+        pthread_mutex_destroy(&p.directory_mutex);
+        return DEPTRACK_ERROR_THREAD;
+    }
+
+    int result = DEPTRACK_SUCCESS;
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+        PipelineCounters* counters = &p.counters[s];
+        atomic_init(&counters->items, 0);
+        atomic_init(&counters->busy_ns, 0);
+        atomic_init(&counters->input_stall_ns, 0);
+        atomic_init(&counters->output_stall_ns, 0);
+        PipelineLink* link = &p.links[s];
+        atomic_init(&link->producers, s > 0 ? effective.threads[s - 1] : 0);
+        atomic_init(&link->items.epoch, 0);
+        atomic_init(&link->items.parked_count, 0);
+        atomic_init(&link->room.epoch, 0);
+        atomic_init(&link->room.parked_count, 0);
+        atomic_init(&link->depth, 0);
+        atomic_init(&link->max_depth, 0);
+        atomic_init(&link->depth_sum, 0);
+        atomic_init(&link->pushes, 0);
+        if (s > 0 && !(link->queue = mpmc_queue_create(effective.queue_capacity))) {
+            result = DEPTRACK_ERROR_MEMORY;
+        }
+    }
+
+    PipelineWorker* workers = calloc(worker_total, sizeof(PipelineWorker));
+    p.group = task_group_create(pool);
+    if (result == DEPTRACK_SUCCESS && (!workers || !p.group || !add_directory(&p, trimmed))) {
+        result = DEPTRACK_ERROR_MEMORY;
+    }
+    if (result != DEPTRACK_SUCCESS) {
+        free(workers);
+        task_group_destroy(p.group);
+        pipeline_release(&p);
+        return result;
+    }
+
+    // Deferred tasks start in queue order, so upstream stages get the pool first
+    uint64_t start = now_ns();
+    size_t spawned = 0;
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+        for (size_t t = 0; t < effective.threads[s]; t++) {
+            PipelineWorker* worker = &workers[spawned];
+            worker->pipeline = &p;
+            worker->stage = (PipelineStage)s;
+            if (task_group_defer(p.group, stage_task, worker) != DEPTRACK_SUCCESS) {
+                // Workers that never run cannot close their output queue; failing makes everyone drain
+                if (s + 1 < PIPELINE_STAGE_COUNT) {
+                    atomic_fetch_sub(&p.links[s + 1].producers, effective.threads[s] - t);
+                }
+                pipeline_fail(&p, DEPTRACK_ERROR_MEMORY);
+                break;
+            }
+            spawned++;
+        }
+    }
+    task_group_wait(p.group);
+
+    // Workers the pool could not take back drain here, upstream stages first so every input closes
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+        for (PipelineWorker* worker = p.orphans; worker; worker = worker->next_parked) {
+            if (worker->stage != (PipelineStage)s) continue;
+            while (step(&p, worker) != STEP_DONE) {
+            }
+            finish_worker(&p, worker);
+        }
+    }
+    task_group_destroy(p.group);
+
+    if (metrics) {
+        memset(metrics, 0, sizeof(*metrics));
+        for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+            PipelineStageMetrics* m = &metrics->stages[s];
+            const PipelineLink* link = &p.links[s];
+            unsigned long long pushes = atomic_load(&link->pushes);
+            m->threads = effective.threads[s];
+            m->items = atomic_load(&p.counters[s].items);
+            m->queue_capacity = mpmc_queue_capacity(link->queue);
+            m->max_queue_depth = (size_t)atomic_load(&link->max_depth);
+            m->mean_queue_depth = pushes ? (double)atomic_load(&link->depth_sum) / (double)pushes : 0.0;
+            m->busy_ns = atomic_load(&p.counters[s].busy_ns);
+            m->input_stall_ns = atomic_load(&p.counters[s].input_stall_ns);
+            m->output_stall_ns = atomic_load(&p.counters[s].output_stall_ns);
+        }
+        metrics->files_skipped = atomic_load(&p.skipped);
+        metrics->files_failed = atomic_load(&p.failed_files);
+        metrics->elapsed_ns = now_ns() - start;
+    }
+
+    result = atomic_load(&p.error);
+    free(workers);
+    pipeline_release(&p);
+    return result;
+}
@@ -0,0 +1,545 @@
+/**
+ * @file thread_pool.c
+ * @brief Work-stealing thread pool shared by directory analysis, graph algorithms and output
+ * @author Unhinged Development Team
+ *
+ * @llm-type service
+ * @llm-legend One set of worker threads per tracker; everything parallel in the tracker runs on it as tasks
+ *             instead of starting threads of its own
+ * @llm-key Every worker owns a Chase-Lev deque: it pushes and pops at the bottom without contention, thieves
+ *          take the oldest task from the top with one CAS. Tasks spawned from outside the pool, or deferred
+ *          on purpose, go to a FIFO injection queue that every worker drains after its own deque
+ * @llm-map Task groups count their outstanding tasks; waiting on a group runs pool tasks on the waiting thread
+ *          until the count reaches zero, so nested waits cannot deadlock; with nothing to run, the waiter sleeps
+ *          with the idle workers until new work arrives or its group's last task ends. Parallel-for splits its
+ *          range in halves, spawning the upper half each time, so thieves always take the largest piece left
+ * @llm-contract Cancelling a group drops its tasks that have not started; running tasks poll
+ *               task_group_cancelled. Deque arrays replaced by growth are freed with the pool, since a
+ *               thief may still be reading one
+ */
+
+#include "dependency_tracker.h"
+#include <stdatomic.h>
+#include <unistd.h>
+
+#define DEQUE_INITIAL_CAPACITY 64
+#define POOL_CACHE_LINE 64
+#define POOL_STEAL_ATTEMPTS 2
+#define POOL_GRAIN_PER_WORKER 8
+
+// Marks a steal that lost its race; the deque may still hold work. No item can share its address
+static char steal_abort;
+#define STEAL_ABORT ((void*)&steal_abort)
+
+// ---------------------------------------------------------------------------
+// Chase-Lev deque (Le, Pop, Cohen, Nardelli: "Correct and Efficient Work-Stealing for Weak Memory Models")
+// ---------------------------------------------------------------------------
+
+typedef struct DequeArray {
+    size_t capacity;               // Power of two
+    struct DequeArray* retired;    // Previous array, freed with the deque
+    _Atomic(void*) slots[];
+} DequeArray;
+
+struct WorkDeque {
+    _Alignas(POOL_CACHE_LINE) atomic_long top;
+    _Alignas(POOL_CACHE_LINE) atomic_long bottom;
+    _Atomic(DequeArray*) array;
+};
+
+static DequeArray* deque_array_create(size_t capacity) {
+    DequeArray* array = malloc(sizeof(DequeArray) + capacity * sizeof(_Atomic(void*)));
+    if (!array) return NULL;
+    array->capacity = capacity;
+    array->retired = NULL;
+    for (size_t i = 0; i < capacity; i++) {
+        atomic_init(&array->slots[i], NULL);
+    }
+    return array;
+}
+
+WorkDeque* work_deque_create(void) {
+    WorkDeque* deque = aligned_alloc(POOL_CACHE_LINE, sizeof(WorkDeque));
+    if (!deque) return NULL;
+    DequeArray* array = deque_array_create(DEQUE_INITIAL_CAPACITY);
+    if (!array) {
+        free(deque);
+        return NULL;
+    }
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->array, array);
+    return deque;
+}
+
+void work_deque_destroy(WorkDeque* deque) {
+    if (!deque) return;
+    DequeArray* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    while (array) {
+        DequeArray* retired = array->retired;
+        free(array);
+        array = retired;
+    }
+    free(deque);
+}
+
+bool work_deque_push(WorkDeque* deque, void* item) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    DequeArray* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    if ((size_t)(bottom - top) >= array->capacity) {
+        DequeArray* grown = deque_array_create(array->capacity * 2);
+        if (!grown) return false;
+        for (long i = top; i < bottom; i++) {
+            void* moved = atomic_load_explicit(&array->slots[(size_t)i & (array->capacity - 1)],
+                                               memory_order_relaxed);
+            atomic_store_explicit(&grown->slots[(size_t)i & (grown->capacity - 1)], moved, memory_order_relaxed);
+        }
+        grown->retired = array;
+        atomic_store_explicit(&deque->array, grown, memory_order_release);
+        array = grown;
+    }
+    atomic_store_explicit(&array->slots[(size_t)bottom & (array->capacity - 1)], item, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    return true;
+}
+
+void* work_deque_pop(WorkDeque* deque) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed) - 1;
+    DequeArray* array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+    atomic_store_explicit(&deque->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+
+    if (top > bottom) {
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+        return NULL;
+    }
+    void* item = atomic_load_explicit(&array->slots[(size_t)bottom & (array->capacity - 1)], memory_order_relaxed);
+    if (top == bottom) {
+        // Last item: race the thieves for it
+        if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed)) {
+            item = NULL;
+        }
+        atomic_store_explicit(&deque->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return item;
+}
+
+// NULL when empty, STEAL_ABORT when another thread won the race for the top item
+static void* deque_steal(WorkDeque* deque) {
+    long top = atomic_load_explicit(&deque->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    if (top >= bottom) return NULL;
+
+    DequeArray* array = atomic_load_explicit(&deque->array, memory_order_acquire);
+    void* item = atomic_load_explicit(&array->slots[(size_t)top & (array->capacity - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&deque->top, &top, top + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed)) {
+        return STEAL_ABORT;
+    }
+    return item;
+}
+
+void* work_deque_steal(WorkDeque* deque) {
+    void* item;
+    while ((item = deque_steal(deque)) == STEAL_ABORT) {
+    }
+    return item;
+}
+
+size_t work_deque_size(const WorkDeque* deque) {
+    long bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+    long top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    return bottom > top ? (size_t)(bottom - top) : 0;
+}
+
+// ---------------------------------------------------------------------------
+// Pool
+// ---------------------------------------------------------------------------
+
+typedef struct Task {
+    TaskFunction function;
+    void* arg;
+    TaskGroup* group;
+    struct Task* next;         // Injection queue link
+} Task;
+
+typedef struct {
+    ThreadPool* pool;
+    WorkDeque* deque;
+    pthread_t thread;
+    unsigned seed;             // Victim selection
+} Worker;
+
+struct ThreadPool {
+    Worker* workers;
+    size_t worker_count;
+    size_t started;
+
+    // Injection queue: tasks from outside the pool and deferred ones, oldest first
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    Task* inject_head;
+    Task* inject_tail;
+    atomic_size_t injected;
+
+    atomic_long pending;       // Queued and not yet taken; may dip below zero while a push is in flight
+    atomic_size_t sleeping;
+    atomic_bool shutdown;
+};
+
+struct TaskGroup {
+    ThreadPool* pool;
+    atomic_size_t outstanding;
+    atomic_bool cancelled;
+};
+
+static _Thread_local Worker* current_worker;
+
+static Worker* worker_of(ThreadPool* pool) {
+    return current_worker && current_worker->pool == pool ? current_worker : NULL;
+}
+
+static void wake_one(ThreadPool* pool) {
+    // Sleepers announce themselves before rechecking pending, so one side always sees the other
+    if (atomic_load(&pool->sleeping) > 0) {
+        pthread_mutex_lock(&pool->mutex);
+        pthread_cond_signal(&pool->wake);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+static void inject(ThreadPool* pool, Task* task) {
+    task->next = NULL;
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->inject_tail) {
+        pool->inject_tail->next = task;
+    } else {
+        pool->inject_head = task;
+    }
+    pool->inject_tail = task;
+    atomic_fetch_add_explicit(&pool->injected, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static Task* take_injected(ThreadPool* pool) {
+    if (atomic_load_explicit(&pool->injected, memory_order_relaxed) == 0) return NULL;
+
+    pthread_mutex_lock(&pool->mutex);
+    Task* task = pool->inject_head;
+    if (task) {
+        pool->inject_head = task->next;
+        if (!pool->inject_head) pool->inject_tail = NULL;
+        atomic_fetch_sub_explicit(&pool->injected, 1, memory_order_relaxed);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+    return task;
+}
+
+// Own deque, then the injection queue, then the other workers' deques from a random start
+static Task* find_task(ThreadPool* pool, Worker* self) {
+    Task* task = self ? work_deque_pop(self->deque) : NULL;
+    if (!task) task = take_injected(pool);
+
+    // Every deque exists before the first thread starts, so all of them can be tried
+    size_t count = pool->worker_count;
+    if (!task) {
+        size_t start = self ? (size_t)rand_r(&self->seed) % count : 0;
+        for (size_t attempt = 0; attempt < POOL_STEAL_ATTEMPTS && !task; attempt++) {
+            for (size_t i = 0; i < count && !task; i++) {
+                Worker* victim = &pool->workers[(start + i) % count];
+                if (victim == self) continue;
+                void* stolen = deque_steal(victim->deque);
+                if (stolen != STEAL_ABORT) task = stolen;
+            }
+        }
+    }
+    if (task) atomic_fetch_sub(&pool->pending, 1);
+    return task;
+}
+
+static void run_task(Task* task) {
+    TaskGroup* group = task->group;
+    ThreadPool* pool = group->pool;   // The group may be gone once its count reaches zero
+    if (!atomic_load_explicit(&group->cancelled, memory_order_relaxed)) {
+        task->function(task->arg);
+    }
+    free(task);
+    // A waiter sleeps with the workers; as in wake_one, it counts itself before rechecking outstanding
+    if (atomic_fetch_sub(&group->outstanding, 1) == 1 && atomic_load(&pool->sleeping) > 0) {
+        pthread_mutex_lock(&pool->mutex);
+        pthread_cond_broadcast(&pool->wake);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+static void* worker_main(void* arg) {
+    Worker* self = arg;
+    ThreadPool* pool = self->pool;
+    current_worker = self;
+
+    while (!atomic_load(&pool->shutdown)) {
+        Task* task = find_task(pool, self);
+        if (task) {
+            run_task(task);
+            continue;
+        }
+        pthread_mutex_lock(&pool->mutex);
+        atomic_fetch_add(&pool->sleeping, 1);
+        while (atomic_load(&pool->pending) <= 0 && !atomic_load(&pool->shutdown)) {
+            pthread_cond_wait(&pool->wake, &pool->mutex);
+        }
+        atomic_fetch_sub(&pool->sleeping, 1);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    current_worker = NULL;
+    return NULL;
+}
+
+ThreadPool* thread_pool_create(size_t workers) {
+    if (workers == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cpus > 0 ? (size_t)cpus : 1;
+    }
+
+    ThreadPool* pool = calloc(1, sizeof(ThreadPool));
+    if (!pool) return NULL;
+    pool->workers = calloc(workers, sizeof(Worker));
+    if (!pool->workers) {
+        free(pool);
+        return NULL;
+    }
+    pool->worker_count = workers;
+    atomic_init(&pool->injected, 0);
+    atomic_init(&pool->pending, 0);
+    atomic_init(&pool->sleeping, 0);
+    atomic_init(&pool->shutdown, false);
+    if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+    if (pthread_cond_init(&pool->wake, NULL) != 0) {
+        pthread_mutex_destroy(&pool->mutex);
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+
+    // Deques exist before any thread starts, since every worker steals from all of them
+    for (size_t i = 0; i < workers; i++) {
+        Worker* worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->seed = (unsigned)(i * 2654435761u + 1);
+        if (!(worker->deque = work_deque_create())) {
+            pool->started = i;
+            thread_pool_destroy(pool);
+            return NULL;
+        }
+    }
+    for (size_t i = 0; i < workers; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]) != 0) {
+            break;
+        }
+        pool->started++;
+    }
+    if (pool->started == 0) {
+        thread_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void thread_pool_destroy(ThreadPool* pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    atomic_store(&pool->shutdown, true);
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->mutex);
+    for (size_t i = 0; i < pool->started; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    // Groups are waited on before the pool goes away, so whatever is left was never spawned into one
+    for (size_t i = 0; i < pool->worker_count; i++) {
+        work_deque_destroy(pool->workers[i].deque);
+    }
+    Task* task = pool->inject_head;
+    while (task) {
+        Task* next = task->next;
+        free(task);
+        task = next;
+    }
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->workers);
+    free(pool);
+}
+
+size_t thread_pool_size(const ThreadPool* pool) {
+    return pool ? pool->started : 0;
+}
+
+bool thread_pool_in_worker(const ThreadPool* pool) {
+    return worker_of((ThreadPool*)pool) != NULL;
+}
+
+// ---------------------------------------------------------------------------
+// Task groups
+// ---------------------------------------------------------------------------
+
+TaskGroup* task_group_create(ThreadPool* pool) {
+    if (!pool) return NULL;
+    TaskGroup* group = malloc(sizeof(TaskGroup));
+    if (!group) return NULL;
+    group->pool = pool;
+    atomic_init(&group->outstanding, 0);
+    atomic_init(&group->cancelled, false);
+    return group;
+}
+
+void task_group_destroy(TaskGroup* group) {
+    if (!group) return;
+    task_group_wait(group);
+    free(group);
+}
+
+static int spawn(TaskGroup* group, TaskFunction function, void* arg, bool defer) {
+    if (!group || !function) return DEPTRACK_ERROR_INVALID_PARAM;
+    if (atomic_load_explicit(&group->cancelled, memory_order_relaxed)) return DEPTRACK_ERROR_CANCELLED;
+
+    ThreadPool* pool = group->pool;
+    Task* task = malloc(sizeof(Task));
+    if (!task) return DEPTRACK_ERROR_MEMORY;
+    task->function = function;
+    task->arg = arg;
+    task->group = group;
+
+    atomic_fetch_add_explicit(&group->outstanding, 1, memory_order_relaxed);
+    Worker* self = worker_of(pool);
+    if (defer || !self || !work_deque_push(self->deque, task)) {
+        inject(pool, task);
+    }
+    atomic_fetch_add(&pool->pending, 1);
+    wake_one(pool);
+    return DEPTRACK_SUCCESS;
+}
+
+int task_group_spawn(TaskGroup* group, TaskFunction function, void* arg) {
+    return spawn(group, function, arg, false);
+}
+
+int task_group_defer(TaskGroup* group, TaskFunction function, void* arg) {
+    return spawn(group, function, arg, true);
+}
+
+void task_group_cancel(TaskGroup* group) {
+    if (group) atomic_store(&group->cancelled, true);
+}
+
+bool task_group_cancelled(const TaskGroup* group) {
+    return group && atomic_load_explicit(&group->cancelled, memory_order_relaxed);
+}
+
+int task_group_wait(TaskGroup* group) {
+    if (!group) return DEPTRACK_ERROR_INVALID_PARAM;
+
+    ThreadPool* pool = group->pool;
+    Worker* self = worker_of(pool);
+    while (atomic_load_explicit(&group->outstanding, memory_order_acquire) > 0) {
+        // Help instead of blocking: the task we run may be the one we wait for, or one it waits for
+        Task* task = find_task(pool, self);
+        if (task) {
+            run_task(task);
+            continue;
+        }
+        // The rest are running elsewhere; sleep until one finishes the group or queues work we can help with
+        pthread_mutex_lock(&pool->mutex);
+        atomic_fetch_add(&pool->sleeping, 1);
+        while (atomic_load(&pool->pending) <= 0 && atomic_load(&group->outstanding) > 0) {
+            pthread_cond_wait(&pool->wake, &pool->mutex);
+        }
+        atomic_fetch_sub(&pool->sleeping, 1);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    return atomic_load(&group->cancelled) ? DEPTRACK_ERROR_CANCELLED : DEPTRACK_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Parallel-for
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    TaskGroup* group;
+    ParallelForFunction function;
+    void* context;
+    size_t grain;
+} ParallelFor;
+
+typedef struct {
+    ParallelFor* loop;
+    size_t begin;
+    size_t end;
+} ParallelRange;
+
+static void parallel_range_run(void* arg) {
+    ParallelRange* range = arg;
+    ParallelFor* loop = range->loop;
+    size_t begin = range->begin;
+    size_t end = range->end;
+    free(range);
+
+    while (end - begin > loop->grain && !task_group_cancelled(loop->group)) {
+        size_t middle = begin + (end - begin) / 2;
+        ParallelRange* upper = malloc(sizeof(ParallelRange));
+        if (!upper) break;   // Run the rest here
+        *upper = (ParallelRange){ loop, middle, end };
+        if (task_group_spawn(loop->group, parallel_range_run, upper) != DEPTRACK_SUCCESS) {
+            free(upper);
+            break;
+        }
+        end = middle;
+    }
+    if (!task_group_cancelled(loop->group)) {
+        loop->function(begin, end, loop->context);
+    }
+}
+
+int thread_pool_parallel_for(ThreadPool* pool, size_t begin, size_t end, size_t grain,
+                             ParallelForFunction function, void* context) {
+    if (!function || begin > end) return DEPTRACK_ERROR_INVALID_PARAM;
+    if (begin == end) return DEPTRACK_SUCCESS;
+
+    size_t count = end - begin;
+    if (grain == 0) {
+        size_t pieces = thread_pool_size(pool) * POOL_GRAIN_PER_WORKER;
+        grain = pieces > 0 ? (count + pieces - 1) / pieces : count;
+    }
+    if (!pool || count <= grain) {
+        function(begin, end, context);
+        return DEPTRACK_SUCCESS;
+    }
+
+    TaskGroup* group = task_group_create(pool);
+    ParallelRange* range = malloc(sizeof(ParallelRange));
+    if (!group || !range) {
+        free(group);
+        free(range);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+    ParallelFor loop = { group, function, context, grain };
+    *range = (ParallelRange){ &loop, begin, end };
+
+    // The calling thread starts splitting; workers take the halves it spawns
+    parallel_range_run(range);
+
+    int result = task_group_wait(group);
+    free(group);
+    return result;
+}
@@ -25,6 +25,15 @@ typedef enum {
     CMD_VALIDATE,
     CMD_UPDATE,
     CMD_FEATURE_DAG,
+    CMD_WAVES,
+    CMD_PROTOS,
+    CMD_DEPFILE,
+    CMD_MAKE,
+    CMD_MIGRATIONS,
+    CMD_SCRIPTS,
+    CMD_CI,
+    CMD_IMAGES,
+    CMD_QUERY,
     CMD_HELP,
     CMD_VERSION,
     CMD_UNKNOWN
@@ -35,12 +44,27 @@ typedef struct {
     Command command;
     char* root_path;
     char* output_path;
+    char** inputs;             // Positional arguments after the command (not owned)
+    int input_count;
     OutputFormat output_format;
+    bool format_given;
     bool verbose;
     bool dry_run;
     bool strict;
+    PipelineConfig pipeline;   // Zero fields keep the pipeline defaults
+    size_t jobs;               // 0 keeps deptrack.json's value or one per CPU
+    bool compact;              // JSON output without indentation
+    char* snapshot_path;
 } CliOptions;
 
+// Long options without a short form
+enum {
+    OPT_STAGE_THREADS = 256,
+    OPT_QUEUE_SIZE,
+    OPT_COMPACT,
+    OPT_SNAPSHOT
+};
+
 static struct option long_options[] = {
     {"help", no_argument, 0, 'h'},
     {"version", no_argument, 0, 'V'},
@@ -50,6 +74,11 @@ static struct option long_options[] = {
     {"dry-run", no_argument, 0, 'n'},
     {"strict", no_argument, 0, 's'},
     {"root", required_argument, 0, 'r'},
+    {"jobs", required_argument, 0, 'j'},
+    {"stage-threads", required_argument, 0, OPT_STAGE_THREADS},
+    {"queue-size", required_argument, 0, OPT_QUEUE_SIZE},
+    {"compact", no_argument, 0, OPT_COMPACT},
+    {"snapshot", required_argument, 0, OPT_SNAPSHOT},
     {0, 0, 0, 0}
 };
 
@@ -63,6 +92,15 @@ void print_usage(const char* program_name) {
     printf("  validate     Validate dependency consistency\n");
     printf("  update       Check for available updates\n");
     printf("  feature-dag  Generate feature dependency DAG\n");
+    printf("  waves FILE   Compute parallel startup waves for a docker-compose file\n");
+    printf("  protos [CHANGED...]  Proto compile order under --root; stale files for a change\n");
+    printf("  depfile SOURCE...    Make .d rules for C/C++ sources, include paths from --root CMakeLists.txt\n");
+    printf("  make [CHANGED...]    Target graph of the --root Makefile; targets affected by a change\n");
+    printf("  migrations [DIR]     SQL migration apply order and forward references (default: --root)\n");
+    printf("  scripts [PATH...]    Scripts and Makefile targets that break if PATH moves\n");
+    printf("  ci [CHANGED...]      CI job waves and critical path; jobs a change requires\n");
+    printf("  images [CHANGED...]  Dockerfile stages, copied sources and packages; images a change rebuilds\n");
+    printf("  query [ID...]        Dependencies and dependents of nodes in an analyze --snapshot file\n");
     printf("  help         Show this help message\n");
     printf("  version      Show version information\n\n");
     
@@ -74,13 +112,30 @@ void print_usage(const char* program_name) {
     printf("  -f, --format FORMAT  Output format (json|dot|mermaid|html|markdown)\n");
     printf("  -n, --dry-run        Show what would be done without executing\n");
     printf("  -s, --strict         Enable strict validation mode\n");
-    printf("  -r, --root PATH      Root directory to analyze (default: current)\n\n");
+    printf("  -r, --root PATH      Root directory to analyze (default: current)\n");
+    printf("  -j, --jobs N         Worker threads shared by analysis, 1-%d (default: deptrack.json, else one per CPU)\n",
+           THREAD_POOL_MAX_WORKERS);
+    printf("      --stage-threads=E,R,P,M  analyze workers for enumerate, read, parse, merge (1-%d each;\n"
+           "                               unlisted stages keep their default)\n", PIPELINE_MAX_STAGE_THREADS);
+    printf("      --queue-size=N   analyze queue capacity between stages (1-%d)\n", PIPELINE_MAX_QUEUE_CAPACITY);
+    printf("      --compact        JSON output without indentation\n");
+    printf("      --snapshot=FILE  analyze writes, query reads a binary graph snapshot\n\n");
     
     printf("Examples:\n");
     printf("  %s analyze --root=/path/to/project --output=deps.json\n", program_name);
     printf("  %s graph --format=mermaid --output=deps.md\n", program_name);
     printf("  %s validate --strict\n", program_name);
     printf("  %s feature-dag --output=docs/architecture/\n", program_name);
+    printf("  %s waves build/orchestration/docker-compose.development.yml --format=json\n", program_name);
+    printf("  %s protos --root=proto proto/chat.proto\n", program_name);
+    printf("  %s depfile --root=. src/main.c --output=build/main.d\n", program_name);
+    printf("  %s make --root=. build/build.py --format=json\n", program_name);
+    printf("  %s migrations db/migrations --format=json\n", program_name);
+    printf("  %s scripts --root=. vm/build/profiles/dev.sh\n", program_name);
+    printf("  %s ci --root=. docs/README.md --format=json\n", program_name);
+    printf("  %s images --root=. build/requirements-core.txt\n", program_name);
+    printf("  %s analyze --root=. --snapshot=build/deps.snap && %s query --snapshot=build/deps.snap react\n",
+           program_name, program_name);
 }
 
 void print_version(void) {
@@ -98,6 +153,15 @@ Command parse_command(const char* cmd_str) {
     if (strcmp(cmd_str, "validate") == 0) return CMD_VALIDATE;
     if (strcmp(cmd_str, "update") == 0) return CMD_UPDATE;
     if (strcmp(cmd_str, "feature-dag") == 0) return CMD_FEATURE_DAG;
+    if (strcmp(cmd_str, "waves") == 0) return CMD_WAVES;
+    if (strcmp(cmd_str, "protos") == 0) return CMD_PROTOS;
+    if (strcmp(cmd_str, "depfile") == 0) return CMD_DEPFILE;
+    if (strcmp(cmd_str, "make") == 0) return CMD_MAKE;
+    if (strcmp(cmd_str, "migrations") == 0) return CMD_MIGRATIONS;
+    if (strcmp(cmd_str, "scripts") == 0) return CMD_SCRIPTS;
+    if (strcmp(cmd_str, "ci") == 0) return CMD_CI;
+    if (strcmp(cmd_str, "images") == 0) return CMD_IMAGES;
+    if (strcmp(cmd_str, "query") == 0) return CMD_QUERY;
     if (strcmp(cmd_str, "help") == 0) return CMD_HELP;
     if (strcmp(cmd_str, "version") == 0) return CMD_VERSION;
     
@@ -116,15 +180,51 @@ OutputFormat parse_output_format(const char* format_str) {
     return OUTPUT_JSON; // Default
 }
 
+// A decimal count in 1..max with nothing after it; signs and overflow are refused
+static bool parse_count(const char* text, size_t max, size_t* count) {
+    size_t value = 0;
+    const char* cursor = text;
+    while (*cursor >= '0' && *cursor <= '9' && value <= max) {
+        value = value * 10 + (size_t)(*cursor++ - '0');
+    }
+    if (cursor == text || *cursor != '\0' || value == 0 || value > max) return false;
+    *count = value;
+    return true;
+}
+
+// Comma-separated worker counts, one per stage in order; every count is 1..PIPELINE_MAX_STAGE_THREADS
+static bool parse_stage_threads(const char* text, size_t threads[PIPELINE_STAGE_COUNT]) {
+    const char* cursor = text;
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+        size_t value = 0;
+        const char* digits = cursor;
+        while (*cursor >= '0' && *cursor <= '9' && value <= PIPELINE_MAX_STAGE_THREADS) {
+            value = value * 10 + (size_t)(*cursor++ - '0');
+        }
+        if (cursor == digits || value == 0 || value > PIPELINE_MAX_STAGE_THREADS) return false;
+        threads[s] = value;
+        if (*cursor == '\0') return true;
+        if (*cursor++ != ',') return false;
+    }
+    return false;   // More counts than stages
+}
+
 int parse_options(int argc, char* argv[], CliOptions* options) {
     // Initialize defaults
     options->command = CMD_UNKNOWN;
     options->root_path = strdup(".");
     options->output_path = NULL;
+    options->inputs = NULL;
+    options->input_count = 0;
     options->output_format = OUTPUT_JSON;
+    options->format_given = false;
     options->verbose = false;
     options->dry_run = false;
     options->strict = false;
+    memset(&options->pipeline, 0, sizeof(options->pipeline));
+    options->jobs = 0;
+    options->compact = false;
+    options->snapshot_path = NULL;
     
     // Parse command if provided
     if (argc > 1 && argv[1][0] != '-') {
@@ -135,7 +235,7 @@ int parse_options(int argc, char* argv[], CliOptions* options) {
     int c;
     int option_index = 0;
     
-    while ((c = getopt_long(argc, argv, "hVvo:f:nsr:", long_options, &option_index)) != -1) {
+    while ((c = getopt_long(argc, argv, "hVvo:f:nsr:j:", long_options, &option_index)) != -1) {
         switch (c) {
             case 'h':
                 options->command = CMD_HELP;
@@ -152,6 +252,7 @@ int parse_options(int argc, char* argv[], CliOptions* options) {
                 break;
             case 'f':
                 options->output_format = parse_output_format(optarg);
+                options->format_given = true;
                 break;
             case 'n':
                 options->dry_run = true;
@@ -163,6 +264,32 @@ int parse_options(int argc, char* argv[], CliOptions* options) {
                 free(options->root_path);
                 options->root_path = strdup(optarg);
                 break;
+            case 'j':
+                if (!parse_count(optarg, THREAD_POOL_MAX_WORKERS, &options->jobs)) {
+                    fprintf(stderr, "❌ --jobs takes a count of 1-%d: %s\n", THREAD_POOL_MAX_WORKERS, optarg);
+                    return -1;
+                }
+                break;
+            case OPT_STAGE_THREADS:
+                if (!parse_stage_threads(optarg, options->pipeline.threads)) {
+                    fprintf(stderr, "❌ --stage-threads takes up to %d counts of 1-%d: %s\n", PIPELINE_STAGE_COUNT,
+                            PIPELINE_MAX_STAGE_THREADS, optarg);
+                    return -1;
+                }
+                break;
+            case OPT_QUEUE_SIZE:
+                if (!parse_count(optarg, PIPELINE_MAX_QUEUE_CAPACITY, &options->pipeline.queue_capacity)) {
+                    fprintf(stderr, "❌ --queue-size takes a count of 1-%d: %s\n", PIPELINE_MAX_QUEUE_CAPACITY, optarg);
+                    return -1;
+                }
+                break;
+            case OPT_COMPACT:
+                options->compact = true;
+                break;
+            case OPT_SNAPSHOT:
+                free(options->snapshot_path);
+                options->snapshot_path = strdup(optarg);
+                break;
             case '?':
                 return -1;
             default:
@@ -170,12 +297,19 @@ int parse_options(int argc, char* argv[], CliOptions* options) {
         }
     }
     
+    // Remaining positional arguments are command inputs
+    if (optind < argc) {
+        options->inputs = &argv[optind];
+        options->input_count = argc - optind;
+    }
+    
     return 0;
 }
 
 void cleanup_options(CliOptions* options) {
     free(options->root_path);
     free(options->output_path);
+    free(options->snapshot_path);
 }
 
 int cmd_analyze(const CliOptions* options) {
@@ -185,6 +319,10 @@ int cmd_analyze(const CliOptions* options) {
         printf("  Output: %s\n", options->output_path ? options->output_path : "stdout");
         printf("  Format: %s\n", options->output_format == OUTPUT_JSON ? "JSON" : "Other");
     }
+    if (options->output_path && options->output_format != OUTPUT_JSON) {
+        fprintf(stderr, "❌ analyze writes --output only as json\n");
+        return 1;
+    }
     
     DependencyTracker* tracker = deptrack_create();
     if (!tracker) {
@@ -192,12 +330,32 @@ int cmd_analyze(const CliOptions* options) {
         return 1;
     }
     
-    int result = deptrack_initialize(tracker, NULL);
+    // deptrack.json at the root is optional; command-line options override it
+    char config_path[MAX_PATH_LENGTH];
+    bool has_config = snprintf(config_path, sizeof(config_path), "%s/deptrack.json", options->root_path) <
+                      (int)sizeof(config_path) && access(config_path, R_OK) == 0;
+    int result = deptrack_initialize(tracker, has_config ? config_path : NULL);
     if (result != DEPTRACK_SUCCESS) {
         fprintf(stderr, "❌ Failed to initialize tracker: %s\n", deptrack_error_string(result));
         deptrack_destroy(tracker);
         return 1;
     }
+    if (options->verbose && has_config) {
+        printf("  Config: %s\n", config_path);
+    }
+    
+    if (options->jobs > 0) {
+        tracker->jobs = options->jobs;
+    }
+    for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+        if (options->pipeline.threads[s] > 0) tracker->pipeline.threads[s] = options->pipeline.threads[s];
+    }
+    if (options->pipeline.queue_capacity > 0) {
+        tracker->pipeline.queue_capacity = options->pipeline.queue_capacity;
+    }
+    if (options->compact) {
+        tracker->compact_output = true;
+    }
     
     result = deptrack_analyze_directory(tracker, options->root_path);
     if (result != DEPTRACK_SUCCESS) {
@@ -206,6 +364,23 @@ int cmd_analyze(const CliOptions* options) {
         return 1;
     }
     
+    const PipelineMetrics* metrics = &tracker->pipeline_metrics;
+    DependencyGraph* graph = deptrack_get_graph(tracker);
+    printf("📦 %zu files merged, %zu skipped, %zu failed: %zu nodes, %zu edges in %.1f ms\n",
+           metrics->stages[PIPELINE_MERGE].items, metrics->files_skipped, metrics->files_failed,
+           graph->node_count, graph->edge_count, metrics->elapsed_ns / 1e6);
+    if (options->verbose) {
+        printf("  %zu worker threads\n", thread_pool_size(tracker->pool));
+        printf("  %-10s %7s %7s %13s %9s %9s %11s %11s\n", "stage", "workers", "items", "queue max/cap",
+               "mean", "busy ms", "starved ms", "blocked ms");
+        for (size_t s = 0; s < PIPELINE_STAGE_COUNT; s++) {
+            const PipelineStageMetrics* m = &metrics->stages[s];
+            printf("  %-10s %7zu %7zu %6zu/%-6zu %9.1f %9.1f %11.1f %11.1f\n", pipeline_stage_name((PipelineStage)s),
+                   m->threads, m->items, m->max_queue_depth, m->queue_capacity, m->mean_queue_depth,
+                   m->busy_ns / 1e6, m->input_stall_ns / 1e6, m->output_stall_ns / 1e6);
+        }
+    }
+    
     if (options->output_path) {
         result = deptrack_generate_output(tracker, options->output_format, options->output_path);
         if (result != DEPTRACK_SUCCESS) {
@@ -213,6 +388,17 @@ int cmd_analyze(const CliOptions* options) {
             deptrack_destroy(tracker);
             return 1;
         }
+    }
+    if (options->snapshot_path) {
+        result = graph_snapshot_write(graph, deptrack_thread_pool(tracker), options->snapshot_path);
+        if (result != DEPTRACK_SUCCESS) {
+            fprintf(stderr, "❌ Snapshot failed: %s\n", deptrack_error_string(result));
+            deptrack_destroy(tracker);
+            return 1;
+        }
+        printf("💾 Snapshot: %s\n", options->snapshot_path);
+    }
+    if (options->output_path) {
         printf("✅ Analysis complete: %s\n", options->output_path);
     } else {
         printf("✅ Analysis complete\n");
@@ -262,6 +448,770 @@ int cmd_feature_dag(const CliOptions* options) {
     return 0;
 }
 
+int cmd_waves(const CliOptions* options) {
+    if (options->input_count < 1) {
+        fprintf(stderr, "❌ waves requires a docker-compose file\n");
+        return 1;
+    }
+    
+    ComposeFile* compose = compose_parse_file(options->inputs[0]);
+    if (!compose) {
+        fprintf(stderr, "❌ Failed to parse %s\n", options->inputs[0]);
+        return 1;
+    }
+    
+    DagSchedule schedule;
+    int result = compose_startup_waves(compose, &schedule);
+    if (result != DEPTRACK_SUCCESS && result != DEPTRACK_ERROR_CYCLE) {
+        fprintf(stderr, "❌ Wave computation failed: %s\n", deptrack_error_string(result));
+        compose_file_destroy(compose);
+        return 1;
+    }
+    
+    FILE* out = stdout;
+    if (options->output_path) {
+        out = fopen(options->output_path, "w");
+        if (!out) {
+            fprintf(stderr, "❌ Cannot open %s\n", options->output_path);
+            dag_schedule_destroy(&schedule);
+            compose_file_destroy(compose);
+            return 1;
+        }
+    }
+    
+    if (options->format_given && options->output_format == OUTPUT_JSON) {
+        fprintf(out, "{\n  \"waves\": [");
+        for (size_t w = 0; w < schedule.wave_count; w++) {
+            fprintf(out, "%s\n    [", w ? "," : "");
+            for (size_t i = schedule.wave_offsets[w]; i < schedule.wave_offsets[w + 1]; i++) {
+                if (i > schedule.wave_offsets[w]) fprintf(out, ", ");
+                json_write_string(out, compose->services[schedule.order[i]].name);
+            }
+            fprintf(out, "]");
+        }
+        fprintf(out, "\n  ],\n  \"critical_path\": [");
+        for (size_t i = 0; i < schedule.critical_path_length; i++) {
+            if (i) fprintf(out, ", ");
+            json_write_string(out, compose->services[schedule.critical_path[i]].name);
+        }
+        fprintf(out, "],\n  \"critical_path_cost\": %.1f,\n  \"cyclic\": [", schedule.critical_path_cost);
+        bool first = true;
+        for (size_t n = 0; n < compose->service_count; n++) {
+            if (schedule.wave_of[n] == SIZE_MAX) {
+                if (!first) fprintf(out, ", ");
+                json_write_string(out, compose->services[n].name);
+                first = false;
+            }
+        }
+        fprintf(out, "]\n}\n");
+    } else {
+        fprintf(out, "🌊 %zu services in %zu startup waves\n", compose->service_count, schedule.wave_count);
+        for (size_t w = 0; w < schedule.wave_count; w++) {
+            fprintf(out, "  Wave %zu:", w + 1);
+            for (size_t i = schedule.wave_offsets[w]; i < schedule.wave_offsets[w + 1]; i++) {
+                fprintf(out, " %s", compose->services[schedule.order[i]].name);
+            }
+            fprintf(out, "\n");
+        }
+        fprintf(out, "  Critical path (%.1f):", schedule.critical_path_cost);
+        for (size_t i = 0; i < schedule.critical_path_length; i++) {
+            fprintf(out, "%s%s", i ? " -> " : " ", compose->services[schedule.critical_path[i]].name);
+        }
+        fprintf(out, "\n");
+        if (result == DEPTRACK_ERROR_CYCLE) {
+            fprintf(out, "⚠️  %zu services are part of a depends_on cycle\n",
+                    compose->service_count - schedule.scheduled_count);
+        }
+    }
+    
+    if (out != stdout) {
+        fclose(out);
+    }
+    
+    dag_schedule_destroy(&schedule);
+    compose_file_destroy(compose);
+    return result == DEPTRACK_SUCCESS ? 0 : 1;
+}
+
+int cmd_protos(const CliOptions* options) {
+    ProtoSet* set = proto_set_load(options->root_path);
+    if (!set) {
+        fprintf(stderr, "❌ Failed to load protos from %s\n", options->root_path);
+        return 1;
+    }
+    
+    DagSchedule schedule;
+    int result = proto_set_compile_order(set, &schedule);
+    if (result != DEPTRACK_SUCCESS && result != DEPTRACK_ERROR_CYCLE) {
+        fprintf(stderr, "❌ Compile order failed: %s\n", deptrack_error_string(result));
+        proto_set_destroy(set);
+        return 1;
+    }
+    
+    bool* stale = calloc(set->file_count ? set->file_count : 1, sizeof(bool));
+    size_t stale_count = 0;
+    if (stale && options->input_count > 0) {
+        stale_count = proto_set_stale(set, (const char* const*)options->inputs,
+                                      (size_t)options->input_count, stale);
+    }
+    
+    bool json = options->format_given && options->output_format == OUTPUT_JSON;
+    if (json) {
+        printf("{\n  \"compile_order\": [");
+        for (size_t i = 0; i < schedule.scheduled_count; i++) {
+            if (i) printf(", ");
+            json_write_string(stdout, set->import_paths[schedule.order[i]]);
+        }
+        printf("],\n  \"stale\": [");
+        bool first = true;
+        for (size_t i = 0; i < schedule.scheduled_count && stale; i++) {
+            size_t file = schedule.order[i];
+            if (stale[file]) {
+                if (!first) printf(", ");
+                json_write_string(stdout, set->import_paths[file]);
+                first = false;
+            }
+        }
+        printf("],\n  \"stale_services\": [");
+        first = true;
+        for (size_t i = 0; i < set->file_count && stale; i++) {
+            for (size_t s = 0; stale[i] && s < set->files[i]->service_count; s++) {
+                if (!first) printf(", ");
+                json_write_string(stdout, set->files[i]->services[s].name);
+                first = false;
+            }
+        }
+        printf("]\n}\n");
+    } else {
+        printf("📦 %zu proto files in %zu compile waves\n", set->file_count, schedule.wave_count);
+        for (size_t w = 0; w < schedule.wave_count; w++) {
+            printf("  Wave %zu:", w + 1);
+            for (size_t i = schedule.wave_offsets[w]; i < schedule.wave_offsets[w + 1]; i++) {
+                printf(" %s", set->import_paths[schedule.order[i]]);
+            }
+            printf("\n");
+        }
+        if (options->input_count > 0) {
+            printf("♻️  %zu stale proto files:\n", stale_count);
+            for (size_t i = 0; i < set->file_count && stale; i++) {
+                if (!stale[i]) continue;
+                printf("  - %s", set->import_paths[i]);
+                for (size_t s = 0; s < set->files[i]->service_count; s++) {
+                    printf("%s%s", s ? ", " : " (services: ", set->files[i]->services[s].name);
+                }
+                printf("%s\n", set->files[i]->service_count ? ")" : "");
+            }
+        }
+        if (result == DEPTRACK_ERROR_CYCLE) {
+            printf("⚠️  %zu proto files are part of an import cycle\n",
+                   set->file_count - schedule.scheduled_count);
+        }
+    }
+    
+    free(stale);
+    dag_schedule_destroy(&schedule);
+    proto_set_destroy(set);
+    return result == DEPTRACK_SUCCESS ? 0 : 1;
+}
+
+int cmd_depfile(const CliOptions* options) {
+    if (options->input_count < 1) {
+        fprintf(stderr, "❌ depfile requires at least one source file\n");
+        return 1;
+    }
+    
+    CIncludeResolver* resolver = c_resolver_create();
+    if (!resolver) {
+        fprintf(stderr, "❌ Out of memory\n");
+        return 1;
+    }
+    
+    char cmakelists[MAX_PATH_LENGTH];
+    snprintf(cmakelists, sizeof(cmakelists), "%s/CMakeLists.txt", options->root_path);
+    if (c_resolver_load_cmake(resolver, cmakelists) != DEPTRACK_SUCCESS && options->verbose) {
+        fprintf(stderr, "⚠️  No include directories read from %s\n", cmakelists);
+    }
+    
+    FILE* out = stdout;
+    if (options->output_path) {
+        out = fopen(options->output_path, "w");
+        if (!out) {
+            fprintf(stderr, "❌ Cannot open %s\n", options->output_path);
+            c_resolver_destroy(resolver);
+            return 1;
+        }
+    }
+    
+    int status = 0;
+    for (int i = 0; i < options->input_count; i++) {
+        // Object target: the source path with its extension replaced by .o
+        const char* source = options->inputs[i];
+        const char* slash = strrchr(source, '/');
+        const char* dot = strrchr(source, '.');
+        int stem = dot && (!slash || dot > slash) ? (int)(dot - source) : (int)strlen(source);
+        char target[MAX_PATH_LENGTH];
+        snprintf(target, sizeof(target), "%.*s.o", stem, source);
+        
+        int result = c_write_depfile(resolver, target, source, true, out);
+        if (result != DEPTRACK_SUCCESS) {
+            fprintf(stderr, "❌ %s: %s\n", source, deptrack_error_string(result));
+            status = 1;
+        }
+    }
+    
+    if (options->verbose) {
+        fprintf(stderr, "📄 %zu files, %zu include lookups cached, %zu filesystem probes\n",
+                resolver->file_count, resolver->cache_hits, resolver->stat_count);
+    }
+    
+    if (out != stdout) {
+        fclose(out);
+    }
+    c_resolver_destroy(resolver);
+    return status;
+}
+
+static void print_json_list(FILE* out, char** items, size_t count) {
+    fprintf(out, "[");
+    for (size_t i = 0; i < count; i++) {
+        if (i) fprintf(out, ", ");
+        json_write_string(out, items[i]);
+    }
+    fprintf(out, "]");
+}
+
+int cmd_make(const CliOptions* options) {
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/Makefile", options->root_path);
+    Makefile* mf = makefile_parse_file(path);
+    if (!mf) {
+        fprintf(stderr, "❌ Failed to parse %s\n", path);
+        return 1;
+    }
+    
+    DagSchedule schedule;
+    int result = makefile_schedule(mf, &schedule);
+    if (result != DEPTRACK_SUCCESS && result != DEPTRACK_ERROR_CYCLE) {
+        fprintf(stderr, "❌ Target graph failed: %s\n", deptrack_error_string(result));
+        makefile_destroy(mf);
+        return 1;
+    }
+    
+    bool* affected = calloc(mf->target_count ? mf->target_count : 1, sizeof(bool));
+    size_t affected_count = 0;
+    if (affected && options->input_count > 0) {
+        affected_count = makefile_affected_targets(mf, (const char* const*)options->inputs,
+                                                   (size_t)options->input_count, affected);
+    }
+    
+    FILE* out = stdout;
+    if (options->output_path) {
+        out = fopen(options->output_path, "w");
+        if (!out) {
+            fprintf(stderr, "❌ Cannot open %s\n", options->output_path);
+            free(affected);
+            dag_schedule_destroy(&schedule);
+            makefile_destroy(mf);
+            return 1;
+        }
+    }
+    
+    if (options->format_given && options->output_format == OUTPUT_JSON) {
+        fprintf(out, "{\n  \"targets\": [");
+        for (size_t t = 0; t < mf->target_count; t++) {
+            const MakeTarget* target = &mf->targets[t];
+            fprintf(out, "%s\n    {\"name\": ", t ? "," : "");
+            json_write_string(out, target->name);
+            fprintf(out, ", \"line\": %d, \"phony\": %s, \"prerequisites\": ", target->line_number,
+                    target->phony ? "true" : "false");
+            print_json_list(out, target->prerequisites, target->prerequisite_count);
+            fprintf(out, ", \"invokes\": ");
+            print_json_list(out, target->invocations, target->invocation_count);
+            fprintf(out, ", \"scripts\": ");
+            print_json_list(out, target->scripts, target->script_count);
+            fprintf(out, ", \"calls\": ");
+            print_json_list(out, target->calls, target->call_count);
+            fprintf(out, "}");
+        }
+        fprintf(out, "\n  ],\n  \"waves\": [");
+        for (size_t w = 0; w < schedule.wave_count; w++) {
+            fprintf(out, "%s\n    [", w ? "," : "");
+            for (size_t i = schedule.wave_offsets[w]; i < schedule.wave_offsets[w + 1]; i++) {
+                if (i > schedule.wave_offsets[w]) fprintf(out, ", ");
+                json_write_string(out, mf->targets[schedule.order[i]].name);
+            }
+            fprintf(out, "]");
+        }
+        fprintf(out, "\n  ],\n  \"critical_path\": [");
+        for (size_t i = 0; i < schedule.critical_path_length; i++) {
+            if (i) fprintf(out, ", ");
+            json_write_string(out, mf->targets[schedule.critical_path[i]].name);
+        }
+        fprintf(out, "],\n  \"includes\": ");
+        print_json_list(out, mf->includes, mf->include_count);
+        fprintf(out, ",\n  \"affected\": [");
+        bool first = true;
+        for (size_t t = 0; t < mf->target_count && affected; t++) {
+            if (affected[t]) {
+                if (!first) fprintf(out, ", ");
+                json_write_string(out, mf->targets[t].name);
+                first = false;
+            }
+        }
+        fprintf(out, "]\n}\n");
+    } else {
+        fprintf(out, "🛠️  %zu targets in %zu waves\n", mf->target_count, schedule.wave_count);
+        for (size_t w = 0; w < schedule.wave_count; w++) {
+            fprintf(out, "  Wave %zu:", w + 1);
+            for (size_t i = schedule.wave_offsets[w]; i < schedule.wave_offsets[w + 1]; i++) {
+                fprintf(out, " %s", mf->targets[schedule.order[i]].name);
+            }
+            fprintf(out, "\n");
+        }
+        fprintf(out, "  Critical path (%.1f):", schedule.critical_path_cost);
+        for (size_t i = 0; i < schedule.critical_path_length; i++) {
+            fprintf(out, "%s%s", i ? " -> " : " ", mf->targets[schedule.critical_path[i]].name);
+        }
+        fprintf(out, "\n");
+        if (options->verbose) {
+            for (size_t t = 0; t < mf->target_count; t++) {
+                const MakeTarget* target = &mf->targets[t];
+                for (size_t s = 0; s < target->script_count; s++) {
+                    fprintf(out, "  📜 %s runs %s\n", target->name, target->scripts[s]);
+                }
+            }
+        }
+        if (options->input_count > 0) {
+            fprintf(out, "♻️  %zu affected targets:\n", affected_count);
+            for (size_t t = 0; t < mf->target_count && affected; t++) {
+                if (affected[t]) fprintf(out, "  - %s\n", mf->targets[t].name);
+            }
+        }
+        if (result == DEPTRACK_ERROR_CYCLE) {
+            fprintf(out, "⚠️  %zu targets are part of a dependency cycle\n",
+                    mf->target_count - schedule.scheduled_count);
+        }
+    }
+    
+    if (out != stdout) {
+        fclose(out);
+    }
+    
+    free(affected);
+    dag_schedule_destroy(&schedule);
+    makefile_destroy(mf);
+    return result == DEPTRACK_SUCCESS ? 0 : 1;
+}
+
+int cmd_migrations(const CliOptions* options) {
+    const char* dir = options->input_count > 0 ? options->inputs[0] : options->root_path;
+    SqlMigrationSet* set = sql_migration_set_load(dir);
+    if (!set) {
+        fprintf(stderr, "❌ Failed to load migrations from %s\n", dir);
+        return 1;
+    }
+    
+    DagSchedule schedule;
+    int result = sql_migration_set_order(set, &schedule);
+    if (result != DEPTRACK_SUCCESS && result != DEPTRACK_ERROR_CYCLE) {
+        fprintf(stderr, "❌ Apply order failed: %s\n", deptrack_error_string(result));
+        sql_migration_set_destroy(set);
+        return 1;
+    }
+    
+    SqlForwardReference* forward = NULL;
+    size_t forward_count = 0;
+    sql_migration_set_forward_references(set, &forward, &forward_count);
+    
+    if (options->format_given && options->output_format == OUTPUT_JSON) {
+        printf("{\n  \"apply_order\": [");
+        for (size_t i = 0; i < schedule.scheduled_count; i++) {
+            if (i) printf(", ");
+            json_write_string(stdout, set->migrations[schedule.order[i]]->filepath);
+        }
+        printf("],\n  \"waves\": [");
+        for (size_t w = 0; w < schedule.wave_count; w++) {
+            printf("%s\n    [", w ? "," : "");
+            for (size_t i = schedule.wave_offsets[w]; i < schedule.wave_offsets[w + 1]; i++) {
+                if (i > schedule.wave_offsets[w]) printf(", ");
+                json_write_string(stdout, set->migrations[schedule.order[i]]->filepath);
+            }
+            printf("]");
+        }
+        printf("\n  ],\n  \"forward_references\": [");
+        for (size_t i = 0; i < forward_count; i++) {
+            const SqlMigration* migration = set->migrations[forward[i].migration];
+            const SqlObject* obj = &migration->objects[forward[i].object];
+            printf("%s\n    {\"file\": ", i ? "," : "");
+            json_write_string(stdout, migration->filepath);
+            printf(", \"line\": %d, \"object\": ", obj->line_number);
+            json_write_string(stdout, obj->name);
+            printf(", \"defined_in\": ");
+            json_write_string(stdout, set->migrations[forward[i].defined_in]->filepath);
+            printf("}");
+        }
+        printf("%s]\n}\n", forward_count ? "\n  " : "");
+    } else {
+        printf("🗄️  %zu migrations in %zu apply waves\n", set->migration_count, schedule.wave_count);
+        for (size_t w = 0; w < schedule.wave_count; w++) {
+            printf("  Wave %zu:", w + 1);
+            for (size_t i = schedule.wave_offsets[w]; i < schedule.wave_offsets[w + 1]; i++) {
+                printf(" %s", set->migrations[schedule.order[i]]->filepath);
+            }
+            printf("\n");
+        }
+        for (size_t i = 0; i < forward_count; i++) {
+            const SqlMigration* migration = set->migrations[forward[i].migration];
+            const SqlObject* obj = &migration->objects[forward[i].object];
+            printf("⚠️  %s:%d uses %s before %s creates it\n", migration->filepath, obj->line_number, obj->name,
+                   set->migrations[forward[i].defined_in]->filepath);
+        }
+        if (result == DEPTRACK_ERROR_CYCLE) {
+            printf("❌ %zu migrations cannot be ordered: their references form a cycle\n",
+                   set->migration_count - schedule.scheduled_count);
+        }
+    }
+    
+    int status = result == DEPTRACK_SUCCESS && forward_count == 0 ? 0 : 1;
+    free(forward);
+    dag_schedule_destroy(&schedule);
+    sql_migration_set_destroy(set);
+    return status;
+}
+
+int cmd_scripts(const CliOptions* options) {
+    ScriptGraph* graph = script_graph_load(options->root_path);
+    if (!graph) {
+        fprintf(stderr, "❌ Failed to scan scripts under %s\n", options->root_path);
+        return 1;
+    }
+    
+    bool* dependents = calloc(graph->node_count ? graph->node_count : 1, sizeof(bool));
+    if (!dependents) {
+        script_graph_destroy(graph);
+        return 1;
+    }
+    
+    bool json = options->format_given && options->output_format == OUTPUT_JSON;
+    if (json) {
+        printf("{\n  \"references\": [");
+        for (size_t e = 0; e < graph->edge_count; e++) {
+            printf("%s\n    {\"from\": ", e ? "," : "");
+            json_write_string(stdout, graph->nodes[graph->edge_from[e]]);
+            printf(", \"to\": ");
+            json_write_string(stdout, graph->nodes[graph->edge_to[e]]);
+            printf(", \"kind\": \"%s\"}", shell_reference_kind_name(graph->edge_kind[e]));
+        }
+        printf("%s],\n  \"dependents\": {", graph->edge_count ? "\n  " : "");
+    } else {
+        printf("📜 %zu scripts and targets, %zu references\n", graph->node_count, graph->edge_count);
+        for (size_t e = 0; options->verbose && e < graph->edge_count; e++) {
+            printf("  %s -> %s (%s)\n", graph->nodes[graph->edge_from[e]], graph->nodes[graph->edge_to[e]],
+                   shell_reference_kind_name(graph->edge_kind[e]));
+        }
+    }
+    
+    for (int i = 0; i < options->input_count; i++) {
+        size_t count = script_graph_dependents(graph, options->inputs[i], dependents);
+        if (json) {
+            printf("%s\n    ", i ? "," : "");
+            json_write_string(stdout, options->inputs[i]);
+            printf(": [");
+        } else {
+            printf("🔗 %zu users of %s%s\n", count, options->inputs[i], count ? ":" : "");
+        }
+        bool first = true;
+        for (size_t n = 0; n < graph->node_count && count; n++) {
+            if (!dependents[n]) continue;
+            if (json) {
+                if (!first) printf(", ");
+                json_write_string(stdout, graph->nodes[n]);
+            } else {
+                printf("  - %s\n", graph->nodes[n]);
+            }
+            first = false;
+        }
+        if (json) printf("]");
+    }
+    if (json) {
+        printf("%s}\n}\n", options->input_count ? "\n  " : "");
+    }
+    
+    free(dependents);
+    script_graph_destroy(graph);
+    return 0;
+}
+
+int cmd_ci(const CliOptions* options) {
+    char** files = NULL;
+    size_t file_count = 0;
+    if (ci_find_workflows(options->root_path, &files, &file_count) != DEPTRACK_SUCCESS) {
+        fprintf(stderr, "❌ Failed to list workflows under %s\n", options->root_path);
+        return 1;
+    }
+    
+    bool json = options->format_given && options->output_format == OUTPUT_JSON;
+    const char* const* changed = (const char* const*)options->inputs;
+    size_t changed_count = (size_t)options->input_count;
+    int status = 0;
+    if (json) printf("{\n  \"workflows\": [");
+    
+    bool first_workflow = true;
+    for (size_t f = 0; f < file_count; f++) {
+        CiWorkflow* wf = ci_workflow_parse_file(options->root_path, files[f]);
+        if (!wf) {
+            fprintf(stderr, "❌ Failed to parse %s\n", files[f]);
+            status = 1;
+            continue;
+        }
+        
+        DagSchedule schedule;
+        int result = ci_workflow_schedule(wf, &schedule);
+        bool* required = calloc(wf->job_count ? wf->job_count : 1, sizeof(bool));
+        if ((result != DEPTRACK_SUCCESS && result != DEPTRACK_ERROR_CYCLE) || !required) {
+            fprintf(stderr, "❌ Job graph failed for %s\n", files[f]);
+            if (result == DEPTRACK_SUCCESS || result == DEPTRACK_ERROR_CYCLE) dag_schedule_destroy(&schedule);
+            free(required);
+            ci_workflow_destroy(wf);
+            status = 1;
+            continue;
+        }
+        size_t required_count = ci_workflow_required_jobs(wf, changed, changed_count, required);
+        if (result == DEPTRACK_ERROR_CYCLE) status = 1;
+        
+        if (json) {
+            printf("%s\n    {\"file\": ", first_workflow ? "" : ",");
+            json_write_string(stdout, wf->filepath);
+            printf(", \"jobs\": [");
+            for (size_t j = 0; j < wf->job_count; j++) {
+                const CiJob* job = &wf->jobs[j];
+                printf("%s\n      {\"id\": ", j ? "," : "");
+                json_write_string(stdout, job->id);
+                printf(", \"line\": %d, \"timeout_minutes\": %d, \"needs\": ", job->line_number,
+                       job->timeout_minutes);
+                print_json_list(stdout, job->needs, job->need_count);
+                printf(", \"paths\": ");
+                print_json_list(stdout, job->paths, job->path_count);
+                printf(", \"scripts\": ");
+                print_json_list(stdout, job->scripts, job->script_count);
+                printf("}");
+            }
+            printf("%s],\n      \"critical_path\": [", wf->job_count ? "\n    " : "");
+            for (size_t i = 0; i < schedule.critical_path_length; i++) {
+                if (i) printf(", ");
+                json_write_string(stdout, wf->jobs[schedule.critical_path[i]].id);
+            }
+            printf("], \"critical_path_minutes\": %.0f,\n      \"required\": [", schedule.critical_path_cost);
+            bool first = true;
+            for (size_t j = 0; j < wf->job_count; j++) {
+                if (!required[j]) continue;
+                if (!first) printf(", ");
+                json_write_string(stdout, wf->jobs[j].id);
+                first = false;
+            }
+            printf("]}");
+        } else if (wf->job_count > 0) {
+            printf("⚙️  %s: %zu jobs in %zu waves\n", wf->filepath, wf->job_count, schedule.wave_count);
+            printf("  Critical path (%.0f min):", schedule.critical_path_cost);
+            for (size_t i = 0; i < schedule.critical_path_length; i++) {
+                printf("%s%s", i ? " -> " : " ", wf->jobs[schedule.critical_path[i]].id);
+            }
+            printf("\n");
+            for (size_t j = 0; options->verbose && j < wf->job_count; j++) {
+                for (size_t i = 0; i < wf->jobs[j].script_count; i++) {
+                    printf("  📜 %s runs %s\n", wf->jobs[j].id, wf->jobs[j].scripts[i]);
+                }
+            }
+            if (changed_count > 0) {
+                printf("  ▶️  %zu of %zu jobs required%s\n", required_count, wf->job_count, required_count ? ":" : "");
+                for (size_t j = 0; j < wf->job_count; j++) {
+                    if (!required[j]) continue;
+                    printf("    - %s%s\n", wf->jobs[j].id, wf->jobs[j].path_count ? "" : " (no path filter)");
+                }
+            }
+            if (result == DEPTRACK_ERROR_CYCLE) {
+                printf("  ⚠️  %zu jobs are part of a needs cycle\n", wf->job_count - schedule.scheduled_count);
+            }
+        }
+        first_workflow = false;
+        
+        free(required);
+        dag_schedule_destroy(&schedule);
+        ci_workflow_destroy(wf);
+    }
+    if (json) printf("%s]\n}\n", first_workflow ? "" : "\n  ");
+    
+    for (size_t f = 0; f < file_count; f++) {
+        free(files[f]);
+    }
+    free(files);
+    return status;
+}
+
+int cmd_images(const CliOptions* options) {
+    DockerImageSet* set = docker_image_set_load(options->root_path);
+    if (!set) {
+        fprintf(stderr, "❌ Failed to scan Dockerfiles under %s\n", options->root_path);
+        return 1;
+    }
+    
+    bool* rebuild = calloc(set->image_count ? set->image_count : 1, sizeof(bool));
+    if (!rebuild) {
+        docker_image_set_destroy(set);
+        return 1;
+    }
+    size_t rebuild_count = docker_images_to_rebuild(set, (const char* const*)options->inputs,
+                                                    (size_t)options->input_count, rebuild);
+    
+    bool json = options->format_given && options->output_format == OUTPUT_JSON;
+    if (json) printf("{\n  \"images\": [");
+    for (size_t i = 0; i < set->image_count; i++) {
+        const Dockerfile* df = set->images[i].dockerfile;
+        if (json) {
+            printf("%s\n    {\"name\": ", i ? "," : "");
+            json_write_string(stdout, set->images[i].name);
+            printf(", \"dockerfile\": ");
+            json_write_string(stdout, df->filepath);
+            printf(", \"context\": ");
+            json_write_string(stdout, df->context);
+            printf(", \"stages\": [");
+            for (size_t s = 0; s < df->stage_count; s++) {
+                printf("%s{\"name\": ", s ? ", " : "");
+                json_write_string(stdout, df->stages[s].name);
+                printf(", \"from\": ");
+                json_write_string(stdout, df->stages[s].base);
+                printf(", \"line\": %d}", df->stages[s].line_number);
+            }
+            printf("], \"references\": [");
+            for (size_t r = 0; r < df->reference_count; r++) {
+                const DockerReference* ref = &df->references[r];
+                printf("%s\n      {\"kind\": \"%s\", \"value\": ", r ? "," : "", docker_reference_kind_name(ref->kind));
+                json_write_string(stdout, ref->value);
+                printf(", \"version\": ");
+                json_write_string(stdout, ref->version);
+                printf(", \"stage\": %zu, \"line\": %d}", ref->stage, ref->line_number);
+            }
+            printf("%s]}", df->reference_count ? "\n    " : "");
+        } else {
+            printf("🐳 %s (%s): %zu stages, %zu references\n", set->images[i].name, df->filepath, df->stage_count,
+                   df->reference_count);
+            for (size_t r = 0; options->verbose && r < df->reference_count; r++) {
+                const DockerReference* ref = &df->references[r];
+                printf("  %s:%d %s %s%s%s\n", df->filepath, ref->line_number, docker_reference_kind_name(ref->kind),
+                       ref->value, ref->version ? " " : "", ref->version ? ref->version : "");
+            }
+        }
+    }
+    
+    if (json) {
+        printf("%s],\n  \"rebuild\": [", set->image_count ? "\n  " : "");
+        bool first = true;
+        for (size_t i = 0; i < set->image_count; i++) {
+            if (!rebuild[i]) continue;
+            if (!first) printf(", ");
+            json_write_string(stdout, set->images[i].name);
+            first = false;
+        }
+        printf("]\n}\n");
+    } else if (options->input_count > 0) {
+        printf("🔁 %zu of %zu images need rebuilding%s\n", rebuild_count, set->image_count, rebuild_count ? ":" : "");
+        for (size_t i = 0; i < set->image_count; i++) {
+            if (rebuild[i]) printf("  - %s\n", set->images[i].name);
+        }
+    }
+    
+    free(rebuild);
+    docker_image_set_destroy(set);
+    return 0;
+}
+
+int cmd_query(const CliOptions* options) {
+    if (!options->snapshot_path) {
+        fprintf(stderr, "❌ query requires --snapshot=FILE from deptrack analyze\n");
+        return 1;
+    }
+    
+    GraphSnapshot* snapshot = NULL;
+    int result = graph_snapshot_open(options->snapshot_path, &snapshot);
+    if (result == DEPTRACK_SUCCESS && options->strict) {
+        result = graph_snapshot_verify(snapshot);
+    }
+    if (result != DEPTRACK_SUCCESS) {
+        fprintf(stderr, "❌ Cannot read snapshot %s: %s\n", options->snapshot_path, deptrack_error_string(result));
+        graph_snapshot_close(snapshot);
+        return 1;
+    }
+    
+    bool json = options->format_given && options->output_format == OUTPUT_JSON;
+    if (json) {
+        printf("{\n  \"node_count\": %zu,\n  \"edge_count\": %zu,\n  \"nodes\": [",
+               graph_snapshot_node_count(snapshot), graph_snapshot_edge_count(snapshot));
+    } else if (options->input_count == 0) {
+        printf("🗂️  %s: %zu nodes, %zu edges\n", options->snapshot_path, graph_snapshot_node_count(snapshot),
+               graph_snapshot_edge_count(snapshot));
+    }
+    int status = 0;
+    bool first_node = true;
+    for (int i = 0; i < options->input_count; i++) {
+        size_t node = graph_snapshot_find_node(snapshot, options->inputs[i]);
+        if (node == SIZE_MAX) {
+            fprintf(stderr, "❌ No node %s\n", options->inputs[i]);
+            status = 1;
+            continue;
+        }
+        const char* filepath = graph_snapshot_node_filepath(snapshot, node);
+        if (json) {
+            printf("%s\n    {\"id\": ", first_node ? "" : ",");
+            json_write_string(stdout, options->inputs[i]);
+            printf(", \"filepath\": ");
+            json_write_string(stdout, filepath);
+            printf(", \"dependencies\": [");
+        } else {
+            printf("📦 %s%s%s\n", options->inputs[i], filepath ? " " : "", filepath ? filepath : "");
+        }
+        first_node = false;
+        
+        SnapshotCursor cursor;
+        size_t neighbor, edge;
+        bool first = true;
+        graph_snapshot_dependencies(snapshot, node, &cursor);
+        while (snapshot_cursor_next(&cursor, &neighbor, &edge)) {
+            const char* version = graph_snapshot_edge_version(snapshot, edge);
+            const char* type = deptrack_dependency_type_name(graph_snapshot_edge_type(snapshot, edge));
+            if (json) {
+                printf("%s{\"id\": ", first ? "" : ", ");
+                json_write_string(stdout, graph_snapshot_node_id(snapshot, neighbor));
+                printf(", \"type\": \"%s\", \"version\": ", type);
+                json_write_string(stdout, version);
+                printf("}");
+            } else {
+                printf("  -> %s (%s)%s%s\n", graph_snapshot_node_id(snapshot, neighbor), type, version ? " " : "",
+                       version ? version : "");
+            }
+            first = false;
+        }
+        if (json) printf("], \"dependents\": [");
+        first = true;
+        graph_snapshot_dependents(snapshot, node, &cursor);
+        while (snapshot_cursor_next(&cursor, &neighbor, NULL)) {
+            if (json) {
+                if (!first) printf(", ");
+                json_write_string(stdout, graph_snapshot_node_id(snapshot, neighbor));
+            } else {
+                printf("  <- %s\n", graph_snapshot_node_id(snapshot, neighbor));
+            }
+            first = false;
+        }
+        if (json) printf("]}");
+    }
+    if (json) {
+        printf("%s]\n}\n", first_node ? "" : "\n  ");
+    }
+    
+    graph_snapshot_close(snapshot);
+    return status;
+}
+
 int main(int argc, char* argv[]) {
     CliOptions options;
     
@@ -288,6 +1238,33 @@ int main(int argc, char* argv[]) {
         case CMD_FEATURE_DAG:
             result = cmd_feature_dag(&options);
             break;
+        case CMD_WAVES:
+            result = cmd_waves(&options);
+            break;
+        case CMD_PROTOS:
+            result = cmd_protos(&options);
+            break;
+        case CMD_DEPFILE:
+            result = cmd_depfile(&options);
+            break;
+        case CMD_MAKE:
+            result = cmd_make(&options);
+            break;
+        case CMD_MIGRATIONS:
+            result = cmd_migrations(&options);
+            break;
+        case CMD_SCRIPTS:
+            result = cmd_scripts(&options);
+            break;
+        case CMD_CI:
+            result = cmd_ci(&options);
+            break;
+        case CMD_IMAGES:
+            result = cmd_images(&options);
+            break;
+        case CMD_QUERY:
+            result = cmd_query(&options);
+            break;
         case CMD_HELP:
             print_usage(argv[0]);
             break;
@@ -0,0 +1,833 @@
+/**
+ * @file c_parser.c
+ * @brief C/C++ #include scanner, include-path resolver and depfile writer
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Finds #include directives in C/C++ sources without running the preprocessor,
+ *             resolves them against CMake include_directories and writes Make .d depfiles
+ * @llm-key One pass per file tracks comments, literals and a conditional stack: `#if 0` branches
+ *          are skipped, every other condition is assumed live; resolutions are cached per
+ *          (including directory, include spelling)
+ * @llm-contract Depfiles list the source and every project header reachable from it, like
+ *               `gcc -MM`; includes that resolve nowhere are treated as system headers
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+
+#define C_MAX_CONDITIONAL_DEPTH 64
+
+typedef struct {
+    const char* start;
+    size_t length;
+} CSpan;
+
+typedef enum {
+    COND_FALSE,                // #if 0
+    COND_TRUE,                 // #if 1
+    COND_UNKNOWN               // Anything the scanner cannot evaluate
+} CondValue;
+
+typedef struct {
+    bool parent_active;
+    bool active;
+    bool taken;                // A branch known to be true has been seen
+} CondFrame;
+
+typedef enum {
+    GUARD_NONE,                // No candidate yet
+    GUARD_IFNDEF,              // Saw #ifndef NAME as the first thing in the file
+    GUARD_DEFINED,             // ... followed by #define NAME
+    GUARD_CLOSED,              // ... and its #endif, with nothing after so far
+    GUARD_BROKEN
+} GuardState;
+
+typedef struct {
+    const char* p;
+    const char* end;
+    int line;
+    CSourceFile* file;
+    CondFrame frames[C_MAX_CONDITIONAL_DEPTH];
+    size_t depth;
+    size_t overflow;           // Conditionals nested beyond the frame stack, treated as live
+    GuardState guard_state;
+    CSpan guard;
+    bool code_seen;            // Tokens or directives before the guard candidate
+} CScanner;
+
+static bool c_is_ident_char(char c) {
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+static bool scanner_active(const CScanner* s) {
+    return s->depth == 0 || s->frames[s->depth - 1].active;
+}
+
+// Skips a /* */ comment starting at p
+static const char* skip_block_comment(CScanner* s, const char* p) {
+    p += 2;
+    while (p + 1 < s->end && !(p[0] == '*' && p[1] == '/')) {
+        if (*p == '\n') s->line++;
+        p++;
+    }
+    return p + 1 < s->end ? p + 2 : s->end;
+}
+
+// Skips horizontal whitespace, comments and line continuations inside a directive
+static const char* skip_directive_space(CScanner* s, const char* p) {
+    while (p < s->end) {
+        if (*p == ' ' || *p == '\t' || *p == '\f' || *p == '\v' || *p == '\r') {
+            p++;
+        } else if (*p == '\\' && p + 1 < s->end && p[1] == '\n') {
+            s->line++;
+            p += 2;
+        } else if (*p == '\\' && p + 2 < s->end && p[1] == '\r' && p[2] == '\n') {
+            s->line++;
+            p += 3;
+        } else if (*p == '/' && p + 1 < s->end && p[1] == '*') {
+            p = skip_block_comment(s, p);
+        } else {
+            break;
+        }
+    }
+    return p;
+}
+
+static CSpan read_identifier(CScanner* s, const char** cursor) {
+    const char* p = skip_directive_space(s, *cursor);
+    CSpan span = { p, 0 };
+    while (p < s->end && c_is_ident_char(*p)) p++;
+    span.length = (size_t)(p - span.start);
+    *cursor = p;
+    return span;
+}
+
+static bool span_is(CSpan span, const char* text) {
+    size_t length = strlen(text);
+    return span.length == length && memcmp(span.start, text, length) == 0;
+}
+
+static const char* skip_literal(CScanner* s, const char* p);
+
+// Moves to the newline ending the directive, honouring continuations and comments
+static const char* skip_directive_rest(CScanner* s, const char* p) {
+    while (p < s->end && *p != '\n') {
+        if (*p == '"' || *p == '\'') {
+            p = skip_literal(s, p);
+            continue;
+        }
+        if (*p == '\\' || *p == '/') {
+            const char* next = skip_directive_space(s, p);
+            if (next != p) {
+                p = next;
+                continue;
+            }
+            if (*p == '/' && p + 1 < s->end && p[1] == '/') {
+                while (p < s->end && *p != '\n') p++;
+                break;
+            }
+        }
+        p++;
+    }
+    return p;
+}
+
+// Only the literal conditions `0` and `1` (optionally parenthesized) are evaluated
+static CondValue evaluate_expression(CScanner* s, const char* p) {
+    p = skip_directive_space(s, p);
+    size_t parens = 0;
+    while (p < s->end && *p == '(') {
+        parens++;
+        p = skip_directive_space(s, p + 1);
+    }
+    if (p >= s->end || (*p != '0' && *p != '1')) return COND_UNKNOWN;
+    char digit = *p++;
+    if (p < s->end && (c_is_ident_char(*p) || *p == '.')) return COND_UNKNOWN;
+    p = skip_directive_space(s, p);
+    while (parens > 0 && p < s->end && *p == ')') {
+        parens--;
+        p = skip_directive_space(s, p + 1);
+    }
+    if (parens > 0) return COND_UNKNOWN;
+    if (p < s->end && *p != '\n' && !(*p == '/' && p + 1 < s->end && p[1] == '/')) return COND_UNKNOWN;
+    return digit == '1' ? COND_TRUE : COND_FALSE;
+}
+
+// Peeks at the condition; the directive is consumed afterwards, so line counting is undone
+static CondValue evaluate_condition(CScanner* s, const char* p) {
+    int line = s->line;
+    CondValue value = evaluate_expression(s, p);
+    s->line = line;
+    return value;
+}
+
+static void push_conditional(CScanner* s, CondValue value) {
+    if (s->depth >= C_MAX_CONDITIONAL_DEPTH) {
+        s->overflow++;
+        return;
+    }
+    bool parent = scanner_active(s);
+    CondFrame* frame = &s->frames[s->depth++];
+    frame->parent_active = parent;
+    frame->active = parent && value != COND_FALSE;
+    frame->taken = value == COND_TRUE;
+}
+
+static void next_branch(CScanner* s, CondValue value, bool is_else) {
+    if (s->overflow > 0 || s->depth == 0) return;
+    CondFrame* frame = &s->frames[s->depth - 1];
+    if (frame->taken) {
+        frame->active = false;
+    } else if (is_else) {
+        frame->active = frame->parent_active;
+    } else {
+        frame->active = frame->parent_active && value != COND_FALSE;
+        frame->taken = value == COND_TRUE;
+    }
+}
+
+static void pop_conditional(CScanner* s) {
+    if (s->overflow > 0) {
+        s->overflow--;
+    } else if (s->depth > 0) {
+        s->depth--;
+    }
+}
+
+static int add_include(CScanner* s, const char* p) {
+    int line = s->line;
+    p = skip_directive_space(s, p);
+    s->line = line;
+    if (p >= s->end || (*p != '"' && *p != '<')) return DEPTRACK_SUCCESS; // Computed include
+
+    char close = *p == '"' ? '"' : '>';
+    const char* start = ++p;
+    while (p < s->end && *p != close && *p != '\n') p++;
+    if (p >= s->end || *p != close || p == start) return DEPTRACK_SUCCESS;
+
+    CSourceFile* file = s->file;
+    CInclude* grown = realloc(file->includes, (file->include_count + 1) * sizeof(CInclude));
+    if (!grown) return DEPTRACK_ERROR_MEMORY;
+    file->includes = grown;
+
+    CInclude* inc = &file->includes[file->include_count];
+    inc->path = strndup(start, (size_t)(p - start));
+    if (!inc->path) return DEPTRACK_ERROR_MEMORY;
+    inc->system = close == '>';
+    inc->line_number = line;
+    file->include_count++;
+    return DEPTRACK_SUCCESS;
+}
+
+// Handles one directive; p is just past the '#'
+static int scan_directive(CScanner* s, const char* p) {
+    CSpan name = read_identifier(s, &p);
+    int result = DEPTRACK_SUCCESS;
+    GuardState guard_before = s->guard_state;
+
+    if (span_is(name, "if")) {
+        push_conditional(s, evaluate_condition(s, p));
+    } else if (span_is(name, "ifdef") || span_is(name, "ifndef")) {
+        CSpan macro = read_identifier(s, &p);
+        if (guard_before == GUARD_NONE && !s->code_seen && s->depth == 0 &&
+            span_is(name, "ifndef") && macro.length > 0) {
+            s->guard_state = GUARD_IFNDEF;
+            s->guard = macro;
+        }
+        push_conditional(s, COND_UNKNOWN);
+    } else if (span_is(name, "elif") || span_is(name, "elifdef") || span_is(name, "elifndef")) {
+        next_branch(s, span_is(name, "elif") ? evaluate_condition(s, p) : COND_UNKNOWN, false);
+    } else if (span_is(name, "else")) {
+        next_branch(s, COND_UNKNOWN, true);
+    } else if (span_is(name, "endif")) {
+        pop_conditional(s);
+        if (s->depth == 0 && s->overflow == 0 && s->guard_state == GUARD_DEFINED) {
+            s->guard_state = GUARD_CLOSED;
+        }
+    } else if (scanner_active(s)) {
+        if (span_is(name, "include") || span_is(name, "include_next") || span_is(name, "import")) {
+            result = add_include(s, p);
+        } else if (span_is(name, "define") && s->guard_state == GUARD_IFNDEF && s->depth == 1) {
+            CSpan macro = read_identifier(s, &p);
+            s->guard_state = macro.length == s->guard.length &&
+                             memcmp(macro.start, s->guard.start, macro.length) == 0 ? GUARD_DEFINED : GUARD_BROKEN;
+        } else if (span_is(name, "pragma")) {
+            CSpan pragma = read_identifier(s, &p);
+            if (span_is(pragma, "once")) s->file->pragma_once = true;
+        }
+    }
+
+    // The guard's #define must directly follow its #ifndef, and nothing may follow its #endif
+    if ((guard_before == GUARD_IFNDEF && s->guard_state == GUARD_IFNDEF) || guard_before == GUARD_CLOSED) {
+        s->guard_state = GUARD_BROKEN;
+    }
+    if (guard_before == GUARD_NONE && s->guard_state == GUARD_NONE) s->code_seen = true;
+
+    s->p = skip_directive_rest(s, p);
+    return result;
+}
+
+static const char* skip_literal(CScanner* s, const char* p) {
+    char quote = *p++;
+    while (p < s->end && *p != quote && *p != '\n') {
+        if (*p == '\\' && p + 1 < s->end) {
+            if (p[1] == '\n') s->line++;
+            p++;
+        }
+        p++;
+    }
+    return p < s->end && *p == quote ? p + 1 : p;
+}
+
+// C++11 raw string R"delim( ... )delim"; p points at the opening quote
+static const char* skip_raw_string(CScanner* s, const char* p) {
+    const char* delim = ++p;
+    while (p < s->end && *p != '(' && *p != '\n' && p - delim < 16) p++;
+    if (p >= s->end || *p != '(') return p;
+    size_t delim_length = (size_t)(p - delim);
+    for (p++; p < s->end; p++) {
+        if (*p == '\n') {
+            s->line++;
+        } else if (*p == ')' && (size_t)(s->end - p) > delim_length + 1 &&
+                   memcmp(p + 1, delim, delim_length) == 0 && p[1 + delim_length] == '"') {
+            return p + delim_length + 2;
+        }
+    }
+    return p;
+}
+
+CSourceFile* c_scan_buffer(const char* filepath, const char* buffer, size_t length) {
+    if (!buffer) return NULL;
+
+    CSourceFile* file = calloc(1, sizeof(CSourceFile));
+    if (!file) return NULL;
+    file->filepath = strdup(filepath ? filepath : "");
+    if (!file->filepath) {
+        free(file);
+        return NULL;
+    }
+
+    CScanner s;
+    memset(&s, 0, sizeof(s));
+    s.p = buffer;
+    s.end = buffer + length;
+    s.line = 1;
+    s.file = file;
+
+    bool line_start = true;
+    int result = DEPTRACK_SUCCESS;
+    while (result == DEPTRACK_SUCCESS && s.p < s.end) {
+        const char* p = s.p;
+        char c = *p;
+
+        if (c == '\n') {
+            s.line++;
+            line_start = true;
+            s.p++;
+        } else if (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+            s.p = p + 1;
+        } else if (c == '\\' && skip_directive_space(&s, p) != p) {
+            s.p = skip_directive_space(&s, p);
+        } else if (c == '/' && p + 1 < s.end && p[1] == '*') {
+            s.p = skip_block_comment(&s, p);
+        } else if (c == '/' && p + 1 < s.end && p[1] == '/') {
+            while (p < s.end && *p != '\n') {
+                if (*p == '\\' && p + 1 < s.end && p[1] == '\n') {
+                    s.line++;
+                    p++;
+                }
+                p++;
+            }
+            s.p = p;
+        } else if (c == '#' && line_start) {
+            result = scan_directive(&s, p + 1);
+        } else {
+            line_start = false;
+            if (s.depth == 0 && s.overflow == 0) {
+                s.code_seen = true;
+                if (s.guard_state == GUARD_CLOSED) s.guard_state = GUARD_BROKEN;
+            }
+            if (c == '\'' && p > buffer && isalnum((unsigned char)p[-1])) {
+                s.p = p + 1; // C++14 digit separator
+            } else if (c == '"' || c == '\'') {
+                s.p = skip_literal(&s, p);
+            } else if (c == 'R' && p + 1 < s.end && p[1] == '"' && (p == buffer || !c_is_ident_char(p[-1]) ||
+                       p[-1] == 'u' || p[-1] == 'U' || p[-1] == 'L' || p[-1] == '8')) {
+                s.p = skip_raw_string(&s, p + 1);
+            } else if (c_is_ident_char(c)) {
+                while (p < s.end && c_is_ident_char(*p)) p++;
+                s.p = p;
+            } else {
+                s.p = p + 1;
+            }
+        }
+    }
+
+    if (result != DEPTRACK_SUCCESS) {
+        c_source_destroy(file);
+        return NULL;
+    }
+
+    if (s.guard_state == GUARD_CLOSED) {
+        file->guard = strndup(s.guard.start, s.guard.length);
+    }
+    return file;
+}
+
+CSourceFile* c_scan_file(const char* filepath) {
+    size_t length;
+    char* buffer = parser_read_file(filepath, &length);
+    if (!buffer) return NULL;
+
+    CSourceFile* file = c_scan_buffer(filepath, buffer, length);
+    free(buffer);
+    return file;
+}
+
+void c_source_destroy(CSourceFile* file) {
+    if (!file) return;
+
+    for (size_t i = 0; i < file->include_count; i++) {
+        free(file->includes[i].path);
+    }
+    free(file->includes);
+    free(file->guard);
+    free(file->filepath);
+    free(file);
+}
+
+bool c_is_source(const char* filepath) {
+    static const char* extensions[] = {
+        ".c", ".h", ".cc", ".cpp", ".cxx", ".hh", ".hpp", ".hxx", ".inl", NULL
+    };
+    for (size_t i = 0; extensions[i]; i++) {
+        if (file_has_suffix(filepath, extensions[i])) return true;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Include resolution
+// ---------------------------------------------------------------------------
+
+static size_t directory_length(const char* filepath) {
+    const char* slash = strrchr(filepath, '/');
+    return slash ? (size_t)(slash - filepath) : 0;
+}
+
+CIncludeResolver* c_resolver_create(void) {
+    CIncludeResolver* resolver = calloc(1, sizeof(CIncludeResolver));
+    if (!resolver) return NULL;
+
+    resolver->lookup_cache = hashmap_create(1024);
+    resolver->by_path = hashmap_create(1024);
+    if (!resolver->lookup_cache || !resolver->by_path) {
+        c_resolver_destroy(resolver);
+        return NULL;
+    }
+    return resolver;
+}
+
+void c_resolver_destroy(CIncludeResolver* resolver) {
+    if (!resolver) return;
+
+    for (size_t i = 0; i < resolver->include_dir_count; i++) {
+        free(resolver->include_dirs[i]);
+    }
+    free(resolver->include_dirs);
+    for (size_t i = 0; i < resolver->file_count; i++) {
+        free(resolver->paths[i]);
+        c_source_destroy(resolver->files[i]);
+    }
+    free(resolver->paths);
+    free(resolver->files);
+    hashmap_destroy(resolver->lookup_cache);
+    hashmap_destroy(resolver->by_path);
+    free(resolver);
+}
+
+int c_resolver_add_include_dir(CIncludeResolver* resolver, const char* dir) {
+    if (!resolver || !dir || !*dir) return DEPTRACK_ERROR_INVALID_PARAM;
+
+    char normalized[MAX_PATH_LENGTH];
+    if (snprintf(normalized, sizeof(normalized), "%s", dir) >= (int)sizeof(normalized)) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+    file_normalize_path(normalized);
+    for (size_t i = 0; i < resolver->include_dir_count; i++) {
+        if (strcmp(resolver->include_dirs[i], normalized) == 0) return DEPTRACK_SUCCESS;
+    }
+
+    char** grown = realloc(resolver->include_dirs, (resolver->include_dir_count + 1) * sizeof(char*));
+    if (!grown) return DEPTRACK_ERROR_MEMORY;
+    resolver->include_dirs = grown;
+    resolver->include_dirs[resolver->include_dir_count] = strdup(normalized);
+    if (!resolver->include_dirs[resolver->include_dir_count]) return DEPTRACK_ERROR_MEMORY;
+    resolver->include_dir_count++;
+    return DEPTRACK_SUCCESS;
+}
+
+// Interns a normalized file path; the file is scanned lazily
+static size_t intern_path(CIncludeResolver* resolver, const char* path) {
+    size_t index;
+    if (hashmap_get(resolver->by_path, path, &index) == 0) return index;
+
+    if (resolver->file_count >= resolver->file_capacity) {
+        size_t capacity = resolver->file_capacity ? resolver->file_capacity * 2 : 64;
+        char** paths = realloc(resolver->paths, capacity * sizeof(char*));
+        if (!paths) return SIZE_MAX;
+        resolver->paths = paths;
+        CSourceFile** files = realloc(resolver->files, capacity * sizeof(CSourceFile*));
+        if (!files) return SIZE_MAX;
+        resolver->files = files;
+        resolver->file_capacity = capacity;
+    }
+
+    index = resolver->file_count;
+    resolver->paths[index] = strdup(path);
+    resolver->files[index] = NULL;
+    if (!resolver->paths[index] || hashmap_put(resolver->by_path, path, index) != 0) {
+        free(resolver->paths[index]);
+        return SIZE_MAX;
+    }
+    resolver->file_count++;
+    return index;
+}
+
+static bool is_regular_file(const char* path) {
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+static size_t try_candidate(CIncludeResolver* resolver, const char* dir, size_t dir_length, const char* name) {
+    char candidate[MAX_PATH_LENGTH];
+    int written = dir_length > 0
+        ? snprintf(candidate, sizeof(candidate), "%.*s/%s", (int)dir_length, dir, name)
+        : snprintf(candidate, sizeof(candidate), "%s", name);
+    if (written <= 0 || (size_t)written >= sizeof(candidate)) return SIZE_MAX;
+
+    file_normalize_path(candidate);
+    size_t index;
+    if (hashmap_get(resolver->by_path, candidate, &index) == 0) return index;
+    resolver->stat_count++;
+    return is_regular_file(candidate) ? intern_path(resolver, candidate) : SIZE_MAX;
+}
+
+size_t c_resolver_resolve(CIncludeResolver* resolver, const char* including_file, const CInclude* inc) {
+    if (!resolver || !inc || !inc->path) return SIZE_MAX;
+    if (inc->path[0] == '/') {
+        return is_regular_file(inc->path) ? intern_path(resolver, inc->path) : SIZE_MAX;
+    }
+
+    // Quoted includes search the including directory first, so the key carries it;
+    // angle includes resolve the same from everywhere
+    size_t dir_length = including_file && !inc->system ? directory_length(including_file) : 0;
+    char key[MAX_PATH_LENGTH * 2];
+    int written = snprintf(key, sizeof(key), "%c%.*s\n%s", inc->system ? '<' : '"', (int)dir_length,
+                           including_file ? including_file : "", inc->path);
+    if (written <= 0 || (size_t)written >= sizeof(key)) return SIZE_MAX;
+
+    size_t index;
+    if (hashmap_get_n(resolver->lookup_cache, key, (size_t)written, &index) == 0) {
+        resolver->cache_hits++;
+        return index;
+    }
+
+    index = SIZE_MAX;
+    if (!inc->system && including_file) {
+        index = try_candidate(resolver, including_file, dir_length, inc->path);
+    }
+    for (size_t i = 0; index == SIZE_MAX && i < resolver->include_dir_count; i++) {
+        const char* dir = resolver->include_dirs[i];
+        index = try_candidate(resolver, dir, strlen(dir), inc->path);
+    }
+
+    hashmap_put_n(resolver->lookup_cache, key, (size_t)written, index);
+    return index;
+}
+
+const CSourceFile* c_resolver_scan(CIncludeResolver* resolver, size_t index) {
+    if (!resolver || index >= resolver->file_count) return NULL;
+    if (!resolver->files[index]) {
+        resolver->files[index] = c_scan_file(resolver->paths[index]);
+    }
+    return resolver->files[index];
+}
+
+int c_resolver_dependencies(CIncludeResolver* resolver, const char* source, size_t** out_files, size_t* out_count) {
+    if (!resolver || !source || !out_files || !out_count) return DEPTRACK_ERROR_INVALID_PARAM;
+    *out_files = NULL;
+    *out_count = 0;
+
+    char normalized[MAX_PATH_LENGTH];
+    if (snprintf(normalized, sizeof(normalized), "%s", source) >= (int)sizeof(normalized)) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+    file_normalize_path(normalized);
+    size_t root = intern_path(resolver, normalized);
+    if (root == SIZE_MAX) return DEPTRACK_ERROR_MEMORY;
+    if (!c_resolver_scan(resolver, root)) return DEPTRACK_ERROR_FILE_NOT_FOUND;
+
+    // Breadth-first over the include graph; the list doubles as the queue
+    size_t capacity = 16;
+    size_t count = 0;
+    size_t* files = malloc(capacity * sizeof(size_t));
+    bool* seen = calloc(resolver->file_count + 1, sizeof(bool));
+    size_t seen_capacity = resolver->file_count + 1;
+    if (!files || !seen) {
+        free(files);
+        free(seen);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+    files[count++] = root;
+    seen[root] = true;
+
+    int result = DEPTRACK_SUCCESS;
+    for (size_t head = 0; head < count && result == DEPTRACK_SUCCESS; head++) {
+        const CSourceFile* file = c_resolver_scan(resolver, files[head]);
+        for (size_t i = 0; file && i < file->include_count; i++) {
+            size_t target = c_resolver_resolve(resolver, resolver->paths[files[head]], &file->includes[i]);
+            if (target == SIZE_MAX) continue;
+
+            if (target >= seen_capacity) {
+                size_t grown_capacity = resolver->file_count + 16;
+                bool* grown = realloc(seen, grown_capacity * sizeof(bool));
+                if (!grown) {
+                    result = DEPTRACK_ERROR_MEMORY;
+                    break;
+                }
+                memset(grown + seen_capacity, 0, (grown_capacity - seen_capacity) * sizeof(bool));
+                seen = grown;
+                seen_capacity = grown_capacity;
+            }
+            if (seen[target]) continue;
+            seen[target] = true;
+
+            if (count >= capacity) {
+                size_t* grown = realloc(files, capacity * 2 * sizeof(size_t));
+                if (!grown) {
+                    result = DEPTRACK_ERROR_MEMORY;
+                    break;
+                }
+                files = grown;
+                capacity *= 2;
+            }
+            files[count++] = target;
+        }
+    }
+
+    free(seen);
+    if (result != DEPTRACK_SUCCESS) {
+        free(files);
+        return result;
+    }
+    *out_files = files;
+    *out_count = count;
+    return DEPTRACK_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// CMakeLists.txt include_directories
+// ---------------------------------------------------------------------------
+
+static const char* cmake_keywords[] = {
+    "BEFORE", "AFTER", "SYSTEM", "PUBLIC", "PRIVATE", "INTERFACE", NULL
+};
+
+static bool is_cmake_keyword(const char* arg) {
+    for (size_t i = 0; cmake_keywords[i]; i++) {
+        if (strcmp(arg, cmake_keywords[i]) == 0) return true;
+    }
+    return false;
+}
+
+// Expands source-directory variables; returns false for anything else (binary dirs, user variables)
+static bool expand_cmake_path(const char* arg, const char* cmake_dir, char* out, size_t size) {
+    static const char* source_vars[] = {
+        "${CMAKE_CURRENT_SOURCE_DIR}", "${CMAKE_SOURCE_DIR}", "${PROJECT_SOURCE_DIR}",
+        "${CMAKE_CURRENT_LIST_DIR}", NULL
+    };
+
+    // $<BUILD_INTERFACE:dir> contributes dir; other generator expressions are skipped
+    char inner[MAX_PATH_LENGTH];
+    const char* bi = "$<BUILD_INTERFACE:";
+    if (strncmp(arg, bi, strlen(bi)) == 0) {
+        snprintf(inner, sizeof(inner), "%s", arg + strlen(bi));
+        char* close = strrchr(inner, '>');
+        if (!close) return false;
+        *close = '\0';
+        arg = inner;
+    } else if (strncmp(arg, "$<", 2) == 0) {
+        return false;
+    }
+
+    const char* rest = arg;
+    for (size_t i = 0; source_vars[i]; i++) {
+        size_t var_length = strlen(source_vars[i]);
+        if (strncmp(arg, source_vars[i], var_length) == 0) {
+            rest = arg + var_length;
+            while (*rest == '/') rest++;
+            break;
+        }
+    }
+    if (strchr(rest, '$')) return false;
+
+    int written;
+    if (rest == arg && arg[0] == '/') {
+        written = snprintf(out, size, "%s", arg);
+    } else if (*rest) {
+        written = snprintf(out, size, "%s/%s", cmake_dir, rest);
+    } else {
+        written = snprintf(out, size, "%s", cmake_dir);
+    }
+    return written > 0 && (size_t)written < size;
+}
+
+int c_resolver_load_cmake(CIncludeResolver* resolver, const char* cmakelists_path) {
+    if (!resolver || !cmakelists_path) return DEPTRACK_ERROR_INVALID_PARAM;
+
+    size_t length;
+    char* buffer = parser_read_file(cmakelists_path, &length);
+    if (!buffer) return DEPTRACK_ERROR_FILE_NOT_FOUND;
+
+    char cmake_dir[MAX_PATH_LENGTH];
+    size_t dir_length = directory_length(cmakelists_path);
+    snprintf(cmake_dir, sizeof(cmake_dir), "%.*s", (int)dir_length, dir_length ? cmakelists_path : ".");
+
+    int result = DEPTRACK_SUCCESS;
+    const char* p = buffer;
+    const char* end = buffer + length;
+    while (p < end && result == DEPTRACK_SUCCESS) {
+        if (*p == '#') {
+            while (p < end && *p != '\n') p++;
+            continue;
+        }
+        if (!isalpha((unsigned char)*p) && *p != '_') {
+            p++;
+            continue;
+        }
+
+        // Command name, compared case-insensitively as CMake does
+        const char* name = p;
+        while (p < end && (isalnum((unsigned char)*p) || *p == '_')) p++;
+        size_t name_length = (size_t)(p - name);
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        if (p >= end || *p != '(') continue;
+
+        bool plain = name_length == 19 && strncasecmp(name, "include_directories", 19) == 0;
+        bool target = name_length == 26 && strncasecmp(name, "target_include_directories", 26) == 0;
+        p++;
+
+        size_t arg_index = 0;
+        while (p < end && *p != ')') {
+            if (isspace((unsigned char)*p)) {
+                p++;
+                continue;
+            }
+            if (*p == '#') {
+                while (p < end && *p != '\n') p++;
+                continue;
+            }
+
+            char arg[MAX_PATH_LENGTH];
+            size_t arg_length = 0;
+            if (*p == '"') {
+                for (p++; p < end && *p != '"'; p++) {
+                    if (arg_length + 1 < sizeof(arg)) arg[arg_length++] = *p;
+                }
+                if (p < end) p++;
+            } else {
+                int angle = 0;     // Generator expressions may contain ')' only inside $<...>
+                while (p < end && !isspace((unsigned char)*p) && (*p != ')' || angle > 0)) {
+                    if (*p == '<' && arg_length > 0 && arg[arg_length - 1] == '$') angle++;
+                    else if (*p == '>' && angle > 0) angle--;
+                    if (arg_length + 1 < sizeof(arg)) arg[arg_length++] = *p;
+                    p++;
+                }
+            }
+            arg[arg_length] = '\0';
+
+            bool skip = (target && arg_index == 0) || is_cmake_keyword(arg);
+            arg_index++;
+            if ((plain || target) && !skip) {
+                char dir[MAX_PATH_LENGTH];
+                if (expand_cmake_path(arg, cmake_dir, dir, sizeof(dir))) {
+                    result = c_resolver_add_include_dir(resolver, dir);
+                }
+            }
+        }
+        if (p < end) p++;
+    }
+
+    free(buffer);
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Depfiles
+// ---------------------------------------------------------------------------
+
+// Make needs spaces and '#' backslash-escaped and '$' doubled
+static void write_make_path(FILE* out, const char* path) {
+    for (const char* p = path; *p; p++) {
+        if (*p == ' ' || *p == '#') fputc('\\', out);
+        else if (*p == '$') fputc('$', out);
+        fputc(*p, out);
+    }
+}
+
+int c_write_depfile(CIncludeResolver* resolver, const char* target, const char* source,
+                    bool phony_headers, FILE* out) {
+    if (!resolver || !target || !source || !out) return DEPTRACK_ERROR_INVALID_PARAM;
+
+    size_t* files;
+    size_t count;
+    int result = c_resolver_dependencies(resolver, source, &files, &count);
+    if (result != DEPTRACK_SUCCESS) return result;
+
+    write_make_path(out, target);
+    fputc(':', out);
+    for (size_t i = 0; i < count; i++) {
+        fputs(i ? " \\\n " : " ", out);
+        write_make_path(out, resolver->paths[files[i]]);
+    }
+    fputc('\n', out);
+
+    // Like gcc -MP: deleted headers then do not break the build
+    for (size_t i = 1; phony_headers && i < count; i++) {
+        fputc('\n', out);
+        write_make_path(out, resolver->paths[files[i]]);
+        fputs(":\n", out);
+    }
+
+    free(files);
+    return ferror(out) ? DEPTRACK_ERROR_FILE_NOT_FOUND : DEPTRACK_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// ParsedFile adapter
+// ---------------------------------------------------------------------------
+
+ParsedFile* parse_c_buffer(const char* filepath, const char* buffer, size_t length) {
+    CSourceFile* file = c_scan_buffer(filepath, buffer, length);
+    if (!file) return NULL;
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_C);
+    for (size_t i = 0; parsed && i < file->include_count; i++) {
+        const CInclude* inc = &file->includes[i];
+        // Quoted includes are project headers; angle includes come from the toolchain or a package
+        DependencyType type = inc->system ? DEP_EXTERNAL : DEP_INTERNAL;
+        parsed_file_add_dependency(parsed, inc->path, strlen(inc->path), NULL, type, inc->line_number);
+    }
+
+    c_source_destroy(file);
+    return parsed;
+}
+
+ParsedFile* parse_c_file(const char* filepath) {
+    return parser_parse_file(filepath, parse_c_buffer);
+}
@@ -0,0 +1,809 @@
+/**
+ * @file ci_parser.c
+ * @brief CI workflow parser: jobs, needs, path filters and step scripts
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Reads GitHub Actions style workflows (build/ci/workflows, .github/workflows, ci-config.yml)
+ *             into a job graph, so the critical path and the jobs a change really requires can be computed
+ * @llm-key Single pass over lines keeping a stack of mapping keys by indentation; block scalars are
+ *          joined so `run: |` scripts reach the shell scanner, which turns them into script references
+ * @llm-map ci_workflow_schedule feeds dag_schedule_compute; ci_workflow_required_jobs answers "does this
+ *          push need that job"
+ * @llm-contract Jobs without a path filter are assumed to depend on everything and always run; only
+ *               push and pull_request triggers take part in change-based selection
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <string.h>
+
+#define CI_MAX_DEPTH 32
+#define CI_DEFAULT_TIMEOUT_MINUTES 360
+
+typedef struct {
+    const char* start;
+    const char* end;
+} CiSpan;
+
+typedef struct {
+    int indent;
+    CiSpan key;
+} CiFrame;
+
+typedef struct {
+    CiWorkflow* workflow;
+    CiFrame frames[CI_MAX_DEPTH];
+    size_t depth;
+    CiTrigger* trigger;        // Event whose filters are being read
+    bool failed;
+} CiParser;
+
+static bool span_is(CiSpan span, const char* literal) {
+    size_t length = strlen(literal);
+    return (size_t)(span.end - span.start) == length && memcmp(span.start, literal, length) == 0;
+}
+
+static CiSpan span_trim(CiSpan span) {
+    while (span.start < span.end && isspace((unsigned char)*span.start)) span.start++;
+    while (span.end > span.start && isspace((unsigned char)span.end[-1])) span.end--;
+    return span;
+}
+
+static CiSpan span_unquote(CiSpan span) {
+    span = span_trim(span);
+    if (span.end - span.start >= 2 && (*span.start == '"' || *span.start == '\'') && span.end[-1] == *span.start) {
+        span.start++;
+        span.end--;
+    }
+    return span;
+}
+
+static const char* strip_comment(const char* p, const char* end) {
+    char quote = 0;
+    for (const char* c = p; c < end; c++) {
+        if (quote) {
+            if (*c == quote) quote = 0;
+        } else if (*c == '"' || *c == '\'') {
+            quote = *c;
+        } else if (*c == '#' && (c == p || c[-1] == ' ' || c[-1] == '\t')) {
+            return c;
+        }
+    }
+    return end;
+}
+
+static bool split_key(CiSpan line, CiSpan* key, CiSpan* value) {
+    char quote = 0;
+    for (const char* c = line.start; c < line.end; c++) {
+        if (quote) {
+            if (*c == quote) quote = 0;
+        } else if (*c == '"' || *c == '\'') {
+            quote = *c;
+        } else if (*c == ':' && (c + 1 == line.end || c[1] == ' ' || c[1] == '\t')) {
+            *key = span_unquote((CiSpan){ line.start, c });
+            *value = span_trim((CiSpan){ c + 1, line.end });
+            return key->start < key->end;
+        }
+    }
+    return false;
+}
+
+static bool list_add(CiParser* p, char*** list, size_t* count, CiSpan value) {
+    value = span_unquote(value);
+    if (value.start >= value.end) return true;
+    char** grown = realloc(*list, (*count + 1) * sizeof(char*));
+    if (!grown || !(grown[*count] = strndup(value.start, (size_t)(value.end - value.start)))) {
+        if (grown) *list = grown;
+        p->failed = true;
+        return false;
+    }
+    *list = grown;
+    (*count)++;
+    return true;
+}
+
+// "[a, 'b']" adds each element; a plain scalar adds itself
+static void list_add_value(CiParser* p, char*** list, size_t* count, CiSpan value) {
+    if (value.start < value.end && *value.start == '[') {
+        const char* c = value.start + 1;
+        const char* end = value.end > c && value.end[-1] == ']' ? value.end - 1 : value.end;
+        while (c < end) {
+            const char* comma = memchr(c, ',', (size_t)(end - c));
+            const char* stop = comma ? comma : end;
+            if (!list_add(p, list, count, (CiSpan){ c, stop })) return;
+            c = stop + 1;
+        }
+    } else {
+        list_add(p, list, count, value);
+    }
+}
+
+static void set_string(CiParser* p, char** field, CiSpan value, const char* block) {
+    char* copy = block ? strdup(block) : NULL;
+    if (!block) {
+        value = span_unquote(value);
+        copy = strndup(value.start, (size_t)(value.end - value.start));
+    }
+    if (!copy) {
+        p->failed = true;
+        return;
+    }
+    free(*field);
+    *field = copy;
+}
+
+static bool frame_is(const CiParser* p, size_t index, const char* name) {
+    return index < p->depth && span_is(p->frames[index].key, name);
+}
+
+static CiJob* current_job(CiParser* p) {
+    return p->workflow->job_count ? &p->workflow->jobs[p->workflow->job_count - 1] : NULL;
+}
+
+static CiStep* current_step(CiParser* p) {
+    CiJob* job = current_job(p);
+    return job && job->step_count ? &job->steps[job->step_count - 1] : NULL;
+}
+
+static void add_trigger(CiParser* p, CiSpan event) {
+    event = span_unquote(event);
+    if (event.start >= event.end) return;
+    CiWorkflow* wf = p->workflow;
+    CiTrigger* grown = realloc(wf->triggers, (wf->trigger_count + 1) * sizeof(CiTrigger));
+    if (!grown) {
+        p->failed = true;
+        return;
+    }
+    wf->triggers = grown;
+    CiTrigger* trigger = &wf->triggers[wf->trigger_count];
+    memset(trigger, 0, sizeof(CiTrigger));
+    if (!(trigger->event = strndup(event.start, (size_t)(event.end - event.start)))) {
+        p->failed = true;
+        return;
+    }
+    wf->trigger_count++;
+    p->trigger = trigger;
+}
+
+static void add_job(CiParser* p, CiSpan id, int line) {
+    CiWorkflow* wf = p->workflow;
+    if (wf->job_count >= wf->job_capacity) {
+        size_t capacity = wf->job_capacity ? wf->job_capacity * 2 : 8;
+        CiJob* grown = realloc(wf->jobs, capacity * sizeof(CiJob));
+        if (!grown) {
+            p->failed = true;
+            return;
+        }
+        wf->jobs = grown;
+        wf->job_capacity = capacity;
+    }
+    CiJob* job = &wf->jobs[wf->job_count];
+    memset(job, 0, sizeof(CiJob));
+    job->line_number = line;
+    if (!(job->id = strndup(id.start, (size_t)(id.end - id.start))) ||
+        hashmap_put(wf->by_id, job->id, wf->job_count) != 0) {
+        free(job->id);
+        p->failed = true;
+        return;
+    }
+    wf->job_count++;
+}
+
+static void add_step(CiParser* p, int line) {
+    CiJob* job = current_job(p);
+    if (!job) return;
+    CiStep* grown = realloc(job->steps, (job->step_count + 1) * sizeof(CiStep));
+    if (!grown) {
+        p->failed = true;
+        return;
+    }
+    job->steps = grown;
+    memset(&job->steps[job->step_count], 0, sizeof(CiStep));
+    job->steps[job->step_count++].line_number = line;
+}
+
+static void handle_key(CiParser* p, CiSpan key, CiSpan value, const char* block, int line) {
+    CiWorkflow* wf = p->workflow;
+
+    if (p->depth == 0) {
+        if (span_is(key, "name")) {
+            set_string(p, &wf->name, value, block);
+        } else if (span_is(key, "on") && value.start < value.end) {
+            // on: push, on: [push, pull_request]
+            char** events = NULL;
+            size_t count = 0;
+            list_add_value(p, &events, &count, value);
+            for (size_t i = 0; i < count; i++) {
+                add_trigger(p, (CiSpan){ events[i], events[i] + strlen(events[i]) });
+                free(events[i]);
+            }
+            free(events);
+        }
+        return;
+    }
+
+    if (frame_is(p, 0, "on")) {
+        if (p->depth == 1) {
+            add_trigger(p, key);
+        } else if (p->depth == 2 && p->trigger && span_is(key, "paths")) {
+            list_add_value(p, &p->trigger->paths, &p->trigger->path_count, value);
+        } else if (p->depth == 2 && p->trigger && span_is(key, "paths-ignore")) {
+            list_add_value(p, &p->trigger->paths_ignore, &p->trigger->paths_ignore_count, value);
+        }
+        return;
+    }
+
+    if (!frame_is(p, 0, "jobs")) return;
+    if (p->depth == 1) {
+        add_job(p, key, line);
+        return;
+    }
+
+    CiJob* job = current_job(p);
+    if (!job) return;
+    if (p->depth == 2) {
+        if (span_is(key, "name")) {
+            set_string(p, &job->name, value, block);
+        } else if (span_is(key, "needs")) {
+            list_add_value(p, &job->needs, &job->need_count, value);
+        } else if (span_is(key, "if")) {
+            set_string(p, &job->condition, value, block);
+        } else if (span_is(key, "timeout-minutes")) {
+            job->timeout_minutes = atoi(span_unquote(value).start);
+        } else if ((span_is(key, "paths") || span_is(key, "changes")) && value.start < value.end) {
+            list_add_value(p, &job->paths, &job->path_count, value);
+        }
+        return;
+    }
+
+    CiStep* step = current_step(p);
+    if (p->depth == 3 && frame_is(p, 2, "steps") && step) {
+        if (span_is(key, "name")) set_string(p, &step->name, value, block);
+        else if (span_is(key, "uses")) set_string(p, &step->uses, value, block);
+        else if (span_is(key, "run")) set_string(p, &step->run, value, block);
+        else if (span_is(key, "working-directory")) set_string(p, &step->working_directory, value, block);
+    }
+}
+
+static void handle_item(CiParser* p, CiSpan value, int line) {
+    if (p->depth == 3 && frame_is(p, 0, "on") && p->trigger) {
+        if (frame_is(p, 2, "paths")) list_add(p, &p->trigger->paths, &p->trigger->path_count, value);
+        else if (frame_is(p, 2, "paths-ignore")) {
+            list_add(p, &p->trigger->paths_ignore, &p->trigger->paths_ignore_count, value);
+        }
+        return;
+    }
+
+    CiJob* job = current_job(p);
+    if (p->depth != 3 || !frame_is(p, 0, "jobs") || !job) return;
+    if (frame_is(p, 2, "needs")) {
+        list_add(p, &job->needs, &job->need_count, value);
+    } else if (frame_is(p, 2, "paths") || frame_is(p, 2, "changes")) {
+        list_add(p, &job->paths, &job->path_count, value);
+    } else if (frame_is(p, 2, "steps")) {
+        add_step(p, line);
+    }
+}
+
+// Reads the block scalar after an indicator line; *next advances past it
+static char* read_block_scalar(const char* indicator_end, const char* end, int parent_indent, bool folded,
+                               const char** next, int* line_number) {
+    const char* p = indicator_end;
+    size_t capacity = 256, length = 0;
+    char* text = malloc(capacity);
+    if (!text) return NULL;
+    int content_indent = -1;
+
+    while (p < end) {
+        const char* line_end = memchr(p, '\n', (size_t)(end - p));
+        if (!line_end) line_end = end;
+        int indent = 0;
+        const char* c = p;
+        while (c < line_end && *c == ' ') {
+            c++;
+            indent++;
+        }
+        bool blank = true;
+        for (const char* b = c; b < line_end; b++) blank = blank && isspace((unsigned char)*b);
+        if (!blank && indent <= parent_indent) break;
+        if (!blank && content_indent < 0) content_indent = indent;
+
+        const char* body = blank ? line_end : p + (content_indent > 0 ? content_indent : 0);
+        size_t body_length = (size_t)(line_end - body);
+        if (body_length > 0 && body[body_length - 1] == '\r') body_length--;
+        if (length + body_length + 2 > capacity) {
+            while (length + body_length + 2 > capacity) capacity *= 2;
+            char* grown = realloc(text, capacity);
+            if (!grown) {
+                free(text);
+                return NULL;
+            }
+            text = grown;
+        }
+        memcpy(text + length, body, body_length);
+        length += body_length;
+        text[length++] = folded && !blank ? ' ' : '\n';
+        (*line_number)++;
+        p = line_end < end ? line_end + 1 : end;
+    }
+    text[length] = '\0';
+    *next = p;
+    return text;
+}
+
+static bool is_block_indicator(CiSpan value) {
+    if (value.start >= value.end || (*value.start != '|' && *value.start != '>')) return false;
+    for (const char* c = value.start + 1; c < value.end; c++) {
+        if (*c != '-' && *c != '+' && !isdigit((unsigned char)*c)) return false;
+    }
+    return true;
+}
+
+static void push_frame(CiParser* p, int indent, CiSpan key) {
+    if (p->depth < CI_MAX_DEPTH) {
+        p->frames[p->depth++] = (CiFrame){ indent, key };
+    }
+}
+
+// Every file a run step executes or sources, relative to the checkout root
+static void collect_scripts(CiParser* p, const char* root, CiJob* job) {
+    for (size_t s = 0; s < job->step_count; s++) {
+        const CiStep* step = &job->steps[s];
+        if (!step->run) continue;
+
+        size_t length = strlen(step->run) + (step->working_directory ? strlen(step->working_directory) + 8 : 0);
+        char* script_text = malloc(length + 1);
+        if (!script_text) {
+            p->failed = true;
+            return;
+        }
+        if (step->working_directory) snprintf(script_text, length + 1, "cd '%s'\n%s", step->working_directory, step->run);
+        else snprintf(script_text, length + 1, "%s", step->run);
+
+        ShellScript* script = shell_scan_buffer(root, p->workflow->filepath, script_text, strlen(script_text));
+        free(script_text);
+        for (size_t r = 0; script && r < script->reference_count; r++) {
+            const char* path = script->references[r].path;
+            bool seen = false;
+            for (size_t i = 0; i < job->script_count && !seen; i++) seen = strcmp(job->scripts[i], path) == 0;
+            if (!seen) list_add(p, &job->scripts, &job->script_count, (CiSpan){ path, path + strlen(path) });
+        }
+        shell_script_destroy(script);
+    }
+}
+
+CiWorkflow* ci_workflow_parse_buffer(const char* root, const char* filepath, const char* buffer, size_t length) {
+    if (!filepath || !buffer) {
+        return NULL;
+    }
+
+    CiParser parser;
+    memset(&parser, 0, sizeof(parser));
+    CiWorkflow* wf = calloc(1, sizeof(CiWorkflow));
+    parser.workflow = wf;
+    if (!wf || !(wf->filepath = strdup(filepath)) || !(wf->by_id = hashmap_create(64))) {
+        ci_workflow_destroy(wf);
+        return NULL;
+    }
+
+    const char* p = buffer;
+    const char* end = buffer + length;
+    int line_number = 0;
+    while (p < end && !parser.failed) {
+        const char* line_end = memchr(p, '\n', (size_t)(end - p));
+        if (!line_end) line_end = end;
+        const char* next = line_end < end ? line_end + 1 : end;
+        line_number++;
+
+        int indent = 0;
+        const char* c = p;
+        while (c < line_end && (*c == ' ' || *c == '\t')) {
+            c++;
+            indent++;
+        }
+        CiSpan content = span_trim((CiSpan){ c, strip_comment(c, line_end) });
+        p = next;
+        if (content.start >= content.end || span_is(content, "---")) continue;
+
+        int line = line_number;
+        int key_indent = indent;
+        bool is_item = *content.start == '-' && (content.end - content.start == 1 || content.start[1] == ' ');
+        if (is_item) {
+            while (parser.depth > 0 && parser.frames[parser.depth - 1].indent > indent) parser.depth--;
+            CiSpan rest = span_trim((CiSpan){ content.start + 1, content.end });
+            CiSpan key, value;
+            bool inline_key = split_key(rest, &key, &value);
+            handle_item(&parser, inline_key ? (CiSpan){ rest.start, rest.start } : rest, line);
+            if (!inline_key) continue;
+            key_indent = indent + (int)(rest.start - content.start);
+            content = rest;
+        } else {
+            while (parser.depth > 0 && parser.frames[parser.depth - 1].indent >= indent) parser.depth--;
+        }
+
+        CiSpan key, value;
+        if (!split_key(content, &key, &value)) continue;
+        if (is_block_indicator(value)) {
+            char* block = read_block_scalar(p, end, key_indent, *value.start == '>', &p, &line_number);
+            if (!block) {
+                parser.failed = true;
+                break;
+            }
+            handle_key(&parser, key, (CiSpan){ NULL, NULL }, block, line);
+            free(block);
+        } else {
+            handle_key(&parser, key, value, NULL, line);
+        }
+        push_frame(&parser, key_indent, key);
+    }
+
+    for (size_t j = 0; j < wf->job_count && !parser.failed; j++) {
+        collect_scripts(&parser, root, &wf->jobs[j]);
+    }
+    if (parser.failed) {
+        ci_workflow_destroy(wf);
+        return NULL;
+    }
+    return wf;
+}
+
+CiWorkflow* ci_workflow_parse_file(const char* root, const char* filepath) {
+    char path[MAX_PATH_LENGTH];
+    if (root && filepath[0] != '/') snprintf(path, sizeof(path), "%s/%s", root, filepath);
+    else snprintf(path, sizeof(path), "%s", filepath);
+
+    size_t length;
+    char* buffer = parser_read_file(path, &length);
+    if (!buffer) {
+        return NULL;
+    }
+    CiWorkflow* wf = ci_workflow_parse_buffer(root, filepath, buffer, length);
+    free(buffer);
+    return wf;
+}
+
+static void free_list(char** list, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(list[i]);
+    }
+    free(list);
+}
+
+void ci_workflow_destroy(CiWorkflow* wf) {
+    if (!wf) return;
+
+    for (size_t t = 0; t < wf->trigger_count; t++) {
+        free(wf->triggers[t].event);
+        free_list(wf->triggers[t].paths, wf->triggers[t].path_count);
+        free_list(wf->triggers[t].paths_ignore, wf->triggers[t].paths_ignore_count);
+    }
+    free(wf->triggers);
+    for (size_t j = 0; j < wf->job_count; j++) {
+        CiJob* job = &wf->jobs[j];
+        free(job->id);
+        free(job->name);
+        free(job->condition);
+        free_list(job->needs, job->need_count);
+        free_list(job->paths, job->path_count);
+        free_list(job->scripts, job->script_count);
+        for (size_t s = 0; s < job->step_count; s++) {
+            free(job->steps[s].name);
+            free(job->steps[s].uses);
+            free(job->steps[s].run);
+            free(job->steps[s].working_directory);
+        }
+        free(job->steps);
+    }
+    free(wf->jobs);
+    hashmap_destroy(wf->by_id);
+    free(wf->name);
+    free(wf->filepath);
+    free(wf);
+}
+
+bool ci_is_workflow(const char* filepath) {
+    if (!filepath) return false;
+    bool yaml = file_has_suffix(filepath, ".yml") || file_has_suffix(filepath, ".yaml");
+    return yaml && (strstr(filepath, "workflows/") != NULL || file_has_suffix(filepath, "ci-config.yml"));
+}
+
+const CiJob* ci_workflow_find_job(const CiWorkflow* wf, const char* id) {
+    size_t index;
+    if (!wf || !id || hashmap_get(wf->by_id, id, &index) != 0) {
+        return NULL;
+    }
+    return &wf->jobs[index];
+}
+
+// Workflow filter globs: ** crosses directories, * and ? do not
+static bool glob_match(const char* pattern, const char* path) {
+    while (*pattern) {
+        if (pattern[0] == '*' && pattern[1] == '*') {
+            while (*pattern == '*') pattern++;
+            if (*pattern == '/' && glob_match(pattern + 1, path)) return true;
+            for (const char* s = path; ; s++) {
+                if (glob_match(pattern, s)) return true;
+                if (!*s) return false;
+            }
+        }
+        if (*pattern == '*') {
+            pattern++;
+            for (const char* s = path; ; s++) {
+                if (glob_match(pattern, s)) return true;
+                if (!*s || *s == '/') return false;
+            }
+        }
+        if (*pattern == '[') {
+            const char* close = strchr(pattern + 1, ']');
+            if (close && *path && *path != '/') {
+                bool matched = false;
+                for (const char* c = pattern + 1; c < close; c++) {
+                    if (c + 2 < close && c[1] == '-') {
+                        matched = matched || (*path >= c[0] && *path <= c[2]);
+                        c += 2;
+                    } else {
+                        matched = matched || *path == *c;
+                    }
+                }
+                if (!matched) return false;
+                pattern = close + 1;
+                path++;
+                continue;
+            }
+        }
+        if (*pattern == '\\' && pattern[1]) pattern++;
+        if (*pattern == '?' ? (!*path || *path == '/') : *pattern != *path) return false;
+        pattern++;
+        path++;
+    }
+    return *path == '\0';
+}
+
+bool ci_path_matches(const char* pattern, const char* path) {
+    if (!pattern || !path) return false;
+    while (pattern[0] == '.' && pattern[1] == '/') pattern += 2;
+    while (path[0] == '.' && path[1] == '/') path += 2;
+    return glob_match(pattern, path);
+}
+
+// Filter lists apply in order and the last matching pattern decides; '!' excludes
+static bool filter_selects(char** patterns, size_t count, const char* path) {
+    bool selected = false;
+    for (size_t i = 0; i < count; i++) {
+        bool negated = patterns[i][0] == '!';
+        if (ci_path_matches(patterns[i] + (negated ? 1 : 0), path)) selected = !negated;
+    }
+    return selected;
+}
+
+static bool is_change_event(const char* event) {
+    return strcmp(event, "push") == 0 || strcmp(event, "pull_request") == 0 ||
+           strcmp(event, "pull_request_target") == 0;
+}
+
+bool ci_workflow_triggered(const CiWorkflow* wf, const char* const* changed, size_t changed_count) {
+    if (!wf) return false;
+
+    for (size_t t = 0; t < wf->trigger_count; t++) {
+        const CiTrigger* trigger = &wf->triggers[t];
+        if (!is_change_event(trigger->event)) continue;
+        if (trigger->path_count == 0 && trigger->paths_ignore_count == 0) return true;
+        for (size_t i = 0; i < changed_count; i++) {
+            bool included = trigger->path_count == 0 ||
+                            filter_selects(trigger->paths, trigger->path_count, changed[i]);
+            bool ignored = trigger->paths_ignore_count > 0 &&
+                           filter_selects(trigger->paths_ignore, trigger->paths_ignore_count, changed[i]);
+            if (included && !ignored) return true;
+        }
+    }
+    return false;
+}
+
+// Edges from each needed job to the job that needs it
+static int job_edges(const CiWorkflow* wf, size_t** edge_from, size_t** edge_to, size_t* edge_count) {
+    size_t total = 0;
+    for (size_t j = 0; j < wf->job_count; j++) {
+        total += wf->jobs[j].need_count;
+    }
+    *edge_from = malloc((total ? total : 1) * sizeof(size_t));
+    *edge_to = malloc((total ? total : 1) * sizeof(size_t));
+    if (!*edge_from || !*edge_to) {
+        free(*edge_from);
+        free(*edge_to);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+
+    // needs naming jobs outside the workflow cannot be scheduled and are ignored
+    *edge_count = 0;
+    for (size_t j = 0; j < wf->job_count; j++) {
+        for (size_t n = 0; n < wf->jobs[j].need_count; n++) {
+            size_t needed;
+            if (hashmap_get(wf->by_id, wf->jobs[j].needs[n], &needed) == 0) {
+                (*edge_from)[*edge_count] = needed;
+                (*edge_to)[*edge_count] = j;
+                (*edge_count)++;
+            }
+        }
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+int ci_workflow_schedule(const CiWorkflow* wf, DagSchedule* schedule) {
+    if (!wf || !schedule) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    size_t *edge_from, *edge_to, edge_count;
+    if (job_edges(wf, &edge_from, &edge_to, &edge_count) != DEPTRACK_SUCCESS) {
+        return DEPTRACK_ERROR_MEMORY;
+    }
+    double* costs = malloc((wf->job_count ? wf->job_count : 1) * sizeof(double));
+    if (!costs) {
+        free(edge_from);
+        free(edge_to);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+
+    // The timeout is the only duration a workflow states; the runner default applies otherwise
+    for (size_t j = 0; j < wf->job_count; j++) {
+        int timeout = wf->jobs[j].timeout_minutes;
+        costs[j] = timeout > 0 ? timeout : CI_DEFAULT_TIMEOUT_MINUTES;
+    }
+
+    int result = dag_schedule_compute(wf->job_count, edge_from, edge_to, edge_count, costs, schedule);
+    free(edge_from);
+    free(edge_to);
+    free(costs);
+    return result;
+}
+
+size_t ci_workflow_required_jobs(const CiWorkflow* wf, const char* const* changed, size_t changed_count,
+                                 bool* required) {
+    if (!wf || !required) {
+        return 0;
+    }
+    memset(required, 0, wf->job_count * sizeof(bool));
+    if (!ci_workflow_triggered(wf, changed, changed_count)) {
+        return 0;
+    }
+
+    // Editing the workflow itself reruns all of it; otherwise unfiltered jobs run on any change
+    bool self_changed = false;
+    for (size_t i = 0; i < changed_count && !self_changed; i++) {
+        self_changed = ci_path_matches(wf->filepath, changed[i]);
+    }
+    for (size_t j = 0; j < wf->job_count; j++) {
+        const CiJob* job = &wf->jobs[j];
+        required[j] = self_changed || job->path_count == 0;
+        for (size_t i = 0; i < changed_count && !required[j]; i++) {
+            required[j] = filter_selects(job->paths, job->path_count, changed[i]);
+        }
+    }
+
+    size_t *edge_from, *edge_to, edge_count;
+    if (job_edges(wf, &edge_from, &edge_to, &edge_count) != DEPTRACK_SUCCESS) {
+        return 0;
+    }
+
+    // Jobs consuming a rerun job's output rerun too, and every job that runs needs its needs
+    bool changed_flag = true;
+    while (changed_flag) {
+        changed_flag = false;
+        for (size_t e = 0; e < edge_count; e++) {
+            if (required[edge_from[e]] && !required[edge_to[e]]) {
+                required[edge_to[e]] = true;
+                changed_flag = true;
+            }
+        }
+    }
+    changed_flag = true;
+    while (changed_flag) {
+        changed_flag = false;
+        for (size_t e = 0; e < edge_count; e++) {
+            if (required[edge_to[e]] && !required[edge_from[e]]) {
+                required[edge_from[e]] = true;
+                changed_flag = true;
+            }
+        }
+    }
+    free(edge_from);
+    free(edge_to);
+
+    size_t count = 0;
+    for (size_t j = 0; j < wf->job_count; j++) {
+        if (required[j]) count++;
+    }
+    return count;
+}
+
+static int add_found(char*** out, size_t* count, const char* path) {
+    char** grown = realloc(*out, (*count + 1) * sizeof(char*));
+    if (!grown) return DEPTRACK_ERROR_MEMORY;
+    *out = grown;
+    if (!(grown[*count] = strdup(path))) return DEPTRACK_ERROR_MEMORY;
+    (*count)++;
+    return DEPTRACK_SUCCESS;
+}
+
+int ci_find_workflows(const char* root, char*** out, size_t* count) {
+    if (!root || !out || !count) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+    *out = NULL;
+    *count = 0;
+
+    static const char* const dirs[] = { "build/ci/workflows", ".github/workflows", NULL };
+    int result = DEPTRACK_SUCCESS;
+    for (size_t d = 0; dirs[d] && result == DEPTRACK_SUCCESS; d++) {
+        char dir_path[MAX_PATH_LENGTH];
+        snprintf(dir_path, sizeof(dir_path), "%s/%s", root, dirs[d]);
+        DIR* dir = opendir(dir_path);
+        if (!dir) continue;
+
+        // Directory order is arbitrary: collect, then sort for stable output
+        size_t first = *count;
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL && result == DEPTRACK_SUCCESS) {
+            if (!file_has_suffix(entry->d_name, ".yml") && !file_has_suffix(entry->d_name, ".yaml")) continue;
+            char path[MAX_PATH_LENGTH];
+            int written = snprintf(path, sizeof(path), "%s/%s", dirs[d], entry->d_name);
+            if (written <= 0 || (size_t)written >= sizeof(path)) continue;
+            result = add_found(out, count, path);
+        }
+        closedir(dir);
+        for (size_t i = first + 1; i < *count; i++) {
+            for (size_t k = i; k > first && strcmp((*out)[k - 1], (*out)[k]) > 0; k--) {
+                char* swap = (*out)[k];
+                (*out)[k] = (*out)[k - 1];
+                (*out)[k - 1] = swap;
+            }
+        }
+    }
+
+    char config[MAX_PATH_LENGTH];
+    snprintf(config, sizeof(config), "%s/build/ci/ci-config.yml", root);
+    FILE* file = fopen(config, "r");
+    if (file) {
+        fclose(file);
+        if (result == DEPTRACK_SUCCESS) result = add_found(out, count, "build/ci/ci-config.yml");
+    }
+
+    if (result != DEPTRACK_SUCCESS) {
+        free_list(*out, *count);
+        *out = NULL;
+        *count = 0;
+    }
+    return result;
+}
+
+ParsedFile* parse_ci_workflow_buffer(const char* filepath, const char* buffer, size_t length) {
+    CiWorkflow* wf = ci_workflow_parse_buffer(".", filepath, buffer, length);
+    if (!wf) {
+        return NULL;
+    }
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_YAML);
+    for (size_t j = 0; parsed && j < wf->job_count; j++) {
+        const CiJob* job = &wf->jobs[j];
+        for (size_t s = 0; s < job->step_count; s++) {
+            // uses: owner/action@ref pins an external action
+            const char* uses = job->steps[s].uses;
+            if (!uses || strncmp(uses, "./", 2) == 0) continue;
+            const char* at = strchr(uses, '@');
+            parsed_file_add_dependency(parsed, uses, at ? (size_t)(at - uses) : strlen(uses), at ? at + 1 : NULL,
+                                       DEP_EXTERNAL, job->steps[s].line_number);
+        }
+        for (size_t i = 0; i < job->script_count; i++) {
+            parsed_file_add_dependency(parsed, job->scripts[i], strlen(job->scripts[i]), NULL, DEP_BUILD_TOOL,
+                                       job->line_number);
+        }
+    }
+    ci_workflow_destroy(wf);
+    return parsed;
+}
+
+ParsedFile* parse_ci_workflow_file(const char* filepath) {
+    return parser_parse_file(filepath, parse_ci_workflow_buffer);
+}
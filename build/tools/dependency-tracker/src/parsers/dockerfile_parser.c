@@ -0,0 +1,1252 @@
+/**
+ * @file dockerfile_parser.c
+ * @brief Dockerfile parser: stages, copied sources and installed packages
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Reads Dockerfiles into stages (FROM ... AS), the build-context paths COPY and ADD take, and
+ *             the packages RUN pip/npm installs, so a changed file can be mapped to the images it rebuilds
+ * @llm-key Physical lines are joined on the escape character into instructions; ARG/ENV values are
+ *          substituted, WORKDIR is tracked per stage, and `pip install -r` files are traced back through
+ *          the COPY that put them in the image
+ * @llm-map docker_image_set_load pairs every Dockerfile with the build context and image name its
+ *          compose service gives it; docker_images_to_rebuild follows FROM and COPY --from between images
+ * @llm-contract COPY/ADD sources are reported relative to the root; .dockerignore is not applied, so an
+ *               image may be reported for a change the ignore file would have excluded
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <string.h>
+
+#define DOCKER_MAX_WORDS 256
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} DockerText;
+
+typedef struct {
+    char* name;
+    char* value;
+} DockerVariable;
+
+// COPY destination inside the image and where it came from in the context
+typedef struct {
+    char* dest;
+    char* source;
+    bool dest_is_dir;
+} DockerCopy;
+
+typedef struct {
+    Dockerfile* df;
+    char escape;
+    DockerVariable* globals;   // ARG before the first FROM
+    size_t global_count;
+    DockerVariable* locals;    // ARG and ENV of the current stage
+    size_t local_count;
+    DockerCopy* copies;        // COPYs of the current stage
+    size_t copy_count;
+    char workdir[MAX_PATH_LENGTH];
+    char** stage_workdirs;     // WORKDIR each finished stage ended with, for FROM <stage>
+    bool failed;
+} DockerParser;
+
+typedef struct {
+    char* items[DOCKER_MAX_WORDS];
+    size_t count;
+} DockerWords;
+
+// ---------------------------------------------------------------------------
+// Small helpers
+// ---------------------------------------------------------------------------
+
+static bool text_append(DockerText* text, const char* data, size_t length) {
+    if (text->length + length + 1 > text->capacity) {
+        size_t capacity = text->capacity ? text->capacity : 256;
+        while (capacity < text->length + length + 1) capacity *= 2;
+        char* grown = realloc(text->data, capacity);
+        if (!grown) return false;
+        text->data = grown;
+        text->capacity = capacity;
+    }
+    memcpy(text->data + text->length, data, length);
+    text->length += length;
+    text->data[text->length] = '\0';
+    return true;
+}
+
+static void words_clear(DockerWords* words) {
+    for (size_t i = 0; i < words->count; i++) free(words->items[i]);
+    words->count = 0;
+}
+
+static bool words_add(DockerWords* words, const char* text, size_t length) {
+    if (words->count >= DOCKER_MAX_WORDS) return true;   // Longer commands are truncated
+    char* copy = strndup(text, length);
+    if (!copy) return false;
+    words->items[words->count++] = copy;
+    return true;
+}
+
+static void free_variables(DockerVariable* vars, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(vars[i].name);
+        free(vars[i].value);
+    }
+    free(vars);
+}
+
+static void free_copies(DockerCopy* copies, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(copies[i].dest);
+        free(copies[i].source);
+    }
+    free(copies);
+}
+
+static bool set_variable(DockerVariable** vars, size_t* count, const char* name, size_t name_length,
+                         const char* value) {
+    for (size_t i = 0; i < *count; i++) {
+        if (strlen((*vars)[i].name) == name_length && memcmp((*vars)[i].name, name, name_length) == 0) {
+            char* copy = strdup(value);
+            if (!copy) return false;
+            free((*vars)[i].value);
+            (*vars)[i].value = copy;
+            return true;
+        }
+    }
+    DockerVariable* grown = realloc(*vars, (*count + 1) * sizeof(DockerVariable));
+    if (!grown) return false;
+    *vars = grown;
+    grown[*count].name = strndup(name, name_length);
+    grown[*count].value = strdup(value);
+    if (!grown[*count].name || !grown[*count].value) {
+        free(grown[*count].name);
+        free(grown[*count].value);
+        return false;
+    }
+    (*count)++;
+    return true;
+}
+
+static const char* find_variable(const DockerParser* p, const char* name, size_t length, bool stage) {
+    if (stage) {
+        for (size_t i = p->local_count; i-- > 0;) {
+            if (strlen(p->locals[i].name) == length && memcmp(p->locals[i].name, name, length) == 0) {
+                return p->locals[i].value;
+            }
+        }
+    }
+    for (size_t i = 0; i < p->global_count; i++) {
+        if (strlen(p->globals[i].name) == length && memcmp(p->globals[i].name, name, length) == 0) {
+            return p->globals[i].value;
+        }
+    }
+    return NULL;
+}
+
+static bool is_name_char(char c) {
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+// $VAR, ${VAR}, ${VAR:-default}, ${VAR:+alt}; unknown values become '*' so paths still glob
+static char* substitute(const DockerParser* p, const char* text, size_t length, bool stage) {
+    DockerText out = { NULL, 0, 0 };
+    bool ok = text_append(&out, "", 0);
+    for (size_t i = 0; ok && i < length;) {
+        if (text[i] == p->escape && i + 1 < length && text[i + 1] == '$') {
+            ok = text_append(&out, "$", 1);
+            i += 2;
+            continue;
+        }
+        if (text[i] != '$' || i + 1 >= length) {
+            ok = text_append(&out, text + i, 1);
+            i++;
+            continue;
+        }
+
+        const char* name = text + i + 1;
+        size_t name_length = 0;
+        const char* modifier = NULL;
+        size_t modifier_length = 0;
+        size_t next;
+        if (*name == '{') {
+            const char* close = memchr(name, '}', length - i - 1);
+            if (!close) {
+                ok = text_append(&out, text + i, length - i);
+                break;
+            }
+            name++;
+            while (name + name_length < close && is_name_char(name[name_length])) name_length++;
+            if (name + name_length + 1 < close && name[name_length] == ':') {
+                modifier = name + name_length + 1;
+                modifier_length = (size_t)(close - modifier);
+            }
+            next = (size_t)(close - text) + 1;
+        } else {
+            while (i + 1 + name_length < length && is_name_char(name[name_length])) name_length++;
+            next = i + 1 + name_length;
+        }
+        if (name_length == 0) {
+            ok = text_append(&out, "$", 1);
+            i++;
+            continue;
+        }
+
+        const char* value = find_variable(p, name, name_length, stage);
+        if (modifier && *modifier == '-' && (!value || !*value)) {
+            ok = text_append(&out, modifier + 1, modifier_length - 1);
+        } else if (modifier && *modifier == '+') {
+            if (value && *value) ok = text_append(&out, modifier + 1, modifier_length - 1);
+        } else if (value) {
+            ok = text_append(&out, value, strlen(value));
+        } else {
+            ok = text_append(&out, "*", 1);
+        }
+        i = next;
+    }
+    if (!ok) {
+        free(out.data);
+        return NULL;
+    }
+    return out.data;
+}
+
+// Splits shell-style words, removing quotes; stops at nothing, operators are words of their own
+static bool split_words(const char* text, size_t length, DockerWords* words) {
+    DockerText word = { NULL, 0, 0 };
+    bool in_word = false;
+    bool ok = true;
+    for (size_t i = 0; ok && i <= length; i++) {
+        char c = i < length ? text[i] : ' ';
+        if (c == '\'' || c == '"') {
+            const char* close = memchr(text + i + 1, c, length - i - 1);
+            size_t end = close ? (size_t)(close - text) : length;
+            ok = text_append(&word, text + i + 1, end - i - 1);
+            in_word = true;
+            i = end;
+        } else if (c == '\\' && i + 1 < length) {
+            ok = text_append(&word, text + i + 1, 1);
+            in_word = true;
+            i++;
+        } else if (c == ';' || c == '|' || c == '&') {
+            if (in_word) ok = words_add(words, word.data, word.length);
+            word.length = 0;
+            in_word = false;
+            size_t run = 1;
+            while (i + run < length && text[i + run] == c && run < 2) run++;
+            if (ok) ok = words_add(words, text + i, run);
+            i += run - 1;
+        } else if (isspace((unsigned char)c)) {
+            if (in_word) ok = words_add(words, word.data, word.length);
+            word.length = 0;
+            in_word = false;
+        } else {
+            ok = text_append(&word, &c, 1);
+            in_word = true;
+        }
+    }
+    free(word.data);
+    return ok;
+}
+
+// ["a", "b"] exec form
+static bool split_json_array(const char* text, size_t length, DockerWords* words) {
+    bool ok = true;
+    for (size_t i = 0; ok && i < length; i++) {
+        if (text[i] != '"') continue;
+        DockerText item = { NULL, 0, 0 };
+        ok = text_append(&item, "", 0);
+        for (i++; ok && i < length && text[i] != '"'; i++) {
+            if (text[i] == '\\' && i + 1 < length) i++;
+            ok = text_append(&item, text + i, 1);
+        }
+        if (ok) ok = words_add(words, item.data, item.length);
+        free(item.data);
+    }
+    return ok;
+}
+
+static bool is_operator(const char* word) {
+    return strcmp(word, "&&") == 0 || strcmp(word, "||") == 0 || strcmp(word, ";") == 0 ||
+           strcmp(word, "|") == 0 || strcmp(word, "&") == 0;
+}
+
+static const char* base_name(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+// Joins a path onto a directory and normalizes it; absolute paths replace the directory. False when the
+// result does not fit in size, and out is then not a path to use.
+static bool join_path(char* out, size_t size, const char* dir, const char* path) {
+    int written;
+    if (path[0] == '/' || !dir || !*dir) {
+        written = snprintf(out, size, "%s", path);
+    } else {
+        written = snprintf(out, size, "%s/%s", dir, path);
+    }
+    if (written < 0 || (size_t)written >= size) return false;
+    file_normalize_path(out);
+    return true;
+}
+
+// Root-relative path of a context path; leading '/' in a COPY source still means the context
+static bool context_path(const Dockerfile* df, const char* source, char* out, size_t size) {
+    while (*source == '/') source++;
+    int written = snprintf(out, size, "%s/%s", df->context, *source ? source : ".");
+    if (written < 0 || (size_t)written >= size) return false;
+    file_normalize_path(out);
+    return true;
+}
+
+static bool add_reference(DockerParser* p, DockerReferenceKind kind, const char* value, size_t value_length,
+                          const char* version, int line) {
+    Dockerfile* df = p->df;
+    if (value_length == 0) return true;
+    if (df->reference_count >= df->reference_capacity) {
+        size_t capacity = df->reference_capacity ? df->reference_capacity * 2 : 16;
+        DockerReference* grown = realloc(df->references, capacity * sizeof(DockerReference));
+        if (!grown) return false;
+        df->references = grown;
+        df->reference_capacity = capacity;
+    }
+    DockerReference* ref = &df->references[df->reference_count];
+    memset(ref, 0, sizeof(*ref));
+    ref->kind = kind;
+    ref->value = strndup(value, value_length);
+    ref->version = version ? strdup(version) : NULL;
+    ref->stage = df->stage_count ? df->stage_count - 1 : 0;
+    ref->line_number = line;
+    if (!ref->value || (version && !ref->version)) {
+        free(ref->value);
+        free(ref->version);
+        return false;
+    }
+    df->reference_count++;
+    return true;
+}
+
+static int find_stage(const Dockerfile* df, const char* name) {
+    // Stages are referenced by name or by index
+    bool numeric = *name != '\0';
+    for (const char* c = name; *c; c++) numeric = numeric && isdigit((unsigned char)*c);
+    if (numeric) {
+        long index = strtol(name, NULL, 10);
+        return index >= 0 && (size_t)index < df->stage_count ? (int)index : -1;
+    }
+    for (size_t i = 0; i < df->stage_count; i++) {
+        if (df->stages[i].name && strcasecmp(df->stages[i].name, name) == 0) return (int)i;
+    }
+    return -1;
+}
+
+// ---------------------------------------------------------------------------
+// Instructions
+// ---------------------------------------------------------------------------
+
+static void handle_from(DockerParser* p, const DockerWords* words, int line) {
+    size_t i = 0;
+    while (i < words->count && strncmp(words->items[i], "--", 2) == 0) i++;
+    if (i >= words->count) return;
+
+    Dockerfile* df = p->df;
+    if (df->stage_count >= df->stage_capacity) {
+        size_t capacity = df->stage_capacity ? df->stage_capacity * 2 : 4;
+        DockerStage* grown = realloc(df->stages, capacity * sizeof(DockerStage));
+        if (!grown) {
+            p->failed = true;
+            return;
+        }
+        df->stages = grown;
+        df->stage_capacity = capacity;
+        char** workdirs = realloc(p->stage_workdirs, capacity * sizeof(char*));
+        if (!workdirs) {
+            p->failed = true;
+            return;
+        }
+        p->stage_workdirs = workdirs;
+    }
+
+    DockerStage* stage = &df->stages[df->stage_count];
+    memset(stage, 0, sizeof(*stage));
+    stage->base = substitute(p, words->items[i], strlen(words->items[i]), false);
+    stage->base_stage = stage->base ? find_stage(df, stage->base) : -1;
+    stage->line_number = line;
+    if (i + 2 < words->count && strcasecmp(words->items[i + 1], "AS") == 0) {
+        stage->name = strdup(words->items[i + 2]);
+        if (!stage->name) p->failed = true;
+    }
+    if (!stage->base) p->failed = true;
+    df->stage_count++;
+
+    // A stage starts from its base's working directory; variables and copies are per stage
+    if (df->stage_count > 1) {
+        p->stage_workdirs[df->stage_count - 2] = strdup(p->workdir);
+        if (!p->stage_workdirs[df->stage_count - 2]) p->failed = true;
+    }
+    const char* inherited = stage->base_stage >= 0 ? p->stage_workdirs[stage->base_stage] : NULL;
+    snprintf(p->workdir, sizeof(p->workdir), "%s", inherited ? inherited : "/");
+    free_variables(p->locals, p->local_count);
+    p->locals = NULL;
+    p->local_count = 0;
+    free_copies(p->copies, p->copy_count);
+    p->copies = NULL;
+    p->copy_count = 0;
+}
+
+static void handle_variable(DockerParser* p, const DockerWords* words, bool is_arg) {
+    bool global = is_arg && p->df->stage_count == 0;
+    for (size_t i = 0; i < words->count; i++) {
+        const char* word = words->items[i];
+        const char* eq = strchr(word, '=');
+        const char* value;
+        char* expanded = NULL;
+        size_t name_length;
+        if (eq) {
+            name_length = (size_t)(eq - word);
+            expanded = substitute(p, eq + 1, strlen(eq + 1), !global);
+            if (!expanded) {
+                p->failed = true;
+                return;
+            }
+            value = expanded;
+        } else if (!is_arg && i + 1 < words->count) {
+            // Legacy "ENV NAME value with spaces" form: the rest of the line is the value
+            name_length = strlen(word);
+            DockerText rest = { NULL, 0, 0 };
+            for (size_t j = i + 1; j < words->count; j++) {
+                if (j > i + 1) text_append(&rest, " ", 1);
+                text_append(&rest, words->items[j], strlen(words->items[j]));
+            }
+            expanded = rest.data ? substitute(p, rest.data, rest.length, true) : NULL;
+            free(rest.data);
+            if (!expanded) {
+                p->failed = true;
+                return;
+            }
+            value = expanded;
+            i = words->count;
+        } else {
+            // ARG NAME inside a stage takes the global default
+            name_length = strlen(word);
+            value = global ? NULL : find_variable(p, word, name_length, false);
+            if (!value) continue;
+        }
+
+        bool ok = global ? set_variable(&p->globals, &p->global_count, word, name_length, value)
+                         : set_variable(&p->locals, &p->local_count, word, name_length, value);
+        free(expanded);
+        if (!ok) {
+            p->failed = true;
+            return;
+        }
+    }
+}
+
+static void handle_workdir(DockerParser* p, const char* args, size_t length) {
+    char* path = substitute(p, args, length, true);
+    if (!path) {
+        p->failed = true;
+        return;
+    }
+    // The working directory is always absolute, so the join is too
+    // One too long to hold leaves the previous directory
+    char joined[MAX_PATH_LENGTH];
+    if (join_path(joined, sizeof(joined), p->workdir, path)) memcpy(p->workdir, joined, sizeof(joined));
+    free(path);
+}
+
+static bool image_path(const DockerParser* p, const char* path, char* out, size_t size) {
+    return join_path(out, size, p->workdir, path);
+}
+
+// Maps a path inside the image back to the context file a COPY brought in, if one did
+static bool resolve_copied(const DockerParser* p, const char* path, char* out, size_t size) {
+    char absolute[MAX_PATH_LENGTH];
+    if (!image_path(p, path, absolute, sizeof(absolute))) return false;
+    // COPY a /x/a and COPY a b /x/ name the file itself; a source copied to a directory only
+    // contains the path when no COPY brought in the file by name
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t i = p->copy_count; i-- > 0;) {
+            const DockerCopy* copy = &p->copies[i];
+            size_t dest_length = strlen(copy->dest);
+            if (strcmp(absolute, copy->dest) == 0) {
+                if (pass == 1) continue;
+                snprintf(out, size, "%s", copy->source);
+                return true;
+            }
+            bool inside = strncmp(absolute, copy->dest, dest_length) == 0 &&
+                          (absolute[dest_length] == '/' || strcmp(copy->dest, "/") == 0);
+            if (!inside) continue;
+            const char* rest = absolute + dest_length + (strcmp(copy->dest, "/") == 0 ? 0 : 1);
+            if (pass == 0 && copy->dest_is_dir && strcmp(rest, base_name(copy->source)) == 0) {
+                snprintf(out, size, "%s", copy->source);
+                return true;
+            }
+            if (pass == 1) return join_path(out, size, copy->source, rest);
+        }
+    }
+    return false;
+}
+
+static bool remember_copy(DockerParser* p, const char* dest, const char* source, bool dest_is_dir) {
+    // A destination too long to hold cannot be matched later, so there is nothing to remember
+    char absolute[MAX_PATH_LENGTH];
+    if (!image_path(p, dest, absolute, sizeof(absolute))) return true;
+    DockerCopy* grown = realloc(p->copies, (p->copy_count + 1) * sizeof(DockerCopy));
+    if (!grown) return false;
+    p->copies = grown;
+    grown[p->copy_count].dest = strdup(absolute);
+    grown[p->copy_count].source = strdup(source);
+    grown[p->copy_count].dest_is_dir = dest_is_dir;
+    if (!grown[p->copy_count].dest || !grown[p->copy_count].source) {
+        free(grown[p->copy_count].dest);
+        free(grown[p->copy_count].source);
+        return false;
+    }
+    p->copy_count++;
+    return true;
+}
+
+static void handle_copy(DockerParser* p, DockerWords* words, bool is_add, int line) {
+    const char* from = NULL;
+    size_t first = 0;
+    while (first < words->count && strncmp(words->items[first], "--", 2) == 0) {
+        if (strncmp(words->items[first], "--from=", 7) == 0) from = words->items[first] + 7;
+        first++;
+    }
+    if (words->count - first < 2) return;
+
+    if (from) {
+        // Another stage of this file, or an image pulled just for its files
+        if (find_stage(p->df, from) < 0 && !add_reference(p, DOCKER_REF_IMAGE, from, strlen(from), NULL, line)) {
+            p->failed = true;
+        }
+        return;
+    }
+
+    const char* dest_raw = words->items[words->count - 1];
+    char* dest = substitute(p, dest_raw, strlen(dest_raw), true);
+    if (!dest) {
+        p->failed = true;
+        return;
+    }
+    size_t source_count = words->count - 1 - first;
+    bool dest_is_dir = source_count > 1 || dest[0] == '\0' || dest[strlen(dest) - 1] == '/';
+
+    for (size_t i = first; i + 1 < words->count && !p->failed; i++) {
+        const char* source = words->items[i];
+        if (strncmp(source, "<<", 2) == 0) continue;   // Here-document content, not a context file
+        if (is_add && (strstr(source, "://") || strncmp(source, "git@", 4) == 0)) continue;
+
+        char* expanded = substitute(p, source, strlen(source), true);
+        if (!expanded) {
+            p->failed = true;
+            break;
+        }
+        char path[MAX_PATH_LENGTH];
+        bool fits = context_path(p->df, expanded, path, sizeof(path));
+        free(expanded);
+        if (!fits) continue;   // Dropped rather than recorded cut short
+        if (!add_reference(p, is_add ? DOCKER_REF_ADD : DOCKER_REF_COPY, path, strlen(path), NULL, line) ||
+            !remember_copy(p, dest, path, dest_is_dir)) {
+            p->failed = true;
+        }
+    }
+    free(dest);
+}
+
+static bool word_in(const char* word, const char* const* list) {
+    for (size_t i = 0; list[i]; i++) {
+        if (strcmp(word, list[i]) == 0) return true;
+    }
+    return false;
+}
+
+// Records a manifest, traced back to the context when a COPY brought it in
+static void add_manifest(DockerParser* p, const char* path, int line) {
+    char resolved[MAX_PATH_LENGTH];
+    if (!resolve_copied(p, path, resolved, sizeof(resolved)) && !image_path(p, path, resolved, sizeof(resolved))) {
+        return;
+    }
+    if (!add_reference(p, DOCKER_REF_MANIFEST, resolved, strlen(resolved), NULL, line)) p->failed = true;
+}
+
+// "torch==2.9.0", "uvicorn[standard]>=0.30", "grpcio"
+static void add_pip_package(DockerParser* p, const char* spec, int line) {
+    size_t name_length = strcspn(spec, "=<>!~[;@ ,");
+    const char* rest = spec + name_length;
+    if (*rest == '[') {
+        const char* close = strchr(rest, ']');
+        rest = close ? close + 1 : rest + strlen(rest);
+    }
+    char version[MAX_VERSION_LENGTH];
+    const char* pinned = NULL;
+    if (strncmp(rest, "==", 2) == 0) {
+        snprintf(version, sizeof(version), "%.*s", (int)strcspn(rest + 2, ";, "), rest + 2);
+        pinned = version;
+    } else if (*rest && strchr("<>!~=", *rest)) {
+        snprintf(version, sizeof(version), "%.*s", (int)strcspn(rest, "; "), rest);
+        pinned = version;
+    }
+    if (!add_reference(p, DOCKER_REF_PIP, spec, name_length, pinned, line)) p->failed = true;
+}
+
+// "lodash@4.17.21", "@grpc/grpc-js@^1.9", "typescript"
+static void add_npm_package(DockerParser* p, const char* spec, int line) {
+    const char* at = strrchr(spec, '@');
+    if (at == spec) at = NULL;
+    size_t name_length = at ? (size_t)(at - spec) : strlen(spec);
+    if (!add_reference(p, DOCKER_REF_NPM, spec, name_length, at ? at + 1 : NULL, line)) p->failed = true;
+}
+
+static void analyze_pip(DockerParser* p, char** args, size_t count, int line) {
+    static const char* const valued[] = {
+        "-i", "--index-url", "--extra-index-url", "-f", "--find-links", "-t", "--target", "--prefix",
+        "--root", "--platform", "--python-version", "--implementation", "--abi", "--src", "--upgrade-strategy",
+        "--cache-dir", "--trusted-host", "--progress-bar", NULL
+    };
+    for (size_t i = 0; i < count && !p->failed; i++) {
+        const char* arg = args[i];
+        if (strcmp(arg, "-r") == 0 || strcmp(arg, "--requirement") == 0 || strcmp(arg, "-c") == 0 ||
+            strcmp(arg, "--constraint") == 0 || strcmp(arg, "-e") == 0 || strcmp(arg, "--editable") == 0) {
+            if (i + 1 < count) add_manifest(p, args[++i], line);
+        } else if (strncmp(arg, "--requirement=", 14) == 0) {
+            add_manifest(p, arg + 14, line);
+        } else if (strncmp(arg, "-r", 2) == 0 && arg[2]) {
+            add_manifest(p, arg + 2, line);
+        } else if (word_in(arg, valued)) {
+            i++;
+        } else if (arg[0] == '-') {
+            continue;
+        } else if (arg[0] == '.' || arg[0] == '/' || strstr(arg, "://") || file_has_suffix(arg, ".whl")) {
+            add_manifest(p, arg, line);
+        } else {
+            add_pip_package(p, arg, line);
+        }
+    }
+}
+
+static void analyze_npm(DockerParser* p, char** args, size_t count, int line) {
+    static const char* const valued[] = { "--prefix", "--registry", "-w", "--workspace", "--cache", NULL };
+    bool any = false;
+    for (size_t i = 0; i < count && !p->failed; i++) {
+        const char* arg = args[i];
+        if (word_in(arg, valued)) {
+            i++;
+        } else if (arg[0] == '-') {
+            continue;
+        } else if (arg[0] == '.' || arg[0] == '/' || strstr(arg, "://") || (arg[0] != '@' && strchr(arg, '/'))) {
+            any = true;   // Local directories, tarballs and git URLs are not registry packages
+        } else {
+            add_npm_package(p, arg, line);
+            any = true;
+        }
+    }
+    // A bare install or ci installs what package.json in the working directory lists
+    if (!any) add_manifest(p, "package.json", line);
+}
+
+static bool is_python(const char* word) {
+    const char* name = base_name(word);
+    if (strncmp(name, "python", 6) != 0) return false;
+    for (const char* c = name + 6; *c; c++) {
+        if (!isdigit((unsigned char)*c) && *c != '.') return false;
+    }
+    return true;
+}
+
+static bool is_pip(const char* word) {
+    const char* name = base_name(word);
+    if (strncmp(name, "pip", 3) != 0) return false;
+    for (const char* c = name + 3; *c; c++) {
+        if (!isdigit((unsigned char)*c) && *c != '.') return false;
+    }
+    return true;
+}
+
+static void analyze_command(DockerParser* p, char** words, size_t count, int line) {
+    size_t i = 0;
+    // Prefixes that run the rest of the command
+    while (i < count && (strchr(words[i], '=') || strcmp(words[i], "sudo") == 0 || strcmp(words[i], "env") == 0 ||
+                         strcmp(words[i], "exec") == 0)) {
+        i++;
+    }
+    if (i >= count) return;
+
+    char** w = words + i;
+    size_t n = count - i;
+    if (n >= 2 && is_pip(w[0]) && strcmp(w[1], "install") == 0) {
+        analyze_pip(p, w + 2, n - 2, line);
+    } else if (n >= 4 && is_python(w[0]) && strcmp(w[1], "-m") == 0 && is_pip(w[2]) && strcmp(w[3], "install") == 0) {
+        analyze_pip(p, w + 4, n - 4, line);
+    } else if (n >= 3 && strcmp(w[0], "uv") == 0 && strcmp(w[1], "pip") == 0 && strcmp(w[2], "install") == 0) {
+        analyze_pip(p, w + 3, n - 3, line);
+    } else if (n >= 2 && strcmp(w[0], "npm") == 0 &&
+               (strcmp(w[1], "install") == 0 || strcmp(w[1], "i") == 0 || strcmp(w[1], "ci") == 0 ||
+                strcmp(w[1], "add") == 0)) {
+        analyze_npm(p, w + 2, n - 2, line);
+    } else if (n >= 2 && (strcmp(w[0], "yarn") == 0 || strcmp(w[0], "pnpm") == 0) &&
+               (strcmp(w[1], "add") == 0 || strcmp(w[1], "install") == 0 || strcmp(w[1], "i") == 0)) {
+        analyze_npm(p, w + 2, n - 2, line);
+    } else if (n >= 2 && strcmp(w[0], "cd") == 0) {
+        // RUN cd dir && npm ci: the working directory changes for the rest of the instruction
+        char joined[MAX_PATH_LENGTH];
+        if (join_path(joined, sizeof(joined), p->workdir, w[1])) memcpy(p->workdir, joined, sizeof(joined));
+    }
+}
+
+static void analyze_run_words(DockerParser* p, DockerWords* words, int line) {
+    size_t start = 0;
+    for (size_t i = 0; i <= words->count; i++) {
+        if (i < words->count && !is_operator(words->items[i])) continue;
+        if (i > start) analyze_command(p, words->items + start, i - start, line);
+        start = i + 1;
+    }
+}
+
+static void handle_run(DockerParser* p, const char* args, size_t length, int line) {
+    char saved[MAX_PATH_LENGTH];
+    snprintf(saved, sizeof(saved), "%s", p->workdir);
+
+    DockerWords words = { .count = 0 };
+    while (length > 0 && isspace((unsigned char)*args)) {
+        args++;
+        length--;
+    }
+    // Flags such as --mount=type=cache come before the command
+    while (length > 2 && strncmp(args, "--", 2) == 0) {
+        while (length > 0 && !isspace((unsigned char)*args)) {
+            args++;
+            length--;
+        }
+        while (length > 0 && isspace((unsigned char)*args)) {
+            args++;
+            length--;
+        }
+    }
+
+    char* expanded = substitute(p, args, length, true);
+    bool ok = expanded != NULL;
+    if (ok && expanded[0] == '[') {
+        ok = split_json_array(expanded, strlen(expanded), &words);
+    } else if (ok) {
+        ok = split_words(expanded, strlen(expanded), &words);
+    }
+    if (ok) analyze_run_words(p, &words, line);
+    else p->failed = true;
+    words_clear(&words);
+    free(expanded);
+
+    // cd inside RUN does not outlive the instruction
+    snprintf(p->workdir, sizeof(p->workdir), "%s", saved);
+}
+
+// Here-document delimiter of "<<EOF", "<<-EOF", "<<'EOF'"; empty when the instruction has none
+static void heredoc_delimiter(const char* text, size_t length, char* out, size_t size, bool* strip_tabs) {
+    out[0] = '\0';
+    const char* marker = NULL;
+    for (size_t i = 0; i + 2 < length; i++) {
+        if (text[i] == '<' && text[i + 1] == '<' && (i == 0 || text[i - 1] != '<')) {
+            marker = text + i + 2;
+            break;
+        }
+    }
+    if (!marker) return;
+    const char* end = text + length;
+    *strip_tabs = marker < end && *marker == '-';
+    if (*strip_tabs) marker++;
+    if (marker < end && (*marker == '\'' || *marker == '"')) marker++;
+    size_t n = 0;
+    while (marker + n < end && is_name_char(marker[n]) && n + 1 < size) n++;
+    memcpy(out, marker, n);
+    out[n] = '\0';
+}
+
+static void dispatch(DockerParser* p, const char* text, size_t length, int line) {
+    while (length > 0 && isspace((unsigned char)*text)) {
+        text++;
+        length--;
+    }
+    size_t keyword_length = 0;
+    while (keyword_length < length && !isspace((unsigned char)text[keyword_length])) keyword_length++;
+    const char* args = text + keyword_length;
+    size_t args_length = length - keyword_length;
+
+    char keyword[16];
+    if (keyword_length == 0 || keyword_length >= sizeof(keyword)) return;
+    for (size_t i = 0; i < keyword_length; i++) keyword[i] = (char)toupper((unsigned char)text[i]);
+    keyword[keyword_length] = '\0';
+
+    if (strcmp(keyword, "RUN") == 0) {
+        handle_run(p, args, args_length, line);
+        return;
+    }
+    if (strcmp(keyword, "WORKDIR") == 0) {
+        while (args_length > 0 && isspace((unsigned char)*args)) {
+            args++;
+            args_length--;
+        }
+        while (args_length > 0 && isspace((unsigned char)args[args_length - 1])) args_length--;
+        handle_workdir(p, args, args_length);
+        return;
+    }
+
+    DockerWords words = { .count = 0 };
+    size_t first = 0;
+    while (first < args_length && isspace((unsigned char)args[first])) first++;
+    bool json = first < args_length && args[first] == '[';
+    bool ok = json ? split_json_array(args, args_length, &words) : split_words(args, args_length, &words);
+    if (!ok) {
+        p->failed = true;
+    } else if (strcmp(keyword, "FROM") == 0) {
+        handle_from(p, &words, line);
+    } else if (strcmp(keyword, "ARG") == 0 || strcmp(keyword, "ENV") == 0) {
+        handle_variable(p, &words, keyword[0] == 'A');
+    } else if (strcmp(keyword, "COPY") == 0 || strcmp(keyword, "ADD") == 0) {
+        handle_copy(p, &words, keyword[0] == 'A', line);
+    }
+    words_clear(&words);
+}
+
+// ---------------------------------------------------------------------------
+// Dockerfile
+// ---------------------------------------------------------------------------
+
+void dockerfile_destroy(Dockerfile* df) {
+    if (!df) return;
+
+    free(df->filepath);
+    free(df->context);
+    for (size_t i = 0; i < df->stage_count; i++) {
+        free(df->stages[i].name);
+        free(df->stages[i].base);
+    }
+    free(df->stages);
+    for (size_t i = 0; i < df->reference_count; i++) {
+        free(df->references[i].value);
+        free(df->references[i].version);
+    }
+    free(df->references);
+    free(df);
+}
+
+static bool line_is(const char* start, const char* end, const char* delimiter, bool strip_tabs) {
+    if (strip_tabs) {
+        while (start < end && *start == '\t') start++;
+    }
+    while (end > start && (end[-1] == '\r' || end[-1] == ' ')) end--;
+    size_t length = strlen(delimiter);
+    return (size_t)(end - start) == length && memcmp(start, delimiter, length) == 0;
+}
+
+Dockerfile* dockerfile_parse_buffer(const char* filepath, const char* context, const char* buffer, size_t length) {
+    if (!filepath || !buffer) {
+        return NULL;
+    }
+
+    Dockerfile* df = calloc(1, sizeof(Dockerfile));
+    if (!df) return NULL;
+    df->filepath = strdup(filepath);
+    if (context) {
+        df->context = strdup(context);
+    } else {
+        char dir[MAX_PATH_LENGTH];
+        const char* slash = strrchr(filepath, '/');
+        snprintf(dir, sizeof(dir), "%.*s", slash ? (int)(slash - filepath) : 0, filepath);
+        file_normalize_path(dir);
+        df->context = strdup(dir);
+    }
+    if (!df->filepath || !df->context) {
+        dockerfile_destroy(df);
+        return NULL;
+    }
+
+    DockerParser p;
+    memset(&p, 0, sizeof(p));
+    p.df = df;
+    p.escape = '\\';
+    snprintf(p.workdir, sizeof(p.workdir), "/");
+
+    DockerText instruction = { NULL, 0, 0 };
+    int instruction_line = 0;
+    bool directives = true;
+    const char* cursor = buffer;
+    const char* end = buffer + length;
+    int line = 0;
+    while (cursor < end && !p.failed) {
+        const char* eol = memchr(cursor, '\n', (size_t)(end - cursor));
+        if (!eol) eol = end;
+        const char* start = cursor;
+        cursor = eol < end ? eol + 1 : end;
+        line++;
+
+        const char* content = start;
+        while (content < eol && (*content == ' ' || *content == '\t')) content++;
+        const char* stop = eol;
+        while (stop > content && isspace((unsigned char)stop[-1])) stop--;
+
+        if (content < stop && *content == '#') {
+            // Parser directives only count before the first instruction
+            if (directives && instruction.length == 0) {
+                const char* directive = content + 1;
+                while (directive < stop && *directive == ' ') directive++;
+                if (stop - directive >= 8 && strncasecmp(directive, "escape=", 7) == 0) {
+                    p.escape = directive[7];
+                }
+            }
+            continue;   // Comment lines, also inside a continued instruction
+        }
+        if (content == stop) {
+            continue;
+        }
+        directives = false;
+
+        if (instruction.length == 0) instruction_line = line;
+        bool continued = stop[-1] == p.escape;
+        if (!text_append(&instruction, content, (size_t)(stop - content - (continued ? 1 : 0))) ||
+            !text_append(&instruction, " ", 1)) {
+            p.failed = true;
+            break;
+        }
+        if (continued) continue;
+
+        char delimiter[64];
+        bool strip_tabs = false;
+        heredoc_delimiter(instruction.data, instruction.length, delimiter, sizeof(delimiter), &strip_tabs);
+        bool run = instruction.length >= 3 && strncasecmp(instruction.data, "RUN", 3) == 0;
+        if (delimiter[0]) {
+            // RUN <<EOF: the body is the script; COPY <<EOF: the body is file content
+            while (cursor < end) {
+                const char* body_end = memchr(cursor, '\n', (size_t)(end - cursor));
+                if (!body_end) body_end = end;
+                const char* body = cursor;
+                cursor = body_end < end ? body_end + 1 : end;
+                line++;
+                if (line_is(body, body_end, delimiter, strip_tabs)) break;
+                if (run) handle_run(&p, body, (size_t)(body_end - body), line);
+            }
+            if (run) {
+                // The body was the script; an interpreter named before "<<" adds nothing to scan
+                instruction.length = 0;
+                continue;
+            }
+        }
+        dispatch(&p, instruction.data, instruction.length, instruction_line);
+        instruction.length = 0;
+    }
+    if (!p.failed && instruction.length > 0) {
+        dispatch(&p, instruction.data, instruction.length, instruction_line);
+    }
+
+    free(instruction.data);
+    free_variables(p.globals, p.global_count);
+    free_variables(p.locals, p.local_count);
+    free_copies(p.copies, p.copy_count);
+    for (size_t i = 0; i + 1 < df->stage_count; i++) free(p.stage_workdirs[i]);
+    free(p.stage_workdirs);
+    if (p.failed) {
+        dockerfile_destroy(df);
+        return NULL;
+    }
+    return df;
+}
+
+Dockerfile* dockerfile_parse_file(const char* root, const char* filepath, const char* context) {
+    if (!filepath) return NULL;
+
+    char path[MAX_PATH_LENGTH];
+    if (root) {
+        snprintf(path, sizeof(path), "%s/%s", root, filepath);
+    } else {
+        snprintf(path, sizeof(path), "%s", filepath);
+    }
+    size_t length;
+    char* buffer = parser_read_file(path, &length);
+    if (!buffer) return NULL;
+
+    Dockerfile* df = dockerfile_parse_buffer(filepath, context, buffer, length);
+    free(buffer);
+    return df;
+}
+
+const char* docker_reference_kind_name(DockerReferenceKind kind) {
+    switch (kind) {
+        case DOCKER_REF_COPY: return "copy";
+        case DOCKER_REF_ADD: return "add";
+        case DOCKER_REF_IMAGE: return "image";
+        case DOCKER_REF_PIP: return "pip";
+        case DOCKER_REF_NPM: return "npm";
+        case DOCKER_REF_MANIFEST: return "manifest";
+    }
+    return "unknown";
+}
+
+bool dockerfile_uses_path(const Dockerfile* df, const char* path) {
+    if (!df || !path) return false;
+
+    char changed[MAX_PATH_LENGTH];
+    snprintf(changed, sizeof(changed), "%s", path);
+    file_normalize_path(changed);
+    if (strcmp(changed, df->filepath) == 0) return true;
+
+    for (size_t i = 0; i < df->reference_count; i++) {
+        const DockerReference* ref = &df->references[i];
+        if (ref->kind != DOCKER_REF_COPY && ref->kind != DOCKER_REF_ADD) continue;
+
+        const char* source = ref->value;
+        if (strpbrk(source, "*?[")) {
+            char tree[MAX_PATH_LENGTH];
+            snprintf(tree, sizeof(tree), "%s/**", source);
+            if (ci_path_matches(source, changed) || ci_path_matches(tree, changed)) return true;
+            continue;
+        }
+        size_t length = strlen(source);
+        if (strcmp(source, ".") == 0 || strcmp(changed, source) == 0 ||
+            (strncmp(changed, source, length) == 0 && changed[length] == '/')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// Image set
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const char* root;
+    size_t root_length;
+    char** dockerfiles;
+    size_t dockerfile_count;
+    char** composes;
+    size_t compose_count;
+    int result;
+} ImageWalk;
+
+static int add_path(char*** list, size_t* count, const char* path) {
+    char** grown = realloc(*list, (*count + 1) * sizeof(char*));
+    if (!grown) return DEPTRACK_ERROR_MEMORY;
+    *list = grown;
+    if (!(grown[*count] = strdup(path))) return DEPTRACK_ERROR_MEMORY;
+    (*count)++;
+    return DEPTRACK_SUCCESS;
+}
+
+static void free_paths(char** list, size_t count) {
+    for (size_t i = 0; i < count; i++) free(list[i]);
+    free(list);
+}
+
+static int compare_paths(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static bool is_compose_file(const char* path) {
+    const char* name = base_name(path);
+    return (strncmp(name, "docker-compose", 14) == 0 || strncmp(name, "compose.", 8) == 0) &&
+           (file_has_suffix(name, ".yml") || file_has_suffix(name, ".yaml"));
+}
+
+static int image_walk_visit(const char* path, void* context) {
+    ImageWalk* walk = context;
+    const char* relative = path + walk->root_length;
+    while (*relative == '/') relative++;
+
+    if (language_classify(relative, NULL, 0) == LANG_DOCKER) {
+        return add_path(&walk->dockerfiles, &walk->dockerfile_count, relative);
+    }
+    if (is_compose_file(relative)) {
+        return add_path(&walk->composes, &walk->compose_count, relative);
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+void docker_image_set_destroy(DockerImageSet* set) {
+    if (!set) return;
+    for (size_t i = 0; i < set->image_count; i++) {
+        free(set->images[i].name);
+        dockerfile_destroy(set->images[i].dockerfile);
+    }
+    free(set->images);
+    free(set);
+}
+
+DockerImageSet* docker_image_set_load(const char* root) {
+    if (!root) return NULL;
+
+    char trimmed[MAX_PATH_LENGTH];
+    snprintf(trimmed, sizeof(trimmed), "%s", root);
+    size_t length = strlen(trimmed);
+    while (length > 1 && trimmed[length - 1] == '/') trimmed[--length] = '\0';
+
+    ImageWalk walk = { trimmed, length, NULL, 0, NULL, 0, DEPTRACK_SUCCESS };
+    walk.result = file_walk(trimmed, image_walk_visit, &walk);
+
+    DockerImageSet* set = calloc(1, sizeof(DockerImageSet));
+    char** contexts = calloc(walk.dockerfile_count ? walk.dockerfile_count : 1, sizeof(char*));
+    char** names = calloc(walk.dockerfile_count ? walk.dockerfile_count : 1, sizeof(char*));
+    bool ok = set && contexts && names && walk.result == DEPTRACK_SUCCESS;
+    if (ok) {
+        qsort(walk.dockerfiles, walk.dockerfile_count, sizeof(char*), compare_paths);
+        qsort(walk.composes, walk.compose_count, sizeof(char*), compare_paths);
+    }
+
+    // Compose services say which context and tag each Dockerfile is built with; the first file wins
+    for (size_t c = 0; ok && c < walk.compose_count; c++) {
+        char path[MAX_PATH_LENGTH];
+        if (snprintf(path, sizeof(path), "%s/%s", trimmed, walk.composes[c]) >= (int)sizeof(path)) continue;
+        ComposeFile* compose = compose_parse_file(path);
+        if (!compose) continue;
+
+        char dir[MAX_PATH_LENGTH];
+        const char* slash = strrchr(walk.composes[c], '/');
+        snprintf(dir, sizeof(dir), "%.*s", slash ? (int)(slash - walk.composes[c]) : 0, walk.composes[c]);
+        for (size_t s = 0; ok && s < compose->service_count; s++) {
+            const ComposeService* service = &compose->services[s];
+            if (!service->build_context) continue;
+            char build_context[MAX_PATH_LENGTH];
+            char dockerfile[MAX_PATH_LENGTH];
+            if (!join_path(build_context, sizeof(build_context), dir, service->build_context) ||
+                !join_path(dockerfile, sizeof(dockerfile), build_context,
+                           service->dockerfile ? service->dockerfile : "Dockerfile")) {
+                continue;
+            }
+
+            char** found = bsearch(&(char*){ dockerfile }, walk.dockerfiles, walk.dockerfile_count, sizeof(char*),
+                                   compare_paths);
+            if (!found || contexts[found - walk.dockerfiles]) continue;
+            size_t index = (size_t)(found - walk.dockerfiles);
+            contexts[index] = strdup(build_context);
+            names[index] = strdup(service->image ? service->image : service->name);
+            ok = contexts[index] && names[index];
+        }
+        compose_file_destroy(compose);
+    }
+
+    for (size_t i = 0; ok && i < walk.dockerfile_count; i++) {
+        Dockerfile* df = dockerfile_parse_file(trimmed, walk.dockerfiles[i], contexts[i]);
+        if (!df) continue;   // Unreadable Dockerfiles are left out
+        DockerImage* grown = realloc(set->images, (set->image_count + 1) * sizeof(DockerImage));
+        char* name = strdup(names[i] ? names[i] : walk.dockerfiles[i]);
+        if (!grown || !name) {
+            if (grown) set->images = grown;
+            free(name);
+            dockerfile_destroy(df);
+            ok = false;
+            break;
+        }
+        set->images = grown;
+        set->images[set->image_count].name = name;
+        set->images[set->image_count].dockerfile = df;
+        set->image_count++;
+    }
+
+    for (size_t i = 0; i < walk.dockerfile_count; i++) {
+        if (contexts) free(contexts[i]);
+        if (names) free(names[i]);
+    }
+    free(contexts);
+    free(names);
+    free_paths(walk.dockerfiles, walk.dockerfile_count);
+    free_paths(walk.composes, walk.compose_count);
+    if (!ok) {
+        docker_image_set_destroy(set);
+        return NULL;
+    }
+    return set;
+}
+
+// "registry:5000/team/app:1.2" -> length of "registry:5000/team/app"
+static size_t repository_length(const char* image) {
+    const char* at = strchr(image, '@');
+    size_t length = at ? (size_t)(at - image) : strlen(image);
+    // The tag colon comes after the last '/'; earlier ones are registry ports
+    for (size_t i = length; i-- > 0 && image[i] != '/';) {
+        if (image[i] == ':') return i;
+    }
+    return length;
+}
+
+// An untagged reference matches any tag of the image
+static bool same_image(const char* reference, const char* image) {
+    size_t a = repository_length(reference), b = repository_length(image);
+    if (a != b || strncmp(reference, image, a) != 0) return false;
+    return reference[a] == '\0' || image[b] == '\0' || strcmp(reference + a, image + b) == 0;
+}
+
+static bool builds_on(const Dockerfile* df, const char* image) {
+    for (size_t s = 0; s < df->stage_count; s++) {
+        if (df->stages[s].base_stage < 0 && df->stages[s].base && same_image(df->stages[s].base, image)) return true;
+    }
+    for (size_t r = 0; r < df->reference_count; r++) {
+        if (df->references[r].kind == DOCKER_REF_IMAGE && same_image(df->references[r].value, image)) return true;
+    }
+    return false;
+}
+
+size_t docker_images_to_rebuild(const DockerImageSet* set, const char* const* changed, size_t changed_count,
+                                bool* rebuild) {
+    if (!set || !rebuild) return 0;
+
+    size_t count = 0;
+    for (size_t i = 0; i < set->image_count; i++) {
+        rebuild[i] = false;
+        for (size_t c = 0; c < changed_count && !rebuild[i]; c++) {
+            rebuild[i] = dockerfile_uses_path(set->images[i].dockerfile, changed[c]);
+        }
+        if (rebuild[i]) count++;
+    }
+
+    // Images built FROM (or copying from) a rebuilt image are rebuilt too
+    bool grew = count > 0;
+    while (grew) {
+        grew = false;
+        for (size_t i = 0; i < set->image_count; i++) {
+            if (rebuild[i]) continue;
+            for (size_t j = 0; j < set->image_count && !rebuild[i]; j++) {
+                if (rebuild[j] && j != i && builds_on(set->images[i].dockerfile, set->images[j].name)) {
+                    rebuild[i] = true;
+                    grew = true;
+                    count++;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+ParsedFile* parse_dockerfile_buffer(const char* filepath, const char* buffer, size_t length) {
+    Dockerfile* df = dockerfile_parse_buffer(filepath, NULL, buffer, length);
+    if (!df) return NULL;
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_DOCKER);
+    for (size_t s = 0; parsed && s < df->stage_count; s++) {
+        const DockerStage* stage = &df->stages[s];
+        if (stage->base_stage >= 0 || !stage->base || strcmp(stage->base, "scratch") == 0) continue;
+        size_t length = repository_length(stage->base);
+        const char* tag = stage->base[length] ? stage->base + length + 1 : "latest";
+        if (!parsed_file_add_dependency(parsed, stage->base, length, tag, DEP_EXTERNAL, stage->line_number)) {
+            parsed_file_destroy(parsed);
+            parsed = NULL;
+        }
+    }
+    for (size_t r = 0; parsed && r < df->reference_count; r++) {
+        const DockerReference* ref = &df->references[r];
+        bool internal = ref->kind == DOCKER_REF_COPY || ref->kind == DOCKER_REF_ADD || ref->kind == DOCKER_REF_MANIFEST;
+        if (!parsed_file_add_dependency(parsed, ref->value, strlen(ref->value), ref->version,
+                                        internal ? DEP_INTERNAL : DEP_EXTERNAL, ref->line_number)) {
+            parsed_file_destroy(parsed);
+            parsed = NULL;
+        }
+    }
+    dockerfile_destroy(df);
+    return parsed;
+}
+
+ParsedFile* parse_dockerfile(const char* filepath) {
+    return parser_parse_file(filepath, parse_dockerfile_buffer);
+}
@@ -0,0 +1,565 @@
+/**
+ * @file go_parser.c
+ * @brief Go module and import parser
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Reads go.mod (module, require, replace), go.sum checksums and the import block of
+ *             .go sources
+ * @llm-key Every reader walks the whole file buffer with spans; go.mod directives are split on
+ *          whitespace in place and sources stop lexing at the first top-level declaration. Source
+ *          imports and go.sum entries record offsets, resolved to lines once at the end
+ * @llm-contract Imports under the module path are internal; versions of external imports come
+ *               from the longest matching go.mod requirement
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <string.h>
+
+#define GO_MAX_FIELDS 8
+
+typedef struct {
+    const char* start;
+    size_t length;
+} GoSpan;
+
+static bool span_is(GoSpan span, const char* text) {
+    size_t length = strlen(text);
+    return span.length == length && memcmp(span.start, text, length) == 0;
+}
+
+static char* span_dup(GoSpan span) {
+    // Quoted module paths are allowed in go.mod
+    if (span.length >= 2 && (span.start[0] == '"' || span.start[0] == '`')) {
+        return strndup(span.start + 1, span.length - 2);
+    }
+    return strndup(span.start, span.length);
+}
+
+// ---------------------------------------------------------------------------
+// go.mod
+// ---------------------------------------------------------------------------
+
+void go_mod_destroy(GoModFile* mod) {
+    if (!mod) return;
+
+    free(mod->module_path);
+    free(mod->go_version);
+    for (size_t i = 0; i < mod->require_count; i++) {
+        free(mod->requires[i].path);
+        free(mod->requires[i].version);
+    }
+    free(mod->requires);
+    for (size_t i = 0; i < mod->replace_count; i++) {
+        free(mod->replaces[i].old_path);
+        free(mod->replaces[i].old_version);
+        free(mod->replaces[i].new_path);
+        free(mod->replaces[i].new_version);
+    }
+    free(mod->replaces);
+    hashmap_destroy(mod->by_path);
+    free(mod);
+}
+
+// Splits a line into whitespace-separated fields; *comment points at a trailing // comment
+static size_t split_fields(const char* p, const char* end, GoSpan* fields, GoSpan* comment) {
+    size_t count = 0;
+    comment->start = NULL;
+    comment->length = 0;
+
+    while (p < end) {
+        while (p < end && isspace((unsigned char)*p)) p++;
+        if (p >= end) break;
+
+        if (p + 1 < end && p[0] == '/' && p[1] == '/') {
+            comment->start = p + 2;
+            comment->length = (size_t)(end - p - 2);
+            break;
+        }
+
+        const char* start = p;
+        if (*p == '"' || *p == '`') {
+            char quote = *p++;
+            while (p < end && *p != quote) {
+                if (quote == '"' && *p == '\\' && p + 1 < end) p++;
+                p++;
+            }
+            if (p < end) p++;
+        } else {
+            while (p < end && !isspace((unsigned char)*p) &&
+                   !(p + 1 < end && p[0] == '/' && p[1] == '/')) {
+                p++;
+            }
+        }
+
+        if (count < GO_MAX_FIELDS) {
+            fields[count].start = start;
+            fields[count].length = (size_t)(p - start);
+            count++;
+        }
+    }
+    return count;
+}
+
+static int add_require(GoModFile* mod, const GoSpan* fields, size_t count, GoSpan comment, int line) {
+    if (count < 2) return DEPTRACK_SUCCESS;
+
+    GoRequire* grown = realloc(mod->requires, (mod->require_count + 1) * sizeof(GoRequire));
+    if (!grown) return DEPTRACK_ERROR_MEMORY;
+    mod->requires = grown;
+
+    GoRequire* req = &mod->requires[mod->require_count];
+    req->path = span_dup(fields[0]);
+    req->version = span_dup(fields[1]);
+    req->line_number = line;
+    req->indirect = false;
+    if (comment.start) {
+        GoSpan word = { comment.start, comment.length };
+        while (word.length > 0 && isspace((unsigned char)*word.start)) { word.start++; word.length--; }
+        req->indirect = word.length >= 8 && memcmp(word.start, "indirect", 8) == 0;
+    }
+    if (!req->path || !req->version) {
+        free(req->path);
+        free(req->version);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+
+    hashmap_put(mod->by_path, req->path, mod->require_count);
+    mod->require_count++;
+    return DEPTRACK_SUCCESS;
+}
+
+// old [v] => new [v]
+static int add_replace(GoModFile* mod, const GoSpan* fields, size_t count, int line) {
+    size_t arrow = 0;
+    while (arrow < count && !span_is(fields[arrow], "=>")) arrow++;
+    if (arrow == 0 || arrow > 2 || arrow + 1 >= count) return DEPTRACK_SUCCESS;
+
+    GoReplace* grown = realloc(mod->replaces, (mod->replace_count + 1) * sizeof(GoReplace));
+    if (!grown) return DEPTRACK_ERROR_MEMORY;
+    mod->replaces = grown;
+
+    GoReplace* rep = &mod->replaces[mod->replace_count];
+    memset(rep, 0, sizeof(GoReplace));
+    rep->old_path = span_dup(fields[0]);
+    rep->old_version = arrow == 2 ? span_dup(fields[1]) : NULL;
+    rep->new_path = span_dup(fields[arrow + 1]);
+    rep->new_version = arrow + 2 < count ? span_dup(fields[arrow + 2]) : NULL;
+    rep->line_number = line;
+    mod->replace_count++;
+
+    if (!rep->old_path || !rep->new_path) return DEPTRACK_ERROR_MEMORY;
+    return DEPTRACK_SUCCESS;
+}
+
+GoModFile* go_mod_parse_buffer(const char* buffer, size_t length) {
+    if (!buffer) return NULL;
+
+    GoModFile* mod = calloc(1, sizeof(GoModFile));
+    if (!mod) return NULL;
+    mod->by_path = hashmap_create(64);
+    if (!mod->by_path) {
+        go_mod_destroy(mod);
+        return NULL;
+    }
+
+    const char* p = buffer;
+    const char* end = buffer + length;
+    int line = 0;
+    GoSpan block = { NULL, 0 };   // Directive of an open "( ... )" block
+    int result = DEPTRACK_SUCCESS;
+
+    while (p < end && result == DEPTRACK_SUCCESS) {
+        const char* nl = memchr(p, '\n', (size_t)(end - p));
+        const char* line_end = nl ? nl : end;
+        line++;
+
+        GoSpan fields[GO_MAX_FIELDS];
+        GoSpan comment;
+        size_t count = split_fields(p, line_end, fields, &comment);
+        p = nl ? nl + 1 : end;
+        if (count == 0) continue;
+
+        GoSpan* args = fields;
+        GoSpan directive = block;
+        if (block.start) {
+            if (span_is(fields[0], ")")) {
+                block.start = NULL;
+                continue;
+            }
+        } else {
+            directive = fields[0];
+            args = fields + 1;
+            count--;
+            if (count == 1 && span_is(args[0], "(")) {
+                block = directive;
+                continue;
+            }
+        }
+
+        if (span_is(directive, "module") && count >= 1) {
+            free(mod->module_path);
+            mod->module_path = span_dup(args[0]);
+        } else if (span_is(directive, "go") && count >= 1) {
+            free(mod->go_version);
+            mod->go_version = span_dup(args[0]);
+        } else if (span_is(directive, "require")) {
+            result = add_require(mod, args, count, comment, line);
+        } else if (span_is(directive, "replace")) {
+            result = add_replace(mod, args, count, line);
+        }
+        // exclude, retract, toolchain and godebug do not add edges
+    }
+
+    if (result != DEPTRACK_SUCCESS) {
+        go_mod_destroy(mod);
+        return NULL;
+    }
+    return mod;
+}
+
+GoModFile* go_mod_parse_file(const char* filepath) {
+    size_t length;
+    char* buffer = parser_read_file(filepath, &length);
+    if (!buffer) return NULL;
+
+    GoModFile* mod = go_mod_parse_buffer(buffer, length);
+    free(buffer);
+    return mod;
+}
+
+const GoRequire* go_mod_find_require(const GoModFile* mod, const char* import_path, size_t length) {
+    if (!mod || !import_path) return NULL;
+
+    // Longest module path that is the import path or a '/'-prefix of it
+    size_t index;
+    while (length > 0) {
+        if (hashmap_get_n(mod->by_path, import_path, length, &index) == 0) {
+            return &mod->requires[index];
+        }
+        while (length > 0 && import_path[length - 1] != '/') length--;
+        if (length > 0) length--;
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------
+// go.sum
+// ---------------------------------------------------------------------------
+
+void go_sum_destroy(GoSumFile* sum) {
+    if (!sum) return;
+    hashmap_destroy(sum->by_module);
+    free(sum);
+}
+
+GoSumFile* go_sum_parse_buffer(const char* buffer, size_t length) {
+    if (!buffer) return NULL;
+
+    GoSumFile* sum = calloc(1, sizeof(GoSumFile));
+    if (!sum) return NULL;
+    sum->by_module = hashmap_create(256);
+    if (!sum->by_module) {
+        free(sum);
+        return NULL;
+    }
+
+    char key[MAX_PATH_LENGTH];
+    const char* p = buffer;
+    const char* end = buffer + length;
+    while (p < end) {
+        const char* nl = memchr(p, '\n', (size_t)(end - p));
+        const char* line_end = nl ? nl : end;
+
+        GoSpan fields[GO_MAX_FIELDS];
+        GoSpan comment;
+        size_t count = split_fields(p, line_end, fields, &comment);
+        p = nl ? nl + 1 : end;
+        if (count < 3) continue;
+
+        // "path version h1:..." covers the module zip; "path version/go.mod h1:..." only go.mod
+        GoSpan version = fields[1];
+        bool go_mod_only = version.length > 7 && memcmp(version.start + version.length - 7, "/go.mod", 7) == 0;
+        if (go_mod_only) version.length -= 7;
+
+        int written = snprintf(key, sizeof(key), "%.*s@%.*s", (int)fields[0].length, fields[0].start,
+                               (int)version.length, version.start);
+        if (written <= 0 || (size_t)written >= sizeof(key)) continue;
+
+        size_t existing;
+        if (hashmap_get_n(sum->by_module, key, (size_t)written, &existing) == 0 && existing == 1) {
+            continue;
+        }
+        hashmap_put_n(sum->by_module, key, (size_t)written, go_mod_only ? 0 : 1);
+        sum->entry_count++;
+    }
+    return sum;
+}
+
+GoSumFile* go_sum_parse_file(const char* filepath) {
+    size_t length;
+    char* buffer = parser_read_file(filepath, &length);
+    if (!buffer) return NULL;
+
+    GoSumFile* sum = go_sum_parse_buffer(buffer, length);
+    free(buffer);
+    return sum;
+}
+
+bool go_sum_has(const GoSumFile* sum, const char* path, const char* version) {
+    char key[MAX_PATH_LENGTH];
+    size_t value;
+    if (!sum || !path || !version) return false;
+
+    int written = snprintf(key, sizeof(key), "%s@%s", path, version);
+    if (written <= 0 || (size_t)written >= sizeof(key)) return false;
+    return hashmap_get_n(sum->by_module, key, (size_t)written, &value) == 0 && value == 1;
+}
+
+// ---------------------------------------------------------------------------
+// .go sources
+// ---------------------------------------------------------------------------
+
+typedef enum {
+    GO_EOF,
+    GO_IDENT,
+    GO_STRING,
+    GO_SYMBOL
+} GoTokenKind;
+
+typedef struct {
+    GoTokenKind kind;
+    const char* start;
+    size_t length;
+} GoToken;
+
+typedef struct {
+    const char* start;
+    const char* p;
+    const char* end;
+} GoLexer;
+
+static GoToken go_next(GoLexer* lex) {
+    // Whitespace and comments
+    while (lex->p < lex->end) {
+        char c = *lex->p;
+        if (isspace((unsigned char)c)) {
+            lex->p++;
+        } else if (c == '/' && lex->p + 1 < lex->end && lex->p[1] == '/') {
+            const char* nl = memchr(lex->p, '\n', (size_t)(lex->end - lex->p));
+            lex->p = nl ? nl : lex->end;
+        } else if (c == '/' && lex->p + 1 < lex->end && lex->p[1] == '*') {
+            lex->p += 2;
+            while (lex->p < lex->end && !(lex->p[0] == '*' && lex->p + 1 < lex->end && lex->p[1] == '/')) {
+                lex->p++;
+            }
+            lex->p = lex->p < lex->end ? lex->p + 2 : lex->end;
+        } else {
+            break;
+        }
+    }
+
+    GoToken tok = { GO_EOF, lex->p, 0 };
+    if (lex->p >= lex->end) return tok;
+
+    const char* p = lex->p;
+    char c = *p;
+    if (isalpha((unsigned char)c) || c == '_' || (unsigned char)c >= 0x80) {
+        while (p < lex->end && (isalnum((unsigned char)*p) || *p == '_' || (unsigned char)*p >= 0x80)) p++;
+        tok.kind = GO_IDENT;
+        tok.length = (size_t)(p - tok.start);
+    } else if (c == '"' || c == '`' || c == '\'') {
+        p++;
+        while (p < lex->end && *p != c) {
+            if (c != '`' && *p == '\\' && p + 1 < lex->end) p++;
+            else if (*p == '\n' && c != '`') break;
+            p++;
+        }
+        tok.kind = GO_STRING;
+        tok.start = lex->p + 1;
+        tok.length = (size_t)(p - tok.start);
+        if (p < lex->end && *p == c) p++;
+    } else {
+        tok.kind = GO_SYMBOL;
+        tok.length = 1;
+        p++;
+    }
+
+    lex->p = p;
+    return tok;
+}
+
+static bool go_is(GoToken tok, const char* text) {
+    size_t length = strlen(text);
+    return tok.kind == GO_IDENT && tok.length == length && memcmp(tok.start, text, length) == 0;
+}
+
+static bool go_is_symbol(GoToken tok, char symbol) {
+    return tok.kind == GO_SYMBOL && *tok.start == symbol;
+}
+
+static bool add_import(ParsedFile* parsed, const GoLexer* lex, GoToken path, const GoModFile* mod) {
+    const char* version = NULL;
+    DependencyType type = DEP_EXTERNAL;
+
+    const char* slash = memchr(path.start, '/', path.length);
+    size_t first_length = slash ? (size_t)(slash - path.start) : path.length;
+    size_t module_length = mod && mod->module_path ? strlen(mod->module_path) : 0;
+
+    if (module_length > 0 && path.length >= module_length &&
+        memcmp(path.start, mod->module_path, module_length) == 0 &&
+        (path.length == module_length || path.start[module_length] == '/')) {
+        type = DEP_INTERNAL;
+    } else if (!memchr(path.start, '.', first_length)) {
+        version = "stdlib"; // Standard library paths have no dot in their first element
+    } else {
+        const GoRequire* req = go_mod_find_require(mod, path.start, path.length);
+        if (req) version = req->version;
+    }
+
+    return parsed_file_add_dependency_at(parsed, path.start, path.length, version, type,
+                                         (size_t)(path.start - lex->start)) != NULL;
+}
+
+ParsedFile* parse_go_source_buffer(const char* filepath, const char* buffer, size_t length, const GoModFile* mod) {
+    if (!buffer) return NULL;
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_GO);
+    if (!parsed) return NULL;
+
+    GoLexer lex = { buffer, buffer, buffer + length };
+    bool ok = true;
+
+    // Imports follow the package clause and precede every declaration
+    for (GoToken tok = go_next(&lex); ok && tok.kind != GO_EOF; tok = go_next(&lex)) {
+        if (go_is_symbol(tok, ';')) continue;
+        if (go_is(tok, "package")) {
+            go_next(&lex);
+            continue;
+        }
+        if (!go_is(tok, "import")) break;
+
+        GoToken spec = go_next(&lex);
+        if (go_is_symbol(spec, '(')) {
+            for (spec = go_next(&lex); spec.kind != GO_EOF && !go_is_symbol(spec, ')'); spec = go_next(&lex)) {
+                // Named (alias "x"), blank (_ "x") and dot (. "x") imports carry a name first
+                if (spec.kind == GO_STRING && !(ok = add_import(parsed, &lex, spec, mod))) break;
+            }
+        } else {
+            if (spec.kind != GO_STRING) spec = go_next(&lex);
+            if (spec.kind == GO_STRING) ok = add_import(parsed, &lex, spec, mod);
+        }
+    }
+
+    if (ok) ok = parsed_file_resolve_lines(parsed, buffer, length) == DEPTRACK_SUCCESS;
+    if (!ok) {
+        parsed_file_destroy(parsed);
+        return NULL;
+    }
+    return parsed;
+}
+
+// Nearest go.mod at or above the directory of filepath
+static GoModFile* find_go_mod(const char* filepath) {
+    char dir[MAX_PATH_LENGTH];
+    char candidate[MAX_PATH_LENGTH];
+    snprintf(dir, sizeof(dir), "%s", filepath);
+
+    char* slash = strrchr(dir, '/');
+    while (slash) {
+        *slash = '\0';
+        int written = snprintf(candidate, sizeof(candidate), "%s/go.mod", dir[0] ? dir : "");
+        if (written > 0 && (size_t)written < sizeof(candidate)) {
+            GoModFile* mod = go_mod_parse_file(candidate);
+            if (mod) return mod;
+        }
+        slash = strrchr(dir, '/');
+    }
+    // Relative paths may still sit below the working directory's module
+    return filepath[0] == '/' ? NULL : go_mod_parse_file("go.mod");
+}
+
+static ParsedFile* parse_go_mod_manifest(const char* filepath, const char* buffer, size_t length) {
+    GoModFile* mod = go_mod_parse_buffer(buffer, length);
+    if (!mod) return NULL;
+
+    // Requirements missing from a sibling go.sum have not been verified
+    char sum_path[MAX_PATH_LENGTH];
+    snprintf(sum_path, sizeof(sum_path), "%.*s", (int)(strlen(filepath) - 6), filepath);
+    strncat(sum_path, "go.sum", sizeof(sum_path) - strlen(sum_path) - 1);
+    GoSumFile* sum = go_sum_parse_file(sum_path);
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_GO);
+    for (size_t i = 0; parsed && i < mod->require_count; i++) {
+        const GoRequire* req = &mod->requires[i];
+        DependencyType type = DEP_EXTERNAL;
+        for (size_t r = 0; r < mod->replace_count; r++) {
+            const GoReplace* rep = &mod->replaces[r];
+            if (strcmp(rep->old_path, req->path) == 0 && !rep->new_version) {
+                type = DEP_INTERNAL; // Replaced by a directory inside the repository
+            }
+        }
+
+        Dependency* dep = parsed_file_add_dependency(parsed, req->path, strlen(req->path),
+                                                     req->version, type, req->line_number);
+        if (dep && sum && type == DEP_EXTERNAL && !go_sum_has(sum, req->path, req->version)) {
+            dep->status = RESOLVE_NOT_FOUND;
+        }
+    }
+
+    go_sum_destroy(sum);
+    go_mod_destroy(mod);
+    return parsed;
+}
+
+static ParsedFile* parse_go_sum_manifest(const char* filepath, const char* buffer, size_t length) {
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_GO);
+    const char* p = buffer;
+    const char* end = buffer + length;
+    while (parsed && p < end) {
+        const char* nl = memchr(p, '\n', (size_t)(end - p));
+        const char* line_end = nl ? nl : end;
+
+        GoSpan fields[GO_MAX_FIELDS];
+        GoSpan comment;
+        size_t count = split_fields(p, line_end, fields, &comment);
+        p = nl ? nl + 1 : end;
+
+        // Only module zips are dependencies; /go.mod lines just feed version selection
+        if (count < 3 || (fields[1].length > 7 &&
+                          memcmp(fields[1].start + fields[1].length - 7, "/go.mod", 7) == 0)) {
+            continue;
+        }
+        char version[MAX_VERSION_LENGTH];
+        snprintf(version, sizeof(version), "%.*s", (int)fields[1].length, fields[1].start);
+        parsed_file_add_dependency_at(parsed, fields[0].start, fields[0].length, version, DEP_EXTERNAL,
+                                      (size_t)(fields[0].start - buffer));
+    }
+    if (parsed && parsed_file_resolve_lines(parsed, buffer, length) != DEPTRACK_SUCCESS) {
+        parsed_file_destroy(parsed);
+        return NULL;
+    }
+    return parsed;
+}
+
+ParsedFile* parse_go_buffer(const char* filepath, const char* buffer, size_t length) {
+    if (!filepath || !buffer) return NULL;
+
+    if (file_has_suffix(filepath, "go.mod")) {
+        return parse_go_mod_manifest(filepath, buffer, length);
+    }
+    if (file_has_suffix(filepath, "go.sum")) {
+        return parse_go_sum_manifest(filepath, buffer, length);
+    }
+
+    GoModFile* mod = find_go_mod(filepath);
+    ParsedFile* parsed = parse_go_source_buffer(filepath, buffer, length, mod);
+    go_mod_destroy(mod);
+    return parsed;
+}
+
+ParsedFile* parse_go_file(const char* filepath) {
+    if (!filepath) return NULL;
+    return parser_parse_file(filepath, parse_go_buffer);
+}
@@ -2,6 +2,15 @@
  * @file kotlin_parser.c
  * @brief Kotlin/Gradle parser implementation
  * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Single-pass lexer for Kotlin sources and Gradle build scripts (KTS and Groovy)
+ * @llm-key Tokens are spans into the file buffer, so nothing is copied per line and no lines are
+ *          counted: dependencies record their offset and get a line once lexing is done. Sources stop
+ *          at the first declaration after the import header; build scripts track the block
+ *          stack so multi-line calls inside dependencies {} and plugins {} are recognised
+ * @llm-contract "group:artifact:version" coordinates are split into Dependency.name and .version;
+ *               version catalog accessors are kept as "libs.x.y" with version "catalog"
  */
 
 #include "dependency_tracker.h"
@@ -10,73 +19,598 @@
 #include <string.h>
 #include <ctype.h>
 
-// Simple Gradle dependency parser
-ParsedFile* parse_kotlin_gradle_file(const char* filepath) {
-    FILE* file = fopen(filepath, "r");
-    if (!file) {
-        return NULL;
+#define KT_MAX_BLOCK_DEPTH 64
+
+typedef enum {
+    KT_EOF,
+    KT_IDENT,
+    KT_STRING,
+    KT_SYMBOL
+} KtTokenKind;
+
+typedef struct {
+    KtTokenKind kind;
+    const char* start;
+    size_t length;
+} KtToken;
+
+typedef struct {
+    const char* p;
+    const char* end;
+    const char* begin;         // Token offsets are relative to this
+    KtToken peeked;
+    bool has_peeked;
+} KtLexer;
+
+typedef enum {
+    BLOCK_OTHER,
+    BLOCK_DEPENDENCIES,
+    BLOCK_PLUGINS
+} GradleBlock;
+
+static bool is_ident_char(char c) {
+    return isalnum((unsigned char)c) || c == '_' || c == '$';
+}
+
+static void kt_skip_trivia(KtLexer* lex) {
+    while (lex->p < lex->end) {
+        char c = *lex->p;
+        if (c == '\n' || c == ' ' || c == '\t' || c == '\r' || c == '\f') {
+            lex->p++;
+        } else if (c == '/' && lex->p + 1 < lex->end && lex->p[1] == '/') {
+            const char* nl = memchr(lex->p, '\n', (size_t)(lex->end - lex->p));
+            lex->p = nl ? nl : lex->end;
+        } else if (c == '/' && lex->p + 1 < lex->end && lex->p[1] == '*') {
+            // Kotlin block comments nest
+            int depth = 0;
+            do {
+                if (lex->p[0] == '/' && lex->p + 1 < lex->end && lex->p[1] == '*') {
+                    depth++;
+                    lex->p += 2;
+                } else if (lex->p[0] == '*' && lex->p + 1 < lex->end && lex->p[1] == '/') {
+                    depth--;
+                    lex->p += 2;
+                } else {
+                    lex->p++;
+                }
+            } while (depth > 0 && lex->p < lex->end);
+        } else {
+            break;
+        }
+    }
+}
+
+// Skips a ${...} template expression; p points just past the '{'
+static const char* kt_skip_template(KtLexer* lex, const char* p) {
+    int depth = 1;
+    while (p < lex->end && depth > 0) {
+        if (*p == '{') depth++;
+        else if (*p == '}') depth--;
+        p++;
+    }
+    return p;
+}
+
+static KtToken kt_next(KtLexer* lex) {
+    if (lex->has_peeked) {
+        lex->has_peeked = false;
+        return lex->peeked;
+    }
+
+    kt_skip_trivia(lex);
+
+    KtToken tok = { KT_EOF, lex->p, 0 };
+    if (lex->p >= lex->end) {
+        return tok;
+    }
+
+    const char* p = lex->p;
+    char c = *p;
+
+    if (is_ident_char(c)) {
+        // Dotted chains (a.b.C, libs.foo.bar) lex as one identifier
+        const char* start = p;
+        while (p < lex->end && (is_ident_char(*p) ||
+               (*p == '.' && p + 1 < lex->end && is_ident_char(p[1])))) {
+            p++;
+        }
+        tok.kind = KT_IDENT;
+        tok.start = start;
+        tok.length = (size_t)(p - start);
+    } else if (c == '`') {
+        const char* close = memchr(p + 1, '`', (size_t)(lex->end - p - 1));
+        const char* stop = close ? close : lex->end;
+        tok.kind = KT_IDENT;
+        tok.start = p + 1;
+        tok.length = (size_t)(stop - p - 1);
+        p = close ? close + 1 : lex->end;
+    } else if (c == '"' && lex->end - p >= 3 && p[1] == '"' && p[2] == '"') {
+        const char* start = p + 3;
+        p = start;
+        while (p < lex->end && !(p[0] == '"' && lex->end - p >= 3 && p[1] == '"' && p[2] == '"')) {
+            if (p[0] == '$' && p + 1 < lex->end && p[1] == '{') {
+                p = kt_skip_template(lex, p + 2);
+                continue;
+            }
+            p++;
+        }
+        tok.kind = KT_STRING;
+        tok.start = start;
+        tok.length = (size_t)(p - start);
+        p = p < lex->end ? p + 3 : lex->end;
+        // Raw strings may end with extra quotes: """a""""
+        while (p < lex->end && *p == '"') p++;
+    } else if (c == '"' || c == '\'') {
+        const char* start = p + 1;
+        p = start;
+        while (p < lex->end && *p != c && *p != '\n') {
+            if (*p == '\\' && p + 1 < lex->end) {
+                p += 2;
+                continue;
+            }
+            if (c == '"' && p[0] == '$' && p + 1 < lex->end && p[1] == '{') {
+                p = kt_skip_template(lex, p + 2);
+                continue;
+            }
+            p++;
+        }
+        tok.kind = KT_STRING;
+        tok.start = start;
+        tok.length = (size_t)(p - start);
+        if (p < lex->end && *p == c) p++;
+    } else {
+        tok.kind = KT_SYMBOL;
+        tok.start = p++;
+        tok.length = 1;
+    }
+
+    lex->p = p;
+    return tok;
+}
+
+static KtToken kt_peek(KtLexer* lex) {
+    if (!lex->has_peeked) {
+        lex->peeked = kt_next(lex);
+        lex->has_peeked = true;
+    }
+    return lex->peeked;
+}
+
+static bool kt_is(KtToken tok, const char* text) {
+    size_t len = strlen(text);
+    return tok.kind == KT_IDENT && tok.length == len && memcmp(tok.start, text, len) == 0;
+}
+
+static bool kt_is_symbol(KtToken tok, char symbol) {
+    return tok.kind == KT_SYMBOL && *tok.start == symbol;
+}
+
+static bool kt_has_prefix(KtToken tok, const char* prefix) {
+    size_t len = strlen(prefix);
+    return tok.length >= len && memcmp(tok.start, prefix, len) == 0;
+}
+
+// Consumes tokens through the ')' matching an already consumed '('
+static void kt_skip_parens(KtLexer* lex) {
+    int depth = 1;
+    while (depth > 0) {
+        KtToken tok = kt_next(lex);
+        if (tok.kind == KT_EOF) return;
+        if (kt_is_symbol(tok, '(')) depth++;
+        else if (kt_is_symbol(tok, ')')) depth--;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Kotlin sources
+// ---------------------------------------------------------------------------
+
+// Number of leading dotted segments shared by two qualified names
+static size_t shared_segments(const char* a, size_t a_len, const char* b, size_t b_len) {
+    size_t segments = 0;
+    size_t i = 0;
+    while (i < a_len && i < b_len && a[i] == b[i]) {
+        i++;
+        if ((i == a_len || a[i] == '.') && (i == b_len || b[i] == '.')) {
+            segments++;
+        }
+    }
+    return segments;
+}
+
+ParsedFile* parse_kotlin_source_buffer(const char* filepath, const char* buffer, size_t length) {
+    if (!buffer) return NULL;
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_KOTLIN);
+    if (!parsed) return NULL;
+
+    KtLexer lex = { buffer, buffer + length, buffer, { KT_EOF, NULL, 0 }, false };
+    KtToken package = { KT_EOF, NULL, 0 };
+
+    // The import header ends at the first declaration, so the file body is never lexed
+    for (;;) {
+        KtToken tok = kt_next(&lex);
+        if (tok.kind == KT_EOF) break;
+
+        if (kt_is_symbol(tok, ';')) {
+            continue;
+        }
+
+        if (kt_is_symbol(tok, '@')) {
+            // @file:JvmName("...") style annotations precede the package directive
+            KtToken name = kt_next(&lex);
+            if (kt_is(name, "file") && kt_is_symbol(kt_peek(&lex), ':')) {
+                kt_next(&lex);
+                kt_next(&lex);
+            }
+            if (kt_is_symbol(kt_peek(&lex), '(')) {
+                kt_next(&lex);
+                kt_skip_parens(&lex);
+            }
+            continue;
+        }
+
+        if (kt_is(tok, "package")) {
+            package = kt_next(&lex);
+            continue;
+        }
+
+        if (!kt_is(tok, "import")) {
+            break;
+        }
+
+        KtToken path = kt_next(&lex);
+        if (path.kind != KT_IDENT) continue;
+
+        // "import a.b.*" imports the package a.b
+        if (kt_is_symbol(kt_peek(&lex), '.')) {
+            kt_next(&lex);
+            if (kt_is_symbol(kt_peek(&lex), '*')) kt_next(&lex);
+        }
+        if (kt_is(kt_peek(&lex), "as")) {
+            kt_next(&lex);
+            kt_next(&lex);
+        }
+
+        // Imports sharing the first two package segments belong to this project
+        DependencyType type = DEP_EXTERNAL;
+        if (package.kind == KT_IDENT &&
+            shared_segments(path.start, path.length, package.start, package.length) >= 2) {
+            type = DEP_INTERNAL;
+        }
+        if (!parsed_file_add_dependency_at(parsed, path.start, path.length, NULL, type,
+                                           (size_t)(path.start - lex.begin))) {
+            parsed_file_destroy(parsed);
+            return NULL;
+        }
     }
 
-    ParsedFile* parsed = calloc(1, sizeof(ParsedFile));
-    if (!parsed) {
-        fclose(file);
+    if (parsed_file_resolve_lines(parsed, buffer, length) != DEPTRACK_SUCCESS) {
+        parsed_file_destroy(parsed);
         return NULL;
     }
+    return parsed;
+}
+
+// ---------------------------------------------------------------------------
+// Gradle build scripts
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const char* group;
+    size_t group_length;
+    const char* name;
+    size_t name_length;
+    const char* version;
+    size_t version_length;
+    bool internal;
+    bool catalog;
+    bool kotlin_module;        // kotlin("x") shorthand for org.jetbrains.kotlin:kotlin-x
+    size_t offset;
+} GradleCoordinate;
+
+static bool add_coordinate(ParsedFile* parsed, const GradleCoordinate* coord, DependencyType type) {
+    char name[MAX_NAME_LENGTH];
+    char version[MAX_VERSION_LENGTH];
+    int written;
+
+    if (coord->kotlin_module) {
+        written = snprintf(name, sizeof(name), "org.jetbrains.kotlin:kotlin-%.*s",
+                           (int)coord->name_length, coord->name);
+    } else if (coord->group && coord->group_length > 0) {
+        written = snprintf(name, sizeof(name), "%.*s:%.*s",
+                           (int)coord->group_length, coord->group,
+                           (int)coord->name_length, coord->name);
+    } else {
+        written = snprintf(name, sizeof(name), "%.*s", (int)coord->name_length, coord->name);
+    }
+    if (written <= 0 || (size_t)written >= sizeof(name)) {
+        return true; // Oversized coordinates are skipped rather than truncated
+    }
+
+    const char* version_text = NULL;
+    if (coord->catalog) {
+        version_text = "catalog";
+    } else if (coord->version && coord->version_length > 0 &&
+               coord->version_length < sizeof(version)) {
+        memcpy(version, coord->version, coord->version_length);
+        version[coord->version_length] = '\0';
+        version_text = version;
+    }
 
-    parsed->filepath = strdup(filepath);
-    parsed->language = LANG_KOTLIN;
-    parsed->dependencies = calloc(MAX_DEPENDENCIES, sizeof(Dependency));
-    parsed->dep_count = 0;
-    parsed->dep_capacity = MAX_DEPENDENCIES;
+    if (coord->internal) {
+        type = DEP_INTERNAL;
+    } else if (strncmp(name, "org.jetbrains.kotlin", 20) == 0) {
+        type = DEP_BUILD_TOOL;
+    }
 
-    char line[1024];
-    int line_number = 0;
+    return parsed_file_add_dependency_at(parsed, name, (size_t)written, version_text, type, coord->offset) != NULL;
+}
 
-    while (fgets(line, sizeof(line), file) && parsed->dep_count < MAX_DEPENDENCIES) {
-        line_number++;
+// Splits "group:artifact[:version[:classifier]][@ext]" held in a string token
+static void split_coordinate(KtToken str, GradleCoordinate* coord) {
+    const char* start = str.start;
+    const char* end = str.start + str.length;
+    const char* at = memchr(start, '@', str.length);
+    if (at) end = at;
 
-        // Remove newline
-        line[strcspn(line, "\n")] = 0;
+    const char* first = memchr(start, ':', (size_t)(end - start));
+    if (!first) {
+        coord->name = start;
+        coord->name_length = (size_t)(end - start);
+        return;
+    }
 
-        // Look for implementation("...") or api("...") dependencies
-        char* impl_start = strstr(line, "implementation(\"");
-        char* api_start = strstr(line, "api(\"");
-        char* dep_start = impl_start ? impl_start + 16 : (api_start ? api_start + 5 : NULL);
+    const char* second = memchr(first + 1, ':', (size_t)(end - first - 1));
+    coord->group = start;
+    coord->group_length = (size_t)(first - start);
+    coord->name = first + 1;
+    coord->name_length = (size_t)((second ? second : end) - first - 1);
+    if (second) {
+        const char* third = memchr(second + 1, ':', (size_t)(end - second - 1));
+        coord->version = second + 1;
+        coord->version_length = (size_t)((third ? third : end) - second - 1);
+    }
+}
+
+// Parses one dependency notation; the opening '(' of the configuration call is consumed
+static bool parse_dependency_notation(KtLexer* lex, GradleCoordinate* coord) {
+    KtToken tok = kt_next(lex);
+    coord->offset = (size_t)(tok.start - lex->begin);
 
-        if (dep_start) {
-            char* dep_end = strchr(dep_start, '"');
-            if (dep_end) {
-                size_t dep_len = dep_end - dep_start;
-                if (dep_len > 0 && dep_len < MAX_NAME_LENGTH) {
-                    Dependency* dep = &parsed->dependencies[parsed->dep_count];
-                    dep->name = strndup(dep_start, dep_len);
-                    dep->type = strstr(dep->name, "org.jetbrains.kotlin") ? DEP_BUILD_TOOL : DEP_EXTERNAL;
-                    dep->source_file = strdup(filepath);
-                    dep->line_number = line_number;
-                    dep->status = RESOLVE_SUCCESS;
-                    dep->version = strdup("unknown"); // TODO: Parse version
+    if (tok.kind == KT_STRING) {
+        split_coordinate(tok, coord);
+        return coord->name_length > 0;
+    }
 
-                    parsed->dep_count++;
+    if (tok.kind != KT_IDENT) {
+        return false;
+    }
 
-                    printf("  Found dependency: %s (line %d)\n", dep->name, line_number);
+    // Version catalog accessor: libs.foo.bar
+    if (kt_has_prefix(tok, "libs.")) {
+        coord->name = tok.start;
+        coord->name_length = tok.length;
+        coord->catalog = true;
+        return true;
+    }
+
+    if (!kt_is_symbol(kt_peek(lex), '(') && !kt_is_symbol(kt_peek(lex), '=')) {
+        return false;
+    }
+
+    // platform(...) / enforcedPlatform(...) wrap another notation
+    if (kt_is(tok, "platform") || kt_is(tok, "enforcedPlatform")) {
+        kt_next(lex);
+        bool ok = parse_dependency_notation(lex, coord);
+        kt_skip_parens(lex);
+        return ok;
+    }
+
+    if (kt_is(tok, "project")) {
+        kt_next(lex);
+        KtToken path = kt_next(lex);
+        if (kt_is(path, "path") && kt_is_symbol(kt_peek(lex), '=')) {
+            kt_next(lex);
+            path = kt_next(lex);
+        }
+        if (path.kind == KT_STRING) {
+            coord->name = path.start;
+            coord->name_length = path.length;
+            coord->internal = true;
+        }
+        kt_skip_parens(lex);
+        return coord->name_length > 0;
+    }
+
+    // kotlin("stdlib", "1.9.0") is org.jetbrains.kotlin:kotlin-stdlib:1.9.0
+    if (kt_is(tok, "kotlin")) {
+        kt_next(lex);
+        KtToken module = kt_next(lex);
+        if (module.kind != KT_STRING) {
+            kt_skip_parens(lex);
+            return false;
+        }
+        coord->name = module.start;
+        coord->name_length = module.length;
+        coord->kotlin_module = true;
+        if (kt_is_symbol(kt_peek(lex), ',')) {
+            kt_next(lex);
+            KtToken version = kt_next(lex);
+            if (version.kind == KT_STRING) {
+                coord->version = version.start;
+                coord->version_length = version.length;
+            }
+        }
+        kt_skip_parens(lex);
+        return true;
+    }
+
+    // Named arguments: group = "g", name = "a", version = "v"
+    if (kt_is_symbol(kt_peek(lex), '=')) {
+        KtToken key = tok;
+        for (;;) {
+            kt_next(lex); // '='
+            KtToken value = kt_next(lex);
+            if (value.kind == KT_STRING) {
+                if (kt_is(key, "group")) {
+                    coord->group = value.start;
+                    coord->group_length = value.length;
+                } else if (kt_is(key, "name")) {
+                    coord->name = value.start;
+                    coord->name_length = value.length;
+                } else if (kt_is(key, "version")) {
+                    coord->version = value.start;
+                    coord->version_length = value.length;
                 }
             }
+            if (!kt_is_symbol(kt_peek(lex), ',')) break;
+            kt_next(lex);
+            key = kt_next(lex);
+            if (key.kind != KT_IDENT || !kt_is_symbol(kt_peek(lex), '=')) break;
+        }
+        return coord->name_length > 0;
+    }
+
+    return false; // files(), fileTree() and other notations carry no coordinates
+}
+
+// Configurations whose dependencies only run at build time
+static bool is_build_tool_configuration(KtToken tok) {
+    return kt_is(tok, "kapt") || kt_is(tok, "ksp") || kt_is(tok, "annotationProcessor") ||
+           kt_is(tok, "classpath") || kt_has_prefix(tok, "kapt") || kt_has_prefix(tok, "ksp");
+}
+
+// A configuration call inside dependencies {}: implementation(...), testImplementation "..."
+static bool parse_dependency_call(KtLexer* lex, ParsedFile* parsed, KtToken configuration) {
+    GradleCoordinate coord;
+    memset(&coord, 0, sizeof(coord));
+
+    KtToken next = kt_peek(lex);
+    bool parenthesized = kt_is_symbol(next, '(');
+    bool ok;
+
+    if (parenthesized) {
+        kt_next(lex);
+        ok = parse_dependency_notation(lex, &coord);
+    } else if (next.kind == KT_STRING) {
+        // Groovy: implementation 'g:a:v'
+        ok = parse_dependency_notation(lex, &coord);
+    } else {
+        return true;
+    }
+
+    bool added = true;
+    if (ok) {
+        DependencyType type = is_build_tool_configuration(configuration) ? DEP_BUILD_TOOL : DEP_EXTERNAL;
+        added = add_coordinate(parsed, &coord, type);
+    }
+
+    if (parenthesized) {
+        // Drop whatever is left of the argument list, e.g. a trailing version or classifier
+        int depth = 1;
+        while (depth > 0) {
+            KtToken tok = kt_peek(lex);
+            if (tok.kind == KT_EOF) break;
+            kt_next(lex);
+            if (kt_is_symbol(tok, '(')) depth++;
+            else if (kt_is_symbol(tok, ')')) depth--;
+        }
+    }
+    return added;
+}
+
+// plugins {}: id("x") version "v", kotlin("jvm") version "v", alias(libs.plugins.x)
+static bool parse_plugin(KtLexer* lex, ParsedFile* parsed, KtToken keyword) {
+    GradleCoordinate coord;
+    memset(&coord, 0, sizeof(coord));
+    coord.offset = (size_t)(keyword.start - lex->begin);
+
+    bool parenthesized = kt_is_symbol(kt_peek(lex), '(');
+    if (parenthesized) kt_next(lex);
+
+    KtToken id = kt_next(lex);
+    if (kt_is(keyword, "alias") && id.kind == KT_IDENT) {
+        coord.name = id.start;
+        coord.name_length = id.length;
+        coord.catalog = true;
+    } else if (id.kind == KT_STRING) {
+        coord.name = id.start;
+        coord.name_length = id.length;
+        coord.kotlin_module = kt_is(keyword, "kotlin");
+    }
+    if (parenthesized) kt_skip_parens(lex);
+
+    if (kt_is(kt_peek(lex), "version")) {
+        kt_next(lex);
+        KtToken version = kt_next(lex);
+        if (version.kind == KT_STRING) {
+            coord.version = version.start;
+            coord.version_length = version.length;
+        }
+    }
+
+    if (coord.name_length == 0) return true;
+    return add_coordinate(parsed, &coord, DEP_BUILD_TOOL);
+}
+
+ParsedFile* parse_gradle_buffer(const char* filepath, const char* buffer, size_t length) {
+    if (!buffer) return NULL;
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_KOTLIN);
+    if (!parsed) return NULL;
+
+    KtLexer lex = { buffer, buffer + length, buffer, { KT_EOF, NULL, 0 }, false };
+    GradleBlock blocks[KT_MAX_BLOCK_DEPTH];
+    size_t depth = 0;
+    KtToken previous = { KT_EOF, NULL, 0 };
+    bool ok = true;
+
+    while (ok) {
+        KtToken tok = kt_next(&lex);
+        if (tok.kind == KT_EOF) break;
+
+        if (kt_is_symbol(tok, '{')) {
+            // A block is named by the identifier right before its brace: dependencies {
+            GradleBlock block = BLOCK_OTHER;
+            if (kt_is(previous, "dependencies")) block = BLOCK_DEPENDENCIES;
+            else if (kt_is(previous, "plugins")) block = BLOCK_PLUGINS;
+            if (depth < KT_MAX_BLOCK_DEPTH) blocks[depth] = block;
+            depth++;
+        } else if (kt_is_symbol(tok, '}')) {
+            if (depth > 0) depth--;
+        } else if (tok.kind == KT_IDENT && depth > 0 && depth <= KT_MAX_BLOCK_DEPTH) {
+            GradleBlock block = blocks[depth - 1];
+            if (block == BLOCK_DEPENDENCIES) {
+                ok = parse_dependency_call(&lex, parsed, tok);
+            } else if (block == BLOCK_PLUGINS &&
+                       (kt_is(tok, "id") || kt_is(tok, "kotlin") || kt_is(tok, "alias"))) {
+                ok = parse_plugin(&lex, parsed, tok);
+            }
         }
+
+        previous = tok;
     }
 
-    fclose(file);
+    if (!ok || parsed_file_resolve_lines(parsed, buffer, length) != DEPTRACK_SUCCESS) {
+        parsed_file_destroy(parsed);
+        return NULL;
+    }
     return parsed;
 }
 
+ParsedFile* parse_kotlin_gradle_file(const char* filepath) {
+    return parser_parse_file(filepath, parse_gradle_buffer);
+}
+
 // Main parser entry point
 ParsedFile* parse_kotlin_file(const char* filepath) {
     if (!filepath) return NULL;
 
     // Check if it's a Gradle file
-    if (strstr(filepath, "build.gradle.kts") || strstr(filepath, "build.gradle")) {
+    if (file_has_suffix(filepath, ".gradle.kts") || file_has_suffix(filepath, ".gradle")) {
         return parse_kotlin_gradle_file(filepath);
     }
 
-    // For .kt files, we'd parse imports here (stub for now)
-    return NULL;
+    return parser_parse_file(filepath, parse_kotlin_source_buffer);
 }
@@ -0,0 +1,268 @@
+/**
+ * @file language_classifier.c
+ * @brief File classification by name, extension, shebang and modeline
+ * @author Unhinged Development Team
+ *
+ * @llm-type util
+ * @llm-legend Maps a path (and optionally the first bytes of the file) to the Language that parses it
+ * @llm-key One static perfect-hash table holds well-known file names ("Makefile"), extensions
+ *          (".py") and interpreter or modeline modes ("!python"); every lookup is one hash, one
+ *          slot and one memcmp, with no allocation
+ * @llm-contract Name beats extension beats content; requirements*.txt and friends still go through
+ *               python_is_manifest, and files nothing recognizes are LANG_UNKNOWN
+ */
+
+#include "dependency_tracker.h"
+#include <string.h>
+
+#define CLASSIFIER_SLOTS 128
+#define CLASSIFIER_BUCKETS 64
+#define CLASSIFIER_MAX_KEY 32
+// How far into the file a modeline is looked for
+#define CLASSIFIER_MODELINE_WINDOW 512
+
+typedef struct {
+    const char* key;
+    size_t length;
+    Language language;
+} ClassifierEntry;
+
+// Hash-and-displace layout: a key's hash picks a bucket (top 6 bits) whose displacement moves it
+// to a free slot. A new key goes at language_classifier_slot(key); if that slot is taken, raise its
+// bucket's displacement until every key of the bucket lands on a free slot. The test suite runs
+// language_classifier_verify over the table.
+#define CLASSIFIER_SEED 0x00000001u
+static const uint8_t classifier_displacement[CLASSIFIER_BUCKETS] = {
+      0,   0,   0,   1,   0,   0,   0,   0,   0,   0,   0,   1,   0,   2,   9,   1,
+      4,   0,   0,   0,   0,   0,   1,   0,   0,   0,   1,   0,   5,   0,   0,   0,
+      1,   0,   4,   0,   0,   0,   1,   1,   0,   0,   0,   3,   2,   0,   0,   1,
+      0,   4,   0,   2,   0,   0,   2,   0,   0,   0,   0,   2,   0,   0,   3,   0,
+};
+static const ClassifierEntry classifier_table[CLASSIFIER_SLOTS] = {
+    [  0] = { "!c", 2, LANG_C },
+    [  2] = { "!sh", 3, LANG_SHELL },
+    [  3] = { "!nodejs", 7, LANG_TYPESCRIPT },
+    [  8] = { "!sql", 4, LANG_SQL },
+    [ 12] = { "!kotlin", 7, LANG_KOTLIN },
+    [ 13] = { ".yaml", 5, LANG_YAML },
+    [ 14] = { "!js", 3, LANG_TYPESCRIPT },
+    [ 16] = { ".profile", 8, LANG_SHELL },
+    [ 19] = { "!dash", 5, LANG_SHELL },
+    [ 20] = { ".hpp", 4, LANG_C },
+    [ 23] = { ".bash", 5, LANG_SHELL },
+    [ 24] = { ".cxx", 4, LANG_C },
+    [ 25] = { ".zshrc", 6, LANG_SHELL },
+    [ 27] = { "!tsx", 4, LANG_TYPESCRIPT },
+    [ 28] = { ".sql", 4, LANG_SQL },
+    [ 29] = { "!gmake", 6, LANG_MAKE },
+    [ 30] = { ".ksh", 4, LANG_SHELL },
+    [ 31] = { "Containerfile", 13, LANG_DOCKER },
+    [ 32] = { ".mk", 3, LANG_MAKE },
+    [ 33] = { "!bash", 5, LANG_SHELL },
+    [ 34] = { "!yaml", 5, LANG_YAML },
+    [ 35] = { "!rust", 5, LANG_RUST },
+    [ 36] = { "!node", 5, LANG_TYPESCRIPT },
+    [ 37] = { "go.sum", 6, LANG_GO },
+    [ 39] = { "!dockerfile", 11, LANG_DOCKER },
+    [ 43] = { "!deno", 5, LANG_TYPESCRIPT },
+    [ 44] = { ".kt", 3, LANG_KOTLIN },
+    [ 45] = { ".h", 2, LANG_C },
+    [ 49] = { "!zsh", 4, LANG_SHELL },
+    [ 52] = { ".tsx", 4, LANG_TYPESCRIPT },
+    [ 54] = { "!javascript", 11, LANG_TYPESCRIPT },
+    [ 55] = { "!python", 7, LANG_PYTHON },
+    [ 56] = { "GNUmakefile", 11, LANG_MAKE },
+    [ 57] = { ".yml", 4, LANG_YAML },
+    [ 58] = { ".bash_profile", 13, LANG_SHELL },
+    [ 59] = { "Cargo.lock", 10, LANG_RUST },
+    [ 63] = { ".Dockerfile", 11, LANG_DOCKER },
+    [ 66] = { ".go", 3, LANG_GO },
+    [ 68] = { ".hh", 3, LANG_C },
+    [ 69] = { ".cjs", 4, LANG_TYPESCRIPT },
+    [ 70] = { ".cpp", 4, LANG_C },
+    [ 71] = { ".sh", 3, LANG_SHELL },
+    [ 72] = { ".py", 3, LANG_PYTHON },
+    [ 74] = { ".jsx", 4, LANG_TYPESCRIPT },
+    [ 75] = { ".mjs", 4, LANG_TYPESCRIPT },
+    [ 77] = { ".bashrc", 7, LANG_SHELL },
+    [ 78] = { "package.json", 12, LANG_TYPESCRIPT },
+    [ 85] = { ".pyi", 4, LANG_PYTHON },
+    [ 86] = { "dockerfile", 10, LANG_DOCKER },
+    [ 87] = { "!pypy", 5, LANG_PYTHON },
+    [ 88] = { "!typescript", 11, LANG_TYPESCRIPT },
+    [ 89] = { ".ts", 3, LANG_TYPESCRIPT },
+    [ 90] = { ".inl", 4, LANG_C },
+    [ 93] = { "Cargo.toml", 10, LANG_RUST },
+    [ 94] = { "!ksh", 4, LANG_SHELL },
+    [ 95] = { "makefile", 8, LANG_MAKE },
+    [ 96] = { ".c", 2, LANG_C },
+    [ 97] = { ".dockerfile", 11, LANG_DOCKER },
+    [ 98] = { "!makefile", 9, LANG_MAKE },
+    [ 99] = { ".rs", 3, LANG_RUST },
+    [100] = { ".js", 3, LANG_TYPESCRIPT },
+    [101] = { "!cpp", 4, LANG_C },
+    [103] = { "go.mod", 6, LANG_GO },
+    [104] = { ".proto", 6, LANG_PROTO },
+    [105] = { ".mts", 4, LANG_TYPESCRIPT },
+    [106] = { ".zsh", 4, LANG_SHELL },
+    [107] = { ".kts", 4, LANG_KOTLIN },
+    [108] = { "!ash", 4, LANG_SHELL },
+    [111] = { ".cts", 4, LANG_TYPESCRIPT },
+    [112] = { "!make", 5, LANG_MAKE },
+    [114] = { ".cc", 3, LANG_C },
+    [115] = { ".gradle", 7, LANG_KOTLIN },
+    [116] = { "!go", 3, LANG_GO },
+    [117] = { "!ts-node", 8, LANG_TYPESCRIPT },
+    [118] = { "Dockerfile", 10, LANG_DOCKER },
+    [119] = { ".hxx", 4, LANG_C },
+    [120] = { "!proto", 6, LANG_PROTO },
+    [121] = { "!bun", 4, LANG_TYPESCRIPT },
+    [122] = { "!shell-script", 13, LANG_SHELL },
+    [125] = { "pyproject.toml", 14, LANG_PYTHON },
+    [126] = { "Makefile", 8, LANG_MAKE },
+};
+
+static uint32_t classifier_hash(const char* key, size_t length) {
+    uint32_t h = CLASSIFIER_SEED ^ (uint32_t)length;
+    for (size_t i = 0; i < length; i++) {
+        h = (h ^ (unsigned char)key[i]) * 16777619u;
+    }
+    return h;
+}
+
+size_t language_classifier_slot(const char* key, size_t length) {
+    uint32_t h = classifier_hash(key, length);
+    return (h + classifier_displacement[h >> 26]) & (CLASSIFIER_SLOTS - 1);
+}
+
+size_t language_classifier_verify(void) {
+    size_t misplaced = 0;
+    for (size_t slot = 0; slot < CLASSIFIER_SLOTS; slot++) {
+        const ClassifierEntry* entry = &classifier_table[slot];
+        if (entry->key && (entry->length != strlen(entry->key) ||
+                           language_classifier_slot(entry->key, entry->length) != slot)) {
+            misplaced++;
+        }
+    }
+    return misplaced;
+}
+
+static Language lookup(const char* key, size_t length) {
+    if (length == 0 || length >= CLASSIFIER_MAX_KEY) return LANG_UNKNOWN;
+    const ClassifierEntry* entry = &classifier_table[language_classifier_slot(key, length)];
+    // Empty slots have length 0, so they never compare equal
+    if (entry->length == length && memcmp(entry->key, key, length) == 0) return entry->language;
+    return LANG_UNKNOWN;
+}
+
+// Looks up "!word" for interpreter and modeline names
+static Language lookup_mode(const char* word, size_t length) {
+    char key[CLASSIFIER_MAX_KEY];
+    if (length + 1 >= sizeof(key)) return LANG_UNKNOWN;
+    key[0] = '!';
+    memcpy(key + 1, word, length);
+    return lookup(key, length + 1);
+}
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// #!/usr/bin/env -S python3.11 -u, #!/bin/bash -e, #!/usr/bin/make -f
+static Language classify_shebang(const char* head, size_t length) {
+    const char* end = memchr(head, '\n', length);
+    if (!end) end = head + length;
+    const char* p = head + 2;
+
+    for (;;) {
+        while (p < end && is_space(*p)) p++;
+        const char* word = p;
+        while (p < end && !is_space(*p)) p++;
+        if (word == p) return LANG_UNKNOWN;
+
+        // Interpreter name without its directory
+        const char* base = word;
+        for (const char* q = word; q < p; q++) {
+            if (*q == '/') base = q + 1;
+        }
+        size_t base_length = (size_t)(p - base);
+        bool env = base_length == 3 && memcmp(base, "env", 3) == 0;
+        if (env || *word == '-') continue;   // env and its options name no language
+
+        // python3.11 -> python
+        while (base_length > 0 && ((base[base_length - 1] >= '0' && base[base_length - 1] <= '9') ||
+                                   base[base_length - 1] == '.')) {
+            base_length--;
+        }
+        return lookup_mode(base, base_length);
+    }
+}
+
+// vim: set ft=python:, vim: filetype=sh, -*- mode: python -*-, -*- sh -*-
+static Language classify_modeline(const char* head, size_t length) {
+    if (length > CLASSIFIER_MODELINE_WINDOW) length = CLASSIFIER_MODELINE_WINDOW;
+    const char* end = head + length;
+
+    for (const char* p = head; p < end; p++) {
+        const char* value = NULL;
+        if (p + 3 <= end && memcmp(p, "-*-", 3) == 0) {
+            value = p + 3;
+            while (value < end && is_space(*value)) value++;
+            if (end - value > 5 && memcmp(value, "mode:", 5) == 0) value += 5;
+        } else if (p + 3 <= end && (memcmp(p, "ft=", 3) == 0 ||
+                                    (p + 9 <= end && memcmp(p, "filetype=", 9) == 0))) {
+            // Only inside a vim:/vi:/ex: modeline on the same line
+            const char* line = p;
+            while (line > head && line[-1] != '\n') line--;
+            bool modeline = false;
+            for (const char* q = line; q + 3 <= p && !modeline; q++) {
+                modeline = memcmp(q, "vi:", 3) == 0 || memcmp(q, "ex:", 3) == 0 ||
+                           (q + 4 <= p && memcmp(q, "vim:", 4) == 0);
+            }
+            if (!modeline) continue;
+            value = p + (*p == 'f' && p[1] == 't' ? 3 : 9);
+        } else {
+            continue;
+        }
+
+        while (value < end && is_space(*value)) value++;
+        const char* stop = value;
+        while (stop < end && !is_space(*stop) && *stop != ':' && *stop != ';' && *stop != '\n') stop++;
+        Language language = lookup_mode(value, (size_t)(stop - value));
+        if (language != LANG_UNKNOWN) return language;
+    }
+    return LANG_UNKNOWN;
+}
+
+Language language_classify(const char* filepath, const char* head, size_t head_length) {
+    if (!filepath) {
+        return LANG_UNKNOWN;
+    }
+
+    const char* base = strrchr(filepath, '/');
+    base = base ? base + 1 : filepath;
+    size_t base_length = strlen(base);
+
+    Language language = lookup(base, base_length);
+    if (language != LANG_UNKNOWN) return language;
+
+    // Dockerfile.llm, Dockerfile.image-gen
+    if (base_length > 11 && memcmp(base, "Dockerfile.", 11) == 0) return LANG_DOCKER;
+
+    // A leading dot is a hidden file's name, not an extension
+    const char* dot = strrchr(base, '.');
+    if (dot && dot != base) {
+        language = lookup(dot, base_length - (size_t)(dot - base));
+        if (language != LANG_UNKNOWN) return language;
+        if (python_is_manifest(filepath)) return LANG_PYTHON;
+    }
+
+    if (head && head_length >= 2) {
+        if (head[0] == '#' && head[1] == '!') {
+            language = classify_shebang(head, head_length);
+            if (language != LANG_UNKNOWN) return language;
+        }
+        return classify_modeline(head, head_length);
+    }
+    return LANG_UNKNOWN;
+}
@@ -0,0 +1,1100 @@
+/**
+ * @file makefile_parser.c
+ * @brief GNU Makefile rule, variable and recipe parser
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Turns a Makefile into targets with prerequisites, sub-make invocations and the
+ *             scripts their recipes run, plus a parallel schedule over the target graph
+ * @llm-key Rules and variables are read in one pass; recipes are analyzed afterwards, as make
+ *          does, so every variable is known when `$(VAR)` and `$(call f,...)` are expanded
+ * @llm-contract Conditionals are not evaluated: every branch contributes rules and variables.
+ *               Only targets defined in the file take part in the schedule
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <string.h>
+
+#define MAKE_MAX_EXPANSION_DEPTH 16
+#define MAKE_MAX_CALL_ARGS 9
+
+// ---------------------------------------------------------------------------
+// Growable strings and lists
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} MakeBuffer;
+
+static bool buffer_append(MakeBuffer* buffer, const char* text, size_t length) {
+    if (buffer->length + length + 1 > buffer->capacity) {
+        size_t capacity = buffer->capacity ? buffer->capacity : 128;
+        while (capacity < buffer->length + length + 1) capacity *= 2;
+        char* grown = realloc(buffer->data, capacity);
+        if (!grown) return false;
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->length, text, length);
+    buffer->length += length;
+    buffer->data[buffer->length] = '\0';
+    return true;
+}
+
+static int list_add(char*** list, size_t* count, const char* text, size_t length) {
+    for (size_t i = 0; i < *count; i++) {
+        if (strlen((*list)[i]) == length && memcmp((*list)[i], text, length) == 0) {
+            return DEPTRACK_SUCCESS;
+        }
+    }
+    char** grown = realloc(*list, (*count + 1) * sizeof(char*));
+    if (!grown) return DEPTRACK_ERROR_MEMORY;
+    *list = grown;
+    (*list)[*count] = strndup(text, length);
+    if (!(*list)[*count]) return DEPTRACK_ERROR_MEMORY;
+    (*count)++;
+    return DEPTRACK_SUCCESS;
+}
+
+static void list_free(char** list, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(list[i]);
+    }
+    free(list);
+}
+
+// ---------------------------------------------------------------------------
+// Model
+// ---------------------------------------------------------------------------
+
+void makefile_destroy(Makefile* mf) {
+    if (!mf) return;
+
+    for (size_t i = 0; i < mf->target_count; i++) {
+        MakeTarget* target = &mf->targets[i];
+        free(target->name);
+        free(target->help);
+        list_free(target->prerequisites, target->prerequisite_count);
+        list_free(target->order_only, target->order_only_count);
+        list_free(target->recipe, target->recipe_count);
+        list_free(target->invocations, target->invocation_count);
+        list_free(target->scripts, target->script_count);
+        list_free(target->calls, target->call_count);
+    }
+    free(mf->targets);
+    for (size_t i = 0; i < mf->variable_count; i++) {
+        free(mf->variables[i].name);
+        free(mf->variables[i].value);
+    }
+    free(mf->variables);
+    list_free(mf->includes, mf->include_count);
+    list_free(mf->phony, mf->phony_count);
+    hashmap_destroy(mf->by_name);
+    hashmap_destroy(mf->variables_by_name);
+    free(mf);
+}
+
+const MakeTarget* makefile_find_target(const Makefile* mf, const char* name) {
+    size_t index;
+    if (!mf || !name || hashmap_get(mf->by_name, name, &index) != 0) return NULL;
+    return &mf->targets[index];
+}
+
+static const MakeVariable* find_variable(const Makefile* mf, const char* name, size_t length) {
+    size_t index;
+    if (hashmap_get_n(mf->variables_by_name, name, length, &index) != 0) return NULL;
+    return &mf->variables[index];
+}
+
+static MakeTarget* get_target(Makefile* mf, const char* name, size_t length, int line) {
+    size_t index;
+    if (hashmap_get_n(mf->by_name, name, length, &index) == 0) {
+        return &mf->targets[index];
+    }
+
+    if (mf->target_count >= mf->target_capacity) {
+        size_t capacity = mf->target_capacity ? mf->target_capacity * 2 : 64;
+        MakeTarget* grown = realloc(mf->targets, capacity * sizeof(MakeTarget));
+        if (!grown) return NULL;
+        mf->targets = grown;
+        mf->target_capacity = capacity;
+    }
+
+    MakeTarget* target = &mf->targets[mf->target_count];
+    memset(target, 0, sizeof(MakeTarget));
+    target->name = strndup(name, length);
+    target->line_number = line;
+    if (!target->name || hashmap_put_n(mf->by_name, name, length, mf->target_count) != 0) {
+        free(target->name);
+        return NULL;
+    }
+    mf->target_count++;
+    return target;
+}
+
+static int set_variable(Makefile* mf, const char* name, size_t name_length, const char* value,
+                        size_t value_length, bool append, bool conditional, int line) {
+    size_t index;
+    if (hashmap_get_n(mf->variables_by_name, name, name_length, &index) == 0) {
+        MakeVariable* var = &mf->variables[index];
+        if (conditional) return DEPTRACK_SUCCESS;
+        MakeBuffer buffer = { NULL, 0, 0 };
+        bool ok = (!append || (buffer_append(&buffer, var->value, strlen(var->value)) &&
+                               buffer_append(&buffer, " ", 1))) &&
+                  buffer_append(&buffer, value, value_length);
+        if (!ok) {
+            free(buffer.data);
+            return DEPTRACK_ERROR_MEMORY;
+        }
+        free(var->value);
+        var->value = buffer.data;
+        var->line_number = line;
+        return DEPTRACK_SUCCESS;
+    }
+
+    MakeVariable* grown = realloc(mf->variables, (mf->variable_count + 1) * sizeof(MakeVariable));
+    if (!grown) return DEPTRACK_ERROR_MEMORY;
+    mf->variables = grown;
+
+    MakeVariable* var = &mf->variables[mf->variable_count];
+    var->name = strndup(name, name_length);
+    var->value = strndup(value, value_length);
+    var->line_number = line;
+    if (!var->name || !var->value ||
+        hashmap_put_n(mf->variables_by_name, name, name_length, mf->variable_count) != 0) {
+        free(var->name);
+        free(var->value);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+    mf->variable_count++;
+    return DEPTRACK_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Expansion
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const Makefile* mf;
+    const MakeTarget* target;  // For $@, $< and $^
+    const char* args[MAKE_MAX_CALL_ARGS + 1];
+    size_t arg_lengths[MAKE_MAX_CALL_ARGS + 1];
+    size_t arg_count;
+} ExpandContext;
+
+static bool expand_into(const ExpandContext* ctx, const char* text, size_t length, MakeBuffer* out, int depth);
+
+// Index just past the ')' or '}' matching the opener at text[start]
+static size_t find_reference_end(const char* text, size_t length, size_t start) {
+    char open = text[start];
+    char close = open == '(' ? ')' : '}';
+    int nesting = 0;
+    for (size_t i = start; i < length; i++) {
+        if (text[i] == open) nesting++;
+        else if (text[i] == close && --nesting == 0) return i + 1;
+    }
+    return length;
+}
+
+static void trim(const char** text, size_t* length) {
+    while (*length > 0 && isspace((unsigned char)**text)) {
+        (*text)++;
+        (*length)--;
+    }
+    while (*length > 0 && isspace((unsigned char)(*text)[*length - 1])) (*length)--;
+}
+
+static bool expand_call(const ExpandContext* ctx, const char* inner, size_t length, MakeBuffer* out, int depth) {
+    // Arguments split on top-level commas; the first names the macro
+    const char* parts[MAKE_MAX_CALL_ARGS + 1];
+    size_t part_lengths[MAKE_MAX_CALL_ARGS + 1];
+    size_t part_count = 0;
+    size_t start = 0;
+    int nesting = 0;
+    for (size_t i = 0; i <= length && part_count <= MAKE_MAX_CALL_ARGS; i++) {
+        if (i < length && (inner[i] == '(' || inner[i] == '{')) nesting++;
+        else if (i < length && (inner[i] == ')' || inner[i] == '}')) nesting--;
+        else if (i == length || (inner[i] == ',' && nesting == 0)) {
+            parts[part_count] = inner + start;
+            part_lengths[part_count] = i - start;
+            part_count++;
+            start = i + 1;
+        }
+    }
+    if (part_count == 0) return true;
+
+    MakeBuffer name = { NULL, 0, 0 };
+    const char* name_text = parts[0];
+    size_t name_length = part_lengths[0];
+    trim(&name_text, &name_length);
+    if (!expand_into(ctx, name_text, name_length, &name, depth + 1)) {
+        free(name.data);
+        return false;
+    }
+
+    // Arguments are expanded before the body, as in make
+    ExpandContext call = { ctx->mf, ctx->target, { NULL }, { 0 }, 0 };
+    MakeBuffer args[MAKE_MAX_CALL_ARGS + 1];
+    memset(args, 0, sizeof(args));
+    bool ok = true;
+    for (size_t i = 1; ok && i < part_count; i++) {
+        ok = expand_into(ctx, parts[i], part_lengths[i], &args[i], depth + 1);
+        call.args[i] = args[i].data ? args[i].data : "";
+        call.arg_lengths[i] = args[i].length;
+        call.arg_count = i;
+    }
+
+    const MakeVariable* macro = name.data ? find_variable(ctx->mf, name.data, name.length) : NULL;
+    if (ok && macro) {
+        ok = expand_into(&call, macro->value, strlen(macro->value), out, depth + 1);
+    }
+
+    for (size_t i = 0; i <= MAKE_MAX_CALL_ARGS; i++) {
+        free(args[i].data);
+    }
+    free(name.data);
+    return ok;
+}
+
+static bool expand_reference(const ExpandContext* ctx, const char* inner, size_t length, MakeBuffer* out, int depth) {
+    if (length > 5 && memcmp(inner, "call", 4) == 0 && isspace((unsigned char)inner[4])) {
+        return expand_call(ctx, inner + 5, length - 5, out, depth);
+    }
+
+    // Other functions ($(shell ...), $(wildcard ...)) have no static value
+    for (size_t i = 0; i < length; i++) {
+        if (isspace((unsigned char)inner[i])) return true;
+    }
+
+    MakeBuffer name = { NULL, 0, 0 };
+    if (!expand_into(ctx, inner, length, &name, depth + 1)) {
+        free(name.data);
+        return false;
+    }
+
+    bool ok = true;
+    if (name.length == 1 && name.data[0] >= '1' && name.data[0] <= '9') {
+        size_t arg = (size_t)(name.data[0] - '0');
+        if (arg <= ctx->arg_count && ctx->args[arg]) ok = buffer_append(out, ctx->args[arg], ctx->arg_lengths[arg]);
+    } else if (name.length == 4 && memcmp(name.data, "MAKE", 4) == 0) {
+        ok = buffer_append(out, "make", 4);
+    } else if (name.data) {
+        const MakeVariable* var = find_variable(ctx->mf, name.data, name.length);
+        if (var) ok = expand_into(ctx, var->value, strlen(var->value), out, depth + 1);
+    }
+    free(name.data);
+    return ok;
+}
+
+static bool expand_automatic(const ExpandContext* ctx, char c, MakeBuffer* out) {
+    const MakeTarget* target = ctx->target;
+    if (c >= '1' && c <= '9') {
+        size_t arg = (size_t)(c - '0');
+        return arg > ctx->arg_count || !ctx->args[arg] || buffer_append(out, ctx->args[arg], ctx->arg_lengths[arg]);
+    }
+    if (!target) return true;
+    if (c == '@') return buffer_append(out, target->name, strlen(target->name));
+    if (c == '<' && target->prerequisite_count > 0) {
+        return buffer_append(out, target->prerequisites[0], strlen(target->prerequisites[0]));
+    }
+    if (c == '^') {
+        for (size_t i = 0; i < target->prerequisite_count; i++) {
+            if ((i && !buffer_append(out, " ", 1)) ||
+                !buffer_append(out, target->prerequisites[i], strlen(target->prerequisites[i]))) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool expand_into(const ExpandContext* ctx, const char* text, size_t length, MakeBuffer* out, int depth) {
+    if (depth > MAKE_MAX_EXPANSION_DEPTH) {
+        return buffer_append(out, text, length); // Recursive variable: leave it unexpanded
+    }
+    if (!buffer_append(out, "", 0)) return false;
+
+    size_t run = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] != '$' || i + 1 >= length) continue;
+        if (!buffer_append(out, text + run, i - run)) return false;
+
+        char next = text[i + 1];
+        if (next == '$') {
+            if (!buffer_append(out, "$", 1)) return false;
+            i++;
+        } else if (next == '(' || next == '{') {
+            size_t end = find_reference_end(text, length, i + 1);
+            size_t inner_length = end > i + 2 ? end - i - 3 : 0;
+            if (end <= length && text[end - 1] != next && !expand_reference(ctx, text + i + 2, inner_length, out, depth)) {
+                return false;
+            }
+            i = end - 1;
+        } else {
+            if (!expand_automatic(ctx, next, out)) return false;
+            i++;
+        }
+        run = i + 1;
+    }
+    return buffer_append(out, text + run, length - run);
+}
+
+char* makefile_expand(const Makefile* mf, const MakeTarget* target, const char* text) {
+    if (!mf || !text) return NULL;
+
+    ExpandContext ctx = { mf, target, { NULL }, { 0 }, 0 };
+    MakeBuffer out = { NULL, 0, 0 };
+    if (!expand_into(&ctx, text, strlen(text), &out, 0)) {
+        free(out.data);
+        return NULL;
+    }
+    return out.data;
+}
+
+// ---------------------------------------------------------------------------
+// Recipe analysis
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const char* start;
+    size_t length;
+    bool op;                   // Shell control operator: && || ; | & ( )
+} ShellWord;
+
+// Splits one expanded recipe line into words; quotes group but are kept out of the word
+static size_t shell_words(char* line, ShellWord* words, size_t max) {
+    size_t count = 0;
+    char* p = line;
+    while (*p && count < max) {
+        while (*p && isspace((unsigned char)*p)) p++;
+        if (!*p) break;
+
+        if (strchr(";|&()", *p)) {
+            char* start = p++;
+            if ((*start == '&' || *start == '|') && *p == *start) p++;
+            words[count++] = (ShellWord){ start, (size_t)(p - start), true };
+            continue;
+        }
+
+        // Quotes are removed in place so the word stays contiguous
+        char* start = p;
+        char* write = p;
+        while (*p && !isspace((unsigned char)*p) && !strchr(";|&()", *p)) {
+            if (*p == '"' || *p == '\'') {
+                char quote = *p++;
+                while (*p && *p != quote) {
+                    if (*p == '\\' && quote == '"' && p[1]) p++;
+                    *write++ = *p++;
+                }
+                if (*p) p++;
+            } else {
+                if (*p == '\\' && p[1]) p++;
+                *write++ = *p++;
+            }
+        }
+        words[count++] = (ShellWord){ start, (size_t)(write - start), false };
+        if (write < p) memset(write, ' ', (size_t)(p - write));
+    }
+    return count;
+}
+
+static bool word_is(ShellWord word, const char* text) {
+    size_t length = strlen(text);
+    return word.length == length && memcmp(word.start, text, length) == 0;
+}
+
+static bool is_interpreter(ShellWord word) {
+    const char* base = word.start;
+    for (size_t i = 0; i < word.length; i++) {
+        if (word.start[i] == '/') base = word.start + i + 1;
+    }
+    size_t length = (size_t)(word.start + word.length - base);
+    static const char* interpreters[] = { "bash", "sh", "zsh", "node", "perl", "ruby", NULL };
+    for (size_t i = 0; interpreters[i]; i++) {
+        if (strlen(interpreters[i]) == length && memcmp(base, interpreters[i], length) == 0) return true;
+    }
+    // python, python3, python3.12
+    if (length < 6 || memcmp(base, "python", 6) != 0) return false;
+    for (size_t i = 6; i < length; i++) {
+        if (!isdigit((unsigned char)base[i]) && base[i] != '.') return false;
+    }
+    return true;
+}
+
+static bool has_script_extension(ShellWord word) {
+    static const char* extensions[] = { ".py", ".sh", ".bash", ".js", ".mjs", ".ts", ".pl", ".rb", NULL };
+    for (size_t i = 0; extensions[i]; i++) {
+        size_t length = strlen(extensions[i]);
+        if (word.length > length && memcmp(word.start + word.length - length, extensions[i], length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int record_script(MakeTarget* target, const char* cwd, ShellWord word) {
+    if (word.length == 0 || word.start[0] == '$' || word.start[0] == '-') return DEPTRACK_SUCCESS;
+
+    char path[MAX_PATH_LENGTH];
+    int written = word.start[0] == '/' || !cwd[0]
+        ? snprintf(path, sizeof(path), "%.*s", (int)word.length, word.start)
+        : snprintf(path, sizeof(path), "%s/%.*s", cwd, (int)word.length, word.start);
+    if (written <= 0 || (size_t)written >= sizeof(path)) return DEPTRACK_SUCCESS;
+    file_normalize_path(path);
+    return list_add(&target->scripts, &target->script_count, path, strlen(path));
+}
+
+static const char* command_prefixes[] = {
+    "exec", "time", "sudo", "env", "nohup", "command", "!", "then", "else", "do", "if", "while", "until", "elif", NULL
+};
+
+// One simple command (words between operators); cwd tracks `cd` within the recipe line
+static int analyze_command(MakeTarget* target, ShellWord* words, size_t count, char* cwd, size_t cwd_size) {
+    size_t i = 0;
+    while (i < count) {
+        ShellWord word = words[i];
+        // Make recipe prefixes
+        while (word.length > 0 && (word.start[0] == '@' || word.start[0] == '-' || word.start[0] == '+')) {
+            word.start++;
+            word.length--;
+        }
+        words[i] = word;
+        bool prefix = word.length == 0 || memchr(word.start, '=', word.length) != NULL;
+        for (size_t k = 0; !prefix && command_prefixes[k]; k++) {
+            prefix = word_is(word, command_prefixes[k]);
+        }
+        if (!prefix) break;
+        i++;
+    }
+    if (i >= count) return DEPTRACK_SUCCESS;
+
+    ShellWord command = words[i];
+    if (word_is(command, "for") || word_is(command, "case") || word_is(command, "[") ||
+        word_is(command, "test") || word_is(command, "echo") || word_is(command, "printf")) {
+        return DEPTRACK_SUCCESS;
+    }
+
+    if (word_is(command, "cd")) {
+        if (i + 1 < count && words[i + 1].length > 0 && words[i + 1].start[0] != '$' && words[i + 1].start[0] != '-') {
+            char next[MAX_PATH_LENGTH];
+            ShellWord dir = words[i + 1];
+            if (dir.start[0] == '/' || !cwd[0]) snprintf(next, sizeof(next), "%.*s", (int)dir.length, dir.start);
+            else snprintf(next, sizeof(next), "%s/%.*s", cwd, (int)dir.length, dir.start);
+            file_normalize_path(next);
+            snprintf(cwd, cwd_size, "%s", strcmp(next, ".") == 0 ? "" : next);
+        }
+        return DEPTRACK_SUCCESS;
+    }
+
+    if (word_is(command, "make")) {
+        // Sub-makes of other directories or files are not targets of this Makefile
+        for (size_t k = i + 1; k < count; k++) {
+            if (word_is(words[k], "-C") || word_is(words[k], "-f") || word_is(words[k], "--directory") ||
+                word_is(words[k], "--file")) {
+                return DEPTRACK_SUCCESS;
+            }
+        }
+        for (size_t k = i + 1; k < count; k++) {
+            ShellWord arg = words[k];
+            if (arg.length == 0 || arg.start[0] == '-' || memchr(arg.start, '=', arg.length) ||
+                memchr(arg.start, '>', arg.length) || arg.start[0] == '$') {
+                continue;
+            }
+            int result = list_add(&target->invocations, &target->invocation_count, arg.start, arg.length);
+            if (result != DEPTRACK_SUCCESS) return result;
+        }
+        return DEPTRACK_SUCCESS;
+    }
+
+    if (is_interpreter(command)) {
+        for (size_t k = i + 1; k < count; k++) {
+            ShellWord arg = words[k];
+            // -c runs inline code and -m a module: no script file
+            if (word_is(arg, "-c") || word_is(arg, "-m")) return DEPTRACK_SUCCESS;
+            if (arg.length > 0 && arg.start[0] == '-') continue;
+            return record_script(target, cwd, arg);
+        }
+        return DEPTRACK_SUCCESS;
+    }
+
+    // Direct execution: ./tool, or a path to a script file
+    bool dot_slash = command.length > 2 && command.start[0] == '.' && command.start[1] == '/';
+    bool has_slash = memchr(command.start, '/', command.length) != NULL;
+    if (dot_slash || (has_slash && has_script_extension(command))) {
+        return record_script(target, cwd, command);
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+static int analyze_recipe_line(MakeTarget* target, char* line) {
+    ShellWord words[256];
+    size_t count = shell_words(line, words, sizeof(words) / sizeof(words[0]));
+    char cwd[MAX_PATH_LENGTH] = "";
+
+    size_t start = 0;
+    for (size_t i = 0; i <= count; i++) {
+        if (i < count && !words[i].op) continue;
+        // Redirection targets are not commands or arguments
+        size_t end = i;
+        size_t kept = start;
+        for (size_t k = start; k < end; k++) {
+            bool redirect = words[k].length > 0 && (words[k].start[0] == '>' || words[k].start[0] == '<' ||
+                            (words[k].length > 1 && isdigit((unsigned char)words[k].start[0]) && words[k].start[1] == '>'));
+            if (redirect) {
+                bool bare = words[k].start[words[k].length - 1] == '>' || words[k].start[words[k].length - 1] == '<';
+                if (bare) k++;
+                continue;
+            }
+            words[kept++] = words[k];
+        }
+        int result = analyze_command(target, words + start, kept - start, cwd, sizeof(cwd));
+        if (result != DEPTRACK_SUCCESS) return result;
+        // A subshell or pipeline stage keeps the cwd of this line; a new line resets it
+        start = i + 1;
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+// Records the macros named by $(call NAME,...) in raw recipe text
+static int record_calls(MakeTarget* target, const char* text) {
+    for (const char* p = strstr(text, "$(call "); p; p = strstr(p + 1, "$(call ")) {
+        const char* name = p + 7;
+        while (*name == ' ') name++;
+        size_t length = 0;
+        while (name[length] && name[length] != ',' && name[length] != ')' && !isspace((unsigned char)name[length])) {
+            length++;
+        }
+        if (length > 0 && name[0] != '$') {
+            int result = list_add(&target->calls, &target->call_count, name, length);
+            if (result != DEPTRACK_SUCCESS) return result;
+        }
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+static int analyze_recipes(Makefile* mf) {
+    for (size_t t = 0; t < mf->target_count; t++) {
+        MakeTarget* target = &mf->targets[t];
+        for (size_t r = 0; r < target->recipe_count; r++) {
+            int result = record_calls(target, target->recipe[r]);
+            if (result != DEPTRACK_SUCCESS) return result;
+
+            char* expanded = makefile_expand(mf, target, target->recipe[r]);
+            if (!expanded) return DEPTRACK_ERROR_MEMORY;
+
+            // Macro bodies may span several lines, each its own shell
+            char* save = NULL;
+            for (char* line = strtok_r(expanded, "\n", &save); line && result == DEPTRACK_SUCCESS;
+                 line = strtok_r(NULL, "\n", &save)) {
+                result = analyze_recipe_line(target, line);
+            }
+            free(expanded);
+            if (result != DEPTRACK_SUCCESS) return result;
+        }
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// Parsing
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    Makefile* mf;
+    MakeBuffer line;           // Logical line with continuations joined
+    MakeTarget** current;      // Targets of the rule whose recipe is being read
+    size_t current_count;
+    char* define_name;         // Open define block
+    MakeBuffer define_body;
+    bool define_append;
+    int define_line;
+} MakeParseState;
+
+static bool is_word_boundary(const char* text, size_t length, size_t i) {
+    return i >= length || isspace((unsigned char)text[i]);
+}
+
+static bool starts_with_word(const char* text, size_t length, const char* word) {
+    size_t word_length = strlen(word);
+    return length >= word_length && memcmp(text, word, word_length) == 0 &&
+           is_word_boundary(text, length, word_length);
+}
+
+// Finds an assignment operator outside references; returns its offset or SIZE_MAX
+static size_t find_assignment(const char* text, size_t length, size_t* op_length) {
+    int nesting = 0;
+    for (size_t i = 0; i < length; i++) {
+        char c = text[i];
+        if (c == '$' && i + 1 < length && (text[i + 1] == '(' || text[i + 1] == '{')) {
+            nesting++;
+            i++;
+        } else if ((c == ')' || c == '}') && nesting > 0) {
+            nesting--;
+        } else if (nesting == 0 && c == '=') {
+            *op_length = 1;
+            if (i > 0 && strchr(":?+!", text[i - 1])) {
+                size_t start = i - 1;
+                while (text[start] == ':' && start > 0 && text[start - 1] == ':') start--; // ::= and :::=
+                *op_length = i + 1 - start;
+                return start;
+            }
+            return i;
+        } else if (nesting == 0 && c == ':' && !(i + 1 < length && (text[i + 1] == '=' || text[i + 1] == ':'))) {
+            return SIZE_MAX; // A rule, possibly with a target-specific assignment
+        }
+    }
+    return SIZE_MAX;
+}
+
+static int handle_assignment(MakeParseState* state, const char* text, size_t length, size_t op, size_t op_length, int line) {
+    const char* name = text;
+    size_t name_length = op;
+    trim(&name, &name_length);
+    const char* value = text + op + op_length;
+    size_t value_length = length - op - op_length;
+    trim(&value, &value_length);
+
+    char kind = text[op];
+    if (kind == '!') return DEPTRACK_SUCCESS; // Shell assignment: value only known at run time
+    return set_variable(state->mf, name, name_length, value, value_length, kind == '+', kind == '?', line);
+}
+
+static int add_words(Makefile* mf, char*** list, size_t* count, const char* text, size_t length) {
+    char* raw = strndup(text, length);
+    if (!raw) return DEPTRACK_ERROR_MEMORY;
+    char* expanded = makefile_expand(mf, NULL, raw);
+    free(raw);
+    if (!expanded) return DEPTRACK_ERROR_MEMORY;
+
+    int result = DEPTRACK_SUCCESS;
+    char* save = NULL;
+    for (char* word = strtok_r(expanded, " \t", &save); word && result == DEPTRACK_SUCCESS;
+         word = strtok_r(NULL, " \t", &save)) {
+        result = list_add(list, count, word, strlen(word));
+    }
+    free(expanded);
+    return result;
+}
+
+static int handle_rule(MakeParseState* state, const char* text, size_t length, int line) {
+    Makefile* mf = state->mf;
+    state->current_count = 0;
+
+    // "targets : prerequisites | order-only ; recipe ## help"
+    const char* help = NULL;
+    size_t help_length = 0;
+    const char* hash = NULL;
+    for (size_t i = 0; i < length; i++) {
+        if (text[i] == '#' && (i == 0 || text[i - 1] != '\\')) {
+            hash = text + i;
+            break;
+        }
+    }
+    if (hash) {
+        if (hash + 1 < text + length && hash[1] == '#') {
+            help = hash + 2;
+            help_length = (size_t)(text + length - help);
+            trim(&help, &help_length);
+        }
+        length = (size_t)(hash - text);
+    }
+
+    size_t colon = 0;
+    int nesting = 0;
+    for (; colon < length; colon++) {
+        if (text[colon] == '$' && colon + 1 < length && (text[colon + 1] == '(' || text[colon + 1] == '{')) nesting++;
+        else if ((text[colon] == ')' || text[colon] == '}') && nesting > 0) nesting--;
+        else if (text[colon] == ':' && nesting == 0) break;
+    }
+    if (colon >= length) return DEPTRACK_SUCCESS;
+    size_t rest = colon + 1;
+    if (rest < length && text[rest] == ':') rest++; // Double-colon rule
+
+    const char* prereqs = text + rest;
+    size_t prereq_length = length - rest;
+    const char* inline_recipe = memchr(prereqs, ';', prereq_length);
+    if (inline_recipe) prereq_length = (size_t)(inline_recipe - prereqs);
+
+    // target: VAR = value sets a target-specific variable, not prerequisites
+    size_t op_length;
+    bool target_variable = find_assignment(prereqs, prereq_length, &op_length) != SIZE_MAX;
+
+    char** names = NULL;
+    size_t name_count = 0;
+    int result = add_words(mf, &names, &name_count, text, colon);
+
+    if (result == DEPTRACK_SUCCESS && name_count > 0 && strcmp(names[0], ".PHONY") == 0) {
+        result = add_words(mf, &mf->phony, &mf->phony_count, prereqs, prereq_length);
+        list_free(names, name_count);
+        return result;
+    }
+
+    MakeTarget** current = realloc(state->current, (name_count ? name_count : 1) * sizeof(MakeTarget*));
+    if (!current) result = DEPTRACK_ERROR_MEMORY;
+    else state->current = current;
+
+    for (size_t i = 0; result == DEPTRACK_SUCCESS && i < name_count; i++) {
+        if (names[i][0] == '.' && isupper((unsigned char)names[i][1])) continue; // .SUFFIXES and friends
+
+        MakeTarget* target = get_target(mf, names[i], strlen(names[i]), line);
+        if (!target) {
+            result = DEPTRACK_ERROR_MEMORY;
+            break;
+        }
+        state->current[state->current_count++] = target;
+        if (target_variable) continue;
+
+        if (help && !target->help) {
+            target->help = strndup(help, help_length);
+        }
+        const char* bar = memchr(prereqs, '|', prereq_length);
+        size_t normal_length = bar ? (size_t)(bar - prereqs) : prereq_length;
+        result = add_words(mf, &target->prerequisites, &target->prerequisite_count, prereqs, normal_length);
+        if (result == DEPTRACK_SUCCESS && bar) {
+            result = add_words(mf, &target->order_only, &target->order_only_count, bar + 1,
+                               prereq_length - normal_length - 1);
+        }
+        if (result == DEPTRACK_SUCCESS && inline_recipe) {
+            const char* recipe = inline_recipe + 1;
+            size_t recipe_length = (size_t)(text + length - recipe);
+            trim(&recipe, &recipe_length);
+            if (recipe_length > 0) {
+                result = list_add(&target->recipe, &target->recipe_count, recipe, recipe_length);
+            }
+        }
+    }
+
+    list_free(names, name_count);
+    return result;
+}
+
+static int handle_line(MakeParseState* state, const char* text, size_t length, int line) {
+    Makefile* mf = state->mf;
+
+    if (state->define_name) {
+        const char* trimmed = text;
+        size_t trimmed_length = length;
+        trim(&trimmed, &trimmed_length);
+        if (starts_with_word(trimmed, trimmed_length, "endef")) {
+            int result = set_variable(mf, state->define_name, strlen(state->define_name),
+                                      state->define_body.data ? state->define_body.data : "",
+                                      state->define_body.length, state->define_append, false, state->define_line);
+            free(state->define_name);
+            free(state->define_body.data);
+            state->define_name = NULL;
+            memset(&state->define_body, 0, sizeof(MakeBuffer));
+            return result;
+        }
+        bool ok = (state->define_body.length == 0 || buffer_append(&state->define_body, "\n", 1)) &&
+                  buffer_append(&state->define_body, text, length);
+        return ok ? DEPTRACK_SUCCESS : DEPTRACK_ERROR_MEMORY;
+    }
+
+    // Recipe lines belong to the most recent rule
+    if (length > 0 && text[0] == '\t') {
+        const char* recipe = text + 1;
+        size_t recipe_length = length - 1;
+        trim(&recipe, &recipe_length);
+        for (size_t i = 0; i < state->current_count && recipe_length > 0; i++) {
+            MakeTarget* target = state->current[i];
+            char** grown = realloc(target->recipe, (target->recipe_count + 1) * sizeof(char*));
+            if (!grown) return DEPTRACK_ERROR_MEMORY;
+            target->recipe = grown;
+            target->recipe[target->recipe_count] = strndup(recipe, recipe_length);
+            if (!target->recipe[target->recipe_count]) return DEPTRACK_ERROR_MEMORY;
+            target->recipe_count++;
+        }
+        if (state->current_count > 0 || recipe_length == 0) return DEPTRACK_SUCCESS;
+    }
+
+    trim(&text, &length);
+    if (length == 0 || text[0] == '#') return DEPTRACK_SUCCESS;
+
+    // Assignment modifiers do not change what the variable holds
+    while (starts_with_word(text, length, "export") || starts_with_word(text, length, "override") ||
+           starts_with_word(text, length, "private")) {
+        size_t skip = text[0] == 'e' ? 6 : text[0] == 'o' ? 8 : 7;
+        text += skip;
+        length -= skip;
+        trim(&text, &length);
+    }
+
+    if (starts_with_word(text, length, "define")) {
+        const char* name = text + 6;
+        size_t name_length = length - 6;
+        trim(&name, &name_length);
+        // define NAME := / define NAME +=
+        size_t op_length = 0;
+        size_t op = find_assignment(name, name_length, &op_length);
+        state->define_append = op != SIZE_MAX && name[op] == '+';
+        if (op != SIZE_MAX) name_length = op;
+        trim(&name, &name_length);
+        state->define_name = strndup(name, name_length);
+        state->define_line = line;
+        state->current_count = 0;
+        return state->define_name ? DEPTRACK_SUCCESS : DEPTRACK_ERROR_MEMORY;
+    }
+
+    static const char* conditionals[] = { "ifeq", "ifneq", "ifdef", "ifndef", "else", "endif", NULL };
+    for (size_t i = 0; conditionals[i]; i++) {
+        if (starts_with_word(text, length, conditionals[i])) return DEPTRACK_SUCCESS;
+    }
+
+    if (starts_with_word(text, length, "include") || starts_with_word(text, length, "-include") ||
+        starts_with_word(text, length, "sinclude")) {
+        const char* files = memchr(text, ' ', length);
+        if (!files) files = memchr(text, '\t', length);
+        state->current_count = 0;
+        return files ? add_words(mf, &mf->includes, &mf->include_count, files, (size_t)(text + length - files))
+                     : DEPTRACK_SUCCESS;
+    }
+    if (starts_with_word(text, length, "unexport") || starts_with_word(text, length, "vpath")) {
+        return DEPTRACK_SUCCESS;
+    }
+
+    size_t op_length;
+    size_t op = find_assignment(text, length, &op_length);
+    if (op != SIZE_MAX) {
+        state->current_count = 0;
+        return handle_assignment(state, text, length, op, op_length, line);
+    }
+    return handle_rule(state, text, length, line);
+}
+
+Makefile* makefile_parse_buffer(const char* buffer, size_t length) {
+    if (!buffer) return NULL;
+
+    Makefile* mf = calloc(1, sizeof(Makefile));
+    if (!mf) return NULL;
+    mf->by_name = hashmap_create(256);
+    mf->variables_by_name = hashmap_create(256);
+    if (!mf->by_name || !mf->variables_by_name) {
+        makefile_destroy(mf);
+        return NULL;
+    }
+
+    MakeParseState state;
+    memset(&state, 0, sizeof(state));
+    state.mf = mf;
+
+    int result = DEPTRACK_SUCCESS;
+    const char* p = buffer;
+    const char* end = buffer + length;
+    int line = 1;
+    while (p < end && result == DEPTRACK_SUCCESS) {
+        // Join backslash continuations into one logical line
+        int start_line = line;
+        state.line.length = 0;
+        bool ok = buffer_append(&state.line, "", 0);
+        for (;;) {
+            const char* nl = memchr(p, '\n', (size_t)(end - p));
+            const char* line_end = nl ? nl : end;
+            size_t piece = (size_t)(line_end - p);
+            if (piece > 0 && p[piece - 1] == '\r') piece--;
+            bool continued = piece > 0 && p[piece - 1] == '\\' && !state.define_name;
+            ok = ok && buffer_append(&state.line, p, continued ? piece - 1 : piece);
+            p = nl ? nl + 1 : end;
+            if (!nl) break;
+            line++;
+            if (!continued) break;
+            // Recipes keep the newline semantics of the shell; elsewhere it becomes a space
+            ok = ok && buffer_append(&state.line, " ", 1);
+            while (p < end && (*p == ' ' || *p == '\t')) p++;
+        }
+        if (!ok) {
+            result = DEPTRACK_ERROR_MEMORY;
+            break;
+        }
+        result = handle_line(&state, state.line.data, state.line.length, start_line);
+    }
+
+    if (result == DEPTRACK_SUCCESS) {
+        for (size_t i = 0; i < mf->phony_count; i++) {
+            size_t index;
+            if (hashmap_get(mf->by_name, mf->phony[i], &index) == 0) mf->targets[index].phony = true;
+        }
+        result = analyze_recipes(mf);
+    }
+
+    free(state.line.data);
+    free(state.current);
+    free(state.define_name);
+    free(state.define_body.data);
+    if (result != DEPTRACK_SUCCESS) {
+        makefile_destroy(mf);
+        return NULL;
+    }
+    return mf;
+}
+
+Makefile* makefile_parse_file(const char* filepath) {
+    size_t length;
+    char* buffer = parser_read_file(filepath, &length);
+    if (!buffer) return NULL;
+
+    Makefile* mf = makefile_parse_buffer(buffer, length);
+    free(buffer);
+    return mf;
+}
+
+bool makefile_is_makefile(const char* filepath) {
+    const char* base = strrchr(filepath, '/');
+    base = base ? base + 1 : filepath;
+    return strcmp(base, "Makefile") == 0 || strcmp(base, "makefile") == 0 ||
+           strcmp(base, "GNUmakefile") == 0 || file_has_suffix(base, ".mk");
+}
+
+// ---------------------------------------------------------------------------
+// Target graph
+// ---------------------------------------------------------------------------
+
+// Prerequisite and sub-make edges (prerequisite -> target) between targets of the file
+static size_t makefile_edges(const Makefile* mf, size_t** edge_from, size_t** edge_to) {
+    size_t total = 0;
+    for (size_t i = 0; i < mf->target_count; i++) {
+        total += mf->targets[i].prerequisite_count + mf->targets[i].order_only_count +
+                 mf->targets[i].invocation_count;
+    }
+
+    *edge_from = malloc((total ? total : 1) * sizeof(size_t));
+    *edge_to = malloc((total ? total : 1) * sizeof(size_t));
+    if (!*edge_from || !*edge_to) {
+        free(*edge_from);
+        free(*edge_to);
+        *edge_from = *edge_to = NULL;
+        return SIZE_MAX;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < mf->target_count; i++) {
+        const MakeTarget* target = &mf->targets[i];
+        char** lists[] = { target->prerequisites, target->order_only, target->invocations };
+        size_t counts[] = { target->prerequisite_count, target->order_only_count, target->invocation_count };
+        for (size_t l = 0; l < 3; l++) {
+            for (size_t j = 0; j < counts[l]; j++) {
+                size_t from;
+                if (hashmap_get(mf->by_name, lists[l][j], &from) == 0 && from != i) {
+                    (*edge_from)[count] = from;
+                    (*edge_to)[count] = i;
+                    count++;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+int makefile_schedule(const Makefile* mf, DagSchedule* schedule) {
+    if (!mf || !schedule) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    size_t *edge_from, *edge_to;
+    size_t edge_count = makefile_edges(mf, &edge_from, &edge_to);
+    if (edge_count == SIZE_MAX) {
+        return DEPTRACK_ERROR_MEMORY;
+    }
+
+    // Recipe length stands in for run time on the critical path
+    double* costs = malloc((mf->target_count ? mf->target_count : 1) * sizeof(double));
+    if (!costs) {
+        free(edge_from);
+        free(edge_to);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+    for (size_t i = 0; i < mf->target_count; i++) {
+        costs[i] = mf->targets[i].recipe_count ? (double)mf->targets[i].recipe_count : 1.0;
+    }
+
+    int result = dag_schedule_compute(mf->target_count, edge_from, edge_to, edge_count, costs, schedule);
+    free(costs);
+    free(edge_from);
+    free(edge_to);
+    return result;
+}
+
+size_t makefile_affected_targets(const Makefile* mf, const char* const* changed, size_t changed_count, bool* affected) {
+    if (!mf || !affected) {
+        return 0;
+    }
+    memset(affected, 0, mf->target_count * sizeof(bool));
+
+    size_t *edge_from, *edge_to;
+    size_t edge_count = makefile_edges(mf, &edge_from, &edge_to);
+    if (edge_count == SIZE_MAX) {
+        return 0;
+    }
+
+    size_t* queue = malloc((mf->target_count ? mf->target_count : 1) * sizeof(size_t));
+    if (!queue) {
+        free(edge_from);
+        free(edge_to);
+        return 0;
+    }
+
+    // Seeds: targets named directly, listing the file as a prerequisite, or running it
+    size_t head = 0, tail = 0;
+    for (size_t i = 0; i < mf->target_count; i++) {
+        const MakeTarget* target = &mf->targets[i];
+        bool hit = false;
+        for (size_t c = 0; c < changed_count && !hit; c++) {
+            char path[MAX_PATH_LENGTH];
+            snprintf(path, sizeof(path), "%s", changed[c]);
+            file_normalize_path(path);
+            hit = strcmp(target->name, path) == 0;
+            for (size_t s = 0; s < target->script_count && !hit; s++) {
+                hit = strcmp(target->scripts[s], path) == 0;
+            }
+            for (size_t p = 0; p < target->prerequisite_count && !hit; p++) {
+                hit = strcmp(target->prerequisites[p], path) == 0;
+            }
+        }
+        if (hit) {
+            affected[i] = true;
+            queue[tail++] = i;
+        }
+    }
+
+    // Everything depending on an affected target is affected too
+    while (head < tail) {
+        size_t current = queue[head++];
+        for (size_t e = 0; e < edge_count; e++) {
+            if (edge_from[e] == current && !affected[edge_to[e]]) {
+                affected[edge_to[e]] = true;
+                queue[tail++] = edge_to[e];
+            }
+        }
+    }
+
+    free(queue);
+    free(edge_from);
+    free(edge_to);
+    return tail;
+}
+
+ParsedFile* parse_makefile_buffer(const char* filepath, const char* buffer, size_t length) {
+    Makefile* mf = makefile_parse_buffer(buffer, length);
+    if (!mf) return NULL;
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_MAKE);
+    for (size_t i = 0; parsed && i < mf->target_count; i++) {
+        const MakeTarget* target = &mf->targets[i];
+        for (size_t s = 0; s < target->script_count; s++) {
+            parsed_file_add_dependency(parsed, target->scripts[s], strlen(target->scripts[s]), NULL,
+                                       DEP_BUILD_TOOL, target->line_number);
+        }
+    }
+    for (size_t i = 0; parsed && i < mf->include_count; i++) {
+        parsed_file_add_dependency(parsed, mf->includes[i], strlen(mf->includes[i]), NULL, DEP_CONFIG, 0);
+    }
+
+    makefile_destroy(mf);
+    return parsed;
+}
+
+ParsedFile* parse_makefile(const char* filepath) {
+    return parser_parse_file(filepath, parse_makefile_buffer);
+}
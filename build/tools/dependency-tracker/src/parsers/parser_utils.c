@@ -1 +1,863 @@
-// Stub implementation for parser_utils
+/**
+ * @file parser_utils.c
+ * @brief Shared helpers for the language parsers
+ * @author Unhinged Development Team
+ *
+ * @llm-type util
+ * @llm-legend File loading and ParsedFile bookkeeping shared by every language parser
+ * @llm-key Parsers load a whole file once and scan the buffer in place; dependencies are
+ *          appended to a growable array instead of a fixed MAX_DEPENDENCIES slab
+ * @llm-contract ParsedFile objects returned by any parser are released with parsed_file_destroy
+ * @llm-map KeywordMatcher finds a language's whole keyword set in one pass: an Aho-Corasick DFA over
+ *          byte classes, with a shufti (PSHUFB nibble table) skip to the next possible keyword start
+ * @llm-map LineIndex lists newline offsets, found 64 bytes per compare; it is only built for files
+ *          whose dependencies were recorded by offset, and resolves them all in one pass. TypeScript,
+ *          package.json, Kotlin, proto, Go sources, go.sum and Rust sources record offsets; C includes,
+ *          go.mod, Python requirements and shell references keep the line their own models expose
+ * @llm-map SyntaxMask marks string and comment bytes 64 at a time: blocks with no quote or comment
+ *          opener cost one compare pass, single-kind quote blocks are solved with prefix XOR, and
+ *          only the remaining blocks step through their candidate bytes. TypeScript, proto and Python
+ *          sources use it; the C, Go, Rust and shell readers tokenize comments and strings as they go
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_DEPENDENCY_CAPACITY 16
+
+char* parser_read_file(const char* filepath, size_t* out_length) {
+    if (!filepath) {
+        return NULL;
+    }
+
+    FILE* file = fopen(filepath, "rb");
+    if (!file) {
+        return NULL;
+    }
+
+    if (fseek(file, 0, SEEK_END) != 0) {
+        fclose(file);
+        return NULL;
+    }
+
+    long size = ftell(file);
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        fclose(file);
+        return NULL;
+    }
+
+    // NUL-terminate so scanners may use the C string helpers on the buffer
+    char* buffer = malloc((size_t)size + 1);
+    if (!buffer) {
+        fclose(file);
+        return NULL;
+    }
+
+    size_t read = fread(buffer, 1, (size_t)size, file);
+    fclose(file);
+
+    buffer[read] = '\0';
+    if (out_length) {
+        *out_length = read;
+    }
+    return buffer;
+}
+
+ParsedFile* parser_parse_file(const char* filepath,
+                              ParsedFile* (*parse_buffer)(const char*, const char*, size_t)) {
+    size_t length = 0;
+    char* buffer = parser_read_file(filepath, &length);
+    if (!buffer) {
+        return NULL;
+    }
+
+    ParsedFile* parsed = parse_buffer(filepath, buffer, length);
+    free(buffer);
+    return parsed;
+}
+
+ParsedFile* parsed_file_create(const char* filepath, Language language) {
+    ParsedFile* parsed = calloc(1, sizeof(ParsedFile));
+    if (!parsed) {
+        return NULL;
+    }
+
+    if (filepath) {
+        parsed->filepath = strdup(filepath);
+        if (!parsed->filepath) {
+            free(parsed);
+            return NULL;
+        }
+    }
+
+    parsed->language = language;
+    return parsed;
+}
+
+Dependency* parsed_file_add_dependency_at(ParsedFile* parsed, const char* name, size_t name_length,
+                                          const char* version, DependencyType type, size_t offset) {
+    if (!parsed || !name || name_length == 0) {
+        return NULL;
+    }
+
+    if (parsed->dep_count >= parsed->dep_capacity) {
+        size_t new_capacity = parsed->dep_capacity ? parsed->dep_capacity * 2 : INITIAL_DEPENDENCY_CAPACITY;
+        Dependency* grown = realloc(parsed->dependencies, new_capacity * sizeof(Dependency));
+        if (!grown) {
+            return NULL;
+        }
+        parsed->dependencies = grown;
+        parsed->dep_capacity = new_capacity;
+    }
+
+    Dependency* dep = &parsed->dependencies[parsed->dep_count];
+    memset(dep, 0, sizeof(Dependency));
+
+    dep->name = strndup(name, name_length);
+    dep->version = strdup(version ? version : "unknown");
+    dep->source_file = parsed->filepath ? strdup(parsed->filepath) : NULL;
+    if (!dep->name || !dep->version || (parsed->filepath && !dep->source_file)) {
+        free(dep->name);
+        free(dep->version);
+        free(dep->source_file);
+        return NULL;
+    }
+
+    dep->type = type;
+    dep->offset = offset;
+    dep->status = RESOLVE_SUCCESS;
+
+    parsed->dep_count++;
+    return dep;
+}
+
+Dependency* parsed_file_add_dependency(ParsedFile* parsed, const char* name, size_t name_length,
+                                       const char* version, DependencyType type, int line_number) {
+    Dependency* dep = parsed_file_add_dependency_at(parsed, name, name_length, version, type, DEPTRACK_NO_OFFSET);
+    if (dep) {
+        dep->line_number = line_number;
+    }
+    return dep;
+}
+
+void parsed_file_destroy(ParsedFile* parsed) {
+    if (!parsed) return;
+
+    if (parsed->dependencies) {
+        for (size_t i = 0; i < parsed->dep_count; i++) {
+            free(parsed->dependencies[i].name);
+            free(parsed->dependencies[i].version);
+            free(parsed->dependencies[i].source_file);
+        }
+        free(parsed->dependencies);
+    }
+
+    free(parsed->filepath);
+    free(parsed);
+}
+
+// ---------------------------------------------------------------------------
+// SIMD dispatch
+// ---------------------------------------------------------------------------
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define PARSER_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+SimdIsa simd_detect_isa(void) {
+#ifdef PARSER_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return SIMD_ISA_AVX2;
+    if (__builtin_cpu_supports("sse4.2")) return SIMD_ISA_SSE42;
+#endif
+    return SIMD_ISA_SCALAR;
+}
+
+const char* simd_isa_name(SimdIsa isa) {
+    switch (isa) {
+        case SIMD_ISA_AVX2: return "avx2";
+        case SIMD_ISA_SSE42: return "sse4.2";
+        case SIMD_ISA_SCALAR: return "scalar";
+    }
+    return "scalar";
+}
+
+// ---------------------------------------------------------------------------
+// Multi-keyword matcher
+// ---------------------------------------------------------------------------
+
+struct KeywordMatcher {
+    unsigned flags;
+    SimdIsa isa;
+    uint8_t byte_class[256];   // 0: byte in no keyword
+    size_t class_count;
+    int32_t* delta;            // Aho-Corasick DFA: delta[state * class_count + class]
+    int32_t* output;           // Keyword ending at the state, -1 if none
+    int32_t* dict_link;        // Nearest state on the failure chain with an output, -1 if none
+    size_t state_count;
+    size_t* lengths;
+    size_t keyword_count;
+    bool is_start[256];        // Bytes that leave the root state
+    uint8_t low_nibble[16];    // Shufti tables: a byte may start a keyword when
+    uint8_t high_nibble[16];   // low_nibble[b & 15] & high_nibble[b >> 4] != 0
+};
+
+static int fold_byte(int c, unsigned flags) {
+    return (flags & KEYWORD_MATCH_IGNORE_CASE) ? tolower(c) : c;
+}
+
+KeywordMatcher* keyword_matcher_create(const char* const* keywords, size_t count, unsigned flags) {
+    if (!keywords || count == 0) {
+        return NULL;
+    }
+
+    KeywordMatcher* m = calloc(1, sizeof(KeywordMatcher));
+    if (!m) {
+        return NULL;
+    }
+    m->flags = flags;
+    m->isa = simd_detect_isa();
+    m->keyword_count = count;
+
+    // Bytes outside every keyword share class 0, which keeps the DFA a few columns wide
+    size_t total = 0;
+    m->class_count = 1;
+    for (size_t k = 0; k < count; k++) {
+        for (const unsigned char* c = (const unsigned char*)keywords[k]; *c; c++) {
+            int folded = fold_byte(*c, flags);
+            if (!m->byte_class[folded]) {
+                m->byte_class[folded] = (uint8_t)m->class_count++;
+            }
+            total++;
+        }
+    }
+    if (flags & KEYWORD_MATCH_IGNORE_CASE) {
+        for (int c = 'A'; c <= 'Z'; c++) m->byte_class[c] = m->byte_class[tolower(c)];
+    }
+
+    size_t capacity = total + 1;
+    m->delta = malloc(capacity * m->class_count * sizeof(int32_t));
+    m->output = malloc(capacity * sizeof(int32_t));
+    m->dict_link = malloc(capacity * sizeof(int32_t));
+    m->lengths = malloc(count * sizeof(size_t));
+    int32_t* fail = malloc(capacity * sizeof(int32_t));
+    int32_t* queue = malloc(capacity * sizeof(int32_t));
+    if (!m->delta || !m->output || !m->dict_link || !m->lengths || !fail || !queue) {
+        free(fail);
+        free(queue);
+        keyword_matcher_destroy(m);
+        return NULL;
+    }
+    for (size_t i = 0; i < capacity * m->class_count; i++) m->delta[i] = -1;
+    for (size_t i = 0; i < capacity; i++) m->output[i] = m->dict_link[i] = -1;
+
+    // Trie
+    m->state_count = 1;
+    for (size_t k = 0; k < count; k++) {
+        int32_t state = 0;
+        m->lengths[k] = strlen(keywords[k]);
+        for (const unsigned char* c = (const unsigned char*)keywords[k]; *c; c++) {
+            int32_t* next = &m->delta[(size_t)state * m->class_count + m->byte_class[*c]];
+            if (*next < 0) *next = (int32_t)m->state_count++;
+            state = *next;
+        }
+        if (state > 0 && m->output[state] < 0) m->output[state] = (int32_t)k;
+    }
+
+    // Breadth-first failure links turn the trie into a DFA
+    size_t head = 0, tail = 0;
+    fail[0] = 0;
+    for (size_t c = 0; c < m->class_count; c++) {
+        int32_t* next = &m->delta[c];
+        if (*next < 0) {
+            *next = 0;
+        } else {
+            fail[*next] = 0;
+            queue[tail++] = *next;
+        }
+    }
+    while (head < tail) {
+        int32_t state = queue[head++];
+        int32_t link = fail[state];
+        m->dict_link[state] = m->output[link] >= 0 ? link : m->dict_link[link];
+        for (size_t c = 0; c < m->class_count; c++) {
+            int32_t* next = &m->delta[(size_t)state * m->class_count + c];
+            int32_t via_fail = m->delta[(size_t)link * m->class_count + c];
+            if (*next < 0) {
+                *next = via_fail;
+            } else {
+                fail[*next] = via_fail;
+                queue[tail++] = *next;
+            }
+        }
+    }
+    free(fail);
+    free(queue);
+
+    // Start bytes, bucketed by high nibble so the shufti test is exact for up to 8 nibbles
+    uint8_t bucket_of_high[16];
+    memset(bucket_of_high, 0xff, sizeof(bucket_of_high));
+    size_t bucket_count = 0;
+    for (int b = 0; b < 256; b++) {
+        if (m->delta[m->byte_class[b]] == 0) continue;
+        m->is_start[b] = true;
+        int high = b >> 4;
+        if (bucket_of_high[high] == 0xff) bucket_of_high[high] = (uint8_t)(bucket_count++ % 8);
+        uint8_t bit = (uint8_t)(1u << bucket_of_high[high]);
+        m->high_nibble[high] |= bit;
+        m->low_nibble[b & 15] |= bit;
+    }
+    return m;
+}
+
+void keyword_matcher_destroy(KeywordMatcher* m) {
+    if (!m) return;
+
+    free(m->delta);
+    free(m->output);
+    free(m->dict_link);
+    free(m->lengths);
+    free(m);
+}
+
+SimdIsa keyword_matcher_set_isa(KeywordMatcher* m, SimdIsa isa) {
+    if (!m) return SIMD_ISA_SCALAR;
+    SimdIsa supported = simd_detect_isa();
+    m->isa = isa < supported ? isa : supported;
+    return m->isa;
+}
+
+size_t keyword_matcher_count(const KeywordMatcher* m) {
+    return m ? m->keyword_count : 0;
+}
+
+static size_t next_start_scalar(const KeywordMatcher* m, const unsigned char* p, size_t i, size_t length) {
+    while (i < length && !m->is_start[p[i]]) i++;
+    return i;
+}
+
+#ifdef PARSER_X86_SIMD
+__attribute__((target("sse4.2")))
+static size_t next_start_sse42(const KeywordMatcher* m, const unsigned char* p, size_t i, size_t length) {
+    const __m128i low_table = _mm_loadu_si128((const __m128i*)m->low_nibble);
+    const __m128i high_table = _mm_loadu_si128((const __m128i*)m->high_nibble);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    for (; i + 16 <= length; i += 16) {
+        __m128i bytes = _mm_loadu_si128((const __m128i*)(p + i));
+        __m128i low = _mm_shuffle_epi8(low_table, _mm_and_si128(bytes, nibble));
+        __m128i high = _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+        __m128i hit = _mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128());
+        unsigned mask = ~(unsigned)_mm_movemask_epi8(hit) & 0xffffu;
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+    return next_start_scalar(m, p, i, length);
+}
+
+__attribute__((target("avx2")))
+static size_t next_start_avx2(const KeywordMatcher* m, const unsigned char* p, size_t i, size_t length) {
+    const __m256i low_table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)m->low_nibble));
+    const __m256i high_table = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)m->high_nibble));
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    for (; i + 32 <= length; i += 32) {
+        __m256i bytes = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i low = _mm256_shuffle_epi8(low_table, _mm256_and_si256(bytes, nibble));
+        __m256i high = _mm256_shuffle_epi8(high_table, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+        __m256i hit = _mm256_cmpeq_epi8(_mm256_and_si256(low, high), _mm256_setzero_si256());
+        uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(hit);
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+    return next_start_sse42(m, p, i, length);
+}
+#endif
+
+static size_t next_start(const KeywordMatcher* m, const unsigned char* p, size_t i, size_t length) {
+#ifdef PARSER_X86_SIMD
+    if (m->isa == SIMD_ISA_AVX2) return next_start_avx2(m, p, i, length);
+    if (m->isa == SIMD_ISA_SSE42) return next_start_sse42(m, p, i, length);
+#endif
+    return next_start_scalar(m, p, i, length);
+}
+
+static bool is_word_byte(unsigned char c) {
+    return isalnum(c) || c == '_' || c == '$';
+}
+
+int keyword_matcher_scan(const KeywordMatcher* m, const char* buffer, size_t length,
+                         KeywordVisitFunction visit, void* context) {
+    if (!m || !buffer || !visit) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    const unsigned char* p = (const unsigned char*)buffer;
+    int32_t state = 0;
+    size_t i = 0;
+    while (i < length) {
+        // The root only leaves on a start byte, so everything before the next one is skipped
+        if (state == 0) {
+            i = next_start(m, p, i, length);
+            if (i >= length) break;
+        }
+        state = m->delta[(size_t)state * m->class_count + m->byte_class[p[++i - 1]]];
+
+        for (int32_t s = m->output[state] >= 0 ? state : m->dict_link[state]; s >= 0; s = m->dict_link[s]) {
+            KeywordMatch match;
+            match.keyword = (size_t)m->output[s];
+            match.length = m->lengths[match.keyword];
+            match.offset = i - match.length;
+            if ((m->flags & KEYWORD_MATCH_WHOLE_WORD) &&
+                ((match.offset > 0 && is_word_byte(p[match.offset - 1])) || (i < length && is_word_byte(p[i])))) {
+                continue;
+            }
+            int result = visit(&match, context);
+            if (result != DEPTRACK_SUCCESS) return result;
+        }
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+// ---------------------------------------------------------------------------
+// String and comment masking
+// ---------------------------------------------------------------------------
+
+typedef enum {
+    SYNTAX_STATE_CODE,
+    SYNTAX_STATE_LINE_COMMENT,
+    SYNTAX_STATE_BLOCK_COMMENT,
+    SYNTAX_STATE_STRING,          // ' or " up to the closing quote or end of line
+    SYNTAX_STATE_TEMPLATE,        // ` up to the closing backtick
+    SYNTAX_STATE_TRIPLE           // ''' or """ up to the same triple
+} SyntaxState;
+
+// Character-class bits of one 64-byte block; bit i is byte base + i
+typedef struct {
+    uint64_t single_quote;
+    uint64_t double_quote;
+    uint64_t backtick;
+    uint64_t hash;
+    uint64_t slash;
+    uint64_t star;
+    uint64_t newline;
+    uint64_t backslash;
+} SyntaxBlock;
+
+static const char syntax_block_chars[8] = { '\'', '"', '`', '#', '/', '*', '\n', '\\' };
+
+static void classify_block_scalar(const unsigned char* p, SyntaxBlock* block) {
+    uint64_t* out = (uint64_t*)block;
+    memset(block, 0, sizeof(*block));
+    for (size_t i = 0; i < 64; i++) {
+        for (size_t c = 0; c < 8; c++) {
+            if (p[i] == (unsigned char)syntax_block_chars[c]) out[c] |= 1ULL << i;
+        }
+    }
+}
+
+#ifdef PARSER_X86_SIMD
+__attribute__((target("sse4.2")))
+static void classify_block_sse42(const unsigned char* p, SyntaxBlock* block) {
+    uint64_t* out = (uint64_t*)block;
+    __m128i chunk[4];
+    for (size_t k = 0; k < 4; k++) chunk[k] = _mm_loadu_si128((const __m128i*)(p + 16 * k));
+    for (size_t c = 0; c < 8; c++) {
+        __m128i needle = _mm_set1_epi8(syntax_block_chars[c]);
+        uint64_t bits = 0;
+        for (size_t k = 0; k < 4; k++) {
+            bits |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk[k], needle)) << (16 * k);
+        }
+        out[c] = bits;
+    }
+}
+
+__attribute__((target("avx2")))
+static void classify_block_avx2(const unsigned char* p, SyntaxBlock* block) {
+    uint64_t* out = (uint64_t*)block;
+    __m256i low = _mm256_loadu_si256((const __m256i*)p);
+    __m256i high = _mm256_loadu_si256((const __m256i*)(p + 32));
+    for (size_t c = 0; c < 8; c++) {
+        __m256i needle = _mm256_set1_epi8(syntax_block_chars[c]);
+        uint32_t lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, needle));
+        uint32_t hi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, needle));
+        out[c] = (uint64_t)lo | ((uint64_t)hi << 32);
+    }
+}
+#endif
+
+// Bits preceded by an odd run of backslashes, carried across blocks (the simdjson construction)
+static uint64_t find_escaped(uint64_t backslash, uint64_t* prev_escaped) {
+    const uint64_t even_bits = 0x5555555555555555ULL;
+    backslash &= ~*prev_escaped;
+    uint64_t follows_escape = (backslash << 1) | *prev_escaped;
+    uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+    uint64_t sequences_starting_on_even_bits;
+    *prev_escaped = __builtin_add_overflow(odd_sequence_starts, backslash, &sequences_starting_on_even_bits);
+    uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+    return (even_bits ^ invert_mask) & follows_escape;
+}
+
+// Bit i becomes the XOR of bits 0..i: set from an opening quote up to, not including, its closer
+static uint64_t prefix_xor(uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+static void mask_set_range(uint64_t* bits, size_t from, size_t to) {
+    for (size_t i = from; i < to;) {
+        size_t word = i / 64, bit = i % 64;
+        size_t span = to - i < 64 - bit ? to - i : 64 - bit;
+        uint64_t ones = span == 64 ? ~0ULL : ((1ULL << span) - 1) << bit;
+        bits[word] |= ones;
+        i += span;
+    }
+}
+
+unsigned syntax_rules_for_language(Language language) {
+    const unsigned c_family = SYNTAX_SLASH_COMMENT | SYNTAX_BLOCK_COMMENT | SYNTAX_DOUBLE_QUOTE;
+    switch (language) {
+        case LANG_KOTLIN: return c_family | SYNTAX_SINGLE_QUOTE | SYNTAX_TRIPLE_QUOTE;
+        case LANG_TYPESCRIPT: return c_family | SYNTAX_SINGLE_QUOTE | SYNTAX_TEMPLATE;
+        case LANG_GO: return c_family | SYNTAX_SINGLE_QUOTE | SYNTAX_TEMPLATE;
+        case LANG_RUST: return c_family;   // ' also opens lifetimes
+        case LANG_C:
+        case LANG_PROTO: return c_family | SYNTAX_SINGLE_QUOTE;
+        case LANG_SQL: return SYNTAX_BLOCK_COMMENT | SYNTAX_SINGLE_QUOTE | SYNTAX_DOUBLE_QUOTE;
+        case LANG_PYTHON: return SYNTAX_HASH_COMMENT | SYNTAX_SINGLE_QUOTE | SYNTAX_DOUBLE_QUOTE | SYNTAX_TRIPLE_QUOTE;
+        case LANG_YAML:
+        case LANG_SHELL: return SYNTAX_HASH_COMMENT | SYNTAX_SINGLE_QUOTE | SYNTAX_DOUBLE_QUOTE;
+        case LANG_MAKE: return SYNTAX_HASH_COMMENT;
+        default: return 0;
+    }
+}
+
+typedef struct {
+    const unsigned char* p;
+    size_t length;
+    unsigned rules;
+    uint64_t* bits;
+    SyntaxState state;
+    unsigned char quote;          // Closing character of the open string
+    size_t region_start;          // First byte of the open string or comment
+    size_t resume;                // Bytes before this were consumed by a two- or three-byte token
+} SyntaxMasker;
+
+static unsigned char byte_at(const SyntaxMasker* s, size_t i) {
+    return i < s->length ? s->p[i] : 0;
+}
+
+static void open_region(SyntaxMasker* s, SyntaxState state, size_t at, size_t width) {
+    s->state = state;
+    s->quote = s->p[at];
+    s->region_start = at;
+    s->resume = at + width;
+}
+
+static void close_region(SyntaxMasker* s, size_t end) {
+    mask_set_range(s->bits, s->region_start, end);
+    s->state = SYNTAX_STATE_CODE;
+    s->resume = end;
+}
+
+// Walks the candidate bytes of a block in order; only these can change the state
+static void mask_block_slow(SyntaxMasker* s, size_t base, uint64_t candidates) {
+    const unsigned rules = s->rules;
+    while (candidates) {
+        size_t i = base + (size_t)__builtin_ctzll(candidates);
+        candidates &= candidates - 1;
+        if (i < s->resume || i >= s->length) continue;
+
+        unsigned char c = s->p[i];
+        switch (s->state) {
+            case SYNTAX_STATE_CODE:
+                if (c == '#' && (rules & SYNTAX_HASH_COMMENT)) {
+                    open_region(s, SYNTAX_STATE_LINE_COMMENT, i, 1);
+                } else if (c == '/' && byte_at(s, i + 1) == '/' && (rules & SYNTAX_SLASH_COMMENT)) {
+                    open_region(s, SYNTAX_STATE_LINE_COMMENT, i, 2);
+                } else if (c == '/' && byte_at(s, i + 1) == '*' && (rules & SYNTAX_BLOCK_COMMENT)) {
+                    open_region(s, SYNTAX_STATE_BLOCK_COMMENT, i, 2);
+                } else if (c == '`' && (rules & SYNTAX_TEMPLATE)) {
+                    open_region(s, SYNTAX_STATE_TEMPLATE, i, 1);
+                } else if ((c == '\'' && (rules & SYNTAX_SINGLE_QUOTE)) || (c == '"' && (rules & SYNTAX_DOUBLE_QUOTE))) {
+                    if ((rules & SYNTAX_TRIPLE_QUOTE) && byte_at(s, i + 1) == c && byte_at(s, i + 2) == c) {
+                        open_region(s, SYNTAX_STATE_TRIPLE, i, 3);
+                    } else {
+                        open_region(s, SYNTAX_STATE_STRING, i, 1);
+                    }
+                }
+                break;
+            case SYNTAX_STATE_LINE_COMMENT:
+                if (c == '\n') close_region(s, i);
+                break;
+            case SYNTAX_STATE_BLOCK_COMMENT:
+                if (c == '*' && byte_at(s, i + 1) == '/') close_region(s, i + 2);
+                break;
+            case SYNTAX_STATE_STRING:
+                if (c == s->quote) {
+                    close_region(s, i + 1);
+                } else if (c == '\n') {
+                    close_region(s, i);   // Unterminated: the line ends it
+                }
+                break;
+            case SYNTAX_STATE_TEMPLATE:
+                if (c == '`') close_region(s, i + 1);
+                break;
+            case SYNTAX_STATE_TRIPLE:
+                if (c == s->quote && byte_at(s, i + 1) == c && byte_at(s, i + 2) == c) close_region(s, i + 3);
+                break;
+        }
+    }
+}
+
+int syntax_mask_build(const char* buffer, size_t length, unsigned rules, SimdIsa max_isa, SyntaxMask* mask) {
+    if (!buffer || !mask) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    memset(mask, 0, sizeof(*mask));
+    mask->length = length;
+    mask->block_count = (length + 63) / 64;
+    mask->bits = calloc(mask->block_count ? mask->block_count : 1, sizeof(uint64_t));
+    if (!mask->bits) {
+        return DEPTRACK_ERROR_MEMORY;
+    }
+
+    SimdIsa isa = simd_detect_isa();
+    if (max_isa < isa) isa = max_isa;
+
+    SyntaxMasker s = { (const unsigned char*)buffer, length, rules, mask->bits, SYNTAX_STATE_CODE, 0, 0, 0 };
+    uint64_t prev_escaped = 0;
+    for (size_t block = 0; block < mask->block_count; block++) {
+        size_t base = block * 64;
+        const unsigned char* p = s.p + base;
+        unsigned char tail[64];
+        if (length - base < 64) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, p, length - base);
+            p = tail;
+        }
+
+        SyntaxBlock b;
+#ifdef PARSER_X86_SIMD
+        if (isa == SIMD_ISA_AVX2) {
+            classify_block_avx2(p, &b);
+        } else if (isa == SIMD_ISA_SSE42) {
+            classify_block_sse42(p, &b);
+        } else
+#endif
+        {
+            classify_block_scalar(p, &b);
+        }
+
+        uint64_t escaped = find_escaped(b.backslash, &prev_escaped);
+        uint64_t single = (rules & SYNTAX_SINGLE_QUOTE) ? b.single_quote & ~escaped : 0;
+        uint64_t dbl = (rules & SYNTAX_DOUBLE_QUOTE) ? b.double_quote & ~escaped : 0;
+        uint64_t backtick = (rules & SYNTAX_TEMPLATE) ? b.backtick & ~escaped : 0;
+        uint64_t newline = b.newline & ~escaped;
+        uint64_t openers = ((rules & SYNTAX_HASH_COMMENT) ? b.hash : 0) |
+                           ((rules & (SYNTAX_SLASH_COMMENT | SYNTAX_BLOCK_COMMENT)) ? b.slash : 0);
+        uint64_t quotes = single | dbl | backtick;
+
+        if (s.state == SYNTAX_STATE_CODE && s.resume <= base) {
+            if (!(quotes | openers)) continue;   // Plain code
+
+            // One quote kind, no comments, no triples: prefix XOR gives every string in the block
+            uint64_t kind = single ? single : (dbl ? dbl : backtick);
+            bool adjacent = (rules & SYNTAX_TRIPLE_QUOTE) && (kind & (kind >> 1));
+            if (!openers && quotes == kind && !adjacent) {
+                uint64_t inside = prefix_xor(kind);
+                if (kind == backtick || !(inside & newline)) {
+                    mask->bits[block] = inside | kind;
+                    if (__builtin_popcountll(kind) & 1) {
+                        // Last quote is still open; the slow path picks it up from here
+                        size_t last = base + 63 - (size_t)__builtin_clzll(kind);
+                        mask->bits[block] &= ~(~0ULL << (last - base));
+                        open_region(&s, kind == backtick ? SYNTAX_STATE_TEMPLATE : SYNTAX_STATE_STRING, last, 1);
+                    }
+                    continue;
+                }
+            }
+        }
+
+        // An open region with none of its closers in the block covers all of it
+        uint64_t closers;
+        switch (s.state) {
+            case SYNTAX_STATE_LINE_COMMENT: closers = newline; break;
+            case SYNTAX_STATE_BLOCK_COMMENT: closers = b.star; break;
+            case SYNTAX_STATE_STRING: closers = (s.quote == '"' ? dbl : single) | newline; break;
+            case SYNTAX_STATE_TEMPLATE: closers = backtick; break;
+            case SYNTAX_STATE_TRIPLE: closers = s.quote == '"' ? dbl : single; break;
+            default: closers = ~0ULL; break;
+        }
+        if (!closers) continue;
+
+        // A region may close and another open in the same block, so every class stays a candidate
+        mask_block_slow(&s, base, quotes | openers | newline | b.star);
+    }
+    if (s.state != SYNTAX_STATE_CODE) {
+        mask_set_range(mask->bits, s.region_start, length);
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+void syntax_mask_destroy(SyntaxMask* mask) {
+    if (!mask) return;
+    free(mask->bits);
+    mask->bits = NULL;
+    mask->length = mask->block_count = 0;
+}
+
+bool syntax_mask_test(const SyntaxMask* mask, size_t offset) {
+    return mask && offset < mask->length && (mask->bits[offset / 64] >> (offset % 64)) & 1;
+}
+
+// ---------------------------------------------------------------------------
+// Line index
+// ---------------------------------------------------------------------------
+
+static uint64_t newline_bits_scalar(const unsigned char* p) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < 64; i++) {
+        if (p[i] == '\n') bits |= 1ULL << i;
+    }
+    return bits;
+}
+
+#ifdef PARSER_X86_SIMD
+__attribute__((target("sse4.2")))
+static uint64_t newline_bits_sse42(const unsigned char* p) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    uint64_t bits = 0;
+    for (size_t k = 0; k < 4; k++) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(p + 16 * k));
+        bits |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)) << (16 * k);
+    }
+    return bits;
+}
+
+__attribute__((target("avx2")))
+static uint64_t newline_bits_avx2(const unsigned char* p) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    uint32_t lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)p), newline));
+    uint32_t hi = (uint32_t)_mm256_movemask_epi8(
+        _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)(p + 32)), newline));
+    return (uint64_t)lo | ((uint64_t)hi << 32);
+}
+#endif
+
+int line_index_build(const char* buffer, size_t length, SimdIsa max_isa, LineIndex* index) {
+    if (!buffer || !index) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    memset(index, 0, sizeof(*index));
+    SimdIsa isa = simd_detect_isa();
+    if (max_isa < isa) isa = max_isa;
+
+    size_t capacity = 64;
+    index->newlines = malloc(capacity * sizeof(size_t));
+    if (!index->newlines) {
+        return DEPTRACK_ERROR_MEMORY;
+    }
+
+    const unsigned char* bytes = (const unsigned char*)buffer;
+    for (size_t base = 0; base < length; base += 64) {
+        const unsigned char* p = bytes + base;
+        unsigned char tail[64];
+        if (length - base < 64) {
+            memset(tail, 0, sizeof(tail));
+            memcpy(tail, p, length - base);
+            p = tail;
+        }
+
+        uint64_t bits;
+#ifdef PARSER_X86_SIMD
+        if (isa == SIMD_ISA_AVX2) {
+            bits = newline_bits_avx2(p);
+        } else if (isa == SIMD_ISA_SSE42) {
+            bits = newline_bits_sse42(p);
+        } else
+#endif
+        {
+            bits = newline_bits_scalar(p);
+        }
+        if (!bits) continue;
+
+        size_t needed = index->count + (size_t)__builtin_popcountll(bits);
+        if (needed > capacity) {
+            while (capacity < needed) capacity *= 2;
+            size_t* grown = realloc(index->newlines, capacity * sizeof(size_t));
+            if (!grown) {
+                line_index_destroy(index);
+                return DEPTRACK_ERROR_MEMORY;
+            }
+            index->newlines = grown;
+        }
+        // Set bits flatten to offsets lowest first
+        while (bits) {
+            index->newlines[index->count++] = base + (size_t)__builtin_ctzll(bits);
+            bits &= bits - 1;
+        }
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+void line_index_destroy(LineIndex* index) {
+    if (!index) return;
+    free(index->newlines);
+    index->newlines = NULL;
+    index->count = 0;
+}
+
+int line_index_line(const LineIndex* index, size_t offset) {
+    // One past the number of newlines before offset
+    size_t low = 0, high = index->count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (index->newlines[mid] < offset) low = mid + 1;
+        else high = mid;
+    }
+    return (int)low + 1;
+}
+
+int parsed_file_resolve_lines(ParsedFile* parsed, const char* buffer, size_t length) {
+    if (!parsed || !buffer) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    size_t pending = 0;
+    for (size_t i = 0; i < parsed->dep_count; i++) {
+        if (parsed->dependencies[i].offset != DEPTRACK_NO_OFFSET && parsed->dependencies[i].line_number == 0) pending++;
+    }
+    if (pending == 0) {
+        return DEPTRACK_SUCCESS;
+    }
+
+    LineIndex index;
+    int result = line_index_build(buffer, length, SIMD_ISA_AVX2, &index);
+    if (result != DEPTRACK_SUCCESS) {
+        return result;
+    }
+
+    // Parsers record in source order, so a forward cursor usually replaces the binary search
+    size_t cursor = 0;
+    size_t previous = 0;
+    for (size_t i = 0; i < parsed->dep_count; i++) {
+        Dependency* dep = &parsed->dependencies[i];
+        if (dep->offset == DEPTRACK_NO_OFFSET || dep->line_number != 0) continue;
+        if (dep->offset < previous) {
+            cursor = (size_t)line_index_line(&index, dep->offset) - 1;
+        }
+        while (cursor < index.count && index.newlines[cursor] < dep->offset) cursor++;
+        dep->line_number = (int)cursor + 1;
+        previous = dep->offset;
+    }
+    line_index_destroy(&index);
+    return DEPTRACK_SUCCESS;
+}
@@ -1 +1,837 @@
-// Stub implementation for proto_parser
+/**
+ * @file proto_parser.c
+ * @brief Protocol Buffers parser and import graph
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Lexes .proto files for imports, package, services/rpcs and message type references
+ * @llm-key Tokens are spans into the file buffer; only names that end up in the model are copied.
+ *          A ProtoSet resolves imports across a proto root to give a compile order and the set
+ *          of files (and generated clients) made stale by a change
+ * @llm-key Directory analysis needs only the imports: the registered keyword matcher finds `import`, the
+ *          syntax mask drops those in comments and strings, and lines come from the offsets afterwards
+ * @llm-map Mirrors the proto root used by build/modules/polyglot_proto_engine.py
+ * @llm-contract Import paths are relative to the proto root, exactly as written in `import`
+ */
+
+#include "dependency_tracker.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define PROTO_MAX_NESTING 64
+
+typedef enum {
+    TOK_EOF,
+    TOK_IDENT,
+    TOK_STRING,
+    TOK_SYMBOL
+} ProtoTokenKind;
+
+typedef struct {
+    ProtoTokenKind kind;
+    const char* start;
+    size_t length;
+    int line;
+} ProtoToken;
+
+typedef struct {
+    const char* p;
+    const char* end;
+    int line;
+    ProtoToken peeked;
+    bool has_peeked;
+} ProtoLexer;
+
+typedef enum {
+    BLOCK_MESSAGE,
+    BLOCK_ONEOF,
+    BLOCK_SERVICE,
+    BLOCK_OTHER
+} ProtoBlock;
+
+static const char* scalar_types[] = {
+    "double", "float", "int32", "int64", "uint32", "uint64", "sint32", "sint64",
+    "fixed32", "fixed64", "sfixed32", "sfixed64", "bool", "string", "bytes", NULL
+};
+
+static void lexer_skip_trivia(ProtoLexer* lex) {
+    while (lex->p < lex->end) {
+        char c = *lex->p;
+        if (c == '\n') {
+            lex->line++;
+            lex->p++;
+        } else if (c == ' ' || c == '\t' || c == '\r') {
+            lex->p++;
+        } else if (c == '/' && lex->p + 1 < lex->end && lex->p[1] == '/') {
+            const char* nl = memchr(lex->p, '\n', (size_t)(lex->end - lex->p));
+            lex->p = nl ? nl : lex->end;
+        } else if (c == '/' && lex->p + 1 < lex->end && lex->p[1] == '*') {
+            lex->p += 2;
+            while (lex->p < lex->end && !(lex->p[0] == '*' && lex->p + 1 < lex->end && lex->p[1] == '/')) {
+                if (*lex->p == '\n') lex->line++;
+                lex->p++;
+            }
+            lex->p = lex->p < lex->end ? lex->p + 2 : lex->end;
+        } else {
+            break;
+        }
+    }
+}
+
+static ProtoToken lexer_next(ProtoLexer* lex) {
+    if (lex->has_peeked) {
+        lex->has_peeked = false;
+        return lex->peeked;
+    }
+
+    lexer_skip_trivia(lex);
+
+    ProtoToken tok = { TOK_EOF, lex->p, 0, lex->line };
+    if (lex->p >= lex->end) {
+        return tok;
+    }
+
+    char c = *lex->p;
+    if (isalnum((unsigned char)c) || c == '_' || c == '.') {
+        const char* start = lex->p;
+        while (lex->p < lex->end &&
+               (isalnum((unsigned char)*lex->p) || *lex->p == '_' || *lex->p == '.')) {
+            lex->p++;
+        }
+        tok.kind = TOK_IDENT;
+        tok.start = start;
+        tok.length = (size_t)(lex->p - start);
+    } else if (c == '"' || c == '\'') {
+        const char* start = ++lex->p;
+        while (lex->p < lex->end && *lex->p != c && *lex->p != '\n') {
+            if (*lex->p == '\\' && lex->p + 1 < lex->end) lex->p++;
+            lex->p++;
+        }
+        tok.kind = TOK_STRING;
+        tok.start = start;
+        tok.length = (size_t)(lex->p - start);
+        if (lex->p < lex->end && *lex->p == c) lex->p++;
+    } else {
+        tok.kind = TOK_SYMBOL;
+        tok.start = lex->p++;
+        tok.length = 1;
+    }
+    return tok;
+}
+
+static ProtoToken lexer_peek(ProtoLexer* lex) {
+    if (!lex->has_peeked) {
+        lex->peeked = lexer_next(lex);
+        lex->has_peeked = true;
+    }
+    return lex->peeked;
+}
+
+static bool tok_is(ProtoToken tok, const char* text) {
+    size_t len = strlen(text);
+    return tok.kind != TOK_EOF && tok.length == len && memcmp(tok.start, text, len) == 0;
+}
+
+static bool tok_is_symbol(ProtoToken tok, char symbol) {
+    return tok.kind == TOK_SYMBOL && *tok.start == symbol;
+}
+
+// Skips to the end of the current statement, stepping over bracketed option blocks.
+// A '}' at statement level belongs to the enclosing block and is left for the caller.
+static void skip_statement(ProtoLexer* lex) {
+    int depth = 0;
+    for (;;) {
+        ProtoToken tok = lexer_peek(lex);
+        if (tok.kind == TOK_EOF) return;
+        if (depth == 0 && tok_is_symbol(tok, '}')) return;
+
+        lexer_next(lex);
+        if (tok_is_symbol(tok, '{') || tok_is_symbol(tok, '[') || tok_is_symbol(tok, '(')) {
+            depth++;
+        } else if (tok_is_symbol(tok, '}') || tok_is_symbol(tok, ']') || tok_is_symbol(tok, ')')) {
+            depth--;
+        } else if (depth == 0 && tok_is_symbol(tok, ';')) {
+            return;
+        }
+    }
+}
+
+static bool is_scalar_type(ProtoToken tok) {
+    for (size_t i = 0; scalar_types[i]; i++) {
+        if (tok_is(tok, scalar_types[i])) return true;
+    }
+    return false;
+}
+
+static int name_list_add(char*** list, size_t* count, const char* name, size_t length) {
+    char** grown = realloc(*list, (*count + 1) * sizeof(char*));
+    if (!grown) return -1;
+    *list = grown;
+    grown[*count] = strndup(name, length);
+    if (!grown[*count]) return -1;
+    (*count)++;
+    return 0;
+}
+
+typedef struct {
+    ProtoFile* file;
+    HashMap* seen_refs;
+    char scope[MAX_NAME_LENGTH];   // Dotted name of the enclosing message
+    size_t scope_length;
+    int status;
+} ProtoParseState;
+
+static void add_type_ref(ProtoParseState* state, ProtoToken tok) {
+    if (tok.kind != TOK_IDENT || is_scalar_type(tok)) return;
+
+    size_t ignored;
+    if (hashmap_get_n(state->seen_refs, tok.start, tok.length, &ignored) == 0) return;
+
+    if (hashmap_put_n(state->seen_refs, tok.start, tok.length, state->file->type_ref_count) != 0 ||
+        name_list_add(&state->file->type_refs, &state->file->type_ref_count, tok.start, tok.length) != 0) {
+        state->status = DEPTRACK_ERROR_MEMORY;
+        return;
+    }
+
+    // Parallel array of first-use lines, grown alongside type_refs
+    int* lines = realloc(state->file->type_ref_lines, state->file->type_ref_count * sizeof(int));
+    if (!lines) {
+        state->status = DEPTRACK_ERROR_MEMORY;
+        return;
+    }
+    lines[state->file->type_ref_count - 1] = tok.line;
+    state->file->type_ref_lines = lines;
+}
+
+static void add_definition(ProtoParseState* state, ProtoToken name) {
+    char qualified[MAX_NAME_LENGTH];
+    int written = snprintf(qualified, sizeof(qualified), "%.*s%s%.*s",
+                           (int)state->scope_length, state->scope,
+                           state->scope_length ? "." : "",
+                           (int)name.length, name.start);
+    if (written < 0 || (size_t)written >= sizeof(qualified)) return;
+
+    if (name_list_add(&state->file->messages, &state->file->message_count, qualified, (size_t)written) != 0) {
+        state->status = DEPTRACK_ERROR_MEMORY;
+    }
+}
+
+static void parse_rpc(ProtoLexer* lex, ProtoParseState* state, ProtoService* service) {
+    ProtoToken name = lexer_next(lex);
+    if (name.kind != TOK_IDENT) {
+        skip_statement(lex);
+        return;
+    }
+
+    ProtoRpc rpc;
+    memset(&rpc, 0, sizeof(rpc));
+    rpc.line_number = name.line;
+
+    // ( [stream] Request ) returns ( [stream] Response )
+    for (int part = 0; part < 2; part++) {
+        if (part == 1 && !tok_is(lexer_next(lex), "returns")) break;
+        if (!tok_is_symbol(lexer_next(lex), '(')) break;
+
+        ProtoToken type = lexer_next(lex);
+        bool streaming = false;
+        if (tok_is(type, "stream") && lexer_peek(lex).kind == TOK_IDENT) {
+            streaming = true;
+            type = lexer_next(lex);
+        }
+        if (type.kind == TOK_IDENT) {
+            add_type_ref(state, type);
+            if (part == 0) {
+                rpc.request_type = strndup(type.start, type.length);
+                rpc.client_streaming = streaming;
+            } else {
+                rpc.response_type = strndup(type.start, type.length);
+                rpc.server_streaming = streaming;
+            }
+        }
+        lexer_next(lex); // ')'
+    }
+
+    // Either ';' or an options block
+    ProtoToken tail = lexer_peek(lex);
+    if (tok_is_symbol(tail, '{')) {
+        lexer_next(lex);
+        int depth = 1;
+        while (depth > 0) {
+            ProtoToken tok = lexer_next(lex);
+            if (tok.kind == TOK_EOF) break;
+            if (tok_is_symbol(tok, '{')) depth++;
+            else if (tok_is_symbol(tok, '}')) depth--;
+        }
+    } else if (tok_is_symbol(tail, ';')) {
+        lexer_next(lex);
+    }
+
+    rpc.name = strndup(name.start, name.length);
+    ProtoRpc* grown = realloc(service->rpcs, (service->rpc_count + 1) * sizeof(ProtoRpc));
+    if (!rpc.name || !grown) {
+        free(rpc.name);
+        free(rpc.request_type);
+        free(rpc.response_type);
+        if (grown) service->rpcs = grown;
+        state->status = DEPTRACK_ERROR_MEMORY;
+        return;
+    }
+    service->rpcs = grown;
+    service->rpcs[service->rpc_count++] = rpc;
+}
+
+// Field: [repeated|optional|required] Type name = N [options];  or  map<K, V> name = N;
+static void parse_field(ProtoLexer* lex, ProtoParseState* state, ProtoToken first) {
+    ProtoToken type = first;
+    if (tok_is(type, "repeated") || tok_is(type, "optional") || tok_is(type, "required")) {
+        type = lexer_next(lex);
+    }
+
+    if (tok_is(type, "map") && tok_is_symbol(lexer_peek(lex), '<')) {
+        lexer_next(lex);                        // <
+        lexer_next(lex);                        // key type, always scalar
+        lexer_next(lex);                        // ,
+        add_type_ref(state, lexer_next(lex));   // value type
+    } else if (type.kind == TOK_IDENT) {
+        add_type_ref(state, type);
+    }
+
+    skip_statement(lex);
+}
+
+ProtoFile* proto_parse_buffer(const char* filepath, const char* buffer, size_t length) {
+    if (!buffer) {
+        return NULL;
+    }
+
+    ProtoFile* file = calloc(1, sizeof(ProtoFile));
+    if (!file) {
+        return NULL;
+    }
+    if (filepath && !(file->filepath = strdup(filepath))) {
+        free(file);
+        return NULL;
+    }
+
+    ProtoParseState state;
+    memset(&state, 0, sizeof(state));
+    state.file = file;
+    state.seen_refs = hashmap_create(64);
+    if (!state.seen_refs) {
+        proto_file_destroy(file);
+        return NULL;
+    }
+
+    ProtoLexer lex = { buffer, buffer + length, 1, { TOK_EOF, NULL, 0, 0 }, false };
+    ProtoBlock blocks[PROTO_MAX_NESTING];
+    size_t scope_marks[PROTO_MAX_NESTING];
+    size_t depth = 0;
+
+    while (state.status == DEPTRACK_SUCCESS) {
+        ProtoToken tok = lexer_next(&lex);
+        if (tok.kind == TOK_EOF) break;
+
+        ProtoBlock block = depth ? blocks[depth - 1] : BLOCK_OTHER;
+
+        if (tok_is_symbol(tok, '}')) {
+            if (depth > 0) {
+                depth--;
+                state.scope_length = scope_marks[depth];
+            }
+            continue;
+        }
+        if (tok_is_symbol(tok, ';')) {
+            continue;
+        }
+
+        if (depth == 0 && tok_is(tok, "package")) {
+            ProtoToken name = lexer_next(&lex);
+            if (name.kind == TOK_IDENT) {
+                free(file->package);
+                file->package = strndup(name.start, name.length);
+            }
+            skip_statement(&lex);
+        } else if (depth == 0 && tok_is(tok, "import")) {
+            ProtoToken path = lexer_next(&lex);
+            if (tok_is(path, "public") || tok_is(path, "weak")) {
+                path = lexer_next(&lex);
+            }
+            if (path.kind == TOK_STRING && path.length > 0) {
+                if (name_list_add(&file->imports, &file->import_count, path.start, path.length) != 0) {
+                    state.status = DEPTRACK_ERROR_MEMORY;
+                    break;
+                }
+                int* lines = realloc(file->import_lines, file->import_count * sizeof(int));
+                if (!lines) {
+                    state.status = DEPTRACK_ERROR_MEMORY;
+                    break;
+                }
+                lines[file->import_count - 1] = path.line;
+                file->import_lines = lines;
+            }
+            skip_statement(&lex);
+        } else if (tok_is(tok, "message") || tok_is(tok, "enum") ||
+                   tok_is(tok, "service") || tok_is(tok, "oneof") || tok_is(tok, "extend")) {
+            ProtoToken name = lexer_next(&lex);
+            if (!tok_is_symbol(lexer_next(&lex), '{') || depth >= PROTO_MAX_NESTING) {
+                skip_statement(&lex);
+                continue;
+            }
+
+            scope_marks[depth] = state.scope_length;
+            if (tok_is(tok, "message")) {
+                add_definition(&state, name);
+                // Nested messages are referenced as Outer.Inner
+                if (state.scope_length + name.length + 1 < sizeof(state.scope)) {
+                    if (state.scope_length) state.scope[state.scope_length++] = '.';
+                    memcpy(state.scope + state.scope_length, name.start, name.length);
+                    state.scope_length += name.length;
+                }
+                blocks[depth++] = BLOCK_MESSAGE;
+            } else if (tok_is(tok, "enum")) {
+                add_definition(&state, name);
+                blocks[depth++] = BLOCK_OTHER;
+            } else if (tok_is(tok, "service")) {
+                ProtoService* grown = realloc(file->services, (file->service_count + 1) * sizeof(ProtoService));
+                if (!grown) {
+                    state.status = DEPTRACK_ERROR_MEMORY;
+                    break;
+                }
+                file->services = grown;
+                ProtoService* service = &file->services[file->service_count++];
+                memset(service, 0, sizeof(ProtoService));
+                service->name = strndup(name.start, name.length);
+                service->line_number = name.line;
+                blocks[depth++] = BLOCK_SERVICE;
+            } else if (tok_is(tok, "extend")) {
+                add_type_ref(&state, name);
+                blocks[depth++] = BLOCK_MESSAGE;
+            } else {
+                blocks[depth++] = BLOCK_ONEOF;
+            }
+        } else if (block == BLOCK_SERVICE && tok_is(tok, "rpc")) {
+            parse_rpc(&lex, &state, &file->services[file->service_count - 1]);
+        } else if ((block == BLOCK_MESSAGE || block == BLOCK_ONEOF) && tok.kind == TOK_IDENT &&
+                   !tok_is(tok, "option") && !tok_is(tok, "reserved") && !tok_is(tok, "extensions")) {
+            parse_field(&lex, &state, tok);
+        } else {
+            skip_statement(&lex);
+        }
+    }
+
+    hashmap_destroy(state.seen_refs);
+
+    if (state.status != DEPTRACK_SUCCESS) {
+        proto_file_destroy(file);
+        return NULL;
+    }
+    return file;
+}
+
+ProtoFile* proto_parse_file(const char* filepath) {
+    size_t length = 0;
+    char* buffer = parser_read_file(filepath, &length);
+    if (!buffer) {
+        return NULL;
+    }
+
+    ProtoFile* file = proto_parse_buffer(filepath, buffer, length);
+    free(buffer);
+    return file;
+}
+
+void proto_file_destroy(ProtoFile* file) {
+    if (!file) return;
+
+    for (size_t i = 0; i < file->import_count; i++) free(file->imports[i]);
+    for (size_t i = 0; i < file->message_count; i++) free(file->messages[i]);
+    for (size_t i = 0; i < file->type_ref_count; i++) free(file->type_refs[i]);
+    for (size_t i = 0; i < file->service_count; i++) {
+        ProtoService* service = &file->services[i];
+        for (size_t j = 0; j < service->rpc_count; j++) {
+            free(service->rpcs[j].name);
+            free(service->rpcs[j].request_type);
+            free(service->rpcs[j].response_type);
+        }
+        free(service->rpcs);
+        free(service->name);
+    }
+
+    free(file->imports);
+    free(file->import_lines);
+    free(file->messages);
+    free(file->type_refs);
+    free(file->type_ref_lines);
+    free(file->services);
+    free(file->package);
+    free(file->filepath);
+    free(file);
+}
+
+// ---------------------------------------------------------------------------
+// Import scan: the ParsedFile view used by directory analysis
+// ---------------------------------------------------------------------------
+
+static const char* const proto_keywords[] = { "import" };
+static char* proto_extensions[] = { "proto" };
+
+typedef struct {
+    const char* buffer;
+    size_t length;
+    ParsedFile* parsed;
+    SyntaxMask mask;           // Strings and comments; an import inside them is not a statement
+    bool failed;
+} ProtoImportScan;
+
+// Whitespace and comments; the opening quote of a string is where they stop
+static size_t skip_trivia(const ProtoImportScan* scan, size_t i) {
+    while (i < scan->length) {
+        char c = scan->buffer[i];
+        if (syntax_mask_test(&scan->mask, i)) {
+            bool opens = i == 0 || !syntax_mask_test(&scan->mask, i - 1);
+            if (opens && (c == '"' || c == '\'')) break;
+        } else if (!isspace((unsigned char)c)) {
+            break;
+        }
+        i++;
+    }
+    return i;
+}
+
+// Statements start the file or follow ';' or '}'; anything else makes `import` part of another one
+static bool starts_statement(const ProtoImportScan* scan, size_t i) {
+    while (i > 0 && (syntax_mask_test(&scan->mask, i - 1) || isspace((unsigned char)scan->buffer[i - 1]))) i--;
+    return i == 0 || scan->buffer[i - 1] == ';' || scan->buffer[i - 1] == '}';
+}
+
+static bool word_at(const ProtoImportScan* scan, size_t i, const char* word) {
+    size_t length = strlen(word);
+    return i + length < scan->length && memcmp(scan->buffer + i, word, length) == 0 &&
+           !(isalnum((unsigned char)scan->buffer[i + length]) || scan->buffer[i + length] == '_');
+}
+
+static int visit_import(const KeywordMatch* match, void* context) {
+    ProtoImportScan* scan = context;
+    if (syntax_mask_test(&scan->mask, match->offset) || !starts_statement(scan, match->offset)) {
+        return DEPTRACK_SUCCESS;
+    }
+
+    size_t i = skip_trivia(scan, match->offset + match->length);
+    if (word_at(scan, i, "public")) i = skip_trivia(scan, i + 6);
+    else if (word_at(scan, i, "weak")) i = skip_trivia(scan, i + 4);
+    if (i >= scan->length || (scan->buffer[i] != '"' && scan->buffer[i] != '\'')) return DEPTRACK_SUCCESS;
+
+    // As the lexer reads it: up to the closing quote or the end of the line
+    char quote = scan->buffer[i];
+    size_t start = ++i;
+    while (i < scan->length && scan->buffer[i] != quote && scan->buffer[i] != '\n') {
+        if (scan->buffer[i] == '\\' && i + 1 < scan->length) i++;
+        i++;
+    }
+    if (i == start) return DEPTRACK_SUCCESS;
+
+    const char* import = scan->buffer + start;
+    DependencyType type = i - start >= 7 && memcmp(import, "google/", 7) == 0 ? DEP_EXTERNAL : DEP_INTERNAL;
+    if (!parsed_file_add_dependency_at(scan->parsed, import, i - start, NULL, type, start)) {
+        scan->failed = true;
+        return DEPTRACK_ERROR_MEMORY;
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+static KeywordMatcher* proto_matcher_create(void) {
+    return keyword_matcher_create(proto_keywords, sizeof(proto_keywords) / sizeof(proto_keywords[0]),
+                                  KEYWORD_MATCH_WHOLE_WORD);
+}
+
+ParsedFile* proto_scan_imports(const char* filepath, const char* buffer, size_t length,
+                               const KeywordMatcher* matcher) {
+    if (!filepath || !buffer) {
+        return NULL;
+    }
+
+    KeywordMatcher* owned = NULL;
+    if (!matcher) {
+        matcher = owned = proto_matcher_create();
+        if (!owned) return NULL;
+    }
+
+    ProtoImportScan scan = { buffer, length, parsed_file_create(filepath, LANG_PROTO), { NULL, 0, 0 }, false };
+    int result = syntax_mask_build(buffer, length, syntax_rules_for_language(LANG_PROTO), SIMD_ISA_AVX2,
+                                   &scan.mask);
+    if (result == DEPTRACK_SUCCESS && scan.parsed) {
+        result = keyword_matcher_scan(matcher, buffer, length, visit_import, &scan);
+    }
+    if (result == DEPTRACK_SUCCESS && scan.parsed) {
+        result = parsed_file_resolve_lines(scan.parsed, buffer, length);
+    }
+    if (result != DEPTRACK_SUCCESS) {
+        parsed_file_destroy(scan.parsed);
+        scan.parsed = NULL;
+    }
+    syntax_mask_destroy(&scan.mask);
+    keyword_matcher_destroy(owned);
+    return scan.parsed;
+}
+
+ParsedFile* parse_proto_buffer(const char* filepath, const char* buffer, size_t length) {
+    return proto_scan_imports(filepath, buffer, length, NULL);
+}
+
+ParsedFile* parse_proto_file(const char* filepath) {
+    return parser_parse_file(filepath, parse_proto_buffer);
+}
+
+LanguageParser* proto_parser_create(void) {
+    LanguageParser* parser = calloc(1, sizeof(LanguageParser));
+    if (!parser) {
+        return NULL;
+    }
+
+    parser->language = LANG_PROTO;
+    parser->name = "Protocol Buffers";
+    parser->file_extensions = proto_extensions;
+    parser->extension_count = sizeof(proto_extensions) / sizeof(proto_extensions[0]);
+    parser->parse_file = parse_proto_file;
+    parser->keywords = proto_keywords;
+    parser->keyword_count = sizeof(proto_keywords) / sizeof(proto_keywords[0]);
+    return parser;
+}
+
+// ---------------------------------------------------------------------------
+// ProtoSet: every .proto under a root, linked by import
+// ---------------------------------------------------------------------------
+
+static int proto_set_append(ProtoSet* set, ProtoFile* file, const char* import_path) {
+    if (set->file_count >= set->file_capacity) {
+        size_t new_capacity = set->file_capacity ? set->file_capacity * 2 : 16;
+        ProtoFile** grown = realloc(set->files, new_capacity * sizeof(ProtoFile*));
+        if (!grown) return DEPTRACK_ERROR_MEMORY;
+        set->files = grown;
+        char** grown_paths = realloc(set->import_paths, new_capacity * sizeof(char*));
+        if (!grown_paths) return DEPTRACK_ERROR_MEMORY;
+        set->import_paths = grown_paths;
+        set->file_capacity = new_capacity;
+    }
+
+    char* path_copy = strdup(import_path);
+    if (!path_copy || hashmap_put(set->by_import_path, import_path, set->file_count) != 0) {
+        free(path_copy);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+    set->import_paths[set->file_count] = path_copy;
+    set->files[set->file_count++] = file;
+    return DEPTRACK_SUCCESS;
+}
+
+ProtoSet* proto_set_create(const char* root) {
+    ProtoSet* set = calloc(1, sizeof(ProtoSet));
+    if (!set) return NULL;
+
+    set->root = strdup(root ? root : ".");
+    set->by_import_path = hashmap_create(128);
+    if (!set->root || !set->by_import_path) {
+        proto_set_destroy(set);
+        return NULL;
+    }
+    return set;
+}
+
+int proto_set_add_buffer(ProtoSet* set, const char* import_path, const char* buffer, size_t length) {
+    if (!set || !import_path || !buffer) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    ProtoFile* file = proto_parse_buffer(import_path, buffer, length);
+    if (!file) {
+        return DEPTRACK_ERROR_PARSE_FAILED;
+    }
+
+    int result = proto_set_append(set, file, import_path);
+    if (result != DEPTRACK_SUCCESS) {
+        proto_file_destroy(file);
+    }
+    return result;
+}
+
+static int proto_set_visit(const char* path, void* context) {
+    ProtoSet* set = context;
+    if (!file_has_suffix(path, ".proto")) {
+        return DEPTRACK_SUCCESS;
+    }
+
+    ProtoFile* file = proto_parse_file(path);
+    if (!file) {
+        return DEPTRACK_SUCCESS; // Unreadable files simply drop out of the set
+    }
+
+    // Import path is the location relative to the proto root
+    const char* import_path = path + strlen(set->root);
+    while (*import_path == '/') import_path++;
+
+    int result = proto_set_append(set, file, import_path);
+    if (result != DEPTRACK_SUCCESS) {
+        proto_file_destroy(file);
+    }
+    return result;
+}
+
+ProtoSet* proto_set_load(const char* root) {
+    ProtoSet* set = proto_set_create(root);
+    if (!set) return NULL;
+
+    // Strip trailing slashes so relative import paths line up with file_walk's output
+    size_t length = strlen(set->root);
+    while (length > 1 && set->root[length - 1] == '/') {
+        set->root[--length] = '\0';
+    }
+
+    if (file_walk(set->root, proto_set_visit, set) != DEPTRACK_SUCCESS) {
+        proto_set_destroy(set);
+        return NULL;
+    }
+    return set;
+}
+
+void proto_set_destroy(ProtoSet* set) {
+    if (!set) return;
+
+    for (size_t i = 0; i < set->file_count; i++) {
+        proto_file_destroy(set->files[i]);
+        free(set->import_paths[i]);
+    }
+    free(set->files);
+    free(set->import_paths);
+    hashmap_destroy(set->by_import_path);
+    free(set->root);
+    free(set);
+}
+
+// Import edges (imported -> importer) between files of the set; external imports are dropped
+static size_t proto_set_edges(const ProtoSet* set, size_t** edge_from, size_t** edge_to) {
+    size_t total = 0;
+    for (size_t i = 0; i < set->file_count; i++) {
+        total += set->files[i]->import_count;
+    }
+
+    *edge_from = malloc((total ? total : 1) * sizeof(size_t));
+    *edge_to = malloc((total ? total : 1) * sizeof(size_t));
+    if (!*edge_from || !*edge_to) {
+        free(*edge_from);
+        free(*edge_to);
+        *edge_from = *edge_to = NULL;
+        return SIZE_MAX;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < set->file_count; i++) {
+        const ProtoFile* file = set->files[i];
+        for (size_t j = 0; j < file->import_count; j++) {
+            size_t target;
+            if (hashmap_get(set->by_import_path, file->imports[j], &target) == 0) {
+                (*edge_from)[count] = target;
+                (*edge_to)[count] = i;
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+int proto_set_compile_order(const ProtoSet* set, DagSchedule* schedule) {
+    if (!set || !schedule) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    size_t *edge_from, *edge_to;
+    size_t edge_count = proto_set_edges(set, &edge_from, &edge_to);
+    if (edge_count == SIZE_MAX) {
+        return DEPTRACK_ERROR_MEMORY;
+    }
+
+    int result = dag_schedule_compute(set->file_count, edge_from, edge_to, edge_count, NULL, schedule);
+    free(edge_from);
+    free(edge_to);
+    return result;
+}
+
+// Matches "proto/chat.proto", "./proto/chat.proto" or "chat.proto" against import path "chat.proto"
+static bool changed_path_matches(const char* changed, const char* import_path) {
+    size_t changed_length = strlen(changed);
+    size_t import_length = strlen(import_path);
+    if (changed_length < import_length) return false;
+    if (memcmp(changed + changed_length - import_length, import_path, import_length) != 0) return false;
+    return changed_length == import_length || changed[changed_length - import_length - 1] == '/';
+}
+
+size_t proto_set_stale(const ProtoSet* set, const char* const* changed, size_t changed_count, bool* stale) {
+    if (!set || !stale) {
+        return 0;
+    }
+    memset(stale, 0, set->file_count * sizeof(bool));
+
+    size_t *edge_from, *edge_to;
+    size_t edge_count = proto_set_edges(set, &edge_from, &edge_to);
+    if (edge_count == SIZE_MAX) {
+        return 0;
+    }
+
+    // Importers of each file in CSR form
+    size_t* offsets = calloc(set->file_count + 1, sizeof(size_t));
+    size_t* importers = malloc((edge_count ? edge_count : 1) * sizeof(size_t));
+    size_t* queue = malloc((set->file_count ? set->file_count : 1) * sizeof(size_t));
+    if (!offsets || !importers || !queue) {
+        free(offsets);
+        free(importers);
+        free(queue);
+        free(edge_from);
+        free(edge_to);
+        return 0;
+    }
+
+    for (size_t e = 0; e < edge_count; e++) {
+        offsets[edge_from[e] + 1]++;
+    }
+    for (size_t i = 0; i < set->file_count; i++) {
+        offsets[i + 1] += offsets[i];
+    }
+    for (size_t e = 0; e < edge_count; e++) {
+        importers[offsets[edge_from[e]]++] = edge_to[e];
+    }
+    // The fill pass advanced each offset to the next row's start; shift back
+    for (size_t i = set->file_count; i > 0; i--) {
+        offsets[i] = offsets[i - 1];
+    }
+    offsets[0] = 0;
+
+    size_t head = 0, tail = 0;
+    for (size_t i = 0; i < set->file_count; i++) {
+        for (size_t c = 0; c < changed_count; c++) {
+            if (changed[c] && changed_path_matches(changed[c], set->import_paths[i])) {
+                stale[i] = true;
+                queue[tail++] = i;
+                break;
+            }
+        }
+    }
+
+    // Everything that imports a stale file, transitively, must be regenerated too
+    while (head < tail) {
+        size_t node = queue[head++];
+        for (size_t e = offsets[node]; e < offsets[node + 1]; e++) {
+            if (!stale[importers[e]]) {
+                stale[importers[e]] = true;
+                queue[tail++] = importers[e];
+            }
+        }
+    }
+
+    free(offsets);
+    free(importers);
+    free(queue);
+    free(edge_from);
+    free(edge_to);
+    return tail;
+}
@@ -0,0 +1,663 @@
+/**
+ * @file rust_parser.c
+ * @brief Rust manifest, lockfile and `use` parser
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Reads Cargo.toml dependency tables and Cargo.lock packages through the shared TOML
+ *             reader, and scans .rs sources for `use` trees and `extern crate`
+ * @llm-key Sources are lexed once over the whole buffer (nested comments, raw strings and
+ *          lifetimes handled); external crates are reported once per file, internal paths as written.
+ *          Tokens carry no line; dependencies record offsets and lines are resolved at the end
+ * @llm-contract Manifest versions are replaced by the locked version when Cargo.lock names a
+ *               single package of that crate
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <string.h>
+
+#define RUST_MAX_USE_DEPTH 16
+#define RUST_PATH_BUFFER 512
+
+static const char* cargo_sections[] = {
+    [CARGO_NORMAL] = "dependencies",
+    [CARGO_DEV] = "dev-dependencies",
+    [CARGO_BUILD] = "build-dependencies"
+};
+
+// ---------------------------------------------------------------------------
+// Cargo.toml
+// ---------------------------------------------------------------------------
+
+void cargo_manifest_destroy(CargoManifest* manifest) {
+    if (!manifest) return;
+
+    free(manifest->package_name);
+    free(manifest->package_version);
+    for (size_t i = 0; i < manifest->dependency_count; i++) {
+        CargoDependency* dep = &manifest->dependencies[i];
+        free(dep->name);
+        free(dep->package);
+        free(dep->version);
+        free(dep->path);
+        free(dep->git);
+        free(dep->target);
+    }
+    free(manifest->dependencies);
+    for (size_t i = 0; i < manifest->member_count; i++) {
+        free(manifest->workspace_members[i]);
+    }
+    free(manifest->workspace_members);
+    hashmap_destroy(manifest->by_key);
+    free(manifest);
+}
+
+static bool section_kind(const TomlValue* value, size_t index, CargoDependencyKind* kind) {
+    if (toml_key_is(value, index, "dependencies")) *kind = CARGO_NORMAL;
+    else if (toml_key_is(value, index, "dev-dependencies") || toml_key_is(value, index, "dev_dependencies")) *kind = CARGO_DEV;
+    else if (toml_key_is(value, index, "build-dependencies") || toml_key_is(value, index, "build_dependencies")) *kind = CARGO_BUILD;
+    else return false;
+    return true;
+}
+
+static CargoDependency* get_cargo_dependency(CargoManifest* manifest, CargoDependencyKind kind,
+                                             const char* target, size_t target_length,
+                                             const char* name, size_t name_length, int line) {
+    char key[MAX_PATH_LENGTH];
+    int written = snprintf(key, sizeof(key), "%d|%.*s|%.*s", (int)kind, (int)target_length,
+                           target ? target : "", (int)name_length, name);
+    if (written <= 0 || (size_t)written >= sizeof(key)) return NULL;
+
+    size_t index;
+    if (hashmap_get_n(manifest->by_key, key, (size_t)written, &index) == 0) {
+        return &manifest->dependencies[index];
+    }
+
+    if (manifest->dependency_count >= manifest->dependency_capacity) {
+        size_t capacity = manifest->dependency_capacity ? manifest->dependency_capacity * 2 : 16;
+        CargoDependency* grown = realloc(manifest->dependencies, capacity * sizeof(CargoDependency));
+        if (!grown) return NULL;
+        manifest->dependencies = grown;
+        manifest->dependency_capacity = capacity;
+    }
+
+    CargoDependency* dep = &manifest->dependencies[manifest->dependency_count];
+    memset(dep, 0, sizeof(CargoDependency));
+    dep->kind = kind;
+    dep->line_number = line;
+    dep->name = strndup(name, name_length);
+    dep->target = target ? strndup(target, target_length) : NULL;
+    if (!dep->name || (target && !dep->target) ||
+        hashmap_put_n(manifest->by_key, key, (size_t)written, manifest->dependency_count) != 0) {
+        free(dep->name);
+        free(dep->target);
+        return NULL;
+    }
+    manifest->dependency_count++;
+    return dep;
+}
+
+static bool set_field(char** field, const TomlValue* value) {
+    char* copy = strndup(value->value, value->value_length);
+    if (!copy) return false;
+    free(*field);
+    *field = copy;
+    return true;
+}
+
+static int visit_manifest_value(const TomlValue* value, void* context) {
+    CargoManifest* manifest = context;
+
+    if (value->depth == 2 && toml_key_is(value, 0, "package") && value->type == TOML_STRING) {
+        if (toml_key_is(value, 1, "name")) return set_field(&manifest->package_name, value) ? DEPTRACK_SUCCESS : DEPTRACK_ERROR_MEMORY;
+        if (toml_key_is(value, 1, "version")) return set_field(&manifest->package_version, value) ? DEPTRACK_SUCCESS : DEPTRACK_ERROR_MEMORY;
+        return DEPTRACK_SUCCESS;
+    }
+
+    if (value->depth == 2 && toml_key_is(value, 0, "workspace") && toml_key_is(value, 1, "members") &&
+        value->type == TOML_STRING) {
+        char** grown = realloc(manifest->workspace_members, (manifest->member_count + 1) * sizeof(char*));
+        if (!grown) return DEPTRACK_ERROR_MEMORY;
+        manifest->workspace_members = grown;
+        manifest->workspace_members[manifest->member_count] = strndup(value->value, value->value_length);
+        if (!manifest->workspace_members[manifest->member_count]) return DEPTRACK_ERROR_MEMORY;
+        manifest->member_count++;
+        return DEPTRACK_SUCCESS;
+    }
+
+    // [dependencies], [workspace.dependencies] and [target.'cfg(..)'.dependencies]
+    CargoDependencyKind kind;
+    size_t base;
+    const char* target = NULL;
+    size_t target_length = 0;
+    if (value->depth >= 2 && section_kind(value, 0, &kind)) {
+        base = 1;
+    } else if (value->depth >= 3 && toml_key_is(value, 0, "workspace") && section_kind(value, 1, &kind)) {
+        base = 2;
+    } else if (value->depth >= 4 && toml_key_is(value, 0, "target") && section_kind(value, 2, &kind)) {
+        base = 3;
+        target = value->path[1];
+        target_length = value->path_lengths[1];
+    } else {
+        return DEPTRACK_SUCCESS;
+    }
+
+    CargoDependency* dep = get_cargo_dependency(manifest, kind, target, target_length, value->path[base],
+                                                value->path_lengths[base], value->line_number);
+    if (!dep) return DEPTRACK_ERROR_MEMORY;
+
+    bool ok = true;
+    size_t field = base + 1;
+    if (value->depth == base + 1 && value->type == TOML_STRING) {
+        ok = set_field(&dep->version, value); // serde = "1.0"
+    } else if (value->depth == field + 1 && value->array_index == SIZE_MAX) {
+        if (toml_key_is(value, field, "version")) ok = set_field(&dep->version, value);
+        else if (toml_key_is(value, field, "path")) ok = set_field(&dep->path, value);
+        else if (toml_key_is(value, field, "git")) ok = set_field(&dep->git, value);
+        else if (toml_key_is(value, field, "package")) ok = set_field(&dep->package, value);
+        else if (toml_key_is(value, field, "optional")) dep->optional = value->value_length == 4;
+        else if (toml_key_is(value, field, "workspace")) dep->workspace = value->value_length == 4;
+    }
+    return ok ? DEPTRACK_SUCCESS : DEPTRACK_ERROR_MEMORY;
+}
+
+CargoManifest* cargo_manifest_parse_buffer(const char* buffer, size_t length) {
+    if (!buffer) return NULL;
+
+    CargoManifest* manifest = calloc(1, sizeof(CargoManifest));
+    if (!manifest) return NULL;
+    manifest->by_key = hashmap_create(64);
+    if (!manifest->by_key ||
+        toml_parse_buffer(buffer, length, visit_manifest_value, manifest) != DEPTRACK_SUCCESS) {
+        cargo_manifest_destroy(manifest);
+        return NULL;
+    }
+    return manifest;
+}
+
+// ---------------------------------------------------------------------------
+// Cargo.lock
+// ---------------------------------------------------------------------------
+
+void cargo_lock_destroy(CargoLock* lock) {
+    if (!lock) return;
+
+    for (size_t i = 0; i < lock->package_count; i++) {
+        CargoLockPackage* pkg = &lock->packages[i];
+        free(pkg->name);
+        free(pkg->version);
+        free(pkg->source);
+        for (size_t d = 0; d < pkg->dependency_count; d++) {
+            free(pkg->dependencies[d]);
+        }
+        free(pkg->dependencies);
+    }
+    free(lock->packages);
+    hashmap_destroy(lock->by_name);
+    free(lock);
+}
+
+typedef struct {
+    CargoLock* lock;
+    size_t table_index;        // TOML table of the package being filled
+    bool open;
+} CargoLockLoad;
+
+static int visit_lock_value(const TomlValue* value, void* context) {
+    CargoLockLoad* load = context;
+    CargoLock* lock = load->lock;
+    if (value->depth != 2 || !toml_key_is(value, 0, "package") || value->type != TOML_STRING) {
+        return DEPTRACK_SUCCESS;
+    }
+
+    // Each [[package]] header starts a new table
+    if (!load->open || load->table_index != value->table_index) {
+        if (lock->package_count >= lock->package_capacity) {
+            size_t capacity = lock->package_capacity ? lock->package_capacity * 2 : 64;
+            CargoLockPackage* grown = realloc(lock->packages, capacity * sizeof(CargoLockPackage));
+            if (!grown) return DEPTRACK_ERROR_MEMORY;
+            lock->packages = grown;
+            lock->package_capacity = capacity;
+        }
+        memset(&lock->packages[lock->package_count++], 0, sizeof(CargoLockPackage));
+        load->table_index = value->table_index;
+        load->open = true;
+    }
+
+    CargoLockPackage* pkg = &lock->packages[lock->package_count - 1];
+    if (toml_key_is(value, 1, "name")) {
+        if (!set_field(&pkg->name, value)) return DEPTRACK_ERROR_MEMORY;
+    } else if (toml_key_is(value, 1, "version")) {
+        if (!set_field(&pkg->version, value)) return DEPTRACK_ERROR_MEMORY;
+    } else if (toml_key_is(value, 1, "source")) {
+        if (!set_field(&pkg->source, value)) return DEPTRACK_ERROR_MEMORY;
+    } else if (toml_key_is(value, 1, "dependencies")) {
+        // "name", "name version" or "name version (source)"
+        const char* space = memchr(value->value, ' ', value->value_length);
+        size_t name_length = space ? (size_t)(space - value->value) : value->value_length;
+        char** grown = realloc(pkg->dependencies, (pkg->dependency_count + 1) * sizeof(char*));
+        if (!grown) return DEPTRACK_ERROR_MEMORY;
+        pkg->dependencies = grown;
+        pkg->dependencies[pkg->dependency_count] = strndup(value->value, name_length);
+        if (!pkg->dependencies[pkg->dependency_count]) return DEPTRACK_ERROR_MEMORY;
+        pkg->dependency_count++;
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+CargoLock* cargo_lock_parse_buffer(const char* buffer, size_t length) {
+    if (!buffer) return NULL;
+
+    CargoLock* lock = calloc(1, sizeof(CargoLock));
+    if (!lock) return NULL;
+    lock->by_name = hashmap_create(256);
+
+    CargoLockLoad load = { lock, 0, false };
+    if (!lock->by_name || toml_parse_buffer(buffer, length, visit_lock_value, &load) != DEPTRACK_SUCCESS) {
+        cargo_lock_destroy(lock);
+        return NULL;
+    }
+
+    // Crates locked at several versions map to SIZE_MAX: the lock alone cannot pick one
+    for (size_t i = 0; i < lock->package_count; i++) {
+        const char* name = lock->packages[i].name;
+        size_t existing;
+        if (!name) continue;
+        if (hashmap_get(lock->by_name, name, &existing) == 0) {
+            hashmap_put(lock->by_name, name, SIZE_MAX);
+        } else {
+            hashmap_put(lock->by_name, name, i);
+        }
+    }
+    return lock;
+}
+
+const CargoLockPackage* cargo_lock_find(const CargoLock* lock, const char* name) {
+    size_t index;
+    if (!lock || !name || hashmap_get(lock->by_name, name, &index) != 0 || index == SIZE_MAX) {
+        return NULL;
+    }
+    return &lock->packages[index];
+}
+
+// ---------------------------------------------------------------------------
+// .rs sources
+// ---------------------------------------------------------------------------
+
+typedef enum {
+    RS_EOF,
+    RS_IDENT,
+    RS_PATH_SEP,               // ::
+    RS_SYMBOL,
+    RS_LITERAL
+} RsTokenKind;
+
+typedef struct {
+    RsTokenKind kind;
+    const char* start;
+    size_t length;
+} RsToken;
+
+typedef struct {
+    const char* start;
+    const char* p;
+    const char* end;
+} RsLexer;
+
+static bool rs_is_ident_start(char c) {
+    return isalpha((unsigned char)c) || c == '_' || (unsigned char)c >= 0x80;
+}
+
+static bool rs_is_ident_char(char c) {
+    return isalnum((unsigned char)c) || c == '_' || (unsigned char)c >= 0x80;
+}
+
+static void rs_skip_trivia(RsLexer* lex) {
+    while (lex->p < lex->end) {
+        char c = *lex->p;
+        if (isspace((unsigned char)c)) {
+            lex->p++;
+        } else if (c == '/' && lex->p + 1 < lex->end && lex->p[1] == '/') {
+            const char* nl = memchr(lex->p, '\n', (size_t)(lex->end - lex->p));
+            lex->p = nl ? nl : lex->end;
+        } else if (c == '/' && lex->p + 1 < lex->end && lex->p[1] == '*') {
+            // Rust block comments nest
+            int depth = 0;
+            do {
+                if (lex->p[0] == '/' && lex->p + 1 < lex->end && lex->p[1] == '*') {
+                    depth++;
+                    lex->p += 2;
+                } else if (lex->p[0] == '*' && lex->p + 1 < lex->end && lex->p[1] == '/') {
+                    depth--;
+                    lex->p += 2;
+                } else {
+                    lex->p++;
+                }
+            } while (depth > 0 && lex->p < lex->end);
+        } else {
+            break;
+        }
+    }
+}
+
+// Raw string r#"..."# (p at the first '#' or '"' after the r/br prefix)
+static const char* rs_skip_raw_string(RsLexer* lex, const char* p) {
+    size_t hashes = 0;
+    while (p < lex->end && *p == '#') {
+        hashes++;
+        p++;
+    }
+    if (p >= lex->end || *p != '"') return p;
+    p++;
+    while (p < lex->end) {
+        if (*p == '"') {
+            size_t n = 0;
+            while (n < hashes && p + 1 + n < lex->end && p[1 + n] == '#') n++;
+            if (n == hashes) return p + 1 + hashes;
+        }
+        p++;
+    }
+    return p;
+}
+
+static const char* rs_skip_string(RsLexer* lex, const char* p) {
+    p++; // opening quote
+    while (p < lex->end && *p != '"') {
+        if (*p == '\\' && p + 1 < lex->end) p++;
+        p++;
+    }
+    return p < lex->end ? p + 1 : p;
+}
+
+static RsToken rs_next(RsLexer* lex) {
+    rs_skip_trivia(lex);
+
+    RsToken tok = { RS_EOF, lex->p, 0 };
+    if (lex->p >= lex->end) return tok;
+
+    const char* p = lex->p;
+    char c = *p;
+
+    if ((c == 'r' || c == 'b') && p + 1 < lex->end) {
+        const char* q = p + 1;
+        if (c == 'b' && *q == 'r') q++;
+        if (c == 'r' && *q == '#' && q + 1 < lex->end && rs_is_ident_start(q[1])) {
+            // Raw identifier r#type
+            p = q + 1;
+            while (p < lex->end && rs_is_ident_char(*p)) p++;
+            tok.kind = RS_IDENT;
+            tok.start = q + 1;
+            tok.length = (size_t)(p - tok.start);
+            lex->p = p;
+            return tok;
+        }
+        if ((c == 'r' || q > p + 1) && q < lex->end && (*q == '"' || *q == '#')) {
+            lex->p = rs_skip_raw_string(lex, q);
+            tok.kind = RS_LITERAL;
+            return tok;
+        }
+        if (c == 'b' && (*q == '"' || *q == '\'')) {
+            p = q; // Byte string or byte literal: lex the quoted part below
+            c = *p;
+        }
+    }
+
+    if (rs_is_ident_start(c)) {
+        while (p < lex->end && rs_is_ident_char(*p)) p++;
+        tok.kind = RS_IDENT;
+        tok.length = (size_t)(p - tok.start);
+    } else if (c == '"') {
+        p = rs_skip_string(lex, p);
+        tok.kind = RS_LITERAL;
+    } else if (c == '\'') {
+        // Char literal ('a', '\n', '\u{1F600}') or lifetime ('a)
+        if (p + 1 < lex->end && p[1] == '\\') {
+            p += 2;
+            while (p < lex->end && *p != '\'' && *p != '\n') p++;
+            if (p < lex->end && *p == '\'') p++;
+            tok.kind = RS_LITERAL;
+        } else {
+            size_t width = 1;
+            if (p + 1 < lex->end) {
+                unsigned char lead = (unsigned char)p[1];
+                width = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC0 ? 2 : 1;
+            }
+            if (p + 1 + width < lex->end && p[1 + width] == '\'') {
+                p += 2 + width;
+                tok.kind = RS_LITERAL;
+            } else {
+                p++;
+                while (p < lex->end && rs_is_ident_char(*p)) p++;
+                tok.kind = RS_SYMBOL; // Lifetime or label
+            }
+        }
+    } else if (c == ':' && p + 1 < lex->end && p[1] == ':') {
+        p += 2;
+        tok.kind = RS_PATH_SEP;
+        tok.length = 2;
+    } else {
+        p++;
+        tok.kind = RS_SYMBOL;
+        tok.length = 1;
+    }
+
+    if (tok.kind == RS_LITERAL) tok.length = (size_t)(p - tok.start);
+    lex->p = p;
+    return tok;
+}
+
+static bool rs_is(RsToken tok, const char* text) {
+    size_t length = strlen(text);
+    return tok.kind == RS_IDENT && tok.length == length && memcmp(tok.start, text, length) == 0;
+}
+
+static bool rs_is_symbol(RsToken tok, char symbol) {
+    return tok.kind == RS_SYMBOL && tok.length == 1 && *tok.start == symbol;
+}
+
+static const char* rust_builtin_crates[] = { "std", "core", "alloc", "proc_macro", "test", NULL };
+
+static bool has_dependency(const ParsedFile* parsed, const char* name, size_t length) {
+    for (size_t i = 0; i < parsed->dep_count; i++) {
+        if (strlen(parsed->dependencies[i].name) == length &&
+            memcmp(parsed->dependencies[i].name, name, length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Records one use path: crate-relative paths as written, external crates by name only
+static bool emit_use_path(ParsedFile* parsed, const char* path, size_t length, size_t offset) {
+    if (length == 0) return true;
+
+    const char* sep = strstr(path, "::");
+    size_t root_length = sep && (size_t)(sep - path) < length ? (size_t)(sep - path) : length;
+
+    if ((root_length == 5 && memcmp(path, "crate", 5) == 0) ||
+        (root_length == 4 && memcmp(path, "self", 4) == 0) ||
+        (root_length == 5 && memcmp(path, "super", 5) == 0)) {
+        // "a::b::self" in a group names a::b itself
+        if (length > 6 && memcmp(path + length - 6, "::self", 6) == 0) length -= 6;
+        if (has_dependency(parsed, path, length)) return true;
+        return parsed_file_add_dependency_at(parsed, path, length, NULL, DEP_INTERNAL, offset) != NULL;
+    }
+
+    if (has_dependency(parsed, path, root_length)) return true;
+
+    const char* version = NULL;
+    for (size_t i = 0; rust_builtin_crates[i]; i++) {
+        if (strlen(rust_builtin_crates[i]) == root_length && memcmp(rust_builtin_crates[i], path, root_length) == 0) {
+            version = "stdlib";
+        }
+    }
+    return parsed_file_add_dependency_at(parsed, path, root_length, version, DEP_EXTERNAL, offset) != NULL;
+}
+
+// Walks a use tree (`a::b::{c, d::e as f, *}`) up to its ';'; offset is the `use` keyword's
+static bool parse_use_tree(RsLexer* lex, ParsedFile* parsed, size_t offset) {
+    char path[RUST_PATH_BUFFER];
+    size_t length = 0;
+    size_t group_start[RUST_MAX_USE_DEPTH];
+    size_t depth = 0;
+    bool pending = false;      // path holds segments not yet emitted
+
+    for (;;) {
+        RsToken tok = rs_next(lex);
+        if (tok.kind == RS_EOF) return true;
+
+        if (tok.kind == RS_IDENT) {
+            if (rs_is(tok, "as")) {
+                rs_next(lex); // Alias name
+                continue;
+            }
+            if (length > 0 && length + 2 < sizeof(path) && path[length - 1] != ':') {
+                // Two identifiers in a row: malformed, restart at the current group
+                length = depth ? group_start[depth - 1] : 0;
+            }
+            if (length + tok.length < sizeof(path)) {
+                memcpy(path + length, tok.start, tok.length);
+                length += tok.length;
+                path[length] = '\0';
+                pending = true;
+            }
+        } else if (tok.kind == RS_PATH_SEP) {
+            if (length > 0 && length + 2 < sizeof(path)) {
+                memcpy(path + length, "::", 3);
+                length += 2;
+            }
+        } else if (rs_is_symbol(tok, '{')) {
+            if (depth < RUST_MAX_USE_DEPTH) group_start[depth++] = length;
+            pending = false;
+        } else if (rs_is_symbol(tok, '*')) {
+            // Glob import: the path so far (minus its trailing ::) is the dependency
+            if (length >= 2 && path[length - 1] == ':') length -= 2;
+            path[length] = '\0';
+            if (!emit_use_path(parsed, path, length, offset)) return false;
+            pending = false;
+        } else if (rs_is_symbol(tok, ',') || rs_is_symbol(tok, '}') || rs_is_symbol(tok, ';')) {
+            if (pending) {
+                path[length] = '\0';
+                if (!emit_use_path(parsed, path, length, offset)) return false;
+                pending = false;
+            }
+            if (rs_is_symbol(tok, '}') && depth > 0) depth--;
+            if (rs_is_symbol(tok, ';')) return true;
+            length = depth ? group_start[depth - 1] : 0;
+            path[length] = '\0';
+        } else {
+            return true; // Not a use tree after all
+        }
+    }
+}
+
+ParsedFile* parse_rust_source_buffer(const char* filepath, const char* buffer, size_t length) {
+    if (!buffer) return NULL;
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_RUST);
+    if (!parsed) return NULL;
+
+    RsLexer lex = { buffer, buffer, buffer + length };
+    RsToken previous = { RS_EOF, NULL, 0 };
+    bool ok = true;
+
+    // `use` is a reserved word, so every occurrence outside literals is a declaration
+    for (RsToken tok = rs_next(&lex); ok && tok.kind != RS_EOF; tok = rs_next(&lex)) {
+        if (rs_is(tok, "use") && !(previous.kind == RS_PATH_SEP)) {
+            ok = parse_use_tree(&lex, parsed, (size_t)(tok.start - lex.start));
+        } else if (rs_is(tok, "crate") && rs_is(previous, "extern")) {
+            RsToken name = rs_next(&lex);
+            if (name.kind == RS_IDENT && !rs_is(name, "self") && !has_dependency(parsed, name.start, name.length)) {
+                ok = parsed_file_add_dependency_at(parsed, name.start, name.length, NULL, DEP_EXTERNAL,
+                                                   (size_t)(name.start - lex.start)) != NULL;
+            }
+        }
+        previous = tok;
+    }
+
+    if (ok) ok = parsed_file_resolve_lines(parsed, buffer, length) == DEPTRACK_SUCCESS;
+    if (!ok) {
+        parsed_file_destroy(parsed);
+        return NULL;
+    }
+    return parsed;
+}
+
+// ---------------------------------------------------------------------------
+// ParsedFile adapters
+// ---------------------------------------------------------------------------
+
+static ParsedFile* parse_cargo_manifest(const char* filepath, const char* buffer, size_t length) {
+    CargoManifest* manifest = cargo_manifest_parse_buffer(buffer, length);
+    if (!manifest) return NULL;
+
+    // Locked versions from a sibling Cargo.lock replace the requirements
+    char lock_path[MAX_PATH_LENGTH];
+    snprintf(lock_path, sizeof(lock_path), "%.*sCargo.lock", (int)(strlen(filepath) - strlen("Cargo.toml")), filepath);
+    CargoLock* lock = NULL;
+    size_t lock_length;
+    char* lock_buffer = parser_read_file(lock_path, &lock_length);
+    if (lock_buffer) {
+        lock = cargo_lock_parse_buffer(lock_buffer, lock_length);
+        free(lock_buffer);
+    }
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_RUST);
+    for (size_t i = 0; parsed && i < manifest->dependency_count; i++) {
+        const CargoDependency* dep = &manifest->dependencies[i];
+        const char* crate = dep->package ? dep->package : dep->name;
+
+        DependencyType type = dep->kind == CARGO_BUILD ? DEP_BUILD_TOOL : DEP_EXTERNAL;
+        if (dep->path) type = DEP_INTERNAL;
+
+        const char* version = dep->version;
+        if (dep->workspace && !version) version = "workspace";
+        const CargoLockPackage* locked = cargo_lock_find(lock, crate);
+        if (locked && locked->version) version = locked->version;
+
+        parsed_file_add_dependency(parsed, crate, strlen(crate), version, type, dep->line_number);
+    }
+
+    cargo_lock_destroy(lock);
+    cargo_manifest_destroy(manifest);
+    return parsed;
+}
+
+static ParsedFile* parse_cargo_lock(const char* filepath, const char* buffer, size_t length) {
+    CargoLock* lock = cargo_lock_parse_buffer(buffer, length);
+    if (!lock) return NULL;
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_RUST);
+    for (size_t i = 0; parsed && i < lock->package_count; i++) {
+        const CargoLockPackage* pkg = &lock->packages[i];
+        if (!pkg->name) continue;
+        // Packages without a source are workspace members
+        DependencyType type = pkg->source ? DEP_EXTERNAL : DEP_INTERNAL;
+        parsed_file_add_dependency(parsed, pkg->name, strlen(pkg->name), pkg->version, type, 0);
+    }
+
+    cargo_lock_destroy(lock);
+    return parsed;
+}
+
+ParsedFile* parse_rust_buffer(const char* filepath, const char* buffer, size_t length) {
+    if (!filepath || !buffer) return NULL;
+
+    if (file_has_suffix(filepath, "Cargo.toml")) {
+        return parse_cargo_manifest(filepath, buffer, length);
+    }
+    if (file_has_suffix(filepath, "Cargo.lock")) {
+        return parse_cargo_lock(filepath, buffer, length);
+    }
+    return parse_rust_source_buffer(filepath, buffer, length);
+}
+
+ParsedFile* parse_rust_file(const char* filepath) {
+    if (!filepath) return NULL;
+    return parser_parse_file(filepath, parse_rust_buffer);
+}
+
+const char* cargo_dependency_section(CargoDependencyKind kind) {
+    return kind <= CARGO_BUILD ? cargo_sections[kind] : "dependencies";
+}
@@ -0,0 +1,1008 @@
+/**
+ * @file shell_parser.c
+ * @brief Shell script source/exec scanner and the script dependency graph
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Finds the files a shell script sources, executes or hands to an interpreter, and joins
+ *             them with the Makefile's recipe scripts so that moving a script shows everything that breaks
+ * @llm-key Words keep their quotes until a command is analyzed; expansion then tracks simple variables,
+ *          the $(cd "$(dirname "$0")/.." && pwd) and git rev-parse --show-toplevel idioms, and `cd`
+ * @llm-contract Paths are relative to the scan root. A variable the scanner cannot know becomes a glob, so
+ *               `source "$PROFILES_DIR/$PROFILE.sh"` depends on every profile that exists
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <glob.h>
+#include <limits.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define SHELL_MAX_WORDS 256
+#define SHELL_MAX_SUBSHELLS 32
+#define SHELL_MAX_HEREDOCS 8
+#define SHELL_MAX_SUBSTITUTION_DEPTH 4
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} ShellText;
+
+typedef struct {
+    const char* start;         // Raw text, quotes included
+    size_t length;
+    int line;
+} ShellWord;
+
+typedef struct {
+    const char* root;          // NULL: no filesystem checks
+    char root_abs[PATH_MAX];
+    const char* filepath;      // Root-relative script path
+    char script_dir[MAX_PATH_LENGTH];
+    ShellScript* script;
+    char** names;
+    char** values;
+    size_t var_count;
+    HashMap* by_name;
+    char cwd[MAX_PATH_LENGTH]; // Root-relative; "." until a cd
+    bool cwd_known;
+    int substitution_depth;
+    bool failed;
+} ShellScanner;
+
+static bool text_append(ShellText* text, const char* data, size_t length) {
+    if (text->length + length + 1 > text->capacity) {
+        size_t capacity = text->capacity ? text->capacity : 64;
+        while (capacity < text->length + length + 1) capacity *= 2;
+        char* grown = realloc(text->data, capacity);
+        if (!grown) return false;
+        text->data = grown;
+        text->capacity = capacity;
+    }
+    memcpy(text->data + text->length, data, length);
+    text->length += length;
+    text->data[text->length] = '\0';
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Variables and expansion
+// ---------------------------------------------------------------------------
+
+static const char* lookup(const ShellScanner* sc, const char* name, size_t length) {
+    if ((length == 1 && name[0] == '0') || (length == 11 && memcmp(name, "BASH_SOURCE", 11) == 0) ||
+        (length == 14 && memcmp(name, "BASH_SOURCE[0]", 14) == 0)) {
+        return sc->filepath;
+    }
+    size_t index;
+    if (hashmap_get_n(sc->by_name, name, length, &index) != 0) return NULL;
+    return sc->values[index];
+}
+
+static void set_variable(ShellScanner* sc, const char* name, size_t length, const char* value) {
+    size_t index;
+    char* copy = strdup(value);
+    if (!copy) {
+        sc->failed = true;
+        return;
+    }
+    if (hashmap_get_n(sc->by_name, name, length, &index) == 0) {
+        free(sc->values[index]);
+        sc->values[index] = copy;
+        return;
+    }
+
+    char** names = realloc(sc->names, (sc->var_count + 1) * sizeof(char*));
+    if (names) sc->names = names;
+    char** values = realloc(sc->values, (sc->var_count + 1) * sizeof(char*));
+    if (values) sc->values = values;
+    if (!names || !values || !(sc->names[sc->var_count] = strndup(name, length)) ||
+        hashmap_put_n(sc->by_name, name, length, sc->var_count) != 0) {
+        free(copy);
+        sc->failed = true;
+        return;
+    }
+    sc->values[sc->var_count++] = copy;
+}
+
+// False when the joined path does not fit in size; out is then not a path to use
+static bool join_path(char* out, size_t size, const char* base, const char* path) {
+    int written;
+    if (path[0] == '/' || !base[0] || strcmp(base, ".") == 0) written = snprintf(out, size, "%s", path);
+    else written = snprintf(out, size, "%s/%s", base, path);
+    if (written < 0 || (size_t)written >= size) return false;
+    file_normalize_path(out);
+    return true;
+}
+
+// Index of the character closing the construct that opens at text[start] ('(', '{' or '`')
+static size_t find_closing(const char* text, size_t length, size_t start) {
+    char open = text[start];
+    char close = open == '(' ? ')' : open == '{' ? '}' : '`';
+    int depth = 0;
+    for (size_t i = start; i < length; i++) {
+        char c = text[i];
+        if (c == '\\') {
+            i++;
+        } else if (c == '\'' && open != '`') {
+            while (++i < length && text[i] != '\'') {}
+        } else if (c == '"' && i != start) {
+            // Quotes nest inside $(...): skip to the matching quote, minding inner substitutions
+            for (i++; i < length && text[i] != '"'; i++) {
+                if (text[i] == '\\') i++;
+                else if (text[i] == '$' && i + 1 < length && text[i + 1] == '(') i = find_closing(text, length, i + 1);
+            }
+        } else if (c == open && open != '`') {
+            depth++;
+        } else if (c == close && (open == '`' ? i != start : --depth == 0)) {
+            return i;
+        }
+    }
+    return length;
+}
+
+static bool expand_word(ShellScanner* sc, const char* raw, size_t length, ShellText* out, bool* unknown);
+
+static void strip_dirname(char* path) {
+    char* slash = strrchr(path, '/');
+    if (!slash) snprintf(path, 2, ".");
+    else if (slash == path) path[1] = '\0';
+    else *slash = '\0';
+}
+
+// Value of $(...) for the idioms scripts use to find themselves; false when unknowable
+static bool evaluate_substitution(ShellScanner* sc, const char* inner, size_t length, ShellText* out) {
+    while (length > 0 && isspace((unsigned char)*inner)) {
+        inner++;
+        length--;
+    }
+    while (length > 0 && isspace((unsigned char)inner[length - 1])) length--;
+
+    char command[MAX_PATH_LENGTH];
+    snprintf(command, sizeof(command), "%.*s", (int)length, inner);
+
+    if (strstr(command, "rev-parse") && strstr(command, "--show-toplevel")) {
+        return text_append(out, ".", 1);
+    }
+    if (strcmp(command, "pwd") == 0) {
+        return sc->cwd_known && text_append(out, sc->cwd, strlen(sc->cwd));
+    }
+
+    if (strncmp(command, "dirname ", 8) == 0) {
+        ShellText arg = { NULL, 0, 0 };
+        bool unknown = false;
+        const char* word = inner + 8;
+        bool ok = expand_word(sc, word, length - 8, &arg, &unknown) && !unknown && arg.data;
+        if (ok) {
+            strip_dirname(arg.data);
+            ok = text_append(out, arg.data, strlen(arg.data));
+        }
+        free(arg.data);
+        return ok;
+    }
+
+    // cd DIR && pwd, cd DIR; pwd
+    if (strncmp(command, "cd ", 3) == 0) {
+        const char* end = strstr(command, "&&");
+        const char* semi = strchr(command, ';');
+        if (!end || (semi && semi < end)) end = semi;
+        if (!end) return false;
+        const char* tail = end + (*end == '&' ? 2 : 1);
+        while (isspace((unsigned char)*tail)) tail++;
+        if (strncmp(tail, "pwd", 3) != 0) return false;
+
+        size_t arg_length = (size_t)(end - command) - 3;
+        while (arg_length > 0 && isspace((unsigned char)command[3 + arg_length - 1])) arg_length--;
+        ShellText arg = { NULL, 0, 0 };
+        bool unknown = false;
+        bool ok = expand_word(sc, inner + 3, arg_length, &arg, &unknown) && !unknown && arg.data;
+        if (ok) {
+            char path[MAX_PATH_LENGTH];
+            ok = join_path(path, sizeof(path), sc->cwd_known ? sc->cwd : ".", arg.data) &&
+                 text_append(out, path, strlen(path));
+        }
+        free(arg.data);
+        return ok;
+    }
+    return false;
+}
+
+static bool append_unknown(ShellText* out, bool* unknown) {
+    *unknown = true;
+    // One '*' stands for any run of unknown text
+    if (out->length > 0 && out->data[out->length - 1] == '*') return true;
+    return text_append(out, "*", 1);
+}
+
+static bool expand_parameter(ShellScanner* sc, const char* name, size_t length, ShellText* out, bool* unknown) {
+    // ${NAME:-default}, ${NAME-default}
+    const char* dash = memchr(name, '-', length);
+    size_t name_length = dash ? (size_t)(dash - name) : length;
+    if (dash && name_length > 0 && name[name_length - 1] == ':') name_length--;
+
+    const char* value = lookup(sc, name, name_length);
+    if (value) return text_append(out, value, strlen(value));
+    if (dash) {
+        const char* fallback = dash + 1;
+        return expand_word(sc, fallback, (size_t)(name + length - fallback), out, unknown);
+    }
+    return append_unknown(out, unknown);
+}
+
+// Quote removal and expansion of one raw word
+static bool expand_word(ShellScanner* sc, const char* raw, size_t length, ShellText* out, bool* unknown) {
+    if (!text_append(out, "", 0)) return false;
+
+    for (size_t i = 0; i < length; i++) {
+        char c = raw[i];
+        bool ok = true;
+        if (c == '\'') {
+            size_t end = i + 1;
+            while (end < length && raw[end] != '\'') end++;
+            ok = text_append(out, raw + i + 1, end - i - 1);
+            i = end;
+        } else if (c == '"') {
+            continue;
+        } else if (c == '\\' && i + 1 < length) {
+            ok = text_append(out, raw + ++i, 1);
+        } else if (c == '`') {
+            i = find_closing(raw, length, i);
+            ok = append_unknown(out, unknown);
+        } else if (c == '~' && i == 0) {
+            ok = append_unknown(out, unknown);
+        } else if (c == '$' && i + 1 < length && raw[i + 1] == '(') {
+            size_t end = find_closing(raw, length, i + 1);
+            bool arithmetic = i + 2 < length && raw[i + 2] == '(';
+            if (arithmetic || sc->substitution_depth >= SHELL_MAX_SUBSTITUTION_DEPTH) {
+                ok = append_unknown(out, unknown);
+            } else {
+                ShellText value = { NULL, 0, 0 };
+                sc->substitution_depth++;
+                bool known = evaluate_substitution(sc, raw + i + 2, end > i + 2 ? end - i - 2 : 0, &value);
+                sc->substitution_depth--;
+                ok = known ? text_append(out, value.data, value.length) : append_unknown(out, unknown);
+                free(value.data);
+            }
+            i = end;
+        } else if (c == '$' && i + 1 < length && raw[i + 1] == '{') {
+            size_t end = find_closing(raw, length, i + 1);
+            ok = expand_parameter(sc, raw + i + 2, end > i + 2 ? end - i - 2 : 0, out, unknown);
+            i = end;
+        } else if (c == '$' && i + 1 < length && (isalnum((unsigned char)raw[i + 1]) || raw[i + 1] == '_')) {
+            size_t start = i + 1;
+            size_t end = start + 1;
+            if (!isdigit((unsigned char)raw[start])) {
+                while (end < length && (isalnum((unsigned char)raw[end]) || raw[end] == '_')) end++;
+            }
+            const char* value = lookup(sc, raw + start, end - start);
+            ok = value ? text_append(out, value, strlen(value)) : append_unknown(out, unknown);
+            i = end - 1;
+        } else if (c == '$' && i + 1 < length && strchr("@*#?$!-", raw[i + 1])) {
+            ok = append_unknown(out, unknown);
+            i++;
+        } else {
+            ok = text_append(out, &c, 1);
+        }
+        if (!ok) return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// References
+// ---------------------------------------------------------------------------
+
+static bool path_exists(const ShellScanner* sc, const char* path) {
+    if (!sc->root) return false;
+    char full[MAX_PATH_LENGTH];
+    struct stat st;
+    int written;
+    if (path[0] == '/') written = snprintf(full, sizeof(full), "%s", path);
+    else written = snprintf(full, sizeof(full), "%s/%s", sc->root, path);
+    if (written < 0 || (size_t)written >= sizeof(full)) return false;
+    return stat(full, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+static void record(ShellScanner* sc, ShellReferenceKind kind, const char* path, bool exists, int line) {
+    ShellScript* script = sc->script;
+    for (size_t i = 0; i < script->reference_count; i++) {
+        if (script->references[i].kind == kind && strcmp(script->references[i].path, path) == 0) return;
+    }
+
+    if (script->reference_count >= script->reference_capacity) {
+        size_t capacity = script->reference_capacity ? script->reference_capacity * 2 : 8;
+        ShellReference* grown = realloc(script->references, capacity * sizeof(ShellReference));
+        if (!grown) {
+            sc->failed = true;
+            return;
+        }
+        script->references = grown;
+        script->reference_capacity = capacity;
+    }
+    ShellReference* ref = &script->references[script->reference_count];
+    ref->path = strdup(path);
+    ref->kind = kind;
+    ref->exists = exists;
+    ref->line_number = line;
+    if (!ref->path) {
+        sc->failed = true;
+        return;
+    }
+    script->reference_count++;
+}
+
+// Root-relative form of an absolute path inside the root
+static const char* relative_to_root(const ShellScanner* sc, const char* path) {
+    size_t length = strlen(sc->root_abs);
+    if (length > 0 && strncmp(path, sc->root_abs, length) == 0 && (path[length] == '/' || !path[length])) {
+        return path[length] ? path + length + 1 : ".";
+    }
+    return path;
+}
+
+static void add_reference(ShellScanner* sc, ShellReferenceKind kind, const char* expanded, bool unknown, int line) {
+    if (!expanded[0] || strcmp(expanded, "*") == 0 || expanded[0] == '-') return;
+    // Variables keep the '*' of whatever was unknown when they were assigned
+    unknown = unknown || strchr(expanded, '*') != NULL;
+
+    // Candidates: relative to the working directory, then to the script's own directory. One too long for
+    // the buffer is dropped rather than recorded cut short.
+    char candidates[2][MAX_PATH_LENGTH];
+    size_t candidate_count = 0;
+    if (expanded[0] == '/') {
+        int written = snprintf(candidates[0], MAX_PATH_LENGTH, "%s", relative_to_root(sc, expanded));
+        if (written >= 0 && written < MAX_PATH_LENGTH) candidate_count++;
+    } else {
+        if (join_path(candidates[candidate_count], MAX_PATH_LENGTH, sc->cwd_known ? sc->cwd : ".", expanded)) {
+            candidate_count++;
+        }
+        if (strcmp(sc->script_dir, ".") != 0 &&
+            join_path(candidates[candidate_count], MAX_PATH_LENGTH, sc->script_dir, expanded)) {
+            candidate_count++;
+        }
+    }
+    if (candidate_count == 0) return;
+
+    if (unknown) {
+        // Expand the unknown parts against the tree; no match leaves the pattern as written
+        bool literal = false;
+        for (const char* p = expanded; *p && !literal; p++) literal = *p != '*' && *p != '/' && *p != '.';
+        if (!literal || !sc->root) {
+            if (literal) record(sc, kind, candidates[0], false, line);
+            return;
+        }
+        bool matched = false;
+        for (size_t c = 0; c < candidate_count && !matched; c++) {
+            char pattern[MAX_PATH_LENGTH];
+            if (snprintf(pattern, sizeof(pattern), "%s/%s", sc->root, candidates[c]) >= (int)sizeof(pattern)) {
+                continue;
+            }
+            glob_t found;
+            if (glob(pattern, 0, NULL, &found) == 0) {
+                size_t prefix = strlen(sc->root) + 1;
+                for (size_t i = 0; i < found.gl_pathc; i++) {
+                    if (path_exists(sc, found.gl_pathv[i] + prefix)) {
+                        record(sc, kind, found.gl_pathv[i] + prefix, true, line);
+                        matched = true;
+                    }
+                }
+            }
+            globfree(&found);
+        }
+        if (!matched) record(sc, kind, candidates[0], false, line);
+        return;
+    }
+
+    for (size_t c = 0; c < candidate_count; c++) {
+        if (path_exists(sc, candidates[c])) {
+            record(sc, kind, candidates[c], true, line);
+            return;
+        }
+    }
+    record(sc, kind, candidates[0], false, line);
+}
+
+// ---------------------------------------------------------------------------
+// Commands
+// ---------------------------------------------------------------------------
+
+static bool is_assignment(const ShellWord* word, size_t* name_length) {
+    const char* p = word->start;
+    size_t i = 0;
+    if (word->length == 0 || !(isalpha((unsigned char)p[0]) || p[0] == '_')) return false;
+    while (i < word->length && (isalnum((unsigned char)p[i]) || p[i] == '_')) i++;
+    if (i < word->length && p[i] == '=') {
+        *name_length = i;
+        return true;
+    }
+    return false;
+}
+
+static void assign(ShellScanner* sc, const ShellWord* word, size_t name_length) {
+    ShellText value = { NULL, 0, 0 };
+    bool unknown = false;
+    if (!expand_word(sc, word->start + name_length + 1, word->length - name_length - 1, &value, &unknown)) {
+        sc->failed = true;
+    } else {
+        set_variable(sc, word->start, name_length, value.data ? value.data : "");
+    }
+    free(value.data);
+}
+
+static bool word_is(const ShellWord* word, const char* text) {
+    return strlen(text) == word->length && memcmp(word->start, text, word->length) == 0;
+}
+
+static const char* base_name(const char* path) {
+    const char* slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+static bool is_python(const char* base) {
+    if (strncmp(base, "python", 6) != 0) return false;
+    for (const char* p = base + 6; *p; p++) {
+        if (!isdigit((unsigned char)*p) && *p != '.') return false;
+    }
+    return true;
+}
+
+static bool is_shell(const char* base) {
+    static const char* shells[] = { "sh", "bash", "zsh", "dash", "ksh", NULL };
+    for (size_t i = 0; shells[i]; i++) {
+        if (strcmp(base, shells[i]) == 0) return true;
+    }
+    return false;
+}
+
+static void scan_commands(ShellScanner* sc, const char* text, size_t length, int first_line);
+
+// Commands inside $(...) and `...` run too: OUT=$(python3 tools/report.py)
+static void scan_substitutions(ShellScanner* sc, const ShellWord* word) {
+    if (sc->substitution_depth >= SHELL_MAX_SUBSTITUTION_DEPTH) return;
+    for (size_t i = 0; i + 1 < word->length; i++) {
+        if (word->start[i] == '\'') {
+            while (++i < word->length && word->start[i] != '\'') {}
+            continue;
+        }
+        if (word->start[i] != '$' || word->start[i + 1] != '(' ||
+            (i + 2 < word->length && word->start[i + 2] == '(')) {
+            continue;
+        }
+        size_t end = find_closing(word->start, word->length, i + 1);
+        char saved_cwd[MAX_PATH_LENGTH];
+        bool saved_known = sc->cwd_known;
+        snprintf(saved_cwd, sizeof(saved_cwd), "%s", sc->cwd);
+        sc->substitution_depth++;
+        scan_commands(sc, word->start + i + 2, end > i + 2 ? end - i - 2 : 0, word->line);
+        sc->substitution_depth--;
+        snprintf(sc->cwd, sizeof(sc->cwd), "%s", saved_cwd);
+        sc->cwd_known = saved_known;
+        i = end;
+    }
+}
+
+static void analyze_command(ShellScanner* sc, ShellWord* words, size_t count) {
+    for (size_t w = 0; w < count; w++) {
+        scan_substitutions(sc, &words[w]);
+    }
+
+    static const char* const prefixes[] = {
+        "if", "then", "else", "elif", "do", "while", "until", "!", "{", "time", "exec", "sudo", "nohup",
+        "command", "builtin", "env", NULL
+    };
+    static const char* const declarations[] = { "local", "export", "readonly", "declare", "typeset", NULL };
+
+    size_t i = 0;
+    size_t name_length;
+    for (;;) {
+        bool skipped = false;
+        for (size_t p = 0; i < count && prefixes[p]; p++) {
+            if (word_is(&words[i], prefixes[p])) {
+                i++;
+                skipped = true;
+                break;
+            }
+        }
+        if (!skipped) break;
+    }
+    if (i >= count) return;
+
+    // NAME=value alone sets a variable; before a command it only sets that command's environment
+    size_t first = i;
+    while (i < count && is_assignment(&words[i], &name_length)) i++;
+    if (i >= count) {
+        for (size_t a = first; a < count; a++) {
+            if (is_assignment(&words[a], &name_length)) assign(sc, &words[a], name_length);
+        }
+        return;
+    }
+    for (size_t d = 0; declarations[d]; d++) {
+        if (!word_is(&words[i], declarations[d])) continue;
+        for (size_t a = i + 1; a < count; a++) {
+            if (is_assignment(&words[a], &name_length)) assign(sc, &words[a], name_length);
+        }
+        return;
+    }
+
+    static const char* const skipped_commands[] = { "for", "case", "select", "function", "[[", "[", NULL };
+    for (size_t s = 0; skipped_commands[s]; s++) {
+        if (word_is(&words[i], skipped_commands[s])) return;
+    }
+
+    ShellText command = { NULL, 0, 0 };
+    bool unknown = false;
+    if (!expand_word(sc, words[i].start, words[i].length, &command, &unknown) || !command.data) {
+        free(command.data);
+        return;
+    }
+
+    if (strcmp(command.data, "cd") == 0) {
+        ShellText dir = { NULL, 0, 0 };
+        bool dir_unknown = false;
+        if (i + 1 < count && expand_word(sc, words[i + 1].start, words[i + 1].length, &dir, &dir_unknown) &&
+            dir.data && !dir_unknown && !strchr(dir.data, '*') && strcmp(dir.data, "-") != 0) {
+            // A relative cd from an unknown directory stays unknown
+            bool absolute = dir.data[0] == '/';
+            char next[MAX_PATH_LENGTH];
+            if (join_path(next, sizeof(next), sc->cwd, absolute ? relative_to_root(sc, dir.data) : dir.data)) {
+                snprintf(sc->cwd, sizeof(sc->cwd), "%s", next);
+                sc->cwd_known = sc->cwd_known || absolute;
+            } else {
+                sc->cwd_known = false;
+            }
+        } else {
+            sc->cwd_known = false;
+        }
+        free(dir.data);
+        free(command.data);
+        return;
+    }
+
+    const char* base = base_name(command.data);
+    ShellReferenceKind kind = SHELL_EXEC;
+    bool interpreter = false;
+    if (strcmp(command.data, "source") == 0 || strcmp(command.data, ".") == 0) {
+        kind = SHELL_SOURCE;
+        interpreter = true;
+    } else if (is_python(base)) {
+        kind = SHELL_PYTHON;
+        interpreter = true;
+    } else if (is_shell(base) || strcmp(base, "node") == 0) {
+        interpreter = true;
+    }
+
+    if (interpreter) {
+        for (size_t a = i + 1; a < count; a++) {
+            ShellText arg = { NULL, 0, 0 };
+            bool arg_unknown = false;
+            if (!expand_word(sc, words[a].start, words[a].length, &arg, &arg_unknown) || !arg.data) {
+                free(arg.data);
+                break;
+            }
+            // -c runs inline code and -m a module: no script file
+            bool stop = strcmp(arg.data, "-c") == 0 || strcmp(arg.data, "-m") == 0;
+            bool option = arg.data[0] == '-';
+            if (!stop && !option) add_reference(sc, kind, arg.data, arg_unknown, words[a].line);
+            free(arg.data);
+            if (stop || !option) break;
+        }
+    } else if (!unknown || strchr(command.data, '/')) {
+        bool python = file_has_suffix(command.data, ".py");
+        bool script = python || file_has_suffix(command.data, ".sh") || file_has_suffix(command.data, ".bash");
+        if (strchr(command.data, '/') || script) {
+            add_reference(sc, python ? SHELL_PYTHON : SHELL_EXEC, command.data, unknown, words[i].line);
+        }
+    }
+    free(command.data);
+}
+
+// ---------------------------------------------------------------------------
+// Lexer
+// ---------------------------------------------------------------------------
+
+// End of the word starting at p: quotes, $(...), ${...} and backticks group
+static const char* word_end(const char* p, const char* end) {
+    while (p < end) {
+        char c = *p;
+        if (isspace((unsigned char)c) || strchr(";&|()<>", c)) break;
+        if (c == '\\' && p + 1 < end) {
+            p += 2;
+        } else if (c == '\'') {
+            const char* close = memchr(p + 1, '\'', (size_t)(end - p - 1));
+            p = close ? close + 1 : end;
+        } else if (c == '"') {
+            for (p++; p < end && *p != '"'; p++) {
+                if (*p == '\\') p++;
+                else if (*p == '$' && p + 1 < end && p[1] == '(') p += find_closing(p, (size_t)(end - p), 1);
+            }
+            if (p < end) p++;
+        } else if (c == '$' && p + 1 < end && (p[1] == '(' || p[1] == '{')) {
+            p += find_closing(p, (size_t)(end - p), 1) + 1;
+        } else if (c == '`') {
+            p += find_closing(p, (size_t)(end - p), 0) + 1;
+        } else {
+            p++;
+        }
+    }
+    return p < end ? p : end;
+}
+
+static void scan_commands(ShellScanner* sc, const char* text, size_t length, int first_line) {
+    ShellWord words[SHELL_MAX_WORDS];
+    size_t word_count = 0;
+    char saved_cwd[SHELL_MAX_SUBSHELLS][MAX_PATH_LENGTH];
+    bool saved_known[SHELL_MAX_SUBSHELLS];
+    int subshell = 0;
+    char heredocs[SHELL_MAX_HEREDOCS][64];
+    bool heredoc_tabs[SHELL_MAX_HEREDOCS];
+    size_t heredoc_count = 0;
+
+    const char* p = text;
+    const char* end = text + length;
+    int line = first_line;
+    while (p < end && !sc->failed) {
+        char c = *p;
+
+        if (c == '\\' && p + 1 < end && p[1] == '\n') {
+            p += 2;
+            line++;
+            continue;
+        }
+        if (c == ' ' || c == '\t' || c == '\r') {
+            p++;
+            continue;
+        }
+        if (c == '#') {
+            while (p < end && *p != '\n') p++;
+            continue;
+        }
+
+        if (c == '\n' || c == ';' || c == '&' || c == '|' || c == '(' || c == ')') {
+            analyze_command(sc, words, word_count);
+            word_count = 0;
+            if (c == '(' && subshell < SHELL_MAX_SUBSHELLS) {
+                snprintf(saved_cwd[subshell], MAX_PATH_LENGTH, "%s", sc->cwd);
+                saved_known[subshell++] = sc->cwd_known;
+            } else if (c == ')' && subshell > 0) {
+                subshell--;
+                snprintf(sc->cwd, sizeof(sc->cwd), "%s", saved_cwd[subshell]);
+                sc->cwd_known = saved_known[subshell];
+            }
+            p++;
+            if (c != '\n') continue;
+            line++;
+
+            // Here-document bodies follow the line that opened them
+            for (size_t h = 0; h < heredoc_count; h++) {
+                while (p < end) {
+                    const char* eol = memchr(p, '\n', (size_t)(end - p));
+                    const char* stop = eol ? eol : end;
+                    const char* body = p;
+                    if (heredoc_tabs[h]) while (body < stop && *body == '\t') body++;
+                    size_t body_length = (size_t)(stop - body);
+                    if (body_length > 0 && body[body_length - 1] == '\r') body_length--;
+                    bool closing = body_length == strlen(heredocs[h]) && memcmp(body, heredocs[h], body_length) == 0;
+                    p = eol ? eol + 1 : end;
+                    if (eol) line++;
+                    if (closing) break;
+                }
+            }
+            heredoc_count = 0;
+            continue;
+        }
+
+        if (c == '<' || c == '>') {
+            // Redirection: the target word is neither command nor argument
+            bool heredoc = c == '<' && p + 1 < end && p[1] == '<' && !(p + 2 < end && p[2] == '<');
+            while (p < end && (*p == '<' || *p == '>' || *p == '&')) p++;
+            bool tabs = heredoc && p < end && *p == '-';
+            if (tabs) p++;
+            while (p < end && (*p == ' ' || *p == '\t')) p++;
+            const char* target_end = word_end(p, end);
+            if (heredoc && heredoc_count < SHELL_MAX_HEREDOCS) {
+                ShellText delimiter = { NULL, 0, 0 };
+                bool unknown = false;
+                if (expand_word(sc, p, (size_t)(target_end - p), &delimiter, &unknown) && delimiter.data) {
+                    snprintf(heredocs[heredoc_count], sizeof(heredocs[0]), "%s", delimiter.data);
+                    heredoc_tabs[heredoc_count++] = tabs;
+                }
+                free(delimiter.data);
+            }
+            p = target_end;
+            continue;
+        }
+
+        // File descriptor prefix of a redirection: 2>&1
+        if (isdigit((unsigned char)c) && p + 1 < end && (p[1] == '>' || p[1] == '<')) {
+            p++;
+            continue;
+        }
+
+        const char* stop = word_end(p, end);
+        if (stop == p) stop = p + 1;
+        if (word_count < SHELL_MAX_WORDS) {
+            words[word_count++] = (ShellWord){ p, (size_t)(stop - p), line };
+        }
+        for (const char* q = p; q < stop; q++) {
+            if (*q == '\n') line++;
+        }
+        p = stop;
+    }
+    analyze_command(sc, words, word_count);
+}
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+ShellScript* shell_scan_buffer(const char* root, const char* filepath, const char* buffer, size_t length) {
+    if (!filepath || !buffer) return NULL;
+
+    ShellScanner sc;
+    memset(&sc, 0, sizeof(sc));
+    sc.root = root;
+    if (root && !realpath(root, sc.root_abs)) sc.root_abs[0] = '\0';
+    sc.filepath = filepath;
+    snprintf(sc.script_dir, sizeof(sc.script_dir), "%s", filepath);
+    strip_dirname(sc.script_dir);
+    snprintf(sc.cwd, sizeof(sc.cwd), ".");
+    sc.cwd_known = true;
+    sc.by_name = hashmap_create(64);
+    sc.script = calloc(1, sizeof(ShellScript));
+    if (!sc.by_name || !sc.script || !(sc.script->filepath = strdup(filepath))) {
+        hashmap_destroy(sc.by_name);
+        shell_script_destroy(sc.script);
+        return NULL;
+    }
+
+    scan_commands(&sc, buffer, length, 1);
+
+    for (size_t i = 0; i < sc.var_count; i++) {
+        free(sc.names[i]);
+        free(sc.values[i]);
+    }
+    free(sc.names);
+    free(sc.values);
+    hashmap_destroy(sc.by_name);
+    if (sc.failed) {
+        shell_script_destroy(sc.script);
+        return NULL;
+    }
+    return sc.script;
+}
+
+ShellScript* shell_scan_file(const char* root, const char* filepath) {
+    char path[MAX_PATH_LENGTH];
+    if (root && filepath[0] != '/') snprintf(path, sizeof(path), "%s/%s", root, filepath);
+    else snprintf(path, sizeof(path), "%s", filepath);
+
+    size_t length;
+    char* buffer = parser_read_file(path, &length);
+    if (!buffer) return NULL;
+
+    ShellScript* script = shell_scan_buffer(root, filepath, buffer, length);
+    free(buffer);
+    return script;
+}
+
+void shell_script_destroy(ShellScript* script) {
+    if (!script) return;
+
+    for (size_t i = 0; i < script->reference_count; i++) {
+        free(script->references[i].path);
+    }
+    free(script->references);
+    free(script->filepath);
+    free(script);
+}
+
+bool shell_is_script(const char* filepath) {
+    return file_has_suffix(filepath, ".sh") || file_has_suffix(filepath, ".bash");
+}
+
+const char* shell_reference_kind_name(ShellReferenceKind kind) {
+    switch (kind) {
+        case SHELL_SOURCE: return "source";
+        case SHELL_EXEC: return "exec";
+        case SHELL_PYTHON: return "python";
+        case SHELL_MAKE: return "make";
+    }
+    return "unknown";
+}
+
+ParsedFile* parse_shell_buffer(const char* filepath, const char* buffer, size_t length) {
+    // Analysis runs from the repository root, which is what the scripts assume too
+    ShellScript* script = shell_scan_buffer(".", filepath, buffer, length);
+    if (!script) return NULL;
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_SHELL);
+    for (size_t i = 0; parsed && i < script->reference_count; i++) {
+        const ShellReference* ref = &script->references[i];
+        parsed_file_add_dependency(parsed, ref->path, strlen(ref->path), NULL, DEP_RUNTIME, ref->line_number);
+    }
+    shell_script_destroy(script);
+    return parsed;
+}
+
+ParsedFile* parse_shell_file(const char* filepath) {
+    return parser_parse_file(filepath, parse_shell_buffer);
+}
+
+// ---------------------------------------------------------------------------
+// Script graph
+// ---------------------------------------------------------------------------
+
+static size_t graph_node(ScriptGraph* graph, const char* name) {
+    size_t index;
+    if (hashmap_get(graph->by_name, name, &index) == 0) return index;
+
+    if (graph->node_count >= graph->node_capacity) {
+        size_t capacity = graph->node_capacity ? graph->node_capacity * 2 : 64;
+        char** grown = realloc(graph->nodes, capacity * sizeof(char*));
+        if (!grown) return SIZE_MAX;
+        graph->nodes = grown;
+        graph->node_capacity = capacity;
+    }
+    graph->nodes[graph->node_count] = strdup(name);
+    if (!graph->nodes[graph->node_count] || hashmap_put(graph->by_name, name, graph->node_count) != 0) {
+        free(graph->nodes[graph->node_count]);
+        return SIZE_MAX;
+    }
+    return graph->node_count++;
+}
+
+static int graph_edge(ScriptGraph* graph, const char* user, const char* used, ShellReferenceKind kind) {
+    size_t from = graph_node(graph, user);
+    size_t to = graph_node(graph, used);
+    if (from == SIZE_MAX || to == SIZE_MAX) return DEPTRACK_ERROR_MEMORY;
+
+    if (graph->edge_count >= graph->edge_capacity) {
+        size_t capacity = graph->edge_capacity ? graph->edge_capacity * 2 : 128;
+        size_t* from_grown = realloc(graph->edge_from, capacity * sizeof(size_t));
+        if (from_grown) graph->edge_from = from_grown;
+        size_t* to_grown = realloc(graph->edge_to, capacity * sizeof(size_t));
+        if (to_grown) graph->edge_to = to_grown;
+        ShellReferenceKind* kind_grown = realloc(graph->edge_kind, capacity * sizeof(ShellReferenceKind));
+        if (kind_grown) graph->edge_kind = kind_grown;
+        if (!from_grown || !to_grown || !kind_grown) return DEPTRACK_ERROR_MEMORY;
+        graph->edge_capacity = capacity;
+    }
+    graph->edge_from[graph->edge_count] = from;
+    graph->edge_to[graph->edge_count] = to;
+    graph->edge_kind[graph->edge_count] = kind;
+    graph->edge_count++;
+    return DEPTRACK_SUCCESS;
+}
+
+typedef struct {
+    ScriptGraph* graph;
+    const char* root;
+    size_t root_length;
+} ScriptGraphWalk;
+
+static int script_graph_visit(const char* path, void* context) {
+    ScriptGraphWalk* walk = context;
+    if (!shell_is_script(path)) return DEPTRACK_SUCCESS;
+
+    const char* relative = path + walk->root_length;
+    while (*relative == '/') relative++;
+    ShellScript* script = shell_scan_file(walk->root, relative);
+    if (!script) return DEPTRACK_SUCCESS;
+
+    int result = graph_node(walk->graph, relative) == SIZE_MAX ? DEPTRACK_ERROR_MEMORY : DEPTRACK_SUCCESS;
+    for (size_t i = 0; result == DEPTRACK_SUCCESS && i < script->reference_count; i++) {
+        result = graph_edge(walk->graph, relative, script->references[i].path, script->references[i].kind);
+    }
+    shell_script_destroy(script);
+    return result;
+}
+
+ScriptGraph* script_graph_load(const char* root) {
+    ScriptGraph* graph = calloc(1, sizeof(ScriptGraph));
+    if (!graph) return NULL;
+    graph->by_name = hashmap_create(256);
+    if (!graph->by_name) {
+        script_graph_destroy(graph);
+        return NULL;
+    }
+
+    char trimmed[MAX_PATH_LENGTH];
+    snprintf(trimmed, sizeof(trimmed), "%s", root);
+    size_t length = strlen(trimmed);
+    while (length > 1 && trimmed[length - 1] == '/') trimmed[--length] = '\0';
+
+    ScriptGraphWalk walk = { graph, trimmed, length };
+    if (file_walk(trimmed, script_graph_visit, &walk) != DEPTRACK_SUCCESS) {
+        script_graph_destroy(graph);
+        return NULL;
+    }
+
+    // Makefile targets are users too: the recipe runs scripts, prerequisites and sub-makes run targets
+    char path[MAX_PATH_LENGTH];
+    Makefile* mf = NULL;
+    if (snprintf(path, sizeof(path), "%s/Makefile", trimmed) < (int)sizeof(path)) {
+        mf = makefile_parse_file(path);
+    }
+    int result = DEPTRACK_SUCCESS;
+    for (size_t t = 0; mf && t < mf->target_count && result == DEPTRACK_SUCCESS; t++) {
+        const MakeTarget* target = &mf->targets[t];
+        char name[MAX_PATH_LENGTH];
+        snprintf(name, sizeof(name), "make:%s", target->name);
+        result = graph_node(graph, name) == SIZE_MAX ? DEPTRACK_ERROR_MEMORY : DEPTRACK_SUCCESS;
+        for (size_t s = 0; s < target->script_count && result == DEPTRACK_SUCCESS; s++) {
+            result = graph_edge(graph, name, target->scripts[s],
+                                is_python(base_name(target->scripts[s])) || file_has_suffix(target->scripts[s], ".py")
+                                    ? SHELL_PYTHON : SHELL_EXEC);
+        }
+        char** lists[] = { target->prerequisites, target->invocations };
+        size_t counts[] = { target->prerequisite_count, target->invocation_count };
+        for (size_t l = 0; l < 2; l++) {
+            for (size_t j = 0; j < counts[l] && result == DEPTRACK_SUCCESS; j++) {
+                char used[MAX_PATH_LENGTH];
+                if (makefile_find_target(mf, lists[l][j])) snprintf(used, sizeof(used), "make:%s", lists[l][j]);
+                else snprintf(used, sizeof(used), "%s", lists[l][j]);
+                result = graph_edge(graph, name, used, SHELL_MAKE);
+            }
+        }
+    }
+    makefile_destroy(mf);
+
+    if (result != DEPTRACK_SUCCESS) {
+        script_graph_destroy(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+void script_graph_destroy(ScriptGraph* graph) {
+    if (!graph) return;
+
+    for (size_t i = 0; i < graph->node_count; i++) {
+        free(graph->nodes[i]);
+    }
+    free(graph->nodes);
+    free(graph->edge_from);
+    free(graph->edge_to);
+    free(graph->edge_kind);
+    hashmap_destroy(graph->by_name);
+    free(graph);
+}
+
+size_t script_graph_dependents(const ScriptGraph* graph, const char* path, bool* dependents) {
+    if (!graph || !path || !dependents) {
+        return 0;
+    }
+    memset(dependents, 0, graph->node_count * sizeof(bool));
+
+    char normalized[MAX_PATH_LENGTH];
+    snprintf(normalized, sizeof(normalized), "%s", path);
+    file_normalize_path(normalized);
+    size_t start;
+    if (hashmap_get(graph->by_name, normalized, &start) != 0) {
+        return 0;
+    }
+
+    size_t* queue = malloc(graph->node_count * sizeof(size_t));
+    if (!queue) {
+        return 0;
+    }
+
+    // Walk user edges backwards from the file
+    size_t head = 0, tail = 0;
+    queue[tail++] = start;
+    while (head < tail) {
+        size_t current = queue[head++];
+        for (size_t e = 0; e < graph->edge_count; e++) {
+            size_t user = graph->edge_from[e];
+            if (graph->edge_to[e] == current && user != start && !dependents[user]) {
+                dependents[user] = true;
+                queue[tail++] = user;
+            }
+        }
+    }
+
+    free(queue);
+    return tail - 1;
+}
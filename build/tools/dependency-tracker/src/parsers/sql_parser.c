@@ -0,0 +1,1294 @@
+/**
+ * @file sql_parser.c
+ * @brief Streaming SQL migration scanner, apply order and forward-reference check
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Finds the tables, views and functions each migration defines, alters and reads,
+ *             and orders a migration directory so that every object exists before it is used
+ * @llm-key The lexer is a byte-at-a-time state machine, so a file is fed in fixed-size chunks and
+ *          tokens may straddle chunk boundaries; memory grows with the objects found, not the file
+ * @llm-contract Dollar-quoted function bodies are opaque: only references visible to the server at
+ *               CREATE time count. COPY ... FROM stdin data blocks of pg_dump output are skipped
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <string.h>
+
+#define SQL_CHUNK_SIZE 65536
+#define SQL_MAX_DOLLAR_TAG 64
+#define SQL_MAX_PAREN_DEPTH 64
+
+typedef enum {
+    SQL_TOKEN_IDENT,           // Unquoted, lower-cased as the server folds it
+    SQL_TOKEN_QUOTED,          // "Quoted" or `quoted` identifier, case kept
+    SQL_TOKEN_SYMBOL,          // ( ) , ; .
+    SQL_TOKEN_OTHER            // Strings, numbers, operators
+} SqlTokenType;
+
+typedef enum {
+    LEX_NORMAL,
+    LEX_IDENT,
+    LEX_QUOTED_IDENT,
+    LEX_QUOTED_IDENT_QUOTE,    // Closing quote seen; a second one is an escaped quote
+    LEX_STRING,
+    LEX_STRING_ESCAPE,         // Backslash inside E'...'
+    LEX_STRING_QUOTE,
+    LEX_NUMBER,
+    LEX_DASH,
+    LEX_LINE_COMMENT,
+    LEX_SLASH,
+    LEX_BLOCK_COMMENT,
+    LEX_DOLLAR_TAG,            // Between the '$' signs of an opening $tag$
+    LEX_DOLLAR_BODY,
+    LEX_COPY_DATA              // Rows of COPY ... FROM stdin, up to a "\." line
+} SqlLexState;
+
+typedef enum {
+    EXPECT_NONE,
+    EXPECT_NAME                // Next qualified name is an object with expect_access/expect_kind
+} SqlExpect;
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} SqlText;
+
+struct SqlScanner {
+    SqlMigration* migration;
+    bool failed;
+
+    // Lexer
+    SqlLexState state;
+    int line;
+    int token_line;
+    SqlText token;
+    char quote;                // Closing character of the quoted identifier
+    bool escapes;              // E'...' string
+    char block_prev;
+    int block_depth;
+    char tag[SQL_MAX_DOLLAR_TAG + 2];
+    size_t tag_length;
+    size_t tag_match;          // Characters of "$tag$" matched inside a dollar body
+    int copy_line;             // 0 at line start, 1 after "\", 2 after "\.", -1 elsewhere
+
+    // Statement
+    size_t token_index;
+    int depth;
+    char verb[16];
+    bool prev_rparen;
+    SqlObjectKind create_kind;
+    bool kind_pending;         // CREATE/ALTER/DROP/... waiting for TABLE, VIEW, FUNCTION, ...
+    SqlAccess kind_access;
+    SqlExpect expect;
+    SqlAccess expect_access;
+    SqlObjectKind expect_kind;
+    bool expect_optional;      // IF EXISTS seen
+    bool list_active;          // Comma-separated names (FROM a, b / DROP TABLE a, b)
+    SqlAccess list_access;
+    SqlObjectKind list_kind;
+    int list_depth;
+    bool on_target_pending;    // CREATE INDEX/TRIGGER/POLICY ... ON table
+    bool rename_pending;
+    bool cte_expect;
+    int cte_depth;             // Depth of the open WITH list, -1 when none
+    bool delete_from_seen;
+    bool copy_from;
+    bool copy_stdin;
+    bool special_paren[SQL_MAX_PAREN_DEPTH]; // EXTRACT(x FROM y) and friends
+    bool special_next;         // The '(' about to open belongs to such a function
+    char** ctes;
+    size_t cte_count;
+    size_t statement_first_object;
+
+    // Qualified name being assembled: a.b."C"
+    SqlText chain;
+    bool chain_active;
+    bool chain_after_dot;
+    int chain_line;
+};
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+
+static bool text_append(SqlText* text, const char* data, size_t length) {
+    if (text->length + length + 1 > text->capacity) {
+        size_t capacity = text->capacity ? text->capacity : 64;
+        while (capacity < text->length + length + 1) capacity *= 2;
+        char* grown = realloc(text->data, capacity);
+        if (!grown) return false;
+        text->data = grown;
+        text->capacity = capacity;
+    }
+    memcpy(text->data + text->length, data, length);
+    text->length += length;
+    text->data[text->length] = '\0';
+    return true;
+}
+
+static bool word_in(const char* word, const char* const* words) {
+    for (size_t i = 0; words[i]; i++) {
+        if (strcmp(word, words[i]) == 0) return true;
+    }
+    return false;
+}
+
+static const char* const sql_keywords[] = {
+    "add", "aggregate", "all", "alter", "and", "as", "by", "call", "cascade", "check", "column", "comment",
+    "concurrently", "constraint", "copy", "create", "cross", "delete", "distinct", "do", "domain", "drop",
+    "else", "end", "except", "execute", "exists", "extension", "for", "foreign", "from", "full", "function",
+    "global", "grant", "group", "having", "if", "in", "index", "inner", "insert", "intersect", "into", "is",
+    "join", "lateral", "left", "like", "limit", "local", "materialized", "merge", "natural", "not", "null",
+    "offset", "on", "only", "or", "order", "outer", "policy", "primary", "procedure", "recursive",
+    "references", "rename", "replace", "returning", "revoke", "right", "rule", "schema", "select",
+    "sequence", "set", "table", "temp", "temporary", "then", "to", "trigger", "truncate", "type", "union",
+    "unique", "unlogged", "update", "using", "values", "view", "when", "where", "window", "with", NULL
+};
+
+static bool is_keyword(const char* word) {
+    return word_in(word, sql_keywords);
+}
+
+static bool kind_from_keyword(const char* word, SqlObjectKind* kind) {
+    static const struct { const char* word; SqlObjectKind kind; } kinds[] = {
+        { "table", SQL_OBJECT_TABLE }, { "view", SQL_OBJECT_VIEW }, { "function", SQL_OBJECT_FUNCTION },
+        { "procedure", SQL_OBJECT_FUNCTION }, { "aggregate", SQL_OBJECT_FUNCTION },
+        { "index", SQL_OBJECT_INDEX }, { "sequence", SQL_OBJECT_SEQUENCE }, { "type", SQL_OBJECT_TYPE },
+        { "domain", SQL_OBJECT_TYPE }, { "schema", SQL_OBJECT_SCHEMA }, { "trigger", SQL_OBJECT_TRIGGER },
+        { "extension", SQL_OBJECT_OTHER }, { "policy", SQL_OBJECT_OTHER }, { "rule", SQL_OBJECT_OTHER },
+    };
+    for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+        if (strcmp(word, kinds[i].word) == 0) {
+            *kind = kinds[i].kind;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool is_function_kind(SqlObjectKind kind) {
+    return kind == SQL_OBJECT_FUNCTION;
+}
+
+// ---------------------------------------------------------------------------
+// Objects
+// ---------------------------------------------------------------------------
+
+static void add_object(SqlScanner* s, const char* name, SqlObjectKind kind, SqlAccess access, bool call,
+                       bool optional, int line) {
+    SqlMigration* m = s->migration;
+    // public.x and x name the same object under the default search_path
+    if (strncmp(name, "public.", 7) == 0 && name[7]) name += 7;
+
+    if (m->object_count >= m->object_capacity) {
+        size_t capacity = m->object_capacity ? m->object_capacity * 2 : 32;
+        SqlObject* grown = realloc(m->objects, capacity * sizeof(SqlObject));
+        if (!grown) {
+            s->failed = true;
+            return;
+        }
+        m->objects = grown;
+        m->object_capacity = capacity;
+    }
+
+    SqlObject* obj = &m->objects[m->object_count];
+    obj->name = strdup(name);
+    if (!obj->name) {
+        s->failed = true;
+        return;
+    }
+    obj->kind = kind;
+    obj->access = access;
+    obj->call = call;
+    obj->optional = optional;
+    obj->statement = m->statement_count;
+    obj->line_number = line;
+    m->object_count++;
+}
+
+// ---------------------------------------------------------------------------
+// Statement analysis
+// ---------------------------------------------------------------------------
+
+static void expect_name(SqlScanner* s, SqlAccess access, SqlObjectKind kind) {
+    s->expect = EXPECT_NAME;
+    s->expect_access = access;
+    s->expect_kind = kind;
+    s->expect_optional = false;
+}
+
+static void start_list(SqlScanner* s, SqlAccess access, SqlObjectKind kind) {
+    s->list_active = true;
+    s->list_access = access;
+    s->list_kind = kind;
+    s->list_depth = s->depth;
+}
+
+static void finish_chain(SqlScanner* s, bool next_is_paren) {
+    if (!s->chain_active) return;
+    s->chain_active = false;
+    s->chain_after_dot = false;
+
+    const char* name = s->chain.data;
+
+    if (s->expect == EXPECT_NAME) {
+        s->expect = EXPECT_NONE;
+        // FROM generate_series(...) reads a set-returning function, not a relation
+        if (next_is_paren && s->expect_access == SQL_ACCESS_READ && s->expect_kind == SQL_OBJECT_RELATION) {
+            add_object(s, name, SQL_OBJECT_FUNCTION, SQL_ACCESS_READ, true, false, s->chain_line);
+            return;
+        }
+        add_object(s, name, s->expect_kind, s->expect_access, false, s->expect_optional, s->chain_line);
+        if (s->expect_access == SQL_ACCESS_DEFINE &&
+            (s->expect_kind == SQL_OBJECT_INDEX || s->expect_kind == SQL_OBJECT_TRIGGER ||
+             s->expect_kind == SQL_OBJECT_OTHER)) {
+            s->on_target_pending = true;
+        }
+        return;
+    }
+
+    if (s->cte_expect) {
+        s->cte_expect = false;
+        char** grown = realloc(s->ctes, (s->cte_count + 1) * sizeof(char*));
+        if (!grown || !(grown[s->cte_count] = strdup(name))) {
+            s->ctes = grown ? grown : s->ctes;
+            s->failed = true;
+            return;
+        }
+        s->ctes = grown;
+        s->cte_count++;
+        return;
+    }
+
+    if (next_is_paren) {
+        static const char* const special[] = { "extract", "substring", "trim", "overlay", "position", NULL };
+        s->special_next = word_in(name, special);
+        add_object(s, name, SQL_OBJECT_FUNCTION, SQL_ACCESS_READ, true, false, s->chain_line);
+    }
+}
+
+static void end_statement(SqlScanner* s) {
+    SqlMigration* m = s->migration;
+
+    // Common table expressions shadow relations of the same name
+    if (s->cte_count > 0) {
+        size_t kept = s->statement_first_object;
+        for (size_t i = s->statement_first_object; i < m->object_count; i++) {
+            SqlObject* obj = &m->objects[i];
+            bool shadowed = false;
+            for (size_t c = 0; c < s->cte_count && !shadowed; c++) {
+                shadowed = obj->access != SQL_ACCESS_DEFINE && !is_function_kind(obj->kind) &&
+                           strcmp(obj->name, s->ctes[c]) == 0;
+            }
+            if (shadowed) free(obj->name);
+            else m->objects[kept++] = *obj;
+        }
+        m->object_count = kept;
+    }
+    for (size_t c = 0; c < s->cte_count; c++) {
+        free(s->ctes[c]);
+    }
+    s->cte_count = 0;
+
+    if (s->token_index > 0) m->statement_count++;
+    if (s->copy_stdin) {
+        s->state = LEX_COPY_DATA;
+        s->copy_line = -1;
+    }
+
+    s->token_index = 0;
+    s->depth = 0;
+    s->verb[0] = '\0';
+    s->prev_rparen = false;
+    s->kind_pending = false;
+    s->expect = EXPECT_NONE;
+    s->list_active = false;
+    s->on_target_pending = false;
+    s->rename_pending = false;
+    s->cte_expect = false;
+    s->cte_depth = -1;
+    s->delete_from_seen = false;
+    s->copy_from = false;
+    s->copy_stdin = false;
+    memset(s->special_paren, 0, sizeof(s->special_paren));
+    s->special_next = false;
+    s->statement_first_object = m->object_count;
+}
+
+static bool verb_is(const SqlScanner* s, const char* verb) {
+    return strcmp(s->verb, verb) == 0;
+}
+
+static void set_verb(SqlScanner* s, const char* word) {
+    snprintf(s->verb, sizeof(s->verb), "%s", word);
+}
+
+// Returns true when the keyword was consumed; false lets an unknown word start a name
+static bool handle_keyword(SqlScanner* s, const char* word) {
+    bool statement_start = s->token_index == 0 || (verb_is(s, "with") && s->depth == 0 && s->prev_rparen);
+
+    if (s->expect == EXPECT_NAME) {
+        if (strcmp(word, "if") == 0 || strcmp(word, "not") == 0 || strcmp(word, "exists") == 0) {
+            s->expect_optional = s->expect_optional || strcmp(word, "exists") == 0;
+            return true;
+        }
+        if (strcmp(word, "only") == 0 || strcmp(word, "lateral") == 0 || strcmp(word, "concurrently") == 0 ||
+            strcmp(word, "table") == 0) {
+            return true;
+        }
+        // CREATE INDEX ON t (no index name)
+        if (strcmp(word, "on") == 0 && s->expect_access == SQL_ACCESS_DEFINE && s->expect_kind == SQL_OBJECT_INDEX) {
+            expect_name(s, SQL_ACCESS_WRITE, SQL_OBJECT_TABLE);
+            return true;
+        }
+    }
+
+    if (s->kind_pending) {
+        static const char* const modifiers[] = {
+            "or", "replace", "temp", "temporary", "unlogged", "global", "local", "materialized", "unique",
+            "recursive", "constraint", "if", "not", "exists", "concurrently", "only", NULL
+        };
+        SqlObjectKind kind;
+        if (kind_from_keyword(word, &kind)) {
+            s->kind_pending = false;
+            s->create_kind = kind;
+            expect_name(s, s->kind_access, kind);
+            if (s->kind_access != SQL_ACCESS_DEFINE && verb_is(s, "drop")) start_list(s, s->kind_access, kind);
+            return true;
+        }
+        if (word_in(word, modifiers)) return true;
+        s->kind_pending = false;
+    }
+
+    if (statement_start) {
+        if (strcmp(word, "create") == 0 || strcmp(word, "alter") == 0 || strcmp(word, "drop") == 0) {
+            set_verb(s, word);
+            s->kind_pending = true;
+            s->kind_access = word[0] == 'c' ? SQL_ACCESS_DEFINE : SQL_ACCESS_WRITE;
+            return true;
+        }
+        if (strcmp(word, "update") == 0 || strcmp(word, "truncate") == 0 || strcmp(word, "copy") == 0) {
+            set_verb(s, word);
+            expect_name(s, SQL_ACCESS_WRITE, SQL_OBJECT_RELATION);
+            if (word[0] == 't') start_list(s, SQL_ACCESS_WRITE, SQL_OBJECT_RELATION);
+            return true;
+        }
+        if (strcmp(word, "call") == 0) {
+            set_verb(s, word);
+            expect_name(s, SQL_ACCESS_READ, SQL_OBJECT_FUNCTION);
+            return true;
+        }
+        if (strcmp(word, "with") == 0) {
+            set_verb(s, word);
+            s->cte_expect = true;
+            s->cte_depth = s->depth;
+            return true;
+        }
+        if (is_keyword(word)) {
+            set_verb(s, word);
+            return true;
+        }
+        return false;
+    }
+
+    if (!is_keyword(word)) {
+        return false;
+    }
+
+    // A keyword where a name was expected: ON ALL TABLES, FROM (VALUES ...), ...
+    s->expect = EXPECT_NONE;
+
+    // Any clause keyword ends a FROM or DROP list; aliases keep it open
+    if (strcmp(word, "as") != 0 && strcmp(word, "only") != 0 && strcmp(word, "lateral") != 0) {
+        s->list_active = false;
+    }
+
+    // WITH inside a view or subquery: CREATE VIEW v AS WITH x AS (...) SELECT ...
+    if (strcmp(word, "with") == 0) {
+        s->cte_expect = true;
+        s->cte_depth = s->depth;
+        return true;
+    }
+    if (strcmp(word, "recursive") == 0 && s->cte_expect) {
+        return true;
+    }
+    if (s->depth == s->cte_depth && (strcmp(word, "select") == 0 || strcmp(word, "insert") == 0 ||
+                                     strcmp(word, "update") == 0 || strcmp(word, "delete") == 0)) {
+        s->cte_depth = -1;
+    }
+    if (strcmp(word, "on") == 0) {
+        if (s->on_target_pending) {
+            s->on_target_pending = false;
+            expect_name(s, SQL_ACCESS_WRITE, SQL_OBJECT_TABLE);
+        } else if (verb_is(s, "comment") || verb_is(s, "grant") || verb_is(s, "revoke")) {
+            s->kind_pending = true;
+            s->kind_access = verb_is(s, "comment") ? SQL_ACCESS_WRITE : SQL_ACCESS_READ;
+            // GRANT ... ON name: the kind keyword is optional for tables
+            if (!verb_is(s, "comment")) expect_name(s, SQL_ACCESS_READ, SQL_OBJECT_RELATION);
+        }
+        return true;
+    }
+    if (strcmp(word, "from") == 0) {
+        if (s->depth < SQL_MAX_PAREN_DEPTH && s->special_paren[s->depth]) {
+            return true;
+        }
+        if (verb_is(s, "delete") && !s->delete_from_seen) {
+            s->delete_from_seen = true;
+            expect_name(s, SQL_ACCESS_WRITE, SQL_OBJECT_RELATION);
+        } else if (verb_is(s, "copy")) {
+            s->copy_from = true;
+        } else {
+            expect_name(s, SQL_ACCESS_READ, SQL_OBJECT_RELATION);
+            start_list(s, SQL_ACCESS_READ, SQL_OBJECT_RELATION);
+        }
+        return true;
+    }
+    if (strcmp(word, "using") == 0 && verb_is(s, "delete")) {
+        expect_name(s, SQL_ACCESS_READ, SQL_OBJECT_RELATION);
+        start_list(s, SQL_ACCESS_READ, SQL_OBJECT_RELATION);
+        return true;
+    }
+    if (strcmp(word, "join") == 0) {
+        expect_name(s, SQL_ACCESS_READ, SQL_OBJECT_RELATION);
+        return true;
+    }
+    if (strcmp(word, "references") == 0) {
+        expect_name(s, SQL_ACCESS_READ, SQL_OBJECT_TABLE);
+        return true;
+    }
+    if (strcmp(word, "into") == 0) {
+        // SELECT ... INTO new_table creates it; INSERT/MERGE INTO writes
+        bool creates = verb_is(s, "select") && s->depth == 0;
+        expect_name(s, creates ? SQL_ACCESS_DEFINE : SQL_ACCESS_WRITE, creates ? SQL_OBJECT_TABLE : SQL_OBJECT_RELATION);
+        return true;
+    }
+    if (strcmp(word, "execute") == 0) {
+        s->kind_pending = true;
+        s->kind_access = SQL_ACCESS_READ;
+        return true;
+    }
+    if (strcmp(word, "rename") == 0 && verb_is(s, "alter")) {
+        s->rename_pending = true;
+        return true;
+    }
+    if (strcmp(word, "to") == 0 && s->rename_pending) {
+        s->rename_pending = false;
+        expect_name(s, SQL_ACCESS_DEFINE, s->create_kind);
+        return true;
+    }
+    s->rename_pending = false;
+    return true;
+}
+
+static void handle_token(SqlScanner* s, SqlTokenType type, const char* text, size_t length, int line) {
+    if (type == SQL_TOKEN_IDENT || type == SQL_TOKEN_QUOTED) {
+        if (s->chain_active && s->chain_after_dot) {
+            s->chain_after_dot = false;
+            if (!text_append(&s->chain, text, length)) s->failed = true;
+            return;
+        }
+        finish_chain(s, false);
+
+        if (s->copy_from && type == SQL_TOKEN_IDENT && strcmp(text, "stdin") == 0) {
+            s->copy_stdin = true;
+        }
+        bool consumed = type == SQL_TOKEN_IDENT && handle_keyword(s, text);
+        s->token_index++;
+        s->prev_rparen = false;
+        if (consumed) {
+            return;
+        }
+
+        s->kind_pending = false;
+        s->chain.length = 0;
+        if (!text_append(&s->chain, text, length)) s->failed = true;
+        s->chain_active = true;
+        s->chain_after_dot = false;
+        s->chain_line = line;
+        return;
+    }
+
+    char c = type == SQL_TOKEN_SYMBOL ? text[0] : '\0';
+    if (c == '.' && s->chain_active && !s->chain_after_dot) {
+        s->chain_after_dot = true;
+        if (!text_append(&s->chain, ".", 1)) s->failed = true;
+        return;
+    }
+    finish_chain(s, c == '(');
+
+    if (c == ';' && s->depth <= 0) {
+        end_statement(s);
+        return;
+    }
+    bool after_rparen = s->prev_rparen;
+    s->token_index++;
+    s->prev_rparen = c == ')';
+
+    if (c == '(') {
+        s->depth++;
+        if (s->depth < SQL_MAX_PAREN_DEPTH) s->special_paren[s->depth] = s->special_next;
+        s->special_next = false;
+        s->cte_expect = false; // WITH (storage options)
+        // A name was expected but a subquery or column list follows
+        if (s->expect == EXPECT_NAME && s->expect_access != SQL_ACCESS_DEFINE) s->expect = EXPECT_NONE;
+    } else if (c == ')') {
+        if (s->depth < SQL_MAX_PAREN_DEPTH) s->special_paren[s->depth] = false;
+        if (s->depth > 0) s->depth--;
+        if (s->list_active && s->depth < s->list_depth) s->list_active = false;
+    } else if (c == ',') {
+        if (s->list_active && s->depth == s->list_depth) {
+            bool optional = s->expect_optional;
+            expect_name(s, s->list_access, s->list_kind);
+            s->expect_optional = optional; // DROP TABLE IF EXISTS a, b
+        } else if (s->depth == s->cte_depth && after_rparen) {
+            s->cte_expect = true;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Lexer
+// ---------------------------------------------------------------------------
+
+static void emit(SqlScanner* s, SqlTokenType type, const char* text, size_t length, int line) {
+    handle_token(s, type, text, length, line);
+}
+
+static bool is_ident_start(unsigned char c) {
+    return isalpha(c) || c == '_' || c >= 0x80;
+}
+
+static void start_token(SqlScanner* s, SqlLexState state) {
+    s->state = state;
+    s->token.length = 0;
+    s->token_line = s->line;
+}
+
+static void lex_byte(SqlScanner* s, unsigned char c) {
+    for (;;) {
+        switch (s->state) {
+            case LEX_NORMAL:
+                if (isspace(c)) return;
+                if (is_ident_start(c)) {
+                    start_token(s, LEX_IDENT);
+                    char lower = (char)tolower(c);
+                    if (!text_append(&s->token, &lower, 1)) s->failed = true;
+                } else if (c == '"' || c == '`') {
+                    start_token(s, LEX_QUOTED_IDENT);
+                    s->quote = (char)c;
+                } else if (c == '\'') {
+                    start_token(s, LEX_STRING);
+                    s->escapes = false;
+                } else if (isdigit(c)) {
+                    emit(s, SQL_TOKEN_OTHER, "0", 1, s->line);
+                    s->state = LEX_NUMBER;
+                } else if (c == '-') {
+                    s->state = LEX_DASH;
+                } else if (c == '/') {
+                    s->state = LEX_SLASH;
+                } else if (c == '$') {
+                    s->state = LEX_DOLLAR_TAG;
+                    s->tag_length = 0;
+                } else {
+                    char symbol = (char)c;
+                    emit(s, strchr("(),;.", symbol) ? SQL_TOKEN_SYMBOL : SQL_TOKEN_OTHER, &symbol, 1, s->line);
+                }
+                return;
+
+            case LEX_IDENT:
+                if (isalnum(c) || c == '_' || c == '$' || c >= 0x80) {
+                    char lower = (char)tolower(c);
+                    if (!text_append(&s->token, &lower, 1)) s->failed = true;
+                    return;
+                }
+                // E'...', B'...', X'...', N'...'
+                if (c == '\'' && s->token.length == 1) {
+                    s->escapes = s->token.data[0] == 'e';
+                    s->state = LEX_STRING;
+                    return;
+                }
+                s->state = LEX_NORMAL;
+                emit(s, SQL_TOKEN_IDENT, s->token.data, s->token.length, s->token_line);
+                continue;
+
+            case LEX_QUOTED_IDENT:
+                if (c == (unsigned char)s->quote) {
+                    s->state = LEX_QUOTED_IDENT_QUOTE;
+                } else if (!text_append(&s->token, (const char*)&c, 1)) {
+                    s->failed = true;
+                }
+                return;
+
+            case LEX_QUOTED_IDENT_QUOTE:
+                if (c == (unsigned char)s->quote) {
+                    s->state = LEX_QUOTED_IDENT;
+                    if (!text_append(&s->token, &s->quote, 1)) s->failed = true;
+                    return;
+                }
+                s->state = LEX_NORMAL;
+                emit(s, SQL_TOKEN_QUOTED, s->token.data ? s->token.data : "", s->token.length, s->token_line);
+                continue;
+
+            case LEX_STRING:
+                if (s->escapes && c == '\\') s->state = LEX_STRING_ESCAPE;
+                else if (c == '\'') s->state = LEX_STRING_QUOTE;
+                return;
+
+            case LEX_STRING_ESCAPE:
+                s->state = LEX_STRING;
+                return;
+
+            case LEX_STRING_QUOTE:
+                if (c == '\'') {
+                    s->state = LEX_STRING;
+                    return;
+                }
+                s->state = LEX_NORMAL;
+                emit(s, SQL_TOKEN_OTHER, "'", 1, s->token_line);
+                continue;
+
+            case LEX_NUMBER:
+                if (isalnum(c) || c == '.' || c == '_') return;
+                s->state = LEX_NORMAL;
+                continue;
+
+            case LEX_DASH:
+                if (c == '-') {
+                    s->state = LEX_LINE_COMMENT;
+                    return;
+                }
+                s->state = LEX_NORMAL;
+                emit(s, SQL_TOKEN_OTHER, "-", 1, s->line);
+                continue;
+
+            case LEX_LINE_COMMENT:
+                if (c == '\n') s->state = LEX_NORMAL;
+                return;
+
+            case LEX_SLASH:
+                if (c == '*') {
+                    s->state = LEX_BLOCK_COMMENT;
+                    s->block_depth = 1;
+                    s->block_prev = '\0';
+                    return;
+                }
+                s->state = LEX_NORMAL;
+                emit(s, SQL_TOKEN_OTHER, "/", 1, s->line);
+                continue;
+
+            case LEX_BLOCK_COMMENT:
+                // Block comments nest in standard SQL and PostgreSQL
+                if (s->block_prev == '*' && c == '/') {
+                    s->block_prev = '\0';
+                    if (--s->block_depth == 0) s->state = LEX_NORMAL;
+                } else if (s->block_prev == '/' && c == '*') {
+                    s->block_prev = '\0';
+                    s->block_depth++;
+                } else {
+                    s->block_prev = (char)c;
+                }
+                return;
+
+            case LEX_DOLLAR_TAG:
+                if (c == '$') {
+                    s->state = LEX_DOLLAR_BODY;
+                    s->tag_match = 0;
+                    return;
+                }
+                if ((is_ident_start(c) || (isdigit(c) && s->tag_length > 0)) && s->tag_length < SQL_MAX_DOLLAR_TAG) {
+                    s->tag[s->tag_length++] = (char)c;
+                    return;
+                }
+                // $1 parameter or a stray dollar
+                s->state = LEX_NORMAL;
+                emit(s, SQL_TOKEN_OTHER, "$", 1, s->line);
+                continue;
+
+            case LEX_DOLLAR_BODY: {
+                // Match the closing "$tag$"; the tag cannot contain '$', so a mismatch restarts at it
+                char expected = s->tag_match == 0 || s->tag_match > s->tag_length ? '$' : s->tag[s->tag_match - 1];
+                if (c == (unsigned char)expected) {
+                    if (++s->tag_match == s->tag_length + 2) {
+                        s->state = LEX_NORMAL;
+                        emit(s, SQL_TOKEN_OTHER, "$", 1, s->line);
+                    }
+                } else {
+                    s->tag_match = c == '$' ? 1 : 0;
+                }
+                return;
+            }
+
+            case LEX_COPY_DATA:
+                if (c == '\n') {
+                    if (s->copy_line == 2) s->state = LEX_NORMAL;
+                    s->copy_line = 0;
+                } else if (s->copy_line == 0 && c == '\\') {
+                    s->copy_line = 1;
+                } else if (s->copy_line == 1 && c == '.') {
+                    s->copy_line = 2;
+                } else if (!(s->copy_line == 2 && c == '\r')) {
+                    s->copy_line = -1;
+                }
+                return;
+        }
+        return;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Scanner
+// ---------------------------------------------------------------------------
+
+SqlScanner* sql_scanner_create(const char* filepath) {
+    if (!filepath) return NULL;
+
+    SqlScanner* s = calloc(1, sizeof(SqlScanner));
+    SqlMigration* m = calloc(1, sizeof(SqlMigration));
+    if (!s || !m) {
+        free(s);
+        free(m);
+        return NULL;
+    }
+    m->filepath = strdup(filepath);
+    m->version = sql_migration_version(filepath);
+    s->migration = m;
+    s->line = 1;
+    s->cte_depth = -1;
+    if (!m->filepath) {
+        sql_migration_destroy(m);
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+int sql_scanner_feed(SqlScanner* scanner, const char* data, size_t length) {
+    if (!scanner || (!data && length > 0)) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    for (size_t i = 0; i < length && !scanner->failed; i++) {
+        lex_byte(scanner, (unsigned char)data[i]);
+        if (data[i] == '\n') scanner->line++;
+    }
+    return scanner->failed ? DEPTRACK_ERROR_MEMORY : DEPTRACK_SUCCESS;
+}
+
+SqlMigration* sql_scanner_finish(SqlScanner* scanner) {
+    if (!scanner) return NULL;
+
+    // Flush a token cut off by the end of input, then the unterminated last statement
+    if (scanner->state == LEX_IDENT) {
+        scanner->state = LEX_NORMAL;
+        emit(scanner, SQL_TOKEN_IDENT, scanner->token.data, scanner->token.length, scanner->token_line);
+    } else if (scanner->state == LEX_QUOTED_IDENT_QUOTE) {
+        scanner->state = LEX_NORMAL;
+        emit(scanner, SQL_TOKEN_QUOTED, scanner->token.data ? scanner->token.data : "", scanner->token.length,
+             scanner->token_line);
+    }
+    finish_chain(scanner, false);
+    end_statement(scanner);
+
+    SqlMigration* m = scanner->migration;
+    if (scanner->failed) {
+        sql_migration_destroy(m);
+        m = NULL;
+    }
+    free(scanner->ctes);
+    free(scanner->token.data);
+    free(scanner->chain.data);
+    free(scanner);
+    return m;
+}
+
+SqlMigration* sql_scan_buffer(const char* filepath, const char* buffer, size_t length) {
+    SqlScanner* scanner = sql_scanner_create(filepath);
+    if (!scanner) return NULL;
+
+    sql_scanner_feed(scanner, buffer, length);
+    return sql_scanner_finish(scanner);
+}
+
+SqlMigration* sql_scan_file(const char* filepath) {
+    FILE* file = fopen(filepath, "rb");
+    if (!file) return NULL;
+
+    SqlScanner* scanner = sql_scanner_create(filepath);
+    char* chunk = malloc(SQL_CHUNK_SIZE);
+    if (!scanner || !chunk) {
+        free(chunk);
+        sql_migration_destroy(sql_scanner_finish(scanner));
+        fclose(file);
+        return NULL;
+    }
+
+    int result = DEPTRACK_SUCCESS;
+    size_t n;
+    while (result == DEPTRACK_SUCCESS && (n = fread(chunk, 1, SQL_CHUNK_SIZE, file)) > 0) {
+        result = sql_scanner_feed(scanner, chunk, n);
+    }
+    free(chunk);
+    fclose(file);
+    return sql_scanner_finish(scanner);
+}
+
+void sql_migration_destroy(SqlMigration* migration) {
+    if (!migration) return;
+
+    for (size_t i = 0; i < migration->object_count; i++) {
+        free(migration->objects[i].name);
+    }
+    free(migration->objects);
+    free(migration->filepath);
+    free(migration->version);
+    free(migration);
+}
+
+// ---------------------------------------------------------------------------
+// Versions
+// ---------------------------------------------------------------------------
+
+char* sql_migration_version(const char* filepath) {
+    const char* base = strrchr(filepath, '/');
+    base = base ? base + 1 : filepath;
+
+    // Flyway: V1_2__name.sql is version 1.2; R__name.sql is repeatable and unversioned
+    if ((base[0] == 'V' || base[0] == 'v') && isdigit((unsigned char)base[1])) {
+        const char* end = strstr(base, "__");
+        if (!end) end = base + strlen(base);
+        char* version = strndup(base + 1, (size_t)(end - base - 1));
+        for (char* p = version; p && *p; p++) {
+            if (*p == '_') *p = '.';
+        }
+        return version;
+    }
+
+    // 0001_init.sql, 20240101120000_add_users.up.sql
+    size_t digits = 0;
+    while (isdigit((unsigned char)base[digits])) digits++;
+    return digits > 0 ? strndup(base, digits) : NULL;
+}
+
+static int compare_versions(const char* a, const char* b) {
+    for (;;) {
+        char* a_end;
+        char* b_end;
+        unsigned long long x = strtoull(a, &a_end, 10);
+        unsigned long long y = strtoull(b, &b_end, 10);
+        if (x != y) return x < y ? -1 : 1;
+
+        bool a_more = *a_end == '.';
+        bool b_more = *b_end == '.';
+        if (!a_more || !b_more) {
+            if (a_more != b_more) return a_more ? 1 : -1; // 1 before 1.1
+            return strcmp(a_end, b_end);
+        }
+        a = a_end + 1;
+        b = b_end + 1;
+    }
+}
+
+int sql_migration_compare(const void* a, const void* b) {
+    const SqlMigration* x = *(const SqlMigration* const*)a;
+    const SqlMigration* y = *(const SqlMigration* const*)b;
+
+    // Versioned migrations first, repeatable ones after them
+    if (x->version && !y->version) return -1;
+    if (!x->version && y->version) return 1;
+    if (x->version) {
+        int order = compare_versions(x->version, y->version);
+        if (order != 0) return order;
+    }
+    return strcmp(x->filepath, y->filepath);
+}
+
+// ---------------------------------------------------------------------------
+// Migration sets
+// ---------------------------------------------------------------------------
+
+SqlMigrationSet* sql_migration_set_create(void) {
+    return calloc(1, sizeof(SqlMigrationSet));
+}
+
+int sql_migration_set_add(SqlMigrationSet* set, SqlMigration* migration) {
+    if (!set || !migration) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    if (set->migration_count >= set->migration_capacity) {
+        size_t capacity = set->migration_capacity ? set->migration_capacity * 2 : 16;
+        SqlMigration** grown = realloc(set->migrations, capacity * sizeof(SqlMigration*));
+        if (!grown) return DEPTRACK_ERROR_MEMORY;
+        set->migrations = grown;
+        set->migration_capacity = capacity;
+    }
+    set->migrations[set->migration_count++] = migration;
+    return DEPTRACK_SUCCESS;
+}
+
+static int sql_set_visit(const char* path, void* context) {
+    SqlMigrationSet* set = context;
+    if (!file_has_suffix(path, ".sql") || file_has_suffix(path, ".down.sql")) {
+        return DEPTRACK_SUCCESS;
+    }
+    // Flyway undo migrations (U1__x.sql) revert rather than apply
+    const char* base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    if (base[0] == 'U' && isdigit((unsigned char)base[1])) {
+        return DEPTRACK_SUCCESS;
+    }
+
+    SqlMigration* migration = sql_scan_file(path);
+    if (!migration) {
+        return DEPTRACK_SUCCESS; // Unreadable files simply drop out of the set
+    }
+
+    int result = sql_migration_set_add(set, migration);
+    if (result != DEPTRACK_SUCCESS) {
+        sql_migration_destroy(migration);
+    }
+    return result;
+}
+
+SqlMigrationSet* sql_migration_set_load(const char* root) {
+    SqlMigrationSet* set = sql_migration_set_create();
+    if (!set) return NULL;
+
+    if (file_walk(root, sql_set_visit, set) != DEPTRACK_SUCCESS) {
+        sql_migration_set_destroy(set);
+        return NULL;
+    }
+    if (set->migration_count > 1) {
+        qsort(set->migrations, set->migration_count, sizeof(SqlMigration*), sql_migration_compare);
+    }
+    return set;
+}
+
+void sql_migration_set_destroy(SqlMigrationSet* set) {
+    if (!set) return;
+
+    for (size_t i = 0; i < set->migration_count; i++) {
+        sql_migration_destroy(set->migrations[i]);
+    }
+    free(set->migrations);
+    free(set);
+}
+
+// Relations and functions live in separate namespaces
+static void object_key(const SqlObject* obj, char* key, size_t size) {
+    snprintf(key, size, "%c|%s", is_function_kind(obj->kind) ? 'f' : 'r', obj->name);
+}
+
+typedef struct {
+    HashMap* by_key;           // Object key -> index of its first definition
+    size_t* migration;
+    size_t* statement;
+    size_t count;
+} SqlDefinitions;
+
+static void definitions_free(SqlDefinitions* defs) {
+    hashmap_destroy(defs->by_key);
+    free(defs->migration);
+    free(defs->statement);
+}
+
+static int definitions_build(const SqlMigrationSet* set, SqlDefinitions* defs) {
+    memset(defs, 0, sizeof(SqlDefinitions));
+    size_t total = 0;
+    for (size_t m = 0; m < set->migration_count; m++) {
+        total += set->migrations[m]->object_count;
+    }
+
+    defs->by_key = hashmap_create(total > 64 ? total : 64);
+    defs->migration = malloc((total ? total : 1) * sizeof(size_t));
+    defs->statement = malloc((total ? total : 1) * sizeof(size_t));
+    if (!defs->by_key || !defs->migration || !defs->statement) {
+        definitions_free(defs);
+        return DEPTRACK_ERROR_MEMORY;
+    }
+
+    char key[MAX_PATH_LENGTH];
+    for (size_t m = 0; m < set->migration_count; m++) {
+        const SqlMigration* migration = set->migrations[m];
+        for (size_t i = 0; i < migration->object_count; i++) {
+            const SqlObject* obj = &migration->objects[i];
+            size_t existing;
+            if (obj->access != SQL_ACCESS_DEFINE) continue;
+            object_key(obj, key, sizeof(key));
+            if (hashmap_get(defs->by_key, key, &existing) == 0) continue;
+            if (hashmap_put(defs->by_key, key, defs->count) != 0) {
+                definitions_free(defs);
+                return DEPTRACK_ERROR_MEMORY;
+            }
+            defs->migration[defs->count] = m;
+            defs->statement[defs->count] = obj->statement;
+            defs->count++;
+        }
+    }
+    return DEPTRACK_SUCCESS;
+}
+
+int sql_migration_set_forward_references(const SqlMigrationSet* set, SqlForwardReference** out, size_t* count) {
+    if (!set || !out || !count) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+    *out = NULL;
+    *count = 0;
+
+    SqlDefinitions defs;
+    int result = definitions_build(set, &defs);
+    if (result != DEPTRACK_SUCCESS) return result;
+
+    size_t capacity = 0;
+    char key[MAX_PATH_LENGTH];
+    for (size_t m = 0; m < set->migration_count && result == DEPTRACK_SUCCESS; m++) {
+        const SqlMigration* migration = set->migrations[m];
+        for (size_t i = 0; i < migration->object_count; i++) {
+            const SqlObject* obj = &migration->objects[i];
+            size_t def;
+            // DROP ... IF EXISTS before the CREATE is the usual idempotent pattern
+            if (obj->access == SQL_ACCESS_DEFINE || obj->optional) continue;
+            object_key(obj, key, sizeof(key));
+            if (hashmap_get(defs.by_key, key, &def) != 0) continue;
+            bool later = defs.migration[def] > m || (defs.migration[def] == m && defs.statement[def] > obj->statement);
+            if (!later) continue;
+
+            if (*count >= capacity) {
+                capacity = capacity ? capacity * 2 : 8;
+                SqlForwardReference* grown = realloc(*out, capacity * sizeof(SqlForwardReference));
+                if (!grown) {
+                    result = DEPTRACK_ERROR_MEMORY;
+                    break;
+                }
+                *out = grown;
+            }
+            (*out)[*count] = (SqlForwardReference){ m, i, defs.migration[def] };
+            (*count)++;
+        }
+    }
+
+    definitions_free(&defs);
+    if (result != DEPTRACK_SUCCESS) {
+        free(*out);
+        *out = NULL;
+        *count = 0;
+    }
+    return result;
+}
+
+typedef struct {
+    size_t definer;            // First defining migration, SIZE_MAX for pre-existing objects
+    size_t last_writer;
+    size_t* readers;           // Readers since last_writer
+    size_t reader_count;
+    size_t reader_capacity;
+    size_t seen_in;            // Migration currently being folded in
+    bool write_in;
+    bool optional_in;
+} SqlAccessChain;
+
+typedef struct {
+    size_t* from;
+    size_t* to;
+    size_t count;
+    size_t capacity;
+} SqlEdges;
+
+static bool add_edge(SqlEdges* edges, size_t from, size_t to) {
+    if (from == to) return true;
+    if (edges->count >= edges->capacity) {
+        size_t capacity = edges->capacity ? edges->capacity * 2 : 64;
+        size_t* from_grown = realloc(edges->from, capacity * sizeof(size_t));
+        if (!from_grown) return false;
+        edges->from = from_grown;
+        size_t* to_grown = realloc(edges->to, capacity * sizeof(size_t));
+        if (!to_grown) return false;
+        edges->to = to_grown;
+        edges->capacity = capacity;
+    }
+    edges->from[edges->count] = from;
+    edges->to[edges->count] = to;
+    edges->count++;
+    return true;
+}
+
+// Per object, accesses are ordered as in the set: writes after every earlier access, reads after the
+// last write. An access before the object's first definition instead waits for that definition.
+static int sql_set_edges(const SqlMigrationSet* set, SqlEdges* edges) {
+    SqlDefinitions defs;
+    int result = definitions_build(set, &defs);
+    if (result != DEPTRACK_SUCCESS) return result;
+
+    HashMap* by_key = hashmap_create(defs.count > 64 ? defs.count * 2 : 128);
+    SqlAccessChain* chains = NULL;
+    size_t chain_count = 0;
+    size_t chain_capacity = 0;
+    size_t* touched = NULL;
+    size_t touched_capacity = 0;
+    if (!by_key) result = DEPTRACK_ERROR_MEMORY;
+
+    char key[MAX_PATH_LENGTH];
+    for (size_t m = 0; m < set->migration_count && result == DEPTRACK_SUCCESS; m++) {
+        const SqlMigration* migration = set->migrations[m];
+        size_t touched_count = 0;
+
+        for (size_t i = 0; i < migration->object_count && result == DEPTRACK_SUCCESS; i++) {
+            const SqlObject* obj = &migration->objects[i];
+            size_t def = SIZE_MAX;
+            object_key(obj, key, sizeof(key));
+            bool defined = hashmap_get(defs.by_key, key, &def) == 0;
+            if (obj->call && !defined) continue; // count(), now(), ...
+
+            size_t index;
+            if (hashmap_get(by_key, key, &index) != 0) {
+                if (chain_count >= chain_capacity) {
+                    size_t capacity = chain_capacity ? chain_capacity * 2 : 64;
+                    SqlAccessChain* grown = realloc(chains, capacity * sizeof(SqlAccessChain));
+                    if (!grown) {
+                        result = DEPTRACK_ERROR_MEMORY;
+                        break;
+                    }
+                    chains = grown;
+                    chain_capacity = capacity;
+                }
+                index = chain_count++;
+                chains[index] = (SqlAccessChain){ defined ? defs.migration[def] : SIZE_MAX, SIZE_MAX, NULL, 0, 0,
+                                                  SIZE_MAX, false, true };
+                if (hashmap_put(by_key, key, index) != 0) {
+                    result = DEPTRACK_ERROR_MEMORY;
+                    break;
+                }
+            }
+
+            SqlAccessChain* chain = &chains[index];
+            if (chain->seen_in != m) {
+                if (touched_count >= touched_capacity) {
+                    size_t capacity = touched_capacity ? touched_capacity * 2 : 64;
+                    size_t* grown = realloc(touched, capacity * sizeof(size_t));
+                    if (!grown) {
+                        result = DEPTRACK_ERROR_MEMORY;
+                        break;
+                    }
+                    touched = grown;
+                    touched_capacity = capacity;
+                }
+                touched[touched_count++] = index;
+                chain->seen_in = m;
+                chain->write_in = false;
+                chain->optional_in = true;
+            }
+            chain->write_in = chain->write_in || obj->access != SQL_ACCESS_READ;
+            chain->optional_in = chain->optional_in && obj->optional;
+        }
+
+        for (size_t t = 0; t < touched_count && result == DEPTRACK_SUCCESS; t++) {
+            SqlAccessChain* chain = &chains[touched[t]];
+            bool ok = true;
+            if (chain->definer != SIZE_MAX && m < chain->definer && !chain->optional_in) {
+                ok = add_edge(edges, chain->definer, m);
+            } else if (chain->write_in) {
+                if (chain->last_writer != SIZE_MAX) ok = add_edge(edges, chain->last_writer, m);
+                for (size_t r = 0; ok && r < chain->reader_count; r++) {
+                    ok = add_edge(edges, chain->readers[r], m);
+                }
+                chain->reader_count = 0;
+                chain->last_writer = m;
+            } else {
+                if (chain->last_writer != SIZE_MAX) ok = add_edge(edges, chain->last_writer, m);
+                if (ok && chain->reader_count >= chain->reader_capacity) {
+                    size_t capacity = chain->reader_capacity ? chain->reader_capacity * 2 : 4;
+                    size_t* grown = realloc(chain->readers, capacity * sizeof(size_t));
+                    ok = grown != NULL;
+                    if (grown) {
+                        chain->readers = grown;
+                        chain->reader_capacity = capacity;
+                    }
+                }
+                if (ok) chain->readers[chain->reader_count++] = m;
+            }
+            if (!ok) result = DEPTRACK_ERROR_MEMORY;
+        }
+    }
+
+    for (size_t i = 0; i < chain_count; i++) {
+        free(chains[i].readers);
+    }
+    free(chains);
+    free(touched);
+    hashmap_destroy(by_key);
+    definitions_free(&defs);
+    return result;
+}
+
+int sql_migration_set_order(const SqlMigrationSet* set, DagSchedule* schedule) {
+    if (!set || !schedule) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    SqlEdges edges = { NULL, NULL, 0, 0 };
+    int result = sql_set_edges(set, &edges);
+    double* costs = malloc((set->migration_count ? set->migration_count : 1) * sizeof(double));
+    if (result == DEPTRACK_SUCCESS && !costs) {
+        result = DEPTRACK_ERROR_MEMORY;
+    }
+
+    if (result == DEPTRACK_SUCCESS) {
+        // Statement count stands in for apply time on the critical path
+        for (size_t m = 0; m < set->migration_count; m++) {
+            size_t statements = set->migrations[m]->statement_count;
+            costs[m] = statements ? (double)statements : 1.0;
+        }
+        result = dag_schedule_compute(set->migration_count, edges.from, edges.to, edges.count, costs, schedule);
+    }
+
+    free(costs);
+    free(edges.from);
+    free(edges.to);
+    return result;
+}
+
+static ParsedFile* parse_sql_migration(const char* filepath, SqlMigration* migration) {
+    if (!migration) return NULL;
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_SQL);
+    HashMap* seen = hashmap_create(64);
+    if (!parsed || !seen) {
+        parsed_file_destroy(parsed);
+        hashmap_destroy(seen);
+        sql_migration_destroy(migration);
+        return NULL;
+    }
+
+    // Objects the file defines itself are not dependencies
+    char key[MAX_PATH_LENGTH];
+    for (size_t i = 0; i < migration->object_count; i++) {
+        if (migration->objects[i].access == SQL_ACCESS_DEFINE) {
+            object_key(&migration->objects[i], key, sizeof(key));
+            hashmap_put(seen, key, i);
+        }
+    }
+    for (size_t i = 0; i < migration->object_count; i++) {
+        const SqlObject* obj = &migration->objects[i];
+        size_t index;
+        if (obj->access == SQL_ACCESS_DEFINE || obj->call) continue;
+        object_key(obj, key, sizeof(key));
+        if (hashmap_get(seen, key, &index) == 0) continue;
+        hashmap_put(seen, key, i);
+        parsed_file_add_dependency(parsed, obj->name, strlen(obj->name), NULL, DEP_INTERNAL, obj->line_number);
+    }
+
+    hashmap_destroy(seen);
+    sql_migration_destroy(migration);
+    return parsed;
+}
+
+ParsedFile* parse_sql_file(const char* filepath) {
+    return parse_sql_migration(filepath, sql_scan_file(filepath));
+}
+
+ParsedFile* parse_sql_buffer(const char* filepath, const char* buffer, size_t length) {
+    return parse_sql_migration(filepath, sql_scan_buffer(filepath, buffer, length));
+}
@@ -0,0 +1,460 @@
+/**
+ * @file toml_parser.c
+ * @brief Streaming TOML reader
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Shared TOML front end for version catalogs, pyproject.toml and Cargo manifests
+ * @llm-key Single pass over the file buffer; every scalar is reported to a visitor together with
+ *          its full key path, so arrays and inline tables are flattened and nothing is built
+ * @llm-contract Event pointers are only valid inside the visitor call; strings arrive decoded,
+ *               other scalars as their source text
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <string.h>
+
+#define TOML_PATH_BUFFER 1024
+
+typedef struct {
+    const char* cur;
+    const char* end;
+    int line;
+    TomlValue event;                 // Path stack lives in the event so visitors see it directly
+    char path_buffer[TOML_PATH_BUFFER];
+    size_t path_used;
+    size_t header_depth;
+    char* scratch;
+    size_t scratch_length;
+    size_t scratch_capacity;
+    TomlVisitFunction visit;
+    void* context;
+    int status;
+} TomlReader;
+
+static bool toml_fail(TomlReader* r) {
+    if (r->status == DEPTRACK_SUCCESS) {
+        r->status = DEPTRACK_ERROR_PARSE_FAILED;
+    }
+    return false;
+}
+
+static bool scratch_append(TomlReader* r, const char* data, size_t length) {
+    if (r->scratch_length + length + 1 > r->scratch_capacity) {
+        size_t capacity = r->scratch_capacity ? r->scratch_capacity : 256;
+        while (r->scratch_length + length + 1 > capacity) capacity *= 2;
+        char* grown = realloc(r->scratch, capacity);
+        if (!grown) {
+            r->status = DEPTRACK_ERROR_MEMORY;
+            return false;
+        }
+        r->scratch = grown;
+        r->scratch_capacity = capacity;
+    }
+    memcpy(r->scratch + r->scratch_length, data, length);
+    r->scratch_length += length;
+    r->scratch[r->scratch_length] = '\0';
+    return true;
+}
+
+static bool scratch_append_codepoint(TomlReader* r, unsigned long cp) {
+    char utf8[4];
+    size_t n;
+    if (cp < 0x80) {
+        utf8[0] = (char)cp; n = 1;
+    } else if (cp < 0x800) {
+        utf8[0] = (char)(0xC0 | (cp >> 6));
+        utf8[1] = (char)(0x80 | (cp & 0x3F)); n = 2;
+    } else if (cp < 0x10000) {
+        utf8[0] = (char)(0xE0 | (cp >> 12));
+        utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[2] = (char)(0x80 | (cp & 0x3F)); n = 3;
+    } else if (cp < 0x110000) {
+        utf8[0] = (char)(0xF0 | (cp >> 18));
+        utf8[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        utf8[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[3] = (char)(0x80 | (cp & 0x3F)); n = 4;
+    } else {
+        return toml_fail(r);
+    }
+    return scratch_append(r, utf8, n);
+}
+
+static void skip_ws(TomlReader* r) {
+    while (r->cur < r->end && (*r->cur == ' ' || *r->cur == '\t')) r->cur++;
+}
+
+static void skip_to_eol(TomlReader* r) {
+    while (r->cur < r->end && *r->cur != '\n') r->cur++;
+}
+
+// Whitespace, newlines and comments, as allowed between array elements
+static void skip_blank(TomlReader* r) {
+    while (r->cur < r->end) {
+        char c = *r->cur;
+        if (c == ' ' || c == '\t' || c == '\r') {
+            r->cur++;
+        } else if (c == '\n') {
+            r->line++;
+            r->cur++;
+        } else if (c == '#') {
+            skip_to_eol(r);
+        } else {
+            break;
+        }
+    }
+}
+
+static bool at(const TomlReader* r, const char* text) {
+    size_t n = strlen(text);
+    return (size_t)(r->end - r->cur) >= n && memcmp(r->cur, text, n) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Key path stack
+// ---------------------------------------------------------------------------
+
+static bool push_component(TomlReader* r, const char* text, size_t length) {
+    if (r->event.depth >= TOML_MAX_DEPTH || r->path_used + length > TOML_PATH_BUFFER) {
+        return toml_fail(r);
+    }
+    char* slot = r->path_buffer + r->path_used;
+    memcpy(slot, text, length);
+    r->event.path[r->event.depth] = slot;
+    r->event.path_lengths[r->event.depth] = length;
+    r->event.depth++;
+    r->path_used += length;
+    return true;
+}
+
+static void pop_to(TomlReader* r, size_t depth) {
+    if (depth < r->event.depth) {
+        r->path_used = (size_t)(r->event.path[depth] - r->path_buffer);
+        r->event.depth = depth;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Strings
+// ---------------------------------------------------------------------------
+
+static bool decode_escape(TomlReader* r) {
+    r->cur++; // backslash
+    if (r->cur >= r->end) return toml_fail(r);
+
+    char c = *r->cur++;
+    switch (c) {
+        case 'b': return scratch_append(r, "\b", 1);
+        case 't': return scratch_append(r, "\t", 1);
+        case 'n': return scratch_append(r, "\n", 1);
+        case 'f': return scratch_append(r, "\f", 1);
+        case 'r': return scratch_append(r, "\r", 1);
+        case 'e': return scratch_append(r, "\x1b", 1);
+        case '"': return scratch_append(r, "\"", 1);
+        case '\\': return scratch_append(r, "\\", 1);
+        case 'u':
+        case 'U': {
+            size_t digits = c == 'u' ? 4 : 8;
+            if ((size_t)(r->end - r->cur) < digits) return toml_fail(r);
+            unsigned long cp = 0;
+            for (size_t i = 0; i < digits; i++) {
+                char h = r->cur[i];
+                if (!isxdigit((unsigned char)h)) return toml_fail(r);
+                cp = cp * 16 + (unsigned long)(isdigit((unsigned char)h) ? h - '0' : (tolower((unsigned char)h) - 'a' + 10));
+            }
+            r->cur += digits;
+            return scratch_append_codepoint(r, cp);
+        }
+        default:
+            return toml_fail(r);
+    }
+}
+
+// Decodes the string at r->cur into scratch; the cursor ends after the closing quote
+static bool decode_string(TomlReader* r, bool allow_multiline) {
+    r->scratch_length = 0;
+    if (!scratch_append(r, "", 0)) return false;
+
+    char quote = *r->cur;
+    bool multiline = allow_multiline && (quote == '"' ? at(r, "\"\"\"") : at(r, "'''"));
+    bool literal = quote == '\'';
+
+    if (!multiline) {
+        r->cur++;
+        const char* run = r->cur;
+        while (r->cur < r->end && *r->cur != quote) {
+            if (*r->cur == '\n') return toml_fail(r);
+            if (!literal && *r->cur == '\\') {
+                if (!scratch_append(r, run, (size_t)(r->cur - run)) || !decode_escape(r)) return false;
+                run = r->cur;
+                continue;
+            }
+            r->cur++;
+        }
+        if (r->cur >= r->end) return toml_fail(r);
+        if (!scratch_append(r, run, (size_t)(r->cur - run))) return false;
+        r->cur++;
+        return true;
+    }
+
+    r->cur += 3;
+    // A newline right after the opening delimiter is trimmed
+    if (at(r, "\r\n") || at(r, "\n")) {
+        r->cur += *r->cur == '\r' ? 2 : 1;
+        r->line++;
+    }
+
+    const char* run = r->cur;
+    const char delimiter[4] = { quote, quote, quote, '\0' };
+    while (r->cur < r->end) {
+        char c = *r->cur;
+        if (c == quote && at(r, delimiter)) {
+            // Up to two quotes may sit directly before the closing delimiter
+            size_t extra = 0;
+            while (extra < 2 && r->cur + 3 + extra < r->end && r->cur[3 + extra] == quote) extra++;
+            if (!scratch_append(r, run, (size_t)(r->cur - run) + extra)) return false;
+            r->cur += 3 + extra;
+            return true;
+        }
+        if (c == '\n') {
+            r->line++;
+            r->cur++;
+        } else if (!literal && c == '\\') {
+            if (!scratch_append(r, run, (size_t)(r->cur - run))) return false;
+            const char* probe = r->cur + 1;
+            while (probe < r->end && (*probe == ' ' || *probe == '\t' || *probe == '\r')) probe++;
+            if (probe < r->end && *probe == '\n') {
+                // Line-ending backslash: drop it and all following whitespace
+                r->cur = probe;
+                while (r->cur < r->end && isspace((unsigned char)*r->cur)) {
+                    if (*r->cur == '\n') r->line++;
+                    r->cur++;
+                }
+            } else if (!decode_escape(r)) {
+                return false;
+            }
+            run = r->cur;
+        } else {
+            r->cur++;
+        }
+    }
+    return toml_fail(r);
+}
+
+// ---------------------------------------------------------------------------
+// Keys and values
+// ---------------------------------------------------------------------------
+
+static bool is_bare_key_char(char c) {
+    return isalnum((unsigned char)c) || c == '_' || c == '-';
+}
+
+// Pushes the components of a dotted key onto the path stack
+static bool parse_key(TomlReader* r) {
+    for (;;) {
+        skip_ws(r);
+        if (r->cur >= r->end) return toml_fail(r);
+
+        if (*r->cur == '"' || *r->cur == '\'') {
+            if (!decode_string(r, false) || !push_component(r, r->scratch, r->scratch_length)) return false;
+        } else {
+            const char* start = r->cur;
+            while (r->cur < r->end && is_bare_key_char(*r->cur)) r->cur++;
+            if (r->cur == start || !push_component(r, start, (size_t)(r->cur - start))) {
+                return toml_fail(r);
+            }
+        }
+
+        skip_ws(r);
+        if (r->cur < r->end && *r->cur == '.') {
+            r->cur++;
+            continue;
+        }
+        return true;
+    }
+}
+
+static bool emit(TomlReader* r, TomlValueType type, const char* value, size_t length, int line) {
+    r->event.type = type;
+    r->event.value = value;
+    r->event.value_length = length;
+    r->event.line_number = line;
+    int result = r->visit(&r->event, r->context);
+    if (result != DEPTRACK_SUCCESS) {
+        r->status = result;
+        return false;
+    }
+    return true;
+}
+
+static TomlValueType classify_literal(const char* s, size_t n) {
+    if ((n == 4 && memcmp(s, "true", 4) == 0) || (n == 5 && memcmp(s, "false", 5) == 0)) {
+        return TOML_BOOLEAN;
+    }
+    if ((n >= 10 && s[4] == '-' && isdigit((unsigned char)s[0])) || (n >= 5 && s[2] == ':')) {
+        return TOML_DATETIME;
+    }
+    if (n > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'o' || s[1] == 'b')) {
+        return TOML_INTEGER;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (s[i] == '.' || s[i] == 'e' || s[i] == 'E' || s[i] == 'i' || s[i] == 'n') {
+            return TOML_FLOAT; // Covers exponents as well as inf and nan
+        }
+    }
+    return TOML_INTEGER;
+}
+
+static bool parse_value(TomlReader* r);
+
+static bool parse_array(TomlReader* r) {
+    r->cur++; // '['
+    size_t saved_index = r->event.array_index;
+    size_t index = 0;
+
+    for (;;) {
+        skip_blank(r);
+        if (r->cur >= r->end) return toml_fail(r);
+        if (*r->cur == ']') break;
+
+        r->event.array_index = index++;
+        if (!parse_value(r)) return false;
+
+        skip_blank(r);
+        if (r->cur < r->end && *r->cur == ',') {
+            r->cur++;
+        } else if (r->cur >= r->end || *r->cur != ']') {
+            return toml_fail(r);
+        }
+    }
+
+    r->cur++; // ']'
+    r->event.array_index = saved_index;
+    return true;
+}
+
+static bool parse_inline_table(TomlReader* r) {
+    r->cur++; // '{'
+    size_t base = r->event.depth;
+
+    for (;;) {
+        // Newlines inside inline tables are tolerated, as TOML 1.1 allows
+        skip_blank(r);
+        if (r->cur >= r->end) return toml_fail(r);
+        if (*r->cur == '}') break;
+
+        if (!parse_key(r)) return false;
+        if (r->cur >= r->end || *r->cur != '=') return toml_fail(r);
+        r->cur++;
+        skip_ws(r);
+        if (!parse_value(r)) return false;
+        pop_to(r, base);
+
+        skip_blank(r);
+        if (r->cur < r->end && *r->cur == ',') {
+            r->cur++;
+        } else if (r->cur >= r->end || *r->cur != '}') {
+            return toml_fail(r);
+        }
+    }
+
+    r->cur++; // '}'
+    return true;
+}
+
+static bool parse_value(TomlReader* r) {
+    if (r->cur >= r->end) return toml_fail(r);
+
+    int line = r->line;
+    char c = *r->cur;
+    if (c == '"' || c == '\'') {
+        return decode_string(r, true) && emit(r, TOML_STRING, r->scratch, r->scratch_length, line);
+    }
+    if (c == '[') return parse_array(r);
+    if (c == '{') return parse_inline_table(r);
+
+    const char* start = r->cur;
+    while (r->cur < r->end && !strchr(" \t\r\n,]}#", *r->cur)) r->cur++;
+    // Local date-times may use a space instead of 'T'
+    if (r->cur - start == 10 && start[4] == '-' && r->end - r->cur > 3 && r->cur[0] == ' ' &&
+        isdigit((unsigned char)r->cur[1]) && isdigit((unsigned char)r->cur[2]) && r->cur[3] == ':') {
+        r->cur++;
+        while (r->cur < r->end && !strchr(" \t\r\n,]}#", *r->cur)) r->cur++;
+    }
+
+    size_t length = (size_t)(r->cur - start);
+    if (length == 0) return toml_fail(r);
+    return emit(r, classify_literal(start, length), start, length, line);
+}
+
+static bool finish_line(TomlReader* r) {
+    skip_ws(r);
+    if (r->cur < r->end && *r->cur == '#') skip_to_eol(r);
+    if (r->cur < r->end && *r->cur == '\r') r->cur++;
+    if (r->cur < r->end && *r->cur != '\n') return toml_fail(r);
+    return true;
+}
+
+int toml_parse_buffer(const char* buffer, size_t length, TomlVisitFunction visit, void* context) {
+    if (!buffer || !visit) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    TomlReader* r = calloc(1, sizeof(TomlReader));
+    if (!r) return DEPTRACK_ERROR_MEMORY;
+
+    r->cur = buffer;
+    r->end = buffer + length;
+    r->line = 1;
+    r->visit = visit;
+    r->context = context;
+    r->event.array_index = SIZE_MAX;
+
+    // Skip a UTF-8 byte order mark
+    if (length >= 3 && memcmp(buffer, "\xEF\xBB\xBF", 3) == 0) r->cur += 3;
+
+    while (r->status == DEPTRACK_SUCCESS) {
+        skip_blank(r);
+        if (r->cur >= r->end) break;
+
+        if (*r->cur == '[') {
+            bool array_table = at(r, "[[");
+            r->cur += array_table ? 2 : 1;
+            pop_to(r, 0);
+            if (!parse_key(r)) break;
+            if (!at(r, array_table ? "]]" : "]")) {
+                toml_fail(r);
+                break;
+            }
+            r->cur += array_table ? 2 : 1;
+            r->header_depth = r->event.depth;
+            r->event.table_index++;
+        } else {
+            if (!parse_key(r)) break;
+            if (r->cur >= r->end || *r->cur != '=') {
+                toml_fail(r);
+                break;
+            }
+            r->cur++;
+            skip_ws(r);
+            if (!parse_value(r)) break;
+            pop_to(r, r->header_depth);
+        }
+
+        finish_line(r);
+    }
+
+    int status = r->status;
+    free(r->scratch);
+    free(r);
+    return status;
+}
+
+bool toml_key_is(const TomlValue* value, size_t index, const char* key) {
+    if (!value || !key || index >= value->depth) {
+        return false;
+    }
+    size_t length = strlen(key);
+    return value->path_lengths[index] == length && memcmp(value->path[index], key, length) == 0;
+}
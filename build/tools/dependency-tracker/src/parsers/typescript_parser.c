@@ -1 +1,260 @@
-// Stub implementation for typescript_parser
+/**
+ * @file typescript_parser.c
+ * @brief TypeScript/JavaScript module import scanner
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Finds the modules a TS/JS file loads: static and dynamic import, export ... from and require()
+ * @llm-key The keyword matcher locates every import/export/require in one pass and the syntax mask
+ *          drops those inside strings and comments; only the remaining spots are examined
+ * @llm-contract Relative specifiers are DEP_INTERNAL as written; bare ones are DEP_EXTERNAL reduced to
+ *               the package name ("@scope/pkg/sub" -> "@scope/pkg")
+ * @llm-map package.json manifests go through json_parse_buffer instead: each entry of the dependency
+ *          sections is a dependency named by its key, with the range as its version
+ */
+
+#include "dependency_tracker.h"
+#include <ctype.h>
+#include <string.h>
+
+// Statements longer than this are not import clauses
+#define TS_MAX_CLAUSE_LENGTH 4096
+
+enum {
+    TS_KEYWORD_IMPORT,
+    TS_KEYWORD_EXPORT,
+    TS_KEYWORD_REQUIRE
+};
+
+static const char* const typescript_keywords[] = { "import", "export", "require" };
+static char* typescript_extensions[] = { "ts", "tsx", "js", "jsx", "mjs", "cjs" };
+
+typedef struct {
+    const char* buffer;
+    size_t length;
+    ParsedFile* parsed;
+    SyntaxMask mask;           // Strings and comments; keywords inside them are not statements
+    bool failed;
+} TsScan;
+
+static size_t skip_space(const TsScan* scan, size_t i) {
+    while (i < scan->length && isspace((unsigned char)scan->buffer[i])) i++;
+    return i;
+}
+
+// Adds the string literal starting at i, if it is one without interpolation
+static void add_specifier(TsScan* scan, size_t i, size_t keyword_offset) {
+    char quote = scan->buffer[i];
+    if (quote != '\'' && quote != '"' && quote != '`') return;
+    const char* start = scan->buffer + i + 1;
+    const char* end = start;
+    while (end < scan->buffer + scan->length && *end != quote && *end != '\n') {
+        if (*end == '\\' || (quote == '`' && *end == '$')) return;
+        end++;
+    }
+    if (end >= scan->buffer + scan->length || *end != quote || end == start) return;
+
+    size_t length = (size_t)(end - start);
+    DependencyType type = DEP_INTERNAL;
+    if (*start != '.' && *start != '/') {
+        // Bare specifier: keep the package, drop the subpath
+        type = DEP_EXTERNAL;
+        const char* slash = memchr(start, '/', length);
+        if (slash && *start == '@') slash = memchr(slash + 1, '/', (size_t)(end - slash - 1));
+        if (slash) length = (size_t)(slash - start);
+    }
+    if (!parsed_file_add_dependency_at(scan->parsed, start, length, NULL, type, keyword_offset)) {
+        scan->failed = true;
+    }
+}
+
+static bool word_before(const TsScan* scan, size_t i, const char* word) {
+    size_t length = strlen(word);
+    while (i > 0 && isspace((unsigned char)scan->buffer[i - 1])) i--;
+    return i >= length && memcmp(scan->buffer + i - length, word, length) == 0 &&
+           (i == length || !(isalnum((unsigned char)scan->buffer[i - length - 1]) || scan->buffer[i - length - 1] == '_'));
+}
+
+// import x from 'm', import {a,\n b} from "m", export * from 'm': the first string after "from"
+static void scan_clause(TsScan* scan, size_t i, size_t keyword_offset, bool is_export) {
+    size_t limit = i + TS_MAX_CLAUSE_LENGTH < scan->length ? i + TS_MAX_CLAUSE_LENGTH : scan->length;
+    int depth = 0;
+    for (; i < limit; i++) {
+        char c = scan->buffer[i];
+        if (syntax_mask_test(&scan->mask, i)) {
+            // Only the opening quote of a masked run matters; comments and string bodies are skipped
+            bool opens = i == 0 || !syntax_mask_test(&scan->mask, i - 1);
+            if (!opens || (c != '\'' && c != '"' && c != '`')) continue;
+        }
+        if (c == '{') {
+            depth++;
+        } else if (c == '}') {
+            depth--;
+        } else if (c == '\'' || c == '"' || c == '`') {
+            if (word_before(scan, i, "from")) add_specifier(scan, i, keyword_offset);
+            return;
+        } else if (depth == 0 && (c == ';' || c == '=' || c == '(')) {
+            return;
+        } else if (is_export && depth == 0 && c == '\n' && !word_before(scan, i, "from") &&
+                   !word_before(scan, i, ",")) {
+            // export const/function/class declarations end the search at the line
+            return;
+        }
+    }
+}
+
+static int visit_keyword(const KeywordMatch* match, void* context) {
+    TsScan* scan = context;
+    size_t i = skip_space(scan, match->offset + match->length);
+    if (i >= scan->length) return DEPTRACK_SUCCESS;
+
+    // obj.import, obj.require are properties, not module loads
+    if (match->offset > 0 && scan->buffer[match->offset - 1] == '.') return DEPTRACK_SUCCESS;
+    if (syntax_mask_test(&scan->mask, match->offset)) return DEPTRACK_SUCCESS;
+
+    char c = scan->buffer[i];
+    switch (match->keyword) {
+        case TS_KEYWORD_IMPORT:
+            if (c == '(') {
+                add_specifier(scan, skip_space(scan, i + 1), match->offset);
+            } else if (c == '\'' || c == '"') {
+                add_specifier(scan, i, match->offset);
+            } else if (c != '.') {
+                scan_clause(scan, i, match->offset, false);
+            }
+            break;
+        case TS_KEYWORD_EXPORT:
+            scan_clause(scan, i, match->offset, true);
+            break;
+        case TS_KEYWORD_REQUIRE:
+            if (c == '(') add_specifier(scan, skip_space(scan, i + 1), match->offset);
+            break;
+        default:
+            break;
+    }
+    return scan->failed ? DEPTRACK_ERROR_MEMORY : DEPTRACK_SUCCESS;
+}
+
+static KeywordMatcher* typescript_matcher_create(void) {
+    return keyword_matcher_create(typescript_keywords, sizeof(typescript_keywords) / sizeof(typescript_keywords[0]),
+                                  KEYWORD_MATCH_WHOLE_WORD);
+}
+
+ParsedFile* typescript_parse_buffer(const char* filepath, const char* buffer, size_t length,
+                                    const KeywordMatcher* matcher) {
+    if (!buffer) {
+        return NULL;
+    }
+
+    KeywordMatcher* owned = NULL;
+    if (!matcher) {
+        matcher = owned = typescript_matcher_create();
+        if (!owned) return NULL;
+    }
+
+    TsScan scan = { buffer, length, parsed_file_create(filepath, LANG_TYPESCRIPT), { NULL, 0, 0 }, false };
+    int result = syntax_mask_build(buffer, length, syntax_rules_for_language(LANG_TYPESCRIPT), SIMD_ISA_AVX2,
+                                   &scan.mask);
+    if (result == DEPTRACK_SUCCESS && scan.parsed) {
+        result = keyword_matcher_scan(matcher, buffer, length, visit_keyword, &scan);
+    }
+    if (result == DEPTRACK_SUCCESS && scan.parsed) {
+        result = parsed_file_resolve_lines(scan.parsed, buffer, length);
+    }
+    if (result != DEPTRACK_SUCCESS) {
+        parsed_file_destroy(scan.parsed);
+        scan.parsed = NULL;
+    }
+    syntax_mask_destroy(&scan.mask);
+    keyword_matcher_destroy(owned);
+    return scan.parsed;
+}
+
+// ---------------------------------------------------------------------------
+// package.json
+// ---------------------------------------------------------------------------
+
+static const char* const package_sections[] = {
+    "dependencies", "devDependencies", "peerDependencies", "optionalDependencies"
+};
+
+// Versions that point into the same repository rather than at the registry
+static const char* const package_local_protocols[] = { "file:", "link:", "workspace:" };
+
+bool typescript_is_manifest(const char* filepath) {
+    if (!filepath) return false;
+
+    const char* slash = strrchr(filepath, '/');
+    return strcmp(slash ? slash + 1 : filepath, "package.json") == 0;
+}
+
+static int visit_package_entry(const JsonValue* value, void* context) {
+    if (value->depth != 2 || !value->key || !value->string) return DEPTRACK_SUCCESS;
+
+    bool in_section = false;
+    for (size_t i = 0; i < sizeof(package_sections) / sizeof(package_sections[0]) && !in_section; i++) {
+        size_t length = strlen(package_sections[i]);
+        in_section = strncmp(value->path, package_sections[i], length) == 0 && value->path[length] == '.';
+    }
+    if (!in_section) return DEPTRACK_SUCCESS;
+
+    DependencyType type = DEP_EXTERNAL;
+    for (size_t i = 0; i < sizeof(package_local_protocols) / sizeof(package_local_protocols[0]); i++) {
+        if (strncmp(value->value, package_local_protocols[i], strlen(package_local_protocols[i])) == 0) {
+            type = DEP_INTERNAL;
+        }
+    }
+    return parsed_file_add_dependency_at(context, value->key, strlen(value->key), value->value, type,
+                                         value->offset)
+               ? DEPTRACK_SUCCESS
+               : DEPTRACK_ERROR_MEMORY;
+}
+
+ParsedFile* parse_package_json_buffer(const char* filepath, const char* buffer, size_t length) {
+    if (!buffer) {
+        return NULL;
+    }
+
+    ParsedFile* parsed = parsed_file_create(filepath, LANG_TYPESCRIPT);
+    if (!parsed) {
+        return NULL;
+    }
+    int result = json_parse_buffer(buffer, length, visit_package_entry, parsed);
+    if (result == DEPTRACK_SUCCESS) {
+        result = parsed_file_resolve_lines(parsed, buffer, length);
+    }
+    if (result != DEPTRACK_SUCCESS) {
+        parsed_file_destroy(parsed);
+        return NULL;
+    }
+    return parsed;
+}
+
+ParsedFile* parse_typescript_file(const char* filepath) {
+    size_t length;
+    char* buffer = parser_read_file(filepath, &length);
+    if (!buffer) {
+        return NULL;
+    }
+
+    ParsedFile* parsed = typescript_is_manifest(filepath) ? parse_package_json_buffer(filepath, buffer, length)
+                                                          : typescript_parse_buffer(filepath, buffer, length, NULL);
+    free(buffer);
+    return parsed;
+}
+
+LanguageParser* typescript_parser_create(void) {
+    LanguageParser* parser = calloc(1, sizeof(LanguageParser));
+    if (!parser) {
+        return NULL;
+    }
+
+    parser->language = LANG_TYPESCRIPT;
+    parser->name = "TypeScript";
+    parser->file_extensions = typescript_extensions;
+    parser->extension_count = sizeof(typescript_extensions) / sizeof(typescript_extensions[0]);
+    parser->parse_file = parse_typescript_file;
+    parser->keywords = typescript_keywords;
+    parser->keyword_count = sizeof(typescript_keywords) / sizeof(typescript_keywords[0]);
+    return parser;
+}
@@ -0,0 +1,398 @@
+/**
+ * @file version_catalog.c
+ * @brief Gradle version catalog (libs.versions.toml) index
+ * @author Unhinged Development Team
+ *
+ * @llm-type parser
+ * @llm-legend Resolves libs.x.y accessors in build scripts to group:artifact:version coordinates
+ * @llm-key Catalogs are read once per root into a hash index keyed by the accessor text exactly as
+ *          build scripts spell it, so resolving a dependency is one lookup on its name
+ * @llm-contract Alias separators (-, _, .) all map to '.', as Gradle's generated accessors do;
+ *               version.ref and bundle members are resolved after the whole file is read
+ */
+
+#include "dependency_tracker.h"
+#include <dirent.h>
+#include <string.h>
+
+#define CATALOG_SUFFIX ".versions.toml"
+
+typedef enum {
+    PENDING_VERSION_REF,
+    PENDING_GROUP,
+    PENDING_NAME,
+    PENDING_MEMBER
+} PendingKind;
+
+// Fields that can only be resolved once the whole catalog file has been read
+typedef struct {
+    PendingKind kind;
+    size_t entry;
+    char* text;
+} PendingField;
+
+typedef struct {
+    VersionCatalog* catalog;
+    const char* name;
+    size_t name_length;
+    PendingField* pending;
+    size_t pending_count;
+    size_t pending_capacity;
+} CatalogLoad;
+
+VersionCatalog* version_catalog_create(const char* root) {
+    VersionCatalog* catalog = calloc(1, sizeof(VersionCatalog));
+    if (!catalog) return NULL;
+
+    catalog->root = strdup(root ? root : ".");
+    catalog->by_accessor = hashmap_create(128);
+    if (!catalog->root || !catalog->by_accessor) {
+        version_catalog_destroy(catalog);
+        return NULL;
+    }
+    return catalog;
+}
+
+void version_catalog_destroy(VersionCatalog* catalog) {
+    if (!catalog) return;
+
+    for (size_t i = 0; i < catalog->entry_count; i++) {
+        free(catalog->entries[i].accessor);
+        free(catalog->entries[i].module);
+        free(catalog->entries[i].version);
+        free(catalog->entries[i].members);
+    }
+    free(catalog->entries);
+    hashmap_destroy(catalog->by_accessor);
+    free(catalog->root);
+    free(catalog);
+}
+
+const CatalogEntry* version_catalog_find(const VersionCatalog* catalog, const char* accessor, size_t length) {
+    size_t index;
+    if (!catalog || !accessor || hashmap_get_n(catalog->by_accessor, accessor, length, &index) != 0) {
+        return NULL;
+    }
+    return &catalog->entries[index];
+}
+
+// Builds "<catalog>.<section>.<alias>" with alias separators normalized to '.'
+static size_t build_accessor(char* out, size_t size, const CatalogLoad* load, const char* section,
+                             const char* alias, size_t alias_length) {
+    int written = snprintf(out, size, "%.*s.%s%.*s", (int)load->name_length, load->name,
+                           section, (int)alias_length, alias);
+    if (written <= 0 || (size_t)written >= size) {
+        return 0;
+    }
+    for (size_t i = (size_t)written - alias_length; i < (size_t)written; i++) {
+        if (out[i] == '-' || out[i] == '_') out[i] = '.';
+    }
+    return (size_t)written;
+}
+
+static CatalogEntry* get_entry(CatalogLoad* load, CatalogEntryKind kind, const char* alias,
+                               size_t alias_length, int line, size_t* out_index) {
+    static const char* sections[] = {
+        [CATALOG_LIBRARY] = "",
+        [CATALOG_PLUGIN] = "plugins.",
+        [CATALOG_BUNDLE] = "bundles.",
+        [CATALOG_VERSION] = "versions."
+    };
+
+    VersionCatalog* catalog = load->catalog;
+    char accessor[MAX_NAME_LENGTH];
+    size_t length = build_accessor(accessor, sizeof(accessor), load, sections[kind], alias, alias_length);
+    if (length == 0) return NULL;
+
+    size_t index;
+    if (hashmap_get_n(catalog->by_accessor, accessor, length, &index) == 0) {
+        *out_index = index;
+        return &catalog->entries[index];
+    }
+
+    if (catalog->entry_count >= catalog->entry_capacity) {
+        size_t capacity = catalog->entry_capacity ? catalog->entry_capacity * 2 : 32;
+        CatalogEntry* grown = realloc(catalog->entries, capacity * sizeof(CatalogEntry));
+        if (!grown) return NULL;
+        catalog->entries = grown;
+        catalog->entry_capacity = capacity;
+    }
+
+    CatalogEntry* entry = &catalog->entries[catalog->entry_count];
+    memset(entry, 0, sizeof(CatalogEntry));
+    entry->kind = kind;
+    entry->line_number = line;
+    entry->accessor = strndup(accessor, length);
+    if (!entry->accessor || hashmap_put_n(catalog->by_accessor, accessor, length, catalog->entry_count) != 0) {
+        free(entry->accessor);
+        return NULL;
+    }
+
+    *out_index = catalog->entry_count++;
+    return entry;
+}
+
+static bool replace_string(char** field, const char* text, size_t length) {
+    char* copy = strndup(text, length);
+    if (!copy) return false;
+    free(*field);
+    *field = copy;
+    return true;
+}
+
+static bool add_pending(CatalogLoad* load, PendingKind kind, size_t entry, const char* text, size_t length) {
+    if (load->pending_count >= load->pending_capacity) {
+        size_t capacity = load->pending_capacity ? load->pending_capacity * 2 : 32;
+        PendingField* grown = realloc(load->pending, capacity * sizeof(PendingField));
+        if (!grown) return false;
+        load->pending = grown;
+        load->pending_capacity = capacity;
+    }
+    char* copy = strndup(text, length);
+    if (!copy) return false;
+    load->pending[load->pending_count++] = (PendingField){ kind, entry, copy };
+    return true;
+}
+
+// "group:artifact[:version]" for libraries, "id:version" for plugins
+static bool set_notation(CatalogEntry* entry, const TomlValue* value) {
+    const char* text = value->value;
+    const char* end = text + value->value_length;
+    const char* split = entry->kind == CATALOG_LIBRARY ? memchr(text, ':', value->value_length) : text - 1;
+    const char* version = split ? memchr(split + 1, ':', (size_t)(end - split - 1)) : NULL;
+
+    if (!replace_string(&entry->module, text, (size_t)((version ? version : end) - text))) return false;
+    return !version || replace_string(&entry->version, version + 1, (size_t)(end - version - 1));
+}
+
+static bool is_rich_version_key(const TomlValue* value, size_t index) {
+    return toml_key_is(value, index, "require") || toml_key_is(value, index, "strictly") ||
+           toml_key_is(value, index, "prefer");
+}
+
+// Rich versions: require or strictly wins over prefer
+static bool set_rich_version(CatalogEntry* entry, const TomlValue* value, size_t index) {
+    if (toml_key_is(value, index, "prefer") && entry->version) {
+        return true;
+    }
+    return replace_string(&entry->version, value->value, value->value_length);
+}
+
+static int visit_catalog_value(const TomlValue* value, void* context) {
+    CatalogLoad* load = context;
+    if (value->depth < 2 || value->type != TOML_STRING) {
+        return DEPTRACK_SUCCESS;
+    }
+
+    CatalogEntryKind kind;
+    if (toml_key_is(value, 0, "libraries")) kind = CATALOG_LIBRARY;
+    else if (toml_key_is(value, 0, "plugins")) kind = CATALOG_PLUGIN;
+    else if (toml_key_is(value, 0, "bundles")) kind = CATALOG_BUNDLE;
+    else if (toml_key_is(value, 0, "versions")) kind = CATALOG_VERSION;
+    else return DEPTRACK_SUCCESS;
+
+    size_t index;
+    CatalogEntry* entry = get_entry(load, kind, value->path[1], value->path_lengths[1],
+                                    value->line_number, &index);
+    if (!entry) return DEPTRACK_ERROR_MEMORY;
+
+    bool ok = true;
+    if (kind == CATALOG_BUNDLE) {
+        if (value->depth == 2 && value->array_index != SIZE_MAX) {
+            ok = add_pending(load, PENDING_MEMBER, index, value->value, value->value_length);
+        }
+    } else if (kind == CATALOG_VERSION) {
+        if (value->depth == 2) {
+            ok = replace_string(&entry->version, value->value, value->value_length);
+        } else if (value->depth == 3 && is_rich_version_key(value, 2)) {
+            ok = set_rich_version(entry, value, 2);
+        }
+    } else if (value->depth == 2) {
+        ok = set_notation(entry, value);
+    } else if (value->depth == 3) {
+        if (toml_key_is(value, 2, "module") || toml_key_is(value, 2, "id")) {
+            ok = replace_string(&entry->module, value->value, value->value_length);
+        } else if (toml_key_is(value, 2, "group")) {
+            ok = add_pending(load, PENDING_GROUP, index, value->value, value->value_length);
+        } else if (toml_key_is(value, 2, "name")) {
+            ok = add_pending(load, PENDING_NAME, index, value->value, value->value_length);
+        } else if (toml_key_is(value, 2, "version")) {
+            ok = replace_string(&entry->version, value->value, value->value_length);
+        }
+    } else if (value->depth == 4 && toml_key_is(value, 2, "version")) {
+        if (toml_key_is(value, 3, "ref")) {
+            ok = add_pending(load, PENDING_VERSION_REF, index, value->value, value->value_length);
+        } else if (is_rich_version_key(value, 3)) {
+            ok = set_rich_version(entry, value, 3);
+        }
+    }
+
+    return ok ? DEPTRACK_SUCCESS : DEPTRACK_ERROR_MEMORY;
+}
+
+static int resolve_pending(CatalogLoad* load) {
+    VersionCatalog* catalog = load->catalog;
+    char accessor[MAX_NAME_LENGTH];
+
+    // group = "g", name = "a" pairs become module "g:a"; the two keys may come in either order
+    for (size_t i = 0; i < load->pending_count; i++) {
+        PendingField* group = &load->pending[i];
+        if (group->kind != PENDING_GROUP) continue;
+        for (size_t j = 0; j < load->pending_count; j++) {
+            PendingField* name = &load->pending[j];
+            if (name->kind != PENDING_NAME || name->entry != group->entry) continue;
+            int written = snprintf(accessor, sizeof(accessor), "%s:%s", group->text, name->text);
+            if (written > 0 && (size_t)written < sizeof(accessor) &&
+                !replace_string(&catalog->entries[group->entry].module, accessor, (size_t)written)) {
+                return DEPTRACK_ERROR_MEMORY;
+            }
+            break;
+        }
+    }
+
+    for (size_t i = 0; i < load->pending_count; i++) {
+        PendingField* field = &load->pending[i];
+        CatalogEntry* entry = &catalog->entries[field->entry];
+        size_t target;
+
+        if (field->kind == PENDING_VERSION_REF) {
+            size_t length = build_accessor(accessor, sizeof(accessor), load, "versions.",
+                                           field->text, strlen(field->text));
+            if (length > 0 && hashmap_get_n(catalog->by_accessor, accessor, length, &target) == 0 &&
+                catalog->entries[target].version) {
+                const char* version = catalog->entries[target].version;
+                if (!replace_string(&entry->version, version, strlen(version))) {
+                    return DEPTRACK_ERROR_MEMORY;
+                }
+            }
+        } else if (field->kind == PENDING_MEMBER) {
+            size_t length = build_accessor(accessor, sizeof(accessor), load, "",
+                                           field->text, strlen(field->text));
+            if (length == 0 || hashmap_get_n(catalog->by_accessor, accessor, length, &target) != 0 ||
+                catalog->entries[target].kind != CATALOG_LIBRARY) {
+                continue; // Unknown bundle member; Gradle would reject the catalog
+            }
+            size_t* grown = realloc(entry->members, (entry->member_count + 1) * sizeof(size_t));
+            if (!grown) return DEPTRACK_ERROR_MEMORY;
+            entry->members = grown;
+            entry->members[entry->member_count++] = target;
+        }
+    }
+
+    return DEPTRACK_SUCCESS;
+}
+
+int version_catalog_add_buffer(VersionCatalog* catalog, const char* name, const char* buffer, size_t length) {
+    if (!catalog || !name || !buffer) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    CatalogLoad load = { catalog, name, strlen(name), NULL, 0, 0 };
+    int result = toml_parse_buffer(buffer, length, visit_catalog_value, &load);
+    if (result == DEPTRACK_SUCCESS) {
+        result = resolve_pending(&load);
+    }
+
+    for (size_t i = 0; i < load.pending_count; i++) {
+        free(load.pending[i].text);
+    }
+    free(load.pending);
+    return result;
+}
+
+VersionCatalog* version_catalog_load(const char* root) {
+    VersionCatalog* catalog = version_catalog_create(root);
+    if (!catalog) return NULL;
+
+    char dir_path[MAX_PATH_LENGTH];
+    snprintf(dir_path, sizeof(dir_path), "%s/gradle", catalog->root);
+    DIR* dir = opendir(dir_path);
+    if (!dir) {
+        return catalog; // No catalogs: an empty index resolves nothing
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t name_length = strlen(entry->d_name);
+        size_t suffix_length = strlen(CATALOG_SUFFIX);
+        if (name_length <= suffix_length || !file_has_suffix(entry->d_name, CATALOG_SUFFIX)) {
+            continue;
+        }
+
+        char path[MAX_PATH_LENGTH];
+        int written = snprintf(path, sizeof(path), "%s/%s", dir_path, entry->d_name);
+        if (written <= 0 || (size_t)written >= sizeof(path)) continue;
+
+        size_t length;
+        char* buffer = parser_read_file(path, &length);
+        if (!buffer) continue;
+
+        char name[MAX_NAME_LENGTH];
+        snprintf(name, sizeof(name), "%.*s", (int)(name_length - suffix_length), entry->d_name);
+        if (version_catalog_add_buffer(catalog, name, buffer, length) != DEPTRACK_SUCCESS) {
+            fprintf(stderr, "Warning: could not read version catalog %s\n", path);
+        }
+        free(buffer);
+    }
+
+    closedir(dir);
+    return catalog;
+}
+
+static bool apply_entry(Dependency* dep, const CatalogEntry* entry) {
+    const char* version = entry->version ? entry->version : "unknown";
+    if (!entry->module) {
+        return false;
+    }
+    if (!replace_string(&dep->name, entry->module, strlen(entry->module)) ||
+        !replace_string(&dep->version, version, strlen(version))) {
+        return false;
+    }
+    dep->status = RESOLVE_SUCCESS;
+    return true;
+}
+
+size_t version_catalog_resolve(const VersionCatalog* catalog, ParsedFile* parsed) {
+    if (!catalog || !parsed) {
+        return 0;
+    }
+
+    size_t resolved = 0;
+    size_t original_count = parsed->dep_count;
+    for (size_t i = 0; i < original_count; i++) {
+        Dependency* dep = &parsed->dependencies[i];
+        if (strcmp(dep->version, "catalog") != 0) {
+            continue;
+        }
+
+        const CatalogEntry* entry = version_catalog_find(catalog, dep->name, strlen(dep->name));
+        if (!entry || entry->kind == CATALOG_VERSION ||
+            (entry->kind == CATALOG_BUNDLE && entry->member_count == 0)) {
+            dep->status = RESOLVE_NOT_FOUND;
+            continue;
+        }
+
+        if (entry->kind != CATALOG_BUNDLE) {
+            if (apply_entry(dep, entry)) resolved++;
+            else dep->status = RESOLVE_NOT_FOUND;
+            continue;
+        }
+
+        // A bundle becomes its first member in place; the others are appended
+        DependencyType type = dep->type;
+        int line = dep->line_number;
+        for (size_t m = 1; m < entry->member_count; m++) {
+            const CatalogEntry* member = &catalog->entries[entry->members[m]];
+            if (member->module &&
+                parsed_file_add_dependency(parsed, member->module, strlen(member->module),
+                                           member->version, type, line)) {
+                resolved++;
+            }
+        }
+        dep = &parsed->dependencies[i]; // The array may have moved
+        if (apply_entry(dep, &catalog->entries[entry->members[0]])) resolved++;
+        else dep->status = RESOLVE_NOT_FOUND;
+    }
+
+    return resolved;
+}
@@ -1 +1,150 @@
-// Stub implementation for file_utils
+/**
+ * @file file_utils.c
+ * @brief Filesystem helpers
+ * @author Unhinged Development Team
+ *
+ * @llm-type util
+ * @llm-legend Recursive directory walking shared by analyzers that load a whole tree
+ * @llm-key Depth-first walk with a single reused path buffer; hidden entries and common
+ *          vendored/output directories are skipped
+ */
+
+#include "dependency_tracker.h"
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string.h>
+
+static const char* skipped_directories[] = {
+    "node_modules", "__pycache__", "venv", "target", "dist", NULL
+};
+
+bool file_is_skipped_directory(const char* name) {
+    if (name[0] == '.') {
+        return true;
+    }
+    for (size_t i = 0; skipped_directories[i]; i++) {
+        if (strcmp(name, skipped_directories[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int walk_directory(char* path, size_t length, FileVisitFunction visit, void* context) {
+    DIR* dir = opendir(path);
+    if (!dir) {
+        return DEPTRACK_ERROR_FILE_NOT_FOUND;
+    }
+
+    int result = DEPTRACK_SUCCESS;
+    struct dirent* entry;
+    while (result == DEPTRACK_SUCCESS && (entry = readdir(dir)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+
+        size_t name_length = strlen(entry->d_name);
+        if (length + 1 + name_length >= MAX_PATH_LENGTH) {
+            continue;
+        }
+        path[length] = '/';
+        memcpy(path + length + 1, entry->d_name, name_length + 1);
+
+        bool is_dir = false;
+        bool is_file = false;
+#ifdef _DIRENT_HAVE_D_TYPE
+        if (entry->d_type == DT_DIR) {
+            is_dir = true;
+        } else if (entry->d_type == DT_REG) {
+            is_file = true;
+        } else if (entry->d_type == DT_UNKNOWN || entry->d_type == DT_LNK)
+#endif
+        {
+            struct stat st;
+            if (stat(path, &st) == 0) {
+                is_dir = S_ISDIR(st.st_mode);
+                is_file = S_ISREG(st.st_mode);
+            }
+        }
+
+        if (is_dir) {
+            if (!file_is_skipped_directory(entry->d_name)) {
+                int sub = walk_directory(path, length + 1 + name_length, visit, context);
+                if (sub != DEPTRACK_SUCCESS && sub != DEPTRACK_ERROR_FILE_NOT_FOUND) {
+                    result = sub; // Visitor asked to stop; unreadable subdirectories are skipped
+                }
+            }
+        } else if (is_file) {
+            result = visit(path, context);
+        }
+    }
+
+    path[length] = '\0';
+    closedir(dir);
+    return result;
+}
+
+int file_walk(const char* root, FileVisitFunction visit, void* context) {
+    if (!root || !visit) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+
+    char path[MAX_PATH_LENGTH];
+    size_t length = strlen(root);
+    if (length >= MAX_PATH_LENGTH) {
+        return DEPTRACK_ERROR_INVALID_PARAM;
+    }
+    memcpy(path, root, length + 1);
+
+    // Drop a trailing slash so joined paths stay canonical
+    while (length > 1 && path[length - 1] == '/') {
+        path[--length] = '\0';
+    }
+
+    return walk_directory(path, length, visit, context);
+}
+
+bool file_has_suffix(const char* path, const char* suffix) {
+    if (!path || !suffix) {
+        return false;
+    }
+    size_t path_length = strlen(path);
+    size_t suffix_length = strlen(suffix);
+    return path_length >= suffix_length &&
+           memcmp(path + path_length - suffix_length, suffix, suffix_length) == 0;
+}
+
+void file_normalize_path(char* path) {
+    bool absolute = path[0] == '/';
+    char* segments[MAX_PATH_LENGTH / 2];
+    size_t count = 0;
+    size_t leading_up = 0;     // ".." that cannot be collapsed in a relative path
+
+    char* save = NULL;
+    for (char* token = strtok_r(path, "/", &save); token; token = strtok_r(NULL, "/", &save)) {
+        if (strcmp(token, ".") == 0) continue;
+        if (strcmp(token, "..") == 0) {
+            if (count > leading_up) {
+                count--;
+                continue;
+            }
+            if (absolute) continue;
+            leading_up++;
+        }
+        if (count < sizeof(segments) / sizeof(segments[0])) segments[count++] = token;
+    }
+
+    char normalized[MAX_PATH_LENGTH];
+    size_t length = 0;
+    if (absolute) normalized[length++] = '/';
+    for (size_t i = 0; i < count; i++) {
+        size_t segment_length = strlen(segments[i]);
+        if (length + segment_length + 2 >= sizeof(normalized)) break;
+        if (i > 0) normalized[length++] = '/';
+        memcpy(normalized + length, segments[i], segment_length);
+        length += segment_length;
+    }
+    if (length == 0) normalized[length++] = '.';
+    normalized[length] = '\0';
+    strcpy(path, normalized);
+}
@@ -1 +1,170 @@
-// Stub implementation for hash_map
+/**
+ * @file hash_map.c
+ * @brief String-keyed hash map shared by the graph index and the parsers
+ * @author Unhinged Development Team
+ *
+ * @llm-type util
+ * @llm-legend Chained hash map from string keys to size_t values (usually array indices)
+ * @llm-key Keys are copied on insert; lookups accept length-delimited keys so parsers can
+ *          probe straight out of a file buffer without copying the token first
+ * @llm-contract Not thread-safe; callers hold their own lock (see DependencyGraph.mutex)
+ */
+
+#include "dependency_tracker.h"
+#include <string.h>
+
+#define HASHMAP_MAX_LOAD_FACTOR 2
+
+typedef struct HashMapEntry {
+    char* key;
+    size_t key_length;
+    size_t hash;
+    size_t value;
+    struct HashMapEntry* next;
+} HashMapEntry;
+
+struct HashMap {
+    HashMapEntry** buckets;
+    size_t bucket_count;
+    size_t size;
+};
+
+static size_t hash_bytes(const char* str, size_t length) {
+    size_t hash = 5381;
+    for (size_t i = 0; i < length; i++) {
+        hash = ((hash << 5) + hash) + (unsigned char)str[i];
+    }
+    return hash;
+}
+
+HashMap* hashmap_create(size_t bucket_count) {
+    if (bucket_count == 0) {
+        bucket_count = 16;
+    }
+
+    HashMap* map = calloc(1, sizeof(HashMap));
+    if (!map) return NULL;
+
+    map->buckets = calloc(bucket_count, sizeof(HashMapEntry*));
+    if (!map->buckets) {
+        free(map);
+        return NULL;
+    }
+
+    map->bucket_count = bucket_count;
+    map->size = 0;
+    return map;
+}
+
+void hashmap_destroy(HashMap* map) {
+    if (!map) return;
+
+    for (size_t i = 0; i < map->bucket_count; i++) {
+        HashMapEntry* entry = map->buckets[i];
+        while (entry) {
+            HashMapEntry* next = entry->next;
+            free(entry->key);
+            free(entry);
+            entry = next;
+        }
+    }
+
+    free(map->buckets);
+    free(map);
+}
+
+static void hashmap_grow(HashMap* map) {
+    size_t new_count = map->bucket_count * 2 + 1;
+    HashMapEntry** new_buckets = calloc(new_count, sizeof(HashMapEntry*));
+    if (!new_buckets) {
+        return; // Keep the old table; chains just get longer
+    }
+
+    for (size_t i = 0; i < map->bucket_count; i++) {
+        HashMapEntry* entry = map->buckets[i];
+        while (entry) {
+            HashMapEntry* next = entry->next;
+            size_t bucket = entry->hash % new_count;
+            entry->next = new_buckets[bucket];
+            new_buckets[bucket] = entry;
+            entry = next;
+        }
+    }
+
+    free(map->buckets);
+    map->buckets = new_buckets;
+    map->bucket_count = new_count;
+}
+
+int hashmap_put_n(HashMap* map, const char* key, size_t key_length, size_t value) {
+    if (!map || !key) return -1;
+
+    size_t hash = hash_bytes(key, key_length);
+    size_t bucket = hash % map->bucket_count;
+
+    // Check if key already exists
+    HashMapEntry* entry = map->buckets[bucket];
+    while (entry) {
+        if (entry->hash == hash && entry->key_length == key_length &&
+            memcmp(entry->key, key, key_length) == 0) {
+            entry->value = value;
+            return 0;
+        }
+        entry = entry->next;
+    }
+
+    // Create new entry
+    entry = malloc(sizeof(HashMapEntry));
+    if (!entry) return -1;
+
+    entry->key = strndup(key, key_length);
+    if (!entry->key) {
+        free(entry);
+        return -1;
+    }
+
+    entry->key_length = key_length;
+    entry->hash = hash;
+    entry->value = value;
+    entry->next = map->buckets[bucket];
+    map->buckets[bucket] = entry;
+    map->size++;
+
+    if (map->size > map->bucket_count * HASHMAP_MAX_LOAD_FACTOR) {
+        hashmap_grow(map);
+    }
+
+    return 0;
+}
+
+int hashmap_put(HashMap* map, const char* key, size_t value) {
+    if (!key) return -1;
+    return hashmap_put_n(map, key, strlen(key), value);
+}
+
+int hashmap_get_n(const HashMap* map, const char* key, size_t key_length, size_t* value) {
+    if (!map || !key || !value) return -1;
+
+    size_t hash = hash_bytes(key, key_length);
+    HashMapEntry* entry = map->buckets[hash % map->bucket_count];
+
+    while (entry) {
+        if (entry->hash == hash && entry->key_length == key_length &&
+            memcmp(entry->key, key, key_length) == 0) {
+            *value = entry->value;
+            return 0;
+        }
+        entry = entry->next;
+    }
+
+    return -1; // Not found
+}
+
+int hashmap_get(const HashMap* map, const char* key, size_t* value) {
+    if (!key) return -1;
+    return hashmap_get_n(map, key, strlen(key), value);
+}
+
+size_t hashmap_size(const HashMap* map) {
+    return map ? map->size : 0;
+}
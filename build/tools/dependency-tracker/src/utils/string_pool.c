@@ -0,0 +1,102 @@
+/**
+ * @file string_pool.c
+ * @brief Interned strings addressed by 32-bit handles
+ * @author Unhinged Development Team
+ *
+ * @llm-type util
+ * @llm-legend Stores each distinct string once so columns can hold a 4-byte handle instead of a pointer
+ * @llm-key Strings sit back to back in one growing buffer; handle i is the i-th distinct string and
+ *          indexes an offset table, and a HashMap finds the handle of a string already seen
+ * @llm-contract Not thread-safe; the graph interns under its own lock
+ */
+
+#include "dependency_tracker.h"
+#include <string.h>
+
+#define STRING_POOL_INITIAL_BYTES 4096
+#define STRING_POOL_INITIAL_STRINGS 256
+
+struct StringPool {
+    char* data;
+    size_t length;
+    size_t capacity;
+    size_t* offsets;           // By handle
+    size_t count;
+    size_t offset_capacity;
+    HashMap* index;            // String -> handle
+};
+
+StringPool* string_pool_create(void) {
+    StringPool* pool = calloc(1, sizeof(StringPool));
+    if (!pool) return NULL;
+    pool->data = malloc(STRING_POOL_INITIAL_BYTES);
+    pool->offsets = malloc(STRING_POOL_INITIAL_STRINGS * sizeof(size_t));
+    pool->index = hashmap_create(STRING_POOL_INITIAL_STRINGS);
+    if (!pool->data || !pool->offsets || !pool->index) {
+        string_pool_destroy(pool);
+        return NULL;
+    }
+    pool->capacity = STRING_POOL_INITIAL_BYTES;
+    pool->offset_capacity = STRING_POOL_INITIAL_STRINGS;
+    return pool;
+}
+
+void string_pool_destroy(StringPool* pool) {
+    if (!pool) return;
+    free(pool->data);
+    free(pool->offsets);
+    hashmap_destroy(pool->index);
+    free(pool);
+}
+
+int string_pool_intern(StringPool* pool, const char* text, StringHandle* handle) {
+    if (!pool || !handle) return DEPTRACK_ERROR_INVALID_PARAM;
+    if (!text) {
+        *handle = STRING_NONE;
+        return DEPTRACK_SUCCESS;
+    }
+    size_t length = strlen(text);
+    size_t existing;
+    if (hashmap_get_n(pool->index, text, length, &existing) == 0) {
+        *handle = (StringHandle)existing;
+        return DEPTRACK_SUCCESS;
+    }
+    if (pool->count >= STRING_NONE) return DEPTRACK_ERROR_MEMORY;
+
+    if (pool->length + length + 1 > pool->capacity) {
+        size_t capacity = pool->capacity * 2;
+        while (capacity < pool->length + length + 1) capacity *= 2;
+        char* data = realloc(pool->data, capacity);
+        if (!data) return DEPTRACK_ERROR_MEMORY;
+        pool->data = data;
+        pool->capacity = capacity;
+    }
+    if (pool->count >= pool->offset_capacity) {
+        size_t* offsets = realloc(pool->offsets, pool->offset_capacity * 2 * sizeof(size_t));
+        if (!offsets) return DEPTRACK_ERROR_MEMORY;
+        pool->offsets = offsets;
+        pool->offset_capacity *= 2;
+    }
+    if (hashmap_put_n(pool->index, text, length, pool->count) != 0) return DEPTRACK_ERROR_MEMORY;
+
+    memcpy(pool->data + pool->length, text, length + 1);
+    pool->offsets[pool->count] = pool->length;
+    pool->length += length + 1;
+    *handle = (StringHandle)pool->count++;
+    return DEPTRACK_SUCCESS;
+}
+
+StringHandle string_pool_find(const StringPool* pool, const char* text) {
+    size_t handle;
+    if (!pool || !text || hashmap_get(pool->index, text, &handle) != 0) return STRING_NONE;
+    return (StringHandle)handle;
+}
+
+const char* string_pool_get(const StringPool* pool, StringHandle handle) {
+    if (!pool || handle >= pool->count) return NULL;
+    return pool->data + pool->offsets[handle];
+}
+
+size_t string_pool_count(const StringPool* pool) {
+    return pool ? pool->count : 0;
+}
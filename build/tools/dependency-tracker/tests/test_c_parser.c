@@ -0,0 +1,159 @@
+/**
+ * @file test_c_parser.c
+ * @brief C/C++ include scanner, resolver and depfile tests
+ */
+
+#include "dependency_tracker.h"
+#include <sys/stat.h>
+#include <unistd.h>
+
+void test_c_include_scanning(void) {
+    static const char* source =
+        "/* header comment\n"
+        "#include \"commented.h\" */\n"
+        "#ifndef UTIL_H\n"
+        "#define UTIL_H\n"
+        "#include <stdio.h>\n"
+        "  #  include \"util/strings.h\" // trailing\n"
+        "#if 0\n"
+        "#include \"disabled.h\"\n"
+        "#elif 1\n"
+        "#include \"enabled.h\"\n"
+        "#else\n"
+        "#include \"also_disabled.h\"\n"
+        "#endif\n"
+        "#ifdef HAVE_POSIX\n"
+        "#include <unistd.h>\n"
+        "#else\n"
+        "#include <windows.h>\n"
+        "#endif\n"
+        "static const char* s = \"#include <nope.h>\";\n"
+        "#define LONG_MACRO(x) \\\n"
+        "    do { x; } while (0)\n"
+        "#include HEADER_MACRO\n"
+        "#include \"last.h\"\n"
+        "#endif /* UTIL_H */\n";
+
+    CSourceFile* file = c_scan_buffer("util.h", source, strlen(source));
+    TEST_ASSERT_NOT_NULL(file, "Header should scan");
+    if (!file) return;
+
+    TEST_ASSERT_EQ(6, file->include_count, "Comments, strings and #if 0 branches are skipped");
+    if (file->include_count == 6) {
+        TEST_ASSERT(file->includes[0].system && strcmp(file->includes[0].path, "stdio.h") == 0, "Angle include");
+        TEST_ASSERT(!file->includes[1].system && file->includes[1].line_number == 6, "Indented quoted include");
+        TEST_ASSERT_STR_EQ("enabled.h", file->includes[2].path, "#elif 1 branch is live");
+        TEST_ASSERT_STR_EQ("windows.h", file->includes[4].path, "Unknown conditions keep both branches");
+        TEST_ASSERT(strcmp(file->includes[5].path, "last.h") == 0 && file->includes[5].line_number == 23,
+                    "Continuation lines are counted");
+    }
+    TEST_ASSERT(file->guard && strcmp(file->guard, "UTIL_H") == 0, "Include guard should be detected");
+    c_source_destroy(file);
+
+    static const char* unguarded =
+        "#ifndef A\n"
+        "#define A\n"
+        "#endif\n"
+        "int after_guard;\n";
+    file = c_scan_buffer("a.h", unguarded, strlen(unguarded));
+    TEST_ASSERT(file && !file->guard, "Code after the #endif means no guard");
+    c_source_destroy(file);
+
+    static const char* once = "#pragma once\n#include \"b.h\"\n";
+    file = c_scan_buffer("b.h", once, strlen(once));
+    TEST_ASSERT(file && file->pragma_once && file->include_count == 1, "#pragma once");
+    c_source_destroy(file);
+
+    TEST_ASSERT_EQ(LANG_C, deptrack_detect_language("src/main.c"), "C sources should be detected");
+    TEST_ASSERT_EQ(LANG_C, deptrack_detect_language("include/api.hpp"), "C++ headers should be detected");
+}
+
+void test_c_include_resolution(void) {
+    char dir_template[] = "/tmp/deptrack_c_XXXXXX";
+    char* dir = mkdtemp(dir_template);
+    TEST_ASSERT_NOT_NULL(dir, "Temporary directory should be created");
+    if (!dir) return;
+
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/include", dir);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/src", dir);
+    mkdir(path, 0755);
+
+    write_fixture(dir, "CMakeLists.txt",
+        "cmake_minimum_required(VERSION 3.10)\n"
+        "# include_directories(ignored)\n"
+        "include_directories(include ${UNKNOWN_DIRS})\n"
+        "target_include_directories(app PRIVATE\n"
+        "    $<BUILD_INTERFACE:${CMAKE_CURRENT_SOURCE_DIR}/src>\n"
+        "    $<INSTALL_INTERFACE:include>)\n");
+    write_fixture(dir, "include/api.h",
+        "#pragma once\n#include \"types.h\"\n#include <stdlib.h>\n");
+    write_fixture(dir, "include/types.h",
+        "#ifndef TYPES_H\n#define TYPES_H\n#include \"api.h\"\n#endif\n");
+    write_fixture(dir, "src/local.h", "#include \"../include/types.h\"\n");
+    write_fixture(dir, "src/my file.c",
+        "#include \"local.h\"\n#include <api.h>\n#include \"missing.h\"\n");
+
+    CIncludeResolver* resolver = c_resolver_create();
+    snprintf(path, sizeof(path), "%s/CMakeLists.txt", dir);
+    int result = c_resolver_load_cmake(resolver, path);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "CMakeLists.txt should load");
+    TEST_ASSERT_EQ(2, resolver->include_dir_count, "Plain and BUILD_INTERFACE directories are read");
+
+    snprintf(path, sizeof(path), "%s/src/my file.c", dir);
+    size_t* files = NULL;
+    size_t count = 0;
+    result = c_resolver_dependencies(resolver, path, &files, &count);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Dependencies should resolve");
+    TEST_ASSERT_EQ(4, count, "Source, local.h, types.h and api.h, each once");
+    if (count == 4) {
+        char expected[MAX_PATH_LENGTH];
+        snprintf(expected, sizeof(expected), "%s/include/types.h", dir);
+        TEST_ASSERT_STR_EQ(expected, resolver->paths[files[3]], "Relative includes are normalized");
+    }
+    free(files);
+
+    // A second source including the same headers hits the lookup cache
+    size_t hits = resolver->cache_hits;
+    write_fixture(dir, "src/other.c", "#include <api.h>\n");
+    snprintf(path, sizeof(path), "%s/src/other.c", dir);
+    result = c_resolver_dependencies(resolver, path, &files, &count);
+    TEST_ASSERT(result == DEPTRACK_SUCCESS && resolver->cache_hits > hits, "Angle lookups are shared");
+    free(files);
+
+    char depfile[MAX_PATH_LENGTH];
+    snprintf(depfile, sizeof(depfile), "%s/out.d", dir);
+    FILE* out = fopen(depfile, "w");
+    snprintf(path, sizeof(path), "%s/src/my file.c", dir);
+    result = c_write_depfile(resolver, "my file.o", path, true, out);
+    fclose(out);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Depfile should be written");
+
+    size_t length = 0;
+    char* text = parser_read_file(depfile, &length);
+    TEST_ASSERT(text && strncmp(text, "my\\ file.o: ", 12) == 0, "Spaces are escaped for Make");
+    TEST_ASSERT(text && strstr(text, "include/api.h:\n") != NULL, "Headers get phony rules");
+    TEST_ASSERT(text && !strstr(text, "missing.h") && !strstr(text, "stdlib.h"), "Unresolved includes are omitted");
+    free(text);
+    c_resolver_destroy(resolver);
+
+    const char* names[] = {
+        "out.d", "src/other.c", "src/my file.c", "src/local.h", "include/types.h", "include/api.h",
+        "CMakeLists.txt", NULL
+    };
+    for (size_t i = 0; names[i]; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        unlink(path);
+    }
+    snprintf(path, sizeof(path), "%s/src", dir);
+    rmdir(path);
+    snprintf(path, sizeof(path), "%s/include", dir);
+    rmdir(path);
+    rmdir(dir);
+}
+
+void run_c_parser_tests(void) {
+    test_run("c_include_scanning", test_c_include_scanning);
+    test_run("c_include_resolution", test_c_include_resolution);
+}
@@ -0,0 +1,174 @@
+/**
+ * @file test_ci_parser.c
+ * @brief CI workflow parsing, job graph and change-based job selection tests
+ */
+
+#include "dependency_tracker.h"
+
+static const char* workflow_text =
+    "name: Pipeline\n"
+    "\n"
+    "on:\n"
+    "  push:\n"
+    "    branches: [ main ]\n"
+    "    paths-ignore:\n"
+    "      - 'docs/**'\n"
+    "      - '**.md'\n"
+    "  pull_request:\n"
+    "    paths-ignore: ['docs/**', '**.md']\n"
+    "  release:\n"
+    "    types: [ published ]\n"
+    "\n"
+    "jobs:\n"
+    "  # Builds everything\n"
+    "  build:\n"
+    "    runs-on: ubuntu-latest\n"
+    "    timeout-minutes: 30\n"
+    "    steps:\n"
+    "    - name: Checkout\n"
+    "      uses: actions/checkout@v4\n"
+    "      with:\n"
+    "        fetch-depth: 0\n"
+    "    - name: Build\n"
+    "      run: |\n"
+    "        python build/ci/scripts/build.py\n"
+    "        ./tools/package.sh --fast\n"
+    "\n"
+    "  lint:\n"
+    "    timeout-minutes: 10\n"
+    "    paths:\n"
+    "      - 'src/**.py'\n"
+    "      - '!src/generated/**'\n"
+    "    steps:\n"
+    "      - run: python3 build/ci/scripts/lint.py\n"
+    "        working-directory: .\n"
+    "\n"
+    "  web:\n"
+    "    timeout-minutes: 15\n"
+    "    paths: [ 'web/**' ]\n"
+    "    steps:\n"
+    "      - run: npm test\n"
+    "        working-directory: web\n"
+    "      - run: ./scripts/e2e.sh\n"
+    "        working-directory: web\n"
+    "\n"
+    "  integration:\n"
+    "    timeout-minutes: 45\n"
+    "    needs: build\n"
+    "    services:\n"
+    "      postgres:\n"
+    "        image: postgres:15\n"
+    "        options: >-\n"
+    "          --health-cmd pg_isready\n"
+    "    steps:\n"
+    "    - run: python build/ci/scripts/integration.py\n"
+    "\n"
+    "  deploy:\n"
+    "    needs: [build, lint, integration]\n"
+    "    timeout-minutes: 20\n"
+    "    if: github.event_name == 'release'\n"
+    "    steps:\n"
+    "    - run: python build/cd/deploy.py\n";
+
+void test_ci_workflow_parsing(void) {
+    CiWorkflow* wf = ci_workflow_parse_buffer(NULL, ".github/workflows/main.yml", workflow_text,
+                                              strlen(workflow_text));
+    TEST_ASSERT_NOT_NULL(wf, "Workflow should parse");
+    if (!wf) return;
+
+    TEST_ASSERT_STR_EQ("Pipeline", wf->name, "Workflow name");
+    TEST_ASSERT_EQ(3, wf->trigger_count, "push, pull_request and release");
+    TEST_ASSERT(wf->trigger_count == 3 && wf->triggers[0].paths_ignore_count == 2 &&
+                wf->triggers[1].paths_ignore_count == 2, "Block and flow paths-ignore lists");
+    TEST_ASSERT_EQ(5, wf->job_count, "Jobs under jobs:");
+
+    const CiJob* build = ci_workflow_find_job(wf, "build");
+    TEST_ASSERT(build && build->step_count == 2 && build->timeout_minutes == 30, "Steps and timeout");
+    if (build && build->step_count == 2) {
+        TEST_ASSERT_STR_EQ("actions/checkout@v4", build->steps[0].uses, "uses is kept per step");
+        TEST_ASSERT(build->steps[1].run && strstr(build->steps[1].run, "package.sh --fast\n"),
+                    "Block scalars keep their lines");
+        TEST_ASSERT_EQ(24, build->steps[1].line_number, "Steps record their line");
+    }
+    TEST_ASSERT(build && build->script_count == 2 && strcmp(build->scripts[1], "tools/package.sh") == 0,
+                "Run scripts are scanned");
+
+    const CiJob* web = ci_workflow_find_job(wf, "web");
+    TEST_ASSERT(web && web->script_count == 1 && strcmp(web->scripts[0], "web/scripts/e2e.sh") == 0,
+                "working-directory applies to the step");
+
+    const CiJob* deploy = ci_workflow_find_job(wf, "deploy");
+    TEST_ASSERT(deploy && deploy->need_count == 3, "Flow needs");
+    TEST_ASSERT(deploy && deploy->condition && strstr(deploy->condition, "release"), "if: condition");
+    const CiJob* integration = ci_workflow_find_job(wf, "integration");
+    TEST_ASSERT(integration && integration->need_count == 1 && integration->script_count == 1,
+                "Scalar needs; services do not leak into the job");
+
+    DagSchedule schedule;
+    int result = ci_workflow_schedule(wf, &schedule);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Job graph is acyclic");
+    if (result == DEPTRACK_SUCCESS) {
+        TEST_ASSERT_EQ(3, schedule.wave_count, "build/lint/web, integration, deploy");
+        TEST_ASSERT(schedule.critical_path_cost == 95.0, "30 + 45 + 20 minutes");
+        TEST_ASSERT(schedule.critical_path_length == 3 &&
+                    strcmp(wf->jobs[schedule.critical_path[0]].id, "build") == 0, "Critical path starts at build");
+        dag_schedule_destroy(&schedule);
+    }
+
+    ci_workflow_destroy(wf);
+
+    TEST_ASSERT(ci_is_workflow("build/ci/workflows/main.yml"), "Workflow directories are recognized");
+    TEST_ASSERT(!ci_is_workflow("build/ci/docker-compose.production.yml"), "Compose files are not workflows");
+}
+
+void test_ci_required_jobs(void) {
+    TEST_ASSERT(ci_path_matches("src/**.py", "src/a/b.py"), "** crosses directories");
+    TEST_ASSERT(!ci_path_matches("*.md", "docs/a.md"), "* stays in one directory");
+    TEST_ASSERT(ci_path_matches("docs/**", "./docs/guide/intro.md"), "Leading ./ is ignored");
+    TEST_ASSERT(ci_path_matches("**/test_[a-c]?.py", "tests/test_b1.py"), "Classes and ?");
+
+    CiWorkflow* wf = ci_workflow_parse_buffer(NULL, ".github/workflows/main.yml", workflow_text,
+                                              strlen(workflow_text));
+    TEST_ASSERT_NOT_NULL(wf, "Workflow should parse");
+    if (!wf) return;
+
+    bool required[8];
+    const char* docs[] = { "docs/guide.md", "README.md" };
+    TEST_ASSERT_EQ(0, ci_workflow_required_jobs(wf, docs, 2, required), "Ignored paths start nothing");
+
+    const char* web_change[] = { "web/app.ts" };
+    size_t count = ci_workflow_required_jobs(wf, web_change, 1, required);
+    const CiJob* lint = ci_workflow_find_job(wf, "lint");
+    const CiJob* web = ci_workflow_find_job(wf, "web");
+    TEST_ASSERT_EQ(5, count, "build has no filter, so deploy needs lint too");
+    TEST_ASSERT(web && required[web - wf->jobs], "Filtered job matches its paths");
+
+    // Once every job has a filter, a change runs only what it touches
+    static const char* const unfiltered[] = { "build", "integration", "deploy" };
+    for (size_t i = 0; i < 3; i++) {
+        CiJob* job = &wf->jobs[ci_workflow_find_job(wf, unfiltered[i]) - wf->jobs];
+        job->paths = malloc(sizeof(char*));
+        job->paths[0] = strdup("build/**");
+        job->path_count = 1;
+    }
+    count = ci_workflow_required_jobs(wf, web_change, 1, required);
+    TEST_ASSERT(count == 1 && web && required[web - wf->jobs], "Only web runs for a web change");
+
+    const char* generated[] = { "src/generated/api.py" };
+    TEST_ASSERT_EQ(0, ci_workflow_required_jobs(wf, generated, 1, required), "'!' patterns exclude");
+
+    const char* lint_change[] = { "src/tool.py" };
+    count = ci_workflow_required_jobs(wf, lint_change, 1, required);
+    TEST_ASSERT(count == 4 && lint && required[lint - wf->jobs] && !required[web - wf->jobs],
+                "lint, deploy after it, and deploy's needs build and integration");
+
+    const char* self[] = { ".github/workflows/main.yml" };
+    TEST_ASSERT_EQ(5, ci_workflow_required_jobs(wf, self, 1, required), "Editing the workflow runs every job");
+
+    ci_workflow_destroy(wf);
+}
+
+void run_ci_parser_tests(void) {
+    test_run("ci_workflow_parsing", test_ci_workflow_parsing);
+    test_run("ci_required_jobs", test_ci_required_jobs);
+}
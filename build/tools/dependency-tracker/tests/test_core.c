@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <unistd.h>
 #include "dependency_tracker.h"
 
 // Test helper functions
@@ -118,6 +119,44 @@ void test_language_detection(void) {
     TEST_ASSERT_EQ(LANG_UNKNOWN, lang, "Should return UNKNOWN for NULL input");
 }
 
+void test_language_classifier(void) {
+    TEST_ASSERT_EQ(0, language_classifier_verify(), "Every table entry sits in its hash slot");
+
+    TEST_ASSERT_EQ(LANG_DOCKER, deptrack_detect_language("build/orchestration/Dockerfile.llm"), "Dockerfile.* by name");
+    TEST_ASSERT_EQ(LANG_DOCKER, deptrack_detect_language("Dockerfile"), "Dockerfile");
+    TEST_ASSERT_EQ(LANG_KOTLIN, deptrack_detect_language("app/build.gradle.kts"), "Gradle Kotlin scripts");
+    TEST_ASSERT_EQ(LANG_KOTLIN, deptrack_detect_language("build.gradle"), "Groovy Gradle scripts");
+    TEST_ASSERT_EQ(LANG_YAML, deptrack_detect_language("build/orchestration/docker-compose.production.yml"),
+                   "Compose files");
+    TEST_ASSERT_EQ(LANG_MAKE, deptrack_detect_language("GNUmakefile"), "Make by name");
+    TEST_ASSERT_EQ(LANG_GO, deptrack_detect_language("services/api/go.mod"), "go.mod by name");
+    TEST_ASSERT_EQ(LANG_SHELL, deptrack_detect_language("home/.bashrc"), "Hidden shell startup files");
+    TEST_ASSERT_EQ(LANG_PYTHON, deptrack_detect_language("requirements-dev.txt"), "Requirement files");
+    TEST_ASSERT_EQ(LANG_UNKNOWN, deptrack_detect_language("notes.txt"), "Other text files");
+    TEST_ASSERT_EQ(LANG_UNKNOWN, deptrack_detect_language(".gitignore"), "A hidden file has no extension");
+    TEST_ASSERT_EQ(LANG_UNKNOWN, deptrack_detect_language("bin/deploy"), "No name, no extension, no content");
+
+    static const struct {
+        const char* head;
+        Language expected;
+    } sniffed[] = {
+        { "#!/bin/bash -e\nset -x\n", LANG_SHELL },
+        { "#!/usr/bin/env -S python3.11 -u\n", LANG_PYTHON },
+        { "#!/usr/bin/env node\n", LANG_TYPESCRIPT },
+        { "#!/usr/bin/make -f\n", LANG_MAKE },
+        { "#!/opt/custom/interpreter\n", LANG_UNKNOWN },
+        { "# helper\n# vim: set ft=sh ts=4:\n", LANG_SHELL },
+        { "# -*- mode: python; coding: utf-8 -*-\n", LANG_PYTHON },
+        { "// -*- javascript -*-\n", LANG_TYPESCRIPT },
+        { "soft=python is not a modeline\n", LANG_UNKNOWN },
+    };
+    for (size_t i = 0; i < sizeof(sniffed) / sizeof(sniffed[0]); i++) {
+        Language lang = language_classify("bin/tool", sniffed[i].head, strlen(sniffed[i].head));
+        TEST_ASSERT_EQ(sniffed[i].expected, lang, sniffed[i].head);
+    }
+    TEST_ASSERT_EQ(LANG_GO, language_classify("main.go", "#!/bin/sh\n", 10), "The name wins over the content");
+}
+
 void test_language_name_conversion(void) {
     const char* name;
     
@@ -208,6 +247,92 @@ void test_memory_management(void) {
     }
 }
 
+void test_config_file(void) {
+    static const char* json =
+        "{\n"
+        "  \"root_path\": \"./src\",\n"
+        "  \"jobs\": 3,\n"
+        "  \"pipeline\": { \"stage_threads\": [1, 2, 4], \"queue_size\": 64 },\n"
+        "  \"output\": { \"title\": \"caf\\u00e9 \\\"deps\\\"\", \"pretty\": true, \"template\": null }\n"
+        "}\n";
+    ConfigManager* config = config_manager_create();
+    TEST_ASSERT_NOT_NULL(config, "Config manager should be created");
+    if (!config) return;
+
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, config_manager_load_buffer(config, json, strlen(json)), "Valid JSON loads");
+    TEST_ASSERT_EQ(3, config_get_int(config, "jobs", 0), "Top-level number");
+    TEST_ASSERT_EQ(2, config_get_int(config, "pipeline.stage_threads.1", 0), "Array elements by index");
+    TEST_ASSERT_EQ(64, config_get_int(config, "pipeline.queue_size", 0), "Nested objects by dotted path");
+    TEST_ASSERT_STR_EQ("caf\xc3\xa9 \"deps\"", config_get_string(config, "output.title"), "Escapes decoded");
+    TEST_ASSERT_STR_EQ("true", config_get_string(config, "output.pretty"), "Booleans as written");
+    TEST_ASSERT_NULL(config_get_string(config, "output.template"), "null reads as absent");
+    TEST_ASSERT_EQ(7, config_get_int(config, "root_path", 7), "Non-numbers fall back");
+    TEST_ASSERT_EQ(7, config_get_int(config, "missing", 7), "Missing keys fall back");
+
+    const char* broken = "{ \"jobs\": 2, }";
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_CONFIG, config_manager_load_buffer(config, broken, strlen(broken)),
+                   "Trailing commas are rejected");
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_FILE_NOT_FOUND, config_manager_load(config, "/nonexistent/deptrack.json"),
+                   "Missing file");
+    config_manager_destroy(config);
+
+    char path[] = "/tmp/deptrack_config_XXXXXX";
+    int fd = mkstemp(path);
+    TEST_ASSERT(fd >= 0, "Temporary file should be created");
+    if (fd < 0) return;
+    FILE* file = fdopen(fd, "w");
+    if (file) {
+        fputs(json, file);
+        fclose(file);
+    }
+    DependencyTracker* tracker = deptrack_create();
+    if (tracker) {
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, deptrack_initialize(tracker, path), "Initialization reads the file");
+        TEST_ASSERT_EQ(3, tracker->jobs, "jobs sizes the pool");
+        TEST_ASSERT_EQ(64, tracker->pipeline.queue_capacity, "Pipeline settings are applied");
+        TEST_ASSERT_EQ(2, tracker->pipeline.threads[PIPELINE_READ], "Stage workers");
+        TEST_ASSERT_EQ(1, tracker->pipeline.threads[PIPELINE_MERGE], "Unlisted stages keep their default");
+        TEST_ASSERT_STR_EQ(path, config_manager_path(tracker->config), "The path is kept");
+        ThreadPool* pool = deptrack_thread_pool(tracker);
+        TEST_ASSERT(pool && thread_pool_size(pool) == 3, "The shared pool has jobs workers");
+        TEST_ASSERT(pool == deptrack_thread_pool(tracker), "One pool per tracker");
+        deptrack_destroy(tracker);
+    }
+
+    // Job and stage counts and queue sizes that would size the workers or queues from garbage are refused
+    const char* bad_counts[] = {
+        "\"stage_threads\": [1, 0]", "\"stage_threads\": [-1]", "\"stage_threads\": [1, 2, 100000]",
+        "\"stage_threads\": [4294967297]", "\"queue_size\": -1", "\"queue_size\": 0", "\"queue_size\": \"big\"",
+        "\"queue_size\": 2097152"
+    };
+    const char* bad_jobs[] = { "-1", "0", "100000", "\"many\"" };
+    for (size_t i = 0; i < sizeof(bad_counts) / sizeof(bad_counts[0]); i++) {
+        file = fopen(path, "w");
+        if (file) {
+            fprintf(file, "{ \"pipeline\": { %s } }\n", bad_counts[i]);
+            fclose(file);
+        }
+        tracker = deptrack_create();
+        if (tracker) {
+            TEST_ASSERT_EQ(DEPTRACK_ERROR_CONFIG, deptrack_initialize(tracker, path), bad_counts[i]);
+            deptrack_destroy(tracker);
+        }
+    }
+    for (size_t i = 0; i < sizeof(bad_jobs) / sizeof(bad_jobs[0]); i++) {
+        file = fopen(path, "w");
+        if (file) {
+            fprintf(file, "{ \"jobs\": %s }\n", bad_jobs[i]);
+            fclose(file);
+        }
+        tracker = deptrack_create();
+        if (tracker) {
+            TEST_ASSERT_EQ(DEPTRACK_ERROR_CONFIG, deptrack_initialize(tracker, path), bad_jobs[i]);
+            deptrack_destroy(tracker);
+        }
+    }
+    remove(path);
+}
+
 // Test runner for core tests
 void run_core_tests(void) {
     setup_test_environment();
@@ -217,11 +342,13 @@ void run_core_tests(void) {
     test_run("dependency_tracker_invalid_params", test_dependency_tracker_invalid_params);
     test_run("version_information", test_version_information);
     test_run("language_detection", test_language_detection);
+    test_run("language_classifier", test_language_classifier);
     test_run("language_name_conversion", test_language_name_conversion);
     test_run("dependency_type_names", test_dependency_type_names);
     test_run("error_handling", test_error_handling);
     test_run("thread_safety_basic", test_thread_safety_basic);
     test_run("memory_management", test_memory_management);
+    test_run("config_file", test_config_file);
     
     cleanup_test_environment();
 }
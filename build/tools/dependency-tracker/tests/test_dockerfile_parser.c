@@ -0,0 +1,184 @@
+/**
+ * @file test_dockerfile_parser.c
+ * @brief Dockerfile stage/reference parsing and image rebuild selection tests
+ */
+
+#include "dependency_tracker.h"
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const DockerReference* find_reference(const Dockerfile* df, DockerReferenceKind kind, const char* value) {
+    for (size_t i = 0; i < df->reference_count; i++) {
+        if (df->references[i].kind == kind && strcmp(df->references[i].value, value) == 0) return &df->references[i];
+    }
+    return NULL;
+}
+
+void test_dockerfile_parsing(void) {
+    static const char* text =
+        "# escape=\\\n"
+        "ARG PY=3.12\n"
+        "FROM --platform=linux/amd64 python:${PY}-slim AS base\n"
+        "WORKDIR /app\n"
+        "COPY build/requirements-core.txt /app/requirements-core.txt\n"
+        "RUN pip install --no-cache-dir -r requirements-core.txt && \\\n"
+        "    # pinned extras\n"
+        "    pip install torch==2.9.0 \"uvicorn[standard]>=0.30\" grpcio\n"
+        "COPY services/image-generation/ ./services/\n"
+        "ADD https://example.com/weights.tar.gz /tmp/\n"
+        "\n"
+        "FROM node:20 AS web\n"
+        "WORKDIR /web\n"
+        "COPY web/package.json web/package-lock.json ./\n"
+        "RUN npm ci\n"
+        "RUN npm install -g typescript@5.4 @grpc/grpc-js\n"
+        "\n"
+        "FROM base\n"
+        "ENV STATIC=/app/static\n"
+        "COPY --from=web /web/dist ${STATIC}\n"
+        "COPY --from=nginx:1.25 /etc/nginx/nginx.conf /etc/nginx/\n"
+        "COPY [\"config/app.yaml\", \"$STATIC/../config/\"]\n"
+        "RUN <<EOF\n"
+        "pip install requests==2.31\n"
+        "EOF\n";
+
+    Dockerfile* df = dockerfile_parse_buffer("build/ci/Dockerfile.app", ".", text, strlen(text));
+    TEST_ASSERT_NOT_NULL(df, "Dockerfile should parse");
+    if (!df) return;
+
+    TEST_ASSERT_EQ(3, df->stage_count, "Three FROM instructions");
+    if (df->stage_count == 3) {
+        TEST_ASSERT_STR_EQ("python:3.12-slim", df->stages[0].base, "Global ARG substituted into FROM");
+        TEST_ASSERT_STR_EQ("base", df->stages[0].name, "AS name");
+        TEST_ASSERT_EQ(-1, df->stages[1].base_stage, "node is an image");
+        TEST_ASSERT_EQ(0, df->stages[2].base_stage, "FROM base is a stage");
+        TEST_ASSERT_EQ(18, df->stages[2].line_number, "Stages record their line");
+    }
+
+    const DockerReference* ref = find_reference(df, DOCKER_REF_MANIFEST, "build/requirements-core.txt");
+    TEST_ASSERT(ref && ref->line_number == 6, "pip -r is traced back through COPY and WORKDIR");
+    ref = find_reference(df, DOCKER_REF_PIP, "torch");
+    TEST_ASSERT(ref && ref->version && strcmp(ref->version, "2.9.0") == 0, "Pinned pip package");
+    ref = find_reference(df, DOCKER_REF_PIP, "uvicorn");
+    TEST_ASSERT(ref && ref->version && strcmp(ref->version, ">=0.30") == 0, "Extras and ranges");
+    TEST_ASSERT_NOT_NULL(find_reference(df, DOCKER_REF_PIP, "grpcio"), "Comment lines inside continuations");
+    TEST_ASSERT_NOT_NULL(find_reference(df, DOCKER_REF_COPY, "services/image-generation"), "Directory COPY");
+    TEST_ASSERT_NULL(find_reference(df, DOCKER_REF_ADD, "https://example.com/weights.tar.gz"), "Remote ADD");
+
+    ref = find_reference(df, DOCKER_REF_MANIFEST, "web/package.json");
+    TEST_ASSERT(ref && ref->stage == 1, "npm ci uses the copied package.json, not the lock file");
+    ref = find_reference(df, DOCKER_REF_NPM, "@grpc/grpc-js");
+    TEST_ASSERT(ref && !ref->version, "Scoped npm package without version");
+    ref = find_reference(df, DOCKER_REF_NPM, "typescript");
+    TEST_ASSERT(ref && ref->version && strcmp(ref->version, "5.4") == 0, "npm name@version");
+
+    TEST_ASSERT_NULL(find_reference(df, DOCKER_REF_IMAGE, "web"), "COPY --from a stage is internal");
+    TEST_ASSERT_NOT_NULL(find_reference(df, DOCKER_REF_IMAGE, "nginx:1.25"), "COPY --from an image");
+    TEST_ASSERT_NOT_NULL(find_reference(df, DOCKER_REF_COPY, "config/app.yaml"), "Exec-form COPY");
+    ref = find_reference(df, DOCKER_REF_PIP, "requests");
+    TEST_ASSERT(ref && ref->line_number == 24, "RUN here-documents are scanned");
+
+    TEST_ASSERT(dockerfile_uses_path(df, "services/image-generation/app.py"), "Files under a copied directory");
+    TEST_ASSERT(dockerfile_uses_path(df, "./build/ci/Dockerfile.app"), "The Dockerfile itself");
+    TEST_ASSERT(!dockerfile_uses_path(df, "services/image-generation-v2/app.py"), "Prefix is per component");
+    TEST_ASSERT(!dockerfile_uses_path(df, "build/requirements-dev.txt"), "Uncopied files");
+    dockerfile_destroy(df);
+
+    static const char* escaped =
+        "# escape=`\n"
+        "FROM mcr.microsoft.com/windows/servercore:ltsc2022\n"
+        "COPY scripts/ `\n"
+        "     C:/scripts/\n";
+    df = dockerfile_parse_buffer("Dockerfile", NULL, escaped, strlen(escaped));
+    TEST_ASSERT(df && df->reference_count == 1 && strcmp(df->references[0].value, "scripts") == 0 &&
+                df->references[0].line_number == 3, "escape directive changes the continuation character");
+    dockerfile_destroy(df);
+
+    // A source longer than any path buffer is dropped, not recorded cut short
+    char long_text[MAX_PATH_LENGTH + 64];
+    int prefix = snprintf(long_text, sizeof(long_text), "FROM alpine:3.19\nCOPY ");
+    memset(long_text + prefix, 'a', MAX_PATH_LENGTH);
+    snprintf(long_text + prefix + MAX_PATH_LENGTH, sizeof(long_text) - (size_t)prefix - MAX_PATH_LENGTH,
+             " /app/\nCOPY ok.txt /app/\n");
+    df = dockerfile_parse_buffer("Dockerfile", ".", long_text, strlen(long_text));
+    TEST_ASSERT(df && df->reference_count == 1 && find_reference(df, DOCKER_REF_COPY, "ok.txt"),
+                "Only the COPY that fits is recorded");
+    dockerfile_destroy(df);
+}
+
+void test_docker_image_rebuild(void) {
+    char dir_template[] = "/tmp/deptrack_docker_XXXXXX";
+    char* dir = mkdtemp(dir_template);
+    TEST_ASSERT_NOT_NULL(dir, "Temporary directory should be created");
+    if (!dir) return;
+
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/build", dir);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/build/ci", dir);
+    mkdir(path, 0755);
+
+    write_fixture(dir, "Dockerfile", "FROM alpine:3.19\nCOPY docs /docs\n");
+    write_fixture(dir, "build/ci/Dockerfile.app",
+        "FROM python:3.12-slim\n"
+        "COPY build/requirements.txt /app/\n"
+        "COPY services/app/ /app/services/\n"
+        "RUN pip install -r /app/requirements.txt\n");
+    write_fixture(dir, "build/ci/Dockerfile.worker", "FROM unhinged/app\nCOPY run.sh /\n");
+    write_fixture(dir, "build/ci/docker-compose.app.yml",
+        "services:\n"
+        "  app:\n"
+        "    image: unhinged/app:latest\n"
+        "    build:\n"
+        "      context: ../..\n"
+        "      dockerfile: build/ci/Dockerfile.app\n");
+
+    DockerImageSet* set = docker_image_set_load(dir);
+    TEST_ASSERT(set && set->image_count == 3, "Every Dockerfile is an image");
+    if (set && set->image_count == 3) {
+        TEST_ASSERT_STR_EQ("Dockerfile", set->images[0].name, "Images without a service keep their path");
+        TEST_ASSERT_STR_EQ("unhinged/app:latest", set->images[1].name, "Compose image: names the image");
+        TEST_ASSERT_STR_EQ(".", set->images[1].dockerfile->context, "Compose context is used");
+        TEST_ASSERT_STR_EQ("build/ci", set->images[2].dockerfile->context, "Default context is the directory");
+
+        bool rebuild[3];
+        const char* service[] = { "services/app/main.py" };
+        TEST_ASSERT_EQ(2, docker_images_to_rebuild(set, service, 1, rebuild), "app and the worker built FROM it");
+        TEST_ASSERT(!rebuild[0] && rebuild[1] && rebuild[2], "Untagged FROM matches the latest tag");
+
+        const char* script[] = { "build/ci/run.sh" };
+        TEST_ASSERT(docker_images_to_rebuild(set, script, 1, rebuild) == 1 && rebuild[2], "Worker context file");
+        const char* requirements[] = { "build/requirements.txt" };
+        TEST_ASSERT_EQ(2, docker_images_to_rebuild(set, requirements, 1, rebuild), "Copied requirements");
+        const char* docs[] = { "docs/index.md", "README.md" };
+        TEST_ASSERT(docker_images_to_rebuild(set, docs, 2, rebuild) == 1 && rebuild[0], "Root image");
+        const char* none[] = { "README.md" };
+        TEST_ASSERT_EQ(0, docker_images_to_rebuild(set, none, 1, rebuild), "Unused files rebuild nothing");
+    }
+    docker_image_set_destroy(set);
+
+    snprintf(path, sizeof(path), "%s/build/ci/Dockerfile.app", dir);
+    ParsedFile* parsed = parse_dockerfile(path);
+    TEST_ASSERT(parsed && parsed->dep_count == 4, "Base image, two COPYs and the requirements file");
+    if (parsed && parsed->dep_count == 4) {
+        TEST_ASSERT_STR_EQ("python", parsed->dependencies[0].name, "Base image name");
+        TEST_ASSERT_STR_EQ("3.12-slim", parsed->dependencies[0].version, "Tag as version");
+        TEST_ASSERT_EQ(DEP_INTERNAL, parsed->dependencies[3].type, "Manifests are internal");
+    }
+    parsed_file_destroy(parsed);
+
+    const char* names[] = {
+        "Dockerfile", "build/ci/Dockerfile.app", "build/ci/Dockerfile.worker", "build/ci/docker-compose.app.yml",
+        "build/ci", "build", NULL
+    };
+    for (size_t i = 0; names[i]; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        remove(path);
+    }
+    rmdir(dir);
+}
+
+void run_dockerfile_parser_tests(void) {
+    test_run("dockerfile_parsing", test_dockerfile_parsing);
+    test_run("docker_image_rebuild", test_docker_image_rebuild);
+}
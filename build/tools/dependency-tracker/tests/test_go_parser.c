@@ -0,0 +1,124 @@
+/**
+ * @file test_go_parser.c
+ * @brief Go module and import parser tests
+ */
+
+#include "dependency_tracker.h"
+
+static const char* GO_MOD =
+    "module github.com/unhinged/service\n"
+    "\n"
+    "go 1.21\n"
+    "\n"
+    "require github.com/google/uuid v1.4.0\n"
+    "require (\n"
+    "    golang.org/x/net v0.19.0 // indirect\n"
+    "    google.golang.org/grpc v1.60.1\n"
+    "    \"github.com/quoted/mod\" v0.1.0\n"
+    ")\n"
+    "\n"
+    "replace github.com/old/lib v1.0.0 => ../lib\n"
+    "replace (\n"
+    "    golang.org/x/net => golang.org/x/net v0.20.0\n"
+    ")\n";
+
+static const Dependency* find_dependency(const ParsedFile* parsed, const char* name) {
+    for (size_t i = 0; i < parsed->dep_count; i++) {
+        if (strcmp(parsed->dependencies[i].name, name) == 0) return &parsed->dependencies[i];
+    }
+    return NULL;
+}
+
+void test_go_mod_parsing(void) {
+    GoModFile* mod = go_mod_parse_buffer(GO_MOD, strlen(GO_MOD));
+    TEST_ASSERT_NOT_NULL(mod, "go.mod should parse");
+    if (!mod) return;
+
+    TEST_ASSERT_STR_EQ("github.com/unhinged/service", mod->module_path, "Module path");
+    TEST_ASSERT_STR_EQ("1.21", mod->go_version, "Go version");
+    TEST_ASSERT_EQ(4, mod->require_count, "Single-line and block requires");
+    if (mod->require_count == 4) {
+        TEST_ASSERT(!mod->requires[0].indirect, "Direct requirement");
+        TEST_ASSERT(mod->requires[1].indirect && mod->requires[1].line_number == 7, "Indirect comment and line");
+        TEST_ASSERT_STR_EQ("github.com/quoted/mod", mod->requires[3].path, "Quoted paths are unquoted");
+    }
+
+    TEST_ASSERT_EQ(2, mod->replace_count, "Both replace forms");
+    if (mod->replace_count == 2) {
+        TEST_ASSERT(mod->replaces[0].old_version && strcmp(mod->replaces[0].old_version, "v1.0.0") == 0,
+                    "Versioned replace");
+        TEST_ASSERT_NULL(mod->replaces[0].new_version, "Directory replacement has no version");
+        TEST_ASSERT_STR_EQ("v0.20.0", mod->replaces[1].new_version, "Module replacement version");
+    }
+
+    const char* import = "google.golang.org/grpc/codes";
+    const GoRequire* req = go_mod_find_require(mod, import, strlen(import));
+    TEST_ASSERT(req && strcmp(req->version, "v1.60.1") == 0, "Packages map to their module");
+    import = "google.golang.org/grpcx";
+    TEST_ASSERT_NULL(go_mod_find_require(mod, import, strlen(import)), "Prefix must end on a path element");
+
+    static const char* go_sum =
+        "github.com/google/uuid v1.4.0 h1:abc=\n"
+        "github.com/google/uuid v1.4.0/go.mod h1:def=\n"
+        "golang.org/x/net v0.19.0/go.mod h1:ghi=\n";
+    GoSumFile* sum = go_sum_parse_buffer(go_sum, strlen(go_sum));
+    TEST_ASSERT_NOT_NULL(sum, "go.sum should parse");
+    if (sum) {
+        TEST_ASSERT(go_sum_has(sum, "github.com/google/uuid", "v1.4.0"), "Module hash present");
+        TEST_ASSERT(!go_sum_has(sum, "golang.org/x/net", "v0.19.0"), "go.mod-only hash is not a download");
+        TEST_ASSERT(!go_sum_has(sum, "google.golang.org/grpc", "v1.60.1"), "Missing module");
+        go_sum_destroy(sum);
+    }
+
+    static const char* go_sum_manifest =
+        "github.com/google/uuid v1.4.0/go.mod h1:def=\n"
+        "github.com/google/uuid v1.4.0 h1:abc=\n";
+    ParsedFile* parsed = parse_go_buffer("svc/go.sum", go_sum_manifest, strlen(go_sum_manifest));
+    TEST_ASSERT(parsed && parsed->dep_count == 1 && parsed->dependencies[0].line_number == 2,
+                "go.sum lists module downloads with their lines");
+    parsed_file_destroy(parsed);
+
+    go_mod_destroy(mod);
+}
+
+void test_go_import_parsing(void) {
+    static const char* source =
+        "// Package api serves requests\n"
+        "package api\n"
+        "\n"
+        "import \"fmt\"\n"
+        "import (\n"
+        "    \"net/http\"\n"
+        "    pb \"google.golang.org/grpc/codes\"\n"
+        "    _ \"github.com/unhinged/service/internal/db\"\n"
+        "    /* block */ . `github.com/google/uuid`\n"
+        ")\n"
+        "\n"
+        "func main() {\n"
+        "    _ = \"github.com/not/an/import\"\n"
+        "}\n";
+
+    GoModFile* mod = go_mod_parse_buffer(GO_MOD, strlen(GO_MOD));
+    ParsedFile* parsed = parse_go_source_buffer("api.go", source, strlen(source), mod);
+    TEST_ASSERT_NOT_NULL(parsed, "Go source should parse");
+    if (parsed) {
+        TEST_ASSERT_EQ(5, parsed->dep_count, "Imports stop at the first declaration");
+
+        const Dependency* dep = find_dependency(parsed, "fmt");
+        TEST_ASSERT(dep && strcmp(dep->version, "stdlib") == 0 && dep->line_number == 4, "Standard library");
+        dep = find_dependency(parsed, "google.golang.org/grpc/codes");
+        TEST_ASSERT(dep && dep->type == DEP_EXTERNAL && strcmp(dep->version, "v1.60.1") == 0,
+                    "Aliased import carries its module version");
+        dep = find_dependency(parsed, "github.com/unhinged/service/internal/db");
+        TEST_ASSERT(dep && dep->type == DEP_INTERNAL, "Own module is internal");
+        dep = find_dependency(parsed, "github.com/google/uuid");
+        TEST_ASSERT(dep && dep->line_number == 9, "Raw string import after a comment");
+        parsed_file_destroy(parsed);
+    }
+    go_mod_destroy(mod);
+}
+
+void run_go_parser_tests(void) {
+    test_run("go_mod_parsing", test_go_mod_parsing);
+    test_run("go_import_parsing", test_go_import_parsing);
+}
@@ -12,8 +12,11 @@ void test_graph_creation(void) {
     if (graph) {
         TEST_ASSERT_EQ(0, graph->node_count, "New graph should have no nodes");
         TEST_ASSERT_EQ(0, graph->edge_count, "New graph should have no edges");
-        TEST_ASSERT_NOT_NULL(graph->nodes, "Nodes array should be allocated");
-        TEST_ASSERT_NOT_NULL(graph->edges, "Edges array should be allocated");
+        TEST_ASSERT(graph->node_type && graph->node_flags && graph->node_id, "Hot node columns should be allocated");
+        TEST_ASSERT(graph->edge_from && graph->edge_to && graph->edge_type && graph->edge_version,
+                    "Edge columns should be allocated");
+        TEST_ASSERT(!graph->node_name && !graph->node_filepath && !graph->node_dep_end,
+                    "Cold columns wait for their first value");
         
         graph_destroy(graph);
     }
@@ -30,21 +33,20 @@ void test_node_operations(void) {
             .type = NODE_SERVICE,
             .filepath = "/test/path",
             .dependencies = NULL,
-            .dep_count = 0,
-            .metadata = NULL
+            .dep_count = 0
         };
         
         int result = graph_add_node(graph, &node);
         TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Adding node should succeed");
         TEST_ASSERT_EQ(1, graph->node_count, "Graph should have one node");
         
-        GraphNode* found = graph_find_node(graph, "test-node");
-        TEST_ASSERT_NOT_NULL(found, "Should find added node");
+        size_t found = graph_find_node(graph, "test-node");
+        TEST_ASSERT(found != GRAPH_NO_NODE, "Should find added node");
         
-        if (found) {
-            TEST_ASSERT_STR_EQ("test-node", found->id, "Node ID should match");
-            TEST_ASSERT_STR_EQ("Test Node", found->name, "Node name should match");
-            TEST_ASSERT_EQ(NODE_SERVICE, found->type, "Node type should match");
+        if (found != GRAPH_NO_NODE) {
+            TEST_ASSERT_STR_EQ("test-node", graph_node_id(graph, found), "Node ID should match");
+            TEST_ASSERT_STR_EQ("Test Node", graph_node_name(graph, found), "Node name should match");
+            TEST_ASSERT_EQ(NODE_SERVICE, graph->node_type[found], "Node type should match");
         }
         
         graph_destroy(graph);
@@ -68,8 +70,7 @@ void test_edge_operations(void) {
             .from_id = "node1",
             .to_id = "node2",
             .type = DEP_INTERNAL,
-            .version_constraint = ">=1.0.0",
-            .metadata = NULL
+            .version_constraint = ">=1.0.0"
         };
         
         int result = graph_add_edge(graph, &edge);
@@ -80,8 +81,536 @@ void test_edge_operations(void) {
     }
 }
 
+void test_string_pool(void) {
+    StringPool* pool = string_pool_create();
+    TEST_ASSERT_NOT_NULL(pool, "Pool creation should succeed");
+    if (!pool) return;
+
+    StringHandle a, b, again, none;
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, string_pool_intern(pool, "react", &a), "First string");
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, string_pool_intern(pool, "", &b), "Empty string");
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, string_pool_intern(pool, "react", &again), "Repeat");
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, string_pool_intern(pool, NULL, &none), "NULL");
+    TEST_ASSERT(a == 0 && b == 1 && again == a && none == STRING_NONE, "Handles count distinct strings");
+    TEST_ASSERT_EQ(2, string_pool_count(pool), "Two strings stored");
+    TEST_ASSERT_STR_EQ("", string_pool_get(pool, b), "Empty is not missing");
+    TEST_ASSERT_NULL(string_pool_get(pool, STRING_NONE), "STRING_NONE reads as NULL");
+    TEST_ASSERT_EQ(STRING_NONE, string_pool_find(pool, "vue"), "Find does not intern");
+
+    // Enough to move the buffer several times; handles still resolve
+    char text[32];
+    bool stable = true;
+    for (size_t i = 0; i < 5000; i++) {
+        snprintf(text, sizeof(text), "module-%zu", i);
+        StringHandle handle;
+        stable = stable && string_pool_intern(pool, text, &handle) == DEPTRACK_SUCCESS && handle == i + 2;
+    }
+    stable = stable && strcmp(string_pool_get(pool, 2 + 4321), "module-4321") == 0 &&
+             strcmp(string_pool_get(pool, a), "react") == 0;
+    TEST_ASSERT(stable, "Handles survive growth");
+    string_pool_destroy(pool);
+}
+
+void test_graph_columns(void) {
+    DependencyGraph* graph = graph_create();
+    TEST_ASSERT_NOT_NULL(graph, "Graph creation should succeed");
+    if (!graph) return;
+
+    // An external dependency has neither path nor list, so only hot columns and names are touched
+    GraphNode react = { .id = "react", .name = "react", .type = NODE_LIBRARY };
+    graph_add_node(graph, &react);
+    TEST_ASSERT(graph->node_name && !graph->node_filepath && !graph->node_dep_end, "Cold columns appear on use");
+    TEST_ASSERT_EQ(1, string_pool_count(graph->strings), "A name equal to the id shares its handle");
+
+    char* deps[] = { "react", "./util" };
+    GraphNode app = { .id = "web/app.ts", .name = "app.ts", .type = NODE_SERVICE, .filepath = "/repo/web/app.ts",
+                      .dependencies = deps, .dep_count = 2 };
+    GraphNode util = { .id = "./util", .type = NODE_LIBRARY, .filepath = "/repo/web/util.ts" };
+    GraphNode config = { .id = "config.yml", .type = NODE_CONFIG, .filepath = "/repo/config.yml" };
+    graph_add_node(graph, &app);
+    graph_add_node(graph, &util);
+    graph_add_node(graph, &config);
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, graph_add_node(graph, &react), "Duplicate ids are rejected");
+
+    size_t app_index = graph_find_node(graph, "web/app.ts");
+    size_t util_index = graph_find_node(graph, "./util");
+    TEST_ASSERT_EQ(2, graph_node_dependency_count(graph, app_index), "Dependency list");
+    TEST_ASSERT_STR_EQ("./util", graph_node_dependency(graph, app_index, 1), "Dependencies keep their order");
+    TEST_ASSERT_EQ(0, graph_node_dependency_count(graph, 0), "Nodes before the first list have none");
+    TEST_ASSERT_EQ(0, graph_node_dependency_count(graph, util_index), "Nodes after it have none either");
+    TEST_ASSERT_NULL(graph_node_name(graph, util_index), "Missing names stay NULL");
+    TEST_ASSERT_NULL(graph_node_filepath(graph, 0), "Rows before a cold column existed are empty");
+    TEST_ASSERT_STR_EQ("/repo/config.yml", graph_node_filepath(graph, 3), "Paths");
+    TEST_ASSERT_EQ(GRAPH_NO_NODE, graph_find_node(graph, "app.ts"), "Names are not ids");
+    TEST_ASSERT_NULL(graph_node_id(graph, 4), "Out of range nodes");
+
+    GraphEdge edges[] = {
+        { "web/app.ts", "react", DEP_EXTERNAL, "^18.2.0", NULL, 0 },
+        { "web/app.ts", "./util", DEP_INTERNAL, NULL, NULL, 0 },
+        { "./util", "config.yml", DEP_CONFIG, NULL, NULL, 0 },
+        { "./util", "react", DEP_EXTERNAL, "^18.2.0", NULL, 0 }
+    };
+    for (size_t i = 0; i < 4; i++) graph_add_edge(graph, &edges[i]);
+    GraphEdge dangling = { "web/app.ts", "vue", DEP_EXTERNAL, NULL, NULL, 0 };
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, graph_add_edge(graph, &dangling), "Both ends must exist");
+    TEST_ASSERT(graph->edge_from[1] == app_index && graph->edge_to[1] == util_index, "Edges hold node indices");
+    TEST_ASSERT_EQ(graph->edge_version[0], graph->edge_version[3], "Equal versions share a handle");
+    TEST_ASSERT_NULL(graph_edge_version(graph, 1), "Missing versions stay NULL");
+
+    size_t out[8];
+    size_t count = graph_filter_nodes(graph, 1u << NODE_LIBRARY, 0, out);
+    TEST_ASSERT(count == 2 && out[0] == 0 && out[1] == util_index, "Filter by type");
+    count = graph_filter_nodes(graph, UINT32_MAX, GRAPH_NODE_FILE | GRAPH_NODE_HAS_DEPENDENTS, out);
+    TEST_ASSERT(count == 2 && out[0] == util_index && out[1] == 3, "Filter by flags: analyzed and depended on");
+    count = graph_filter_nodes(graph, UINT32_MAX, GRAPH_NODE_HAS_DEPENDENCIES, out);
+    TEST_ASSERT(count == 2 && out[0] == app_index && out[1] == util_index, "Sources of edges");
+    count = graph_filter_edges(graph, (1u << DEP_EXTERNAL) | (1u << DEP_CONFIG), out);
+    TEST_ASSERT(count == 3 && out[0] == 0 && out[1] == 2 && out[2] == 3, "Filter edges by type");
+    graph_destroy(graph);
+}
+
+void test_graph_cycles(void) {
+    DependencyGraph* graph = graph_create();
+    TEST_ASSERT_NOT_NULL(graph, "Graph creation should succeed");
+    if (!graph) return;
+
+    char id[16], to[16];
+    for (size_t i = 0; i < 1000; i++) {
+        snprintf(id, sizeof(id), "m%zu", i);
+        GraphNode node = { .id = id, .type = NODE_LIBRARY };
+        graph_add_node(graph, &node);
+    }
+    TEST_ASSERT_EQ(0, graph_detect_cycles(graph), "No edges, no cycle");
+    // A diamond-rich DAG: every node depends on a few later ones
+    for (size_t i = 0; i < 1000; i++) {
+        for (size_t k = 1; k <= 3 && i + k * 7 < 1000; k++) {
+            snprintf(id, sizeof(id), "m%zu", i);
+            snprintf(to, sizeof(to), "m%zu", i + k * 7);
+            GraphEdge edge = { id, to, DEP_INTERNAL, NULL, NULL, 0 };
+            graph_add_edge(graph, &edge);
+        }
+    }
+    TEST_ASSERT_EQ(0, graph_detect_cycles(graph), "Acyclic");
+
+    GraphEdge back = { "m990", "m500", DEP_INTERNAL, NULL, NULL, 0 };
+    graph_add_edge(graph, &back);
+    TEST_ASSERT_EQ(1, graph_detect_cycles(graph), "A back edge closes a cycle");
+    graph_destroy(graph);
+
+    graph = graph_create();
+    GraphNode self = { .id = "self", .type = NODE_LIBRARY };
+    GraphEdge loop = { "self", "self", DEP_INTERNAL, NULL, NULL, 0 };
+    graph_add_node(graph, &self);
+    graph_add_edge(graph, &loop);
+    TEST_ASSERT_EQ(1, graph_detect_cycles(graph), "Self loops are cycles");
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, graph_detect_cycles(NULL), "NULL graph");
+    graph_destroy(graph);
+}
+
+#define BULK_TEST_FILES 2000
+#define BULK_TEST_DEPS 8
+
+void test_graph_bulk(void) {
+    DependencyGraph* bulk = graph_create();
+    DependencyGraph* single = graph_create();
+    TEST_ASSERT(bulk && single, "Setup");
+    if (!bulk || !single) {
+        graph_destroy(bulk);
+        graph_destroy(single);
+        return;
+    }
+
+    // A batch may repeat ids and name ids already present; both resolve to the existing node
+    GraphNode seed = { .id = "react", .name = "react", .type = NODE_LIBRARY };
+    graph_add_node(bulk, &seed);
+    GraphNode batch[] = {
+        { .id = "web/app.ts", .name = "app.ts", .type = NODE_SERVICE, .filepath = "/repo/web/app.ts" },
+        { .id = "react", .name = "other", .type = NODE_CONFIG },
+        { .id = "lodash", .name = "lodash", .type = NODE_LIBRARY },
+        { .id = "lodash", .name = "lodash", .type = NODE_LIBRARY }
+    };
+    size_t handles[4];
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_add_nodes_bulk(bulk, batch, 4, handles), "Bulk nodes");
+    TEST_ASSERT_EQ(3, bulk->node_count, "Duplicates are not added");
+    TEST_ASSERT(handles[0] == 1 && handles[1] == 0 && handles[2] == 2 && handles[3] == 2,
+                "Handles of new and existing nodes");
+    TEST_ASSERT_STR_EQ("react", graph_node_name(bulk, 0), "The existing node is kept as it was");
+
+    GraphBulkEdge edges[] = {
+        { handles[0], handles[1], DEP_EXTERNAL, "^18.2.0", NULL, 0 },
+        { handles[0], handles[2], DEP_EXTERNAL, NULL, NULL, 0 }
+    };
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_add_edges_bulk(bulk, edges, 2), "Bulk edges");
+    TEST_ASSERT(bulk->edge_count == 2 && bulk->edge_to[0] == 0 && strcmp(graph_edge_version(bulk, 0), "^18.2.0") == 0,
+                "Edges by handle");
+    TEST_ASSERT(bulk->node_flags[1] & GRAPH_NODE_HAS_DEPENDENCIES, "Flags follow bulk edges");
+    GraphBulkEdge bad[] = { { 0, 1, DEP_INTERNAL, NULL, NULL, 0 }, { 0, 3, DEP_INTERNAL, NULL, NULL, 0 } };
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, graph_add_edges_bulk(bulk, bad, 2), "Unknown handles");
+    TEST_ASSERT_EQ(2, bulk->edge_count, "A refused batch adds nothing");
+    GraphNode unnamed = { .name = "no id" };
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, graph_add_nodes_bulk(bulk, &unnamed, 1, NULL), "Nodes need ids");
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_add_nodes_bulk(bulk, NULL, 0, NULL), "Empty batches");
+    graph_destroy(bulk);
+
+    // Batches the way the pipeline merges files build the same graph as one call per node and edge
+    bulk = graph_create();
+    GraphNode nodes[BULK_TEST_DEPS + 1];
+    GraphBulkEdge file_edges[BULK_TEST_DEPS];
+    size_t file_handles[BULK_TEST_DEPS + 1];
+    char ids[BULK_TEST_DEPS + 1][32];
+    bool built = bulk != NULL;
+    for (size_t f = 0; built && f < BULK_TEST_FILES; f++) {
+        snprintf(ids[0], sizeof(ids[0]), "src/file%zu.c", f);
+        nodes[0] = (GraphNode){ .id = ids[0], .name = ids[0], .type = NODE_LIBRARY, .filepath = ids[0] };
+        for (size_t d = 0; d < BULK_TEST_DEPS; d++) {
+            snprintf(ids[d + 1], sizeof(ids[d + 1]), "lib%zu", (f * 7 + d * 13) % 300);
+            nodes[d + 1] = (GraphNode){ .id = ids[d + 1], .name = ids[d + 1], .type = NODE_LIBRARY };
+        }
+        built = graph_add_nodes_bulk(bulk, nodes, BULK_TEST_DEPS + 1, file_handles) == DEPTRACK_SUCCESS;
+        for (size_t d = 0; d < BULK_TEST_DEPS; d++) {
+            file_edges[d] = (GraphBulkEdge){ file_handles[0], file_handles[d + 1], DEP_EXTERNAL,
+                                             d % 2 ? "1.0" : NULL, ids[0], (int)d + 1 };
+            graph_add_node(single, &nodes[d + 1]);
+        }
+        built = built && graph_add_edges_bulk(bulk, file_edges, BULK_TEST_DEPS) == DEPTRACK_SUCCESS;
+        graph_add_node(single, &nodes[0]);
+        for (size_t d = 0; d < BULK_TEST_DEPS; d++) {
+            GraphEdge edge = { ids[0], ids[d + 1], DEP_EXTERNAL, d % 2 ? "1.0" : NULL, NULL, 0 };
+            graph_add_edge(single, &edge);
+        }
+    }
+    TEST_ASSERT(built, "Every batch is added");
+    bool same = built && bulk->node_count == single->node_count && bulk->edge_count == single->edge_count &&
+                bulk->node_count == BULK_TEST_FILES + 300;
+    for (size_t e = 0; same && e < bulk->edge_count; e++) {
+        same = strcmp(graph_node_id(bulk, bulk->edge_from[e]), graph_node_id(single, single->edge_from[e])) == 0 &&
+               strcmp(graph_node_id(bulk, bulk->edge_to[e]), graph_node_id(single, single->edge_to[e])) == 0 &&
+               bulk->edge_type[e] == single->edge_type[e] &&
+               (graph_edge_version(bulk, e) == NULL) == (graph_edge_version(single, e) == NULL);
+    }
+    for (size_t n = 0; same && n < bulk->node_count; n++) {
+        size_t other = graph_find_node(single, graph_node_id(bulk, n));
+        same = other != GRAPH_NO_NODE && bulk->node_flags[n] == single->node_flags[other];
+    }
+    TEST_ASSERT(same, "Bulk and single adds build the same graph");
+    graph_destroy(bulk);
+    graph_destroy(single);
+}
+
+#define DEDUP_TEST_IMPORTS 40
+
+void test_graph_edge_dedup(void) {
+    DependencyGraph* graph = graph_create();
+    TEST_ASSERT_NOT_NULL(graph, "Graph creation should succeed");
+    if (!graph) return;
+
+    GraphNode app = { .id = "web", .type = NODE_SERVICE };
+    GraphNode lodash = { .id = "lodash", .type = NODE_LIBRARY };
+    graph_add_node(graph, &app);
+    graph_add_node(graph, &lodash);
+
+    // Every file of a package importing the same module is one package-level edge
+    char file[32];
+    const char* versions[] = { "^4.17.0", "^4.1.0", NULL };
+    bool added = true;
+    for (size_t i = 0; i < DEDUP_TEST_IMPORTS; i++) {
+        snprintf(file, sizeof(file), "web/src/file%zu.ts", i / 2);
+        GraphEdge edge = { "web", "lodash", DEP_EXTERNAL, (char*)versions[i % 3], file, (int)i + 1 };
+        added = added && graph_add_edge(graph, &edge) == DEPTRACK_SUCCESS;
+    }
+    TEST_ASSERT(added, "Repeated edges are accepted");
+    TEST_ASSERT_EQ(1, graph->edge_count, "Stored once");
+    TEST_ASSERT_EQ(DEDUP_TEST_IMPORTS, graph->edge_occurrences[0], "Every add is counted");
+    TEST_ASSERT_STR_EQ("^4.1.0", graph_edge_version(graph, 0), "The smallest version is kept");
+    TEST_ASSERT_EQ(0, graph_find_edge(graph, 0, 1, DEP_EXTERNAL), "Find by key");
+    TEST_ASSERT_EQ(SIZE_MAX, graph_find_edge(graph, 1, 0, DEP_EXTERNAL), "Direction is part of the key");
+    TEST_ASSERT_EQ(SIZE_MAX, graph_find_edge(graph, 0, 7, DEP_EXTERNAL), "Unknown nodes");
+
+    GraphLocation locations[DEDUP_TEST_IMPORTS];
+    TEST_ASSERT_EQ(DEDUP_TEST_IMPORTS, graph_edge_locations(graph, 0, locations, DEDUP_TEST_IMPORTS),
+                   "One location per add");
+    bool in_order = true;
+    for (size_t i = 0; i < DEDUP_TEST_IMPORTS; i++) {
+        snprintf(file, sizeof(file), "web/src/file%zu.ts", i / 2);
+        in_order = in_order && locations[i].line == i + 1 && strcmp(locations[i].file, file) == 0;
+    }
+    TEST_ASSERT(in_order, "Locations keep their insertion order");
+    TEST_ASSERT(locations[0].file == locations[1].file, "File names are interned");
+    TEST_ASSERT_EQ(DEDUP_TEST_IMPORTS, graph_edge_locations(graph, 0, locations, 3), "Count past capacity");
+
+    // Another type is another edge; edges without a source file record no location
+    GraphEdge runtime = { "web", "lodash", DEP_RUNTIME, "^4.0.0", NULL, 0 };
+    graph_add_edge(graph, &runtime);
+    TEST_ASSERT_EQ(2, graph->edge_count, "Types are kept apart");
+    TEST_ASSERT_EQ(0, graph_edge_locations(graph, 1, locations, DEDUP_TEST_IMPORTS), "No location");
+    graph_destroy(graph);
+
+    graph = graph_create();
+    graph_add_node(graph, &app);
+    graph_add_node(graph, &lodash);
+    graph_add_edge(graph, &runtime);
+    TEST_ASSERT_NULL(graph->edge_location_first, "The location columns wait for the first location");
+
+    // Repeats inside one batch merge as well, whatever their order
+    GraphBulkEdge batch[] = {
+        { 0, 1, DEP_RUNTIME, "^4.1.0", "web/a.ts", 3 },
+        { 0, 1, DEP_RUNTIME, NULL, "web/b.ts", 9 },
+        { 1, 0, DEP_RUNTIME, NULL, "lib/c.ts", 1 }
+    };
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_add_edges_bulk(graph, batch, 3), "Bulk repeats");
+    TEST_ASSERT(graph->edge_count == 2 && graph->edge_occurrences[0] == 3 && graph->edge_occurrences[1] == 1,
+                "Bulk adds merge into existing edges");
+    TEST_ASSERT_STR_EQ("^4.0.0", graph_edge_version(graph, 0), "Versions merge the same way");
+    TEST_ASSERT(graph_edge_locations(graph, 0, locations, 2) == 2 && locations[1].line == 9,
+                "Located repeats of an unlocated edge");
+    graph_destroy(graph);
+}
+
+#define ATTRIBUTE_TEST_NODES 5000
+
+void test_graph_attributes(void) {
+    DependencyGraph* graph = graph_create();
+    TEST_ASSERT_NOT_NULL(graph, "Graph creation should succeed");
+    if (!graph) return;
+
+    char id[32];
+    for (size_t i = 0; i < ATTRIBUTE_TEST_NODES; i++) {
+        snprintf(id, sizeof(id), "src/file%zu.c", i);
+        GraphNode node = { .id = id, .type = NODE_LIBRARY };
+        graph_add_node(graph, &node);
+    }
+    GraphEdge edge = { "src/file0.c", "src/file1.c", DEP_INTERNAL, NULL, NULL, 0 };
+    graph_add_edge(graph, &edge);
+
+    size_t loc, build_time, owner, platforms, weight;
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_attribute_define(graph, ATTRIBUTE_NODE, "loc", ATTRIBUTE_INT, &loc),
+                   "Int attribute");
+    graph_attribute_define(graph, ATTRIBUTE_NODE, "build_time", ATTRIBUTE_FLOAT, &build_time);
+    graph_attribute_define(graph, ATTRIBUTE_NODE, "owner", ATTRIBUTE_STRING, &owner);
+    graph_attribute_define(graph, ATTRIBUTE_NODE, "platforms", ATTRIBUTE_BITSET, &platforms);
+    graph_attribute_define(graph, ATTRIBUTE_EDGE, "loc", ATTRIBUTE_FLOAT, &weight);
+    TEST_ASSERT(weight != loc, "Node and edge attributes have separate names");
+    size_t again = GRAPH_NO_ATTRIBUTE;
+    TEST_ASSERT(graph_attribute_define(graph, ATTRIBUTE_NODE, "loc", ATTRIBUTE_INT, &again) == DEPTRACK_SUCCESS &&
+                again == loc, "Defining twice returns the same attribute");
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM,
+                   graph_attribute_define(graph, ATTRIBUTE_NODE, "loc", ATTRIBUTE_STRING, &again), "Types are fixed");
+    TEST_ASSERT_EQ(owner, graph_attribute_find(graph, ATTRIBUTE_NODE, "owner"), "Find by name");
+    TEST_ASSERT_EQ(GRAPH_NO_ATTRIBUTE, graph_attribute_find(graph, ATTRIBUTE_EDGE, "owner"), "Scoped names");
+    TEST_ASSERT_NULL(graph->attributes[loc].values, "Columns wait for their first value");
+
+    // Every node at once, then a few by row
+    int64_t* counts = malloc(ATTRIBUTE_TEST_NODES * sizeof(int64_t));
+    size_t* rows = malloc(ATTRIBUTE_TEST_NODES * sizeof(size_t));
+    if (!counts || !rows) {
+        free(counts);
+        free(rows);
+        graph_destroy(graph);
+        return;
+    }
+    int64_t expected_sum = 0;
+    for (size_t i = 0; i < ATTRIBUTE_TEST_NODES; i++) {
+        counts[i] = (int64_t)(i % 500);
+        expected_sum += counts[i];
+    }
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_attribute_set_ints(graph, loc, NULL, counts, ATTRIBUTE_TEST_NODES),
+                   "Bulk set over every node");
+    TEST_ASSERT(graph_attribute_sum(graph, loc) == (double)expected_sum, "Sum over the column");
+    size_t kept = graph_attribute_filter_ints(graph, loc, 490, 499, rows);
+    TEST_ASSERT(kept == 100 && rows[0] == 490 && rows[99] == 4999, "Range filter");
+
+    size_t picked[] = { 7, 3, 4999 };
+    const char* owners[] = { "@web", "@infra", "@web" };
+    double times[] = { 1.5, 2.25, 4.0 };
+    uint64_t bits[] = { 0x1, 0x6, 0x0 };
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_attribute_set_strings(graph, owner, picked, owners, 3), "Strings by row");
+    graph_attribute_set_floats(graph, build_time, picked, times, 3);
+    graph_attribute_set_bits(graph, platforms, picked, bits, 3);
+
+    size_t query[] = { 3, 4, 7, 4999, 123456 };
+    const char* names[5];
+    double seconds[5];
+    uint64_t sets[5];
+    int64_t lines[5];
+    TEST_ASSERT_EQ(3, graph_attribute_get_strings(graph, owner, query, names, 5), "Three owners set");
+    TEST_ASSERT(names[0] && strcmp(names[0], "@infra") == 0 && !names[1] && names[2] == names[3] && !names[4],
+                "Equal strings are interned once; unset and out of range rows are NULL");
+    TEST_ASSERT_EQ(3, graph_attribute_get_floats(graph, build_time, query, seconds, 5), "Floats");
+    TEST_ASSERT(seconds[0] == 2.25 && seconds[1] == 0.0 && seconds[3] == 4.0, "Float values");
+    TEST_ASSERT(graph_attribute_sum(graph, build_time) == 7.75, "Float sum");
+    TEST_ASSERT_EQ(2, graph_attribute_get_bits(graph, platforms, query, sets, 5), "Empty sets are unset");
+    TEST_ASSERT(sets[0] == 0x6 && sets[2] == 0x1, "Bit values");
+    kept = graph_attribute_filter_bits(graph, platforms, 0x4, rows);
+    TEST_ASSERT(kept == 1 && rows[0] == 3, "Mask filter");
+    TEST_ASSERT_EQ(4, graph_attribute_get_ints(graph, loc, query, lines, 5), "Ints of existing rows");
+    TEST_ASSERT(lines[2] == 7 && lines[3] == 499 && lines[4] == 0, "Int values");
+    TEST_ASSERT_EQ(0, graph_attribute_get_ints(graph, owner, query, lines, 5), "Wrong type reads nothing");
+
+    // Failed calls leave columns unchanged
+    size_t bad[] = { 1, ATTRIBUTE_TEST_NODES };
+    int64_t values[] = { 42, 42 };
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, graph_attribute_set_ints(graph, loc, bad, values, 2),
+                   "Rows past the node count");
+    TEST_ASSERT(graph_attribute_get_ints(graph, loc, bad, lines, 1) == 1 && lines[0] == 1, "Nothing was written");
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, graph_attribute_set_floats(graph, loc, NULL, times, 1),
+                   "Type mismatch");
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, graph_attribute_set_floats(graph, weight, NULL, times, 2),
+                   "Edge attributes are bounded by the edge count");
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_attribute_set_floats(graph, weight, NULL, times, 1), "One edge");
+    const char* unset[] = { NULL };
+    graph_attribute_set_strings(graph, owner, picked, unset, 1);
+    TEST_ASSERT_EQ(0, graph_attribute_get_strings(graph, owner, picked, names, 1), "A NULL string unsets");
+
+    // Attributes on nodes added later
+    GraphNode late = { .id = "late.c", .type = NODE_LIBRARY };
+    graph_add_node(graph, &late);
+    size_t late_row = graph_find_node(graph, "late.c");
+    int64_t late_loc = 12;
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_attribute_set_ints(graph, loc, &late_row, &late_loc, 1), "New rows");
+    TEST_ASSERT(graph_attribute_sum(graph, loc) == (double)(expected_sum + 12), "Sum covers new rows");
+    free(counts);
+    free(rows);
+    graph_destroy(graph);
+}
+
+#define SORT_TEST_NODES 12000
+#define SORT_TEST_EDGES 40000
+#define SORT_TEST_REPEATS (SORT_TEST_EDGES / 4)
+
+static uint32_t next_random(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+// Same nodes and edges, inserted in an order that depends on seed
+static DependencyGraph* build_shuffled_graph(uint32_t seed) {
+    DependencyGraph* graph = graph_create();
+    if (!graph) return NULL;
+    size_t* perm = malloc((SORT_TEST_EDGES + SORT_TEST_REPEATS) * sizeof(size_t));
+    if (!perm) {
+        graph_destroy(graph);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < SORT_TEST_NODES; i++) perm[i] = i;
+    for (size_t i = SORT_TEST_NODES; i > 1; i--) {
+        size_t j = next_random(&seed) % i;
+        size_t t = perm[i - 1]; perm[i - 1] = perm[j]; perm[j] = t;
+    }
+    char id[32];
+    for (size_t i = 0; i < SORT_TEST_NODES; i++) {
+        snprintf(id, sizeof(id), "pkg/%zu", perm[i] * 7919 % SORT_TEST_NODES);
+        GraphNode node = { .id = id, .name = id, .type = NODE_LIBRARY };
+        graph_add_node(graph, &node);
+    }
+
+    for (size_t i = 0; i < SORT_TEST_EDGES + SORT_TEST_REPEATS; i++) perm[i] = i;
+    for (size_t i = SORT_TEST_EDGES + SORT_TEST_REPEATS; i > 1; i--) {
+        size_t j = next_random(&seed) % i;
+        size_t t = perm[i - 1]; perm[i - 1] = perm[j]; perm[j] = t;
+    }
+    char from[32], to[32], version[16];
+    for (size_t i = 0; i < SORT_TEST_EDGES + SORT_TEST_REPEATS; i++) {
+        // Past SORT_TEST_EDGES, every fourth edge again with its own version: it merges into the first
+        bool repeat = perm[i] >= SORT_TEST_EDGES;
+        size_t e = repeat ? (perm[i] - SORT_TEST_EDGES) * 4 + 3 : perm[i];
+        snprintf(from, sizeof(from), "pkg/%zu", (e % SORT_TEST_NODES) * 7919 % SORT_TEST_NODES);
+        snprintf(to, sizeof(to), "pkg/%zu", e * 97 % SORT_TEST_NODES);
+        snprintf(version, sizeof(version), "^%zu.0", e % 2);
+        GraphEdge edge = {
+            .from_id = from,
+            .to_id = to,
+            .type = (DependencyType)(e / SORT_TEST_NODES),
+            .version_constraint = repeat ? "^0.5" : e % 4 == 3 ? NULL : version
+        };
+        graph_add_edge(graph, &edge);
+    }
+    free(perm);
+    return graph;
+}
+
+static int compare_edges(const DependencyGraph* ga, size_t a, const DependencyGraph* gb, size_t b) {
+    int c = strcmp(graph_node_id(ga, ga->edge_from[a]), graph_node_id(gb, gb->edge_from[b]));
+    if (c == 0) c = strcmp(graph_node_id(ga, ga->edge_to[a]), graph_node_id(gb, gb->edge_to[b]));
+    if (c == 0) c = (int)ga->edge_type[a] - (int)gb->edge_type[b];
+    const char* va = graph_edge_version(ga, a);
+    const char* vb = graph_edge_version(gb, b);
+    if (c == 0 && (!va || !vb)) {
+        c = (va != NULL) - (vb != NULL);
+    } else if (c == 0) {
+        c = strcmp(va, vb);
+    }
+    return c;
+}
+
+void test_graph_sort(void) {
+    DependencyGraph* graphs[2] = { build_shuffled_graph(1), build_shuffled_graph(2) };
+    ThreadPool* pools[3] = { NULL, thread_pool_create(1), thread_pool_create(4) };
+    TEST_ASSERT(graphs[0] && graphs[1] && pools[1] && pools[2], "Setup");
+    if (graphs[0] && graphs[1] && pools[1] && pools[2]) {
+        TEST_ASSERT_EQ(SORT_TEST_EDGES, graphs[0]->edge_count, "Every edge was added");
+        GraphOrder reference;
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_sort(graphs[0], NULL, &reference), "Serial sort");
+
+        bool ordered = reference.node_count == SORT_TEST_NODES && reference.edge_count == SORT_TEST_EDGES;
+        for (size_t i = 1; ordered && i < reference.node_count; i++) {
+            ordered = strcmp(graph_node_id(graphs[0], reference.nodes[i - 1]),
+                             graph_node_id(graphs[0], reference.nodes[i])) < 0;
+        }
+        TEST_ASSERT(ordered, "Nodes ascend by id");
+        ordered = true;
+        for (size_t i = 1; ordered && i < reference.edge_count; i++) {
+            ordered = compare_edges(graphs[0], reference.edges[i - 1], graphs[0], reference.edges[i]) < 0;
+        }
+        TEST_ASSERT(ordered, "Edges strictly ascend by (from, to, type)");
+        size_t occurrences = 0;
+        for (size_t i = 0; i < graphs[0]->edge_count; i++) occurrences += graphs[0]->edge_occurrences[i];
+        TEST_ASSERT_EQ(SORT_TEST_EDGES + SORT_TEST_REPEATS, occurrences, "Repeats are counted, not stored");
+
+        // Any insertion order and any pool produce the same sequence of contents
+        bool identical = true;
+        for (size_t g = 0; g < 2; g++) {
+            for (size_t p = 0; p < 3; p++) {
+                GraphOrder order;
+                if (graph_sort(graphs[g], pools[p], &order) != DEPTRACK_SUCCESS) {
+                    identical = false;
+                    continue;
+                }
+                for (size_t i = 0; identical && i < order.node_count; i++) {
+                    identical = strcmp(graph_node_id(graphs[g], order.nodes[i]),
+                                       graph_node_id(graphs[0], reference.nodes[i])) == 0;
+                }
+                for (size_t i = 0; identical && i < order.edge_count; i++) {
+                    identical = compare_edges(graphs[g], order.edges[i], graphs[0], reference.edges[i]) == 0;
+                }
+                graph_order_destroy(&order);
+            }
+        }
+        TEST_ASSERT(identical, "Order is independent of insertion order and thread count");
+        graph_order_destroy(&reference);
+    }
+
+    DependencyGraph* empty = graph_create();
+    GraphOrder order;
+    TEST_ASSERT(empty && graph_sort(empty, pools[2], &order) == DEPTRACK_SUCCESS && order.node_count == 0 &&
+                order.edge_count == 0, "Empty graph");
+    graph_order_destroy(&order);
+    graph_destroy(empty);
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, graph_sort(NULL, NULL, &order), "NULL graph");
+
+    for (size_t i = 0; i < 2; i++) graph_destroy(graphs[i]);
+    for (size_t i = 1; i < 3; i++) thread_pool_destroy(pools[i]);
+}
+
 void run_graph_tests(void) {
     test_run("graph_creation", test_graph_creation);
     test_run("node_operations", test_node_operations);
     test_run("edge_operations", test_edge_operations);
+    test_run("string_pool", test_string_pool);
+    test_run("graph_columns", test_graph_columns);
+    test_run("graph_cycles", test_graph_cycles);
+    test_run("graph_attributes", test_graph_attributes);
+    test_run("graph_bulk", test_graph_bulk);
+    test_run("graph_edge_dedup", test_graph_edge_dedup);
+    test_run("graph_sort", test_graph_sort);
 }
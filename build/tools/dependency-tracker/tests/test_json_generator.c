@@ -0,0 +1,264 @@
+/**
+ * @file test_json_generator.c
+ * @brief Streaming JSON output tests
+ */
+
+#include "dependency_tracker.h"
+#include <unistd.h>
+
+#define JSON_TEST_NODES 5000
+
+// Renders the graph through a temporary file; the caller frees the text
+static char* render(const DependencyGraph* graph, const JsonOutputOptions* options, size_t* length) {
+    char path[] = "/tmp/deptrack_json_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return NULL;
+    int result = json_generate(graph, fd, options);
+    close(fd);
+    char* text = result == DEPTRACK_SUCCESS ? parser_read_file(path, length) : NULL;
+    remove(path);
+    return text;
+}
+
+static void add_edge(DependencyGraph* graph, const char* from, const char* to, DependencyType type,
+                     const char* version) {
+    GraphEdge edge = { (char*)from, (char*)to, type, (char*)version, NULL, 0 };
+    graph_add_edge(graph, &edge);
+}
+
+void test_json_escape_scan(void) {
+    const SimdIsa isas[] = { SIMD_ISA_SCALAR, SIMD_ISA_SSE42, SIMD_ISA_AVX2 };
+    const char specials[] = { '"', '\\', '\n', '\x01', '\x1f', (char)0x80, (char)0xc3, (char)0xff };
+    char text[160];
+
+    bool found = true;
+    for (size_t i = 0; i < 3; i++) {
+        memset(text, 'a', sizeof(text));
+        text[10] = '\x7f';
+        text[11] = ' ';
+        found = found && json_escape_scan(text, sizeof(text), isas[i]) == sizeof(text);
+        for (size_t s = 0; s < sizeof(specials); s++) {
+            // Every position, so each vector width meets the byte in its body and in the scalar tail
+            for (size_t at = 0; at < sizeof(text); at++) {
+                text[at] = specials[s];
+                found = found && json_escape_scan(text, sizeof(text), isas[i]) == at;
+                found = found && json_escape_scan(text, at, isas[i]) == at;
+                text[at] = 'a';
+            }
+        }
+    }
+    TEST_ASSERT(found, "Every instruction set finds the first byte to escape and nothing else");
+    TEST_ASSERT_EQ(0, json_escape_scan(NULL, 4, SIMD_ISA_AVX2), "NULL text");
+}
+
+void test_json_write_string(void) {
+    char* text = NULL;
+    size_t length = 0;
+    FILE* out = open_memstream(&text, &length);
+    TEST_ASSERT_NOT_NULL(out, "Memory stream should open");
+    if (!out) return;
+    json_write_string(out, "web \"api\"\\\n\x01");
+    fputc(' ', out);
+    json_write_string(out, NULL);
+    fclose(out);
+    TEST_ASSERT_STR_EQ("\"web \\\"api\\\"\\\\\\n\\u0001\" null", text, "Quotes, backslashes and control bytes");
+    free(text);
+
+    // Well-formed sequences pass through; stray continuations, overlong forms, surrogates, code points past
+    // U+10FFFF and sequences cut short each lose their first byte to U+FFFD
+    static const struct {
+        const char* input;
+        const char* expected;
+    } utf8[] = {
+        { "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80", "\"caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80\"" },
+        { "a\x80z", "\"a\\ufffdz\"" },
+        { "\xc0\xaf", "\"\\ufffd\\ufffd\"" },
+        { "\xed\xa0\x80", "\"\\ufffd\\ufffd\\ufffd\"" },
+        { "\xf4\x90\x80\x80", "\"\\ufffd\\ufffd\\ufffd\\ufffd\"" },
+        { "\xe2\x82", "\"\\ufffd\\ufffd\"" },
+        { "\xe2\x82z", "\"\\ufffd\\ufffdz\"" }
+    };
+    bool replaced = true;
+    for (size_t i = 0; i < sizeof(utf8) / sizeof(utf8[0]); i++) {
+        text = NULL;
+        out = open_memstream(&text, &length);
+        if (!out) return;
+        json_write_string(out, utf8[i].input);
+        fclose(out);
+        if (strcmp(text, utf8[i].expected) != 0) {
+            fprintf(stderr, "    %s for case %zu\n", text, i);
+            replaced = false;
+        }
+        free(text);
+    }
+    TEST_ASSERT(replaced, "Only well-formed UTF-8 is written as is");
+}
+
+void test_json_output(void) {
+    DependencyGraph* graph = graph_create();
+    TEST_ASSERT_NOT_NULL(graph, "Graph should be created");
+    if (!graph) return;
+
+    JsonOutputOptions options;
+    json_output_options_default(&options);
+    options.pretty = false;
+    size_t length;
+    char* text = render(graph, &options, &length);
+    TEST_ASSERT_STR_EQ("{\"generator\":\"deptrack " DEPTRACK_VERSION_STRING "\",\"root_path\":null,"
+                       "\"node_count\":0,\"edge_count\":0,\"nodes\":[],\"edges\":[]}\n",
+                       text ? text : "", "Empty graph, compact");
+    free(text);
+
+    GraphNode app = { "web/app.ts", "app.ts", NODE_LIBRARY, "/repo/web/app.ts", NULL, 0 };
+    GraphNode odd = { "say \"hi\"\\\n\x01", "odd", NODE_CONFIG, NULL, NULL, 0 };
+    GraphNode react = { "react", "react", NODE_LIBRARY, NULL, NULL, 0 };
+    graph_add_node(graph, &odd);
+    graph_add_node(graph, &app);
+    graph_add_node(graph, &react);
+    add_edge(graph, "web/app.ts", "say \"hi\"\\\n\x01", DEP_CONFIG, NULL);
+    add_edge(graph, "web/app.ts", "react", DEP_EXTERNAL, "^18.2.0");
+
+    options.root_path = "/repo";
+    text = render(graph, &options, &length);
+    TEST_ASSERT_STR_EQ("{\"generator\":\"deptrack " DEPTRACK_VERSION_STRING "\",\"root_path\":\"/repo\","
+                       "\"node_count\":3,\"edge_count\":2,\"nodes\":["
+                       "{\"id\":\"react\",\"name\":\"react\",\"type\":\"library\","
+                       "\"filepath\":null,\"dependencies\":[]},"
+                       "{\"id\":\"say \\\"hi\\\"\\\\\\n\\u0001\",\"name\":\"odd\",\"type\":\"config\","
+                       "\"filepath\":null,\"dependencies\":[]},"
+                       "{\"id\":\"web/app.ts\",\"name\":\"app.ts\",\"type\":\"library\","
+                       "\"filepath\":\"/repo/web/app.ts\",\"dependencies\":[]}],\"edges\":["
+                       "{\"from\":\"web/app.ts\",\"to\":\"react\",\"type\":\"external\",\"version\":\"^18.2.0\","
+                       "\"occurrences\":1},"
+                       "{\"from\":\"web/app.ts\",\"to\":\"say \\\"hi\\\"\\\\\\n\\u0001\",\"type\":\"config\","
+                       "\"version\":null,\"occurrences\":1}]}\n",
+                       text ? text : "", "Sorted, escaped and compact");
+    free(text);
+
+    // A node that lists its dependencies in place
+    char* deps[] = { "react", "odd" };
+    GraphNode main_node = { "web/main.ts", "main.ts", NODE_LIBRARY, "/repo/web/main.ts", deps, 2 };
+    graph_add_node(graph, &main_node);
+    options.pretty = true;
+    text = render(graph, &options, &length);
+    TEST_ASSERT(text && strstr(text, "\n  \"nodes\": [\n    {\n      \"id\": "), "Pretty output indents two spaces");
+    TEST_ASSERT(text && strstr(text, "\"dependencies\": [\n        \"react\",\n        \"odd\"\n      ]"),
+                "Node dependencies are listed in place");
+    TEST_ASSERT(text && strstr(text, "\"dependencies\": []"), "Empty arrays stay on one line");
+
+    // Pretty and compact hold the same values
+    ConfigManager* parsed = config_manager_create();
+    if (parsed && text) {
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, config_manager_load_buffer(parsed, text, length), "Pretty output is valid JSON");
+        TEST_ASSERT_STR_EQ("say \"hi\"\\\n\x01", config_get_string(parsed, "nodes.1.id"), "Escapes round-trip");
+        TEST_ASSERT_STR_EQ("odd", config_get_string(parsed, "nodes.3.dependencies.1"), "Dependencies round-trip");
+        TEST_ASSERT_NULL(config_get_string(parsed, "edges.1.version"), "Missing versions are null");
+    }
+    config_manager_destroy(parsed);
+    free(text);
+
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, json_generate(NULL, 1, NULL), "NULL graph");
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_OUTPUT, json_generate_file(graph, "/nonexistent/deptrack/out.json", NULL),
+                   "Unwritable paths are reported");
+    graph_destroy(graph);
+}
+
+// Every thousandth node carries long_name, odd nodes a name just long enough to be written in place
+static DependencyGraph* build_large_graph(unsigned seed, const char* long_name, const char* medium_name) {
+    DependencyGraph* graph = graph_create();
+    size_t* order = malloc(JSON_TEST_NODES * sizeof(size_t));
+    if (!graph || !order) {
+        graph_destroy(graph);
+        free(order);
+        return NULL;
+    }
+    for (size_t i = 0; i < JSON_TEST_NODES; i++) order[i] = i;
+    srand(seed);
+    for (size_t i = JSON_TEST_NODES - 1; i > 0; i--) {
+        size_t j = (size_t)rand() % (i + 1);
+        size_t swap = order[i];
+        order[i] = order[j];
+        order[j] = swap;
+    }
+    for (size_t i = 0; i < JSON_TEST_NODES; i++) {
+        char id[32];
+        snprintf(id, sizeof(id), "pkg/%05zu", order[i]);
+        const char* name = order[i] % 1000 == 0 ? long_name : order[i] % 2 ? medium_name : id;
+        GraphNode node = { id, (char*)name, NODE_LIBRARY, NULL, NULL, 0 };
+        graph_add_node(graph, &node);
+    }
+    for (size_t i = 0; i < JSON_TEST_NODES; i++) {
+        char id[32];
+        char to[32];
+        snprintf(id, sizeof(id), "pkg/%05zu", order[i]);
+        snprintf(to, sizeof(to), "pkg/%05zu", (order[i] * 31 + 7) % JSON_TEST_NODES);
+        add_edge(graph, id, to, DEP_INTERNAL, order[i] % 1000 == 0 ? long_name : NULL);
+    }
+    free(order);
+    return graph;
+}
+
+void test_json_large_output(void) {
+    // Long enough to be written in place, with an escape in the middle and a tail past the last vector
+    size_t long_length = 300000;
+    char* long_name = malloc(long_length + 1);
+    TEST_ASSERT_NOT_NULL(long_name, "Setup");
+    if (!long_name) return;
+    for (size_t i = 0; i < long_length; i++) long_name[i] = (char)('a' + i % 26);
+    long_name[long_length / 2] = '"';
+    long_name[long_length] = '\0';
+    char medium_name[301];
+    memset(medium_name, 'm', sizeof(medium_name) - 1);
+    medium_name[sizeof(medium_name) - 1] = '\0';
+
+    DependencyGraph* graphs[2] = { build_large_graph(3, long_name, medium_name),
+                                   build_large_graph(4, long_name, medium_name) };
+    ThreadPool* pool = thread_pool_create(4);
+    TEST_ASSERT(graphs[0] && graphs[1] && pool, "Setup");
+    if (graphs[0] && graphs[1] && pool) {
+        JsonOutputOptions options;
+        json_output_options_default(&options);
+        size_t reference_length = 0;
+        char* reference = render(graphs[0], &options, &reference_length);
+        TEST_ASSERT_NOT_NULL(reference, "Large graph is written");
+        TEST_ASSERT(reference_length > 2 * 1024 * 1024, "Output spans many buffer flushes");
+
+        // Insertion order, thread count and instruction set leave the bytes unchanged
+        bool identical = reference != NULL;
+        for (size_t g = 0; identical && g < 2; g++) {
+            for (SimdIsa isa = SIMD_ISA_SCALAR; identical && isa <= SIMD_ISA_AVX2; isa++) {
+                options.pool = g ? pool : NULL;
+                options.max_isa = isa;
+                size_t length = 0;
+                char* text = render(graphs[g], &options, &length);
+                identical = text && length == reference_length && memcmp(text, reference, length) == 0;
+                free(text);
+            }
+        }
+        TEST_ASSERT(identical, "Output is byte-identical across insertion orders, pools and instruction sets");
+
+        ConfigManager* parsed = config_manager_create();
+        if (parsed && reference) {
+            TEST_ASSERT_EQ(DEPTRACK_SUCCESS, config_manager_load_buffer(parsed, reference, reference_length),
+                           "Large output is valid JSON");
+            TEST_ASSERT_STR_EQ("pkg/04999", config_get_string(parsed, "nodes.4999.id"), "Nodes in id order");
+            TEST_ASSERT_STR_EQ(long_name, config_get_string(parsed, "nodes.0.name"), "Long strings round-trip");
+            TEST_ASSERT_STR_EQ(long_name, config_get_string(parsed, "edges.0.version"), "Long versions round-trip");
+            TEST_ASSERT_STR_EQ(medium_name, config_get_string(parsed, "nodes.1.name"), "Strings written in place");
+            TEST_ASSERT_NULL(config_get_string(parsed, "edges.1.version"), "Null versions");
+        }
+        config_manager_destroy(parsed);
+        free(reference);
+    }
+    graph_destroy(graphs[0]);
+    graph_destroy(graphs[1]);
+    thread_pool_destroy(pool);
+    free(long_name);
+}
+
+void run_json_generator_tests(void) {
+    test_run("json_escape_scan", test_json_escape_scan);
+    test_run("json_write_string", test_json_write_string);
+    test_run("json_output", test_json_output);
+    test_run("json_large_output", test_json_large_output);
+}
@@ -5,14 +5,119 @@
 
 #include "dependency_tracker.h"
 
+static const Dependency* find_dependency(const ParsedFile* parsed, const char* name) {
+    for (size_t i = 0; i < parsed->dep_count; i++) {
+        if (strcmp(parsed->dependencies[i].name, name) == 0) {
+            return &parsed->dependencies[i];
+        }
+    }
+    return NULL;
+}
+
+static const char* GRADLE_FIXTURE =
+    "plugins {\n"
+    "    kotlin(\"jvm\") version \"1.9.22\"\n"
+    "    id(\"org.springframework.boot\") version \"3.2.0\"\n"
+    "    alias(libs.plugins.ktlint)\n"
+    "}\n"
+    "\n"
+    "val implementationNotADependency = \"implementation(\\\"fake:fake:1\\\")\"\n"
+    "\n"
+    "dependencies {\n"
+    "    implementation(platform(\"org.springframework.boot:spring-boot-dependencies:3.2.0\"))\n"
+    "    implementation(\n"
+    "        \"io.ktor:ktor-server-core:2.3.7\"\n"
+    "    )\n"
+    "    api(\"com.google.guava:guava:32.1.3-jre\") {\n"
+    "        exclude(group = \"com.google.code.findbugs\")\n"
+    "    }\n"
+    "    // implementation(\"commented:out:1.0\")\n"
+    "    implementation(libs.kotlinx.coroutines.core)\n"
+    "    implementation(project(\":shared\"))\n"
+    "    testImplementation(kotlin(\"test\"))\n"
+    "    testImplementation(group = \"io.mockk\", name = \"mockk\", version = \"1.13.8\")\n"
+    "    kapt(\"com.google.dagger:dagger-compiler:2.50\")\n"
+    "    runtimeOnly(\"org.postgresql:postgresql\")\n"
+    "}\n";
+
 void test_kotlin_gradle_parsing(void) {
-    // TODO: Implement Kotlin Gradle parsing tests
-    TEST_ASSERT(true, "Kotlin Gradle parsing test placeholder");
+    ParsedFile* parsed = parse_gradle_buffer("build.gradle.kts", GRADLE_FIXTURE, strlen(GRADLE_FIXTURE));
+    TEST_ASSERT_NOT_NULL(parsed, "Gradle buffer should parse");
+    if (!parsed) return;
+
+    TEST_ASSERT_EQ(12, parsed->dep_count, "Plugins and dependencies, excluding strings, comments and excludes");
+
+    const Dependency* dep = find_dependency(parsed, "io.ktor:ktor-server-core");
+    TEST_ASSERT_NOT_NULL(dep, "Multi-line implementation() should be found");
+    if (dep) {
+        TEST_ASSERT_STR_EQ("2.3.7", dep->version, "Version should be split from the coordinate");
+        TEST_ASSERT_EQ(12, dep->line_number, "Line of the coordinate string should be reported");
+        TEST_ASSERT_EQ(DEP_EXTERNAL, dep->type, "Library dependency should be external");
+    }
+
+    dep = find_dependency(parsed, "org.springframework.boot:spring-boot-dependencies");
+    TEST_ASSERT(dep && strcmp(dep->version, "3.2.0") == 0, "platform() BOM should be unwrapped");
+
+    dep = find_dependency(parsed, "libs.kotlinx.coroutines.core");
+    TEST_ASSERT(dep && strcmp(dep->version, "catalog") == 0, "Catalog accessor should be kept for resolution");
+
+    dep = find_dependency(parsed, ":shared");
+    TEST_ASSERT(dep && dep->type == DEP_INTERNAL, "project() should be internal");
+
+    dep = find_dependency(parsed, "org.jetbrains.kotlin:kotlin-test");
+    TEST_ASSERT(dep && dep->type == DEP_BUILD_TOOL, "kotlin() shorthand should expand");
+
+    dep = find_dependency(parsed, "io.mockk:mockk");
+    TEST_ASSERT(dep && strcmp(dep->version, "1.13.8") == 0, "Named arguments should be read");
+
+    dep = find_dependency(parsed, "com.google.dagger:dagger-compiler");
+    TEST_ASSERT(dep && dep->type == DEP_BUILD_TOOL, "kapt dependencies are build tools");
+
+    dep = find_dependency(parsed, "org.postgresql:postgresql");
+    TEST_ASSERT(dep && strcmp(dep->version, "unknown") == 0, "Missing version should stay unknown");
+
+    dep = find_dependency(parsed, "org.jetbrains.kotlin:kotlin-jvm");
+    TEST_ASSERT(dep && strcmp(dep->version, "1.9.22") == 0, "kotlin() plugin version should be read");
+
+    TEST_ASSERT_NOT_NULL(find_dependency(parsed, "org.springframework.boot"), "id() plugin should be found");
+    TEST_ASSERT_NULL(find_dependency(parsed, "fake:fake"), "Strings outside dependencies are ignored");
+    TEST_ASSERT_NULL(find_dependency(parsed, "commented:out"), "Commented dependencies are ignored");
+    TEST_ASSERT_NULL(find_dependency(parsed, "com.google.code.findbugs"), "exclude() is not a dependency");
+
+    parsed_file_destroy(parsed);
 }
 
 void test_kotlin_import_parsing(void) {
-    // TODO: Implement Kotlin import parsing tests
-    TEST_ASSERT(true, "Kotlin import parsing test placeholder");
+    static const char* source =
+        "/* Copyright /* nested */ header */\n"
+        "@file:JvmName(\"ChatKt\")\n"
+        "package com.unhinged.chat.api\n"
+        "\n"
+        "import com.unhinged.common.Envelope\n"
+        "import io.ktor.server.routing.*\n"
+        "import kotlinx.coroutines.flow.Flow as KFlow\n"
+        "import `java`.util.UUID\n"
+        "\n"
+        "class Chat {\n"
+        "    val s = \"import fake.Import\"\n"
+        "}\n"
+        "import after.declaration.Ignored\n";
+
+    ParsedFile* parsed = parse_kotlin_source_buffer("Chat.kt", source, strlen(source));
+    TEST_ASSERT_NOT_NULL(parsed, "Kotlin source should parse");
+    if (!parsed) return;
+
+    TEST_ASSERT_EQ(4, parsed->dep_count, "Only header imports should be collected");
+    if (parsed->dep_count == 4) {
+        TEST_ASSERT_STR_EQ("com.unhinged.common.Envelope", parsed->dependencies[0].name, "Import path should be extracted");
+        TEST_ASSERT_EQ(DEP_INTERNAL, parsed->dependencies[0].type, "Same-project import should be internal");
+        TEST_ASSERT_EQ(5, parsed->dependencies[0].line_number, "Import line should be tracked across comments");
+        TEST_ASSERT_STR_EQ("io.ktor.server.routing", parsed->dependencies[1].name, "Wildcard import names the package");
+        TEST_ASSERT_EQ(DEP_EXTERNAL, parsed->dependencies[1].type, "Third-party import should be external");
+        TEST_ASSERT_STR_EQ("kotlinx.coroutines.flow.Flow", parsed->dependencies[2].name, "Alias should be dropped");
+    }
+
+    parsed_file_destroy(parsed);
 }
 
 void run_kotlin_parser_tests(void) {
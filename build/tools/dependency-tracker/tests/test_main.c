@@ -68,10 +68,24 @@ void test_print_summary(void) {
 void run_core_tests(void);
 void run_parser_tests(void);
 void run_graph_tests(void);
+void run_pipeline_tests(void);
+void run_thread_pool_tests(void);
 void run_kotlin_parser_tests(void);
 void run_typescript_parser_tests(void);
 void run_python_parser_tests(void);
 void run_yaml_parser_tests(void);
+void run_proto_parser_tests(void);
+void run_toml_parser_tests(void);
+void run_go_parser_tests(void);
+void run_rust_parser_tests(void);
+void run_c_parser_tests(void);
+void run_makefile_parser_tests(void);
+void run_sql_parser_tests(void);
+void run_shell_parser_tests(void);
+void run_ci_parser_tests(void);
+void run_dockerfile_parser_tests(void);
+void run_json_generator_tests(void);
+void run_snapshot_tests(void);
 void run_integration_tests(void);
 void run_utils_tests(void);
 
@@ -86,10 +100,24 @@ static TestSuite test_suites[] = {
     {"Core Infrastructure", run_core_tests, true},
     {"Parser Framework", run_parser_tests, true},
     {"Graph Operations", run_graph_tests, true},
+    {"Thread Pool", run_thread_pool_tests, true},
+    {"Analysis Pipeline", run_pipeline_tests, true},
     {"Kotlin Parser", run_kotlin_parser_tests, true},
     {"TypeScript Parser", run_typescript_parser_tests, true},
     {"Python Parser", run_python_parser_tests, true},
     {"YAML Parser", run_yaml_parser_tests, true},
+    {"Proto Parser", run_proto_parser_tests, true},
+    {"TOML Parser", run_toml_parser_tests, true},
+    {"Go Parser", run_go_parser_tests, true},
+    {"Rust Parser", run_rust_parser_tests, true},
+    {"C Parser", run_c_parser_tests, true},
+    {"Makefile Parser", run_makefile_parser_tests, true},
+    {"SQL Parser", run_sql_parser_tests, true},
+    {"Shell Parser", run_shell_parser_tests, true},
+    {"CI Parser", run_ci_parser_tests, true},
+    {"Dockerfile Parser", run_dockerfile_parser_tests, true},
+    {"JSON Output", run_json_generator_tests, true},
+    {"Graph Snapshots", run_snapshot_tests, true},
     {"Integration Tests", run_integration_tests, true},
     {"Utility Functions", run_utils_tests, true},
     {NULL, NULL, false}
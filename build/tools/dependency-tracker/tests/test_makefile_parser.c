@@ -0,0 +1,159 @@
+/**
+ * @file test_makefile_parser.c
+ * @brief Makefile rule, recipe and target graph tests
+ */
+
+#include "dependency_tracker.h"
+
+static bool has_item(char** items, size_t count, const char* item) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(items[i], item) == 0) return true;
+    }
+    return false;
+}
+
+void test_makefile_rules(void) {
+    static const char* text =
+        "PYTHON := python3\n"
+        "PYTHON_RUN = $(PYTHON) -u\n"
+        "TOOLS ?= tools\n"
+        "TOOLS ?= ignored\n"
+        "FLAGS = -a\n"
+        "FLAGS += -b\n"
+        "export PROTO_DIR := proto\n"
+        "include config.mk\n"
+        "-include $(TOOLS)/local.mk\n"
+        "\n"
+        "define run_step\n"
+        "\t@echo \"step $(1)\"\n"
+        "\t$(PYTHON) $(TOOLS)/step.py $(1)\n"
+        "endef\n"
+        "\n"
+        ".PHONY: all build test clean\n"
+        "\n"
+        "all: build test ## Build and test everything\n"
+        "\n"
+        "build: gen | out-dir\n"
+        "\t@$(PYTHON_RUN) build/build.py --fast > build.log\n"
+        "\tcd scripts && ./install.sh --quiet\n"
+        "\t$(PROTO_DIR)/build-gateway.sh\n"
+        "\n"
+        "gen out-dir:\n"
+        "\tmkdir -p out\n"
+        "\n"
+        "test: build\n"
+        "\t$(call run_step,unit)\n"
+        "\t@$(MAKE) clean FOO=1\n"
+        "\tpython3 -m pytest tests\n"
+        "\n"
+        "ifeq ($(CI),true)\n"
+        "clean:\n"
+        "\trm -rf out \\\n"
+        "\t    build.log\n"
+        "else\n"
+        "clean: ; rm -rf out\n"
+        "endif\n"
+        "\n"
+        "deploy: CONFIG = prod\n"
+        ".SUFFIXES:\n";
+
+    Makefile* mf = makefile_parse_buffer(text, strlen(text));
+    TEST_ASSERT_NOT_NULL(mf, "Makefile should parse");
+    if (!mf) return;
+
+    char* value = makefile_expand(mf, NULL, "$(TOOLS) $(FLAGS) $$HOME");
+    TEST_ASSERT(value && strcmp(value, "tools -a -b $HOME") == 0, "?= keeps the first value and += appends");
+    free(value);
+
+    TEST_ASSERT_EQ(2, mf->include_count, "include and -include");
+    TEST_ASSERT(mf->include_count == 2 && strcmp(mf->includes[1], "tools/local.mk") == 0, "Include paths are expanded");
+
+    const MakeTarget* all = makefile_find_target(mf, "all");
+    TEST_ASSERT(all && all->phony && all->prerequisite_count == 2, "Phony aggregate target");
+    TEST_ASSERT(all && all->help && strcmp(all->help, "Build and test everything") == 0, "## help text");
+
+    const MakeTarget* build = makefile_find_target(mf, "build");
+    TEST_ASSERT(build && build->line_number == 20 && build->recipe_count == 3, "Recipe lines belong to the rule");
+    TEST_ASSERT(build && build->order_only_count == 1 && build->prerequisite_count == 1, "Order-only prerequisites");
+    if (build) {
+        TEST_ASSERT_EQ(3, build->script_count, "Interpreter, ./ and path scripts");
+        TEST_ASSERT(has_item(build->scripts, build->script_count, "build/build.py"), "Script through a variable");
+        TEST_ASSERT(has_item(build->scripts, build->script_count, "scripts/install.sh"), "cd prefixes the script");
+        TEST_ASSERT(has_item(build->scripts, build->script_count, "proto/build-gateway.sh"), "Expanded script path");
+    }
+
+    TEST_ASSERT(makefile_find_target(mf, "gen") && makefile_find_target(mf, "out-dir"), "Multiple targets per rule");
+
+    const MakeTarget* test = makefile_find_target(mf, "test");
+    TEST_ASSERT(test && test->call_count == 1 && strcmp(test->calls[0], "run_step") == 0, "$(call) macros are recorded");
+    TEST_ASSERT(test && has_item(test->scripts, test->script_count, "tools/step.py"), "Macro bodies are analyzed");
+    TEST_ASSERT(test && test->script_count == 1, "python -m runs a module, not a script");
+    TEST_ASSERT(test && test->invocation_count == 1 && strcmp(test->invocations[0], "clean") == 0,
+                "$(MAKE) target invocation without variable overrides");
+
+    const MakeTarget* clean = makefile_find_target(mf, "clean");
+    TEST_ASSERT(clean && clean->recipe_count == 2, "Both conditional branches are kept");
+
+    const MakeTarget* deploy = makefile_find_target(mf, "deploy");
+    TEST_ASSERT(deploy && deploy->prerequisite_count == 0, "Target-specific variables are not prerequisites");
+    TEST_ASSERT_NULL(makefile_find_target(mf, ".SUFFIXES"), "Special targets are skipped");
+    TEST_ASSERT_NULL(makefile_find_target(mf, ".PHONY"), ".PHONY is not a target");
+
+    makefile_destroy(mf);
+}
+
+void test_makefile_target_graph(void) {
+    static const char* text =
+        "all: package docs\n"
+        "package: compile\n"
+        "\tpython3 tools/package.py\n"
+        "\tpython3 tools/sign.py\n"
+        "compile: gen\n"
+        "\tcc -c main.c\n"
+        "gen: schema.json\n"
+        "\t./tools/gen.sh\n"
+        "docs:\n"
+        "\t$(MAKE) site\n"
+        "site:\n"
+        "\tnode tools/site.js\n";
+
+    Makefile* mf = makefile_parse_buffer(text, strlen(text));
+    TEST_ASSERT_NOT_NULL(mf, "Makefile should parse");
+    if (!mf) return;
+
+    DagSchedule schedule;
+    int result = makefile_schedule(mf, &schedule);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Target graph is acyclic");
+    if (result == DEPTRACK_SUCCESS) {
+        TEST_ASSERT_EQ(4, schedule.wave_count, "gen/site, compile/docs, package, all");
+        TEST_ASSERT_STR_EQ("all", mf->targets[schedule.critical_path[schedule.critical_path_length - 1]].name,
+                           "Critical path ends at the aggregate target");
+        TEST_ASSERT(schedule.critical_path_cost == 5.0, "Recipe lines weigh the critical path");
+        dag_schedule_destroy(&schedule);
+    }
+
+    bool affected[16] = { false };
+    const char* changed[] = { "./tools/gen.sh" };
+    size_t count = makefile_affected_targets(mf, changed, 1, affected);
+    TEST_ASSERT_EQ(4, count, "gen, compile, package and all");
+    const MakeTarget* docs = makefile_find_target(mf, "docs");
+    TEST_ASSERT(docs && !affected[docs - mf->targets], "docs does not depend on gen");
+
+    const char* schema[] = { "schema.json" };
+    memset(affected, 0, sizeof(affected));
+    TEST_ASSERT_EQ(4, makefile_affected_targets(mf, schema, 1, affected), "File prerequisites seed the walk");
+
+    const char* site_script[] = { "tools/site.js" };
+    count = makefile_affected_targets(mf, site_script, 1, affected);
+    TEST_ASSERT(count == 3 && affected[docs - mf->targets], "Sub-make invocations propagate");
+
+    makefile_destroy(mf);
+
+    TEST_ASSERT_EQ(LANG_MAKE, deptrack_detect_language("build/Makefile"), "Makefiles should be detected");
+    TEST_ASSERT_EQ(LANG_MAKE, deptrack_detect_language("rules/common.mk"), ".mk fragments should be detected");
+}
+
+void run_makefile_parser_tests(void) {
+    test_run("makefile_rules", test_makefile_rules);
+    test_run("makefile_target_graph", test_makefile_target_graph);
+}
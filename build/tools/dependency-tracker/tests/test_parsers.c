@@ -1,21 +1,304 @@
 /**
  * @file test_parsers.c
- * @brief Parser framework tests
+ * @brief Parser framework tests: registration, the shared keyword matcher, syntax masking and line index
  */
 
 #include "dependency_tracker.h"
 
+typedef struct {
+    KeywordMatch matches[64];
+    size_t count;
+    size_t total;
+    size_t checksum;
+} MatchLog;
+
+static int record_match(const KeywordMatch* match, void* context) {
+    MatchLog* log = context;
+    if (log->count < 64) log->matches[log->count++] = *match;
+    log->total++;
+    log->checksum = log->checksum * 31 + match->offset * 7 + match->keyword;
+    return DEPTRACK_SUCCESS;
+}
+
 void test_parser_registration(void) {
-    // TODO: Implement parser registration tests
-    TEST_ASSERT(true, "Parser registration test placeholder");
+    DependencyTracker* tracker = deptrack_create();
+    TEST_ASSERT_NOT_NULL(tracker, "Tracker should be created");
+    if (!tracker) return;
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, deptrack_initialize(tracker, NULL), "Tracker should initialize");
+
+    LanguageParser* parser = deptrack_get_parser(tracker, LANG_TYPESCRIPT);
+    TEST_ASSERT(parser && parser->language == LANG_TYPESCRIPT, "TypeScript parser is built in");
+    TEST_ASSERT(parser && parser->keyword_matcher && keyword_matcher_count(parser->keyword_matcher) == 3,
+                "Keyword matcher is built at registration");
+    parser = deptrack_get_parser(tracker, LANG_PROTO);
+    TEST_ASSERT(parser && parser->keyword_matcher && keyword_matcher_count(parser->keyword_matcher) == 1,
+                "So is the proto import scan");
+    TEST_ASSERT_NULL(deptrack_get_parser(tracker, LANG_GO), "Unregistered languages have no parser");
+
+    size_t before = tracker->parser_count;
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, deptrack_register_parser(tracker, typescript_parser_create()),
+                   "Re-registration replaces the parser");
+    TEST_ASSERT_EQ(before, tracker->parser_count, "Replacing does not add a slot");
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, deptrack_register_parser(tracker, NULL), "NULL parser is rejected");
+
+    deptrack_destroy(tracker);
 }
 
 void test_parser_detection(void) {
-    // TODO: Implement parser detection tests
-    TEST_ASSERT(true, "Parser detection test placeholder");
+    static const char* const keywords[] = { "he", "she", "his", "hers" };
+    KeywordMatcher* matcher = keyword_matcher_create(keywords, 4, 0);
+    TEST_ASSERT_NOT_NULL(matcher, "Matcher should build");
+    if (!matcher) return;
+
+    MatchLog log = { .count = 0 };
+    const char* text = "ushers";
+    keyword_matcher_scan(matcher, text, strlen(text), record_match, &log);
+    TEST_ASSERT_EQ(3, log.count, "Overlapping keywords: she, he, hers");
+    TEST_ASSERT(log.count == 3 && log.matches[0].keyword == 1 && log.matches[0].offset == 1 &&
+                log.matches[1].keyword == 0 && log.matches[1].offset == 2 &&
+                log.matches[2].keyword == 3 && log.matches[2].offset == 2, "Matches report keyword and offset");
+    keyword_matcher_destroy(matcher);
+
+    static const char* const words[] = { "import", "FROM" };
+    matcher = keyword_matcher_create(words, 2, KEYWORD_MATCH_WHOLE_WORD | KEYWORD_MATCH_IGNORE_CASE);
+    TEST_ASSERT_NOT_NULL(matcher, "Whole-word matcher should build");
+    if (!matcher) return;
+    log = (MatchLog){ .count = 0 };
+    text = "reimport Import x from y; $import from_ IMPORT";
+    keyword_matcher_scan(matcher, text, strlen(text), record_match, &log);
+    TEST_ASSERT_EQ(3, log.count, "Import, from and IMPORT only");
+    TEST_ASSERT(log.count == 3 && log.matches[0].offset == 9 && log.matches[1].keyword == 1,
+                "Case is folded and word boundaries respected");
+
+    // Every instruction set finds the same matches, including across block boundaries
+    size_t length = 100000;
+    char* big = malloc(length);
+    TEST_ASSERT_NOT_NULL(big, "Buffer should allocate");
+    if (big) {
+        unsigned seed = 12345;
+        for (size_t i = 0; i < length; i++) {
+            seed = seed * 1103515245 + 12345;
+            big[i] = " abcdefimortFROMxyz\n;_"[(seed >> 16) % 22];
+        }
+        for (size_t i = 7; i + 8 < length; i += 997) memcpy(big + i, " import ", 8);
+
+        MatchLog reference = { .count = 0 };
+        keyword_matcher_set_isa(matcher, SIMD_ISA_SCALAR);
+        keyword_matcher_scan(matcher, big, length, record_match, &reference);
+        TEST_ASSERT(reference.total > 50, "Fixture contains many keywords");
+
+        SimdIsa isas[] = { SIMD_ISA_SSE42, SIMD_ISA_AVX2 };
+        for (size_t k = 0; k < 2; k++) {
+            SimdIsa used = keyword_matcher_set_isa(matcher, isas[k]);
+            MatchLog other = { .count = 0 };
+            keyword_matcher_scan(matcher, big, length, record_match, &other);
+            TEST_ASSERT(other.total == reference.total && other.checksum == reference.checksum,
+                        simd_isa_name(used));
+        }
+        free(big);
+    }
+    keyword_matcher_destroy(matcher);
+
+    TEST_ASSERT_NULL(keyword_matcher_create(NULL, 0, 0), "Empty keyword sets are rejected");
+}
+
+static char* mask_string(const SyntaxMask* mask, size_t length) {
+    char* out = malloc(length + 1);
+    if (!out) return NULL;
+    for (size_t i = 0; i < length; i++) out[i] = syntax_mask_test(mask, i) ? 'x' : '.';
+    out[length] = '\0';
+    return out;
+}
+
+// Byte-at-a-time model of the masking rules; a delimiter after an odd run of backslashes is escaped
+static void reference_mask(const char* p, size_t n, unsigned rules, char* out) {
+    enum { CODE, LINE, BLOCK, STRING, TEMPLATE, TRIPLE } state = CODE;
+    char quote = 0;
+    for (size_t i = 0; i < n;) {
+        size_t backslashes = 0;
+        while (backslashes < i && p[i - backslashes - 1] == '\\') backslashes++;
+        bool escaped = backslashes % 2 == 1;
+        char c = p[i];
+        char next = i + 1 < n ? p[i + 1] : 0, next2 = i + 2 < n ? p[i + 2] : 0;
+        bool is_quote = !escaped && ((c == '\'' && (rules & SYNTAX_SINGLE_QUOTE)) ||
+                                     (c == '"' && (rules & SYNTAX_DOUBLE_QUOTE)));
+        bool is_newline = !escaped && c == '\n';
+        bool is_backtick = !escaped && c == '`' && (rules & SYNTAX_TEMPLATE);
+        size_t width = 1;
+        bool masked = true;
+        switch (state) {
+            case CODE:
+                if (c == '#' && (rules & SYNTAX_HASH_COMMENT)) {
+                    state = LINE;
+                } else if (c == '/' && next == '/' && (rules & SYNTAX_SLASH_COMMENT)) {
+                    state = LINE;
+                    width = 2;
+                } else if (c == '/' && next == '*' && (rules & SYNTAX_BLOCK_COMMENT)) {
+                    state = BLOCK;
+                    width = 2;
+                } else if (is_backtick) {
+                    state = TEMPLATE;
+                } else if (is_quote) {
+                    quote = c;
+                    state = STRING;
+                    if ((rules & SYNTAX_TRIPLE_QUOTE) && next == c && next2 == c) {
+                        state = TRIPLE;
+                        width = 3;
+                    }
+                }
+                masked = state != CODE;
+                break;
+            case LINE:
+                if (is_newline) {
+                    state = CODE;
+                    masked = false;
+                }
+                break;
+            case BLOCK:
+                if (c == '*' && next == '/') {
+                    state = CODE;
+                    width = 2;
+                }
+                break;
+            case STRING:
+                if (is_quote && c == quote) {
+                    state = CODE;
+                } else if (is_newline) {
+                    state = CODE;
+                    masked = false;
+                }
+                break;
+            case TEMPLATE:
+                if (is_backtick) state = CODE;
+                break;
+            case TRIPLE:
+                if (is_quote && c == quote && next == c && next2 == c) {
+                    state = CODE;
+                    width = 3;
+                }
+                break;
+        }
+        for (size_t j = 0; j < width && i < n; j++, i++) out[i] = masked ? 'x' : '.';
+    }
+    out[n] = '\0';
+}
+
+void test_syntax_masking(void) {
+    static const struct {
+        const char* text;
+        Language language;
+        const char* expected;
+    } cases[] = {
+        { "a 'b' \"c\" d", LANG_TYPESCRIPT, "..xxx.xxx.." },
+        { "x // 'y\nz /* q\n */ w", LANG_TYPESCRIPT, "..xxxxx...xxxxxxxx.." },
+        { "s = \"a\\\"b\" # c\nt", LANG_PYTHON, "....xxxxxx.xxx.." },
+        { "d = '''x\n'y'''\nimport z", LANG_PYTHON, "....xxxxxxxxxx........." },
+        { "`a\n${b}` + 'c", LANG_TYPESCRIPT, "xxxxxxxx...xx" },
+        { "'open\nnext", LANG_KOTLIN, "xxxxx....." },
+    };
+    for (size_t k = 0; k < sizeof(cases) / sizeof(cases[0]); k++) {
+        SyntaxMask mask;
+        size_t length = strlen(cases[k].text);
+        int result = syntax_mask_build(cases[k].text, length, syntax_rules_for_language(cases[k].language),
+                                       SIMD_ISA_AVX2, &mask);
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Mask should build");
+        if (result != DEPTRACK_SUCCESS) continue;
+        char* got = mask_string(&mask, length);
+        TEST_ASSERT_STR_EQ(cases[k].expected, got, cases[k].text);
+        free(got);
+        syntax_mask_destroy(&mask);
+    }
+
+    // Random text over the delimiter alphabet reaches every fast and slow path across block edges
+    static const char alphabet[] = "ab '\"`#/*\n\\";
+    const unsigned rule_sets[] = {
+        syntax_rules_for_language(LANG_TYPESCRIPT), syntax_rules_for_language(LANG_PYTHON),
+        syntax_rules_for_language(LANG_KOTLIN), SYNTAX_DOUBLE_QUOTE
+    };
+    size_t length = 5000;
+    char* text = malloc(length + 1);
+    char* expected = malloc(length + 1);
+    TEST_ASSERT(text && expected, "Buffers should allocate");
+    if (text && expected) {
+        unsigned seed = 42;
+        size_t mismatches = 0;
+        for (size_t round = 0; round < 40; round++) {
+            // Sparse rounds leave most blocks without delimiters
+            size_t filler = round % 2 ? 4 : 400;
+            for (size_t i = 0; i < length; i++) {
+                seed = seed * 1103515245 + 12345;
+                size_t pick = (seed >> 16) % (sizeof(alphabet) - 1 + filler);
+                text[i] = pick < sizeof(alphabet) - 1 ? alphabet[pick] : 'a';
+            }
+            text[length] = '\0';
+            unsigned rules = rule_sets[round % 4];
+            reference_mask(text, length, rules, expected);
+            for (int isa = SIMD_ISA_SCALAR; isa <= SIMD_ISA_AVX2; isa++) {
+                SyntaxMask mask;
+                if (syntax_mask_build(text, length, rules, (SimdIsa)isa, &mask) != DEPTRACK_SUCCESS) {
+                    mismatches++;
+                    continue;
+                }
+                char* got = mask_string(&mask, length);
+                if (!got || strcmp(got, expected) != 0) mismatches++;
+                free(got);
+                syntax_mask_destroy(&mask);
+            }
+        }
+        TEST_ASSERT_EQ(0, mismatches, "Every instruction set matches the byte-at-a-time model");
+    }
+    free(text);
+    free(expected);
+}
+
+void test_line_index(void) {
+    size_t length = 3000;
+    char* text = malloc(length);
+    TEST_ASSERT_NOT_NULL(text, "Buffer should allocate");
+    if (!text) return;
+    unsigned seed = 7;
+    for (size_t i = 0; i < length; i++) {
+        seed = seed * 1103515245 + 12345;
+        text[i] = (seed >> 16) % 9 == 0 ? '\n' : 'a';
+    }
+
+    size_t mismatches = 0;
+    for (int isa = SIMD_ISA_SCALAR; isa <= SIMD_ISA_AVX2; isa++) {
+        LineIndex index;
+        if (line_index_build(text, length, (SimdIsa)isa, &index) != DEPTRACK_SUCCESS) {
+            mismatches++;
+            continue;
+        }
+        int line = 1;
+        for (size_t i = 0; i < length; i++) {
+            if (line_index_line(&index, i) != line) mismatches++;
+            if (text[i] == '\n') line++;
+        }
+        line_index_destroy(&index);
+    }
+    TEST_ASSERT_EQ(0, mismatches, "Every instruction set indexes every newline");
+
+    static const char* source = "one\ntwo\n\nfour\n";
+    ParsedFile* parsed = parsed_file_create("x.kt", LANG_KOTLIN);
+    TEST_ASSERT_NOT_NULL(parsed, "ParsedFile should be created");
+    if (parsed) {
+        parsed_file_add_dependency_at(parsed, "d", 1, NULL, DEP_EXTERNAL, 9);
+        parsed_file_add_dependency_at(parsed, "b", 1, NULL, DEP_EXTERNAL, 4);
+        parsed_file_add_dependency(parsed, "k", 1, NULL, DEP_EXTERNAL, 42);
+        parsed_file_add_dependency_at(parsed, "e", 1, NULL, DEP_EXTERNAL, 12);
+        TEST_ASSERT_EQ(0, parsed->dependencies[0].line_number, "Offsets wait for resolution");
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, parsed_file_resolve_lines(parsed, source, strlen(source)), "Lines resolve");
+        TEST_ASSERT(parsed->dependencies[0].line_number == 4 && parsed->dependencies[1].line_number == 2 &&
+                    parsed->dependencies[3].line_number == 4, "Out-of-order offsets resolve exactly");
+        TEST_ASSERT_EQ(42, parsed->dependencies[2].line_number, "Dependencies recorded by line are kept");
+        parsed_file_destroy(parsed);
+    }
+    free(text);
 }
 
 void run_parser_tests(void) {
     test_run("parser_registration", test_parser_registration);
     test_run("parser_detection", test_parser_detection);
+    test_run("syntax_masking", test_syntax_masking);
+    test_run("line_index", test_line_index);
 }
@@ -0,0 +1,407 @@
+/**
+ * @file test_pipeline.c
+ * @brief Bounded MPMC queue and staged directory analysis tests
+ */
+
+#include "dependency_tracker.h"
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define QUEUE_STRESS_THREADS 4
+#define QUEUE_STRESS_ITEMS 20000
+
+typedef struct {
+    MpmcQueue* queue;
+    size_t first;
+    size_t sum;
+} QueueStress;
+
+static void* queue_producer(void* arg) {
+    QueueStress* stress = arg;
+    for (size_t i = 0; i < QUEUE_STRESS_ITEMS; i++) {
+        while (!mpmc_queue_push(stress->queue, (void*)(uintptr_t)(stress->first + i))) {
+        }
+    }
+    return NULL;
+}
+
+static void* queue_consumer(void* arg) {
+    QueueStress* stress = arg;
+    for (size_t i = 0; i < QUEUE_STRESS_ITEMS; i++) {
+        void* item;
+        while (!mpmc_queue_pop(stress->queue, &item)) {
+        }
+        stress->sum += (uintptr_t)item;
+    }
+    return NULL;
+}
+
+void test_mpmc_queue(void) {
+    MpmcQueue* queue = mpmc_queue_create(3);
+    TEST_ASSERT_NOT_NULL(queue, "Queue should be created");
+    if (!queue) return;
+
+    TEST_ASSERT_EQ(4, mpmc_queue_capacity(queue), "Capacity rounds up to a power of two");
+    void* item = NULL;
+    TEST_ASSERT(!mpmc_queue_pop(queue, &item), "New queue is empty");
+    for (uintptr_t i = 1; i <= 4; i++) {
+        TEST_ASSERT(mpmc_queue_push(queue, (void*)i), "Pushes up to capacity succeed");
+    }
+    TEST_ASSERT(!mpmc_queue_push(queue, (void*)5), "Full queue rejects a push");
+
+    // Wrap around a few laps to exercise the cell sequence numbers
+    bool fifo = true;
+    for (uintptr_t i = 1; i <= 40; i++) {
+        fifo = fifo && mpmc_queue_pop(queue, &item) && (uintptr_t)item == i;
+        fifo = fifo && mpmc_queue_push(queue, (void*)(i + 4));
+    }
+    TEST_ASSERT(fifo, "Items come out in order across laps");
+    mpmc_queue_destroy(queue);
+
+    queue = mpmc_queue_create(64);
+    if (!queue) return;
+    QueueStress producers[QUEUE_STRESS_THREADS];
+    QueueStress consumers[QUEUE_STRESS_THREADS];
+    pthread_t threads[2 * QUEUE_STRESS_THREADS];
+    for (size_t t = 0; t < QUEUE_STRESS_THREADS; t++) {
+        producers[t] = (QueueStress){ queue, 1 + t * QUEUE_STRESS_ITEMS, 0 };
+        consumers[t] = (QueueStress){ queue, 0, 0 };
+        pthread_create(&threads[t], NULL, queue_producer, &producers[t]);
+        pthread_create(&threads[QUEUE_STRESS_THREADS + t], NULL, queue_consumer, &consumers[t]);
+    }
+    size_t total = 0;
+    for (size_t t = 0; t < 2 * QUEUE_STRESS_THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    for (size_t t = 0; t < QUEUE_STRESS_THREADS; t++) {
+        total += consumers[t].sum;
+    }
+    size_t n = (size_t)QUEUE_STRESS_THREADS * QUEUE_STRESS_ITEMS;
+    TEST_ASSERT_EQ(n * (n + 1) / 2, total, "Every item is consumed exactly once");
+    TEST_ASSERT(!mpmc_queue_pop(queue, &item), "Queue is drained");
+    mpmc_queue_destroy(queue);
+
+    TEST_ASSERT_NULL(mpmc_queue_create(SIZE_MAX), "Capacities past the cap are refused");
+}
+
+// jobs sizes the shared pool; 0 leaves the default
+static DependencyTracker* analyze(const char* root, const PipelineConfig* config, size_t jobs) {
+    DependencyTracker* tracker = deptrack_create();
+    if (!tracker) return NULL;
+    if (deptrack_initialize(tracker, NULL) != DEPTRACK_SUCCESS) {
+        deptrack_destroy(tracker);
+        return NULL;
+    }
+    if (jobs > 0) tracker->jobs = jobs;
+    tracker->pipeline = *config;
+    if (deptrack_analyze_directory(tracker, root) != DEPTRACK_SUCCESS) {
+        deptrack_destroy(tracker);
+        return NULL;
+    }
+    return tracker;
+}
+
+void test_pipeline_analysis(void) {
+    char dir_template[] = "/tmp/deptrack_pipeline_XXXXXX";
+    char* dir = mkdtemp(dir_template);
+    TEST_ASSERT_NOT_NULL(dir, "Temporary directory should be created");
+    if (!dir) return;
+
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/web", dir);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/node_modules", dir);
+    mkdir(path, 0755);
+
+    write_fixture(dir, "web/a.ts", "import { b } from './b';\nimport React from 'react';\n");
+    write_fixture(dir, "web/b.ts", "export const b = require('react');\n");
+    write_fixture(dir, "requirements.txt", "requests==2.31.0\nflask>=2.0\n");
+    write_fixture(dir, "deploy", "#!/usr/bin/env bash\nsource ./web/env.sh\n");
+    write_fixture(dir, "main.py", "import os\n");
+    write_fixture(dir, "notes.txt", "nothing to see\n");
+    write_fixture(dir, "node_modules/c.ts", "import 'left-pad';\n");
+
+    // One thread per stage and a tiny queue, then many threads: the graph must not depend on the split
+    PipelineConfig configs[2] = {
+        { { 1, 1, 1, 1 }, 2 },
+        { { 3, 2, 4, 2 }, 4 }
+    };
+    for (size_t c = 0; c < 2; c++) {
+        DependencyTracker* tracker = analyze(dir, &configs[c], 0);
+        TEST_ASSERT_NOT_NULL(tracker, "Directory analysis should succeed");
+        if (!tracker) continue;
+
+        DependencyGraph* graph = deptrack_get_graph(tracker);
+        const PipelineMetrics* metrics = &tracker->pipeline_metrics;
+        TEST_ASSERT_EQ(7, graph->edge_count, "a.ts 2, b.ts 1, requirements 2, deploy 1, main.py 1");
+        TEST_ASSERT_EQ(11, graph->node_count, "5 files and 6 distinct dependencies");
+        const char* name = graph_node_name(graph, graph_find_node(graph, "web/a.ts"));
+        TEST_ASSERT(name && strcmp(name, "a.ts") == 0, "Files are keyed relative to the root");
+        TEST_ASSERT(graph_find_node(graph, "deploy") != GRAPH_NO_NODE, "Extensionless scripts are sniffed by the reader");
+        TEST_ASSERT(graph_find_node(graph, "left-pad") == GRAPH_NO_NODE, "node_modules is not entered");
+        TEST_ASSERT(graph_find_node(graph, "react") != GRAPH_NO_NODE, "Shared dependencies are one node");
+
+        TEST_ASSERT_EQ(configs[c].threads[PIPELINE_PARSE], metrics->stages[PIPELINE_PARSE].threads,
+                       "Configured thread counts are used");
+        TEST_ASSERT_EQ(6, metrics->stages[PIPELINE_ENUMERATE].items, "Every file outside node_modules is read");
+        TEST_ASSERT_EQ(5, metrics->stages[PIPELINE_MERGE].items, "Five files merged");
+        TEST_ASSERT_EQ(1, metrics->files_skipped, "notes.txt has no parser");
+        TEST_ASSERT(metrics->stages[PIPELINE_READ].max_queue_depth <= metrics->stages[PIPELINE_READ].queue_capacity,
+                    "Queue depth is bounded by its capacity");
+        TEST_ASSERT_EQ(0, metrics->stages[PIPELINE_ENUMERATE].queue_capacity, "Enumeration has no input queue");
+        deptrack_destroy(tracker);
+    }
+
+    PipelineConfig config;
+    pipeline_config_default(&config);
+    DependencyTracker* tracker = deptrack_create();
+    if (tracker && deptrack_initialize(tracker, NULL) == DEPTRACK_SUCCESS) {
+        TEST_ASSERT_EQ(DEPTRACK_ERROR_FILE_NOT_FOUND, pipeline_run(tracker, "/nonexistent/deptrack", &config, NULL),
+                       "Missing roots are reported");
+        config.threads[PIPELINE_READ] = SIZE_MAX;
+        TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, pipeline_run(tracker, ".", &config, NULL),
+                       "Stage counts that would overflow the worker array are refused");
+        config.threads[PIPELINE_READ] = 0;
+        config.queue_capacity = PIPELINE_MAX_QUEUE_CAPACITY + 1;
+        TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, pipeline_run(tracker, ".", &config, NULL),
+                       "Queue capacities past the cap are refused");
+    }
+    deptrack_destroy(tracker);
+    TEST_ASSERT_STR_EQ("parse", pipeline_stage_name(PIPELINE_PARSE), "Stage names");
+
+    const char* names[] = {
+        "web/a.ts", "web/b.ts", "requirements.txt", "deploy", "main.py", "notes.txt", "node_modules/c.ts",
+        "node_modules", "web", NULL
+    };
+    for (size_t i = 0; names[i]; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        remove(path);
+    }
+    rmdir(dir);
+}
+
+// The same relative name from two directories is two files, and ids never carry the root
+void test_pipeline_relative_paths(void) {
+    char dir_template[] = "/tmp/deptrack_relative_XXXXXX";
+    char* dir = mkdtemp(dir_template);
+    TEST_ASSERT_NOT_NULL(dir, "Temporary directory should be created");
+    if (!dir) return;
+
+    char path[MAX_PATH_LENGTH];
+    const char* dirs[] = { "a", "b", "b/src", NULL };
+    for (size_t i = 0; dirs[i]; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, dirs[i]);
+        mkdir(path, 0755);
+    }
+    write_fixture(dir, "a/x.ts", "import { u } from './util';\nimport { s } from '../shared/s';\n");
+    write_fixture(dir, "b/x.ts", "import { u } from './util';\n");
+    write_fixture(dir, "b/src/main.c", "#include \"util.h\"\n#include \"config.h\"\n");
+    write_fixture(dir, "b/src/util.h", "\n");
+    write_fixture(dir, "b/Dockerfile", "FROM alpine:3.19\nCOPY src /app\n");
+
+    PipelineConfig config;
+    pipeline_config_default(&config);
+    DependencyTracker* tracker = analyze(dir, &config, 0);
+    TEST_ASSERT_NOT_NULL(tracker, "Directory analysis should succeed");
+    if (tracker) {
+        DependencyGraph* graph = deptrack_get_graph(tracker);
+        bool both = graph_find_node(graph, "a/util") != GRAPH_NO_NODE && graph_find_node(graph, "b/util") != GRAPH_NO_NODE;
+        TEST_ASSERT(both, "./util is resolved against each importing directory");
+        TEST_ASSERT(graph_find_node(graph, "./util") == GRAPH_NO_NODE, "No node keeps the relative name");
+        TEST_ASSERT(graph_find_node(graph, "shared/s") != GRAPH_NO_NODE, "../ is normalized away");
+        TEST_ASSERT(graph_find_node(graph, "b/src/util.h") != GRAPH_NO_NODE, "Quoted includes found next to the file");
+        TEST_ASSERT(graph_find_node(graph, "config.h") != GRAPH_NO_NODE, "Missing headers keep the include path");
+        TEST_ASSERT(graph_find_node(graph, "b/src") != GRAPH_NO_NODE, "Build context paths are root-relative");
+
+        // The output names the analyzed root; formats without a writer are refused, not left empty
+        snprintf(path, sizeof(path), "%s/deps.json", dir);
+        TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, deptrack_generate_output(tracker, OUTPUT_DOT, path),
+                       "Unwritten formats are an error");
+        TEST_ASSERT(access(path, F_OK) != 0, "No file is created for them");
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, deptrack_generate_output(tracker, OUTPUT_JSON, path), "JSON is written");
+        size_t length = 0;
+        char* json = parser_read_file(path, &length);
+        char expected[MAX_PATH_LENGTH + 32];
+        snprintf(expected, sizeof(expected), "\"root_path\": \"%s\"", dir);
+        TEST_ASSERT(json && strstr(json, expected), "root_path is the analyzed directory");
+        free(json);
+        remove(path);
+        deptrack_destroy(tracker);
+    }
+
+    const char* names[] = {
+        "a/x.ts", "b/x.ts", "b/src/main.c", "b/src/util.h", "b/Dockerfile", "b/src", "b", "a", NULL
+    };
+    for (size_t i = 0; names[i]; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        remove(path);
+    }
+    rmdir(dir);
+}
+
+#define DETERMINISM_MODULES 40
+
+// Merge order follows whichever worker finishes first; the written graph must not
+void test_pipeline_deterministic_output(void) {
+    char dir_template[] = "/tmp/deptrack_determinism_XXXXXX";
+    char* dir = mkdtemp(dir_template);
+    TEST_ASSERT_NOT_NULL(dir, "Temporary directory should be created");
+    if (!dir) return;
+
+    // Each script sources the next and each module imports a shared package, so files are often a target
+    // before they are merged
+    char path[MAX_PATH_LENGTH];
+    char name[64];
+    char content[256];
+    for (int i = 0; i < DETERMINISM_MODULES; i++) {
+        snprintf(name, sizeof(name), "s%d.sh", i);
+        snprintf(content, sizeof(content), "#!/bin/sh\nsource ./s%d.sh\n", (i + 1) % DETERMINISM_MODULES);
+        write_fixture(dir, name, content);
+        snprintf(name, sizeof(name), "m%d.ts", i);
+        snprintf(content, sizeof(content), "import { x } from './m%d';\nimport y from 'pkg%d';\n",
+                 (i + 1) % DETERMINISM_MODULES, i % 5);
+        write_fixture(dir, name, content);
+    }
+    write_fixture(dir, "requirements.txt", "requests==2.31.0\nflask>=2.0\n");
+    write_fixture(dir, "Dockerfile", "FROM alpine:3.19\nCOPY s0.sh /app/\n");
+
+    static const struct {
+        size_t jobs;
+        PipelineConfig pipeline;
+    } runs[] = {
+        { 1, { { 1, 1, 1, 1 }, 2 } },
+        { 2, { { 1, 2, 2, 1 }, 4 } },
+        { 8, { { 2, 4, 8, 2 }, 8 } },
+        { 4, { { 3, 1, 4, 4 }, 64 } }
+    };
+    char* expected = NULL;
+    size_t expected_length = 0;
+    snprintf(path, sizeof(path), "%s/deps.json", dir);
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        DependencyTracker* tracker = analyze(dir, &runs[r].pipeline, runs[r].jobs);
+        TEST_ASSERT_NOT_NULL(tracker, "Directory analysis should succeed");
+        if (!tracker) continue;
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, deptrack_generate_output(tracker, OUTPUT_JSON, path), "JSON is written");
+        deptrack_destroy(tracker);
+
+        size_t length = 0;
+        char* json = parser_read_file(path, &length);
+        remove(path);
+        TEST_ASSERT_NOT_NULL(json, "JSON is read back");
+        if (!expected) {
+            expected = json;
+            expected_length = length;
+            continue;
+        }
+        bool same = json && length == expected_length && memcmp(json, expected, length) == 0;
+        if (!same) fprintf(stderr, "    jobs=%zu differs from the single-threaded output\n", runs[r].jobs);
+        TEST_ASSERT(same, "Output is byte-identical at every pool and stage thread count");
+        free(json);
+    }
+    free(expected);
+
+    for (int i = 0; i < DETERMINISM_MODULES; i++) {
+        snprintf(path, sizeof(path), "%s/s%d.sh", dir, i);
+        remove(path);
+        snprintf(path, sizeof(path), "%s/m%d.ts", dir, i);
+        remove(path);
+    }
+    const char* names[] = { "requirements.txt", "Dockerfile", NULL };
+    for (size_t i = 0; names[i]; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        remove(path);
+    }
+    rmdir(dir);
+}
+
+// A script merged after one that sources it must not stay the source's placeholder
+void test_pipeline_merge_order(void) {
+    ParsedFile* run_sh = parsed_file_create("/src/run.sh", LANG_SHELL);
+    ParsedFile* env_sh = parsed_file_create("/src/env.sh", LANG_SHELL);
+    if (run_sh) parsed_file_add_dependency(run_sh, "env.sh", 6, NULL, DEP_INTERNAL, 2);
+    TEST_ASSERT(run_sh && env_sh && run_sh->dep_count == 1, "Parsed files should be created");
+
+    for (int order = 0; run_sh && env_sh && order < 2; order++) {
+        DependencyTracker* tracker = deptrack_create();
+        if (!tracker || deptrack_initialize(tracker, NULL) != DEPTRACK_SUCCESS) {
+            deptrack_destroy(tracker);
+            continue;
+        }
+        const ParsedFile* first = order == 0 ? run_sh : env_sh;
+        const ParsedFile* second = order == 0 ? env_sh : run_sh;
+        deptrack_merge_parsed_file(tracker, first, first == run_sh ? "run.sh" : "env.sh");
+        deptrack_merge_parsed_file(tracker, second, second == run_sh ? "run.sh" : "env.sh");
+
+        DependencyGraph* graph = deptrack_get_graph(tracker);
+        size_t node = graph_find_node(graph, "env.sh");
+        const char* filepath = graph_node_filepath(graph, node);
+        const char* name = graph_node_name(graph, node);
+        TEST_ASSERT_EQ(2, graph->node_count, "The source target and the script are one node");
+        TEST_ASSERT(filepath && strcmp(filepath, "/src/env.sh") == 0, "The sourced script keeps its filepath");
+        TEST_ASSERT(name && strcmp(name, "env.sh") == 0, "The sourced script keeps its name");
+        TEST_ASSERT(node != GRAPH_NO_NODE && (graph->node_flags[node] & GRAPH_NODE_FILE), "It is a file");
+        TEST_ASSERT_EQ(NODE_CONFIG, graph->node_type[node], "It has the script type, not the placeholder's");
+        TEST_ASSERT_EQ(1, graph->edge_count, "The source edge is kept");
+        deptrack_destroy(tracker);
+    }
+    parsed_file_destroy(run_sh);
+    parsed_file_destroy(env_sh);
+}
+
+// Paths that do not exist: every parser has to work from the buffer the read stage loaded
+void test_parse_buffers(void) {
+    static const struct {
+        const char* path;
+        Language language;
+        const char* content;
+    } files[] = {
+        { "/nonexistent/src/main.c", LANG_C, "#include <stdio.h>\n#include \"util.h\"\n" },
+        { "/nonexistent/go.mod", LANG_GO, "module example.com/x\n\ngo 1.21\n\nrequire github.com/pkg/errors v0.9.1\n" },
+        { "/nonexistent/Cargo.toml", LANG_RUST, "[package]\nname = \"x\"\n\n[dependencies]\nserde = \"1\"\n" },
+        { "/nonexistent/requirements.txt", LANG_PYTHON, "requests==2.31.0\n" },
+        { "/nonexistent/docker-compose.yml", LANG_YAML, "services:\n  web:\n    image: nginx:1.25\n" },
+        { "/nonexistent/build/ci/workflows/main.yml", LANG_YAML,
+          "jobs:\n  build:\n    steps:\n    - uses: actions/checkout@v4\n" },
+        { "/nonexistent/api.proto", LANG_PROTO, "syntax = \"proto3\";\nimport \"google/protobuf/empty.proto\";\n" },
+        { "/nonexistent/Makefile", LANG_MAKE, "include common.mk\nall:\n\t./scripts/build.sh\n" },
+        { "/nonexistent/run.sh", LANG_SHELL, "#!/bin/sh\nsource ./env.sh\n" },
+        { "/nonexistent/Dockerfile", LANG_DOCKER, "FROM alpine:3.19\n" },
+        { "/nonexistent/V1__views.sql", LANG_SQL, "CREATE VIEW v AS SELECT * FROM orders;\n" }
+    };
+    bool parsed_all = true;
+    for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++) {
+        ParsedFile* parsed = deptrack_parse_buffer(NULL, files[i].path, files[i].language, files[i].content,
+                                                   strlen(files[i].content));
+        if (!parsed || parsed->dep_count == 0) {
+            fprintf(stderr, "    %s was not parsed from its buffer\n", files[i].path);
+            parsed_all = false;
+        }
+        parsed_file_destroy(parsed);
+    }
+    TEST_ASSERT(parsed_all, "Every language parses the loaded buffer without reading the file again");
+
+    // SQL dumps are streamed from disk rather than loaded by the read stage
+    TEST_ASSERT(deptrack_parser_streams(LANG_SQL) && !deptrack_parser_streams(LANG_C), "Only SQL streams");
+    char path[] = "/tmp/deptrack_stream_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+        const char* sql = "CREATE VIEW v AS SELECT * FROM orders;\n";
+        bool written = write(fd, sql, strlen(sql)) == (ssize_t)strlen(sql);
+        close(fd);
+        ParsedFile* parsed = written ? deptrack_parse_file(NULL, path, LANG_SQL) : NULL;
+        TEST_ASSERT(parsed && parsed->dep_count == 1 && strcmp(parsed->dependencies[0].name, "orders") == 0,
+                    "Streamed SQL finds the same references");
+        parsed_file_destroy(parsed);
+        remove(path);
+    }
+    TEST_ASSERT_NULL(deptrack_parse_file(NULL, "/nonexistent/V2__gone.sql", LANG_SQL), "Missing files");
+}
+
+void run_pipeline_tests(void) {
+    test_run("mpmc_queue", test_mpmc_queue);
+    test_run("pipeline_analysis", test_pipeline_analysis);
+    test_run("pipeline_relative_paths", test_pipeline_relative_paths);
+    test_run("pipeline_merge_order", test_pipeline_merge_order);
+    test_run("pipeline_deterministic_output", test_pipeline_deterministic_output);
+    test_run("parse_buffers", test_parse_buffers);
+}
@@ -0,0 +1,169 @@
+/**
+ * @file test_proto_parser.c
+ * @brief Protocol Buffers parser tests
+ */
+
+#include "dependency_tracker.h"
+
+static const char* COMMON_PROTO =
+    "syntax = \"proto3\";\n"
+    "package unhinged.common;\n"
+    "import \"google/protobuf/timestamp.proto\";\n"
+    "message Envelope {\n"
+    "  google.protobuf.Timestamp sent_at = 1;\n"
+    "}\n";
+
+static const char* CHAT_PROTO =
+    "syntax = \"proto3\";\n"
+    "// import \"commented/out.proto\";\n"
+    "package unhinged.chat;\n"
+    "import public \"common/envelope.proto\";\n"
+    "\n"
+    "message ChatRequest {\n"
+    "  unhinged.common.Envelope envelope = 1;\n"
+    "  repeated string tags = 2 [deprecated = true];\n"
+    "  map<string, Attachment> attachments = 3;\n"
+    "  message Attachment { bytes data = 1; }\n"
+    "  oneof body {\n"
+    "    string text = 4;\n"
+    "    Voice voice = 5;\n"
+    "  }\n"
+    "}\n"
+    "enum Voice { VOICE_UNSPECIFIED = 0; }\n"
+    "/* service Hidden { rpc Nope (A) returns (B); } */\n"
+    "service ChatService {\n"
+    "  option deprecated = false;\n"
+    "  rpc Send (ChatRequest) returns (ChatReply);\n"
+    "  rpc Stream (stream ChatRequest) returns (stream ChatReply) {\n"
+    "    option idempotency_level = NO_SIDE_EFFECTS;\n"
+    "  }\n"
+    "}\n";
+
+static const char* GATEWAY_PROTO =
+    "syntax = \"proto3\";\n"
+    "import \"chat.proto\";\n"
+    "service Gateway { rpc Relay (unhinged.chat.ChatRequest) returns (unhinged.chat.ChatReply); }\n";
+
+static const char* STANDALONE_PROTO =
+    "syntax = \"proto3\";\n"
+    "message Ping { int64 at = 1; }\n";
+
+static const char* IMPORTS_PROTO =
+    "syntax = 'proto3'; import weak 'a.proto'; import /* why */ \"b.proto\";\n"
+    "message M {\n"
+    "  string x = 1; // import \"c.proto\";\n"
+    "  string y = 2 [(opt) = \"import d.proto\"];\n"
+    "}\n"
+    "import\n"
+    "  \"e.proto\";\n"
+    "import.Foo bar = 3;\n"
+    "import \"\";\n";
+
+void test_proto_parsing(void) {
+    ProtoFile* file = proto_parse_buffer("chat.proto", CHAT_PROTO, strlen(CHAT_PROTO));
+    TEST_ASSERT_NOT_NULL(file, "Proto buffer should parse");
+    if (!file) return;
+
+    TEST_ASSERT_STR_EQ("unhinged.chat", file->package, "Package should be extracted");
+    TEST_ASSERT_EQ(1, file->import_count, "Commented imports must be ignored");
+    if (file->import_count == 1) {
+        TEST_ASSERT_STR_EQ("common/envelope.proto", file->imports[0], "Public import path should be extracted");
+        TEST_ASSERT_EQ(4, file->import_lines[0], "Import line should be recorded");
+    }
+
+    TEST_ASSERT_EQ(3, file->message_count, "Messages and enums, including nested ones");
+    if (file->message_count == 3) {
+        TEST_ASSERT_STR_EQ("ChatRequest.Attachment", file->messages[1], "Nested message should be qualified");
+        TEST_ASSERT_STR_EQ("Voice", file->messages[2], "Top-level enum after nesting should not be qualified");
+    }
+
+    // Envelope, Attachment, Voice, ChatRequest, ChatReply
+    TEST_ASSERT_EQ(5, file->type_ref_count, "Distinct non-scalar type references");
+
+    TEST_ASSERT_EQ(1, file->service_count, "Commented services must be ignored");
+    if (file->service_count == 1) {
+        ProtoService* service = &file->services[0];
+        TEST_ASSERT_STR_EQ("ChatService", service->name, "Service name should be extracted");
+        TEST_ASSERT_EQ(2, service->rpc_count, "Both rpcs should be extracted");
+        if (service->rpc_count == 2) {
+            TEST_ASSERT_STR_EQ("ChatReply", service->rpcs[0].response_type, "Response type should be extracted");
+            TEST_ASSERT(!service->rpcs[0].client_streaming, "Unary rpc is not streaming");
+            TEST_ASSERT(service->rpcs[1].client_streaming && service->rpcs[1].server_streaming,
+                        "Bidirectional stream flags should be set");
+            TEST_ASSERT_STR_EQ("Stream", service->rpcs[1].name, "Rpc with options block should be extracted");
+        }
+    }
+
+    proto_file_destroy(file);
+}
+
+void test_proto_compile_order(void) {
+    ProtoSet* set = proto_set_create("proto");
+    TEST_ASSERT_NOT_NULL(set, "Proto set creation should succeed");
+    if (!set) return;
+
+    proto_set_add_buffer(set, "gateway.proto", GATEWAY_PROTO, strlen(GATEWAY_PROTO));
+    proto_set_add_buffer(set, "chat.proto", CHAT_PROTO, strlen(CHAT_PROTO));
+    proto_set_add_buffer(set, "common/envelope.proto", COMMON_PROTO, strlen(COMMON_PROTO));
+    proto_set_add_buffer(set, "ping.proto", STANDALONE_PROTO, strlen(STANDALONE_PROTO));
+    TEST_ASSERT_EQ(4, set->file_count, "All protos should be added");
+
+    DagSchedule schedule;
+    int result = proto_set_compile_order(set, &schedule);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Import graph should be acyclic");
+    TEST_ASSERT_EQ(3, schedule.wave_count, "envelope+ping, chat, gateway");
+    TEST_ASSERT(schedule.wave_of[2] < schedule.wave_of[1] && schedule.wave_of[1] < schedule.wave_of[0],
+                "Imports must compile before their importers");
+    dag_schedule_destroy(&schedule);
+
+    bool stale[4];
+    const char* changed[] = { "proto/common/envelope.proto" };
+    size_t stale_count = proto_set_stale(set, changed, 1, stale);
+    TEST_ASSERT_EQ(3, stale_count, "Envelope change reaches chat and gateway transitively");
+    TEST_ASSERT(stale[0] && stale[1] && stale[2] && !stale[3], "Unrelated proto stays fresh");
+
+    const char* leaf[] = { "gateway.proto", "not/in/set.proto" };
+    stale_count = proto_set_stale(set, leaf, 2, stale);
+    TEST_ASSERT_EQ(1, stale_count, "Leaf change only regenerates itself");
+
+    proto_set_destroy(set);
+}
+
+// The import scan must agree with the full parser on every file it is given
+void test_proto_import_scan(void) {
+    const char* const all[] = { COMMON_PROTO, CHAT_PROTO, GATEWAY_PROTO, IMPORTS_PROTO };
+    bool same = true;
+    for (size_t f = 0; f < sizeof(all) / sizeof(all[0]); f++) {
+        ProtoFile* file = proto_parse_buffer("x.proto", all[f], strlen(all[f]));
+        ParsedFile* parsed = proto_scan_imports("x.proto", all[f], strlen(all[f]), NULL);
+        same = same && file && parsed && parsed->dep_count == file->import_count;
+        for (size_t i = 0; same && i < parsed->dep_count; i++) {
+            same = strcmp(parsed->dependencies[i].name, file->imports[i]) == 0 &&
+                   parsed->dependencies[i].line_number == file->import_lines[i];
+        }
+        if (!same) fprintf(stderr, "    import scan differs from the parser on file %zu\n", f);
+        proto_file_destroy(file);
+        parsed_file_destroy(parsed);
+    }
+    TEST_ASSERT(same, "Imports, their order and their lines match proto_parse_buffer");
+
+    ParsedFile* parsed = proto_scan_imports("x.proto", IMPORTS_PROTO, strlen(IMPORTS_PROTO), NULL);
+    TEST_ASSERT(parsed && parsed->dep_count == 3, "weak, commented-out, option and field imports");
+    if (parsed && parsed->dep_count == 3) {
+        TEST_ASSERT_STR_EQ("e.proto", parsed->dependencies[2].name, "A path on the next line");
+        TEST_ASSERT_EQ(7, parsed->dependencies[2].line_number, "Its line is the path's");
+        TEST_ASSERT_EQ(DEP_INTERNAL, parsed->dependencies[0].type, "Local imports are internal");
+    }
+    parsed_file_destroy(parsed);
+
+    parsed = proto_scan_imports("x.proto", COMMON_PROTO, strlen(COMMON_PROTO), NULL);
+    TEST_ASSERT(parsed && parsed->dep_count == 1 && parsed->dependencies[0].type == DEP_EXTERNAL,
+                "google/ imports are external");
+    parsed_file_destroy(parsed);
+}
+
+void run_proto_parser_tests(void) {
+    test_run("proto_parsing", test_proto_parsing);
+    test_run("proto_compile_order", test_proto_compile_order);
+    test_run("proto_import_scan", test_proto_import_scan);
+}
@@ -4,18 +4,233 @@
  */
 
 #include "dependency_tracker.h"
+#include <unistd.h>
+
+static const char* format_interval(const VersionInterval* interval, char* out, size_t size) {
+    if (version_interval_format(interval, out, size) < 0) {
+        snprintf(out, size, "<error>");
+    }
+    return out;
+}
 
 void test_python_requirements_parsing(void) {
-    // TODO: Implement Python requirements.txt parsing tests
-    TEST_ASSERT(true, "Python requirements parsing test placeholder");
+    char dir_template[] = "/tmp/deptrack_python_XXXXXX";
+    char* dir = mkdtemp(dir_template);
+    TEST_ASSERT_NOT_NULL(dir, "Temporary directory should be created");
+    if (!dir) return;
+
+    char main_path[MAX_PATH_LENGTH], base_path[MAX_PATH_LENGTH], constraints_path[MAX_PATH_LENGTH];
+    snprintf(main_path, sizeof(main_path), "%s/requirements.txt", dir);
+    snprintf(base_path, sizeof(base_path), "%s/base.txt", dir);
+    snprintf(constraints_path, sizeof(constraints_path), "%s/constraints.txt", dir);
+
+    write_fixture(dir, "requirements.txt",
+        "# Service requirements\n"
+        "-r base.txt\n"
+        "-c constraints.txt\n"
+        "--index-url https://pypi.org/simple\n"
+        "PyYAML>=6.0                    # Configuration parsing\n"
+        "requests[socks,security] >= 2.31.0, < 3 ; python_version >= \"3.8\"\n"
+        "Django~=4.2.1 \\\n"
+        "    --hash=sha256:abc\n"
+        "-e ./libs/event-framework\n"
+        "mypkg @ https://example.com/mypkg-1.0.tar.gz ; sys_platform == 'linux'\n"
+        "-r base.txt\n");
+    write_fixture(dir, "base.txt",
+        "numpy>=1.24.0,!=1.25.*\n"
+        "-r requirements.txt\n");
+    write_fixture(dir, "constraints.txt",
+        "numpy<2\n"
+        "torch==2.1.0\n");
+
+    PythonRequirements* reqs = python_requirements_create();
+    int result = python_requirements_load(reqs, main_path);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Requirements with includes should load");
+    char text[128];
+
+    const PythonRequirement* req = python_requirements_find(reqs, "pyyaml");
+    TEST_ASSERT_NOT_NULL(req, "Names should be PEP 503 normalized");
+    if (req) {
+        TEST_ASSERT_STR_EQ("[6.0,)", format_interval(&req->interval, text, sizeof(text)), "Lower bound only");
+        TEST_ASSERT_EQ(5, req->line_number, "Line number should be tracked");
+    }
+
+    req = python_requirements_find(reqs, "requests");
+    TEST_ASSERT(req && req->extras && strcmp(req->extras, "socks,security") == 0, "Extras should be kept");
+    TEST_ASSERT(req && req->marker && strcmp(req->marker, "python_version >= \"3.8\"") == 0, "Marker should be split off");
+    if (req) {
+        TEST_ASSERT_STR_EQ("[2.31.0,3)", format_interval(&req->interval, text, sizeof(text)), "Range should be an interval");
+    }
+
+    req = python_requirements_find(reqs, "django");
+    TEST_ASSERT(req != NULL, "Continued lines should be joined and --hash dropped");
+    if (req) {
+        TEST_ASSERT_STR_EQ("[4.2.1,4.3)", format_interval(&req->interval, text, sizeof(text)), "~= should be compatible release");
+    }
+
+    req = python_requirements_find(reqs, "event-framework");
+    TEST_ASSERT(req && req->editable, "Editable path should be named after its directory");
+
+    req = python_requirements_find(reqs, "mypkg");
+    TEST_ASSERT(req && req->url && strcmp(req->url, "https://example.com/mypkg-1.0.tar.gz") == 0, "Direct URL should be kept");
+
+    req = python_requirements_find(reqs, "numpy");
+    TEST_ASSERT(req != NULL, "Included requirements should be loaded");
+    if (req) {
+        TEST_ASSERT_STR_EQ("[1.24.0,2),!=1.25.*", format_interval(&req->interval, text, sizeof(text)),
+                           "Constraints should narrow the interval");
+        TEST_ASSERT(strstr(req->source_file, "base.txt") != NULL, "Source file should be the included file");
+    }
+
+    TEST_ASSERT_NULL(python_requirements_find(reqs, "torch"), "Constraints must not add packages");
+
+    size_t numpy_count = 0;
+    for (size_t i = 0; i < reqs->count; i++) {
+        if (!reqs->items[i].constraint && strcmp(reqs->items[i].name, "numpy") == 0) numpy_count++;
+    }
+    TEST_ASSERT_EQ(1, numpy_count, "Include cycles and repeats should be read once");
+    python_requirements_destroy(reqs);
+
+    // A NUL inside a name drops the line instead of hashing past the copied name
+    static const char nul_lines[] = "-e git+https://h/x#egg=ab\0cd\nfoo\0bar>=1\nflask\n";
+    reqs = python_requirements_create();
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, python_requirements_parse_buffer(reqs, main_path, nul_lines,
+                                                                      sizeof(nul_lines) - 1, false),
+                   "Lines with NUL bytes are skipped");
+    TEST_ASSERT(reqs->count == 1 && python_requirements_find(reqs, "flask"), "Only the clean line is kept");
+    python_requirements_destroy(reqs);
+    unlink(main_path);
+    unlink(base_path);
+    unlink(constraints_path);
+    rmdir(dir);
+}
+
+static const Dependency* find_dependency(const ParsedFile* parsed, const char* name) {
+    for (size_t i = 0; i < parsed->dep_count; i++) {
+        if (strcmp(parsed->dependencies[i].name, name) == 0) return &parsed->dependencies[i];
+    }
+    return NULL;
 }
 
 void test_python_import_parsing(void) {
-    // TODO: Implement Python import parsing tests
-    TEST_ASSERT(true, "Python import parsing test placeholder");
+    static const char* text =
+        "\"\"\"Service entry point.\n"
+        "import docstring_module\n"
+        "\"\"\"\n"
+        "from __future__ import annotations\n"
+        "import os, sys as system\n"
+        "import yaml.loader\n"
+        "from . import models\n"
+        "from ..shared.config import (\n"
+        "    load,\n"
+        ")\n"
+        "# import commented\n"
+        "message = 'from quoted import x'\n"
+        "try: import ujson as json\n"
+        "except ImportError: pass\n"
+        "def run():\n"
+        "    from requests.adapters import HTTPAdapter\n"
+        "    yield from range(3)\n"
+        "    raise ValueError() from None\n"
+        "from grpc \\\n"
+        "    import aio\n";
+
+    ParsedFile* parsed = python_scan_imports("svc/main.py", text, strlen(text), NULL);
+    TEST_ASSERT_NOT_NULL(parsed, "Source should parse");
+    if (!parsed) return;
+
+    TEST_ASSERT_EQ(8, parsed->dep_count, "One dependency per imported module");
+    const Dependency* dep = find_dependency(parsed, "yaml");
+    TEST_ASSERT(dep && dep->type == DEP_EXTERNAL && dep->line_number == 6, "Submodules reduce to the package");
+    TEST_ASSERT(find_dependency(parsed, "os") && find_dependency(parsed, "sys"), "Comma lists and aliases");
+    dep = find_dependency(parsed, ".");
+    TEST_ASSERT(dep && dep->type == DEP_INTERNAL && dep->line_number == 7, "Relative imports are internal");
+    dep = find_dependency(parsed, "..shared.config");
+    TEST_ASSERT(dep && dep->type == DEP_INTERNAL, "Relative modules are kept as written");
+    TEST_ASSERT_NOT_NULL(find_dependency(parsed, "ujson"), "Imports after a compound statement's colon");
+    dep = find_dependency(parsed, "requests");
+    TEST_ASSERT(dep && dep->line_number == 16, "Function-local imports");
+    TEST_ASSERT_NOT_NULL(find_dependency(parsed, "grpc"), "Continued from statements");
+    TEST_ASSERT_NULL(find_dependency(parsed, "docstring_module"), "Docstrings are masked");
+    TEST_ASSERT_NULL(find_dependency(parsed, "__future__"), "Future statements are not dependencies");
+    TEST_ASSERT_NULL(find_dependency(parsed, "aio"), "A continued line is not a statement");
+    parsed_file_destroy(parsed);
+
+    TEST_ASSERT(deptrack_has_parser(LANG_PYTHON, "svc/main.py"), "Python sources have a parser");
+}
+
+void test_pyproject_parsing(void) {
+    static const char* pyproject =
+        "[build-system]\n"
+        "requires = [\"setuptools>=61.0\", \"wheel\"]\n"
+        "[project]\n"
+        "name = \"events\"\n"
+        "dependencies = [\n"
+        "    \"PyYAML>=6.0\",\n"
+        "    \"opentelemetry-api>=1.18.0\",\n"
+        "]\n"
+        "[project.optional-dependencies]\n"
+        "dev = [\"pytest>=7.0.0\", \"mypy==1.*\"]\n"
+        "[tool.black]\n"
+        "line-length = 100\n";
+
+    PythonRequirements* reqs = python_requirements_create();
+    int result = pyproject_parse_buffer(reqs, "pyproject.toml", pyproject, strlen(pyproject));
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "pyproject.toml should parse");
+    TEST_ASSERT_EQ(6, reqs->count, "Build, main and optional requirements should be read");
+
+    const PythonRequirement* req = python_requirements_find(reqs, "setuptools");
+    TEST_ASSERT(req && req->group && strcmp(req->group, "build-system") == 0, "build-system requires are grouped");
+    req = python_requirements_find(reqs, "opentelemetry-api");
+    TEST_ASSERT(req && !req->group && req->line_number == 7, "Main dependencies have no group");
+    req = python_requirements_find(reqs, "mypy");
+    TEST_ASSERT(req && req->group && strcmp(req->group, "dev") == 0, "Optional group should be recorded");
+    char text[64];
+    if (req) {
+        version_interval_format(&req->interval, text, sizeof(text));
+        TEST_ASSERT_STR_EQ("[1,2)", text, "Prefix match should become a half-open interval");
+    }
+    python_requirements_destroy(reqs);
+}
+
+void test_pep440_intervals(void) {
+    char text[64];
+    TEST_ASSERT(pep440_compare("1.0.dev1", "1.0a1") < 0, "Dev release sorts before pre-releases");
+    TEST_ASSERT(pep440_compare("1.0rc1", "1.0") < 0, "Release candidate sorts before final");
+    TEST_ASSERT(pep440_compare("1.0.post1", "1.0") > 0, "Post release sorts after final");
+    TEST_ASSERT(pep440_compare("1.0", "1.0.0") == 0, "Trailing zeros are insignificant");
+    TEST_ASSERT(pep440_compare("1!0.1", "2.0") > 0, "Epoch dominates");
+    TEST_ASSERT(pep440_normalize("1.0-ALPHA.2", 11, text, sizeof(text)) && strcmp(text, "1.0a2") == 0,
+                "Versions should normalize");
+
+    VersionInterval a, b;
+    version_interval_parse(">=1.0,<2.0", 10, &a);
+    version_interval_parse("==2.0", 5, &b);
+    TEST_ASSERT(!version_interval_overlaps(&a, &b), "Touching exclusive bound does not overlap");
+    TEST_ASSERT(version_interval_contains(&a, "1.9.9"), "Interval should contain inner version");
+    version_interval_destroy(&b);
+    version_interval_parse("~=1.5, !=1.7.0", 14, &b);
+    TEST_ASSERT(version_interval_overlaps(&a, &b), "Overlapping ranges should be detected");
+    TEST_ASSERT(!version_interval_contains(&b, "1.7"), "Excluded version should not be contained");
+    version_interval_destroy(&a);
+    version_interval_destroy(&b);
+    version_interval_parse(">2.0,<=1.0", 10, &a);
+    TEST_ASSERT(a.empty, "Contradictory specifiers should be empty");
+    version_interval_destroy(&a);
+
+    const char* env[] = { "python_version", "3.12", "sys_platform", "linux", NULL };
+    TEST_ASSERT_EQ(1, python_marker_evaluate("python_version >= \"3.8\" and sys_platform == 'linux'", env),
+                   "Version markers compare as versions");
+    TEST_ASSERT_EQ(0, python_marker_evaluate("python_version < '3.10' or (sys_platform == 'win32')", env),
+                   "Marker disjunction should evaluate");
+    TEST_ASSERT_EQ(1, python_marker_evaluate("extra == 'dev' or 'linux' in sys_platform", env),
+                   "Unknown variables are empty strings");
+    TEST_ASSERT(python_marker_evaluate("python_version >>", env) < 0, "Malformed markers are errors");
 }
 
 void run_python_parser_tests(void) {
     test_run("python_requirements_parsing", test_python_requirements_parsing);
     test_run("python_import_parsing", test_python_import_parsing);
+    test_run("pyproject_parsing", test_pyproject_parsing);
+    test_run("pep440_intervals", test_pep440_intervals);
 }
@@ -0,0 +1,139 @@
+/**
+ * @file test_rust_parser.c
+ * @brief Cargo manifest, lockfile and Rust use-tree tests
+ */
+
+#include "dependency_tracker.h"
+
+static const Dependency* find_dependency(const ParsedFile* parsed, const char* name) {
+    for (size_t i = 0; i < parsed->dep_count; i++) {
+        if (strcmp(parsed->dependencies[i].name, name) == 0) return &parsed->dependencies[i];
+    }
+    return NULL;
+}
+
+void test_cargo_manifest_parsing(void) {
+    static const char* manifest_text =
+        "[package]\n"
+        "name = \"engine\"\n"
+        "version = \"0.3.0\"\n"
+        "\n"
+        "[dependencies]\n"
+        "serde = { version = \"1.0\", features = [\"derive\"] }\n"
+        "tokio = \"1.35\"\n"
+        "core-utils = { path = \"../core-utils\" }\n"
+        "json = { package = \"serde_json\", version = \"1\", optional = true }\n"
+        "log.workspace = true\n"
+        "\n"
+        "[dev-dependencies]\n"
+        "criterion = \"0.5\"\n"
+        "\n"
+        "[build-dependencies.cc]\n"
+        "version = \"1.0\"\n"
+        "\n"
+        "[target.'cfg(unix)'.dependencies]\n"
+        "libc = \"0.2\"\n";
+
+    CargoManifest* manifest = cargo_manifest_parse_buffer(manifest_text, strlen(manifest_text));
+    TEST_ASSERT_NOT_NULL(manifest, "Cargo.toml should parse");
+    if (!manifest) return;
+
+    TEST_ASSERT_STR_EQ("engine", manifest->package_name, "Package name");
+    TEST_ASSERT_EQ(8, manifest->dependency_count, "Every dependency table should be read");
+    if (manifest->dependency_count == 8) {
+        const CargoDependency* deps = manifest->dependencies;
+        TEST_ASSERT(deps[0].version && strcmp(deps[0].version, "1.0") == 0 && deps[0].line_number == 6,
+                    "Inline table version and line");
+        TEST_ASSERT(deps[2].path && !deps[2].version, "Path dependency");
+        TEST_ASSERT(deps[3].package && strcmp(deps[3].package, "serde_json") == 0 && deps[3].optional,
+                    "Renamed optional dependency");
+        TEST_ASSERT(deps[4].workspace, "Dotted workspace inheritance");
+        TEST_ASSERT_EQ(CARGO_DEV, deps[5].kind, "Dev dependency");
+        TEST_ASSERT(deps[6].kind == CARGO_BUILD && strcmp(deps[6].version, "1.0") == 0, "Table-form build dependency");
+        TEST_ASSERT(deps[7].target && strcmp(deps[7].target, "cfg(unix)") == 0, "Target-specific dependency");
+    }
+    cargo_manifest_destroy(manifest);
+
+    static const char* lock_text =
+        "version = 3\n"
+        "\n"
+        "[[package]]\n"
+        "name = \"engine\"\n"
+        "version = \"0.3.0\"\n"
+        "dependencies = [\n"
+        " \"serde\",\n"
+        " \"syn 2.0.48\",\n"
+        "]\n"
+        "\n"
+        "[[package]]\n"
+        "name = \"serde\"\n"
+        "version = \"1.0.195\"\n"
+        "source = \"registry+https://github.com/rust-lang/crates.io-index\"\n"
+        "\n"
+        "[[package]]\n"
+        "name = \"syn\"\n"
+        "version = \"1.0.109\"\n"
+        "source = \"registry+https://github.com/rust-lang/crates.io-index\"\n"
+        "\n"
+        "[[package]]\n"
+        "name = \"syn\"\n"
+        "version = \"2.0.48\"\n"
+        "source = \"registry+https://github.com/rust-lang/crates.io-index\"\n";
+
+    CargoLock* lock = cargo_lock_parse_buffer(lock_text, strlen(lock_text));
+    TEST_ASSERT_NOT_NULL(lock, "Cargo.lock should parse");
+    if (!lock) return;
+
+    TEST_ASSERT_EQ(4, lock->package_count, "One entry per [[package]]");
+    const CargoLockPackage* pkg = cargo_lock_find(lock, "engine");
+    TEST_ASSERT(pkg && !pkg->source && pkg->dependency_count == 2, "Workspace member with dependencies");
+    if (pkg && pkg->dependency_count == 2) {
+        TEST_ASSERT_STR_EQ("syn", pkg->dependencies[1], "Versioned dependency entries keep the name");
+    }
+    pkg = cargo_lock_find(lock, "serde");
+    TEST_ASSERT(pkg && strcmp(pkg->version, "1.0.195") == 0, "Locked version");
+    TEST_ASSERT_NULL(cargo_lock_find(lock, "syn"), "Crates locked twice are ambiguous");
+    cargo_lock_destroy(lock);
+}
+
+void test_rust_use_parsing(void) {
+    static const char* source =
+        "//! Crate docs: use fake::Thing;\n"
+        "extern crate alloc;\n"
+        "use std::collections::{HashMap, HashSet};\n"
+        "use serde::{Deserialize, Serialize as Ser};\n"
+        "use tokio::sync::*;\n"
+        "use crate::graph::{self, node::Node};\n"
+        "use super::util;\n"
+        "/* use commented::out; /* nested */ still comment */\n"
+        "fn f<'a>(x: &'a str) -> char {\n"
+        "    let _ = r#\"use raw::string;\"#;\n"
+        "    use serde_json::Value;\n"
+        "    '\\''\n"
+        "}\n";
+
+    ParsedFile* parsed = parse_rust_source_buffer("lib.rs", source, strlen(source));
+    TEST_ASSERT_NOT_NULL(parsed, "Rust source should parse");
+    if (!parsed) return;
+
+    TEST_ASSERT_EQ(8, parsed->dep_count, "Comments and strings are not scanned");
+    const Dependency* dep = find_dependency(parsed, "std");
+    TEST_ASSERT(dep && strcmp(dep->version, "stdlib") == 0 && dep->line_number == 3, "Standard library crate once");
+    TEST_ASSERT(find_dependency(parsed, "alloc") != NULL, "extern crate");
+    dep = find_dependency(parsed, "serde");
+    TEST_ASSERT(dep && dep->type == DEP_EXTERNAL, "External crate root");
+    TEST_ASSERT(find_dependency(parsed, "tokio") != NULL, "Glob import");
+    dep = find_dependency(parsed, "crate::graph");
+    TEST_ASSERT(dep && dep->type == DEP_INTERNAL, "self in a group names the module");
+    TEST_ASSERT(find_dependency(parsed, "crate::graph::node::Node") != NULL, "Nested group path");
+    TEST_ASSERT(find_dependency(parsed, "super::util") != NULL, "super path");
+    dep = find_dependency(parsed, "serde_json");
+    TEST_ASSERT(dep && dep->line_number == 11, "Function-local use after a lifetime");
+    TEST_ASSERT_NULL(find_dependency(parsed, "raw"), "Raw strings are skipped");
+    parsed_file_destroy(parsed);
+}
+
+void run_rust_parser_tests(void) {
+    test_run("cargo_manifest_parsing", test_cargo_manifest_parsing);
+    test_run("rust_use_parsing", test_rust_use_parsing);
+}
@@ -0,0 +1,148 @@
+/**
+ * @file test_shell_parser.c
+ * @brief Shell script reference scanning and script graph tests
+ */
+
+#include "dependency_tracker.h"
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const ShellReference* find_reference(const ShellScript* script, const char* path) {
+    for (size_t i = 0; i < script->reference_count; i++) {
+        if (strcmp(script->references[i].path, path) == 0) return &script->references[i];
+    }
+    return NULL;
+}
+
+void test_shell_reference_scanning(void) {
+    static const char* text =
+        "#!/bin/bash\n"
+        "# source commented.sh\n"
+        "set -euo pipefail\n"
+        "SCRIPT_DIR=\"$(cd \"$(dirname \"${BASH_SOURCE[0]}\")\" && pwd)\"\n"
+        "REPO_ROOT=\"$(cd \"$SCRIPT_DIR/..\" && pwd)\"\n"
+        "source \"$SCRIPT_DIR/lib/common.sh\"\n"
+        ". ./env.sh\n"
+        "PYTHON=./venv/bin/python3\n"
+        "$PYTHON \"$REPO_ROOT/tools/report.py\" --fast 2>&1 | tee out.log\n"
+        "python3 -m pytest tests\n"
+        "bash -c 'echo not-a-script.sh'\n"
+        "echo \"run ./scripts/ignored.sh\"\n"
+        "cat > generated.sh << 'EOF'\n"
+        "./inside-heredoc.sh\n"
+        "EOF\n"
+        "if [ -f x ]; then ./scripts/check.sh --all; fi\n"
+        "(cd tools && ./sub.sh)\n"
+        "./after-subshell.sh\n"
+        "VERSION=$(python3 tools/version.py)\n"
+        "sh \\\n"
+        "  tools/continued.sh\n";
+
+    ShellScript* script = shell_scan_buffer(NULL, "scripts/build.sh", text, strlen(text));
+    TEST_ASSERT_NOT_NULL(script, "Script should scan");
+    if (!script) return;
+
+    const ShellReference* ref = find_reference(script, "scripts/lib/common.sh");
+    TEST_ASSERT(ref && ref->kind == SHELL_SOURCE && ref->line_number == 6, "source through the script directory");
+    ref = find_reference(script, "env.sh");
+    TEST_ASSERT(ref && ref->kind == SHELL_SOURCE, ". is source");
+    ref = find_reference(script, "tools/report.py");
+    TEST_ASSERT(ref && ref->kind == SHELL_PYTHON, "Interpreter named by a variable, root through cd && pwd");
+    TEST_ASSERT_NOT_NULL(find_reference(script, "scripts/check.sh"), "Command after then");
+    TEST_ASSERT_NOT_NULL(find_reference(script, "tools/sub.sh"), "cd applies inside the subshell");
+    TEST_ASSERT_NOT_NULL(find_reference(script, "after-subshell.sh"), "The subshell's cd does not leak");
+    TEST_ASSERT_NOT_NULL(find_reference(script, "tools/version.py"), "Commands in $(...) are scanned");
+    ref = find_reference(script, "tools/continued.sh");
+    TEST_ASSERT(ref && ref->kind == SHELL_EXEC && ref->line_number == 21, "Continued lines keep their line");
+
+    TEST_ASSERT_NULL(find_reference(script, "inside-heredoc.sh"), "Here-document bodies are data");
+    TEST_ASSERT_NULL(find_reference(script, "generated.sh"), "Redirection targets are not commands");
+    TEST_ASSERT_NULL(find_reference(script, "scripts/ignored.sh"), "Arguments of other commands are ignored");
+    TEST_ASSERT_NULL(find_reference(script, "commented.sh"), "Comments are skipped");
+    TEST_ASSERT_EQ(8, script->reference_count, "Only script references are recorded");
+    shell_script_destroy(script);
+
+    // A path longer than any path buffer is dropped, not recorded cut short
+    char long_text[MAX_PATH_LENGTH + 64];
+    int prefix = snprintf(long_text, sizeof(long_text), "source ./");
+    memset(long_text + prefix, 'a', MAX_PATH_LENGTH);
+    snprintf(long_text + prefix + MAX_PATH_LENGTH, sizeof(long_text) - (size_t)prefix - MAX_PATH_LENGTH,
+             ".sh\n./ok.sh\n");
+    script = shell_scan_buffer(NULL, "scripts/long.sh", long_text, strlen(long_text));
+    TEST_ASSERT(script && script->reference_count == 1 && find_reference(script, "ok.sh"),
+                "Only the reference that fits is recorded");
+    shell_script_destroy(script);
+
+    TEST_ASSERT_EQ(LANG_SHELL, deptrack_detect_language("vm/build/profiles/dev.sh"), "Shell scripts are detected");
+}
+
+void test_shell_script_graph(void) {
+    char dir_template[] = "/tmp/deptrack_shell_XXXXXX";
+    char* dir = mkdtemp(dir_template);
+    TEST_ASSERT_NOT_NULL(dir, "Temporary directory should be created");
+    if (!dir) return;
+
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/build", dir);
+    mkdir(path, 0755);
+    snprintf(path, sizeof(path), "%s/build/profiles", dir);
+    mkdir(path, 0755);
+
+    write_fixture(dir, "Makefile",
+        "image:\n"
+        "\t./build/builder.sh\n"
+        "release: image\n"
+        "docs:\n"
+        "\tpython3 build/docs.py\n");
+    write_fixture(dir, "build/builder.sh",
+        "SCRIPT_DIR=\"$(cd \"$(dirname \"$0\")\" && pwd)\"\n"
+        "source \"$SCRIPT_DIR/profiles/$PROFILE.sh\"\n"
+        "python3 build/docs.py\n");
+    write_fixture(dir, "build/profiles/dev.sh", "source ../common.sh\n");
+    write_fixture(dir, "build/profiles/prod.sh", "export MODE=prod\n");
+    write_fixture(dir, "build/common.sh", "true\n");
+    write_fixture(dir, "build/docs.py", "print()\n");
+
+    ShellScript* script = shell_scan_file(dir, "build/builder.sh");
+    TEST_ASSERT(script && script->reference_count == 3, "Unknown variables glob over existing profiles");
+    if (script) {
+        const ShellReference* ref = find_reference(script, "build/profiles/prod.sh");
+        TEST_ASSERT(ref && ref->exists && ref->kind == SHELL_SOURCE, "Globbed profile exists");
+    }
+    shell_script_destroy(script);
+
+    ScriptGraph* graph = script_graph_load(dir);
+    TEST_ASSERT_NOT_NULL(graph, "Script graph should load");
+    if (graph) {
+        bool dependents[32] = { false };
+        TEST_ASSERT(graph->node_count <= 32, "Fixture graph is small");
+        size_t count = script_graph_dependents(graph, "build/profiles/dev.sh", dependents);
+        TEST_ASSERT_EQ(3, count, "builder.sh, make:image and make:release");
+
+        size_t index;
+        TEST_ASSERT(hashmap_get(graph->by_name, "make:release", &index) == 0 && dependents[index],
+                    "Dependents propagate through Makefile prerequisites");
+        TEST_ASSERT(hashmap_get(graph->by_name, "make:docs", &index) == 0 && !dependents[index],
+                    "Unrelated targets are untouched");
+
+        count = script_graph_dependents(graph, "./build/docs.py", dependents);
+        TEST_ASSERT_EQ(4, count, "Script and Makefile users of docs.py");
+        TEST_ASSERT_EQ(0, script_graph_dependents(graph, "nowhere.sh", dependents), "Unknown paths have no users");
+        script_graph_destroy(graph);
+    }
+
+    const char* names[] = {
+        "Makefile", "build/builder.sh", "build/profiles/dev.sh", "build/profiles/prod.sh", "build/common.sh",
+        "build/docs.py", "build/profiles", "build", NULL
+    };
+    for (size_t i = 0; names[i]; i++) {
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        remove(path);
+    }
+    rmdir(dir);
+}
+
+void run_shell_parser_tests(void) {
+    test_run("shell_reference_scanning", test_shell_reference_scanning);
+    test_run("shell_script_graph", test_shell_script_graph);
+}
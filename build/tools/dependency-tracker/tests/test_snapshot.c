@@ -0,0 +1,217 @@
+/**
+ * @file test_snapshot.c
+ * @brief Binary graph snapshot write, mmap open and query tests
+ */
+
+#include "dependency_tracker.h"
+#include <unistd.h>
+
+#define SNAPSHOT_TEST_NODES 3000
+
+static void add_node(DependencyGraph* graph, const char* id, const char* name, NodeType type, const char* path) {
+    GraphNode node = { (char*)id, (char*)name, type, (char*)path, NULL, 0 };
+    graph_add_node(graph, &node);
+}
+
+static void add_edge(DependencyGraph* graph, const char* from, const char* to, DependencyType type,
+                     const char* version) {
+    GraphEdge edge = { (char*)from, (char*)to, type, (char*)version, NULL, 0 };
+    graph_add_edge(graph, &edge);
+}
+
+static bool write_bytes(const char* path, const char* data, size_t length) {
+    FILE* file = fopen(path, "wb");
+    if (!file) return false;
+    bool ok = fwrite(data, 1, length, file) == length;
+    return fclose(file) == 0 && ok;
+}
+
+void test_snapshot_checksum(void) {
+    const SimdIsa isas[] = { SIMD_ISA_SCALAR, SIMD_ISA_SSE42, SIMD_ISA_AVX2 };
+    bool known = true;
+    for (size_t i = 0; i < 3; i++) {
+        known = known && graph_snapshot_checksum("123456789", 9, isas[i]) == 0xE3069283u;
+    }
+    TEST_ASSERT(known, "CRC-32C check value on every instruction set");
+
+    char buffer[1000];
+    for (size_t i = 0; i < sizeof(buffer); i++) buffer[i] = (char)(i * 131 + 7);
+    bool same = true;
+    for (size_t length = 0; length < sizeof(buffer); length += 37) {
+        same = same && graph_snapshot_checksum(buffer, length, SIMD_ISA_SCALAR) ==
+                           graph_snapshot_checksum(buffer, length, SIMD_ISA_AVX2);
+    }
+    TEST_ASSERT(same, "Table and hardware CRC agree at every length");
+}
+
+void test_snapshot_roundtrip(void) {
+    DependencyGraph* graph = graph_create();
+    TEST_ASSERT_NOT_NULL(graph, "Graph should be created");
+    if (!graph) return;
+
+    add_node(graph, "web/app.ts", "app.ts", NODE_LIBRARY, "/repo/web/app.ts");
+    add_node(graph, "react", "react", NODE_LIBRARY, NULL);
+    add_node(graph, "config.yml", "config.yml", NODE_CONFIG, "/repo/config.yml");
+    add_node(graph, "api/server.kt", "server.kt", NODE_SERVICE, "/repo/api/server.kt");
+    add_node(graph, "lonely", "lonely", NODE_FEATURE, NULL);
+    add_edge(graph, "web/app.ts", "react", DEP_EXTERNAL, "^18.2.0");
+    add_edge(graph, "web/app.ts", "config.yml", DEP_CONFIG, NULL);
+    add_edge(graph, "api/server.kt", "config.yml", DEP_CONFIG, NULL);
+    add_edge(graph, "web/app.ts", "react", DEP_EXTERNAL, "^18.3.0");   // Merges into the first
+
+    char path[] = "/tmp/deptrack_snapshot_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) close(fd);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_snapshot_write(graph, NULL, path), "Snapshot is written");
+
+    GraphSnapshot* snapshot = NULL;
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_snapshot_open(path, &snapshot), "Snapshot opens");
+    if (snapshot) {
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_snapshot_verify(snapshot), "Checksum matches");
+        TEST_ASSERT_EQ(5, graph_snapshot_node_count(snapshot), "Node count");
+        TEST_ASSERT_EQ(3, graph_snapshot_edge_count(snapshot), "Edge count");
+        TEST_ASSERT_STR_EQ("api/server.kt", graph_snapshot_node_id(snapshot, 0), "Nodes are numbered by id");
+
+        size_t app = graph_snapshot_find_node(snapshot, "web/app.ts");
+        TEST_ASSERT_EQ(4, app, "Binary search finds the last node");
+        TEST_ASSERT_EQ(SIZE_MAX, graph_snapshot_find_node(snapshot, "missing"), "Unknown ids");
+        TEST_ASSERT_STR_EQ("app.ts", graph_snapshot_node_name(snapshot, app), "Names");
+        TEST_ASSERT_STR_EQ("/repo/web/app.ts", graph_snapshot_node_filepath(snapshot, app), "File paths");
+        TEST_ASSERT_NULL(graph_snapshot_node_filepath(snapshot, graph_snapshot_find_node(snapshot, "react")),
+                         "Missing strings stay NULL");
+        TEST_ASSERT_EQ(NODE_SERVICE, graph_snapshot_node_type(snapshot, 0), "Node types");
+        TEST_ASSERT_NULL(graph_snapshot_node_id(snapshot, 5), "Out of range nodes");
+
+        // config.yml, then react with the smaller of its two versions
+        SnapshotCursor cursor;
+        size_t neighbor, edge;
+        graph_snapshot_dependencies(snapshot, app, &cursor);
+        const char* expected[] = { "config.yml", "react" };
+        const char* versions[] = { NULL, "^18.2.0" };
+        bool listed = true;
+        for (size_t i = 0; i < 2; i++) {
+            listed = listed && snapshot_cursor_next(&cursor, &neighbor, &edge) &&
+                     strcmp(graph_snapshot_node_id(snapshot, neighbor), expected[i]) == 0;
+            const char* version = listed ? graph_snapshot_edge_version(snapshot, edge) : NULL;
+            listed = listed && (versions[i] ? version && strcmp(version, versions[i]) == 0 : version == NULL);
+        }
+        TEST_ASSERT(listed, "Dependencies come with their edges, in order");
+        TEST_ASSERT(!snapshot_cursor_next(&cursor, &neighbor, &edge), "Two dependencies");
+
+        graph_snapshot_dependents(snapshot, graph_snapshot_find_node(snapshot, "config.yml"), &cursor);
+        listed = snapshot_cursor_next(&cursor, &neighbor, &edge) && neighbor == 0 && edge == SIZE_MAX &&
+                 snapshot_cursor_next(&cursor, &neighbor, NULL) && neighbor == app &&
+                 !snapshot_cursor_next(&cursor, NULL, NULL);
+        TEST_ASSERT(listed, "Dependents in id order");
+        graph_snapshot_dependencies(snapshot, graph_snapshot_find_node(snapshot, "lonely"), &cursor);
+        TEST_ASSERT(!snapshot_cursor_next(&cursor, NULL, NULL), "Isolated nodes have no edges");
+        TEST_ASSERT_EQ(DEP_CONFIG, graph_snapshot_edge_type(snapshot, 0), "Edge types");
+        graph_snapshot_close(snapshot);
+    }
+
+    // Damage: a flipped byte fails verification, a truncated file or foreign bytes fail to open
+    size_t length;
+    char* bytes = parser_read_file(path, &length);
+    if (bytes) {
+        bytes[length - 3] ^= 0x40;
+        write_bytes(path, bytes, length);
+        snapshot = NULL;
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_snapshot_open(path, &snapshot), "Opening does not read the data");
+        TEST_ASSERT_EQ(DEPTRACK_ERROR_PARSE_FAILED, graph_snapshot_verify(snapshot), "The checksum catches it");
+        graph_snapshot_close(snapshot);
+
+        write_bytes(path, bytes, length - 8);
+        TEST_ASSERT_EQ(DEPTRACK_ERROR_PARSE_FAILED, graph_snapshot_open(path, &snapshot), "Truncated file");
+        TEST_ASSERT_NULL(snapshot, "No snapshot on failure");
+        write_bytes(path, "{\"nodes\": []}", 13);
+        TEST_ASSERT_EQ(DEPTRACK_ERROR_PARSE_FAILED, graph_snapshot_open(path, &snapshot), "Not a snapshot");
+        free(bytes);
+    }
+    remove(path);
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_FILE_NOT_FOUND, graph_snapshot_open("/nonexistent/deptrack.snap", &snapshot),
+                   "Missing file");
+    graph_destroy(graph);
+}
+
+void test_snapshot_large(void) {
+    DependencyGraph* graph = graph_create();
+    ThreadPool* pool = thread_pool_create(4);
+    TEST_ASSERT(graph && pool, "Setup");
+    if (!graph || !pool) {
+        graph_destroy(graph);
+        thread_pool_destroy(pool);
+        return;
+    }
+
+    char id[32], to[32];
+    for (size_t i = 0; i < SNAPSHOT_TEST_NODES; i++) {
+        snprintf(id, sizeof(id), "n%05zu", i);
+        add_node(graph, id, id, NODE_LIBRARY, NULL);
+    }
+    // Neighbors far apart need multi-byte deltas; node 0 is everyone's dependency
+    size_t expected_edges = 0;
+    for (size_t i = 0; i < SNAPSHOT_TEST_NODES; i++) {
+        snprintf(id, sizeof(id), "n%05zu", i);
+        for (size_t k = 1; k <= i % 5; k++) {
+            snprintf(to, sizeof(to), "n%05zu", (i * 7919 + k * 1543) % SNAPSHOT_TEST_NODES);
+            add_edge(graph, id, to, DEP_INTERNAL, NULL);
+            expected_edges++;
+        }
+        if (i > 0) {
+            add_edge(graph, id, "n00000", DEP_RUNTIME, NULL);
+            expected_edges++;
+        }
+    }
+
+    char path[] = "/tmp/deptrack_snapshot_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd >= 0) close(fd);
+    GraphSnapshot* snapshot = NULL;
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_snapshot_write(graph, pool, path), "Large snapshot is written");
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_snapshot_open(path, &snapshot), "Large snapshot opens");
+    if (snapshot) {
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, graph_snapshot_verify(snapshot), "Checksum matches");
+        TEST_ASSERT_EQ(expected_edges, graph_snapshot_edge_count(snapshot), "Every edge is stored");
+
+        // Adjacency agrees with the graph in both directions
+        size_t out_total = 0, in_total = 0;
+        bool consistent = true;
+        for (size_t node = 0; consistent && node < SNAPSHOT_TEST_NODES; node++) {
+            SnapshotCursor cursor;
+            size_t neighbor, edge, previous = 0;
+            graph_snapshot_dependencies(snapshot, node, &cursor);
+            while (snapshot_cursor_next(&cursor, &neighbor, &edge)) {
+                consistent = consistent && neighbor >= previous && edge == out_total;
+                previous = neighbor;
+                out_total++;
+            }
+            graph_snapshot_dependents(snapshot, node, &cursor);
+            size_t dependents = 0;
+            while (snapshot_cursor_next(&cursor, &neighbor, NULL)) dependents++;
+            in_total += dependents;
+            if (node == 0) consistent = consistent && dependents >= SNAPSHOT_TEST_NODES - 1;
+        }
+        TEST_ASSERT(consistent, "Neighbors ascend and edges are numbered in order");
+        TEST_ASSERT(out_total == expected_edges && in_total == expected_edges, "Both directions hold every edge");
+        graph_snapshot_close(snapshot);
+    }
+
+    // The bytes do not depend on the pool
+    size_t first_length = 0, second_length = 0;
+    char* first = parser_read_file(path, &first_length);
+    graph_snapshot_write(graph, NULL, path);
+    char* second = parser_read_file(path, &second_length);
+    TEST_ASSERT(first && second && first_length == second_length && memcmp(first, second, first_length) == 0,
+                "Snapshots are reproducible");
+    free(first);
+    free(second);
+    remove(path);
+    thread_pool_destroy(pool);
+    graph_destroy(graph);
+}
+
+void run_snapshot_tests(void) {
+    test_run("snapshot_checksum", test_snapshot_checksum);
+    test_run("snapshot_roundtrip", test_snapshot_roundtrip);
+    test_run("snapshot_large", test_snapshot_large);
+}
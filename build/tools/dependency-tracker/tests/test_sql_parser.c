@@ -0,0 +1,209 @@
+/**
+ * @file test_sql_parser.c
+ * @brief SQL migration scanning, streaming and apply-order tests
+ */
+
+#include "dependency_tracker.h"
+#include <unistd.h>
+
+static const SqlObject* find_object(const SqlMigration* m, const char* name, SqlAccess access) {
+    for (size_t i = 0; i < m->object_count; i++) {
+        if (strcmp(m->objects[i].name, name) == 0 && m->objects[i].access == access) return &m->objects[i];
+    }
+    return NULL;
+}
+
+static const char* schema_sql =
+    "-- users and their posts\n"
+    "CREATE TABLE IF NOT EXISTS public.users (\n"
+    "    id serial PRIMARY KEY,\n"
+    "    name text DEFAULT 'it''s; not a statement'\n"
+    ");\n"
+    "CREATE TABLE \"Posts\" (id int, author int REFERENCES users(id), body text);\n"
+    "/* CREATE TABLE commented (id int); /* nested */ still comment */\n"
+    "CREATE OR REPLACE FUNCTION post_count(uid int) RETURNS bigint AS $body$\n"
+    "    SELECT count(*) FROM hidden_in_body WHERE author = uid; -- $notend$\n"
+    "$body$ LANGUAGE sql;\n"
+    "CREATE VIEW author_stats AS\n"
+    "    WITH recent AS (SELECT * FROM \"Posts\" p WHERE p.id > 10)\n"
+    "    SELECT u.name, post_count(u.id), EXTRACT(year FROM now())\n"
+    "    FROM users u, audit.events e JOIN recent r ON r.author = u.id;\n"
+    "CREATE UNIQUE INDEX CONCURRENTLY idx_users_name ON users (name);\n"
+    "DROP TABLE IF EXISTS legacy_a, legacy_b CASCADE;\n"
+    "ALTER TABLE users RENAME TO members;\n"
+    "INSERT INTO members (name) SELECT name FROM staging ON CONFLICT DO UPDATE SET name = E'a\\'b';\n"
+    "COPY members (id, name) FROM stdin;\n"
+    "1\tit's broken; CREATE TABLE not_real (x int);\n"
+    "\\.\n"
+    "DELETE FROM members USING banned WHERE members.id = banned.id;\n";
+
+void test_sql_statement_scanning(void) {
+    SqlMigration* m = sql_scan_buffer("db/V1__schema.sql", schema_sql, strlen(schema_sql));
+    TEST_ASSERT_NOT_NULL(m, "Migration should scan");
+    if (!m) return;
+
+    TEST_ASSERT_STR_EQ("1", m->version, "Flyway version");
+    TEST_ASSERT_EQ(10, m->statement_count, "Strings, comments and COPY data hold no statements");
+
+    const SqlObject* obj = find_object(m, "users", SQL_ACCESS_DEFINE);
+    TEST_ASSERT(obj && obj->kind == SQL_OBJECT_TABLE && obj->line_number == 2, "public. is dropped from names");
+    TEST_ASSERT_NOT_NULL(find_object(m, "Posts", SQL_ACCESS_DEFINE), "Quoted identifiers keep their case");
+    obj = find_object(m, "users", SQL_ACCESS_READ);
+    TEST_ASSERT(obj && obj->kind == SQL_OBJECT_TABLE && obj->statement == 1, "REFERENCES reads the table");
+    obj = find_object(m, "post_count", SQL_ACCESS_DEFINE);
+    TEST_ASSERT(obj && obj->kind == SQL_OBJECT_FUNCTION, "Function definition");
+    TEST_ASSERT_NULL(find_object(m, "hidden_in_body", SQL_ACCESS_READ), "Dollar-quoted bodies are opaque");
+    TEST_ASSERT_NULL(find_object(m, "commented", SQL_ACCESS_DEFINE), "Nested block comments");
+
+    TEST_ASSERT_NOT_NULL(find_object(m, "author_stats", SQL_ACCESS_DEFINE), "View definition");
+    TEST_ASSERT_NULL(find_object(m, "recent", SQL_ACCESS_READ), "CTE names are not relations");
+    TEST_ASSERT_NOT_NULL(find_object(m, "audit.events", SQL_ACCESS_READ), "Comma join of a qualified name");
+    obj = find_object(m, "post_count", SQL_ACCESS_READ);
+    TEST_ASSERT(obj && obj->call && obj->line_number == 13, "Function call candidate");
+    TEST_ASSERT_NULL(find_object(m, "year", SQL_ACCESS_READ), "EXTRACT(x FROM y) is not a FROM clause");
+
+    obj = find_object(m, "users", SQL_ACCESS_WRITE);
+    TEST_ASSERT(obj && obj->line_number == 15, "CREATE INDEX ON writes the table");
+    obj = find_object(m, "legacy_b", SQL_ACCESS_WRITE);
+    TEST_ASSERT(obj && obj->optional, "IF EXISTS carries through a DROP list");
+    obj = find_object(m, "members", SQL_ACCESS_DEFINE);
+    TEST_ASSERT(obj && obj->kind == SQL_OBJECT_TABLE, "RENAME TO defines the new name");
+    TEST_ASSERT_NOT_NULL(find_object(m, "staging", SQL_ACCESS_READ), "INSERT ... SELECT reads its source");
+    TEST_ASSERT_NULL(find_object(m, "not_real", SQL_ACCESS_DEFINE), "COPY data rows are skipped");
+    obj = find_object(m, "banned", SQL_ACCESS_READ);
+    TEST_ASSERT(obj && obj->line_number == 22, "DELETE ... USING, lines counted through COPY data");
+
+    sql_migration_destroy(m);
+}
+
+void test_sql_chunked_streaming(void) {
+    SqlMigration* whole = sql_scan_buffer("schema.sql", schema_sql, strlen(schema_sql));
+    TEST_ASSERT_NOT_NULL(whole, "Whole buffer should scan");
+    if (!whole) return;
+
+    // Every chunk size must produce the same objects as one buffer
+    bool identical = true;
+    size_t length = strlen(schema_sql);
+    for (size_t chunk = 1; chunk <= 13 && identical; chunk += 3) {
+        SqlScanner* scanner = sql_scanner_create("schema.sql");
+        for (size_t offset = 0; offset < length; offset += chunk) {
+            size_t n = length - offset < chunk ? length - offset : chunk;
+            sql_scanner_feed(scanner, schema_sql + offset, n);
+        }
+        SqlMigration* pieces = sql_scanner_finish(scanner);
+        identical = pieces && pieces->object_count == whole->object_count &&
+                    pieces->statement_count == whole->statement_count;
+        for (size_t i = 0; identical && i < whole->object_count; i++) {
+            identical = strcmp(pieces->objects[i].name, whole->objects[i].name) == 0 &&
+                        pieces->objects[i].access == whole->objects[i].access &&
+                        pieces->objects[i].line_number == whole->objects[i].line_number;
+        }
+        sql_migration_destroy(pieces);
+    }
+    TEST_ASSERT(identical, "Chunk boundaries do not change the result");
+
+    // A dump larger than the read chunk streams from disk
+    char path[] = "/tmp/deptrack_sql_XXXXXX";
+    int fd = mkstemp(path);
+    TEST_ASSERT(fd >= 0, "Temporary file should be created");
+    if (fd < 0) {
+        sql_migration_destroy(whole);
+        return;
+    }
+    FILE* file = fdopen(fd, "w");
+    for (int i = 0; i < 4000; i++) {
+        fprintf(file, "CREATE TABLE t%d (id int REFERENCES t%d(id), note text DEFAULT '%*s');\n",
+                i, i > 0 ? i - 1 : 0, 10, "x");
+    }
+    fclose(file);
+
+    SqlMigration* dump = sql_scan_file(path);
+    TEST_ASSERT(dump && dump->statement_count == 4000 && dump->object_count == 8000, "Large file streams in chunks");
+    if (dump) {
+        const SqlObject* last = find_object(dump, "t3999", SQL_ACCESS_DEFINE);
+        TEST_ASSERT(last && last->line_number == 4000, "Line numbers survive chunking");
+    }
+    sql_migration_destroy(dump);
+    unlink(path);
+    sql_migration_destroy(whole);
+}
+
+static SqlMigration* scan(const char* path, const char* text) {
+    return sql_scan_buffer(path, text, strlen(text));
+}
+
+void test_sql_migration_order(void) {
+    char* version = sql_migration_version("migrations/V2_1__add_index.sql");
+    TEST_ASSERT(version && strcmp(version, "2.1") == 0, "Flyway underscores are version separators");
+    free(version);
+    version = sql_migration_version("000042_create_users.up.sql");
+    TEST_ASSERT(version && strcmp(version, "000042") == 0, "Leading digits are the version");
+    free(version);
+    TEST_ASSERT_NULL(sql_migration_version("R__views.sql"), "Repeatable migrations are unversioned");
+
+    SqlMigration* sorted[3] = {
+        scan("V10__c.sql", ""), scan("R__views.sql", ""), scan("V9__b.sql", "")
+    };
+    qsort(sorted, 3, sizeof(SqlMigration*), sql_migration_compare);
+    TEST_ASSERT(strcmp(sorted[0]->filepath, "V9__b.sql") == 0 && strcmp(sorted[2]->filepath, "R__views.sql") == 0,
+                "Numeric version order, repeatables last");
+    for (size_t i = 0; i < 3; i++) {
+        sql_migration_destroy(sorted[i]);
+    }
+
+    SqlMigrationSet* set = sql_migration_set_create();
+    sql_migration_set_add(set, scan("V1__users.sql", "CREATE TABLE users (id int);"));
+    sql_migration_set_add(set, scan("V2__teams.sql", "CREATE TABLE teams (id int);"));
+    sql_migration_set_add(set, scan("V3__members.sql",
+        "CREATE TABLE members (u int REFERENCES users, t int REFERENCES teams(id));"));
+    sql_migration_set_add(set, scan("V4__users_email.sql", "ALTER TABLE users ADD COLUMN email text;"));
+    sql_migration_set_add(set, scan("V5__report.sql",
+        "CREATE VIEW report AS SELECT * FROM members m JOIN team_totals(m.t) x ON true;"));
+    sql_migration_set_add(set, scan("V6__totals.sql",
+        "CREATE FUNCTION team_totals(int) RETURNS int AS $$ SELECT 1 $$ LANGUAGE sql;"
+        "SELECT count(*) FROM teams;"));
+
+    DagSchedule schedule;
+    int result = sql_migration_set_order(set, &schedule);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Apply order exists");
+    if (result == DEPTRACK_SUCCESS) {
+        // users, teams | members, totals | email, report
+        TEST_ASSERT_EQ(3, schedule.wave_count, "Independent migrations share a wave");
+        TEST_ASSERT(schedule.wave_of[0] == 0 && schedule.wave_of[1] == 0, "Creates of unrelated tables run together");
+        TEST_ASSERT(schedule.wave_of[3] > schedule.wave_of[2], "ALTER of users waits for migrations reading users");
+        TEST_ASSERT(schedule.wave_of[4] > schedule.wave_of[5], "The view waits for the function defined after it");
+        dag_schedule_destroy(&schedule);
+    }
+
+    SqlForwardReference* forward = NULL;
+    size_t count = 0;
+    result = sql_migration_set_forward_references(set, &forward, &count);
+    TEST_ASSERT(result == DEPTRACK_SUCCESS && count == 1, "One forward reference");
+    if (count == 1) {
+        const SqlObject* obj = &set->migrations[forward[0].migration]->objects[forward[0].object];
+        TEST_ASSERT(forward[0].migration == 4 && forward[0].defined_in == 5 && strcmp(obj->name, "team_totals") == 0,
+                    "The view calls a function created later");
+    }
+    free(forward);
+    sql_migration_set_destroy(set);
+
+    // Within one file, a use before the CREATE is flagged; DROP IF EXISTS is not
+    set = sql_migration_set_create();
+    sql_migration_set_add(set, scan("V1__init.sql",
+        "DROP TABLE IF EXISTS a;\nINSERT INTO b VALUES (1);\nCREATE TABLE a (id int);\nCREATE TABLE b (id int);\n"));
+    result = sql_migration_set_forward_references(set, &forward, &count);
+    TEST_ASSERT(result == DEPTRACK_SUCCESS && count == 1, "Same-file forward reference");
+    if (count == 1) {
+        TEST_ASSERT_EQ(2, set->migrations[0]->objects[forward[0].object].line_number, "INSERT before CREATE");
+    }
+    free(forward);
+    sql_migration_set_destroy(set);
+
+    TEST_ASSERT_EQ(LANG_SQL, deptrack_detect_language("db/V1__init.sql"), "SQL files should be detected");
+}
+
+void run_sql_parser_tests(void) {
+    test_run("sql_statement_scanning", test_sql_statement_scanning);
+    test_run("sql_chunked_streaming", test_sql_chunked_streaming);
+    test_run("sql_migration_order", test_sql_migration_order);
+}
@@ -0,0 +1,261 @@
+/**
+ * @file test_thread_pool.c
+ * @brief Work-stealing deque, task group and parallel-for tests
+ */
+
+#include "dependency_tracker.h"
+#include <stdatomic.h>
+#include <unistd.h>
+
+#define DEQUE_STRESS_ITEMS 50000
+#define DEQUE_STRESS_THIEVES 3
+
+typedef struct {
+    WorkDeque* deque;
+    atomic_bool* done;
+    size_t sum;
+    size_t count;
+} Thief;
+
+static void* thief_main(void* arg) {
+    Thief* thief = arg;
+    for (;;) {
+        bool finished = atomic_load(thief->done);
+        void* item = work_deque_steal(thief->deque);
+        if (item) {
+            thief->sum += (uintptr_t)item;
+            thief->count++;
+        } else if (finished) {
+            return NULL;
+        }
+    }
+}
+
+void test_work_deque(void) {
+    WorkDeque* deque = work_deque_create();
+    TEST_ASSERT_NOT_NULL(deque, "Deque should be created");
+    if (!deque) return;
+
+    TEST_ASSERT_NULL(work_deque_pop(deque), "New deque is empty");
+    TEST_ASSERT_NULL(work_deque_steal(deque), "Nothing to steal");
+    bool pushed = true;
+    for (uintptr_t i = 1; i <= 200; i++) {
+        pushed = pushed && work_deque_push(deque, (void*)i);
+    }
+    TEST_ASSERT(pushed, "Pushes grow the array past its initial size");
+    TEST_ASSERT_EQ(200, work_deque_size(deque), "Size counts every item");
+    TEST_ASSERT_EQ(200, (uintptr_t)work_deque_pop(deque), "The owner pops the newest item");
+    TEST_ASSERT_EQ(1, (uintptr_t)work_deque_steal(deque), "Thieves take the oldest");
+    while (work_deque_pop(deque)) {
+    }
+    TEST_ASSERT_EQ(0, work_deque_size(deque), "Drained");
+    work_deque_destroy(deque);
+
+    // The owner pushes and pops while thieves steal: every item is taken exactly once
+    deque = work_deque_create();
+    if (!deque) return;
+    atomic_bool done;
+    atomic_init(&done, false);
+    Thief thieves[DEQUE_STRESS_THIEVES];
+    pthread_t threads[DEQUE_STRESS_THIEVES];
+    for (size_t t = 0; t < DEQUE_STRESS_THIEVES; t++) {
+        thieves[t] = (Thief){ deque, &done, 0, 0 };
+        pthread_create(&threads[t], NULL, thief_main, &thieves[t]);
+    }
+    size_t owner_sum = 0;
+    size_t owner_count = 0;
+    for (uintptr_t i = 1; i <= DEQUE_STRESS_ITEMS; i++) {
+        while (!work_deque_push(deque, (void*)i)) {
+        }
+        if (i % 3 == 0) {
+            void* item = work_deque_pop(deque);
+            if (item) {
+                owner_sum += (uintptr_t)item;
+                owner_count++;
+            }
+        }
+    }
+    void* item;
+    while ((item = work_deque_pop(deque)) != NULL) {
+        owner_sum += (uintptr_t)item;
+        owner_count++;
+    }
+    atomic_store(&done, true);
+    size_t total = owner_sum;
+    size_t count = owner_count;
+    for (size_t t = 0; t < DEQUE_STRESS_THIEVES; t++) {
+        pthread_join(threads[t], NULL);
+        total += thieves[t].sum;
+        count += thieves[t].count;
+    }
+    TEST_ASSERT_EQ((size_t)DEQUE_STRESS_ITEMS, count, "No item lost or taken twice");
+    TEST_ASSERT_EQ((size_t)DEQUE_STRESS_ITEMS * (DEQUE_STRESS_ITEMS + 1) / 2, total, "Items are intact");
+    work_deque_destroy(deque);
+}
+
+typedef struct {
+    TaskGroup* group;
+    atomic_size_t* counter;
+    int depth;
+} TreeTask;
+
+// Every task spawns two children into the same group until depth runs out: 2^(depth+1) - 1 tasks
+static void tree_task(void* arg) {
+    TreeTask* task = arg;
+    atomic_fetch_add(task->counter, 1);
+    if (task->depth > 0) {
+        for (int i = 0; i < 2; i++) {
+            TreeTask* child = malloc(sizeof(TreeTask));
+            if (!child) break;
+            *child = (TreeTask){ task->group, task->counter, task->depth - 1 };
+            if (task_group_spawn(task->group, tree_task, child) != DEPTRACK_SUCCESS) free(child);
+        }
+    }
+    free(task);
+}
+
+typedef struct {
+    ThreadPool* pool;
+    atomic_size_t* counter;
+} NestedTask;
+
+// Waits on a group of its own from inside a worker
+static void nested_task(void* arg) {
+    NestedTask* nested = arg;
+    TaskGroup* inner = task_group_create(nested->pool);
+    if (!inner) return;
+    TreeTask* root = malloc(sizeof(TreeTask));
+    if (root) {
+        *root = (TreeTask){ inner, nested->counter, 3 };
+        if (task_group_spawn(inner, tree_task, root) != DEPTRACK_SUCCESS) free(root);
+    }
+    task_group_wait(inner);
+    task_group_destroy(inner);
+}
+
+static void count_task(void* arg) {
+    atomic_fetch_add((atomic_size_t*)arg, 1);
+}
+
+void test_task_groups(void) {
+    ThreadPool* pool = thread_pool_create(4);
+    TEST_ASSERT_NOT_NULL(pool, "Pool should start");
+    if (!pool) return;
+    TEST_ASSERT_EQ(4, thread_pool_size(pool), "Requested worker count");
+    TEST_ASSERT(!thread_pool_in_worker(pool), "The test thread is not a worker");
+
+    atomic_size_t counter;
+    atomic_init(&counter, 0);
+    TaskGroup* group = task_group_create(pool);
+    TreeTask* root = malloc(sizeof(TreeTask));
+    if (group && root) {
+        *root = (TreeTask){ group, &counter, 10 };
+        task_group_spawn(group, tree_task, root);
+        TEST_ASSERT_EQ(DEPTRACK_SUCCESS, task_group_wait(group), "Wait succeeds");
+        TEST_ASSERT_EQ(2047, atomic_load(&counter), "Tasks spawned by tasks are waited for");
+    }
+    task_group_destroy(group);
+
+    // More nested waits than workers: waiting threads run tasks instead of blocking
+    atomic_store(&counter, 0);
+    group = task_group_create(pool);
+    NestedTask nested = { pool, &counter };
+    for (int i = 0; group && i < 16; i++) {
+        task_group_spawn(group, nested_task, &nested);
+    }
+    task_group_wait(group);
+    TEST_ASSERT_EQ(16 * 15, atomic_load(&counter), "Nested groups complete");
+    task_group_destroy(group);
+
+    // Cancelled before the workers get to them, the queued tasks are dropped
+    atomic_store(&counter, 0);
+    group = task_group_create(pool);
+    task_group_cancel(group);
+    TEST_ASSERT(task_group_cancelled(group), "Cancel is visible");
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_CANCELLED, task_group_spawn(group, count_task, &counter),
+                   "A cancelled group takes no new tasks");
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_CANCELLED, task_group_wait(group), "Wait reports the cancellation");
+    TEST_ASSERT_EQ(0, atomic_load(&counter), "Nothing ran");
+    task_group_destroy(group);
+
+    // Deferred tasks from outside the pool still run
+    group = task_group_create(pool);
+    for (int i = 0; group && i < 100; i++) {
+        task_group_defer(group, count_task, &counter);
+    }
+    task_group_wait(group);
+    TEST_ASSERT_EQ(100, atomic_load(&counter), "Deferred tasks run");
+    task_group_destroy(group);
+
+    thread_pool_destroy(pool);
+}
+
+typedef struct {
+    const uint32_t* values;
+    atomic_ullong sum;
+    atomic_size_t calls;
+    size_t largest;
+    pthread_mutex_t mutex;
+} SumContext;
+
+static void sum_range(size_t begin, size_t end, void* context) {
+    SumContext* sum = context;
+    unsigned long long local = 0;
+    for (size_t i = begin; i < end; i++) local += sum->values[i];
+    atomic_fetch_add(&sum->sum, local);
+    atomic_fetch_add(&sum->calls, 1);
+    pthread_mutex_lock(&sum->mutex);
+    if (end - begin > sum->largest) sum->largest = end - begin;
+    pthread_mutex_unlock(&sum->mutex);
+}
+
+void test_parallel_for(void) {
+    enum { COUNT = 100000 };
+    uint32_t* values = malloc(COUNT * sizeof(uint32_t));
+    ThreadPool* pool = thread_pool_create(3);
+    TEST_ASSERT(values && pool, "Setup");
+    if (!values || !pool) {
+        free(values);
+        thread_pool_destroy(pool);
+        return;
+    }
+    unsigned long long expected = 0;
+    for (size_t i = 0; i < COUNT; i++) {
+        values[i] = (uint32_t)(i * 7 + 3);
+        expected += values[i];
+    }
+
+    SumContext sum = { .values = values };
+    pthread_mutex_init(&sum.mutex, NULL);
+    atomic_init(&sum.sum, 0);
+    atomic_init(&sum.calls, 0);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, thread_pool_parallel_for(pool, 0, COUNT, 1000, sum_range, &sum),
+                   "Parallel-for succeeds");
+    TEST_ASSERT_EQ(expected, atomic_load(&sum.sum), "Every index is visited once");
+    TEST_ASSERT(sum.largest <= 1000, "Subranges respect the grain");
+    TEST_ASSERT(atomic_load(&sum.calls) >= COUNT / 1000, "The range is split");
+
+    atomic_store(&sum.sum, 0);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, thread_pool_parallel_for(pool, 10, COUNT, 0, sum_range, &sum),
+                   "Automatic grain");
+    TEST_ASSERT_EQ(expected - (0 * 7 + 3) * 10 - 7 * 45, atomic_load(&sum.sum), "Offset ranges");
+
+    atomic_store(&sum.sum, 0);
+    atomic_store(&sum.calls, 0);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, thread_pool_parallel_for(NULL, 0, COUNT, 0, sum_range, &sum),
+                   "No pool runs serially");
+    TEST_ASSERT(atomic_load(&sum.sum) == expected && atomic_load(&sum.calls) == 1, "One call without a pool");
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, thread_pool_parallel_for(pool, 5, 5, 0, sum_range, &sum), "Empty range");
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_INVALID_PARAM, thread_pool_parallel_for(pool, 6, 5, 0, sum_range, &sum),
+                   "Reversed range");
+
+    pthread_mutex_destroy(&sum.mutex);
+    thread_pool_destroy(pool);
+    free(values);
+}
+
+void run_thread_pool_tests(void) {
+    test_run("work_deque", test_work_deque);
+    test_run("task_groups", test_task_groups);
+    test_run("parallel_for", test_parallel_for);
+}
@@ -0,0 +1,161 @@
+/**
+ * @file test_toml_parser.c
+ * @brief TOML reader and Gradle version catalog tests
+ */
+
+#include "dependency_tracker.h"
+
+typedef struct {
+    char keys[16][64];
+    char values[16][64];
+    size_t array_index[16];
+    size_t table_index[16];
+    TomlValueType types[16];
+    int lines[16];
+    size_t count;
+} TomlCapture;
+
+static int capture_value(const TomlValue* value, void* context) {
+    TomlCapture* capture = context;
+    if (capture->count >= 16) return DEPTRACK_SUCCESS;
+
+    size_t i = capture->count++;
+    char* key = capture->keys[i];
+    key[0] = '\0';
+    for (size_t d = 0; d < value->depth; d++) {
+        snprintf(key + strlen(key), 64 - strlen(key), "%s%.*s", d ? "/" : "",
+                 (int)value->path_lengths[d], value->path[d]);
+    }
+    snprintf(capture->values[i], 64, "%.*s", (int)value->value_length, value->value);
+    capture->array_index[i] = value->array_index;
+    capture->table_index[i] = value->table_index;
+    capture->types[i] = value->type;
+    capture->lines[i] = value->line_number;
+    return DEPTRACK_SUCCESS;
+}
+
+void test_toml_reader(void) {
+    static const char* toml =
+        "# comment\n"
+        "title = \"a \\\"quoted\\\" \\u00e9\" # trailing\n"
+        "[server.\"http-v2\"]\n"
+        "port = 8_080\n"
+        "ratio = 0.5\n"
+        "enabled = true\n"
+        "deps = [\n"
+        "  'one', # first\n"
+        "  { name = \"two\", opt.in = false },\n"
+        "]\n"
+        "notes = \"\"\"\n"
+        "line\"\"\"\n"
+        "[[package]]\n"
+        "name = \"a\"\n"
+        "[[package]]\n"
+        "name = \"b\"\n";
+
+    TomlCapture capture;
+    memset(&capture, 0, sizeof(capture));
+    int result = toml_parse_buffer(toml, strlen(toml), capture_value, &capture);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Valid TOML should parse");
+    TEST_ASSERT_EQ(10, capture.count, "Every scalar should be visited once");
+    if (capture.count != 10) return;
+
+    TEST_ASSERT_STR_EQ("a \"quoted\" \xc3\xa9", capture.values[0], "Escapes should be decoded");
+    TEST_ASSERT_STR_EQ("server/http-v2/port", capture.keys[1], "Quoted header keys should be unquoted");
+    TEST_ASSERT_EQ(TOML_INTEGER, capture.types[1], "Integers keep their source text");
+    TEST_ASSERT_EQ(TOML_FLOAT, capture.types[2], "Floats should be classified");
+    TEST_ASSERT_EQ(TOML_BOOLEAN, capture.types[3], "Booleans should be classified");
+    TEST_ASSERT_STR_EQ("one", capture.values[4], "Literal strings should be read");
+    TEST_ASSERT_EQ(0, capture.array_index[4], "Array elements carry their index");
+    TEST_ASSERT_STR_EQ("server/http-v2/deps/name", capture.keys[5], "Inline tables extend the path");
+    TEST_ASSERT_EQ(1, capture.array_index[5], "Inline tables inside arrays keep the element index");
+    TEST_ASSERT_STR_EQ("server/http-v2/deps/opt/in", capture.keys[6], "Dotted keys split into components");
+    TEST_ASSERT_STR_EQ("line", capture.values[7], "Leading newline of multi-line strings is trimmed");
+    TEST_ASSERT_EQ(11, capture.lines[7], "Multi-line values report their starting line");
+    TEST_ASSERT(capture.table_index[8] != capture.table_index[9], "Array tables should be distinguishable");
+
+    static const char* broken = "key = \"unterminated\n";
+    memset(&capture, 0, sizeof(capture));
+    result = toml_parse_buffer(broken, strlen(broken), capture_value, &capture);
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_PARSE_FAILED, result, "Unterminated strings should fail");
+}
+
+static const char* CATALOG =
+    "[versions]\n"
+    "kotlin = \"1.9.22\"\n"
+    "ktor = { strictly = \"2.3.7\" }\n"
+    "\n"
+    "[libraries]\n"
+    "ktor-server-core = { module = \"io.ktor:ktor-server-core\", version.ref = \"ktor\" }\n"
+    "ktor-server-netty = { group = \"io.ktor\", name = \"ktor-server-netty\", version = { ref = \"ktor\" } }\n"
+    "kotlinx_coroutines_core = \"org.jetbrains.kotlinx:kotlinx-coroutines-core:1.7.3\"\n"
+    "spring-boot-starter = { module = \"org.springframework.boot:spring-boot-starter\" }\n"
+    "\n"
+    "[bundles]\n"
+    "ktor = [\"ktor-server-core\", \"ktor-server-netty\"]\n"
+    "\n"
+    "[plugins]\n"
+    "kotlin-jvm = { id = \"org.jetbrains.kotlin.jvm\", version.ref = \"kotlin\" }\n"
+    "ktlint = \"org.jlleitschuh.gradle.ktlint:12.0.3\"\n";
+
+void test_version_catalog(void) {
+    VersionCatalog* catalog = version_catalog_create("/repo");
+    TEST_ASSERT_NOT_NULL(catalog, "Catalog should be created");
+    if (!catalog) return;
+
+    int result = version_catalog_add_buffer(catalog, "libs", CATALOG, strlen(CATALOG));
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Catalog should load");
+
+    const char* accessor = "libs.ktor.server.core";
+    const CatalogEntry* entry = version_catalog_find(catalog, accessor, strlen(accessor));
+    TEST_ASSERT(entry && strcmp(entry->module, "io.ktor:ktor-server-core") == 0, "Module should be read");
+    TEST_ASSERT(entry && entry->version && strcmp(entry->version, "2.3.7") == 0, "version.ref should resolve");
+
+    accessor = "libs.ktor.server.netty";
+    entry = version_catalog_find(catalog, accessor, strlen(accessor));
+    TEST_ASSERT(entry && strcmp(entry->module, "io.ktor:ktor-server-netty") == 0, "group/name should combine");
+
+    accessor = "libs.plugins.kotlin.jvm";
+    entry = version_catalog_find(catalog, accessor, strlen(accessor));
+    TEST_ASSERT(entry && entry->kind == CATALOG_PLUGIN && strcmp(entry->version, "1.9.22") == 0,
+                "Plugin version.ref should resolve");
+
+    accessor = "libs.spring.boot.starter";
+    entry = version_catalog_find(catalog, accessor, strlen(accessor));
+    TEST_ASSERT(entry && entry->version == NULL, "Platform-managed libraries have no version");
+
+    static const char* script =
+        "plugins { alias(libs.plugins.ktlint) }\n"
+        "dependencies {\n"
+        "    implementation(libs.kotlinx.coroutines.core)\n"
+        "    implementation(libs.bundles.ktor)\n"
+        "    implementation(libs.missing.alias)\n"
+        "    implementation(\"com.example:direct:1.0\")\n"
+        "}\n";
+    ParsedFile* parsed = parse_gradle_buffer("build.gradle.kts", script, strlen(script));
+    TEST_ASSERT_NOT_NULL(parsed, "Build script should parse");
+    if (parsed) {
+        size_t resolved = version_catalog_resolve(catalog, parsed);
+        TEST_ASSERT_EQ(4, resolved, "Plugin, library and both bundle members should resolve");
+        TEST_ASSERT_EQ(6, parsed->dep_count, "Bundle should expand in place");
+        if (parsed->dep_count == 6) {
+            TEST_ASSERT_STR_EQ("org.jlleitschuh.gradle.ktlint", parsed->dependencies[0].name, "Plugin id");
+            TEST_ASSERT_STR_EQ("12.0.3", parsed->dependencies[0].version, "Plugin version");
+            TEST_ASSERT_STR_EQ("org.jetbrains.kotlinx:kotlinx-coroutines-core", parsed->dependencies[1].name,
+                               "Underscore aliases map to dotted accessors");
+            TEST_ASSERT_STR_EQ("1.7.3", parsed->dependencies[1].version, "Inline version");
+            TEST_ASSERT_STR_EQ("io.ktor:ktor-server-core", parsed->dependencies[2].name, "First bundle member");
+            TEST_ASSERT_EQ(RESOLVE_NOT_FOUND, parsed->dependencies[3].status, "Unknown alias is flagged");
+            TEST_ASSERT_STR_EQ("1.0", parsed->dependencies[4].version, "Direct coordinates are untouched");
+            TEST_ASSERT_STR_EQ("io.ktor:ktor-server-netty", parsed->dependencies[5].name, "Appended bundle member");
+        }
+        parsed_file_destroy(parsed);
+    }
+
+    version_catalog_destroy(catalog);
+}
+
+void run_toml_parser_tests(void) {
+    test_run("toml_reader", test_toml_reader);
+    test_run("version_catalog", test_version_catalog);
+}
@@ -5,17 +5,122 @@
 
 #include "dependency_tracker.h"
 
-void test_typescript_package_parsing(void) {
-    // TODO: Implement TypeScript package.json parsing tests
-    TEST_ASSERT(true, "TypeScript package parsing test placeholder");
+static const Dependency* find_dependency(const ParsedFile* parsed, const char* name) {
+    for (size_t i = 0; i < parsed->dep_count; i++) {
+        if (strcmp(parsed->dependencies[i].name, name) == 0) return &parsed->dependencies[i];
+    }
+    return NULL;
+}
+
+void test_typescript_bare_specifiers(void) {
+    static const char* text =
+        "import React from 'react';\n"
+        "import { render } from \"react-dom/client\";\n"
+        "import type { Schema } from '@scope/schema/v2';\n"
+        "const fs = require('node:fs');\n"
+        "export * from 'lodash';\n";
+
+    ParsedFile* parsed = typescript_parse_buffer("web/app.tsx", text, strlen(text), NULL);
+    TEST_ASSERT_NOT_NULL(parsed, "Source should parse");
+    if (!parsed) return;
+
+    TEST_ASSERT_EQ(5, parsed->dep_count, "One dependency per module load");
+    const Dependency* dep = find_dependency(parsed, "react-dom");
+    TEST_ASSERT(dep && dep->type == DEP_EXTERNAL && dep->line_number == 2, "Subpaths reduce to the package");
+    TEST_ASSERT_NOT_NULL(find_dependency(parsed, "@scope/schema"), "Scoped packages keep their scope");
+    TEST_ASSERT_NOT_NULL(find_dependency(parsed, "node:fs"), "require() is a module load");
+    TEST_ASSERT_NOT_NULL(find_dependency(parsed, "lodash"), "Re-exports are module loads");
+    parsed_file_destroy(parsed);
+
+    TEST_ASSERT_EQ(LANG_TYPESCRIPT, deptrack_detect_language("web/src/index.ts"), "TypeScript is detected");
 }
 
 void test_typescript_import_parsing(void) {
-    // TODO: Implement TypeScript import parsing tests
-    TEST_ASSERT(true, "TypeScript import parsing test placeholder");
+    static const char* text =
+        "import {\n"
+        "  a,\n"
+        "  b,\n"
+        "} from './local/module';\n"
+        "import './styles.css';\n"
+        "const lazy = () => import('../pages/Lazy');\n"
+        "export const value = 1;\n"
+        "export {\n"
+        "  c,\n"
+        "} from '../shared';\n"
+        "const dynamic = import(`./locale/${lang}`);\n"
+        "obj.require('not-a-module');\n"
+        "const reimported = 'import x from y';\n"
+        "if (import.meta.env) {}\n"
+        "// import { gone } from './commented';\n"
+        "/* export * from './block-commented'; */\n"
+        "const doc = \"require('in-a-string')\";\n"
+        "import def, /* from 'nope' */ { e } from './after-comment';\n";
+
+    ParsedFile* parsed = typescript_parse_buffer("web/src/app.ts", text, strlen(text), NULL);
+    TEST_ASSERT_NOT_NULL(parsed, "Source should parse");
+    if (!parsed) return;
+
+    const Dependency* dep = find_dependency(parsed, "./local/module");
+    TEST_ASSERT(dep && dep->type == DEP_INTERNAL && dep->line_number == 1, "Multi-line import clause");
+    TEST_ASSERT_NOT_NULL(find_dependency(parsed, "./styles.css"), "Side-effect import");
+    dep = find_dependency(parsed, "../pages/Lazy");
+    TEST_ASSERT(dep && dep->line_number == 6, "Dynamic import()");
+    dep = find_dependency(parsed, "../shared");
+    TEST_ASSERT(dep && dep->line_number == 8, "Multi-line re-export");
+    TEST_ASSERT_NULL(find_dependency(parsed, "not-a-module"), "Property calls are not module loads");
+    TEST_ASSERT_NULL(find_dependency(parsed, "./commented"), "Line comments are masked");
+    TEST_ASSERT_NULL(find_dependency(parsed, "./block-commented"), "Block comments are masked");
+    TEST_ASSERT_NULL(find_dependency(parsed, "in-a-string"), "Strings are masked");
+    dep = find_dependency(parsed, "./after-comment");
+    TEST_ASSERT(dep && dep->line_number == 18, "Comments inside a clause are skipped");
+    TEST_ASSERT_EQ(5, parsed->dep_count, "Interpolated, masked and non-module uses are skipped");
+    parsed_file_destroy(parsed);
+}
+
+void test_typescript_package_json(void) {
+    static const char* text =
+        "{\n"
+        "  \"name\": \"web\",\n"
+        "  \"version\": \"1.2.0\",\n"
+        "  \"scripts\": { \"build\": \"tsc\" },\n"
+        "  \"dependencies\": {\n"
+        "    \"react\": \"^18.2.0\",\n"
+        "    \"lodash.merge\": \"4.6.2\",\n"
+        "    \"@scope/ui\": \"workspace:*\"\n"
+        "  },\n"
+        "  \"devDependencies\": { \"typescript\": \"~5.4.0\", \"shared\": \"file:../shared\" },\n"
+        "  \"workspaces\": [\"packages/a\"],\n"
+        "  \"config\": { \"dependencies\": { \"nested\": \"1\" } }\n"
+        "}\n";
+
+    TEST_ASSERT(typescript_is_manifest("web/package.json"), "package.json is a manifest");
+    TEST_ASSERT(!typescript_is_manifest("web/package.json.ts"), "Sources are not manifests");
+    TEST_ASSERT_EQ(LANG_TYPESCRIPT, deptrack_detect_language("web/package.json"), "package.json is detected");
+
+    ParsedFile* parsed = parse_package_json_buffer("web/package.json", text, strlen(text));
+    TEST_ASSERT_NOT_NULL(parsed, "Manifest should parse");
+    if (!parsed) return;
+
+    TEST_ASSERT_EQ(5, parsed->dep_count, "Only dependency section entries are dependencies");
+    const Dependency* dep = find_dependency(parsed, "react");
+    TEST_ASSERT(dep && dep->type == DEP_EXTERNAL && dep->line_number == 6, "Registry packages are external");
+    TEST_ASSERT(dep && dep->version && strcmp(dep->version, "^18.2.0") == 0, "The range is the version");
+    dep = find_dependency(parsed, "lodash.merge");
+    TEST_ASSERT(dep && dep->line_number == 7, "Dotted package names stay whole");
+    dep = find_dependency(parsed, "@scope/ui");
+    TEST_ASSERT(dep && dep->type == DEP_INTERNAL, "Workspace packages are internal");
+    dep = find_dependency(parsed, "shared");
+    TEST_ASSERT(dep && dep->type == DEP_INTERNAL && dep->line_number == 10, "file: packages are internal");
+    TEST_ASSERT_NOT_NULL(find_dependency(parsed, "typescript"), "devDependencies are read");
+    TEST_ASSERT_NULL(find_dependency(parsed, "nested"), "Nested dependencies members are not sections");
+    parsed_file_destroy(parsed);
+
+    TEST_ASSERT_NULL(parse_package_json_buffer("package.json", "{\"dependencies\": {", 17),
+                     "Malformed manifests do not parse");
 }
 
 void run_typescript_parser_tests(void) {
-    test_run("typescript_package_parsing", test_typescript_package_parsing);
+    test_run("typescript_bare_specifiers", test_typescript_bare_specifiers);
     test_run("typescript_import_parsing", test_typescript_import_parsing);
+    test_run("typescript_package_json", test_typescript_package_json);
 }
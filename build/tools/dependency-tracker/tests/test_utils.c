@@ -1,10 +1,20 @@
 /**
  * @file test_utils.c
- * @brief Utility function tests
+ * @brief Utility function tests and the shared fixture writer
  */
 
 #include "dependency_tracker.h"
 
+void write_fixture(const char* dir, const char* name, const char* content) {
+    char path[MAX_PATH_LENGTH];
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    FILE* file = fopen(path, "w");
+    if (file) {
+        fputs(content, file);
+        fclose(file);
+    }
+}
+
 void test_string_utilities(void) {
     // TODO: Implement string utility tests
     TEST_ASSERT(true, "String utilities test placeholder");
@@ -5,14 +5,129 @@
 
 #include "dependency_tracker.h"
 
+static const char* COMPOSE_FIXTURE =
+    "# @llm-type config.build\n"
+    "version: '3.8'\n"
+    "\n"
+    "services:\n"
+    "  llm:\n"
+    "    build:\n"
+    "      context: .\n"
+    "      dockerfile: Dockerfile.llm\n"
+    "    volumes:\n"
+    "      - llm-models:/models\n"
+    "\n"
+    "  database:\n"
+    "    image: \"postgres:15-alpine\"  # pinned\n"
+    "    volumes:\n"
+    "      - postgres-data:/var/lib/postgresql/data\n"
+    "      - ./database/init:/docker-entrypoint-initdb.d:ro\n"
+    "      - /anonymous\n"
+    "\n"
+    "  backend:\n"
+    "    build: ./backend\n"
+    "    depends_on:\n"
+    "      database:\n"
+    "        condition: service_healthy\n"
+    "      llm:\n"
+    "        condition: service_started\n"
+    "    volumes:\n"
+    "      - type: bind\n"
+    "        source: ./backend/config\n"
+    "        target: /app/config\n"
+    "\n"
+    "  frontend:\n"
+    "    image: node:20\n"
+    "    depends_on: [backend, \"external-auth\"]\n"
+    "\n"
+    "volumes:\n"
+    "  llm-models:\n"
+    "  postgres-data:\n";
+
 void test_yaml_docker_compose_parsing(void) {
-    // TODO: Implement YAML docker-compose parsing tests
-    TEST_ASSERT(true, "YAML docker-compose parsing test placeholder");
+    ComposeFile* compose = compose_parse_buffer(COMPOSE_FIXTURE, strlen(COMPOSE_FIXTURE));
+    TEST_ASSERT_NOT_NULL(compose, "Compose buffer should parse");
+    if (!compose) return;
+
+    TEST_ASSERT_EQ(4, compose->service_count, "Top-level volumes must not be read as services");
+
+    int llm = compose_find_service(compose, "llm");
+    int database = compose_find_service(compose, "database");
+    int backend = compose_find_service(compose, "backend");
+    int frontend = compose_find_service(compose, "frontend");
+    TEST_ASSERT(llm >= 0 && database >= 0 && backend >= 0 && frontend >= 0, "All services should be found");
+
+    if (llm >= 0 && database >= 0 && backend >= 0 && frontend >= 0) {
+        const ComposeService* s = &compose->services[llm];
+        TEST_ASSERT_STR_EQ(".", s->build_context, "build.context should be extracted");
+        TEST_ASSERT_EQ(1, s->volume_count, "llm should have one volume");
+        TEST_ASSERT_STR_EQ("llm-models", s->volumes[0], "Named volume source should be kept");
+
+        s = &compose->services[database];
+        TEST_ASSERT_STR_EQ("postgres:15-alpine", s->image, "Quoted image should be unquoted, comment stripped");
+        TEST_ASSERT_EQ(2, s->volume_count, "Anonymous volumes have no source");
+        TEST_ASSERT_STR_EQ("./database/init", s->volumes[1], "Bind mount source should be kept");
+
+        s = &compose->services[backend];
+        TEST_ASSERT_STR_EQ("./backend", s->build_context, "Short build form should be the context");
+        TEST_ASSERT_EQ(2, s->depends_count, "Long-form depends_on keys should be collected");
+        TEST_ASSERT_STR_EQ("database", s->depends_on[0], "First dependency should be database");
+        TEST_ASSERT_STR_EQ("llm", s->depends_on[1], "Second dependency should be llm");
+        TEST_ASSERT_EQ(1, s->volume_count, "Long-form volume should be collected");
+        TEST_ASSERT_STR_EQ("./backend/config", s->volumes[0], "Long-form volume source should be kept");
+
+        s = &compose->services[frontend];
+        TEST_ASSERT_EQ(2, s->depends_count, "Flow sequence depends_on should be split");
+        TEST_ASSERT_STR_EQ("external-auth", s->depends_on[1], "Flow items should be unquoted");
+        TEST_ASSERT_EQ(31, s->line_number, "Service line number should be recorded");
+    }
+
+    compose_file_destroy(compose);
 }
 
 void test_yaml_dependency_parsing(void) {
-    // TODO: Implement YAML dependency parsing tests
-    TEST_ASSERT(true, "YAML dependency parsing test placeholder");
+    ComposeFile* compose = compose_parse_buffer(COMPOSE_FIXTURE, strlen(COMPOSE_FIXTURE));
+    TEST_ASSERT_NOT_NULL(compose, "Compose buffer should parse");
+    if (!compose) return;
+
+    DagSchedule schedule;
+    int result = compose_startup_waves(compose, &schedule);
+    TEST_ASSERT_EQ(DEPTRACK_SUCCESS, result, "Acyclic compose file should schedule");
+    TEST_ASSERT_EQ(3, schedule.wave_count, "llm+database, backend, frontend");
+    TEST_ASSERT_EQ(2, schedule.wave_offsets[1] - schedule.wave_offsets[0], "First wave should start two services");
+    TEST_ASSERT_EQ(0, schedule.wave_of[compose_find_service(compose, "database")], "database starts first");
+    TEST_ASSERT_EQ(2, schedule.wave_of[compose_find_service(compose, "frontend")], "frontend starts last");
+
+    // llm (build, 2.0) -> backend (build, 2.0) -> frontend (1.0)
+    TEST_ASSERT_EQ(3, schedule.critical_path_length, "Critical path should span three services");
+    TEST_ASSERT_EQ(5.0, schedule.critical_path_cost, "Critical path should weight image builds");
+    if (schedule.critical_path_length == 3) {
+        TEST_ASSERT_STR_EQ("llm", compose->services[schedule.critical_path[0]].name, "Critical path starts at llm");
+    }
+
+    dag_schedule_destroy(&schedule);
+    compose_file_destroy(compose);
+
+    static const char* cyclic =
+        "services:\n"
+        "  a:\n"
+        "    depends_on: [b]\n"
+        "  b:\n"
+        "    depends_on:\n"
+        "      - a\n"
+        "  c:\n"
+        "    image: busybox\n";
+    compose = compose_parse_buffer(cyclic, strlen(cyclic));
+    TEST_ASSERT_NOT_NULL(compose, "Cyclic compose buffer should parse");
+    if (!compose) return;
+
+    result = compose_startup_waves(compose, &schedule);
+    TEST_ASSERT_EQ(DEPTRACK_ERROR_CYCLE, result, "depends_on cycle should be reported");
+    TEST_ASSERT_EQ(1, schedule.scheduled_count, "Only the service outside the cycle is scheduled");
+    TEST_ASSERT_EQ(SIZE_MAX, schedule.wave_of[0], "Cyclic services have no wave");
+
+    dag_schedule_destroy(&schedule);
+    compose_file_destroy(compose);
 }
 
 void run_yaml_parser_tests(void) {